@@ -0,0 +1,563 @@
+/******************************************************************************
+ * @file serial_benchmarks.cpp                                                *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+/**
+ * @brief Micro-benchmarks of the SerialPort and SerialStream hot paths.
+ *
+ *        Each benchmark runs over a pseudo-terminal pair created with
+ *        openpty(), so no serial hardware is needed. The library object
+ *        under test is opened on the slave side while the master side is
+ *        driven directly with read() and write(), so the reported numbers
+ *        mostly reflect the cost of the library and of the tty layer.
+ *
+ *        For every operation and message size the benchmark reports the
+ *        throughput and the 50th, 99th and 99.9th percentile latency of one
+ *        complete message transfer.
+ *
+ *        Usage: SerialBenchmarks [--iterations N] [--filter SUBSTRING]
+ */
+
+#include <libserial/BasicSerialPort.h>
+#include <libserial/SerialPort.h>
+#include <libserial/SerialStream.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <pty.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace LibSerial ;
+
+/**
+ * @brief The message sizes, in bytes, each benchmark is run with.
+ */
+constexpr size_t MESSAGE_SIZES[] = {1, 16, 64, 256, 1024, 4096} ;
+
+/**
+ * @brief The default number of timed iterations of each benchmark.
+ */
+constexpr size_t DEFAULT_ITERATIONS = 1000 ;
+
+/**
+ * @brief The number of untimed iterations run before each benchmark.
+ */
+constexpr size_t WARMUP_ITERATIONS = 100 ;
+
+/**
+ * @brief A pseudo-terminal pair. The slave device name is opened by the
+ *        library object under test while the master file descriptor acts
+ *        as the remote end of the serial link.
+ */
+class PtyPair
+{
+public:
+    /**
+     * @brief Creates the pseudo-terminal pair.
+     */
+    PtyPair()
+    {
+        int slave_fd = -1 ;
+        char slave_name[256] {} ;
+
+        if (openpty(&mMasterFileDescriptor, &slave_fd, slave_name, nullptr, nullptr) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        // Keep the slave open so that the master never reports a hangup
+        // while the library object opens and closes the device.
+        mSlaveFileDescriptor = slave_fd ;
+        mSlaveName = slave_name ;
+    }
+
+    /**
+     * @brief Closes both ends of the pseudo-terminal pair.
+     */
+    ~PtyPair()
+    {
+        close(mSlaveFileDescriptor) ;
+        close(mMasterFileDescriptor) ;
+    }
+
+    PtyPair(const PtyPair&) = delete ;
+    PtyPair& operator=(const PtyPair&) = delete ;
+
+    /**
+     * @brief Gets the name of the slave device.
+     */
+    const std::string& GetSlaveName() const
+    {
+        return mSlaveName ;
+    }
+
+    /**
+     * @brief Writes a complete message to the master side.
+     */
+    void WriteAll(const void* dataBuffer, size_t numberOfBytes) const
+    {
+        const auto* data = static_cast<const uint8_t*>(dataBuffer) ;
+
+        while (numberOfBytes > 0)
+        {
+            const auto result = write(mMasterFileDescriptor, data, numberOfBytes) ;
+
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue ;
+                }
+
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            data += result ;
+            numberOfBytes -= static_cast<size_t>(result) ;
+        }
+    }
+
+    /**
+     * @brief Reads a complete message from the master side.
+     */
+    void ReadAll(void* dataBuffer, size_t numberOfBytes) const
+    {
+        auto* data = static_cast<uint8_t*>(dataBuffer) ;
+
+        while (numberOfBytes > 0)
+        {
+            const auto result = read(mMasterFileDescriptor, data, numberOfBytes) ;
+
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue ;
+                }
+
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            data += result ;
+            numberOfBytes -= static_cast<size_t>(result) ;
+        }
+    }
+
+private:
+    int mMasterFileDescriptor = -1 ;
+    int mSlaveFileDescriptor = -1 ;
+    std::string mSlaveName {} ;
+} ;
+
+/**
+ * @brief The benchmark options given on the command line.
+ */
+struct BenchmarkOptions
+{
+    size_t iterations = DEFAULT_ITERATIONS ;
+    std::string filter {} ;
+} ;
+
+/**
+ * @brief Runs one benchmark and prints a line of results.
+ * @param options The benchmark options.
+ * @param benchmarkName The name of the benchmark.
+ * @param messageSize The number of bytes transferred by one operation.
+ * @param operation Transfers one complete message.
+ */
+void
+runBenchmark(const BenchmarkOptions&      options,
+             const std::string&           benchmarkName,
+             const size_t                 messageSize,
+             const std::function<void()>& operation)
+{
+    for (size_t i = 0 ; i < WARMUP_ITERATIONS ; ++i)
+    {
+        operation() ;
+    }
+
+    using clock = std::chrono::steady_clock ;
+
+    std::vector<double> latencies_us ;
+    latencies_us.reserve(options.iterations) ;
+
+    const auto start_time = clock::now() ;
+
+    for (size_t i = 0 ; i < options.iterations ; ++i)
+    {
+        const auto operation_start = clock::now() ;
+        operation() ;
+        const auto operation_time = clock::now() - operation_start ;
+
+        latencies_us.push_back(std::chrono::duration<double, std::micro>(operation_time).count()) ;
+    }
+
+    const auto total_seconds = std::chrono::duration<double>(clock::now() - start_time).count() ;
+
+    std::sort(latencies_us.begin(), latencies_us.end()) ;
+
+    const auto percentile = [&latencies_us](const double fraction)
+    {
+        const auto index = static_cast<size_t>(fraction * static_cast<double>(latencies_us.size() - 1)) ;
+        return latencies_us[index] ;
+    } ;
+
+    const auto megabytes_per_second = static_cast<double>(messageSize * options.iterations) /
+                                      total_seconds / 1.0e6 ;
+
+    std::cout << std::left  << std::setw(36) << benchmarkName
+              << std::right << std::setw(8)  << messageSize
+              << std::fixed << std::setprecision(3)
+              << std::setw(12) << megabytes_per_second
+              << std::setprecision(1)
+              << std::setw(10) << percentile(0.5)
+              << std::setw(10) << percentile(0.99)
+              << std::setw(10) << percentile(0.999)
+              << std::endl ;
+}
+
+/**
+ * @brief Determines whether a benchmark was selected on the command line.
+ */
+bool
+isSelected(const BenchmarkOptions& options,
+           const std::string&      benchmarkName)
+{
+    return options.filter.empty() or
+           (benchmarkName.find(options.filter) != std::string::npos) ;
+}
+
+/**
+ * @brief Runs the benchmarks of the SerialPort write paths.
+ */
+void
+runSerialPortWriteBenchmarks(const BenchmarkOptions& options,
+                             const PtyPair&          ptyPair,
+                             const size_t            messageSize)
+{
+    SerialPort serial_port(ptyPair.GetSlaveName()) ;
+
+    const DataBuffer message(messageSize, 'x') ;
+    DataBuffer received(messageSize) ;
+
+    if (isSelected(options, "SerialPort::Write(DataBuffer)"))
+    {
+        runBenchmark(options, "SerialPort::Write(DataBuffer)", messageSize,
+                     [&]()
+                     {
+                         serial_port.Write(message) ;
+                         ptyPair.ReadAll(received.data(), messageSize) ;
+                     }) ;
+    }
+
+    if (isSelected(options, "SerialPort::Write(uint8_t*)"))
+    {
+        runBenchmark(options, "SerialPort::Write(uint8_t*)", messageSize,
+                     [&]()
+                     {
+                         serial_port.Write(message.data(), messageSize) ;
+                         ptyPair.ReadAll(received.data(), messageSize) ;
+                     }) ;
+    }
+
+    if (isSelected(options, "SerialPort::WriteV()"))
+    {
+        // A typical framed message: a small header followed by a payload.
+        const auto header_size = std::min<size_t>(4, messageSize) ;
+
+        runBenchmark(options, "SerialPort::WriteV()", messageSize,
+                     [&]()
+                     {
+                         serial_port.WriteV({{message.data(), header_size},
+                                             {message.data() + header_size, messageSize - header_size}}) ;
+                         ptyPair.ReadAll(received.data(), messageSize) ;
+                     }) ;
+    }
+}
+
+/**
+ * @brief Runs the benchmarks of the SerialPort read paths.
+ */
+void
+runSerialPortReadBenchmarks(const BenchmarkOptions& options,
+                            const PtyPair&          ptyPair,
+                            const size_t            messageSize)
+{
+    SerialPort serial_port(ptyPair.GetSlaveName()) ;
+
+    const DataBuffer message(messageSize, 'x') ;
+
+    if (isSelected(options, "SerialPort::Read(DataBuffer)"))
+    {
+        DataBuffer received ;
+
+        runBenchmark(options, "SerialPort::Read(DataBuffer)", messageSize,
+                     [&]()
+                     {
+                         ptyPair.WriteAll(message.data(), messageSize) ;
+                         serial_port.Read(received, messageSize) ;
+                     }) ;
+    }
+
+    if (isSelected(options, "SerialPort::Read(uint8_t*)"))
+    {
+        DataBuffer received(messageSize) ;
+
+        runBenchmark(options, "SerialPort::Read(uint8_t*)", messageSize,
+                     [&]()
+                     {
+                         ptyPair.WriteAll(message.data(), messageSize) ;
+
+                         for (size_t bytes_read = 0 ; bytes_read < messageSize ; )
+                         {
+                             bytes_read += serial_port.Read(received.data() + bytes_read,
+                                                            messageSize - bytes_read) ;
+                         }
+                     }) ;
+    }
+
+    if (isSelected(options, "SerialPort::ReadByte()"))
+    {
+        char received = 0 ;
+
+        runBenchmark(options, "SerialPort::ReadByte()", messageSize,
+                     [&]()
+                     {
+                         ptyPair.WriteAll(message.data(), messageSize) ;
+
+                         for (size_t i = 0 ; i < messageSize ; ++i)
+                         {
+                             serial_port.ReadByte(received) ;
+                         }
+                     }) ;
+    }
+
+    if (isSelected(options, "SerialPort::ReadLine()"))
+    {
+        auto line = message ;
+        line.back() = '\n' ;
+        std::string received ;
+
+        runBenchmark(options, "SerialPort::ReadLine()", messageSize,
+                     [&]()
+                     {
+                         ptyPair.WriteAll(line.data(), messageSize) ;
+                         serial_port.ReadLine(received) ;
+                     }) ;
+    }
+
+    if (isSelected(options, "SerialPort::ReadFromRingBuffer()"))
+    {
+        DataBuffer received(messageSize) ;
+        serial_port.StartBackgroundReader() ;
+
+        runBenchmark(options, "SerialPort::ReadFromRingBuffer()", messageSize,
+                     [&]()
+                     {
+                         ptyPair.WriteAll(message.data(), messageSize) ;
+
+                         for (size_t bytes_read = 0 ; bytes_read < messageSize ; )
+                         {
+                             bytes_read += serial_port.ReadFromRingBuffer(received.data() + bytes_read,
+                                                                          messageSize - bytes_read) ;
+                         }
+                     }) ;
+
+        serial_port.StopBackgroundReader() ;
+    }
+}
+
+/**
+ * @brief Runs the benchmarks of the BasicSerialPort inline hot paths.
+ */
+void
+runBasicSerialPortBenchmarks(const BenchmarkOptions& options,
+                             const PtyPair&          ptyPair,
+                             const size_t            messageSize)
+{
+    const DataBuffer message(messageSize, 'x') ;
+
+    if (isSelected(options, "BasicSerialPort<>::Write(uint8_t*)"))
+    {
+        BasicSerialPort<> basic_serial_port(ptyPair.GetSlaveName()) ;
+        DataBuffer received(messageSize) ;
+
+        runBenchmark(options, "BasicSerialPort<>::Write(uint8_t*)", messageSize,
+                     [&]()
+                     {
+                         basic_serial_port.Write(message.data(), messageSize) ;
+                         ptyPair.ReadAll(received.data(), messageSize) ;
+                     }) ;
+    }
+
+    if (isSelected(options, "BasicSerialPort<>::ReadByte()"))
+    {
+        BasicSerialPort<> basic_serial_port(ptyPair.GetSlaveName()) ;
+        char received = 0 ;
+
+        runBenchmark(options, "BasicSerialPort<>::ReadByte()", messageSize,
+                     [&]()
+                     {
+                         ptyPair.WriteAll(message.data(), messageSize) ;
+
+                         for (size_t i = 0 ; i < messageSize ; ++i)
+                         {
+                             basic_serial_port.ReadByte(received) ;
+                         }
+                     }) ;
+    }
+
+    if (isSelected(options, "BasicSerialPort<4096>::ReadByte()"))
+    {
+        BasicSerialPort<NoLocking, ReadBuffered<4096>> basic_serial_port(ptyPair.GetSlaveName()) ;
+        char received = 0 ;
+
+        runBenchmark(options, "BasicSerialPort<4096>::ReadByte()", messageSize,
+                     [&]()
+                     {
+                         ptyPair.WriteAll(message.data(), messageSize) ;
+
+                         for (size_t i = 0 ; i < messageSize ; ++i)
+                         {
+                             basic_serial_port.ReadByte(received) ;
+                         }
+                     }) ;
+    }
+}
+
+/**
+ * @brief Runs the benchmarks of the SerialStream formatted I/O paths.
+ */
+void
+runSerialStreamBenchmarks(const BenchmarkOptions& options,
+                          const PtyPair&          ptyPair,
+                          const size_t            messageSize)
+{
+    SerialStream serial_stream(ptyPair.GetSlaveName()) ;
+
+    if (isSelected(options, "SerialStream::operator<<"))
+    {
+        const std::string message(messageSize, 'x') ;
+        DataBuffer received(messageSize) ;
+
+        runBenchmark(options, "SerialStream::operator<<", messageSize,
+                     [&]()
+                     {
+                         serial_stream << message << std::flush ;
+                         ptyPair.ReadAll(received.data(), messageSize) ;
+                     }) ;
+    }
+
+    if (isSelected(options, "SerialStream::operator>>"))
+    {
+        // Whitespace terminates each word extracted by operator>>, it is
+        // not counted in the message size.
+        const auto message = std::string(messageSize, 'x') + '\n' ;
+        std::string received ;
+
+        runBenchmark(options, "SerialStream::operator>>", messageSize,
+                     [&]()
+                     {
+                         ptyPair.WriteAll(message.data(), message.size()) ;
+                         serial_stream >> received ;
+                     }) ;
+    }
+}
+
+int
+main(int argc, char** argv)
+{
+    BenchmarkOptions options ;
+
+    for (int i = 1 ; i < argc ; ++i)
+    {
+        const std::string argument = argv[i] ;
+
+        if ((argument == "--iterations") and (i + 1 < argc))
+        {
+            options.iterations = std::strtoul(argv[++i], nullptr, 10) ;
+        }
+        else if ((argument == "--filter") and (i + 1 < argc))
+        {
+            options.filter = argv[++i] ;
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--iterations N] [--filter SUBSTRING]" << std::endl ;
+            return EXIT_FAILURE ;
+        }
+    }
+
+    if (options.iterations == 0)
+    {
+        std::cerr << "The number of iterations must be positive." << std::endl ;
+        return EXIT_FAILURE ;
+    }
+
+    std::cout << std::left  << std::setw(36) << "benchmark"
+              << std::right << std::setw(8)  << "bytes"
+              << std::setw(12) << "MB/s"
+              << std::setw(10) << "p50 us"
+              << std::setw(10) << "p99 us"
+              << std::setw(10) << "p999 us"
+              << std::endl ;
+
+    try
+    {
+        const PtyPair pty_pair ;
+
+        for (const auto message_size : MESSAGE_SIZES)
+        {
+            runSerialPortWriteBenchmarks(options, pty_pair, message_size) ;
+            runSerialPortReadBenchmarks(options, pty_pair, message_size) ;
+            runBasicSerialPortBenchmarks(options, pty_pair, message_size) ;
+            runSerialStreamBenchmarks(options, pty_pair, message_size) ;
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "Benchmark failed: " << error.what() << std::endl ;
+        return EXIT_FAILURE ;
+    }
+
+    return EXIT_SUCCESS ;
+}
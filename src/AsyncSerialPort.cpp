@@ -0,0 +1,1013 @@
+/******************************************************************************
+ * @file AsyncSerialPort.cpp                                                  *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/AsyncSerialPort.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
+namespace LibSerial
+{
+    /**
+     * @brief AsyncSerialPort::Implementation is the AsyncSerialPort
+     *        implementation class.
+     */
+    class AsyncSerialPort::Implementation : public std::enable_shared_from_this<Implementation>
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param serialPortReactor The reactor that completes the operations.
+         */
+        explicit Implementation(SerialPortReactor& serialPortReactor) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        ~Implementation() = default ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Transfers the serial port to the reactor. This cannot be done
+         *        by the constructor since the reactor callbacks refer to the
+         *        implementation through a weak pointer.
+         * @param serialPort The open serial port.
+         */
+        void Start(std::unique_ptr<SerialPort> serialPort) ;
+
+        /**
+         * @brief Removes the serial port from the reactor and fails all
+         *        pending operations.
+         */
+        void Close() ;
+
+        /**
+         * @brief Gets the handle of the serial port within the reactor.
+         * @return Returns the handle of the serial port.
+         */
+        SerialPortReactor::PortId GetPortId() const ;
+
+        /**
+         * @brief Starts reading the specified number of bytes.
+         * @param numberOfBytes The number of bytes to read.
+         * @param msTimeout The timeout period in milliseconds.
+         * @param handler The handler to invoke on completion.
+         */
+        void ReadAsync(size_t             numberOfBytes,
+                       size_t             msTimeout,
+                       const ReadHandler& handler) ;
+
+        /**
+         * @brief Starts reading until the delimiter has been received.
+         * @param delimiter The delimiter ending the data.
+         * @param msTimeout The timeout period in milliseconds.
+         * @param handler The handler to invoke on completion.
+         */
+        void ReadUntilAsync(const std::string&      delimiter,
+                            size_t                  msTimeout,
+                            const ReadUntilHandler& handler) ;
+
+        /**
+         * @brief Starts writing a buffer.
+         * @param dataBuffer The data to be written.
+         * @param handler The handler to invoke on completion.
+         */
+        void WriteAsync(DataBuffer          dataBuffer,
+                        const WriteHandler& handler) ;
+
+    private:
+        /**
+         * @brief A completion handler bound to its result, invoked once the
+         *        mutex has been released.
+         */
+        using Completion = std::function<void()> ;
+
+        /**
+         * @brief A pending ReadAsync() or ReadUntilAsync() operation.
+         */
+        struct ReadOperation
+        {
+            uint64_t                    operationId = 0 ;
+            size_t                      numberOfBytes = 0 ;
+            std::string                 delimiter {} ;
+            size_t                      searchOffset = 0 ;
+            ReadHandler                 readHandler {} ;
+            ReadUntilHandler            readUntilHandler {} ;
+            bool                        hasTimer = false ;
+            SerialPortReactor::TimerId  timerId = 0 ;
+        } ;
+
+        /**
+         * @brief A pending WriteAsync() operation.
+         */
+        struct WriteOperation
+        {
+            DataBuffer   dataBuffer {} ;
+            size_t       numberOfBytesWritten = 0 ;
+            WriteHandler writeHandler {} ;
+        } ;
+
+        /**
+         * @brief Queues a read operation and completes it right away if
+         *        enough data has already been received.
+         * @param readOperation The read operation.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void StartRead(ReadOperation readOperation,
+                       size_t        msTimeout) ;
+
+        /**
+         * @brief Moves received data from the driver to the receive buffer
+         *        and completes the reads it satisfies.
+         * @param serialPort The serial port.
+         */
+        void OnDataReady(SerialPort& serialPort) ;
+
+        /**
+         * @brief Hands queued data to the driver and completes the writes
+         *        that have been fully written.
+         */
+        void OnWritable() ;
+
+        /**
+         * @brief Fails all pending operations after a hang-up.
+         */
+        void OnHangUp() ;
+
+        /**
+         * @brief Fails a read whose timeout has elapsed.
+         * @param operationId The identifier of the read operation.
+         */
+        void OnReadTimeout(uint64_t operationId) ;
+
+        /**
+         * @brief Completes, in order, the pending reads satisfied by the
+         *        receive buffer. Must be called with the mutex held.
+         * @param completions Receives the completions to invoke.
+         */
+        void CompleteReads(std::vector<Completion>& completions) ;
+
+        /**
+         * @brief Creates the completion of a failed read.
+         * @param readOperation The read operation.
+         * @param error The reason the read failed.
+         * @return Returns the completion to invoke.
+         */
+        Completion FailRead(ReadOperation&     readOperation,
+                            std::exception_ptr error) ;
+
+        /**
+         * @brief Fails all pending operations. Must be called with the mutex
+         *        held.
+         * @param error The reason the operations failed.
+         * @param completions Receives the completions to invoke.
+         */
+        void FailAllOperations(std::exception_ptr       error,
+                               std::vector<Completion>& completions) ;
+
+        /**
+         * @brief Enables readable and writable interest in the reactor only
+         *        while reads or writes are pending. Must be called with the
+         *        mutex held.
+         */
+        void UpdateInterest() ;
+
+        /**
+         * @brief Invokes completions collected while the mutex was held.
+         * @param completions The completions to invoke.
+         */
+        static void InvokeCompletions(std::vector<Completion>& completions) ;
+
+        /**
+         * The reactor that completes the operations.
+         */
+        SerialPortReactor& mSerialPortReactor ;
+
+        /**
+         * The handle of the serial port within the reactor.
+         */
+        SerialPortReactor::PortId mPortId = 0 ;
+
+        /**
+         * The file descriptor of the serial port.
+         */
+        int mFileDescriptor = -1 ;
+
+        /**
+         * Protects the state below, which is used by the threads starting
+         * operations as well as those running the reactor.
+         */
+        mutable std::mutex mMutex {} ;
+
+        /**
+         * Data received from the driver but not yet consumed by a read.
+         */
+        DataBuffer mReceiveBuffer {} ;
+
+        /**
+         * The pending reads in the order they were started.
+         */
+        std::deque<ReadOperation> mReadOperations {} ;
+
+        /**
+         * The pending writes in the order they were started.
+         */
+        std::deque<WriteOperation> mWriteOperations {} ;
+
+        /**
+         * The identifier assigned to the next read operation.
+         */
+        uint64_t mNextOperationId = 1 ;
+
+        /**
+         * True while data-ready callbacks are enabled.
+         */
+        bool mReadableInterest = true ;
+
+        /**
+         * True while writable callbacks are enabled.
+         */
+        bool mWritableInterest = false ;
+
+        /**
+         * True once the port has hung up.
+         */
+        bool mHungUp = false ;
+
+        /**
+         * True once the port has been removed from the reactor.
+         */
+        bool mClosed = true ;
+    } ;
+
+    AsyncSerialPort::AsyncSerialPort(SerialPortReactor&          serialPortReactor,
+                                     std::unique_ptr<SerialPort> serialPort)
+        : mImpl(std::make_shared<Implementation>(serialPortReactor))
+    {
+        mImpl->Start(std::move(serialPort)) ;
+    }
+
+    AsyncSerialPort::~AsyncSerialPort() noexcept
+    {
+        try
+        {
+            mImpl->Close() ;
+        }
+        catch (...)
+        {
+            // Exceptions thrown by completion handlers cannot be reported
+            // from a destructor.
+        }
+    }
+
+    SerialPortReactor::PortId
+    AsyncSerialPort::GetPortId() const
+    {
+        return mImpl->GetPortId() ;
+    }
+
+    void
+    AsyncSerialPort::ReadAsync(const size_t       numberOfBytes,
+                               const size_t       msTimeout,
+                               const ReadHandler& handler)
+    {
+        mImpl->ReadAsync(numberOfBytes,
+                         msTimeout,
+                         handler) ;
+    }
+
+    void
+    AsyncSerialPort::ReadUntilAsync(const std::string&      delimiter,
+                                    const size_t            msTimeout,
+                                    const ReadUntilHandler& handler)
+    {
+        mImpl->ReadUntilAsync(delimiter,
+                              msTimeout,
+                              handler) ;
+    }
+
+    void
+    AsyncSerialPort::WriteAsync(DataBuffer          dataBuffer,
+                                const WriteHandler& handler)
+    {
+        mImpl->WriteAsync(std::move(dataBuffer),
+                          handler) ;
+    }
+
+    std::future<DataBuffer>
+    AsyncSerialPort::ReadAsync(const size_t numberOfBytes,
+                               const size_t msTimeout)
+    {
+        const auto promise = std::make_shared<std::promise<DataBuffer>>() ;
+        auto future = promise->get_future() ;
+
+        mImpl->ReadAsync(numberOfBytes,
+                         msTimeout,
+                         [promise](std::exception_ptr error, DataBuffer dataBuffer)
+                         {
+                             if (error)
+                             {
+                                 promise->set_exception(error) ;
+                                 return ;
+                             }
+
+                             promise->set_value(std::move(dataBuffer)) ;
+                         }) ;
+
+        return future ;
+    }
+
+    std::future<std::string>
+    AsyncSerialPort::ReadUntilAsync(const std::string& delimiter,
+                                    const size_t       msTimeout)
+    {
+        const auto promise = std::make_shared<std::promise<std::string>>() ;
+        auto future = promise->get_future() ;
+
+        mImpl->ReadUntilAsync(delimiter,
+                              msTimeout,
+                              [promise](std::exception_ptr error, std::string dataString)
+                              {
+                                  if (error)
+                                  {
+                                      promise->set_exception(error) ;
+                                      return ;
+                                  }
+
+                                  promise->set_value(std::move(dataString)) ;
+                              }) ;
+
+        return future ;
+    }
+
+    std::future<void>
+    AsyncSerialPort::WriteAsync(DataBuffer dataBuffer)
+    {
+        const auto promise = std::make_shared<std::promise<void>>() ;
+        auto future = promise->get_future() ;
+
+        mImpl->WriteAsync(std::move(dataBuffer),
+                          [promise](std::exception_ptr error, size_t /* numberOfBytes */)
+                          {
+                              if (error)
+                              {
+                                  promise->set_exception(error) ;
+                                  return ;
+                              }
+
+                              promise->set_value() ;
+                          }) ;
+
+        return future ;
+    }
+
+    std::future<void>
+    AsyncSerialPort::WriteAsync(const std::string& dataString)
+    {
+        return this->WriteAsync(DataBuffer(dataString.begin(),
+                                           dataString.end())) ;
+    }
+
+    inline
+    AsyncSerialPort::Implementation::Implementation(SerialPortReactor& serialPortReactor)
+        : mSerialPortReactor(serialPortReactor)
+    {
+        /* Empty */
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::Start(std::unique_ptr<SerialPort> serialPort)
+    {
+        if ((not serialPort) or
+            (not serialPort->IsOpen()))
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        mFileDescriptor = serialPort->GetFileDescriptor() ;
+
+        // Writes are performed from the reactor threads and must never block.
+        const auto flags = fcntl(mFileDescriptor, F_GETFL) ; // NOLINT (cppcoreguidelines-pro-type-vararg)
+
+        if ((flags < 0) or
+            (fcntl(mFileDescriptor, F_SETFL, flags | O_NONBLOCK) < 0)) // NOLINT (cppcoreguidelines-pro-type-vararg, hicpp-signed-bitwise)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        const std::weak_ptr<Implementation> weak_this = this->shared_from_this() ;
+
+        SerialPortReactor::Callbacks<SerialPort> callbacks ;
+
+        callbacks.dataReady = [weak_this](SerialPortReactor::PortId /* portId */,
+                                          SerialPort&               port)
+        {
+            if (const auto self = weak_this.lock())
+            {
+                self->OnDataReady(port) ;
+            }
+        } ;
+
+        callbacks.writable = [weak_this](SerialPortReactor::PortId /* portId */,
+                                         SerialPort&               /* port */)
+        {
+            if (const auto self = weak_this.lock())
+            {
+                self->OnWritable() ;
+            }
+        } ;
+
+        callbacks.hangUp = [weak_this](SerialPortReactor::PortId /* portId */,
+                                       SerialPort&               /* port */)
+        {
+            if (const auto self = weak_this.lock())
+            {
+                self->OnHangUp() ;
+            }
+        } ;
+
+        std::lock_guard<std::mutex> lock(mMutex) ;
+
+        mPortId = mSerialPortReactor.Add(std::move(serialPort),
+                                         callbacks) ;
+        mClosed = false ;
+
+        // No read is pending yet.
+        this->UpdateInterest() ;
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::Close()
+    {
+        std::vector<Completion> completions ;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex) ;
+
+            if (mClosed)
+            {
+                return ;
+            }
+
+            mClosed = true ;
+
+            this->FailAllOperations(std::make_exception_ptr(NotOpen(ERR_MSG_PORT_NOT_OPEN)),
+                                    completions) ;
+        }
+
+        // Callbacks already running on another thread see mClosed and
+        // return without touching the port, which is then closed.
+        mSerialPortReactor.Remove(mPortId) ;
+
+        InvokeCompletions(completions) ;
+    }
+
+    inline
+    SerialPortReactor::PortId
+    AsyncSerialPort::Implementation::GetPortId() const
+    {
+        return mPortId ;
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::ReadAsync(const size_t       numberOfBytes,
+                                               const size_t       msTimeout,
+                                               const ReadHandler& handler)
+    {
+        ReadOperation read_operation ;
+        read_operation.numberOfBytes = numberOfBytes ;
+        read_operation.readHandler = handler ;
+
+        this->StartRead(std::move(read_operation),
+                        msTimeout) ;
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::ReadUntilAsync(const std::string&      delimiter,
+                                                    const size_t            msTimeout,
+                                                    const ReadUntilHandler& handler)
+    {
+        if (delimiter.empty())
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_TERMINATOR) ;
+        }
+
+        ReadOperation read_operation ;
+        read_operation.delimiter = delimiter ;
+        read_operation.readUntilHandler = handler ;
+
+        this->StartRead(std::move(read_operation),
+                        msTimeout) ;
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::WriteAsync(DataBuffer          dataBuffer,
+                                                const WriteHandler& handler)
+    {
+        std::vector<Completion> completions ;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex) ;
+
+            if (mClosed or mHungUp)
+            {
+                const auto error = mClosed ? std::make_exception_ptr(NotOpen(ERR_MSG_PORT_NOT_OPEN)) :
+                                             std::make_exception_ptr(std::runtime_error(ERR_MSG_PORT_HUNG_UP)) ;
+
+                completions.push_back([handler, error]() { handler(error, 0) ; }) ;
+            }
+            else
+            {
+                WriteOperation write_operation ;
+                write_operation.dataBuffer = std::move(dataBuffer) ;
+                write_operation.writeHandler = handler ;
+
+                mWriteOperations.push_back(std::move(write_operation)) ;
+                this->UpdateInterest() ;
+            }
+        }
+
+        InvokeCompletions(completions) ;
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::StartRead(ReadOperation readOperation,
+                                               const size_t  msTimeout)
+    {
+        std::vector<Completion> completions ;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex) ;
+
+            if (mClosed)
+            {
+                completions.push_back(this->FailRead(readOperation,
+                                                     std::make_exception_ptr(NotOpen(ERR_MSG_PORT_NOT_OPEN)))) ;
+            }
+            else
+            {
+                readOperation.operationId = mNextOperationId++ ;
+
+                if (msTimeout > 0)
+                {
+                    const std::weak_ptr<Implementation> weak_this = this->shared_from_this() ;
+                    const auto operation_id = readOperation.operationId ;
+
+                    // The timer cannot fire before the operation is queued
+                    // since its callback has to acquire the mutex first.
+                    readOperation.hasTimer = true ;
+                    readOperation.timerId  = mSerialPortReactor.StartTimer(msTimeout,
+                                                                           [weak_this, operation_id]()
+                                                                           {
+                                                                               if (const auto self = weak_this.lock())
+                                                                               {
+                                                                                   self->OnReadTimeout(operation_id) ;
+                                                                               }
+                                                                           }) ;
+                }
+
+                mReadOperations.push_back(std::move(readOperation)) ;
+
+                this->CompleteReads(completions) ;
+
+                if (mHungUp)
+                {
+                    // Data received before the hang-up has been handed out,
+                    // nothing more will arrive.
+                    this->FailAllOperations(std::make_exception_ptr(std::runtime_error(ERR_MSG_PORT_HUNG_UP)),
+                                            completions) ;
+                }
+
+                this->UpdateInterest() ;
+            }
+        }
+
+        InvokeCompletions(completions) ;
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::OnDataReady(SerialPort& serialPort)
+    {
+        std::vector<Completion> completions ;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex) ;
+
+            if (mClosed)
+            {
+                return ;
+            }
+
+            if (not mReadOperations.empty())
+            {
+                const auto number_of_bytes_available = serialPort.GetNumberOfBytesAvailable() ;
+
+                if (number_of_bytes_available > 0)
+                {
+                    const auto previous_size = mReceiveBuffer.size() ;
+                    mReceiveBuffer.resize(previous_size + static_cast<size_t>(number_of_bytes_available)) ;
+
+                    const auto number_of_bytes_read = serialPort.Read(&mReceiveBuffer[previous_size],
+                                                                      static_cast<size_t>(number_of_bytes_available)) ;
+
+                    mReceiveBuffer.resize(previous_size + number_of_bytes_read) ;
+
+                    this->CompleteReads(completions) ;
+                }
+                else
+                {
+                    // Readable with nothing to read means end of file, which
+                    // a tty reports once the other end has hung up.
+                    uint8_t probe_byte = 0 ;
+
+                    if (call_with_retry(read, mFileDescriptor, &probe_byte, 1) == 0)
+                    {
+                        mHungUp = true ;
+                        this->FailAllOperations(std::make_exception_ptr(std::runtime_error(ERR_MSG_PORT_HUNG_UP)),
+                                                completions) ;
+                    }
+                    else
+                    {
+                        mReceiveBuffer.push_back(probe_byte) ;
+                        this->CompleteReads(completions) ;
+                    }
+                }
+            }
+
+            this->UpdateInterest() ;
+        }
+
+        InvokeCompletions(completions) ;
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::OnWritable()
+    {
+        std::vector<Completion> completions ;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex) ;
+
+            if (mClosed)
+            {
+                return ;
+            }
+
+            while (not mWriteOperations.empty())
+            {
+                auto& write_operation = mWriteOperations.front() ;
+
+                const auto number_of_bytes_remaining = write_operation.dataBuffer.size() -
+                                                       write_operation.numberOfBytesWritten ;
+
+                if (number_of_bytes_remaining > 0)
+                {
+                    const auto write_result = call_with_retry(write,
+                                                              mFileDescriptor,
+                                                              &write_operation.dataBuffer[write_operation.numberOfBytesWritten],
+                                                              number_of_bytes_remaining) ;
+
+                    if (write_result < 0)
+                    {
+                        if (errno == EWOULDBLOCK)
+                        {
+                            break ;
+                        }
+
+                        const auto error = std::make_exception_ptr(std::runtime_error(std::strerror(errno))) ;
+                        const auto handler = write_operation.writeHandler ;
+                        const auto number_of_bytes_written = write_operation.numberOfBytesWritten ;
+
+                        completions.push_back([handler, error, number_of_bytes_written]()
+                                              {
+                                                  handler(error, number_of_bytes_written) ;
+                                              }) ;
+
+                        mWriteOperations.pop_front() ;
+                        continue ;
+                    }
+
+                    write_operation.numberOfBytesWritten += static_cast<size_t>(write_result) ;
+
+                    if (write_operation.numberOfBytesWritten < write_operation.dataBuffer.size())
+                    {
+                        // The driver's output buffer is full.
+                        break ;
+                    }
+                }
+
+                const auto handler = write_operation.writeHandler ;
+                const auto number_of_bytes_written = write_operation.numberOfBytesWritten ;
+
+                completions.push_back([handler, number_of_bytes_written]()
+                                      {
+                                          handler(nullptr, number_of_bytes_written) ;
+                                      }) ;
+
+                mWriteOperations.pop_front() ;
+            }
+
+            this->UpdateInterest() ;
+        }
+
+        InvokeCompletions(completions) ;
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::OnHangUp()
+    {
+        std::vector<Completion> completions ;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex) ;
+
+            if (mClosed)
+            {
+                return ;
+            }
+
+            mHungUp = true ;
+
+            this->FailAllOperations(std::make_exception_ptr(std::runtime_error(ERR_MSG_PORT_HUNG_UP)),
+                                    completions) ;
+        }
+
+        InvokeCompletions(completions) ;
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::OnReadTimeout(const uint64_t operationId)
+    {
+        std::vector<Completion> completions ;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex) ;
+
+            const auto read_operation_iter = std::find_if(mReadOperations.begin(),
+                                                          mReadOperations.end(),
+                                                          [operationId](const ReadOperation& readOperation)
+                                                          {
+                                                              return readOperation.operationId == operationId ;
+                                                          }) ;
+
+            // The read may have completed while the timer was expiring.
+            if (read_operation_iter == mReadOperations.end())
+            {
+                return ;
+            }
+
+            // The timer has fired, so there is nothing left to cancel.
+            read_operation_iter->hasTimer = false ;
+
+            completions.push_back(this->FailRead(*read_operation_iter,
+                                                 std::make_exception_ptr(ReadTimeout(ERR_MSG_READ_TIMEOUT)))) ;
+
+            const auto was_first = (read_operation_iter == mReadOperations.begin()) ;
+            mReadOperations.erase(read_operation_iter) ;
+
+            // A read queued behind the failed one may already be satisfied.
+            if (was_first)
+            {
+                this->CompleteReads(completions) ;
+            }
+
+            if (not mClosed)
+            {
+                this->UpdateInterest() ;
+            }
+        }
+
+        InvokeCompletions(completions) ;
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::CompleteReads(std::vector<Completion>& completions)
+    {
+        while (not mReadOperations.empty())
+        {
+            auto& read_operation = mReadOperations.front() ;
+
+            size_t number_of_bytes = 0 ;
+
+            if (read_operation.readHandler)
+            {
+                if (read_operation.numberOfBytes == 0)
+                {
+                    number_of_bytes = mReceiveBuffer.size() ;
+                }
+                else if (mReceiveBuffer.size() >= read_operation.numberOfBytes)
+                {
+                    number_of_bytes = read_operation.numberOfBytes ;
+                }
+            }
+            else
+            {
+                const auto& delimiter = read_operation.delimiter ;
+
+                // Only search the bytes that arrived since the last search,
+                // plus enough of the older ones to catch a split delimiter.
+                const auto search_start = mReceiveBuffer.begin() +
+                                          static_cast<std::ptrdiff_t>(read_operation.searchOffset) ;
+
+                const auto delimiter_iter = std::search(search_start,
+                                                        mReceiveBuffer.end(),
+                                                        delimiter.begin(),
+                                                        delimiter.end()) ;
+
+                if (delimiter_iter != mReceiveBuffer.end())
+                {
+                    number_of_bytes = static_cast<size_t>(delimiter_iter - mReceiveBuffer.begin()) + delimiter.size() ;
+                }
+                else if (mReceiveBuffer.size() >= delimiter.size())
+                {
+                    read_operation.searchOffset = mReceiveBuffer.size() - delimiter.size() + 1 ;
+                }
+            }
+
+            if (number_of_bytes == 0)
+            {
+                break ;
+            }
+
+            if (read_operation.hasTimer)
+            {
+                mSerialPortReactor.CancelTimer(read_operation.timerId) ;
+            }
+
+            const auto data_end = mReceiveBuffer.begin() + static_cast<std::ptrdiff_t>(number_of_bytes) ;
+
+            if (read_operation.readHandler)
+            {
+                auto handler = std::move(read_operation.readHandler) ;
+                auto data_buffer = std::make_shared<DataBuffer>(mReceiveBuffer.begin(), data_end) ;
+
+                completions.push_back([handler, data_buffer]()
+                                      {
+                                          handler(nullptr, std::move(*data_buffer)) ;
+                                      }) ;
+            }
+            else
+            {
+                auto handler = std::move(read_operation.readUntilHandler) ;
+                auto data_string = std::make_shared<std::string>(mReceiveBuffer.begin(), data_end) ;
+
+                completions.push_back([handler, data_string]()
+                                      {
+                                          handler(nullptr, std::move(*data_string)) ;
+                                      }) ;
+            }
+
+            mReceiveBuffer.erase(mReceiveBuffer.begin(), data_end) ;
+            mReadOperations.pop_front() ;
+        }
+    }
+
+    inline
+    AsyncSerialPort::Implementation::Completion
+    AsyncSerialPort::Implementation::FailRead(ReadOperation&           readOperation,
+                                              const std::exception_ptr error)
+    {
+        if (readOperation.hasTimer)
+        {
+            mSerialPortReactor.CancelTimer(readOperation.timerId) ;
+        }
+
+        if (readOperation.readHandler)
+        {
+            auto handler = std::move(readOperation.readHandler) ;
+            return [handler, error]() { handler(error, DataBuffer()) ; } ;
+        }
+
+        auto handler = std::move(readOperation.readUntilHandler) ;
+        return [handler, error]() { handler(error, std::string()) ; } ;
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::FailAllOperations(const std::exception_ptr error,
+                                                       std::vector<Completion>& completions)
+    {
+        for (auto& read_operation : mReadOperations)
+        {
+            completions.push_back(this->FailRead(read_operation,
+                                                 error)) ;
+        }
+
+        for (auto& write_operation : mWriteOperations)
+        {
+            const auto handler = write_operation.writeHandler ;
+            const auto number_of_bytes_written = write_operation.numberOfBytesWritten ;
+
+            completions.push_back([handler, error, number_of_bytes_written]()
+                                  {
+                                      handler(error, number_of_bytes_written) ;
+                                  }) ;
+        }
+
+        mReadOperations.clear() ;
+        mWriteOperations.clear() ;
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::UpdateInterest()
+    {
+        if (mClosed)
+        {
+            return ;
+        }
+
+        const auto readable_interest = (not mReadOperations.empty()) and (not mHungUp) ;
+        const auto writable_interest = (not mWriteOperations.empty()) and (not mHungUp) ;
+
+        if (readable_interest != mReadableInterest)
+        {
+            mSerialPortReactor.SetReadableInterest(mPortId,
+                                                   readable_interest) ;
+            mReadableInterest = readable_interest ;
+        }
+
+        if (writable_interest != mWritableInterest)
+        {
+            mSerialPortReactor.SetWritableInterest(mPortId,
+                                                   writable_interest) ;
+            mWritableInterest = writable_interest ;
+        }
+    }
+
+    inline
+    void
+    AsyncSerialPort::Implementation::InvokeCompletions(std::vector<Completion>& completions)
+    {
+        for (const auto& completion : completions)
+        {
+            completion() ;
+        }
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,493 @@
+/******************************************************************************
+ * @file BufferPool.cpp                                                       *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/BufferPool.h"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+
+namespace LibSerial
+{
+    /**
+     * @brief The maximum number of free blocks a thread caches per size
+     *        class before returning a batch to the depot.
+     */
+    constexpr size_t THREAD_CACHE_CAPACITY = 64 ;
+
+    /**
+     * @brief The number of blocks moved between a thread cache and the
+     *        depot at a time.
+     */
+    constexpr size_t TRANSFER_BATCH_SIZE = THREAD_CACHE_CAPACITY / 2 ;
+
+    /**
+     * @brief BufferPool::Depot holds free blocks shared by all threads.
+     */
+    class BufferPool::Depot
+    {
+    public:
+        /**
+         * @brief Gets the depot. The depot is never destroyed, so blocks
+         *        released during static destruction are still accepted.
+         * @return Returns the depot.
+         */
+        static Depot& Get() ;
+
+        /**
+         * @brief Moves up to TRANSFER_BATCH_SIZE blocks of a size class to
+         *        the specified list.
+         * @param sizeClass The size class.
+         * @param blocks The list receiving the blocks.
+         */
+        void Take(size_t              sizeClass,
+                  std::vector<void*>& blocks) ;
+
+        /**
+         * @brief Moves blocks of a size class from the end of the
+         *        specified list to the depot.
+         * @param sizeClass The size class.
+         * @param blocks The list the blocks are taken from.
+         * @param numberOfBlocks The number of blocks to move.
+         */
+        void Give(size_t              sizeClass,
+                  std::vector<void*>& blocks,
+                  size_t              numberOfBlocks) ;
+
+        /**
+         * @brief Adds a single block of a size class to the depot.
+         * @param sizeClass The size class.
+         * @param block The block.
+         */
+        void Give(size_t sizeClass,
+                  void*  block) ;
+
+        /**
+         * @brief Gets the number of blocks held by the depot.
+         * @return Returns the number of blocks.
+         */
+        size_t GetNumberOfBlocks() ;
+
+        /**
+         * @brief Releases all blocks held by the depot.
+         */
+        void Trim() ;
+
+    private:
+        /**
+         * @brief The free blocks of a single size class.
+         */
+        struct FreeList
+        {
+            /**
+             * @brief Mutex protecting the blocks.
+             */
+            std::mutex mutex {} ;
+
+            /**
+             * @brief The free blocks.
+             */
+            std::vector<void*> blocks {} ;
+        } ;
+
+        /**
+         * @brief The free blocks of each size class.
+         */
+        std::array<FreeList, BUFFER_POOL_SIZE_CLASSES> mFreeLists {} ;
+    } ;
+
+    /**
+     * @brief BufferPool::ThreadCache holds the free blocks of one thread.
+     */
+    class BufferPool::ThreadCache
+    {
+    public:
+        /**
+         * @brief Constructor.
+         */
+        ThreadCache() ;
+
+        /**
+         * @brief Destructor. Returns all cached blocks to the depot.
+         */
+        ~ThreadCache() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        ThreadCache(const ThreadCache& otherThreadCache) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        ThreadCache(ThreadCache&& otherThreadCache) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        ThreadCache& operator=(const ThreadCache& otherThreadCache) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        ThreadCache& operator=(ThreadCache&& otherThreadCache) = delete ;
+
+        /**
+         * @brief Gets the cache of the calling thread.
+         * @return Returns the cache, or nullptr if the calling thread is
+         *         exiting and its cache has already been destroyed.
+         */
+        static ThreadCache* Get() ;
+
+        /**
+         * @brief Allocates a block of a size class.
+         * @param sizeClass The size class.
+         * @return Returns a pointer to the block.
+         */
+        void* Allocate(size_t sizeClass) ;
+
+        /**
+         * @brief Returns a block of a size class to the cache.
+         * @param sizeClass The size class.
+         * @param block The block.
+         */
+        void Deallocate(size_t sizeClass,
+                        void*  block) ;
+
+        /**
+         * @brief Gets the number of blocks held by the cache.
+         * @return Returns the number of blocks.
+         */
+        size_t GetNumberOfBlocks() const ;
+
+        /**
+         * @brief Moves all cached blocks to the depot.
+         */
+        void Flush() ;
+
+    private:
+        /**
+         * @brief True while the cache of the calling thread is alive. This
+         *        is trivially destructible, so it can still be read after
+         *        the cache itself has been destroyed.
+         */
+        static thread_local bool sAlive ;
+
+        /**
+         * @brief The free blocks of each size class.
+         */
+        std::array<std::vector<void*>, BUFFER_POOL_SIZE_CLASSES> mBlocks {} ;
+    } ;
+
+    thread_local bool BufferPool::ThreadCache::sAlive = false ;
+
+    void*
+    BufferPool::Allocate(const size_t size)
+    {
+        if (size > BUFFER_POOL_MAXIMUM_BLOCK_SIZE)
+        {
+            return ::operator new(size) ;
+        }
+
+        const auto size_class = GetSizeClass(size) ;
+        auto* const thread_cache = ThreadCache::Get() ;
+
+        if (thread_cache == nullptr)
+        {
+            return ::operator new(BUFFER_POOL_MINIMUM_BLOCK_SIZE << (2 * size_class)) ;
+        }
+
+        return thread_cache->Allocate(size_class) ;
+    }
+
+    void
+    BufferPool::Deallocate(void* const  block,
+                           const size_t size) noexcept
+    {
+        if (block == nullptr)
+        {
+            return ;
+        }
+
+        if (size > BUFFER_POOL_MAXIMUM_BLOCK_SIZE)
+        {
+            ::operator delete(block) ;
+            return ;
+        }
+
+        const auto size_class = GetSizeClass(size) ;
+        auto* const thread_cache = ThreadCache::Get() ;
+
+        try
+        {
+            if (thread_cache == nullptr)
+            {
+                Depot::Get().Give(size_class, block) ;
+            }
+            else
+            {
+                thread_cache->Deallocate(size_class, block) ;
+            }
+        }
+        catch (const std::bad_alloc&)
+        {
+            // No room to remember the block, so hand it back to the system.
+            ::operator delete(block) ;
+        }
+    }
+
+    size_t
+    BufferPool::GetBlockSize(const size_t size)
+    {
+        if (size > BUFFER_POOL_MAXIMUM_BLOCK_SIZE)
+        {
+            return size ;
+        }
+
+        return BUFFER_POOL_MINIMUM_BLOCK_SIZE << (2 * GetSizeClass(size)) ;
+    }
+
+    size_t
+    BufferPool::GetNumberOfCachedBlocks()
+    {
+        const auto* const thread_cache = ThreadCache::Get() ;
+        const auto thread_blocks = (thread_cache != nullptr) ? thread_cache->GetNumberOfBlocks() : 0 ;
+
+        return thread_blocks + Depot::Get().GetNumberOfBlocks() ;
+    }
+
+    void
+    BufferPool::Trim()
+    {
+        auto* const thread_cache = ThreadCache::Get() ;
+
+        if (thread_cache != nullptr)
+        {
+            thread_cache->Flush() ;
+        }
+
+        Depot::Get().Trim() ;
+    }
+
+    size_t
+    BufferPool::GetSizeClass(const size_t size)
+    {
+        size_t size_class = 0 ;
+
+        while ((BUFFER_POOL_MINIMUM_BLOCK_SIZE << (2 * size_class)) < size)
+        {
+            ++size_class ;
+        }
+
+        return size_class ;
+    }
+
+    BufferPool::Depot&
+    BufferPool::Depot::Get()
+    {
+        static auto* const depot = new Depot() ; // NOLINT (cppcoreguidelines-owning-memory)
+        return *depot ;
+    }
+
+    void
+    BufferPool::Depot::Take(const size_t        sizeClass,
+                            std::vector<void*>& blocks)
+    {
+        auto& free_list = mFreeLists[sizeClass] ;
+        std::lock_guard<std::mutex> lock(free_list.mutex) ;
+
+        const auto number_of_blocks = std::min(free_list.blocks.size(),
+                                               TRANSFER_BATCH_SIZE) ;
+
+        blocks.insert(blocks.end(),
+                      free_list.blocks.end() - number_of_blocks,
+                      free_list.blocks.end()) ;
+
+        free_list.blocks.resize(free_list.blocks.size() - number_of_blocks) ;
+    }
+
+    void
+    BufferPool::Depot::Give(const size_t        sizeClass,
+                            std::vector<void*>& blocks,
+                            const size_t        numberOfBlocks)
+    {
+        auto& free_list = mFreeLists[sizeClass] ;
+        std::lock_guard<std::mutex> lock(free_list.mutex) ;
+
+        free_list.blocks.insert(free_list.blocks.end(),
+                                blocks.end() - numberOfBlocks,
+                                blocks.end()) ;
+
+        blocks.resize(blocks.size() - numberOfBlocks) ;
+    }
+
+    void
+    BufferPool::Depot::Give(const size_t sizeClass,
+                            void* const  block)
+    {
+        auto& free_list = mFreeLists[sizeClass] ;
+        std::lock_guard<std::mutex> lock(free_list.mutex) ;
+
+        free_list.blocks.push_back(block) ;
+    }
+
+    size_t
+    BufferPool::Depot::GetNumberOfBlocks()
+    {
+        size_t number_of_blocks = 0 ;
+
+        for (auto& free_list : mFreeLists)
+        {
+            std::lock_guard<std::mutex> lock(free_list.mutex) ;
+            number_of_blocks += free_list.blocks.size() ;
+        }
+
+        return number_of_blocks ;
+    }
+
+    void
+    BufferPool::Depot::Trim()
+    {
+        for (auto& free_list : mFreeLists)
+        {
+            std::vector<void*> blocks ;
+
+            {
+                std::lock_guard<std::mutex> lock(free_list.mutex) ;
+                blocks.swap(free_list.blocks) ;
+            }
+
+            for (auto* const block : blocks)
+            {
+                ::operator delete(block) ;
+            }
+        }
+    }
+
+    BufferPool::ThreadCache::ThreadCache()
+    {
+        // Reserve the lists up front so caching a block never allocates.
+        for (auto& blocks : mBlocks)
+        {
+            blocks.reserve(THREAD_CACHE_CAPACITY) ;
+        }
+
+        sAlive = true ;
+    }
+
+    BufferPool::ThreadCache::~ThreadCache()
+    {
+        sAlive = false ;
+
+        try
+        {
+            this->Flush() ;
+        }
+        catch (const std::bad_alloc&)
+        {
+            // The blocks are leaked rather than terminating a thread.
+        }
+    }
+
+    BufferPool::ThreadCache*
+    BufferPool::ThreadCache::Get()
+    {
+        // Once destroyed, the cache is not constructed again, so sAlive
+        // tells a thread that is being torn down to bypass its cache.
+        static thread_local ThreadCache thread_cache ;
+
+        return sAlive ? &thread_cache : nullptr ;
+    }
+
+    void*
+    BufferPool::ThreadCache::Allocate(const size_t sizeClass)
+    {
+        auto& blocks = mBlocks[sizeClass] ;
+
+        if (blocks.empty())
+        {
+            Depot::Get().Take(sizeClass, blocks) ;
+
+            if (blocks.empty())
+            {
+                return ::operator new(BUFFER_POOL_MINIMUM_BLOCK_SIZE << (2 * sizeClass)) ;
+            }
+        }
+
+        auto* const block = blocks.back() ;
+        blocks.pop_back() ;
+
+        return block ;
+    }
+
+    void
+    BufferPool::ThreadCache::Deallocate(const size_t sizeClass,
+                                        void* const  block)
+    {
+        auto& blocks = mBlocks[sizeClass] ;
+
+        if (blocks.size() == THREAD_CACHE_CAPACITY)
+        {
+            Depot::Get().Give(sizeClass,
+                              blocks,
+                              TRANSFER_BATCH_SIZE) ;
+        }
+
+        blocks.push_back(block) ;
+    }
+
+    size_t
+    BufferPool::ThreadCache::GetNumberOfBlocks() const
+    {
+        size_t number_of_blocks = 0 ;
+
+        for (const auto& blocks : mBlocks)
+        {
+            number_of_blocks += blocks.size() ;
+        }
+
+        return number_of_blocks ;
+    }
+
+    void
+    BufferPool::ThreadCache::Flush()
+    {
+        for (size_t size_class = 0 ; size_class < BUFFER_POOL_SIZE_CLASSES ; ++size_class)
+        {
+            Depot::Get().Give(size_class,
+                              mBlocks[size_class],
+                              mBlocks[size_class].size()) ;
+        }
+    }
+
+} // namespace LibSerial
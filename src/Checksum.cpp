@@ -0,0 +1,559 @@
+/******************************************************************************
+ * @file Checksum.cpp                                                         *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/Checksum.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace LibSerial
+{
+    /**
+     * @brief The slicing-by-8 lookup tables of a CRC. Entry k of table i
+     *        holds the CRC of byte k followed by i zero bytes, so that
+     *        eight bytes are folded into the CRC with eight lookups.
+     */
+    struct CrcTables
+    {
+        uint32_t entries[8][256] ; // NOLINT (cppcoreguidelines-avoid-c-arrays)
+    } ;
+
+    /**
+     * @brief A function that folds data into the state of a CRC-32.
+     */
+    using Crc32Kernel = uint32_t (*)(uint32_t       crc,
+                                     const uint8_t* data,
+                                     size_t         size) ;
+
+    /**
+     * @brief Builds the tables of a CRC that processes the least
+     *        significant bit of each byte first.
+     * @param polynomial The bit reversed polynomial.
+     * @return Returns the tables.
+     */
+    static CrcTables
+    MakeReflectedCrcTables(const uint32_t polynomial)
+    {
+        CrcTables crc_tables {} ;
+
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            auto crc = i ;
+
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc & 1U) ? ((crc >> 1U) ^ polynomial) : (crc >> 1U) ;
+            }
+
+            crc_tables.entries[0][i] = crc ;
+        }
+
+        for (size_t table = 1; table < 8; ++table)
+        {
+            for (size_t i = 0; i < 256; ++i)
+            {
+                const auto previous = crc_tables.entries[table - 1][i] ;
+                crc_tables.entries[table][i] = (previous >> 8U) ^ crc_tables.entries[0][previous & 0xFFU] ;
+            }
+        }
+
+        return crc_tables ;
+    }
+
+    /**
+     * @brief Builds the tables of a 16 bit CRC that processes the most
+     *        significant bit of each byte first.
+     * @param polynomial The polynomial.
+     * @return Returns the tables.
+     */
+    static CrcTables
+    MakeCrc16Tables(const uint32_t polynomial)
+    {
+        CrcTables crc_tables {} ;
+
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            auto crc = i << 8U ;
+
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc & 0x8000U) ? ((crc << 1U) ^ polynomial) : (crc << 1U) ;
+            }
+
+            crc_tables.entries[0][i] = crc & 0xFFFFU ;
+        }
+
+        for (size_t table = 1; table < 8; ++table)
+        {
+            for (size_t i = 0; i < 256; ++i)
+            {
+                const auto previous = crc_tables.entries[table - 1][i] ;
+                crc_tables.entries[table][i] = ((previous << 8U) ^ crc_tables.entries[0][previous >> 8U]) & 0xFFFFU ;
+            }
+        }
+
+        return crc_tables ;
+    }
+
+    /**
+     * @brief Loads a little endian 32 bit value.
+     * @param data Pointer to the four bytes.
+     * @return Returns the value.
+     */
+    static inline uint32_t
+    LoadLittleEndian32(const uint8_t* const data)
+    {
+        return static_cast<uint32_t>(data[0]) |
+               (static_cast<uint32_t>(data[1]) << 8U) |
+               (static_cast<uint32_t>(data[2]) << 16U) |
+               (static_cast<uint32_t>(data[3]) << 24U) ;
+    }
+
+    /**
+     * @brief Folds data into the state of a reflected CRC of up to 32 bits.
+     * @param crcTables The tables of the CRC.
+     * @param crc The current state.
+     * @param data Pointer to the data.
+     * @param size The number of bytes of data.
+     * @return Returns the new state.
+     */
+    static uint32_t
+    UpdateReflectedCrc(const CrcTables& crcTables,
+                       uint32_t         crc,
+                       const uint8_t*   data,
+                       size_t           size)
+    {
+        const auto& tables = crcTables.entries ;
+
+        while (size >= 8)
+        {
+            const auto low = LoadLittleEndian32(data) ^ crc ;
+            const auto high = LoadLittleEndian32(data + 4) ;
+
+            crc = tables[7][low & 0xFFU] ^
+                  tables[6][(low >> 8U) & 0xFFU] ^
+                  tables[5][(low >> 16U) & 0xFFU] ^
+                  tables[4][low >> 24U] ^
+                  tables[3][high & 0xFFU] ^
+                  tables[2][(high >> 8U) & 0xFFU] ^
+                  tables[1][(high >> 16U) & 0xFFU] ^
+                  tables[0][high >> 24U] ;
+
+            data += 8 ;
+            size -= 8 ;
+        }
+
+        for (; size > 0; --size)
+        {
+            crc = (crc >> 8U) ^ tables[0][(crc ^ *data++) & 0xFFU] ;
+        }
+
+        return crc ;
+    }
+
+    /**
+     * @brief Folds data into the state of a 16 bit CRC that processes the
+     *        most significant bit of each byte first.
+     * @param crcTables The tables of the CRC.
+     * @param crc The current state.
+     * @param data Pointer to the data.
+     * @param size The number of bytes of data.
+     * @return Returns the new state.
+     */
+    static uint32_t
+    UpdateCrc16(const CrcTables& crcTables,
+                uint32_t         crc,
+                const uint8_t*   data,
+                size_t           size)
+    {
+        const auto& tables = crcTables.entries ;
+
+        while (size >= 8)
+        {
+            crc = tables[7][data[0] ^ (crc >> 8U)] ^
+                  tables[6][data[1] ^ (crc & 0xFFU)] ^
+                  tables[5][data[2]] ^
+                  tables[4][data[3]] ^
+                  tables[3][data[4]] ^
+                  tables[2][data[5]] ^
+                  tables[1][data[6]] ^
+                  tables[0][data[7]] ;
+
+            data += 8 ;
+            size -= 8 ;
+        }
+
+        for (; size > 0; --size)
+        {
+            crc = ((crc << 8U) ^ tables[0][(crc >> 8U) ^ *data++]) & 0xFFFFU ;
+        }
+
+        return crc ;
+    }
+
+    /**
+     * @brief Gets the tables of CRC-16/CCITT-FALSE.
+     * @return Returns the tables.
+     */
+    static const CrcTables&
+    GetCrc16CcittTables()
+    {
+        static const auto crc_tables = MakeCrc16Tables(0x1021U) ;
+        return crc_tables ;
+    }
+
+    /**
+     * @brief Gets the tables of CRC-16/MODBUS.
+     * @return Returns the tables.
+     */
+    static const CrcTables&
+    GetCrc16ModbusTables()
+    {
+        static const auto crc_tables = MakeReflectedCrcTables(0xA001U) ;
+        return crc_tables ;
+    }
+
+    /**
+     * @brief Gets the tables of CRC-32.
+     * @return Returns the tables.
+     */
+    static const CrcTables&
+    GetCrc32Tables()
+    {
+        static const auto crc_tables = MakeReflectedCrcTables(0xEDB88320U) ;
+        return crc_tables ;
+    }
+
+    /**
+     * @brief Folds data into the state of a CRC-32 with slicing-by-8 tables.
+     * @param crc The current state.
+     * @param data Pointer to the data.
+     * @param size The number of bytes of data.
+     * @return Returns the new state.
+     */
+    static uint32_t
+    UpdateCrc32Tables(const uint32_t crc,
+                      const uint8_t* data,
+                      const size_t   size)
+    {
+        return UpdateReflectedCrc(GetCrc32Tables(), crc, data, size) ;
+    }
+
+#if defined(__x86_64__)
+    /**
+     * @brief Folds data into the state of a CRC-32 with carry-less
+     *        multiplication, as described in Intel's "Fast CRC Computation
+     *        for Generic Polynomials Using PCLMULQDQ Instruction". Four
+     *        128 bit lanes are folded 64 bytes at a time, then reduced to
+     *        32 bits with a Barrett reduction.
+     * @param crc The current state.
+     * @param data Pointer to the data.
+     * @param size The number of bytes of data, at least 64 and a multiple
+     *        of 16.
+     * @return Returns the new state.
+     */
+    __attribute__((target("pclmul,sse4.1")))
+    static uint32_t
+    FoldCrc32Pclmul(const uint32_t crc,
+                    const uint8_t* data,
+                    size_t         size)
+    {
+        // The folding constants x^(4*128+64), x^(4*128), x^(128+64), x^128
+        // and x^64 modulo P(x), bit reflected, followed by P(x) and the
+        // Barrett constant floor(x^64 / P(x)).
+        const auto k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL) ;
+        const auto k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL) ;
+        const auto k5k0 = _mm_set_epi64x(0x0000000000LL, 0x0163cd6124LL) ;
+        const auto poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL) ;
+        const auto mask32 = _mm_setr_epi32(-1, 0, -1, 0) ;
+
+        // NOLINTBEGIN (cppcoreguidelines-pro-type-reinterpret-cast)
+        auto x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00)) ;
+        auto x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10)) ;
+        auto x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20)) ;
+        auto x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30)) ;
+        x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc))) ;
+
+        data += 64 ;
+        size -= 64 ;
+
+        // Fold the four lanes over each further block of 64 bytes.
+        while (size >= 64)
+        {
+            const auto x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00) ;
+            const auto x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00) ;
+            const auto x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00) ;
+            const auto x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00) ;
+
+            x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11) ;
+            x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11) ;
+            x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11) ;
+            x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11) ;
+
+            x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00))) ;
+            x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10))) ;
+            x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20))) ;
+            x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30))) ;
+
+            data += 64 ;
+            size -= 64 ;
+        }
+
+        // Fold the four lanes into one.
+        auto x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00) ;
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x2), x5) ;
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00) ;
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x3), x5) ;
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00) ;
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x4), x5) ;
+
+        // Fold each remaining block of 16 bytes.
+        while (size >= 16)
+        {
+            x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00) ;
+            x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11),
+                                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(data))),
+                               x5) ;
+
+            data += 16 ;
+            size -= 16 ;
+        }
+        // NOLINTEND (cppcoreguidelines-pro-type-reinterpret-cast)
+
+        // Fold 128 bits to 64 bits.
+        x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10) ;
+        x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2) ;
+        x2 = _mm_srli_si128(x1, 4) ;
+        x1 = _mm_and_si128(x1, mask32) ;
+        x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00) ;
+        x1 = _mm_xor_si128(x1, x2) ;
+
+        // Barrett reduction to 32 bits.
+        x2 = _mm_and_si128(x1, mask32) ;
+        x2 = _mm_clmulepi64_si128(x2, poly, 0x10) ;
+        x2 = _mm_and_si128(x2, mask32) ;
+        x2 = _mm_clmulepi64_si128(x2, poly, 0x00) ;
+        x1 = _mm_xor_si128(x1, x2) ;
+
+        return static_cast<uint32_t>(_mm_extract_epi32(x1, 1)) ;
+    }
+
+    /**
+     * @brief Folds data into the state of a CRC-32, using carry-less
+     *        multiplication for all but the last few bytes.
+     * @param crc The current state.
+     * @param data Pointer to the data.
+     * @param size The number of bytes of data.
+     * @return Returns the new state.
+     */
+    static uint32_t
+    UpdateCrc32Pclmul(uint32_t       crc,
+                      const uint8_t* data,
+                      size_t         size)
+    {
+        if (size >= 64)
+        {
+            const auto folded_size = size & ~static_cast<size_t>(15) ;
+
+            crc = FoldCrc32Pclmul(crc, data, folded_size) ;
+            data += folded_size ;
+            size -= folded_size ;
+        }
+
+        return UpdateCrc32Tables(crc, data, size) ;
+    }
+#elif defined(__aarch64__)
+    /**
+     * @brief Folds data into the state of a CRC-32 with the ARMv8 CRC32
+     *        instructions, which implement this polynomial directly.
+     * @param crc The current state.
+     * @param data Pointer to the data.
+     * @param size The number of bytes of data.
+     * @return Returns the new state.
+     */
+    __attribute__((target("+crc")))
+    static uint32_t
+    UpdateCrc32Armv8(uint32_t       crc,
+                     const uint8_t* data,
+                     size_t         size)
+    {
+        while (size >= 8)
+        {
+            uint64_t value = 0 ;
+            std::memcpy(&value, data, sizeof(value)) ;
+            crc = __crc32d(crc, value) ;
+
+            data += 8 ;
+            size -= 8 ;
+        }
+
+        for (; size > 0; --size)
+        {
+            crc = __crc32b(crc, *data++) ;
+        }
+
+        return crc ;
+    }
+#endif
+
+    /**
+     * @brief Selects the fastest CRC-32 implementation the processor
+     *        supports.
+     * @return Returns the CRC-32 kernel.
+     */
+    static Crc32Kernel
+    SelectCrc32Kernel()
+    {
+#if defined(__x86_64__)
+        unsigned int eax = 0 ;
+        unsigned int ebx = 0 ;
+        unsigned int ecx = 0 ;
+        unsigned int edx = 0 ;
+
+        if ((__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) and
+            ((ecx & bit_PCLMUL) != 0) and
+            ((ecx & bit_SSE4_1) != 0))
+        {
+            return UpdateCrc32Pclmul ;
+        }
+#elif defined(__aarch64__)
+        if ((getauxval(AT_HWCAP) & HWCAP_CRC32) != 0)
+        {
+            return UpdateCrc32Armv8 ;
+        }
+#endif
+        return UpdateCrc32Tables ;
+    }
+
+    uint32_t
+    ComputeChecksum(const ChecksumType checksumType,
+                    const uint8_t*     data,
+                    const size_t       size)
+    {
+        switch (checksumType)
+        {
+        case ChecksumType::CRC_16_CCITT:
+            return UpdateCrc16(GetCrc16CcittTables(), 0xFFFFU, data, size) ;
+        case ChecksumType::CRC_16_MODBUS:
+            return UpdateReflectedCrc(GetCrc16ModbusTables(), 0xFFFFU, data, size) ;
+        case ChecksumType::CRC_32:
+        {
+            static const auto crc32_kernel = SelectCrc32Kernel() ;
+            return ~crc32_kernel(0xFFFFFFFFU, data, size) ;
+        }
+        default:
+            throw std::invalid_argument(ERR_MSG_INVALID_CHECKSUM_TYPE) ;
+        }
+    }
+
+    size_t
+    GetChecksumSize(const ChecksumType checksumType)
+    {
+        switch (checksumType)
+        {
+        case ChecksumType::CRC_16_CCITT:
+        case ChecksumType::CRC_16_MODBUS:
+            return 2 ;
+        case ChecksumType::CRC_32:
+            return 4 ;
+        default:
+            throw std::invalid_argument(ERR_MSG_INVALID_CHECKSUM_TYPE) ;
+        }
+    }
+
+    void
+    StoreChecksum(const ChecksumType checksumType,
+                  const uint32_t     checksum,
+                  uint8_t* const     destination)
+    {
+        const auto checksum_size = GetChecksumSize(checksumType) ;
+
+        for (size_t i = 0; i < checksum_size; ++i)
+        {
+            // CRC-16/CCITT is sent most significant byte first, the
+            // reflected CRCs least significant byte first.
+            const auto shift = (checksumType == ChecksumType::CRC_16_CCITT) ?
+                               8 * (checksum_size - 1 - i) : 8 * i ;
+
+            destination[i] = static_cast<uint8_t>(checksum >> shift) ;
+        }
+    }
+
+    void
+    AppendChecksum(const ChecksumType checksumType,
+                   DataBuffer&        dataBuffer)
+    {
+        const auto checksum = ComputeChecksum(checksumType,
+                                              dataBuffer.data(),
+                                              dataBuffer.size()) ;
+
+        const auto data_size = dataBuffer.size() ;
+        dataBuffer.resize(data_size + GetChecksumSize(checksumType)) ;
+
+        StoreChecksum(checksumType,
+                      checksum,
+                      dataBuffer.data() + data_size) ;
+    }
+
+    bool
+    VerifyChecksum(const ChecksumType checksumType,
+                   const uint8_t*     data,
+                   const size_t       size)
+    {
+        const auto checksum_size = GetChecksumSize(checksumType) ;
+
+        if (size < checksum_size)
+        {
+            return false ;
+        }
+
+        const auto data_size = size - checksum_size ;
+
+        uint8_t expected_checksum[4] {} ; // NOLINT (cppcoreguidelines-avoid-c-arrays)
+        StoreChecksum(checksumType,
+                      ComputeChecksum(checksumType, data, data_size),
+                      expected_checksum) ;
+
+        return std::memcmp(expected_checksum, data + data_size, checksum_size) == 0 ;
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,529 @@
+/******************************************************************************
+ * @file FrameCodec.cpp                                                       *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/FrameCodec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace LibSerial
+{
+    /**
+     * @brief The COBS frame delimiter.
+     */
+    constexpr uint8_t COBS_DELIMITER = 0x00 ;
+
+    /**
+     * @brief The largest COBS code, standing for 254 non-zero bytes that are
+     *        not followed by an implicit zero.
+     */
+    constexpr uint8_t COBS_MAXIMUM_CODE = 0xFF ;
+
+    /**
+     * @brief The SLIP special characters, see RFC 1055.
+     */
+    constexpr uint8_t SLIP_END     = 0xC0 ;
+    constexpr uint8_t SLIP_ESC     = 0xDB ;
+    constexpr uint8_t SLIP_ESC_END = 0xDC ;
+    constexpr uint8_t SLIP_ESC_ESC = 0xDD ;
+
+    LengthPrefixCodec::LengthPrefixCodec(const size_t lengthFieldSize,
+                                         const bool   bigEndian,
+                                         const size_t maximumPayloadSize)
+        : mLengthFieldSize(lengthFieldSize)
+        , mBigEndian(bigEndian)
+        , mMaximumPayloadSize(maximumPayloadSize)
+    {
+        if ((lengthFieldSize != 1) and
+            (lengthFieldSize != 2) and
+            (lengthFieldSize != 4))
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_LENGTH_FIELD) ;
+        }
+
+        // The payload size must also fit in the length field.
+        const auto largest_length = (lengthFieldSize == 4) ? 0xFFFFFFFFULL :
+                                                             (1ULL << (lengthFieldSize * BITS_PER_BYTE)) - 1 ;
+
+        mMaximumPayloadSize = static_cast<size_t>(std::min<unsigned long long>(maximumPayloadSize,
+                                                                               largest_length)) ;
+    }
+
+    DecodeResult
+    LengthPrefixCodec::Decode(uint8_t* const data,
+                              const size_t   size,
+                              size_t&        bytesConsumed,
+                              ConstBuffer&   frame)
+    {
+        if (size < mLengthFieldSize)
+        {
+            return DecodeResult::INCOMPLETE ;
+        }
+
+        size_t payload_size = 0 ;
+
+        for (size_t i = 0 ; i < mLengthFieldSize ; ++i)
+        {
+            const auto byte_index = mBigEndian ? i : (mLengthFieldSize - 1 - i) ;
+            payload_size = (payload_size << BITS_PER_BYTE) | data[byte_index] ;
+        }
+
+        if (payload_size > mMaximumPayloadSize)
+        {
+            // Drop a single byte and look for a plausible header after it.
+            bytesConsumed = 1 ;
+            return DecodeResult::INVALID ;
+        }
+
+        if (size - mLengthFieldSize < payload_size)
+        {
+            return DecodeResult::INCOMPLETE ;
+        }
+
+        frame.data = data + mLengthFieldSize ;
+        frame.size = payload_size ;
+        bytesConsumed = mLengthFieldSize + payload_size ;
+
+        return DecodeResult::FRAME ;
+    }
+
+    void
+    LengthPrefixCodec::Encode(const uint8_t* const payload,
+                              const size_t         payloadSize,
+                              DataBuffer&          encodedFrame) const
+    {
+        if (payloadSize > mMaximumPayloadSize)
+        {
+            throw std::invalid_argument(ERR_MSG_FRAME_TOO_LARGE) ;
+        }
+
+        const auto header_offset = encodedFrame.size() ;
+        encodedFrame.resize(header_offset + mLengthFieldSize) ;
+
+        for (size_t i = 0 ; i < mLengthFieldSize ; ++i)
+        {
+            const auto byte_index = mBigEndian ? (mLengthFieldSize - 1 - i) : i ;
+            encodedFrame[header_offset + byte_index] = static_cast<uint8_t>(payloadSize >> (i * BITS_PER_BYTE)) ;
+        }
+
+        encodedFrame.insert(encodedFrame.end(),
+                            payload,
+                            payload + payloadSize) ;
+    }
+
+    void
+    LengthPrefixCodec::Reset()
+    {
+        /* Empty */
+    }
+
+    DecodeResult
+    CobsCodec::Decode(uint8_t* const data,
+                      const size_t   size,
+                      size_t&        bytesConsumed,
+                      ConstBuffer&   frame)
+    {
+        // memchr() is vectorized by the C library, so the delimiter scan
+        // runs well above a byte per cycle.
+        const auto* const delimiter = static_cast<uint8_t*>(std::memchr(data + mScanOffset,
+                                                                        COBS_DELIMITER,
+                                                                        size - mScanOffset)) ;
+
+        if (delimiter == nullptr)
+        {
+            mScanOffset = size ;
+            return DecodeResult::INCOMPLETE ;
+        }
+
+        mScanOffset = 0 ;
+
+        const auto encoded_size = static_cast<size_t>(delimiter - data) ;
+        bytesConsumed = encoded_size + 1 ;
+
+        if (encoded_size == 0)
+        {
+            return DecodeResult::SKIPPED ;
+        }
+
+        // Each code byte is followed by code - 1 literal bytes, which are
+        // moved down over the code bytes already consumed.
+        size_t read_offset = 0 ;
+        size_t write_offset = 0 ;
+
+        while (read_offset < encoded_size)
+        {
+            const size_t code = data[read_offset] ;
+
+            if (read_offset + code > encoded_size)
+            {
+                return DecodeResult::INVALID ;
+            }
+
+            std::memmove(data + write_offset,
+                         data + read_offset + 1,
+                         code - 1) ;
+
+            write_offset += code - 1 ;
+            read_offset += code ;
+
+            if ((code != COBS_MAXIMUM_CODE) and
+                (read_offset < encoded_size))
+            {
+                data[write_offset++] = COBS_DELIMITER ;
+            }
+        }
+
+        frame.data = data ;
+        frame.size = write_offset ;
+
+        return DecodeResult::FRAME ;
+    }
+
+    void
+    CobsCodec::Encode(const uint8_t* const payload,
+                      const size_t         payloadSize,
+                      DataBuffer&          encodedFrame) const
+    {
+        // COBS adds at most one byte per 254 bytes, plus the code byte and
+        // the delimiter.
+        encodedFrame.reserve(encodedFrame.size() + payloadSize + payloadSize / 254 + 2) ;
+
+        const auto* position = payload ;
+        const auto* const end = payload + payloadSize ;
+
+        while (true)
+        {
+            const auto remaining = static_cast<size_t>(end - position) ;
+            const auto block_limit = std::min<size_t>(remaining, COBS_MAXIMUM_CODE - 1) ;
+
+            const auto* zero = static_cast<const uint8_t*>(std::memchr(position,
+                                                                       COBS_DELIMITER,
+                                                                       block_limit)) ;
+
+            const auto block_size = (zero != nullptr) ? static_cast<size_t>(zero - position) : block_limit ;
+
+            encodedFrame.push_back(static_cast<uint8_t>(block_size + 1)) ;
+            encodedFrame.insert(encodedFrame.end(),
+                                position,
+                                position + block_size) ;
+
+            position += block_size ;
+
+            if (zero != nullptr)
+            {
+                // The zero is implied by the code byte.
+                ++position ;
+                continue ;
+            }
+
+            if (position == end)
+            {
+                // A full block at the very end still needs a final code.
+                if (block_size == COBS_MAXIMUM_CODE - 1)
+                {
+                    encodedFrame.push_back(1) ;
+                }
+
+                break ;
+            }
+        }
+
+        encodedFrame.push_back(COBS_DELIMITER) ;
+    }
+
+    void
+    CobsCodec::Reset()
+    {
+        mScanOffset = 0 ;
+    }
+
+    DecodeResult
+    SlipCodec::Decode(uint8_t* const data,
+                      const size_t   size,
+                      size_t&        bytesConsumed,
+                      ConstBuffer&   frame)
+    {
+        const auto* const end_byte = static_cast<uint8_t*>(std::memchr(data + mScanOffset,
+                                                                       SLIP_END,
+                                                                       size - mScanOffset)) ;
+
+        if (end_byte == nullptr)
+        {
+            mScanOffset = size ;
+            return DecodeResult::INCOMPLETE ;
+        }
+
+        mScanOffset = 0 ;
+
+        const auto encoded_size = static_cast<size_t>(end_byte - data) ;
+        bytesConsumed = encoded_size + 1 ;
+
+        // Encoders send an END before each frame to flush line noise, so
+        // empty frames are expected and carry nothing.
+        if (encoded_size == 0)
+        {
+            return DecodeResult::SKIPPED ;
+        }
+
+        // Copy the runs between escape bytes down over the escapes.
+        size_t read_offset = 0 ;
+        size_t write_offset = 0 ;
+
+        while (read_offset < encoded_size)
+        {
+            const auto* const escape = static_cast<uint8_t*>(std::memchr(data + read_offset,
+                                                                         SLIP_ESC,
+                                                                         encoded_size - read_offset)) ;
+
+            const auto run_end = (escape != nullptr) ? static_cast<size_t>(escape - data) : encoded_size ;
+
+            std::memmove(data + write_offset,
+                         data + read_offset,
+                         run_end - read_offset) ;
+
+            write_offset += run_end - read_offset ;
+            read_offset = run_end ;
+
+            if (escape == nullptr)
+            {
+                break ;
+            }
+
+            if (read_offset + 1 >= encoded_size)
+            {
+                return DecodeResult::INVALID ;
+            }
+
+            const auto escaped_byte = data[read_offset + 1] ;
+
+            if (escaped_byte == SLIP_ESC_END)
+            {
+                data[write_offset++] = SLIP_END ;
+            }
+            else if (escaped_byte == SLIP_ESC_ESC)
+            {
+                data[write_offset++] = SLIP_ESC ;
+            }
+            else
+            {
+                return DecodeResult::INVALID ;
+            }
+
+            read_offset += 2 ;
+        }
+
+        frame.data = data ;
+        frame.size = write_offset ;
+
+        return DecodeResult::FRAME ;
+    }
+
+    void
+    SlipCodec::Encode(const uint8_t* const payload,
+                      const size_t         payloadSize,
+                      DataBuffer&          encodedFrame) const
+    {
+        encodedFrame.reserve(encodedFrame.size() + payloadSize + 2) ;
+        encodedFrame.push_back(SLIP_END) ;
+
+        const auto* run_start = payload ;
+        const auto* const end = payload + payloadSize ;
+
+        for (const auto* position = payload ; position < end ; ++position)
+        {
+            const auto byte = *position ;
+
+            if ((byte != SLIP_END) and
+                (byte != SLIP_ESC))
+            {
+                continue ;
+            }
+
+            encodedFrame.insert(encodedFrame.end(),
+                                run_start,
+                                position) ;
+            encodedFrame.push_back(SLIP_ESC) ;
+            encodedFrame.push_back((byte == SLIP_END) ? SLIP_ESC_END : SLIP_ESC_ESC) ;
+
+            run_start = position + 1 ;
+        }
+
+        encodedFrame.insert(encodedFrame.end(),
+                            run_start,
+                            end) ;
+        encodedFrame.push_back(SLIP_END) ;
+    }
+
+    void
+    SlipCodec::Reset()
+    {
+        mScanOffset = 0 ;
+    }
+
+    DelimiterCodec::DelimiterCodec(const std::string& delimiter)
+        : mDelimiter(delimiter)
+    {
+        if (delimiter.empty())
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_TERMINATOR) ;
+        }
+    }
+
+    DecodeResult
+    DelimiterCodec::Decode(uint8_t* const data,
+                           const size_t   size,
+                           size_t&        bytesConsumed,
+                           ConstBuffer&   frame)
+    {
+        const auto delimiter_size = mDelimiter.size() ;
+        const auto first_byte = static_cast<uint8_t>(mDelimiter[0]) ;
+
+        auto search_offset = mScanOffset ;
+
+        // Find candidates for the first delimiter byte with memchr() and
+        // confirm the rest of the delimiter with memcmp().
+        while (search_offset + delimiter_size <= size)
+        {
+            const auto* const candidate = static_cast<uint8_t*>(std::memchr(data + search_offset,
+                                                                            first_byte,
+                                                                            size - search_offset - delimiter_size + 1)) ;
+
+            if (candidate == nullptr)
+            {
+                break ;
+            }
+
+            if (std::memcmp(candidate, mDelimiter.data(), delimiter_size) == 0)
+            {
+                mScanOffset = 0 ;
+
+                frame.data = data ;
+                frame.size = static_cast<size_t>(candidate - data) ;
+                bytesConsumed = frame.size + delimiter_size ;
+
+                return DecodeResult::FRAME ;
+            }
+
+            search_offset = static_cast<size_t>(candidate - data) + 1 ;
+        }
+
+        // The tail may hold the start of a delimiter split across reads.
+        mScanOffset = (size >= delimiter_size) ? size - delimiter_size + 1 : 0 ;
+
+        return DecodeResult::INCOMPLETE ;
+    }
+
+    void
+    DelimiterCodec::Encode(const uint8_t* const payload,
+                           const size_t         payloadSize,
+                           DataBuffer&          encodedFrame) const
+    {
+        encodedFrame.insert(encodedFrame.end(),
+                            payload,
+                            payload + payloadSize) ;
+        encodedFrame.insert(encodedFrame.end(),
+                            mDelimiter.begin(),
+                            mDelimiter.end()) ;
+    }
+
+    void
+    DelimiterCodec::Reset()
+    {
+        mScanOffset = 0 ;
+    }
+
+    ChecksumCodec::ChecksumCodec(std::unique_ptr<FrameCodec> frameCodec,
+                                 const ChecksumType          checksumType)
+        : mFrameCodec(std::move(frameCodec))
+        , mChecksumType(checksumType)
+        , mChecksumSize(GetChecksumSize(checksumType))
+    {
+        if (mFrameCodec == nullptr)
+        {
+            throw std::invalid_argument(ERR_MSG_NO_FRAME_CODEC) ;
+        }
+    }
+
+    DecodeResult
+    ChecksumCodec::Decode(uint8_t* const data,
+                          const size_t   size,
+                          size_t&        bytesConsumed,
+                          ConstBuffer&   frame)
+    {
+        const auto decode_result = mFrameCodec->Decode(data,
+                                                       size,
+                                                       bytesConsumed,
+                                                       frame) ;
+
+        if (decode_result != DecodeResult::FRAME)
+        {
+            return decode_result ;
+        }
+
+        if (not VerifyChecksum(mChecksumType,
+                               frame.data,
+                               frame.size))
+        {
+            return DecodeResult::INVALID ;
+        }
+
+        frame.size -= mChecksumSize ;
+
+        return DecodeResult::FRAME ;
+    }
+
+    void
+    ChecksumCodec::Encode(const uint8_t* const payload,
+                          const size_t         payloadSize,
+                          DataBuffer&          encodedFrame) const
+    {
+        DataBuffer checked_payload(payloadSize + mChecksumSize) ;
+        std::copy(payload, payload + payloadSize, checked_payload.begin()) ;
+
+        StoreChecksum(mChecksumType,
+                      ComputeChecksum(mChecksumType, payload, payloadSize),
+                      checked_payload.data() + payloadSize) ;
+
+        mFrameCodec->Encode(checked_payload.data(),
+                            checked_payload.size(),
+                            encodedFrame) ;
+    }
+
+    void
+    ChecksumCodec::Reset()
+    {
+        mFrameCodec->Reset() ;
+    }
+
+} // namespace LibSerial
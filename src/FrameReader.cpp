@@ -0,0 +1,393 @@
+/******************************************************************************
+ * @file FrameReader.cpp                                                      *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/FrameReader.h"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace LibSerial
+{
+    /**
+     * @brief FrameReader::Implementation is the FrameReader implementation
+     *        class.
+     */
+    class FrameReader::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param serialPort The open serial port to read frames from.
+         * @param frameCodec The codec used to decode frames.
+         * @param bufferSize The size of the receive buffer.
+         */
+        explicit Implementation(SerialPort&                 serialPort,
+                                std::unique_ptr<FrameCodec> frameCodec,
+                                size_t                      bufferSize) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        ~Implementation() = default ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Reads the next frame from the serial port.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns a view of the decoded frame payload.
+         */
+        ConstBuffer ReadFrame(size_t msTimeout) ;
+
+        /**
+         * @brief Decodes a frame from data that has already been received.
+         * @param frame Set to a view of the decoded frame payload.
+         * @return Returns true if a frame was decoded.
+         */
+        bool TryReadFrame(ConstBuffer& frame) ;
+
+        /**
+         * @brief Gets the number of malformed or oversized frames discarded.
+         * @return Returns the number of frames discarded.
+         */
+        size_t GetNumberOfInvalidFrames() const ;
+
+        /**
+         * @brief Gets the number of received bytes not yet decoded.
+         * @return Returns the number of bytes held in the receive buffer.
+         */
+        size_t GetNumberOfBufferedBytes() const ;
+
+        /**
+         * @brief Gets the codec used to decode frames.
+         * @return Returns a reference to the frame codec.
+         */
+        const FrameCodec& GetFrameCodec() const ;
+
+        /**
+         * @brief Discards all buffered data and any partial frame.
+         */
+        void Reset() ;
+
+    private:
+        /**
+         * @brief Reads whatever data is available from the serial port into
+         *        the free space at the end of the receive buffer, moving a
+         *        partial frame to the start of the buffer first if needed.
+         * @param msTimeout The timeout period in milliseconds, or zero to
+         *        wait indefinitely.
+         */
+        void FillBuffer(size_t msTimeout) ;
+
+        /**
+         * @brief The serial port frames are read from.
+         */
+        SerialPort& mSerialPort ;
+
+        /**
+         * @brief The codec used to decode frames.
+         */
+        std::unique_ptr<FrameCodec> mFrameCodec ;
+
+        /**
+         * @brief The receive buffer. Frames are decoded in place, so the
+         *        buffer is kept linear rather than wrapping around: a
+         *        partial frame is moved to the front when the end of the
+         *        buffer is reached.
+         */
+        std::vector<uint8_t> mBuffer ;
+
+        /**
+         * @brief The offset of the first byte not yet decoded.
+         */
+        size_t mFrameStart = 0 ;
+
+        /**
+         * @brief The offset one past the last byte received.
+         */
+        size_t mDataEnd = 0 ;
+
+        /**
+         * @brief The number of malformed or oversized frames discarded.
+         */
+        size_t mNumberOfInvalidFrames = 0 ;
+    } ;
+
+    FrameReader::FrameReader(SerialPort&                 serialPort,
+                             std::unique_ptr<FrameCodec> frameCodec,
+                             const size_t                bufferSize)
+        : mImpl(new Implementation(serialPort,
+                                   std::move(frameCodec),
+                                   bufferSize))
+    {
+        /* Empty */
+    }
+
+    FrameReader::~FrameReader() = default ;
+
+    ConstBuffer
+    FrameReader::ReadFrame(const size_t msTimeout)
+    {
+        return mImpl->ReadFrame(msTimeout) ;
+    }
+
+    void
+    FrameReader::ReadFrame(DataBuffer&  frame,
+                           const size_t msTimeout)
+    {
+        const auto frame_view = mImpl->ReadFrame(msTimeout) ;
+        frame.assign(frame_view.data,
+                     frame_view.data + frame_view.size) ;
+    }
+
+    void
+    FrameReader::ReadFrame(PooledDataBuffer& frame,
+                           const size_t      msTimeout)
+    {
+        const auto frame_view = mImpl->ReadFrame(msTimeout) ;
+        frame.assign(frame_view.data,
+                     frame_view.data + frame_view.size) ;
+    }
+
+    bool
+    FrameReader::TryReadFrame(ConstBuffer& frame)
+    {
+        return mImpl->TryReadFrame(frame) ;
+    }
+
+    size_t
+    FrameReader::GetNumberOfInvalidFrames() const
+    {
+        return mImpl->GetNumberOfInvalidFrames() ;
+    }
+
+    size_t
+    FrameReader::GetNumberOfBufferedBytes() const
+    {
+        return mImpl->GetNumberOfBufferedBytes() ;
+    }
+
+    void
+    FrameReader::Reset()
+    {
+        mImpl->Reset() ;
+    }
+
+    const FrameCodec&
+    FrameReader::GetFrameCodec() const
+    {
+        return mImpl->GetFrameCodec() ;
+    }
+
+    inline
+    FrameReader::Implementation::Implementation(SerialPort&                 serialPort,
+                                                std::unique_ptr<FrameCodec> frameCodec,
+                                                const size_t                bufferSize)
+        : mSerialPort(serialPort)
+        , mFrameCodec(std::move(frameCodec))
+        , mBuffer(bufferSize)
+    {
+        if (mFrameCodec == nullptr)
+        {
+            throw std::invalid_argument(ERR_MSG_NO_FRAME_CODEC) ;
+        }
+
+        if (bufferSize == 0)
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_BUFFER_SIZE) ;
+        }
+    }
+
+    inline
+    ConstBuffer
+    FrameReader::Implementation::ReadFrame(const size_t msTimeout)
+    {
+        ConstBuffer frame {} ;
+
+        if (this->TryReadFrame(frame))
+        {
+            return frame ;
+        }
+
+        // Obtain the entry time.
+        const auto entry_time = std::chrono::steady_clock::now() ;
+
+        while (true)
+        {
+            size_t remaining_ms = 0 ;
+
+            if (msTimeout > 0)
+            {
+                const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - entry_time).count() ;
+
+                if (static_cast<size_t>(elapsed_ms) >= msTimeout)
+                {
+                    throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+                }
+
+                remaining_ms = msTimeout - static_cast<size_t>(elapsed_ms) ;
+            }
+
+            this->FillBuffer(remaining_ms) ;
+
+            if (this->TryReadFrame(frame))
+            {
+                return frame ;
+            }
+        }
+    }
+
+    inline
+    bool
+    FrameReader::Implementation::TryReadFrame(ConstBuffer& frame)
+    {
+        while (mFrameStart < mDataEnd)
+        {
+            size_t bytes_consumed = 0 ;
+
+            const auto result = mFrameCodec->Decode(mBuffer.data() + mFrameStart,
+                                                    mDataEnd - mFrameStart,
+                                                    bytes_consumed,
+                                                    frame) ;
+
+            if (result == DecodeResult::INCOMPLETE)
+            {
+                return false ;
+            }
+
+            // The frame stays in the buffer until the next read compacts it.
+            mFrameStart += bytes_consumed ;
+
+            if (result == DecodeResult::FRAME)
+            {
+                return true ;
+            }
+
+            if (result == DecodeResult::INVALID)
+            {
+                ++mNumberOfInvalidFrames ;
+            }
+        }
+
+        return false ;
+    }
+
+    inline
+    size_t
+    FrameReader::Implementation::GetNumberOfInvalidFrames() const
+    {
+        return mNumberOfInvalidFrames ;
+    }
+
+    inline
+    size_t
+    FrameReader::Implementation::GetNumberOfBufferedBytes() const
+    {
+        return mDataEnd - mFrameStart ;
+    }
+
+    inline
+    void
+    FrameReader::Implementation::Reset()
+    {
+        mFrameStart = 0 ;
+        mDataEnd = 0 ;
+        mFrameCodec->Reset() ;
+    }
+
+    inline
+    const FrameCodec&
+    FrameReader::Implementation::GetFrameCodec() const
+    {
+        return *mFrameCodec ;
+    }
+
+    inline
+    void
+    FrameReader::Implementation::FillBuffer(const size_t msTimeout)
+    {
+        if (mFrameStart == mDataEnd)
+        {
+            mFrameStart = 0 ;
+            mDataEnd = 0 ;
+        }
+
+        if (mDataEnd == mBuffer.size())
+        {
+            if (mFrameStart == 0)
+            {
+                // The partial frame fills the whole buffer and can never
+                // complete, so drop it and resynchronize on new data.
+                ++mNumberOfInvalidFrames ;
+                this->Reset() ;
+            }
+            else
+            {
+                // Codecs track their scan position relative to the frame
+                // start, so moving the partial frame keeps their state valid.
+                std::memmove(mBuffer.data(),
+                             mBuffer.data() + mFrameStart,
+                             mDataEnd - mFrameStart) ;
+
+                mDataEnd -= mFrameStart ;
+                mFrameStart = 0 ;
+            }
+        }
+
+        mDataEnd += mSerialPort.Read(mBuffer.data() + mDataEnd,
+                                     mBuffer.size() - mDataEnd,
+                                     msTimeout) ;
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,1622 @@
+/******************************************************************************
+ * @file IoUringEngine.cpp                                                    *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/IoUringEngine.h"
+#include "TransmitQueue.h"
+
+#include <stdexcept>
+
+#ifdef LIBSERIAL_ENABLE_IO_URING
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <linux/io_uring.h>
+#include <map>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+#endif
+
+namespace LibSerial
+{
+#ifdef LIBSERIAL_ENABLE_IO_URING
+    /**
+     * @brief The opcode of IORING_OP_READ_MULTISHOT, (Linux 6.7), which is
+     *        missing from older kernel headers. Single shot reads are used
+     *        when the running kernel does not support it.
+     */
+    constexpr uint8_t IO_URING_OP_READ_MULTISHOT = 49 ;
+
+    /**
+     * @brief The number of opcodes requested when probing the kernel.
+     */
+    constexpr size_t IO_URING_PROBE_OPCODES = 256 ;
+
+    /**
+     * @brief The largest number of buffers in an io_uring buffer ring.
+     */
+    constexpr size_t IO_URING_BUFFERS_MAXIMUM = 32768 ;
+
+    /**
+     * @brief The number of low bits of the completion user data holding the
+     *        request type. The remaining bits hold the port id.
+     */
+    constexpr uint64_t IO_URING_REQUEST_TYPE_BITS = 2 ;
+
+    /**
+     * @brief The type of request a completion belongs to.
+     */
+    enum class IoUringRequestType : uint64_t
+    {
+        IO_URING_REQUEST_READ,
+        IO_URING_REQUEST_WRITE,
+        IO_URING_REQUEST_CANCEL,
+        IO_URING_REQUEST_DRAIN,
+    } ;
+
+    /**
+     * @brief IoUringEngine::Implementation is the IoUringEngine
+     *        implementation class.
+     */
+    class IoUringEngine::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor. Creates and maps the io_uring instance and
+         *        registers the receive buffer ring.
+         * @param ioUringEnginePolicy The queue and buffer sizes.
+         */
+        explicit Implementation(const IoUringEnginePolicy& ioUringEnginePolicy) ;
+
+        /**
+         * @brief Default Destructor. Removes all ports and releases the
+         *        io_uring instance.
+         */
+        ~Implementation() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Adds an open serial port and arms its read.
+         * @param serialPort The serial port.
+         * @param callbacks The callbacks to invoke for the serial port.
+         * @return Returns the handle identifying the serial port.
+         */
+        PortId Add(SerialPort&      serialPort,
+                   const Callbacks& callbacks) ;
+
+        /**
+         * @brief Cancels the requests of a port and removes it.
+         * @param portId The handle of the port to be removed.
+         */
+        void Remove(PortId portId) ;
+
+        /**
+         * @brief Gets the number of ports added to the engine.
+         * @return Returns the number of ports.
+         */
+        size_t GetNumberOfPorts() const ;
+
+        /**
+         * @brief Queues data to be written to a port.
+         * @param portId The handle of the port.
+         * @param dataBuffer Pointer to the data to be written.
+         * @param numberOfBytes The number of bytes to be written.
+         * @param drainWriteBuffer True to drain the data once written.
+         */
+        void Write(PortId         portId,
+                   const uint8_t* dataBuffer,
+                   size_t         numberOfBytes,
+                   bool           drainWriteBuffer) ;
+
+        /**
+         * @brief Submits all queued requests without waiting.
+         * @return Returns the number of requests submitted.
+         */
+        size_t Submit() ;
+
+        /**
+         * @brief Submits all queued requests, waits for and dispatches
+         *        completions.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t RunOnce(size_t msTimeout) ;
+
+        /**
+         * @brief Gets the number of io_uring_enter() system calls made.
+         * @return Returns the number of system calls.
+         */
+        size_t GetNumberOfSystemCalls() const ;
+
+    private:
+        /**
+         * @brief The data of one Write() call.
+         */
+        struct WriteRequest
+        {
+            /**
+             * @brief A copy of the data to be written.
+             */
+            DataBuffer data {} ;
+
+            /**
+             * @brief The number of bytes already written.
+             */
+            size_t numberOfBytesWritten = 0 ;
+
+            /**
+             * @brief True to drain the data once written.
+             */
+            bool drainWriteBuffer = false ;
+
+            /**
+             * @brief True while a write request for the data is queued or
+             *        being executed by the kernel.
+             */
+            bool inFlight = false ;
+        } ;
+
+        /**
+         * @brief The state of a port added to the engine.
+         */
+        struct PortEntry
+        {
+            /**
+             * @brief The file descriptor of the serial port.
+             */
+            int fileDescriptor = -1 ;
+
+            /**
+             * @brief The callbacks to invoke for the port.
+             */
+            Callbacks callbacks {} ;
+
+            /**
+             * @brief The writes not yet completed, oldest first. The writes
+             *        in flight are always at the front.
+             */
+            std::deque<WriteRequest> writeRequests {} ;
+
+            /**
+             * @brief The number of write requests in flight.
+             */
+            size_t numberOfWritesInFlight = 0 ;
+
+            /**
+             * @brief True while a read request is queued or armed.
+             */
+            bool readArmed = false ;
+
+            /**
+             * @brief False once reading has failed.
+             */
+            bool readable = true ;
+
+            /**
+             * @brief True once Remove() has been called. No callbacks are
+             *        invoked and no requests are queued from then on.
+             */
+            bool removed = false ;
+
+            /**
+             * @brief True while the port is in mPortsWithQueuedWrites.
+             */
+            bool writesScheduled = false ;
+
+            /**
+             * @brief The number of bytes written and the errno value of each
+             *        write completed while the data drains, oldest first.
+             *        Their callbacks are invoked, in order, once it has
+             *        drained, and no further writes are queued meanwhile.
+             */
+            std::vector<std::pair<size_t, int>> drainedWrites {} ;
+
+            /**
+             * @brief True while the timeout that polls the drain is queued
+             *        or armed.
+             */
+            bool drainArmed = false ;
+
+            /**
+             * @brief The period of the drain timeout, which must remain
+             *        valid until the timeout has been submitted.
+             */
+            __kernel_timespec drainTimeout {} ;
+        } ;
+
+        /**
+         * @brief Unmaps and closes the io_uring instance and the buffer ring.
+         */
+        void ReleaseRing() ;
+
+        /**
+         * @brief Finds a port.
+         * @param portId The handle of the port.
+         * @return Returns the port entry, or nullptr if there is none.
+         */
+        PortEntry* FindPortEntry(PortId portId) const ;
+
+        /**
+         * @brief Gets a free submission queue entry, submitting the queued
+         *        entries if the queue is full.
+         * @return Returns the cleared submission queue entry.
+         */
+        io_uring_sqe* GetSubmissionQueueEntry() ;
+
+        /**
+         * @brief Gets the number of submission queue entries not yet
+         *        submitted.
+         * @return Returns the number of queued entries.
+         */
+        unsigned GetNumberOfQueuedEntries() const ;
+
+        /**
+         * @brief Submits the queued entries and optionally waits for
+         *        completions with a single io_uring_enter() call.
+         * @param minimumCompletions The number of completions to wait for.
+         * @param msTimeout The timeout period in milliseconds when waiting,
+         *        or zero to wait without a timeout.
+         */
+        void Enter(unsigned minimumCompletions,
+                   size_t   msTimeout) ;
+
+        /**
+         * @brief Queues the read request of a port.
+         * @param portId The handle of the port.
+         * @param portEntry The port entry.
+         */
+        void ArmRead(PortId     portId,
+                     PortEntry& portEntry) ;
+
+        /**
+         * @brief Queues the write requests of every port that has data
+         *        waiting and no write in flight. The writes of each port
+         *        form one linked chain, so that they execute in order.
+         */
+        void QueueWrites() ;
+
+        /**
+         * @brief Dispatches all completions that have arrived.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t ProcessCompletions() ;
+
+        /**
+         * @brief Handles the completion of a read request.
+         * @param portId The handle of the port.
+         * @param result The result of the read.
+         * @param completionFlags The flags of the completion.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t HandleReadCompletion(PortId   portId,
+                                    int      result,
+                                    unsigned completionFlags) ;
+
+        /**
+         * @brief Handles the completion of a write request.
+         * @param portId The handle of the port.
+         * @param result The result of the write.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t HandleWriteCompletion(PortId portId,
+                                     int    result) ;
+
+        /**
+         * @brief Checks whether the written data of a port has drained,
+         *        and either invokes the writeComplete callbacks of the
+         *        drained writes or arms a timeout for about as long as the
+         *        remaining data takes to transmit. tcdrain() would block
+         *        every port, and io_uring cannot issue it for a tty.
+         * @param portId The handle of the port.
+         * @param portEntry The port entry.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t PollDrain(PortId     portId,
+                         PortEntry& portEntry) ;
+
+        /**
+         * @brief Queues the drain timeout of a port.
+         * @param portId The handle of the port.
+         * @param portEntry The port entry.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ArmDrain(PortId     portId,
+                      PortEntry& portEntry,
+                      size_t     msTimeout) ;
+
+        /**
+         * @brief Handles the expiry of the drain timeout of a port.
+         * @param portId The handle of the port.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t HandleDrainCompletion(PortId portId) ;
+
+        /**
+         * @brief Schedules the queued writes of a port for submission.
+         * @param portEntry The port entry.
+         */
+        void ScheduleWrites(PortEntry& portEntry) ;
+
+        /**
+         * @brief Returns a receive buffer to the buffer ring.
+         * @param bufferId The id of the buffer.
+         */
+        void RecycleBuffer(uint16_t bufferId) ;
+
+        /**
+         * @brief The queue and buffer sizes.
+         */
+        IoUringEnginePolicy mIoUringEnginePolicy ;
+
+        /**
+         * @brief The io_uring file descriptor.
+         */
+        int mRingFileDescriptor = -1 ;
+
+        /**
+         * @brief The mapping of the submission queue ring.
+         */
+        void* mSubmissionRing = MAP_FAILED ; // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+
+        /**
+         * @brief The size of the submission queue ring mapping.
+         */
+        size_t mSubmissionRingSize = 0 ;
+
+        /**
+         * @brief The mapping of the completion queue ring, which is the
+         *        submission queue ring mapping on kernels with
+         *        IORING_FEAT_SINGLE_MMAP.
+         */
+        void* mCompletionRing = MAP_FAILED ; // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+
+        /**
+         * @brief The size of the completion queue ring mapping.
+         */
+        size_t mCompletionRingSize = 0 ;
+
+        /**
+         * @brief The mapping of the submission queue entries.
+         */
+        io_uring_sqe* mSubmissionQueueEntries = nullptr ;
+
+        /**
+         * @brief The size of the submission queue entries mapping.
+         */
+        size_t mSubmissionQueueEntriesSize = 0 ;
+
+        /**
+         * @brief The submission queue head, advanced by the kernel.
+         */
+        unsigned* mSubmissionHead = nullptr ;
+
+        /**
+         * @brief The submission queue tail, advanced by the engine.
+         */
+        unsigned* mSubmissionTail = nullptr ;
+
+        /**
+         * @brief The submission queue index array.
+         */
+        unsigned* mSubmissionArray = nullptr ;
+
+        /**
+         * @brief The submission queue index mask.
+         */
+        unsigned mSubmissionMask = 0 ;
+
+        /**
+         * @brief The number of submission queue entries.
+         */
+        unsigned mSubmissionEntries = 0 ;
+
+        /**
+         * @brief The tail of the entries filled in, which is published to
+         *        the kernel on submission.
+         */
+        unsigned mSubmissionLocalTail = 0 ;
+
+        /**
+         * @brief The completion queue head, advanced by the engine.
+         */
+        unsigned* mCompletionHead = nullptr ;
+
+        /**
+         * @brief The completion queue tail, advanced by the kernel.
+         */
+        unsigned* mCompletionTail = nullptr ;
+
+        /**
+         * @brief The completion queue index mask.
+         */
+        unsigned mCompletionMask = 0 ;
+
+        /**
+         * @brief The completion queue entries.
+         */
+        io_uring_cqe* mCompletionQueueEntries = nullptr ;
+
+        /**
+         * @brief The receive buffer ring shared with the kernel, an array of
+         *        io_uring_buf whose first resv field holds the ring tail.
+         *        The entries are not accessed through io_uring_buf_ring, as
+         *        the offset of its flexible array member is wrong when the
+         *        kernel header is compiled as C++.
+         */
+        io_uring_buf* mBufferRing = nullptr ;
+
+        /**
+         * @brief The size of the receive buffer ring mapping.
+         */
+        size_t mBufferRingSize = 0 ;
+
+        /**
+         * @brief The tail of the receive buffer ring.
+         */
+        uint16_t mBufferRingTail = 0 ;
+
+        /**
+         * @brief The memory of all receive buffers.
+         */
+        std::vector<uint8_t> mBufferStorage {} ;
+
+        /**
+         * @brief The opcode used for reads, IO_URING_OP_READ_MULTISHOT or
+         *        IORING_OP_READ.
+         */
+        uint8_t mReadOpcode = IORING_OP_READ ;
+
+        /**
+         * @brief The ports added to the engine.
+         */
+        std::map<PortId, std::unique_ptr<PortEntry>> mPortEntries {} ;
+
+        /**
+         * @brief The ports with writes waiting to be queued.
+         */
+        std::vector<PortId> mPortsWithQueuedWrites {} ;
+
+        /**
+         * @brief The handle of the next port to be added.
+         */
+        PortId mNextPortId = 1 ;
+
+        /**
+         * @brief The number of io_uring_enter() system calls made.
+         */
+        size_t mNumberOfSystemCalls = 0 ;
+    } ;
+#else
+    /**
+     * @brief IoUringEngine::Implementation stands in for the io_uring
+     *        implementation when it is not compiled in. It cannot be
+     *        constructed.
+     */
+    class IoUringEngine::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor. Always throws.
+         */
+        explicit Implementation(const IoUringEnginePolicy& /* ioUringEnginePolicy */)
+        {
+            throw std::runtime_error(ERR_MSG_IO_URING_UNAVAILABLE) ;
+        }
+
+        /**
+         * @brief Never called, as the constructor throws.
+         */
+        PortId Add(SerialPort& /* serialPort */, const Callbacks& /* callbacks */) { return 0 ; }
+
+        /**
+         * @brief Never called, as the constructor throws.
+         */
+        void Remove(PortId /* portId */) {}
+
+        /**
+         * @brief Never called, as the constructor throws.
+         */
+        size_t GetNumberOfPorts() const { return 0 ; }
+
+        /**
+         * @brief Never called, as the constructor throws.
+         */
+        void Write(PortId /* portId */, const uint8_t* /* dataBuffer */, size_t /* numberOfBytes */, bool /* drainWriteBuffer */) {}
+
+        /**
+         * @brief Never called, as the constructor throws.
+         */
+        size_t Submit() { return 0 ; }
+
+        /**
+         * @brief Never called, as the constructor throws.
+         */
+        size_t RunOnce(size_t /* msTimeout */) { return 0 ; }
+
+        /**
+         * @brief Never called, as the constructor throws.
+         */
+        size_t GetNumberOfSystemCalls() const { return 0 ; }
+    } ;
+#endif
+
+    IoUringEngine::IoUringEngine(const IoUringEnginePolicy& ioUringEnginePolicy)
+        : mImpl(new Implementation(ioUringEnginePolicy))
+    {
+        /* Empty */
+    }
+
+    IoUringEngine::~IoUringEngine() = default ;
+
+    bool
+    IoUringEngine::IsSupported()
+    {
+        static const bool is_supported = []()
+        {
+            try
+            {
+                IoUringEnginePolicy io_uring_engine_policy ;
+                io_uring_engine_policy.queueDepth = 4 ;
+                io_uring_engine_policy.bufferSize = 16 ;
+                io_uring_engine_policy.numberOfBuffers = 1 ;
+
+                const Implementation implementation(io_uring_engine_policy) ;
+                return true ;
+            }
+            catch (const std::exception&)
+            {
+                return false ;
+            }
+        }() ;
+
+        return is_supported ;
+    }
+
+    IoUringEngine::PortId
+    IoUringEngine::Add(SerialPort&      serialPort,
+                       const Callbacks& callbacks)
+    {
+        return mImpl->Add(serialPort,
+                          callbacks) ;
+    }
+
+    void
+    IoUringEngine::Remove(const PortId portId)
+    {
+        mImpl->Remove(portId) ;
+    }
+
+    size_t
+    IoUringEngine::GetNumberOfPorts() const
+    {
+        return mImpl->GetNumberOfPorts() ;
+    }
+
+    void
+    IoUringEngine::Write(const PortId         portId,
+                         const uint8_t* const dataBuffer,
+                         const size_t         numberOfBytes,
+                         const bool           drainWriteBuffer)
+    {
+        mImpl->Write(portId,
+                     dataBuffer,
+                     numberOfBytes,
+                     drainWriteBuffer) ;
+    }
+
+    void
+    IoUringEngine::Write(const PortId      portId,
+                         const DataBuffer& dataBuffer,
+                         const bool        drainWriteBuffer)
+    {
+        mImpl->Write(portId,
+                     dataBuffer.data(),
+                     dataBuffer.size(),
+                     drainWriteBuffer) ;
+    }
+
+    void
+    IoUringEngine::Write(const PortId       portId,
+                         const std::string& dataString,
+                         const bool         drainWriteBuffer)
+    {
+        mImpl->Write(portId,
+                     reinterpret_cast<const uint8_t*>(dataString.data()), // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                     dataString.size(),
+                     drainWriteBuffer) ;
+    }
+
+    size_t
+    IoUringEngine::Submit()
+    {
+        return mImpl->Submit() ;
+    }
+
+    size_t
+    IoUringEngine::RunOnce(const size_t msTimeout)
+    {
+        return mImpl->RunOnce(msTimeout) ;
+    }
+
+    size_t
+    IoUringEngine::GetNumberOfSystemCalls() const
+    {
+        return mImpl->GetNumberOfSystemCalls() ;
+    }
+
+#ifdef LIBSERIAL_ENABLE_IO_URING
+    inline
+    IoUringEngine::Implementation::Implementation(const IoUringEnginePolicy& ioUringEnginePolicy)
+        : mIoUringEnginePolicy(ioUringEnginePolicy)
+    {
+        const auto number_of_buffers = mIoUringEnginePolicy.numberOfBuffers ;
+
+        if ((mIoUringEnginePolicy.queueDepth == 0) or
+            (mIoUringEnginePolicy.bufferSize == 0) or
+            (mIoUringEnginePolicy.bufferSize > std::numeric_limits<uint32_t>::max()))
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_BUFFER_SIZE) ;
+        }
+
+        if ((number_of_buffers == 0) or
+            (number_of_buffers > IO_URING_BUFFERS_MAXIMUM) or
+            ((number_of_buffers & (number_of_buffers - 1)) != 0))
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_BUFFER_COUNT) ;
+        }
+
+        io_uring_params io_uring_parameters {} ;
+
+        mRingFileDescriptor = static_cast<int>(syscall(__NR_io_uring_setup,
+                                                       static_cast<unsigned>(mIoUringEnginePolicy.queueDepth),
+                                                       &io_uring_parameters)) ;
+
+        if (mRingFileDescriptor < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        // Release everything mapped so far if a later step fails.
+        const auto throw_error = [this](const int errorNumber)
+        {
+            this->ReleaseRing() ;
+            throw std::runtime_error(std::strerror(errorNumber)) ;
+        } ;
+
+        mSubmissionRingSize = io_uring_parameters.sq_off.array +
+                              io_uring_parameters.sq_entries * sizeof(unsigned) ;
+        mCompletionRingSize = io_uring_parameters.cq_off.cqes +
+                              io_uring_parameters.cq_entries * sizeof(io_uring_cqe) ;
+
+        const auto single_mapping = (io_uring_parameters.features & IORING_FEAT_SINGLE_MMAP) != 0 ;
+
+        if (single_mapping)
+        {
+            mSubmissionRingSize = std::max(mSubmissionRingSize, mCompletionRingSize) ;
+        }
+
+        mSubmissionRing = mmap(nullptr,
+                               mSubmissionRingSize,
+                               PROT_READ | PROT_WRITE, // NOLINT (hicpp-signed-bitwise)
+                               MAP_SHARED | MAP_POPULATE, // NOLINT (hicpp-signed-bitwise)
+                               mRingFileDescriptor,
+                               IORING_OFF_SQ_RING) ;
+
+        if (mSubmissionRing == MAP_FAILED) // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+        {
+            throw_error(errno) ;
+        }
+
+        if (single_mapping)
+        {
+            mCompletionRing = mSubmissionRing ;
+            mCompletionRingSize = mSubmissionRingSize ;
+        }
+        else
+        {
+            mCompletionRing = mmap(nullptr,
+                                   mCompletionRingSize,
+                                   PROT_READ | PROT_WRITE, // NOLINT (hicpp-signed-bitwise)
+                                   MAP_SHARED | MAP_POPULATE, // NOLINT (hicpp-signed-bitwise)
+                                   mRingFileDescriptor,
+                                   IORING_OFF_CQ_RING) ;
+
+            if (mCompletionRing == MAP_FAILED) // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+            {
+                throw_error(errno) ;
+            }
+        }
+
+        mSubmissionQueueEntriesSize = io_uring_parameters.sq_entries * sizeof(io_uring_sqe) ;
+
+        const auto submission_queue_entries = mmap(nullptr,
+                                                   mSubmissionQueueEntriesSize,
+                                                   PROT_READ | PROT_WRITE, // NOLINT (hicpp-signed-bitwise)
+                                                   MAP_SHARED | MAP_POPULATE, // NOLINT (hicpp-signed-bitwise)
+                                                   mRingFileDescriptor,
+                                                   IORING_OFF_SQES) ;
+
+        if (submission_queue_entries == MAP_FAILED) // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+        {
+            throw_error(errno) ;
+        }
+
+        mSubmissionQueueEntries = static_cast<io_uring_sqe*>(submission_queue_entries) ;
+
+        const auto submission_ring = static_cast<uint8_t*>(mSubmissionRing) ;
+        const auto completion_ring = static_cast<uint8_t*>(mCompletionRing) ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+        mSubmissionHead = reinterpret_cast<unsigned*>(submission_ring + io_uring_parameters.sq_off.head) ;
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+        mSubmissionTail = reinterpret_cast<unsigned*>(submission_ring + io_uring_parameters.sq_off.tail) ;
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+        mSubmissionArray = reinterpret_cast<unsigned*>(submission_ring + io_uring_parameters.sq_off.array) ;
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+        mSubmissionMask = *reinterpret_cast<unsigned*>(submission_ring + io_uring_parameters.sq_off.ring_mask) ;
+        mSubmissionEntries = io_uring_parameters.sq_entries ;
+        mSubmissionLocalTail = *mSubmissionTail ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+        mCompletionHead = reinterpret_cast<unsigned*>(completion_ring + io_uring_parameters.cq_off.head) ;
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+        mCompletionTail = reinterpret_cast<unsigned*>(completion_ring + io_uring_parameters.cq_off.tail) ;
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+        mCompletionMask = *reinterpret_cast<unsigned*>(completion_ring + io_uring_parameters.cq_off.ring_mask) ;
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+        mCompletionQueueEntries = reinterpret_cast<io_uring_cqe*>(completion_ring + io_uring_parameters.cq_off.cqes) ;
+
+        // Register the receive buffers as a buffer ring, from which the
+        // kernel picks a buffer for each read without a system call.
+        mBufferRingSize = number_of_buffers * sizeof(io_uring_buf) ;
+
+        const auto buffer_ring = mmap(nullptr,
+                                      mBufferRingSize,
+                                      PROT_READ | PROT_WRITE, // NOLINT (hicpp-signed-bitwise)
+                                      MAP_PRIVATE | MAP_ANONYMOUS, // NOLINT (hicpp-signed-bitwise)
+                                      -1,
+                                      0) ;
+
+        if (buffer_ring == MAP_FAILED) // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+        {
+            throw_error(errno) ;
+        }
+
+        mBufferRing = static_cast<io_uring_buf*>(buffer_ring) ;
+
+        io_uring_buf_reg buffer_ring_registration {} ;
+        buffer_ring_registration.ring_addr = reinterpret_cast<uint64_t>(mBufferRing) ; // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+        buffer_ring_registration.ring_entries = static_cast<uint32_t>(number_of_buffers) ;
+        buffer_ring_registration.bgid = 0 ;
+
+        if (syscall(__NR_io_uring_register,
+                    mRingFileDescriptor,
+                    IORING_REGISTER_PBUF_RING,
+                    &buffer_ring_registration,
+                    1) < 0)
+        {
+            throw_error(errno) ;
+        }
+
+        mBufferStorage.resize(number_of_buffers * mIoUringEnginePolicy.bufferSize) ;
+
+        for (size_t buffer_id = 0; buffer_id < number_of_buffers; buffer_id++)
+        {
+            this->RecycleBuffer(static_cast<uint16_t>(buffer_id)) ;
+        }
+
+        // Use multishot reads if the kernel supports them.
+        std::vector<uint8_t> probe_storage(sizeof(io_uring_probe) +
+                                           IO_URING_PROBE_OPCODES * sizeof(io_uring_probe_op)) ;
+        const auto probe = reinterpret_cast<io_uring_probe*>(probe_storage.data()) ; // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+
+        if ((syscall(__NR_io_uring_register,
+                     mRingFileDescriptor,
+                     IORING_REGISTER_PROBE,
+                     probe,
+                     IO_URING_PROBE_OPCODES) == 0) and
+            (probe->last_op >= IO_URING_OP_READ_MULTISHOT) and
+            ((probe->ops[IO_URING_OP_READ_MULTISHOT].flags & IO_URING_OP_SUPPORTED) != 0))
+        {
+            mReadOpcode = IO_URING_OP_READ_MULTISHOT ;
+        }
+    }
+
+    inline
+    IoUringEngine::Implementation::~Implementation()
+    {
+        // Cancel the requests of every port before the buffers they use are
+        // released.
+        while (not mPortEntries.empty())
+        {
+            try
+            {
+                this->Remove(mPortEntries.begin()->first) ;
+            }
+            catch (const std::exception&)
+            {
+                mPortEntries.erase(mPortEntries.begin()) ;
+            }
+        }
+
+        this->ReleaseRing() ;
+    }
+
+    inline
+    void
+    IoUringEngine::Implementation::ReleaseRing()
+    {
+        if (mBufferRing != nullptr)
+        {
+            munmap(mBufferRing, mBufferRingSize) ;
+            mBufferRing = nullptr ;
+        }
+
+        if (mSubmissionQueueEntries != nullptr)
+        {
+            munmap(mSubmissionQueueEntries, mSubmissionQueueEntriesSize) ;
+            mSubmissionQueueEntries = nullptr ;
+        }
+
+        if ((mCompletionRing != MAP_FAILED) and // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+            (mCompletionRing != mSubmissionRing))
+        {
+            munmap(mCompletionRing, mCompletionRingSize) ;
+        }
+
+        mCompletionRing = MAP_FAILED ; // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+
+        if (mSubmissionRing != MAP_FAILED) // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+        {
+            munmap(mSubmissionRing, mSubmissionRingSize) ;
+            mSubmissionRing = MAP_FAILED ; // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+        }
+
+        if (mRingFileDescriptor >= 0)
+        {
+            close(mRingFileDescriptor) ;
+            mRingFileDescriptor = -1 ;
+        }
+    }
+
+    inline
+    IoUringEngine::PortId
+    IoUringEngine::Implementation::Add(SerialPort&      serialPort,
+                                       const Callbacks& callbacks)
+    {
+        if (not serialPort.IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        const auto port_id = mNextPortId++ ;
+
+        std::unique_ptr<PortEntry> port_entry(new PortEntry) ;
+        port_entry->fileDescriptor = serialPort.GetFileDescriptor() ;
+        port_entry->callbacks = callbacks ;
+
+        this->ArmRead(port_id, *port_entry) ;
+
+        mPortEntries.emplace(port_id, std::move(port_entry)) ;
+
+        return port_id ;
+    }
+
+    inline
+    void
+    IoUringEngine::Implementation::Remove(const PortId portId)
+    {
+        const auto port_entry = this->FindPortEntry(portId) ;
+
+        if ((port_entry == nullptr) or
+            port_entry->removed)
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_PORT_ID) ;
+        }
+
+        port_entry->removed = true ;
+
+        // Drop the writes that have not been queued yet, and cancel every
+        // request of the port that the kernel knows about.
+        while ((not port_entry->writeRequests.empty()) and
+               (not port_entry->writeRequests.back().inFlight))
+        {
+            port_entry->writeRequests.pop_back() ;
+        }
+
+        const auto submission_queue_entry = this->GetSubmissionQueueEntry() ;
+        submission_queue_entry->opcode = IORING_OP_ASYNC_CANCEL ;
+        submission_queue_entry->fd = port_entry->fileDescriptor ;
+        submission_queue_entry->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL ; // NOLINT (hicpp-signed-bitwise)
+        submission_queue_entry->user_data = (portId << IO_URING_REQUEST_TYPE_BITS) |
+                                            static_cast<uint64_t>(IoUringRequestType::IO_URING_REQUEST_CANCEL) ;
+
+        // A timeout has no file descriptor, so it is cancelled by its user
+        // data.
+        if (port_entry->drainArmed)
+        {
+            const auto timeout_remove_entry = this->GetSubmissionQueueEntry() ;
+            timeout_remove_entry->opcode = IORING_OP_TIMEOUT_REMOVE ;
+            timeout_remove_entry->fd = -1 ;
+            timeout_remove_entry->addr = (portId << IO_URING_REQUEST_TYPE_BITS) |
+                                         static_cast<uint64_t>(IoUringRequestType::IO_URING_REQUEST_DRAIN) ;
+            timeout_remove_entry->user_data = (portId << IO_URING_REQUEST_TYPE_BITS) |
+                                              static_cast<uint64_t>(IoUringRequestType::IO_URING_REQUEST_CANCEL) ;
+        }
+
+        // Completions of other ports are dispatched as usual meanwhile.
+        this->ProcessCompletions() ;
+
+        while (port_entry->readArmed or
+               port_entry->drainArmed or
+               (port_entry->numberOfWritesInFlight > 0))
+        {
+            this->Enter(1, 0) ;
+            this->ProcessCompletions() ;
+        }
+
+        mPortEntries.erase(portId) ;
+    }
+
+    inline
+    size_t
+    IoUringEngine::Implementation::GetNumberOfPorts() const
+    {
+        return mPortEntries.size() ;
+    }
+
+    inline
+    void
+    IoUringEngine::Implementation::Write(const PortId         portId,
+                                         const uint8_t* const dataBuffer,
+                                         const size_t         numberOfBytes,
+                                         const bool           drainWriteBuffer)
+    {
+        const auto port_entry = this->FindPortEntry(portId) ;
+
+        if ((port_entry == nullptr) or
+            port_entry->removed)
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_PORT_ID) ;
+        }
+
+        if (numberOfBytes == 0)
+        {
+            return ;
+        }
+
+        WriteRequest write_request ;
+        write_request.data.assign(dataBuffer, dataBuffer + numberOfBytes) ;
+        write_request.drainWriteBuffer = drainWriteBuffer ;
+
+        port_entry->writeRequests.push_back(std::move(write_request)) ;
+
+        this->ScheduleWrites(*port_entry) ;
+
+        if (not port_entry->writesScheduled)
+        {
+            return ;
+        }
+
+        if ((mPortsWithQueuedWrites.empty()) or
+            (mPortsWithQueuedWrites.back() != portId))
+        {
+            mPortsWithQueuedWrites.push_back(portId) ;
+        }
+    }
+
+    inline
+    size_t
+    IoUringEngine::Implementation::Submit()
+    {
+        this->QueueWrites() ;
+
+        const auto number_of_queued_entries = this->GetNumberOfQueuedEntries() ;
+
+        if (number_of_queued_entries > 0)
+        {
+            this->Enter(0, 0) ;
+        }
+
+        return number_of_queued_entries ;
+    }
+
+    inline
+    size_t
+    IoUringEngine::Implementation::RunOnce(const size_t msTimeout)
+    {
+        this->QueueWrites() ;
+
+        // Completions that have already arrived need no system call.
+        auto number_of_callbacks = this->ProcessCompletions() ;
+
+        if (number_of_callbacks == 0)
+        {
+            this->Enter(1, msTimeout) ;
+            number_of_callbacks = this->ProcessCompletions() ;
+        }
+
+        // Submit the reads re-armed and the writes queued by callbacks.
+        this->QueueWrites() ;
+
+        if (this->GetNumberOfQueuedEntries() > 0)
+        {
+            this->Enter(0, 0) ;
+        }
+
+        return number_of_callbacks ;
+    }
+
+    inline
+    size_t
+    IoUringEngine::Implementation::GetNumberOfSystemCalls() const
+    {
+        return mNumberOfSystemCalls ;
+    }
+
+    inline
+    IoUringEngine::Implementation::PortEntry*
+    IoUringEngine::Implementation::FindPortEntry(const PortId portId) const
+    {
+        const auto port_entry = mPortEntries.find(portId) ;
+
+        if (port_entry == mPortEntries.end())
+        {
+            return nullptr ;
+        }
+
+        return port_entry->second.get() ;
+    }
+
+    inline
+    io_uring_sqe*
+    IoUringEngine::Implementation::GetSubmissionQueueEntry()
+    {
+        if (this->GetNumberOfQueuedEntries() >= mSubmissionEntries)
+        {
+            this->Enter(0, 0) ;
+        }
+
+        const auto submission_index = mSubmissionLocalTail & mSubmissionMask ;
+        const auto submission_queue_entry = &mSubmissionQueueEntries[submission_index] ;
+
+        std::memset(submission_queue_entry, 0, sizeof(io_uring_sqe)) ;
+        mSubmissionArray[submission_index] = submission_index ;
+        mSubmissionLocalTail++ ;
+
+        return submission_queue_entry ;
+    }
+
+    inline
+    unsigned
+    IoUringEngine::Implementation::GetNumberOfQueuedEntries() const
+    {
+        return mSubmissionLocalTail - __atomic_load_n(mSubmissionHead, __ATOMIC_ACQUIRE) ;
+    }
+
+    inline
+    void
+    IoUringEngine::Implementation::Enter(const unsigned minimumCompletions,
+                                         const size_t   msTimeout)
+    {
+        const auto number_of_queued_entries = this->GetNumberOfQueuedEntries() ;
+
+        // Publish the queued entries to the kernel.
+        __atomic_store_n(mSubmissionTail, mSubmissionLocalTail, __ATOMIC_RELEASE) ;
+
+        unsigned enter_flags = 0 ;
+        __kernel_timespec timeout {} ;
+        io_uring_getevents_arg getevents_argument {} ;
+        void* enter_argument = nullptr ;
+        size_t enter_argument_size = 0 ;
+
+        if (minimumCompletions > 0)
+        {
+            enter_flags |= IORING_ENTER_GETEVENTS ;
+
+            if (msTimeout > 0)
+            {
+                const auto timeout_duration = std::chrono::milliseconds(msTimeout) ;
+                const auto timeout_seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout_duration) ;
+
+                timeout.tv_sec = timeout_seconds.count() ;
+                timeout.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout_duration - timeout_seconds).count() ;
+                getevents_argument.ts = reinterpret_cast<uint64_t>(&timeout) ; // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                enter_flags |= IORING_ENTER_EXT_ARG ;
+                enter_argument = &getevents_argument ;
+                enter_argument_size = sizeof(getevents_argument) ;
+            }
+        }
+
+        mNumberOfSystemCalls++ ;
+
+        const auto enter_result = syscall(__NR_io_uring_enter,
+                                          mRingFileDescriptor,
+                                          number_of_queued_entries,
+                                          minimumCompletions,
+                                          enter_flags,
+                                          enter_argument,
+                                          enter_argument_size) ;
+
+        if ((enter_result < 0) and
+            (errno != ETIME) and
+            (errno != EINTR) and
+            (errno != EBUSY))
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+    }
+
+    inline
+    void
+    IoUringEngine::Implementation::ArmRead(const PortId portId,
+                                           PortEntry&   portEntry)
+    {
+        const auto submission_queue_entry = this->GetSubmissionQueueEntry() ;
+        submission_queue_entry->opcode = mReadOpcode ;
+        submission_queue_entry->fd = portEntry.fileDescriptor ;
+        submission_queue_entry->flags = IOSQE_BUFFER_SELECT ;
+        submission_queue_entry->buf_group = 0 ;
+        submission_queue_entry->user_data = (portId << IO_URING_REQUEST_TYPE_BITS) |
+                                            static_cast<uint64_t>(IoUringRequestType::IO_URING_REQUEST_READ) ;
+
+        // A multishot read fills whole buffers, a single shot read needs
+        // the buffer size.
+        if (mReadOpcode == IORING_OP_READ)
+        {
+            submission_queue_entry->len = static_cast<uint32_t>(mIoUringEnginePolicy.bufferSize) ;
+        }
+
+        portEntry.readArmed = true ;
+    }
+
+    inline
+    void
+    IoUringEngine::Implementation::ScheduleWrites(PortEntry& portEntry)
+    {
+        portEntry.writesScheduled = (not portEntry.removed) and
+                                    (portEntry.numberOfWritesInFlight == 0) and
+                                    portEntry.drainedWrites.empty() and
+                                    (not portEntry.writeRequests.empty()) ;
+    }
+
+    inline
+    void
+    IoUringEngine::Implementation::QueueWrites()
+    {
+        for (const auto port_id : mPortsWithQueuedWrites)
+        {
+            const auto port_entry = this->FindPortEntry(port_id) ;
+
+            if ((port_entry == nullptr) or
+                (not port_entry->writesScheduled))
+            {
+                continue ;
+            }
+
+            port_entry->writesScheduled = false ;
+
+            // The entries of one chain must be contiguous in the submission
+            // queue, so make room for the whole chain first.
+            const auto number_of_writes = std::min(port_entry->writeRequests.size(),
+                                                   static_cast<size_t>(mSubmissionEntries)) ;
+
+            if (this->GetNumberOfQueuedEntries() + number_of_writes > mSubmissionEntries)
+            {
+                this->Enter(0, 0) ;
+            }
+
+            for (size_t write_index = 0; write_index < number_of_writes; write_index++)
+            {
+                auto& write_request = port_entry->writeRequests[write_index] ;
+
+                const auto submission_queue_entry = this->GetSubmissionQueueEntry() ;
+                submission_queue_entry->opcode = IORING_OP_WRITE ;
+                submission_queue_entry->fd = port_entry->fileDescriptor ;
+                submission_queue_entry->addr = reinterpret_cast<uint64_t>(write_request.data.data() + // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                                                                          write_request.numberOfBytesWritten) ;
+                submission_queue_entry->len = static_cast<uint32_t>(write_request.data.size() -
+                                                                    write_request.numberOfBytesWritten) ;
+                submission_queue_entry->user_data = (port_id << IO_URING_REQUEST_TYPE_BITS) |
+                                                    static_cast<uint64_t>(IoUringRequestType::IO_URING_REQUEST_WRITE) ;
+
+                if (write_index + 1 < number_of_writes)
+                {
+                    submission_queue_entry->flags = IOSQE_IO_LINK ;
+                }
+
+                write_request.inFlight = true ;
+                port_entry->numberOfWritesInFlight++ ;
+            }
+        }
+
+        mPortsWithQueuedWrites.clear() ;
+    }
+
+    inline
+    size_t
+    IoUringEngine::Implementation::ProcessCompletions()
+    {
+        size_t number_of_callbacks = 0 ;
+
+        auto completion_head = *mCompletionHead ;
+
+        while (completion_head != __atomic_load_n(mCompletionTail, __ATOMIC_ACQUIRE))
+        {
+            const auto& completion_queue_entry = mCompletionQueueEntries[completion_head & mCompletionMask] ;
+
+            const auto user_data = completion_queue_entry.user_data ;
+            const auto result = completion_queue_entry.res ;
+            const auto completion_flags = completion_queue_entry.flags ;
+
+            // Release the entry before dispatching, as callbacks may queue
+            // more requests.
+            completion_head++ ;
+            __atomic_store_n(mCompletionHead, completion_head, __ATOMIC_RELEASE) ;
+
+            const auto port_id = user_data >> IO_URING_REQUEST_TYPE_BITS ;
+            const auto request_type = static_cast<IoUringRequestType>(user_data & ((1U << IO_URING_REQUEST_TYPE_BITS) - 1)) ;
+
+            switch (request_type)
+            {
+            case IoUringRequestType::IO_URING_REQUEST_READ:
+                number_of_callbacks += this->HandleReadCompletion(port_id,
+                                                                  result,
+                                                                  completion_flags) ;
+                break ;
+            case IoUringRequestType::IO_URING_REQUEST_WRITE:
+                number_of_callbacks += this->HandleWriteCompletion(port_id,
+                                                                   result) ;
+                break ;
+            case IoUringRequestType::IO_URING_REQUEST_DRAIN:
+                number_of_callbacks += this->HandleDrainCompletion(port_id) ;
+                break ;
+            case IoUringRequestType::IO_URING_REQUEST_CANCEL:
+            default:
+                break ;
+            }
+        }
+
+        return number_of_callbacks ;
+    }
+
+    inline
+    size_t
+    IoUringEngine::Implementation::HandleReadCompletion(const PortId   portId,
+                                                        const int      result,
+                                                        const unsigned completionFlags)
+    {
+        const auto port_entry = this->FindPortEntry(portId) ;
+
+        if (port_entry == nullptr)
+        {
+            return 0 ;
+        }
+
+        size_t number_of_callbacks = 0 ;
+
+        if ((completionFlags & IORING_CQE_F_MORE) == 0)
+        {
+            port_entry->readArmed = false ;
+        }
+
+        if (result > 0)
+        {
+            const auto buffer_id = static_cast<uint16_t>(completionFlags >> IORING_CQE_BUFFER_SHIFT) ;
+
+            if ((not port_entry->removed) and
+                port_entry->callbacks.dataReceived)
+            {
+                port_entry->callbacks.dataReceived(portId,
+                                                   &mBufferStorage[buffer_id * mIoUringEnginePolicy.bufferSize],
+                                                   static_cast<size_t>(result)) ;
+                number_of_callbacks++ ;
+            }
+
+            this->RecycleBuffer(buffer_id) ;
+        }
+        else if ((result != -ENOBUFS) and
+                 (result != -EAGAIN) and
+                 (result != -EINTR) and
+                 (result != -ECANCELED))
+        {
+            // End of file or a read error, e.g. the device was unplugged.
+            port_entry->readable = false ;
+
+            if ((not port_entry->removed) and
+                port_entry->callbacks.hangUp)
+            {
+                port_entry->callbacks.hangUp(portId,
+                                             (result == 0) ? EIO : -result) ;
+                number_of_callbacks++ ;
+            }
+        }
+
+        // Re-arm a single shot read, or a multishot read that ran out of
+        // buffers.
+        if ((not port_entry->readArmed) and
+            port_entry->readable and
+            (not port_entry->removed))
+        {
+            this->ArmRead(portId, *port_entry) ;
+        }
+
+        return number_of_callbacks ;
+    }
+
+    inline
+    size_t
+    IoUringEngine::Implementation::HandleWriteCompletion(const PortId portId,
+                                                         const int    result)
+    {
+        const auto port_entry = this->FindPortEntry(portId) ;
+
+        if (port_entry == nullptr)
+        {
+            return 0 ;
+        }
+
+        // The writes of a port complete in order, and a failed or short
+        // write cancels the rest of its chain, so the completion belongs to
+        // the oldest write in flight.
+        auto write_request = port_entry->writeRequests.begin() ;
+
+        while ((write_request != port_entry->writeRequests.end()) and
+               (not write_request->inFlight))
+        {
+            ++write_request ;
+        }
+
+        if (write_request == port_entry->writeRequests.end())
+        {
+            return 0 ;
+        }
+
+        write_request->inFlight = false ;
+        port_entry->numberOfWritesInFlight-- ;
+
+        if (result > 0)
+        {
+            write_request->numberOfBytesWritten += static_cast<size_t>(result) ;
+        }
+
+        // A write of zero bytes to a tty makes no progress, and would be
+        // retried forever, so it is taken for a hang up.
+        const auto is_complete = (write_request->numberOfBytesWritten == write_request->data.size()) ;
+        const auto is_retryable = (result > 0) or
+                                  (result == -ECANCELED) or
+                                  (result == -EAGAIN) or
+                                  (result == -EINTR) ;
+
+        size_t number_of_callbacks = 0 ;
+
+        if (port_entry->removed)
+        {
+            port_entry->writeRequests.erase(write_request) ;
+        }
+        else if (is_complete or
+                 (not is_retryable))
+        {
+            const auto error_number = is_complete ? 0 : ((result == 0) ? EIO : -result) ;
+            const auto number_of_bytes_written = write_request->numberOfBytesWritten ;
+            const auto drain_write_buffer = is_complete and write_request->drainWriteBuffer ;
+
+            port_entry->writeRequests.erase(write_request) ;
+
+            // The callback of a drained write, and of the linked writes
+            // completing after it, is invoked once the data has drained.
+            if (drain_write_buffer or
+                (not port_entry->drainedWrites.empty()))
+            {
+                port_entry->drainedWrites.emplace_back(number_of_bytes_written, error_number) ;
+
+                if (not port_entry->drainArmed)
+                {
+                    number_of_callbacks += this->PollDrain(portId, *port_entry) ;
+                }
+            }
+            else if (port_entry->callbacks.writeComplete)
+            {
+                port_entry->callbacks.writeComplete(portId,
+                                                    number_of_bytes_written,
+                                                    error_number) ;
+                number_of_callbacks++ ;
+            }
+        }
+
+        // Requeue the unwritten remainder once the chain has finished.
+        this->ScheduleWrites(*port_entry) ;
+
+        if (port_entry->writesScheduled)
+        {
+            mPortsWithQueuedWrites.push_back(portId) ;
+        }
+
+        return number_of_callbacks ;
+    }
+
+    inline
+    size_t
+    IoUringEngine::Implementation::PollDrain(const PortId portId,
+                                             PortEntry&   portEntry)
+    {
+        int error_number = 0 ;
+        int number_of_bytes_pending = 0 ;
+        bool is_transmitter_empty = false ;
+
+        if (GetNumberOfBytesPending(portEntry.fileDescriptor,
+                                    number_of_bytes_pending) < 0)
+        {
+            error_number = errno ;
+        }
+        else if (number_of_bytes_pending > 0)
+        {
+            // Wake up about when the queue is expected to be empty.
+            this->ArmDrain(portId,
+                           portEntry,
+                           GetTransmitTime(portEntry.fileDescriptor,
+                                           static_cast<size_t>(number_of_bytes_pending))) ;
+            return 0 ;
+        }
+        else if (GetTransmitterEmpty(portEntry.fileDescriptor,
+                                     is_transmitter_empty) < 0)
+        {
+            // Without TIOCSERGETLSR the empty queue is all there is to go by.
+            if ((errno != ENOTTY) and
+                (errno != EINVAL))
+            {
+                error_number = errno ;
+            }
+        }
+        else if (not is_transmitter_empty)
+        {
+            // Wait for the characters in the transmit FIFO of the UART.
+            this->ArmDrain(portId,
+                           portEntry,
+                           GetTransmitTime(portEntry.fileDescriptor, 1)) ;
+            return 0 ;
+        }
+
+        size_t number_of_callbacks = 0 ;
+
+        const auto drained_writes = std::move(portEntry.drainedWrites) ;
+        portEntry.drainedWrites.clear() ;
+
+        // Every write made before the drain began has drained together.
+        for (const auto& drained_write : drained_writes)
+        {
+            if (portEntry.callbacks.writeComplete)
+            {
+                portEntry.callbacks.writeComplete(portId,
+                                                  drained_write.first,
+                                                  (drained_write.second != 0) ? drained_write.second : error_number) ;
+                number_of_callbacks++ ;
+            }
+        }
+
+        return number_of_callbacks ;
+    }
+
+    inline
+    void
+    IoUringEngine::Implementation::ArmDrain(const PortId portId,
+                                            PortEntry&   portEntry,
+                                            const size_t msTimeout)
+    {
+        const auto timeout_duration = std::chrono::milliseconds(msTimeout) ;
+        const auto timeout_seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout_duration) ;
+
+        portEntry.drainTimeout.tv_sec = timeout_seconds.count() ;
+        portEntry.drainTimeout.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout_duration - timeout_seconds).count() ;
+
+        const auto submission_queue_entry = this->GetSubmissionQueueEntry() ;
+        submission_queue_entry->opcode = IORING_OP_TIMEOUT ;
+        submission_queue_entry->fd = -1 ;
+        submission_queue_entry->addr = reinterpret_cast<uint64_t>(&portEntry.drainTimeout) ; // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+        submission_queue_entry->len = 1 ;
+        submission_queue_entry->user_data = (portId << IO_URING_REQUEST_TYPE_BITS) |
+                                            static_cast<uint64_t>(IoUringRequestType::IO_URING_REQUEST_DRAIN) ;
+
+        portEntry.drainArmed = true ;
+    }
+
+    inline
+    size_t
+    IoUringEngine::Implementation::HandleDrainCompletion(const PortId portId)
+    {
+        const auto port_entry = this->FindPortEntry(portId) ;
+
+        if (port_entry == nullptr)
+        {
+            return 0 ;
+        }
+
+        port_entry->drainArmed = false ;
+
+        if (port_entry->removed)
+        {
+            return 0 ;
+        }
+
+        const auto number_of_callbacks = this->PollDrain(portId, *port_entry) ;
+
+        // Queue the writes held back while the data drained.
+        this->ScheduleWrites(*port_entry) ;
+
+        if (port_entry->writesScheduled)
+        {
+            mPortsWithQueuedWrites.push_back(portId) ;
+        }
+
+        return number_of_callbacks ;
+    }
+
+    inline
+    void
+    IoUringEngine::Implementation::RecycleBuffer(const uint16_t bufferId)
+    {
+        const auto buffer_mask = static_cast<uint16_t>(mIoUringEnginePolicy.numberOfBuffers - 1) ;
+
+        auto& buffer = mBufferRing[mBufferRingTail & buffer_mask] ;
+        buffer.addr = reinterpret_cast<uint64_t>(&mBufferStorage[bufferId * mIoUringEnginePolicy.bufferSize]) ; // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+        buffer.len = static_cast<uint32_t>(mIoUringEnginePolicy.bufferSize) ;
+        buffer.bid = bufferId ;
+
+        mBufferRingTail++ ;
+        __atomic_store_n(&mBufferRing->resv, mBufferRingTail, __ATOMIC_RELEASE) ;
+    }
+#endif
+
+} // namespace LibSerial
@@ -0,0 +1,504 @@
+/******************************************************************************
+ * @file ModemLineWait.cpp                                                    *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "ModemLineWait.h"
+#include "libserial/SerialPort.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <linux/serial.h>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace LibSerial
+{
+    /**
+     * @brief The handler of the wake signal. Its only purpose is to make
+     *        TIOCMIWAIT return with EINTR.
+     */
+    static void
+    HandleModemLineWakeSignal(int /*signalNumber*/)
+    {
+        /* Empty */
+    }
+
+    /**
+     * @brief Installs the handler of the wake signal on the first call,
+     *        unless the application has installed its own.
+     * @return Returns the wake signal, or -1 if the disposition of the
+     *         signal would not interrupt TIOCMIWAIT.
+     */
+    static int
+    InstallModemLineWakeSignal()
+    {
+        static const int wake_signal = []()
+        {
+            const auto signal_number = SIGRTMIN + 1 ;
+
+            struct sigaction current_action {} ;
+
+            if (sigaction(signal_number, nullptr, &current_action) < 0)
+            {
+                return -1 ;
+            }
+
+            if (current_action.sa_handler == SIG_DFL)  // NOLINT (cppcoreguidelines-pro-type-union-access)
+            {
+                // SA_RESTART is deliberately not set, otherwise the kernel
+                // would restart TIOCMIWAIT instead of returning EINTR.
+                struct sigaction wake_action {} ;
+                wake_action.sa_handler = HandleModemLineWakeSignal ;  // NOLINT (cppcoreguidelines-pro-type-union-access)
+                sigemptyset(&wake_action.sa_mask) ;
+
+                return (sigaction(signal_number, &wake_action, nullptr) < 0) ? -1 : signal_number ;
+            }
+
+            // A handler of the application serves as well, provided that it
+            // lets TIOCMIWAIT return with EINTR.
+            if ((current_action.sa_handler == SIG_IGN) or  // NOLINT (cppcoreguidelines-pro-type-union-access)
+                ((current_action.sa_flags & SA_RESTART) != 0)) // NOLINT (hicpp-signed-bitwise)
+            {
+                return -1 ;
+            }
+
+            return signal_number ;
+        }() ;
+
+        return wake_signal ;
+    }
+
+    /**
+     * @brief A timed wait registered with the ModemLineWakeTimer.
+     */
+    struct TimedModemLineWait
+    {
+        /**
+         * @brief The thread running WaitForModemLineChange().
+         */
+        pthread_t waitingThread {} ;
+
+        /**
+         * @brief The time at which the wake signal is next sent.
+         */
+        std::chrono::steady_clock::time_point wakeTime {} ;
+
+        /**
+         * @brief The flag passed to WaitForModemLineChange().
+         */
+        std::atomic<bool> interruptRequested {false} ;
+
+        /**
+         * @brief The number of times the wake signal has been sent.
+         */
+        size_t numberOfWakeAttempts = 0 ;
+    } ;
+
+    /**
+     * @brief A thread shared by all timed modem line waits, which sends the
+     *        wake signal to each waiting thread once its timeout expires.
+     */
+    class ModemLineWakeTimer
+    {
+    public:
+        /**
+         * @brief Gets the timer, starting its thread on the first call.
+         * @return Returns the timer.
+         */
+        static ModemLineWakeTimer& GetInstance()
+        {
+            // Never destroyed, so that the detached thread can not outlive it.
+            static auto* const instance = new ModemLineWakeTimer() ; // NOLINT (cppcoreguidelines-owning-memory)
+            return *instance ;
+        }
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        ModemLineWakeTimer(const ModemLineWakeTimer& otherModemLineWakeTimer) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        ModemLineWakeTimer(ModemLineWakeTimer&& otherModemLineWakeTimer) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        ModemLineWakeTimer& operator=(const ModemLineWakeTimer& otherModemLineWakeTimer) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        ModemLineWakeTimer& operator=(ModemLineWakeTimer&& otherModemLineWakeTimer) = delete ;
+
+        /**
+         * @brief Registers a timed wait, which must be cancelled before it
+         *        is destroyed.
+         * @param timedWait The timed wait, with its wake time set.
+         */
+        void Schedule(TimedModemLineWait& timedWait)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex) ;
+                mTimedWaits.push_back(&timedWait) ;
+            }
+
+            mCondition.notify_one() ;
+        }
+
+        /**
+         * @brief Deregisters a timed wait. No wake signal is sent to its
+         *        thread once this method returns.
+         * @param timedWait The timed wait.
+         */
+        void Cancel(TimedModemLineWait& timedWait)
+        {
+            std::lock_guard<std::mutex> lock(mMutex) ;
+
+            mTimedWaits.erase(std::remove(mTimedWaits.begin(),
+                                          mTimedWaits.end(),
+                                          &timedWait),
+                              mTimedWaits.end()) ;
+        }
+
+    private:
+        /**
+         * @brief Constructor, starts the timer thread.
+         */
+        ModemLineWakeTimer()
+        {
+            std::thread([this]()
+            {
+                this->Run() ;
+            }).detach() ;
+        }
+
+        /**
+         * @brief Default Destructor, never called.
+         */
+        ~ModemLineWakeTimer() = default ;
+
+        /**
+         * @brief The timer thread, which resends the wake signal to each
+         *        expired wait every MODEM_LINE_WAKE_INTERVAL milliseconds
+         *        until it is cancelled or MODEM_LINE_WAKE_ATTEMPTS is
+         *        reached.
+         */
+        void Run()
+        {
+            const auto wake_interval = std::chrono::milliseconds(MODEM_LINE_WAKE_INTERVAL) ;
+
+            std::unique_lock<std::mutex> lock(mMutex) ;
+
+            while (true)
+            {
+                if (mTimedWaits.empty())
+                {
+                    mCondition.wait(lock) ;
+                    continue ;
+                }
+
+                const auto next_wait = std::min_element(mTimedWaits.begin(),
+                                                        mTimedWaits.end(),
+                                                        [](const TimedModemLineWait* lhs,
+                                                           const TimedModemLineWait* rhs)
+                                                        {
+                                                            return lhs->wakeTime < rhs->wakeTime ;
+                                                        }) ;
+
+                const auto current_time = std::chrono::steady_clock::now() ;
+
+                if ((*next_wait)->wakeTime > current_time)
+                {
+                    mCondition.wait_until(lock, (*next_wait)->wakeTime) ;
+                    continue ;
+                }
+
+                auto& timed_wait = **next_wait ;
+
+                timed_wait.interruptRequested = true ;
+                pthread_kill(timed_wait.waitingThread,
+                             InstallModemLineWakeSignal()) ;
+
+                if (++timed_wait.numberOfWakeAttempts < MODEM_LINE_WAKE_ATTEMPTS)
+                {
+                    timed_wait.wakeTime = current_time + wake_interval ;
+                }
+                else
+                {
+                    // Give up, the wait then lasts until a line changes.
+                    mTimedWaits.erase(next_wait) ;
+                }
+            }
+        }
+
+        /**
+         * @brief Guards mTimedWaits.
+         */
+        std::mutex mMutex {} ;
+
+        /**
+         * @brief Signaled when a timed wait is registered.
+         */
+        std::condition_variable mCondition {} ;
+
+        /**
+         * @brief The registered timed waits.
+         */
+        std::vector<TimedModemLineWait*> mTimedWaits {} ;
+    } ;
+
+    int
+    GetModemLineWakeSignal()
+    {
+        const auto wake_signal = InstallModemLineWakeSignal() ;
+
+        if (wake_signal < 0)
+        {
+            throw std::runtime_error(ERR_MSG_MODEM_LINE_WAKE_SIGNAL) ;
+        }
+
+        return wake_signal ;
+    }
+
+    bool
+    IsModemLineWakeSignalUsable()
+    {
+        return InstallModemLineWakeSignal() >= 0 ;
+    }
+
+    int
+    GetModemLineCounters(const int          fileDescriptor,
+                         ModemLineCounters& modemLineCounters)
+    {
+        serial_icounter_struct icounter {} ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (call_with_retry(ioctl,
+                            fileDescriptor,
+                            TIOCGICOUNT,
+                            &icounter) < 0)
+        {
+            return -1 ;
+        }
+
+        modemLineCounters.cts = icounter.cts ;
+        modemLineCounters.dsr = icounter.dsr ;
+        modemLineCounters.ri  = icounter.rng ;
+        modemLineCounters.dcd = icounter.dcd ;
+
+        return 0 ;
+    }
+
+    int
+    GetChangedModemLines(const ModemLineCounters& previousCounters,
+                         const ModemLineCounters& currentCounters)
+    {
+        int changed_lines = 0 ;
+
+        if (currentCounters.cts != previousCounters.cts)
+        {
+            changed_lines |= TIOCM_CTS ; // NOLINT (hicpp-signed-bitwise)
+        }
+
+        if (currentCounters.dsr != previousCounters.dsr)
+        {
+            changed_lines |= TIOCM_DSR ; // NOLINT (hicpp-signed-bitwise)
+        }
+
+        if (currentCounters.ri != previousCounters.ri)
+        {
+            changed_lines |= TIOCM_RI ; // NOLINT (hicpp-signed-bitwise)
+        }
+
+        if (currentCounters.dcd != previousCounters.dcd)
+        {
+            changed_lines |= TIOCM_CD ; // NOLINT (hicpp-signed-bitwise)
+        }
+
+        return changed_lines ;
+    }
+
+    /**
+     * @brief Waits as WaitForModemLineChange(), with the wake signal already
+     *        unblocked.
+     * @param fileDescriptor The file descriptor of the serial port.
+     * @param modemLineMask The lines to wait for.
+     * @param modemLineCounters The counters of the previous wait.
+     * @param interruptRequested Set to make the wait return.
+     * @return Returns the changed lines of modemLineMask, 0 if the wait was
+     *         interrupted, or -1 with errno set on failure.
+     */
+    static int
+    WaitForModemLineChangeUnblocked(const int                fileDescriptor,
+                                    const int                modemLineMask,
+                                    ModemLineCounters&       modemLineCounters,
+                                    const std::atomic<bool>& interruptRequested)
+    {
+        while (true)
+        {
+            ModemLineCounters current_counters {} ;
+
+            if (GetModemLineCounters(fileDescriptor,
+                                     current_counters) < 0)
+            {
+                return -1 ;
+            }
+
+            // The counters catch transitions that happened between waits,
+            // which TIOCMIWAIT alone would miss.
+            const auto changed_lines = GetChangedModemLines(modemLineCounters,
+                                                            current_counters) & modemLineMask ; // NOLINT (hicpp-signed-bitwise)
+
+            if (changed_lines != 0)
+            {
+                modemLineCounters = current_counters ;
+                return changed_lines ;
+            }
+
+            if (interruptRequested)
+            {
+                return 0 ;
+            }
+
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+            if ((ioctl(fileDescriptor,
+                       TIOCMIWAIT,
+                       modemLineMask) < 0) and
+                (errno != EINTR))
+            {
+                return -1 ;
+            }
+        }
+    }
+
+    int
+    WaitForModemLineChange(const int                fileDescriptor,
+                           const int                modemLineMask,
+                           ModemLineCounters&       modemLineCounters,
+                           const std::atomic<bool>& interruptRequested)
+    {
+        // Install the handler before the first wait can be interrupted.
+        const auto wake_signal = InstallModemLineWakeSignal() ;
+
+        if (wake_signal < 0)
+        {
+            errno = EINVAL ;
+            return -1 ;
+        }
+
+        // A thread that blocks the wake signal would never be interrupted.
+        sigset_t wake_signal_set {} ;
+        sigemptyset(&wake_signal_set) ;
+        sigaddset(&wake_signal_set, wake_signal) ;
+
+        sigset_t previous_signal_set {} ;
+        pthread_sigmask(SIG_UNBLOCK, &wake_signal_set, &previous_signal_set) ;
+
+        const auto changed_lines = WaitForModemLineChangeUnblocked(fileDescriptor,
+                                                                   modemLineMask,
+                                                                   modemLineCounters,
+                                                                   interruptRequested) ;
+        const auto error_number = errno ;
+
+        pthread_sigmask(SIG_SETMASK, &previous_signal_set, nullptr) ;
+
+        errno = error_number ;
+        return changed_lines ;
+    }
+
+    int
+    WaitForModemLineChange(const int          fileDescriptor,
+                           const int          modemLineMask,
+                           ModemLineCounters& modemLineCounters,
+                           const size_t       msTimeout)
+    {
+        TimedModemLineWait timed_wait ;
+
+        if (msTimeout == 0)
+        {
+            return WaitForModemLineChange(fileDescriptor,
+                                          modemLineMask,
+                                          modemLineCounters,
+                                          timed_wait.interruptRequested) ;
+        }
+
+        timed_wait.waitingThread = pthread_self() ;
+        timed_wait.wakeTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(msTimeout) ;
+
+        auto& modem_line_wake_timer = ModemLineWakeTimer::GetInstance() ;
+        modem_line_wake_timer.Schedule(timed_wait) ;
+
+        const auto changed_lines = WaitForModemLineChange(fileDescriptor,
+                                                          modemLineMask,
+                                                          modemLineCounters,
+                                                          timed_wait.interruptRequested) ;
+        const auto error_number = errno ;
+
+        modem_line_wake_timer.Cancel(timed_wait) ;
+
+        errno = error_number ;
+        return changed_lines ;
+    }
+
+    bool
+    InterruptModemLineWait(const pthread_t          waitingThread,
+                           std::atomic<bool>&       interruptRequested,
+                           const std::atomic<bool>& waitFinished)
+    {
+        interruptRequested = true ;
+
+        const auto wake_signal = GetModemLineWakeSignal() ;
+
+        for (size_t wake_attempt = 0; wake_attempt < MODEM_LINE_WAKE_ATTEMPTS; ++wake_attempt)
+        {
+            if (waitFinished)
+            {
+                return true ;
+            }
+
+            pthread_kill(waitingThread,
+                         wake_signal) ;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(MODEM_LINE_WAKE_INTERVAL)) ;
+        }
+
+        return waitFinished ;
+    }
+
+} // namespace LibSerial
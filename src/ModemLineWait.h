@@ -0,0 +1,157 @@
+/******************************************************************************
+ * @file ModemLineWait.h                                                      *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPortConstants.h>
+
+#include <atomic>
+#include <pthread.h>
+#include <sys/ioctl.h>
+
+namespace LibSerial
+{
+    /**
+     * Blocking waits for modem input line changes with TIOCMIWAIT, shared by
+     * SerialPort and SerialPortReactor. The kernel offers no timeout for
+     * TIOCMIWAIT, so a wait is cut short by sending the waiting thread the
+     * real-time signal returned by GetModemLineWakeSignal(). Timed waits share
+     * one timer thread that sends the signal when their timeout expires.
+     */
+
+    /**
+     * @brief The modem input lines that can be waited for with TIOCMIWAIT.
+     */
+    constexpr int MODEM_INPUT_LINE_MASK = TIOCM_CTS | TIOCM_DSR | TIOCM_CD | TIOCM_RI ; // NOLINT (hicpp-signed-bitwise)
+
+    /**
+     * @brief The interval in milliseconds at which the wake signal is resent
+     *        until an interrupted wait has returned, which covers a signal
+     *        arriving just before the waiting thread enters TIOCMIWAIT.
+     */
+    constexpr int MODEM_LINE_WAKE_INTERVAL = 1 ;
+
+    /**
+     * @brief The number of times the wake signal is sent before an
+     *        interrupt gives up, one second at MODEM_LINE_WAKE_INTERVAL.
+     */
+    constexpr size_t MODEM_LINE_WAKE_ATTEMPTS = 1000 ;
+
+    /**
+     * @brief Gets the signal used to interrupt TIOCMIWAIT, SIGRTMIN + 1. The
+     *        first call installs a handler that does nothing, without
+     *        SA_RESTART, unless the application has already installed one.
+     *        A std::runtime_error is thrown if the application ignores the
+     *        signal or handles it with SA_RESTART, as the signal could not
+     *        interrupt TIOCMIWAIT then.
+     * @return Returns the signal number.
+     */
+    int GetModemLineWakeSignal() ;
+
+    /**
+     * @brief Determines if the wake signal can interrupt TIOCMIWAIT, as
+     *        GetModemLineWakeSignal() but without throwing.
+     * @return Returns true iff the wake signal is usable.
+     */
+    bool IsModemLineWakeSignalUsable() ;
+
+    /**
+     * @brief Gets the modem input line transition counters with TIOCGICOUNT.
+     * @param fileDescriptor The file descriptor of the serial port.
+     * @param modemLineCounters The counters read from the driver.
+     * @return Returns 0 on success, or -1 with errno set on failure.
+     */
+    int GetModemLineCounters(int                fileDescriptor,
+                             ModemLineCounters& modemLineCounters) ;
+
+    /**
+     * @brief Compares two snapshots of the modem input line counters.
+     * @param previousCounters The earlier snapshot.
+     * @param currentCounters The later snapshot.
+     * @return Returns the TIOCM_CTS, TIOCM_DSR, TIOCM_CD and TIOCM_RI bits
+     *         of the lines whose counters differ.
+     */
+    int GetChangedModemLines(const ModemLineCounters& previousCounters,
+                             const ModemLineCounters& currentCounters) ;
+
+    /**
+     * @brief Waits with TIOCMIWAIT until one of the specified modem input
+     *        lines changes state. Transitions that occurred since the
+     *        supplied counters were read are reported without waiting. The
+     *        wake signal is unblocked in the calling thread during the wait.
+     * @param fileDescriptor The file descriptor of the serial port.
+     * @param modemLineMask The lines to wait for.
+     * @param modemLineCounters The counters of the previous wait, updated
+     *        to the current counters when a change is reported.
+     * @param interruptRequested Set by InterruptModemLineWait() to make
+     *        the wait return.
+     * @return Returns the changed lines of modemLineMask, 0 if the wait was
+     *         interrupted, or -1 with errno set on failure.
+     */
+    int WaitForModemLineChange(int                      fileDescriptor,
+                               int                      modemLineMask,
+                               ModemLineCounters&       modemLineCounters,
+                               const std::atomic<bool>& interruptRequested) ;
+
+    /**
+     * @brief Waits as WaitForModemLineChange() above, until the timeout
+     *        expires, without starting a thread of its own.
+     * @param fileDescriptor The file descriptor of the serial port.
+     * @param modemLineMask The lines to wait for.
+     * @param modemLineCounters The counters of the previous wait, updated
+     *        to the current counters when a change is reported.
+     * @param msTimeout The timeout period in milliseconds, or zero to wait
+     *        indefinitely.
+     * @return Returns the changed lines of modemLineMask, 0 if the timeout
+     *         expired, or -1 with errno set on failure.
+     */
+    int WaitForModemLineChange(int                fileDescriptor,
+                               int                modemLineMask,
+                               ModemLineCounters& modemLineCounters,
+                               size_t             msTimeout) ;
+
+    /**
+     * @brief Interrupts a WaitForModemLineChange() running on another thread,
+     *        resending the wake signal until that thread sets waitFinished,
+     *        at most MODEM_LINE_WAKE_ATTEMPTS times.
+     * @param waitingThread The thread running WaitForModemLineChange().
+     * @param interruptRequested The flag passed to WaitForModemLineChange().
+     * @param waitFinished Set by the waiting thread once the wait returned.
+     * @return Returns true if the wait returned, false if it could not be
+     *         interrupted.
+     */
+    bool InterruptModemLineWait(pthread_t                waitingThread,
+                                std::atomic<bool>&       interruptRequested,
+                                const std::atomic<bool>& waitFinished) ;
+
+} // namespace LibSerial
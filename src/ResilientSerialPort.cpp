@@ -0,0 +1,1201 @@
+/******************************************************************************
+ * @file ResilientSerialPort.cpp                                              *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/ResilientSerialPort.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <poll.h>
+#include <stdexcept>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+
+namespace LibSerial
+{
+    /**
+     * @brief Gets the time remaining before a timeout expires.
+     * @param entryTime The time at which the operation started.
+     * @param msTimeout The timeout period in milliseconds, or zero if the
+     *        operation should block indefinitely.
+     * @param remainingMs Set to the number of milliseconds remaining, at
+     *        least one, or to zero if msTimeout is zero.
+     * @return Returns false if the timeout period has elapsed.
+     */
+    static bool
+    GetRemainingTimeout(const std::chrono::steady_clock::time_point& entryTime,
+                        const size_t                                 msTimeout,
+                        size_t&                                      remainingMs)
+    {
+        remainingMs = 0 ;
+
+        if (msTimeout == 0)
+        {
+            return true ;
+        }
+
+        const auto elapsed_ms = static_cast<size_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - entryTime).count()) ;
+
+        if (elapsed_ms >= msTimeout)
+        {
+            return false ;
+        }
+
+        remainingMs = msTimeout - elapsed_ms ;
+        return true ;
+    }
+
+    /**
+     * @brief ResilientSerialPort::Implementation is the ResilientSerialPort
+     *        implementation class.
+     */
+    class ResilientSerialPort::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param sysfsTtyDirectory The sysfs tty class directory searched.
+         * @param deviceDirectory The directory holding the device nodes.
+         */
+        explicit Implementation(const std::string& sysfsTtyDirectory,
+                                const std::string& deviceDirectory) ;
+
+        /**
+         * @brief Default Destructor. Closes the serial port if it is open.
+         */
+        ~Implementation() noexcept ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Opens the serial port of the device with the specified
+         *        USB serial number.
+         * @param serialNumber The USB serial number of the device.
+         * @param portSettings The serial port parameters to be set.
+         * @param openMode The communication mode status when the serial
+         *        communication port is opened.
+         */
+        void Open(const std::string&             serialNumber,
+                  const PortSettings&            portSettings,
+                  const std::ios_base::openmode& openMode) ;
+
+        /**
+         * @brief Closes the serial port and discards any queued writes.
+         */
+        void Close() ;
+
+        /**
+         * @brief Determines if the serial port is open.
+         * @return Returns true iff the serial port is open.
+         */
+        bool IsOpen() const ;
+
+        /**
+         * @brief Determines if the device of the serial port is connected.
+         * @return Returns true iff the device is connected.
+         */
+        bool IsConnected() const ;
+
+        /**
+         * @brief Waits until the device of the serial port is connected.
+         * @param msTimeout The timeout period in milliseconds, or zero.
+         * @return Returns true if the device is connected.
+         */
+        bool WaitForReconnect(size_t msTimeout) ;
+
+        /**
+         * @brief Gets the device node the serial port is open on.
+         * @return Returns the device path, or an empty string.
+         */
+        std::string GetDevicePath() const ;
+
+        /**
+         * @brief Gets the number of reconnections.
+         * @return Returns the number of reconnections.
+         */
+        size_t GetNumberOfReconnects() const ;
+
+        /**
+         * @brief Sets the size of the replay queue.
+         * @param numberOfBytes The maximum number of bytes queued.
+         */
+        void SetReplayQueueSize(size_t numberOfBytes) ;
+
+        /**
+         * @brief Gets the size of the replay queue.
+         * @return Returns the maximum number of bytes queued.
+         */
+        size_t GetReplayQueueSize() const ;
+
+        /**
+         * @brief Gets the number of bytes waiting in the replay queue.
+         * @return Returns the number of bytes queued.
+         */
+        size_t GetNumberOfBytesQueued() const ;
+
+        /**
+         * @brief Gets the number of bytes dropped from the replay queue.
+         * @return Returns the number of bytes dropped.
+         */
+        size_t GetNumberOfBytesDropped() const ;
+
+        /**
+         * @brief Sets and caches all serial port parameters.
+         * @param portSettings The serial port parameters to be set.
+         */
+        void SetSerialPortParameters(const PortSettings& portSettings) ;
+
+        /**
+         * @brief Gets the serial port parameters.
+         * @return Returns the port settings.
+         */
+        PortSettings GetSerialPortParameters() const ;
+
+        /**
+         * @brief Sets and caches a custom bit rate.
+         * @param bitRate The bit rate in bits per second.
+         */
+        void SetBitRate(speed_t bitRate) ;
+
+        /**
+         * @brief Gets the underlying serial port.
+         * @return Returns the underlying serial port.
+         */
+        SerialPort& GetSerialPort() ;
+
+        /**
+         * @brief Reads up to bufferSize bytes into caller owned memory.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of bytes placed into dataBuffer.
+         */
+        size_t Read(uint8_t* dataBuffer,
+                    size_t   bufferSize,
+                    size_t   msTimeout) ;
+
+        /**
+         * @brief Reads exactly numberOfBytes bytes into dataBuffer.
+         * @param dataBuffer The data buffer to place data into.
+         * @param numberOfBytes The number of bytes to read.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void Read(DataBuffer& dataBuffer,
+                  size_t      numberOfBytes,
+                  size_t      msTimeout) ;
+
+        /**
+         * @brief Writes numberOfBytes bytes or queues them for replay.
+         * @param dataBuffer Pointer to the data to be written.
+         * @param numberOfBytes The number of bytes to write.
+         */
+        void Write(const uint8_t* dataBuffer,
+                   size_t         numberOfBytes) ;
+
+    private:
+        /**
+         * @brief Throws std::invalid_argument if the baud rate of the port
+         *        settings can never be applied, so that reconnection scans
+         *        need not tell invalid settings from a device not yet ready.
+         * @param portSettings The serial port parameters to be checked.
+         */
+        static void CheckPortSettings(const PortSettings& portSettings) ;
+
+        /**
+         * @brief Writes to the open serial port, advancing dataBuffer and
+         *        numberOfBytes past the bytes accepted by the driver, so
+         *        that only the rest is queued if the write fails part way.
+         * @param dataBuffer Pointer to the data to be written.
+         * @param numberOfBytes The number of bytes to write.
+         */
+        void WriteToDevice(const uint8_t*& dataBuffer,
+                           size_t&         numberOfBytes) ;
+
+        /**
+         * @brief Scans sysfs for the device and opens it if it is present,
+         *        then replays the queued writes.
+         * @return Returns true if the device is connected.
+         */
+        bool TryConnect() ;
+
+        /**
+         * @brief Closes the serial port of a device that has gone away,
+         *        keeping its current settings for the reconnection.
+         */
+        void HandleDisconnect() ;
+
+        /**
+         * @brief Sends the writes of the replay queue, oldest first.
+         */
+        void ReplayQueuedWrites() ;
+
+        /**
+         * @brief Appends a write to the replay queue, dropping the oldest
+         *        writes to make room.
+         * @param dataBuffer Pointer to the data to be queued.
+         * @param numberOfBytes The number of bytes to queue.
+         */
+        void QueueWrite(const uint8_t* dataBuffer,
+                        size_t         numberOfBytes) ;
+
+        /**
+         * @brief Drops the oldest queued writes until at most numberOfBytes
+         *        bytes remain in the replay queue.
+         * @param numberOfBytes The number of bytes to keep at most.
+         */
+        void TrimReplayQueue(size_t numberOfBytes) ;
+
+        /**
+         * @brief Finds the device and watches for hotplug events.
+         */
+        SerialPortEnumerator mSerialPortEnumerator ;
+
+        /**
+         * @brief The serial port of the device, closed while disconnected.
+         */
+        SerialPort mSerialPort {} ;
+
+        /**
+         * @brief The USB serial number identifying the device.
+         */
+        std::string mSerialNumber {} ;
+
+        /**
+         * @brief The device node the serial port is open on.
+         */
+        std::string mDevicePath {} ;
+
+        /**
+         * @brief The serial port parameters applied on reconnection.
+         */
+        PortSettings mPortSettings {} ;
+
+        /**
+         * @brief A bit rate set with SerialPort::SetBitRate(), which has no
+         *        BaudRate value, reapplied on reconnection, or zero.
+         */
+        speed_t mBitRate = 0 ;
+
+        /**
+         * @brief The mode the serial port is opened with.
+         */
+        std::ios_base::openmode mOpenMode = std::ios_base::in | std::ios_base::out ;
+
+        /**
+         * @brief True between Open() and Close().
+         */
+        bool mIsOpen = false ;
+
+        /**
+         * @brief The number of reconnections.
+         */
+        size_t mNumberOfReconnects = 0 ;
+
+        /**
+         * @brief The time of the last scan of sysfs for the device.
+         */
+        std::chrono::steady_clock::time_point mLastScanTime {} ;
+
+        /**
+         * @brief The writes waiting for the device to reconnect.
+         */
+        std::deque<DataBuffer> mReplayQueue {} ;
+
+        /**
+         * @brief The maximum number of bytes in the replay queue.
+         */
+        size_t mReplayQueueSize = 0 ;
+
+        /**
+         * @brief The number of bytes in the replay queue.
+         */
+        size_t mNumberOfBytesQueued = 0 ;
+
+        /**
+         * @brief The number of bytes dropped from the replay queue.
+         */
+        size_t mNumberOfBytesDropped = 0 ;
+    } ;
+
+    ResilientSerialPort::ResilientSerialPort(const std::string& sysfsTtyDirectory,
+                                             const std::string& deviceDirectory)
+        : mImpl(new Implementation(sysfsTtyDirectory,
+                                   deviceDirectory))
+    {
+        /* Empty */
+    }
+
+    ResilientSerialPort::~ResilientSerialPort() noexcept = default ;
+
+    void
+    ResilientSerialPort::Open(const std::string&             serialNumber,
+                              const PortSettings&            portSettings,
+                              const std::ios_base::openmode& openMode)
+    {
+        mImpl->Open(serialNumber,
+                    portSettings,
+                    openMode) ;
+    }
+
+    void
+    ResilientSerialPort::Close()
+    {
+        mImpl->Close() ;
+    }
+
+    bool
+    ResilientSerialPort::IsOpen() const
+    {
+        return mImpl->IsOpen() ;
+    }
+
+    bool
+    ResilientSerialPort::IsConnected() const
+    {
+        return mImpl->IsConnected() ;
+    }
+
+    bool
+    ResilientSerialPort::WaitForReconnect(const size_t msTimeout)
+    {
+        return mImpl->WaitForReconnect(msTimeout) ;
+    }
+
+    std::string
+    ResilientSerialPort::GetDevicePath() const
+    {
+        return mImpl->GetDevicePath() ;
+    }
+
+    size_t
+    ResilientSerialPort::GetNumberOfReconnects() const
+    {
+        return mImpl->GetNumberOfReconnects() ;
+    }
+
+    void
+    ResilientSerialPort::SetReplayQueueSize(const size_t numberOfBytes)
+    {
+        mImpl->SetReplayQueueSize(numberOfBytes) ;
+    }
+
+    size_t
+    ResilientSerialPort::GetReplayQueueSize() const
+    {
+        return mImpl->GetReplayQueueSize() ;
+    }
+
+    size_t
+    ResilientSerialPort::GetNumberOfBytesQueued() const
+    {
+        return mImpl->GetNumberOfBytesQueued() ;
+    }
+
+    size_t
+    ResilientSerialPort::GetNumberOfBytesDropped() const
+    {
+        return mImpl->GetNumberOfBytesDropped() ;
+    }
+
+    void
+    ResilientSerialPort::SetSerialPortParameters(const PortSettings& portSettings)
+    {
+        mImpl->SetSerialPortParameters(portSettings) ;
+    }
+
+    PortSettings
+    ResilientSerialPort::GetSerialPortParameters() const
+    {
+        return mImpl->GetSerialPortParameters() ;
+    }
+
+    void
+    ResilientSerialPort::SetBitRate(const speed_t bitRate)
+    {
+        mImpl->SetBitRate(bitRate) ;
+    }
+
+    SerialPort&
+    ResilientSerialPort::GetSerialPort()
+    {
+        return mImpl->GetSerialPort() ;
+    }
+
+    size_t
+    ResilientSerialPort::Read(uint8_t* const dataBuffer,
+                              const size_t   bufferSize,
+                              const size_t   msTimeout)
+    {
+        return mImpl->Read(dataBuffer,
+                           bufferSize,
+                           msTimeout) ;
+    }
+
+    void
+    ResilientSerialPort::Read(DataBuffer&  dataBuffer,
+                              const size_t numberOfBytes,
+                              const size_t msTimeout)
+    {
+        mImpl->Read(dataBuffer,
+                    numberOfBytes,
+                    msTimeout) ;
+    }
+
+    void
+    ResilientSerialPort::ReadByte(char&        charBuffer,
+                                  const size_t msTimeout)
+    {
+        uint8_t byte_buffer = 0 ;
+        mImpl->Read(&byte_buffer, 1, msTimeout) ;
+        charBuffer = static_cast<char>(byte_buffer) ;
+    }
+
+    void
+    ResilientSerialPort::Write(const uint8_t* const dataBuffer,
+                               const size_t         numberOfBytes)
+    {
+        mImpl->Write(dataBuffer,
+                     numberOfBytes) ;
+    }
+
+    void
+    ResilientSerialPort::Write(const DataBuffer& dataBuffer)
+    {
+        mImpl->Write(dataBuffer.data(),
+                     dataBuffer.size()) ;
+    }
+
+    void
+    ResilientSerialPort::Write(const std::string& dataString)
+    {
+        mImpl->Write(reinterpret_cast<const uint8_t*>(dataString.data()), // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                     dataString.size()) ;
+    }
+
+    inline
+    ResilientSerialPort::Implementation::Implementation(const std::string& sysfsTtyDirectory,
+                                                        const std::string& deviceDirectory)
+        : mSerialPortEnumerator(sysfsTtyDirectory,
+                                deviceDirectory)
+    {
+        /* Empty */
+    }
+
+    inline
+    ResilientSerialPort::Implementation::~Implementation() noexcept
+    try
+    {
+        if (this->IsOpen())
+        {
+            this->Close() ;
+        }
+    }
+    catch (...)
+    {
+        //
+        // :IMPORTANT: We do not let any exceptions escape the destructor.
+        // (see https://isocpp.org/wiki/faq/exceptions#dtors-shouldnt-throw)
+        //
+        // We could push the exception onto a stack for later processing
+        // by the caller, but there is not much the caller can do anyway.
+        //
+    }
+
+    inline
+    void
+    ResilientSerialPort::Implementation::Open(const std::string&             serialNumber,
+                                              const PortSettings&            portSettings,
+                                              const std::ios_base::openmode& openMode)
+    {
+        // Throw an exception if the port is already open.
+        if (this->IsOpen())
+        {
+            throw AlreadyOpen(ERR_MSG_PORT_ALREADY_OPEN) ;
+        }
+
+        CheckPortSettings(portSettings) ;
+
+        mSerialNumber = serialNumber ;
+        mPortSettings = portSettings ;
+        mBitRate = 0 ;
+        mOpenMode = openMode ;
+
+        if (not this->TryConnect())
+        {
+            throw OpenFailed(ERR_MSG_DEVICE_NOT_FOUND) ;
+        }
+
+        mIsOpen = true ;
+    }
+
+    inline
+    void
+    ResilientSerialPort::Implementation::Close()
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        mIsOpen = false ;
+        mDevicePath.clear() ;
+        this->TrimReplayQueue(0) ;
+
+        if (mSerialPortEnumerator.IsMonitoring())
+        {
+            mSerialPortEnumerator.StopMonitoring() ;
+        }
+
+        if (mSerialPort.IsOpen())
+        {
+            mSerialPort.Close() ;
+        }
+    }
+
+    inline
+    bool
+    ResilientSerialPort::Implementation::IsOpen() const
+    {
+        return mIsOpen ;
+    }
+
+    inline
+    bool
+    ResilientSerialPort::Implementation::IsConnected() const
+    {
+        return mSerialPort.IsOpen() ;
+    }
+
+    inline
+    bool
+    ResilientSerialPort::Implementation::WaitForReconnect(const size_t msTimeout)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        if (this->IsConnected())
+        {
+            return true ;
+        }
+
+        // Subscribe to hotplug events before scanning, so that the device
+        // cannot reappear unnoticed in between. Monitoring is an
+        // optimization only, (it may not be permitted, e.g. in a container),
+        // and periodic scans find the device without it.
+        if (not mSerialPortEnumerator.IsMonitoring())
+        {
+            try
+            {
+                mSerialPortEnumerator.StartMonitoring() ;
+            }
+            catch (const std::runtime_error&)
+            {
+                /* Fall back to periodic scans. */
+            }
+        }
+
+        const auto entry_time = std::chrono::steady_clock::now() ;
+        const auto scan_interval = std::chrono::milliseconds(RECONNECT_SCAN_INTERVAL_MS) ;
+
+        while (true)
+        {
+            // Scans are rate limited, so that a device which fails again
+            // right after being reopened, or a burst of unrelated hotplug
+            // events, cannot make this loop spin.
+            if ((std::chrono::steady_clock::now() - mLastScanTime >= scan_interval) and
+                this->TryConnect())
+            {
+                break ;
+            }
+
+            size_t remaining_ms = 0 ;
+
+            if (not GetRemainingTimeout(entry_time, msTimeout, remaining_ms))
+            {
+                return false ;
+            }
+
+            const auto wait_ms = (remaining_ms == 0) ?
+                                 RECONNECT_SCAN_INTERVAL_MS :
+                                 std::min(remaining_ms, RECONNECT_SCAN_INTERVAL_MS) ;
+
+            if (mSerialPortEnumerator.IsMonitoring())
+            {
+                // Any tty hotplug event ends the wait early.
+                try
+                {
+                    mSerialPortEnumerator.ReadEvent(wait_ms) ;
+                }
+                catch (const std::runtime_error&)
+                {
+                    /* Timed out, or the event queue overflowed. */
+                }
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(wait_ms)) ;
+            }
+        }
+
+        ++mNumberOfReconnects ;
+
+        return true ;
+    }
+
+    inline
+    std::string
+    ResilientSerialPort::Implementation::GetDevicePath() const
+    {
+        return mDevicePath ;
+    }
+
+    inline
+    size_t
+    ResilientSerialPort::Implementation::GetNumberOfReconnects() const
+    {
+        return mNumberOfReconnects ;
+    }
+
+    inline
+    void
+    ResilientSerialPort::Implementation::SetReplayQueueSize(const size_t numberOfBytes)
+    {
+        mReplayQueueSize = numberOfBytes ;
+        this->TrimReplayQueue(numberOfBytes) ;
+    }
+
+    inline
+    size_t
+    ResilientSerialPort::Implementation::GetReplayQueueSize() const
+    {
+        return mReplayQueueSize ;
+    }
+
+    inline
+    size_t
+    ResilientSerialPort::Implementation::GetNumberOfBytesQueued() const
+    {
+        return mNumberOfBytesQueued ;
+    }
+
+    inline
+    size_t
+    ResilientSerialPort::Implementation::GetNumberOfBytesDropped() const
+    {
+        return mNumberOfBytesDropped ;
+    }
+
+    inline
+    void
+    ResilientSerialPort::Implementation::SetSerialPortParameters(const PortSettings& portSettings)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        CheckPortSettings(portSettings) ;
+
+        if (this->IsConnected())
+        {
+            try
+            {
+                mSerialPort.SetSerialPortParameters(portSettings) ;
+            }
+            catch (const std::runtime_error&)
+            {
+                this->HandleDisconnect() ;
+            }
+        }
+
+        mPortSettings = portSettings ;
+        mBitRate = 0 ;
+    }
+
+    inline
+    PortSettings
+    ResilientSerialPort::Implementation::GetSerialPortParameters() const
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        if (this->IsConnected())
+        {
+            return mSerialPort.GetSerialPortParameters() ;
+        }
+
+        return mPortSettings ;
+    }
+
+    inline
+    void
+    ResilientSerialPort::Implementation::SetBitRate(const speed_t bitRate)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        if (bitRate == 0)
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_BIT_RATE) ;
+        }
+
+        if (this->IsConnected())
+        {
+            try
+            {
+                mSerialPort.SetBitRate(bitRate) ;
+            }
+            catch (const std::runtime_error&)
+            {
+                this->HandleDisconnect() ;
+            }
+        }
+
+        mBitRate = bitRate ;
+    }
+
+    inline
+    SerialPort&
+    ResilientSerialPort::Implementation::GetSerialPort()
+    {
+        return mSerialPort ;
+    }
+
+    inline
+    size_t
+    ResilientSerialPort::Implementation::Read(uint8_t* const dataBuffer,
+                                              const size_t   bufferSize,
+                                              const size_t   msTimeout)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        const auto entry_time = std::chrono::steady_clock::now() ;
+
+        while (true)
+        {
+            size_t remaining_ms = 0 ;
+
+            if ((not GetRemainingTimeout(entry_time, msTimeout, remaining_ms)) or
+                (not this->WaitForReconnect(remaining_ms)))
+            {
+                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+            }
+
+            if (not GetRemainingTimeout(entry_time, msTimeout, remaining_ms))
+            {
+                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+            }
+
+            try
+            {
+                return mSerialPort.Read(dataBuffer,
+                                        bufferSize,
+                                        remaining_ms) ;
+            }
+            catch (const ReadTimeout&)
+            {
+                throw ;
+            }
+            catch (const std::runtime_error&)
+            {
+                // The device went away, wait for it within the timeout.
+                this->HandleDisconnect() ;
+            }
+        }
+    }
+
+    inline
+    void
+    ResilientSerialPort::Implementation::Read(DataBuffer&  dataBuffer,
+                                              const size_t numberOfBytes,
+                                              const size_t msTimeout)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        dataBuffer.resize(numberOfBytes) ;
+
+        const auto entry_time = std::chrono::steady_clock::now() ;
+        size_t number_of_bytes_read = 0 ;
+
+        try
+        {
+            while (number_of_bytes_read < numberOfBytes)
+            {
+                size_t remaining_ms = 0 ;
+
+                if (not GetRemainingTimeout(entry_time, msTimeout, remaining_ms))
+                {
+                    throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+                }
+
+                number_of_bytes_read += this->Read(&dataBuffer[number_of_bytes_read],
+                                                   numberOfBytes - number_of_bytes_read,
+                                                   remaining_ms) ;
+            }
+        }
+        catch (const ReadTimeout&)
+        {
+            dataBuffer.resize(number_of_bytes_read) ;
+            throw ;
+        }
+    }
+
+    inline
+    void
+    ResilientSerialPort::Implementation::Write(const uint8_t* const dataBuffer,
+                                               const size_t         numberOfBytes)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // Writes do not wait for the device, but pick it up if it has
+        // reappeared since the last scan.
+        const auto scan_interval = std::chrono::milliseconds(RECONNECT_SCAN_INTERVAL_MS) ;
+
+        if ((not this->IsConnected()) and
+            (std::chrono::steady_clock::now() - mLastScanTime >= scan_interval) and
+            this->TryConnect())
+        {
+            ++mNumberOfReconnects ;
+        }
+
+        auto data_buffer = dataBuffer ;
+        auto number_of_bytes = numberOfBytes ;
+
+        if (this->IsConnected())
+        {
+            try
+            {
+                this->WriteToDevice(data_buffer, number_of_bytes) ;
+                return ;
+            }
+            catch (const std::runtime_error&)
+            {
+                this->HandleDisconnect() ;
+            }
+        }
+
+        // Only the bytes that the driver did not accept are queued.
+        this->QueueWrite(data_buffer, number_of_bytes) ;
+    }
+
+    inline
+    void
+    ResilientSerialPort::Implementation::CheckPortSettings(const PortSettings& portSettings)
+    {
+        termios port_settings {} ;
+
+        if (cfsetspeed(&port_settings,
+                       static_cast<speed_t>(portSettings.baudRate)) != 0)
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_BAUD_RATE) ;
+        }
+    }
+
+    inline
+    void
+    ResilientSerialPort::Implementation::WriteToDevice(const uint8_t*& dataBuffer,
+                                                       size_t&         numberOfBytes)
+    {
+        const auto file_descriptor = mSerialPort.GetFileDescriptor() ;
+
+        while (numberOfBytes > 0)
+        {
+            const auto write_result = call_with_retry(write,
+                                                      file_descriptor,
+                                                      dataBuffer,
+                                                      numberOfBytes) ;
+
+            // A write of zero bytes to a serial port means it was hung up.
+            if (write_result == 0)
+            {
+                throw std::runtime_error(std::strerror(EIO)) ;
+            }
+
+            if (write_result > 0)
+            {
+                dataBuffer += write_result ;
+                numberOfBytes -= static_cast<size_t>(write_result) ;
+                continue ;
+            }
+
+            if (errno != EWOULDBLOCK)
+            {
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            // Sleep until the driver accepts more data rather than spin.
+            pollfd poll_fd {file_descriptor, POLLOUT, 0} ;
+
+            if (call_with_retry(poll, &poll_fd, 1, -1) < 0)
+            {
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            if (0 == (poll_fd.revents & POLLOUT)) // NOLINT (hicpp-signed-bitwise)
+            {
+                throw std::runtime_error(std::strerror((poll_fd.revents & POLLNVAL) ? EBADF : EIO)) ; // NOLINT (hicpp-signed-bitwise)
+            }
+        }
+    }
+
+    inline
+    bool
+    ResilientSerialPort::Implementation::TryConnect()
+    {
+        mLastScanTime = std::chrono::steady_clock::now() ;
+
+        for (const auto& port_info : mSerialPortEnumerator.GetSerialPorts())
+        {
+            if (port_info.serialNumber != mSerialNumber)
+            {
+                continue ;
+            }
+
+            try
+            {
+                mSerialPort.Open(port_info.devicePath,
+                                 mPortSettings,
+                                 mOpenMode) ;
+            }
+            catch (const std::runtime_error&)
+            {
+                // The settings were checked when they were set, so the
+                // device node is not usable yet, (e.g. udev has not set its
+                // permissions), and is tried again on the next scan.
+                continue ;
+            }
+
+            if (mBitRate != 0)
+            {
+                try
+                {
+                    mSerialPort.SetBitRate(mBitRate) ;
+                }
+                catch (const std::runtime_error&)
+                {
+                    // The device went away again right after reappearing,
+                    // close it and keep the cached rate for the next scan.
+                    try
+                    {
+                        mSerialPort.Close() ;
+                    }
+                    catch (const std::runtime_error&)
+                    {
+                        /* The file descriptor is released even if close() fails. */
+                    }
+
+                    continue ;
+                }
+            }
+
+            mDevicePath = port_info.devicePath ;
+
+            if (mSerialPortEnumerator.IsMonitoring())
+            {
+                mSerialPortEnumerator.StopMonitoring() ;
+            }
+
+            try
+            {
+                this->ReplayQueuedWrites() ;
+            }
+            catch (const std::runtime_error&)
+            {
+                this->HandleDisconnect() ;
+                return false ;
+            }
+
+            return true ;
+        }
+
+        return false ;
+    }
+
+    inline
+    void
+    ResilientSerialPort::Implementation::HandleDisconnect()
+    {
+        mDevicePath.clear() ;
+
+        if (not mSerialPort.IsOpen())
+        {
+            return ;
+        }
+
+        // Keep changes made through GetSerialPort() for the reconnection.
+        // A custom bit rate reads back as BAUD_INVALID, so the last valid
+        // baud rate opens the port and the bit rate is reapplied after.
+        const auto last_baud_rate = mPortSettings.baudRate ;
+        mPortSettings = mSerialPort.GetSerialPortParameters() ;
+
+        if (mPortSettings.baudRate == BaudRate::BAUD_INVALID)
+        {
+            mPortSettings.baudRate = last_baud_rate ;
+
+            try
+            {
+                mBitRate = mSerialPort.GetBitRate() ;
+            }
+            catch (const std::runtime_error&)
+            {
+                // A hung up port cannot be queried, keep the cached rate.
+            }
+        }
+        else
+        {
+            mBitRate = 0 ;
+        }
+
+        try
+        {
+            mSerialPort.Close() ;
+        }
+        catch (const std::runtime_error&)
+        {
+            /* The file descriptor is released even if close() fails. */
+        }
+    }
+
+    inline
+    void
+    ResilientSerialPort::Implementation::ReplayQueuedWrites()
+    {
+        while (not mReplayQueue.empty())
+        {
+            auto& queued_write = mReplayQueue.front() ;
+
+            const uint8_t* data_buffer = queued_write.data() ;
+            size_t number_of_bytes = queued_write.size() ;
+
+            try
+            {
+                this->WriteToDevice(data_buffer, number_of_bytes) ;
+            }
+            catch (const std::runtime_error&)
+            {
+                // Keep only the bytes the driver did not accept.
+                const auto bytes_written = queued_write.size() - number_of_bytes ;
+
+                queued_write.erase(queued_write.begin(),
+                                   queued_write.begin() + static_cast<std::ptrdiff_t>(bytes_written)) ;
+                mNumberOfBytesQueued -= bytes_written ;
+                throw ;
+            }
+
+            mNumberOfBytesQueued -= queued_write.size() ;
+            mReplayQueue.pop_front() ;
+        }
+    }
+
+    inline
+    void
+    ResilientSerialPort::Implementation::QueueWrite(const uint8_t* const dataBuffer,
+                                                    const size_t         numberOfBytes)
+    {
+        if (mReplayQueueSize == 0)
+        {
+            throw std::runtime_error(ERR_MSG_PORT_DISCONNECTED) ;
+        }
+
+        if (numberOfBytes > mReplayQueueSize)
+        {
+            mNumberOfBytesDropped += numberOfBytes ;
+            return ;
+        }
+
+        this->TrimReplayQueue(mReplayQueueSize - numberOfBytes) ;
+
+        mReplayQueue.emplace_back(dataBuffer, dataBuffer + numberOfBytes) ;
+        mNumberOfBytesQueued += numberOfBytes ;
+    }
+
+    inline
+    void
+    ResilientSerialPort::Implementation::TrimReplayQueue(const size_t numberOfBytes)
+    {
+        while (mNumberOfBytesQueued > numberOfBytes)
+        {
+            const auto dropped_bytes = mReplayQueue.front().size() ;
+
+            mNumberOfBytesQueued -= dropped_bytes ;
+            mNumberOfBytesDropped += dropped_bytes ;
+            mReplayQueue.pop_front() ;
+        }
+    }
+
+} // namespace LibSerial
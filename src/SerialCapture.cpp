@@ -0,0 +1,1347 @@
+/******************************************************************************
+ * @file SerialCapture.cpp                                                    *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/SerialCapture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace LibSerial
+{
+    /**
+     * @brief Rounds a record size up to CAPTURE_RECORD_ALIGNMENT bytes.
+     * @param recordSize The size of the record header and its data.
+     * @return Returns the number of bytes the record occupies in the file.
+     */
+    constexpr size_t AlignCaptureRecordSize(const size_t recordSize)
+    {
+        return (recordSize + CAPTURE_RECORD_ALIGNMENT - 1) & ~(CAPTURE_RECORD_ALIGNMENT - 1) ;
+    }
+
+    /**
+     * @brief CaptureTap::Implementation is the CaptureTap implementation
+     *        class.
+     */
+    class CaptureTap::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor. Creates, sizes and maps the capture file.
+         * @param serialPort The serial port to capture.
+         * @param fileName The name of the capture file.
+         * @param initialFileSize The initial size of the capture file.
+         */
+        explicit Implementation(SerialPort&        serialPort,
+                                const std::string& fileName,
+                                size_t             initialFileSize) ;
+
+        /**
+         * @brief Default Destructor. Truncates the capture file to the
+         *        records made, unmaps and closes it.
+         */
+        ~Implementation() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Reads from the serial port and records the data read,
+         *        including any data received before a ReadTimeout.
+         * @param dataContainer The container to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        template <typename ContainerType>
+        void Read(ContainerType& dataContainer,
+                  size_t         numberOfBytes,
+                  size_t         msTimeout) ;
+
+        /**
+         * @brief Reads from the serial port into caller owned memory and
+         *        records the data read.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of bytes placed into dataBuffer.
+         */
+        size_t Read(uint8_t* dataBuffer,
+                    size_t   bufferSize,
+                    size_t   msTimeout) ;
+
+        /**
+         * @brief Reads a single byte from the serial port and records it.
+         * @param charBuffer The character read from the serial port.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadByte(unsigned char& charBuffer,
+                      size_t         msTimeout) ;
+
+        /**
+         * @brief Reads a line from the serial port and records the data
+         *        read, including a partial line before a ReadTimeout.
+         * @param dataString The data string read from the serial port.
+         * @param lineTerminator The line termination character.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadLine(std::string& dataString,
+                      char         lineTerminator,
+                      size_t       msTimeout) ;
+
+        /**
+         * @brief Writes to the serial port and records the data written.
+         * @param dataBuffer Pointer to the data to write to the serial port.
+         * @param bufferSize The number of bytes to write.
+         */
+        void Write(const uint8_t* dataBuffer,
+                   size_t         bufferSize) ;
+
+        /**
+         * @brief Appends a record to the capture file.
+         * @param captureDirection The direction of the data.
+         * @param dataBuffer Pointer to the data to be recorded.
+         * @param bufferSize The number of bytes to be recorded.
+         */
+        void Record(CaptureDirection captureDirection,
+                    const uint8_t*   dataBuffer,
+                    size_t           bufferSize) ;
+
+        /**
+         * @brief Gets the number of records made.
+         * @return Returns the number of records in the capture file.
+         */
+        size_t GetNumberOfRecords() const ;
+
+    private:
+        /**
+         * @brief Grows the capture file and its mapping until at least
+         *        requiredSize bytes are available. Must be called with mMutex
+         *        held.
+         * @param requiredSize The number of bytes required.
+         */
+        void GrowFile(size_t requiredSize) ;
+
+        /**
+         * @brief The serial port being captured.
+         */
+        SerialPort& mSerialPort ;
+
+        /**
+         * @brief Protects the members below.
+         */
+        mutable std::mutex mMutex {} ;
+
+        /**
+         * @brief The file descriptor of the capture file.
+         */
+        int mFileDescriptor = -1 ;
+
+        /**
+         * @brief The start of the shared mapping of the capture file.
+         */
+        uint8_t* mMapping = nullptr ;
+
+        /**
+         * @brief The size of the capture file and of its mapping.
+         */
+        size_t mMappingSize = 0 ;
+
+        /**
+         * @brief The number of bytes used, i.e. the header and the records.
+         */
+        size_t mUsedSize = sizeof(CaptureFileHeader) ;
+
+        /**
+         * @brief The number of records made.
+         */
+        size_t mNumberOfRecords = 0 ;
+
+        /**
+         * @brief The time the capture started, from which record timestamps
+         *        are measured.
+         */
+        std::chrono::steady_clock::time_point mStartTime {} ;
+    } ;
+
+    /**
+     * @brief ReplayPort::Implementation is the ReplayPort implementation
+     *        class.
+     */
+    class ReplayPort::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor. Maps and validates the capture file.
+         * @param fileName The name of the capture file.
+         * @param replaySpeed The replay speed relative to real time.
+         */
+        explicit Implementation(const std::string& fileName,
+                                double             replaySpeed) ;
+
+        /**
+         * @brief Default Destructor. Unmaps the capture file.
+         */
+        ~Implementation() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Reads the specified number of bytes into a container.
+         * @param dataContainer The container to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        template <typename ContainerType>
+        void Read(ContainerType& dataContainer,
+                  size_t         numberOfBytes,
+                  size_t         msTimeout) ;
+
+        /**
+         * @brief Reads up to bufferSize bytes into caller owned memory.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of bytes placed into dataBuffer.
+         */
+        size_t Read(uint8_t* dataBuffer,
+                    size_t   bufferSize,
+                    size_t   msTimeout) ;
+
+        /**
+         * @brief Reads a single byte.
+         * @param charBuffer The character read.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadByte(unsigned char& charBuffer,
+                      size_t         msTimeout) ;
+
+        /**
+         * @brief Reads a line.
+         * @param dataString The data string read.
+         * @param lineTerminator The line termination character.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadLine(std::string& dataString,
+                      char         lineTerminator,
+                      size_t       msTimeout) ;
+
+        /**
+         * @brief Discards written data, counting the bytes written.
+         * @param bufferSize The number of bytes written.
+         */
+        void Write(size_t bufferSize) ;
+
+        /**
+         * @brief Gets the number of bytes that have been replayed and are
+         *        waiting to be read.
+         * @return Returns the number of bytes available.
+         */
+        size_t GetNumberOfBytesAvailable() const ;
+
+        /**
+         * @brief Determines whether all of the captured data has been read.
+         * @return Returns true at the end of the capture.
+         */
+        bool IsEndOfCapture() const ;
+
+        /**
+         * @brief Restarts the replay from the start of the capture.
+         */
+        void Rewind() ;
+
+        /**
+         * @brief Gets the number of bytes written to the replay port.
+         * @return Returns the number of bytes written.
+         */
+        size_t GetNumberOfBytesWritten() const ;
+
+    private:
+        /**
+         * @brief Skips transmitted records and received records that have
+         *        been read completely.
+         */
+        void SkipToReceivedData() ;
+
+        /**
+         * @brief Reads the header of the record at the specified offset.
+         * @param recordOffset The offset of the record from the start of the
+         *        records.
+         * @return Returns the record header.
+         */
+        CaptureRecordHeader GetRecordHeader(size_t recordOffset) const ;
+
+        /**
+         * @brief Gets the time at which a record is replayed.
+         * @param recordHeader The record header.
+         * @return Returns the time at which the record data becomes available.
+         */
+        std::chrono::steady_clock::time_point GetReplayTime(const CaptureRecordHeader& recordHeader) const ;
+
+        /**
+         * @brief Waits until replayed data is available to be read.
+         * @param msTimeout The timeout period in milliseconds, or -1 to wait
+         *        until the next record is replayed.
+         * @return Returns true if data is available, or false on timeout or
+         *         at the end of the capture.
+         */
+        bool WaitForDataAvailable(int msTimeout) ;
+
+        /**
+         * @brief Copies replayed data that is available without waiting.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The maximum number of bytes to copy.
+         * @return Returns the number of bytes copied.
+         */
+        size_t ReadAvailable(uint8_t* dataBuffer,
+                             size_t   bufferSize) ;
+
+        /**
+         * @brief Gets the timeout remaining, as SerialPort does.
+         * @param entryTime The time at which the read started.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the remaining number of milliseconds, 0 if the
+         *         timeout has elapsed, or -1 if msTimeout is zero.
+         */
+        static int GetRemainingTimeout(const std::chrono::steady_clock::time_point& entryTime,
+                                       size_t msTimeout) ;
+
+        /**
+         * @brief The start of the private read-only mapping of the capture
+         *        file.
+         */
+        uint8_t* mMapping = nullptr ;
+
+        /**
+         * @brief The size of the mapping.
+         */
+        size_t mMappingSize = 0 ;
+
+        /**
+         * @brief The start of the records within the mapping.
+         */
+        const uint8_t* mRecords = nullptr ;
+
+        /**
+         * @brief The number of bytes of records.
+         */
+        size_t mRecordsSize = 0 ;
+
+        /**
+         * @brief The replay speed relative to real time, or zero to replay
+         *        all of the data at once.
+         */
+        double mReplaySpeed = 1.0 ;
+
+        /**
+         * @brief The offset of the current record from mRecords.
+         */
+        size_t mRecordOffset = 0 ;
+
+        /**
+         * @brief The number of data bytes of the current record already read.
+         */
+        size_t mRecordPosition = 0 ;
+
+        /**
+         * @brief The time the replay started.
+         */
+        std::chrono::steady_clock::time_point mStartTime {} ;
+
+        /**
+         * @brief The number of bytes written to the replay port.
+         */
+        size_t mNumberOfBytesWritten = 0 ;
+    } ;
+
+    CaptureTap::CaptureTap(SerialPort&        serialPort,
+                           const std::string& fileName,
+                           const size_t       initialFileSize)
+        : mImpl(new Implementation(serialPort,
+                                   fileName,
+                                   initialFileSize))
+    {
+        /* Empty */
+    }
+
+    CaptureTap::~CaptureTap() = default ;
+
+    void
+    CaptureTap::Read(DataBuffer&  dataBuffer,
+                     const size_t numberOfBytes,
+                     const size_t msTimeout)
+    {
+        mImpl->Read(dataBuffer,
+                    numberOfBytes,
+                    msTimeout) ;
+    }
+
+    void
+    CaptureTap::Read(std::string& dataString,
+                     const size_t numberOfBytes,
+                     const size_t msTimeout)
+    {
+        mImpl->Read(dataString,
+                    numberOfBytes,
+                    msTimeout) ;
+    }
+
+    size_t
+    CaptureTap::Read(uint8_t* const dataBuffer,
+                     const size_t   bufferSize,
+                     const size_t   msTimeout)
+    {
+        return mImpl->Read(dataBuffer,
+                           bufferSize,
+                           msTimeout) ;
+    }
+
+    void
+    CaptureTap::ReadByte(unsigned char& charBuffer,
+                         const size_t   msTimeout)
+    {
+        mImpl->ReadByte(charBuffer,
+                        msTimeout) ;
+    }
+
+    void
+    CaptureTap::ReadLine(std::string& dataString,
+                         const char   lineTerminator,
+                         const size_t msTimeout)
+    {
+        mImpl->ReadLine(dataString,
+                        lineTerminator,
+                        msTimeout) ;
+    }
+
+    void
+    CaptureTap::Write(const DataBuffer& dataBuffer)
+    {
+        mImpl->Write(dataBuffer.data(),
+                     dataBuffer.size()) ;
+    }
+
+    void
+    CaptureTap::Write(const std::string& dataString)
+    {
+        mImpl->Write(reinterpret_cast<const uint8_t*>(dataString.data()), // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                     dataString.size()) ;
+    }
+
+    void
+    CaptureTap::Write(const uint8_t* const dataBuffer,
+                      const size_t         bufferSize)
+    {
+        mImpl->Write(dataBuffer,
+                     bufferSize) ;
+    }
+
+    void
+    CaptureTap::WriteByte(const unsigned char charBuffer)
+    {
+        mImpl->Write(&charBuffer,
+                     sizeof(charBuffer)) ;
+    }
+
+    void
+    CaptureTap::Record(const CaptureDirection captureDirection,
+                       const uint8_t* const   dataBuffer,
+                       const size_t           bufferSize)
+    {
+        mImpl->Record(captureDirection,
+                      dataBuffer,
+                      bufferSize) ;
+    }
+
+    size_t
+    CaptureTap::GetNumberOfRecords() const
+    {
+        return mImpl->GetNumberOfRecords() ;
+    }
+
+    ReplayPort::ReplayPort(const std::string& fileName,
+                           const double       replaySpeed)
+        : mImpl(new Implementation(fileName,
+                                   replaySpeed))
+    {
+        /* Empty */
+    }
+
+    ReplayPort::~ReplayPort() = default ;
+
+    void
+    ReplayPort::Read(DataBuffer&  dataBuffer,
+                     const size_t numberOfBytes,
+                     const size_t msTimeout)
+    {
+        mImpl->Read(dataBuffer,
+                    numberOfBytes,
+                    msTimeout) ;
+    }
+
+    void
+    ReplayPort::Read(std::string& dataString,
+                     const size_t numberOfBytes,
+                     const size_t msTimeout)
+    {
+        mImpl->Read(dataString,
+                    numberOfBytes,
+                    msTimeout) ;
+    }
+
+    size_t
+    ReplayPort::Read(uint8_t* const dataBuffer,
+                     const size_t   bufferSize,
+                     const size_t   msTimeout)
+    {
+        return mImpl->Read(dataBuffer,
+                           bufferSize,
+                           msTimeout) ;
+    }
+
+    void
+    ReplayPort::ReadByte(unsigned char& charBuffer,
+                         const size_t   msTimeout)
+    {
+        mImpl->ReadByte(charBuffer,
+                        msTimeout) ;
+    }
+
+    void
+    ReplayPort::ReadLine(std::string& dataString,
+                         const char   lineTerminator,
+                         const size_t msTimeout)
+    {
+        mImpl->ReadLine(dataString,
+                        lineTerminator,
+                        msTimeout) ;
+    }
+
+    void
+    ReplayPort::Write(const DataBuffer& dataBuffer)
+    {
+        mImpl->Write(dataBuffer.size()) ;
+    }
+
+    void
+    ReplayPort::Write(const std::string& dataString)
+    {
+        mImpl->Write(dataString.size()) ;
+    }
+
+    void
+    ReplayPort::Write(const uint8_t* const dataBuffer [[maybe_unused]],
+                      const size_t         bufferSize)
+    {
+        mImpl->Write(bufferSize) ;
+    }
+
+    void
+    ReplayPort::WriteByte(const unsigned char charBuffer [[maybe_unused]])
+    {
+        mImpl->Write(sizeof(charBuffer)) ;
+    }
+
+    bool
+    ReplayPort::IsDataAvailable() const
+    {
+        return mImpl->GetNumberOfBytesAvailable() > 0 ;
+    }
+
+    size_t
+    ReplayPort::GetNumberOfBytesAvailable() const
+    {
+        return mImpl->GetNumberOfBytesAvailable() ;
+    }
+
+    bool
+    ReplayPort::IsEndOfCapture() const
+    {
+        return mImpl->IsEndOfCapture() ;
+    }
+
+    void
+    ReplayPort::Rewind()
+    {
+        mImpl->Rewind() ;
+    }
+
+    size_t
+    ReplayPort::GetNumberOfBytesWritten() const
+    {
+        return mImpl->GetNumberOfBytesWritten() ;
+    }
+
+    inline
+    CaptureTap::Implementation::Implementation(SerialPort&        serialPort,
+                                               const std::string& fileName,
+                                               const size_t       initialFileSize)
+        : mSerialPort(serialPort)
+        , mMappingSize(std::max(initialFileSize,
+                                AlignCaptureRecordSize(sizeof(CaptureFileHeader) +
+                                                       sizeof(CaptureRecordHeader))))
+    {
+        mFileDescriptor = open(fileName.c_str(),
+                               O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, // NOLINT (hicpp-signed-bitwise)
+                               0644) ;
+
+        if (mFileDescriptor < 0)
+        {
+            throw OpenFailed(std::strerror(errno)) ;
+        }
+
+        if (ftruncate(mFileDescriptor,
+                      static_cast<off_t>(mMappingSize)) < 0)
+        {
+            const auto error_number = errno ;
+            close(mFileDescriptor) ;
+            throw OpenFailed(std::strerror(error_number)) ;
+        }
+
+        const auto mapping = mmap(nullptr,
+                                  mMappingSize,
+                                  PROT_READ | PROT_WRITE, // NOLINT (hicpp-signed-bitwise)
+                                  MAP_SHARED,
+                                  mFileDescriptor,
+                                  0) ;
+
+        if (mapping == MAP_FAILED) // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+        {
+            const auto error_number = errno ;
+            close(mFileDescriptor) ;
+            throw OpenFailed(std::strerror(error_number)) ;
+        }
+
+        mMapping = static_cast<uint8_t*>(mapping) ;
+
+        CaptureFileHeader file_header {} ;
+        file_header.magic = CAPTURE_FILE_MAGIC ;
+        file_header.version = CAPTURE_FILE_VERSION ;
+        file_header.headerSize = sizeof(CaptureFileHeader) ;
+        file_header.dataSize = 0 ;
+
+        std::memcpy(mMapping, &file_header, sizeof(file_header)) ;
+
+        mStartTime = std::chrono::steady_clock::now() ;
+    }
+
+    inline
+    CaptureTap::Implementation::~Implementation()
+    {
+        // Drop the unused tail so that the file holds only the records made.
+        munmap(mMapping, mMappingSize) ;
+
+        if (ftruncate(mFileDescriptor,
+                      static_cast<off_t>(mUsedSize)) < 0)
+        {
+            // Nothing more can be done from a destructor, and the records
+            // remain readable as CaptureFileHeader::dataSize bounds them.
+        }
+
+        close(mFileDescriptor) ;
+    }
+
+    template <typename ContainerType>
+    inline
+    void
+    CaptureTap::Implementation::Read(ContainerType& dataContainer,
+                                     const size_t   numberOfBytes,
+                                     const size_t   msTimeout)
+    {
+        try
+        {
+            mSerialPort.Read(dataContainer,
+                             numberOfBytes,
+                             msTimeout) ;
+        }
+        catch (const ReadTimeout&)
+        {
+            this->Record(CaptureDirection::CAPTURE_DIRECTION_RECEIVED,
+                         reinterpret_cast<const uint8_t*>(dataContainer.data()), // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                         dataContainer.size()) ;
+            throw ;
+        }
+
+        this->Record(CaptureDirection::CAPTURE_DIRECTION_RECEIVED,
+                     reinterpret_cast<const uint8_t*>(dataContainer.data()), // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                     dataContainer.size()) ;
+    }
+
+    inline
+    size_t
+    CaptureTap::Implementation::Read(uint8_t* const dataBuffer,
+                                     const size_t   bufferSize,
+                                     const size_t   msTimeout)
+    {
+        const auto number_of_bytes_read = mSerialPort.Read(dataBuffer,
+                                                           bufferSize,
+                                                           msTimeout) ;
+
+        this->Record(CaptureDirection::CAPTURE_DIRECTION_RECEIVED,
+                     dataBuffer,
+                     number_of_bytes_read) ;
+
+        return number_of_bytes_read ;
+    }
+
+    inline
+    void
+    CaptureTap::Implementation::ReadByte(unsigned char& charBuffer,
+                                         const size_t   msTimeout)
+    {
+        mSerialPort.ReadByte(charBuffer,
+                             msTimeout) ;
+
+        this->Record(CaptureDirection::CAPTURE_DIRECTION_RECEIVED,
+                     &charBuffer,
+                     sizeof(charBuffer)) ;
+    }
+
+    inline
+    void
+    CaptureTap::Implementation::ReadLine(std::string& dataString,
+                                         const char   lineTerminator,
+                                         const size_t msTimeout)
+    {
+        try
+        {
+            mSerialPort.ReadLine(dataString,
+                                 lineTerminator,
+                                 msTimeout) ;
+        }
+        catch (const ReadTimeout&)
+        {
+            this->Record(CaptureDirection::CAPTURE_DIRECTION_RECEIVED,
+                         reinterpret_cast<const uint8_t*>(dataString.data()), // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                         dataString.size()) ;
+            throw ;
+        }
+
+        this->Record(CaptureDirection::CAPTURE_DIRECTION_RECEIVED,
+                     reinterpret_cast<const uint8_t*>(dataString.data()), // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                     dataString.size()) ;
+    }
+
+    inline
+    void
+    CaptureTap::Implementation::Write(const uint8_t* const dataBuffer,
+                                      const size_t         bufferSize)
+    {
+        mSerialPort.Write(dataBuffer,
+                          bufferSize) ;
+
+        this->Record(CaptureDirection::CAPTURE_DIRECTION_TRANSMITTED,
+                     dataBuffer,
+                     bufferSize) ;
+    }
+
+    inline
+    void
+    CaptureTap::Implementation::Record(const CaptureDirection captureDirection,
+                                       const uint8_t* const   dataBuffer,
+                                       const size_t           bufferSize)
+    {
+        if (bufferSize == 0)
+        {
+            return ;
+        }
+
+        if (bufferSize > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_BUFFER_SIZE) ;
+        }
+
+        const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - mStartTime).count() ;
+
+        std::lock_guard<std::mutex> lock(mMutex) ;
+
+        const auto record_size = AlignCaptureRecordSize(sizeof(CaptureRecordHeader) + bufferSize) ;
+
+        if (mUsedSize + record_size > mMappingSize)
+        {
+            this->GrowFile(mUsedSize + record_size) ;
+        }
+
+        CaptureRecordHeader record_header {} ;
+        record_header.timestamp = static_cast<uint64_t>(timestamp) ;
+        record_header.size = static_cast<uint32_t>(bufferSize) ;
+        record_header.direction = static_cast<uint8_t>(captureDirection) ;
+
+        std::memcpy(mMapping + mUsedSize,
+                    &record_header,
+                    sizeof(record_header)) ;
+
+        std::memcpy(mMapping + mUsedSize + sizeof(record_header),
+                    dataBuffer,
+                    bufferSize) ;
+
+        mUsedSize += record_size ;
+        mNumberOfRecords++ ;
+
+        // Publish the record only once it is complete, so that a reader of
+        // the file never sees a partial record.
+        const uint64_t data_size = mUsedSize - sizeof(CaptureFileHeader) ;
+        std::memcpy(mMapping + offsetof(CaptureFileHeader, dataSize),
+                    &data_size,
+                    sizeof(data_size)) ;
+    }
+
+    inline
+    size_t
+    CaptureTap::Implementation::GetNumberOfRecords() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex) ;
+        return mNumberOfRecords ;
+    }
+
+    inline
+    void
+    CaptureTap::Implementation::GrowFile(const size_t requiredSize)
+    {
+        auto new_mapping_size = mMappingSize ;
+
+        while (new_mapping_size < requiredSize)
+        {
+            new_mapping_size *= 2 ;
+        }
+
+        if (ftruncate(mFileDescriptor,
+                      static_cast<off_t>(new_mapping_size)) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        const auto mapping = mremap(mMapping,
+                                    mMappingSize,
+                                    new_mapping_size,
+                                    MREMAP_MAYMOVE) ;
+
+        if (mapping == MAP_FAILED) // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        mMapping = static_cast<uint8_t*>(mapping) ;
+        mMappingSize = new_mapping_size ;
+    }
+
+    inline
+    ReplayPort::Implementation::Implementation(const std::string& fileName,
+                                               const double       replaySpeed)
+        : mReplaySpeed(replaySpeed)
+    {
+        if (not (replaySpeed >= 0.0) or
+            std::isinf(replaySpeed))
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_REPLAY_SPEED) ;
+        }
+
+        const auto file_descriptor = open(fileName.c_str(),
+                                          O_RDONLY | O_CLOEXEC) ; // NOLINT (hicpp-signed-bitwise)
+
+        if (file_descriptor < 0)
+        {
+            throw OpenFailed(std::strerror(errno)) ;
+        }
+
+        struct stat file_status {} ;
+
+        if (fstat(file_descriptor, &file_status) < 0)
+        {
+            const auto error_number = errno ;
+            close(file_descriptor) ;
+            throw OpenFailed(std::strerror(error_number)) ;
+        }
+
+        if (static_cast<size_t>(file_status.st_size) < sizeof(CaptureFileHeader))
+        {
+            close(file_descriptor) ;
+            throw std::runtime_error(ERR_MSG_INVALID_CAPTURE_FILE) ;
+        }
+
+        mMappingSize = static_cast<size_t>(file_status.st_size) ;
+
+        const auto mapping = mmap(nullptr,
+                                  mMappingSize,
+                                  PROT_READ,
+                                  MAP_PRIVATE,
+                                  file_descriptor,
+                                  0) ;
+
+        // The mapping remains valid once the file is closed.
+        const auto error_number = errno ;
+        close(file_descriptor) ;
+
+        if (mapping == MAP_FAILED) // NOLINT (cppcoreguidelines-pro-type-cstyle-cast)
+        {
+            throw OpenFailed(std::strerror(error_number)) ;
+        }
+
+        mMapping = static_cast<uint8_t*>(mapping) ;
+
+        CaptureFileHeader file_header {} ;
+        std::memcpy(&file_header, mMapping, sizeof(file_header)) ;
+
+        // Validate the header and every record up front so that reads
+        // never run past the end of the mapping.
+        auto is_valid = (file_header.magic == CAPTURE_FILE_MAGIC) and
+                        (file_header.version == CAPTURE_FILE_VERSION) and
+                        (file_header.headerSize >= sizeof(CaptureFileHeader)) and
+                        (file_header.headerSize <= mMappingSize) and
+                        (file_header.dataSize <= mMappingSize - file_header.headerSize) ;
+
+        if (is_valid)
+        {
+            mRecords = mMapping + file_header.headerSize ;
+            mRecordsSize = static_cast<size_t>(file_header.dataSize) ;
+
+            size_t record_offset = 0 ;
+
+            while (is_valid and
+                   (record_offset < mRecordsSize))
+            {
+                if (mRecordsSize - record_offset < sizeof(CaptureRecordHeader))
+                {
+                    is_valid = false ;
+                    break ;
+                }
+
+                const auto record_header = this->GetRecordHeader(record_offset) ;
+                const auto record_size = AlignCaptureRecordSize(sizeof(CaptureRecordHeader) +
+                                                                record_header.size) ;
+
+                is_valid = (record_header.direction <= static_cast<uint8_t>(CaptureDirection::CAPTURE_DIRECTION_TRANSMITTED)) and
+                           (record_size <= mRecordsSize - record_offset) ;
+
+                record_offset += record_size ;
+            }
+        }
+
+        if (not is_valid)
+        {
+            munmap(mMapping, mMappingSize) ;
+            throw std::runtime_error(ERR_MSG_INVALID_CAPTURE_FILE) ;
+        }
+
+        this->Rewind() ;
+    }
+
+    inline
+    ReplayPort::Implementation::~Implementation()
+    {
+        munmap(mMapping, mMappingSize) ;
+    }
+
+    template <typename ContainerType>
+    inline
+    void
+    ReplayPort::Implementation::Read(ContainerType& dataContainer,
+                                     const size_t   numberOfBytes,
+                                     const size_t   msTimeout)
+    {
+        if ((numberOfBytes == 0) and
+            (msTimeout == 0))
+        {
+            return ;
+        }
+
+        size_t number_of_bytes_read = 0 ;
+
+        dataContainer.clear() ;
+        dataContainer.resize(numberOfBytes) ;
+
+        const auto entry_time = std::chrono::steady_clock::now() ;
+
+        while ((numberOfBytes == 0) or
+               (number_of_bytes_read < numberOfBytes))
+        {
+            const auto remaining_ms = GetRemainingTimeout(entry_time, msTimeout) ;
+
+            if ((remaining_ms == 0) or
+                (not this->WaitForDataAvailable(remaining_ms)))
+            {
+                dataContainer.resize(number_of_bytes_read) ;
+                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+            }
+
+            if (numberOfBytes == 0)
+            {
+                dataContainer.resize(number_of_bytes_read + this->GetNumberOfBytesAvailable()) ;
+            }
+
+            number_of_bytes_read += this->ReadAvailable(reinterpret_cast<uint8_t*>(&dataContainer[number_of_bytes_read]), // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                                                        dataContainer.size() - number_of_bytes_read) ;
+        }
+    }
+
+    inline
+    size_t
+    ReplayPort::Implementation::Read(uint8_t* const dataBuffer,
+                                     const size_t   bufferSize,
+                                     const size_t   msTimeout)
+    {
+        if (bufferSize == 0)
+        {
+            return 0 ;
+        }
+
+        const auto entry_time = std::chrono::steady_clock::now() ;
+        const auto remaining_ms = GetRemainingTimeout(entry_time, msTimeout) ;
+
+        if (not this->WaitForDataAvailable(remaining_ms))
+        {
+            throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+        }
+
+        return this->ReadAvailable(dataBuffer,
+                                   bufferSize) ;
+    }
+
+    inline
+    void
+    ReplayPort::Implementation::ReadByte(unsigned char& charBuffer,
+                                         const size_t   msTimeout)
+    {
+        this->Read(&charBuffer,
+                   sizeof(charBuffer),
+                   msTimeout) ;
+    }
+
+    inline
+    void
+    ReplayPort::Implementation::ReadLine(std::string& dataString,
+                                         const char   lineTerminator,
+                                         const size_t msTimeout)
+    {
+        dataString.clear() ;
+
+        const auto entry_time = std::chrono::steady_clock::now() ;
+
+        while (true)
+        {
+            const auto remaining_ms = GetRemainingTimeout(entry_time, msTimeout) ;
+
+            if ((remaining_ms == 0) or
+                (not this->WaitForDataAvailable(remaining_ms)))
+            {
+                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+            }
+
+            // Copy the replayed data up to and including the terminator,
+            // a record at a time.
+            this->SkipToReceivedData() ;
+
+            const auto record_header = this->GetRecordHeader(mRecordOffset) ;
+            const auto record_data = mRecords + mRecordOffset + sizeof(CaptureRecordHeader) ;
+            const auto data_begin = record_data + mRecordPosition ;
+            const auto data_end = record_data + record_header.size ;
+            const auto line_terminator = std::find(data_begin,
+                                                   data_end,
+                                                   static_cast<uint8_t>(lineTerminator)) ;
+            const auto copy_end = (line_terminator == data_end) ? data_end : line_terminator + 1 ;
+
+            dataString.append(data_begin, copy_end) ;
+            mRecordPosition += static_cast<size_t>(copy_end - data_begin) ;
+
+            if (line_terminator != data_end)
+            {
+                return ;
+            }
+        }
+    }
+
+    inline
+    void
+    ReplayPort::Implementation::Write(const size_t bufferSize)
+    {
+        mNumberOfBytesWritten += bufferSize ;
+    }
+
+    inline
+    size_t
+    ReplayPort::Implementation::GetNumberOfBytesAvailable() const
+    {
+        const auto current_time = std::chrono::steady_clock::now() ;
+
+        size_t number_of_bytes_available = 0 ;
+        auto record_position = mRecordPosition ;
+
+        for (auto record_offset = mRecordOffset;
+             record_offset < mRecordsSize;
+             record_offset += AlignCaptureRecordSize(sizeof(CaptureRecordHeader) +
+                                                     this->GetRecordHeader(record_offset).size))
+        {
+            const auto record_header = this->GetRecordHeader(record_offset) ;
+
+            if (record_header.direction == static_cast<uint8_t>(CaptureDirection::CAPTURE_DIRECTION_RECEIVED))
+            {
+                if (this->GetReplayTime(record_header) > current_time)
+                {
+                    break ;
+                }
+
+                number_of_bytes_available += record_header.size - record_position ;
+            }
+
+            record_position = 0 ;
+        }
+
+        return number_of_bytes_available ;
+    }
+
+    inline
+    bool
+    ReplayPort::Implementation::IsEndOfCapture() const
+    {
+        auto record_position = mRecordPosition ;
+
+        for (auto record_offset = mRecordOffset;
+             record_offset < mRecordsSize;
+             record_offset += AlignCaptureRecordSize(sizeof(CaptureRecordHeader) +
+                                                     this->GetRecordHeader(record_offset).size))
+        {
+            const auto record_header = this->GetRecordHeader(record_offset) ;
+
+            if ((record_header.direction == static_cast<uint8_t>(CaptureDirection::CAPTURE_DIRECTION_RECEIVED)) and
+                (record_position < record_header.size))
+            {
+                return false ;
+            }
+
+            record_position = 0 ;
+        }
+
+        return true ;
+    }
+
+    inline
+    void
+    ReplayPort::Implementation::Rewind()
+    {
+        mRecordOffset = 0 ;
+        mRecordPosition = 0 ;
+        mStartTime = std::chrono::steady_clock::now() ;
+    }
+
+    inline
+    size_t
+    ReplayPort::Implementation::GetNumberOfBytesWritten() const
+    {
+        return mNumberOfBytesWritten ;
+    }
+
+    inline
+    void
+    ReplayPort::Implementation::SkipToReceivedData()
+    {
+        while (mRecordOffset < mRecordsSize)
+        {
+            const auto record_header = this->GetRecordHeader(mRecordOffset) ;
+
+            if ((record_header.direction == static_cast<uint8_t>(CaptureDirection::CAPTURE_DIRECTION_RECEIVED)) and
+                (mRecordPosition < record_header.size))
+            {
+                return ;
+            }
+
+            mRecordOffset += AlignCaptureRecordSize(sizeof(CaptureRecordHeader) +
+                                                    record_header.size) ;
+            mRecordPosition = 0 ;
+        }
+    }
+
+    inline
+    CaptureRecordHeader
+    ReplayPort::Implementation::GetRecordHeader(const size_t recordOffset) const
+    {
+        CaptureRecordHeader record_header {} ;
+
+        std::memcpy(&record_header,
+                    mRecords + recordOffset,
+                    sizeof(record_header)) ;
+
+        return record_header ;
+    }
+
+    inline
+    std::chrono::steady_clock::time_point
+    ReplayPort::Implementation::GetReplayTime(const CaptureRecordHeader& recordHeader) const
+    {
+        if (mReplaySpeed == 0.0)
+        {
+            return mStartTime ;
+        }
+
+        const auto replay_offset = static_cast<double>(recordHeader.timestamp) / mReplaySpeed ;
+
+        return mStartTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::nano>(replay_offset)) ;
+    }
+
+    inline
+    bool
+    ReplayPort::Implementation::WaitForDataAvailable(const int msTimeout)
+    {
+        this->SkipToReceivedData() ;
+
+        if (mRecordOffset >= mRecordsSize)
+        {
+            return false ;
+        }
+
+        const auto replay_time = this->GetReplayTime(this->GetRecordHeader(mRecordOffset)) ;
+        const auto current_time = std::chrono::steady_clock::now() ;
+
+        if (replay_time <= current_time)
+        {
+            return true ;
+        }
+
+        if ((msTimeout >= 0) and
+            (current_time + std::chrono::milliseconds(msTimeout) < replay_time))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(msTimeout)) ;
+            return false ;
+        }
+
+        std::this_thread::sleep_until(replay_time) ;
+        return true ;
+    }
+
+    inline
+    size_t
+    ReplayPort::Implementation::ReadAvailable(uint8_t* const dataBuffer,
+                                              const size_t   bufferSize)
+    {
+        const auto current_time = std::chrono::steady_clock::now() ;
+
+        size_t number_of_bytes_read = 0 ;
+
+        while (number_of_bytes_read < bufferSize)
+        {
+            this->SkipToReceivedData() ;
+
+            if (mRecordOffset >= mRecordsSize)
+            {
+                break ;
+            }
+
+            const auto record_header = this->GetRecordHeader(mRecordOffset) ;
+
+            if (this->GetReplayTime(record_header) > current_time)
+            {
+                break ;
+            }
+
+            const auto number_of_bytes_to_copy = std::min(bufferSize - number_of_bytes_read,
+                                                          record_header.size - mRecordPosition) ;
+
+            std::memcpy(dataBuffer + number_of_bytes_read,
+                        mRecords + mRecordOffset + sizeof(CaptureRecordHeader) + mRecordPosition,
+                        number_of_bytes_to_copy) ;
+
+            number_of_bytes_read += number_of_bytes_to_copy ;
+            mRecordPosition += number_of_bytes_to_copy ;
+        }
+
+        return number_of_bytes_read ;
+    }
+
+    inline
+    int
+    ReplayPort::Implementation::GetRemainingTimeout(const std::chrono::steady_clock::time_point& entryTime,
+                                                    const size_t msTimeout)
+    {
+        if (msTimeout == 0)
+        {
+            return -1 ;
+        }
+
+        const auto elapsed_ms = static_cast<size_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - entryTime).count()) ;
+
+        if (elapsed_ms >= msTimeout)
+        {
+            return 0 ;
+        }
+
+        return static_cast<int>(std::min(msTimeout - elapsed_ms,
+                                         static_cast<size_t>(std::numeric_limits<int>::max()))) ;
+    }
+
+} // namespace LibSerial
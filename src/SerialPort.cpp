@@ -32,14 +32,29 @@
  *****************************************************************************/
 
 #include "libserial/SerialPort.h"
-
+#include "libserial/SerialPortEnumerator.h"
+#include "ModemLineWait.h"
+#include "StatisticsRecording.h"
+#include "Termios2.h"
+#include "TransmitQueue.h"
+
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
+#include <fstream>
+#include <mutex>
 #include <linux/serial.h>
+#include <poll.h>
 #include <sstream>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <sys/uio.h>
+#include <thread>
 #include <type_traits>
 #include <unistd.h>
 
@@ -103,13 +118,16 @@ namespace LibSerial
 
         /**
          * @brief Opens the serial port associated with the specified
-         *        file name and the specified mode.
+         *        file name and the specified mode, and configures it with
+         *        the specified parameters.
          * @param fileName The file name of the serial port.
          * @param openMode The communication mode status when the serial
          *        communication port is opened.
+         * @param portSettings The serial port parameters to be set.
          */
         void Open(const std::string& fileName,
-                  const std::ios_base::openmode& openMode) ;
+                  const std::ios_base::openmode& openMode,
+                  const PortSettings& portSettings) ;
 
         /**
          * @brief Closes the serial port. All settings of the serial port will be
@@ -122,6 +140,14 @@ namespace LibSerial
          */
         void DrainWriteBuffer() ;
 
+        /**
+         * @brief Waits until the write buffer is drained or the timeout
+         *        period elapses.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns true iff the write buffer was drained.
+         */
+        bool DrainWriteBuffer(size_t msTimeout) ;
+
         /**
          * @brief Flushes the serial port input buffer.
          */
@@ -153,6 +179,26 @@ namespace LibSerial
          */
         void SetDefaultSerialPortParameters() ;
 
+        /**
+         * @brief Sets the default modes of the serial port together with the
+         *        specified parameters, with a single call to tcsetattr().
+         * @param portSettings The serial port parameters to be set.
+         */
+        void SetDefaultSerialPortParameters(const PortSettings& portSettings) ;
+
+        /**
+         * @brief Sets all of the serial port parameters with a single call
+         *        to tcsetattr().
+         * @param portSettings The serial port parameters to be set.
+         */
+        void SetSerialPortParameters(const PortSettings& portSettings) ;
+
+        /**
+         * @brief Gets all of the serial port parameters.
+         * @return Returns the current serial port parameters.
+         */
+        PortSettings GetSerialPortParameters() const ;
+
         /**
          * @brief Sets the baud rate for the serial port to the specified value
          * @param baudRate The baud rate to be set for the serial port.
@@ -165,6 +211,18 @@ namespace LibSerial
          */
         BaudRate GetBaudRate() const ;
 
+        /**
+         * @brief Sets the serial port to an arbitrary bit rate in bits per second.
+         * @param bitRate The bit rate in bits per second.
+         */
+        void SetBitRate(const speed_t bitRate) ;
+
+        /**
+         * @brief Gets the bit rate in bits per second currently used by the serial port.
+         * @return Returns the bit rate in bits per second.
+         */
+        speed_t GetBitRate() const ;
+
         /**
          * @brief Sets the character size for the serial port.
          * @param characterSize The character size to be set.
@@ -238,6 +296,36 @@ namespace LibSerial
          */
         short GetVTime() const ;
 
+        /**
+         * @brief Enables or disables the low latency mode of the serial port driver.
+         * @param lowLatency True to enable low latency mode.
+         */
+        void SetLowLatency(const bool lowLatency) ;
+
+        /**
+         * @brief Determines whether the low latency mode of the serial port driver is enabled.
+         * @return Returns true if ASYNC_LOW_LATENCY is set.
+         */
+        bool IsLowLatency() const ;
+
+        /**
+         * @brief Applies a preset of VMIN, VTIME and driver buffering settings.
+         * @param latencyProfile The profile to be applied.
+         */
+        void SetLatencyProfile(const LatencyProfile& latencyProfile) ;
+
+        /**
+         * @brief Configures the RS-485 mode of the serial port driver.
+         * @param rs485Settings The RS-485 settings to be applied.
+         */
+        void SetRS485Settings(const RS485Settings& rs485Settings) ;
+
+        /**
+         * @brief Gets the RS-485 settings in effect in the serial port driver.
+         * @return Returns the RS-485 settings.
+         */
+        RS485Settings GetRS485Settings() const ;
+
         /**
          * @brief Sets the serial port DTR line status.
          * @param dtrState The state to set the DTR line
@@ -286,6 +374,12 @@ namespace LibSerial
          */
         int GetNumberOfBytesAvailable() ;
 
+        /**
+         * @brief Gets the number of bytes pending transmission.
+         * @return Returns the number of bytes pending transmission.
+         */
+        int GetNumberOfBytesPending() const ;
+
 #ifdef __linux__
         /**
          * @brief Gets a list of available serial ports.
@@ -331,6 +425,45 @@ namespace LibSerial
                   size_t       numberOfBytes = 0,
                   size_t       msTimeout = 0) ;
 
+        /**
+         * @brief Reads the specified number of bytes from the serial port
+         *        into a buffer drawn from BufferPool.
+         * @param dataBuffer The pooled data buffer to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void Read(PooledDataBuffer& dataBuffer,
+                  size_t            numberOfBytes = 0,
+                  size_t            msTimeout = 0) ;
+
+        /**
+         * @brief Reads up to bufferSize bytes from the serial port directly
+         *        into caller owned memory. The method blocks until at least
+         *        one byte is available and then returns everything that has
+         *        arrived, up to bufferSize bytes, without allocating. If no
+         *        data arrives within msTimeout milliseconds, a ReadTimeout
+         *        exception is thrown. If msTimeout is zero, then this method
+         *        will block until data becomes available.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of bytes placed into dataBuffer.
+         */
+        size_t Read(uint8_t* dataBuffer,
+                    size_t   bufferSize,
+                    size_t   msTimeout = 0) ;
+
+        /**
+         * @brief Reads the specified number of bytes from the serial port,
+         *        recording when each chunk of data arrived.
+         * @param timestampedData The data read and the chunk timestamps.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadTimestamped(TimestampedDataBuffer& timestampedData,
+                             size_t                 numberOfBytes = 0,
+                             size_t                 msTimeout = 0) ;
+
         /**
          * @brief Reads a single byte from the serial port.
          *        If no data is available within the specified number
@@ -352,7 +485,7 @@ namespace LibSerial
          *        this method will block until a line terminator is received.
          *        If a line terminator is read, a string will be returned,
          *        however, if the timeout is reached, an exception will be thrown
-         *        and all previously read data will be lost.
+         *        and the data read so far is returned in dataString.
          * @param dataString The data string read from the serial port.
          * @param lineTerminator The line termination character to specify the
          *        end of a line.
@@ -363,6 +496,18 @@ namespace LibSerial
                       char         lineTerminator = '\n',
                       size_t       msTimeout = 0) ;
 
+        /**
+         * @brief Reads a line of characters ending with a multi-character
+         *        line terminator from the serial port.
+         * @param dataString The data string read from the serial port.
+         * @param lineTerminator The sequence of characters that specifies
+         *        the end of a line.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadLine(std::string&       dataString,
+                      const std::string& lineTerminator,
+                      size_t             msTimeout = 0) ;
+
         /**
          * @brief Writes a DataBuffer to the serial port.
          * @param dataBuffer The DataBuffer to write to the serial port.
@@ -375,6 +520,41 @@ namespace LibSerial
          */
         void Write(const std::string& dataString) ;
 
+        /**
+         * @brief Writes a PooledDataBuffer to the serial port.
+         * @param dataBuffer The PooledDataBuffer to be written to the serial port.
+         */
+        void Write(const PooledDataBuffer& dataBuffer) ;
+
+        /**
+         * @brief Writes the specified number of bytes from caller owned
+         *        memory to the serial port.
+         * @param dataBuffer Pointer to the data to write to the serial port.
+         * @param numberOfBytes The number of bytes to write.
+         */
+        void Write(const uint8_t* dataBuffer,
+                   size_t         numberOfBytes) ;
+
+        /**
+         * @brief Writes the contents of several buffers to the serial port,
+         *        in order, using gather writes so that the buffers need not
+         *        first be copied into a single contiguous buffer.
+         * @param buffers Pointer to the first of the buffers to write.
+         * @param numberOfBuffers The number of buffers to write.
+         */
+        void WriteV(const ConstBuffer* buffers,
+                    size_t             numberOfBuffers) ;
+
+        /**
+         * @brief Writes data followed by its checksum.
+         * @param dataBuffer Pointer to the data to write to the serial port.
+         * @param numberOfBytes The number of bytes to write.
+         * @param checksumType The checksum to append.
+         */
+        void WriteWithChecksum(const uint8_t*     dataBuffer,
+                               size_t             numberOfBytes,
+                               const ChecksumType checksumType) ;
+
         /**
          * @brief Writes a single byte to the serial port.
          * @param charBuffer The byte to be written to the serial port.
@@ -419,234 +599,830 @@ namespace LibSerial
          */
         bool GetModemControlLine(int modemLine) ;
 
-    private:
+        /**
+         * @brief Gets the modem input line transition counters.
+         * @return Returns the current modem line counters.
+         */
+        ModemLineCounters GetModemLineCounters() ;
 
         /**
-         * @brief Gets the bit rate for the serial port given the current baud rate setting.
-         * @return Returns the bit rate the serial port is capable of achieving.
+         * @brief Blocks until one of the specified modem input lines changes
+         *        state after this method is called or the timeout expires.
+         * @param modemLineMask The lines to wait for.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the lines of modemLineMask that changed state.
          */
-        int GetBitRate(const BaudRate& baudRate) const ;
+        int WaitForModemLineChange(int    modemLineMask,
+                                   size_t msTimeout) ;
 
         /**
-         * @brief Sets the default Linux specific line discipline modes.
+         * @brief Blocks until one of the specified modem input lines changes
+         *        state or the timeout expires.
+         * @param modemLineMask The lines to wait for.
+         * @param modemLineCounters The counters of the previous wait.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the lines of modemLineMask that changed state.
          */
-        void SetDefaultLinuxSpecificModes() ;
+        int WaitForModemLineChange(int                modemLineMask,
+                                   ModemLineCounters& modemLineCounters,
+                                   size_t             msTimeout) ;
 
         /**
-         * @brief Sets the default serial port input modes.
+         * @brief Starts the background reader thread.
+         * @param ringBufferSize The size of the ring buffer in bytes.
          */
-        void SetDefaultInputModes() ;
+        void StartBackgroundReader(size_t ringBufferSize) ;
 
         /**
-         * @brief Sets the default serial port output modes.
+         * @brief Stops the background reader thread, if running.
          */
-        void SetDefaultOutputModes() ;
+        void StopBackgroundReader() ;
 
         /**
-         * @brief Sets the default serial port control modes.
+         * @brief Determines if the background reader thread is running.
+         * @return Returns true iff the background reader is running.
          */
-        void SetDefaultControlModes() ;
+        bool IsBackgroundReaderRunning() const ;
 
         /**
-         * @brief Sets the default serial port local modes.
+         * @brief Moves data from the ring buffer into caller owned memory.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @return Returns the number of bytes placed into dataBuffer.
          */
-        void SetDefaultLocalModes() ;
+        size_t ReadFromRingBuffer(uint8_t* dataBuffer,
+                                  size_t   bufferSize) ;
 
         /**
-         * The file descriptor corresponding to the serial port.
+         * @brief Gets the number of bytes waiting in the ring buffer.
+         * @return Returns the number of bytes waiting in the ring buffer.
          */
-        int mFileDescriptor = -1 ;
+        size_t GetRingBufferLevel() const ;
 
         /**
-         * The time in microseconds required for a byte of data to arrive at
-         * the serial port.
+         * @brief Gets the number of bytes discarded because the ring buffer
+         *        was full.
+         * @return Returns the number of bytes discarded.
          */
-        int mByteArrivalTimeDelta = 1 ;
+        size_t GetRingBufferOverrunCount() const ;
 
         /**
-         * Serial port settings are saved into this struct immediately after
-         * the port is opened. These settings are restored when the serial port
-         * is closed.
+         * @brief Gets the largest number of bytes held in the ring buffer.
+         * @return Returns the ring buffer high-water mark in bytes.
          */
-        termios mOldPortSettings {} ;
-    } ;
+        size_t GetRingBufferHighWaterMark() const ;
 
-    SerialPort::SerialPort()
-        : mImpl(new Implementation())
-    {
-        /* Empty */
-    }
+        /**
+         * @brief Gets the I/O statistics of the serial port.
+         * @return Returns a snapshot of the statistics.
+         */
+        SerialPortStatistics GetStatistics() const ;
 
-    SerialPort::SerialPort(const std::string&   fileName,
-                           const BaudRate&      baudRate,
-                           const CharacterSize& characterSize,
-                           const FlowControl&   flowControlType,
-                           const Parity&        parityType,
-                           const StopBits&      stopBits)
-        : mImpl(new Implementation(fileName,
-                                   baudRate,
-                                   characterSize,
-                                   flowControlType,
-                                   parityType,
-                                   stopBits))
-    {
-        /* Empty */
-    }
+        /**
+         * @brief Clears the I/O statistics of the serial port.
+         */
+        void ResetStatistics() ;
 
-    SerialPort::SerialPort(SerialPort&& otherSerialPort) : 
-        mImpl(std::move(otherSerialPort.mImpl))
-    {
-        // empty
-    }
+        /**
+         * @brief Enables or disables concurrent mode.
+         * @param concurrentMode True to enable concurrent mode.
+         */
+        void SetConcurrentMode(const bool concurrentMode) ;
 
-    SerialPort& SerialPort::operator=(SerialPort&& otherSerialPort)
-    {
-        mImpl = std::move(otherSerialPort.mImpl);
-        return *this;
-    }
+        /**
+         * @brief Determines whether concurrent mode is enabled.
+         * @return Returns true if concurrent mode is enabled.
+         */
+        bool IsConcurrentMode() const ;
 
-    SerialPort::~SerialPort() noexcept = default ;
+        /**
+         * @brief Wakes the reads blocked waiting for data in concurrent
+         *        mode, which then throw NotOpen, so that Close() can take
+         *        the read lock.
+         */
+        void InterruptBlockedReads() const ;
 
-    void
-    SerialPort::Open(const std::string& fileName,
-                     const std::ios_base::openmode& openMode)
-    {
-        mImpl->Open(fileName,
-                    openMode) ;
-    }
+        /**
+         * @brief Clears a pending InterruptBlockedReads() wakeup.
+         */
+        void ClearBlockedReadsInterrupt() const ;
 
-    void
-    SerialPort::Close()
-    {
-        mImpl->Close() ;
-    }
+        /**
+         * @brief Locks the read side of the serial port in concurrent mode.
+         * @return Returns a lock owning mReadMutex in concurrent mode, or a
+         *         lock owning nothing otherwise.
+         */
+        std::unique_lock<std::mutex> LockReadSide() const ;
 
-    void
-    SerialPort::DrainWriteBuffer()
-    {
-        mImpl->DrainWriteBuffer() ;
-    }
+        /**
+         * @brief Locks the write side of the serial port in concurrent mode.
+         * @return Returns a lock owning mWriteMutex in concurrent mode, or a
+         *         lock owning nothing otherwise.
+         */
+        std::unique_lock<std::mutex> LockWriteSide() const ;
 
-    void
-    SerialPort::FlushInputBuffer()
-    {
-        mImpl->FlushInputBuffer() ;
-    }
+        /**
+         * @brief Locks the serial port settings in concurrent mode.
+         * @return Returns a lock owning mConfigurationMutex in concurrent
+         *         mode, or a lock owning nothing otherwise.
+         */
+        std::unique_lock<std::mutex> LockConfiguration() const ;
 
-    void
-    SerialPort::FlushOutputBuffer()
-    {
-        mImpl->FlushOutputBuffer() ;
-    }
+    private:
 
-    void
-    SerialPort::FlushIOBuffers()
-    {
-        mImpl->FlushIOBuffers() ;
-    }
+        /**
+         * @brief The body of the background reader thread, which is the only
+         *        producer of data in the ring buffer. Blocks in poll() until
+         *        data arrives or the stop event is signaled.
+         */
+        void BackgroundReaderLoop() ;
 
-    bool
-    SerialPort::IsDataAvailable()
-    {
-        return mImpl->IsDataAvailable() ;
-    }
+        /**
+         * @brief Reads the specified number of bytes from the serial port
+         *        into a DataBuffer, a PooledDataBuffer or a std::string. See
+         *        Read() for a description of the behavior of numberOfBytes
+         *        and msTimeout.
+         * @param dataContainer The container to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        template <typename ContainerType>
+        void ReadIntoContainer(ContainerType& dataContainer,
+                               size_t         numberOfBytes,
+                               size_t         msTimeout) ;
 
-    bool
-    SerialPort::IsOpen() const
-    {
-        return mImpl->IsOpen() ;
-    }
+        /**
+         * @brief Blocks in poll() until data is available to be read from
+         *        the serial port or until the specified timeout elapses.
+         * @param msTimeout The maximum time to wait in milliseconds, or -1
+         *        to wait indefinitely.
+         * @return Returns true iff data is available to be read.
+         */
+        bool WaitForDataAvailable(int msTimeout) const ;
 
-    void
-    SerialPort::SetDefaultSerialPortParameters()
-    {
-        mImpl->SetDefaultSerialPortParameters() ;
-    }
+        /**
+         * @brief Gets the time remaining before a read timeout expires in a
+         *        form suitable for passing to WaitForDataAvailable().
+         * @param entryTime The time at which the read operation started.
+         * @param msTimeout The timeout period in milliseconds, or zero if
+         *        the read operation should block indefinitely.
+         * @return Returns -1 if msTimeout is zero, zero if the timeout period
+         *         has elapsed, and the number of milliseconds remaining
+         *         otherwise.
+         */
+        static int GetRemainingTimeout(const std::chrono::steady_clock::time_point& entryTime,
+                                       size_t msTimeout) ;
 
-    void
-    SerialPort::SetBaudRate(const BaudRate& baudRate)
-    {
-        mImpl->SetBaudRate(baudRate) ;
-    }
+        /**
+         * @brief Reads from the serial port in bulk into the read-ahead
+         *        buffer until the specified line terminator is found, then
+         *        returns the line and retains any data following it.
+         * @param dataString The data string read from the serial port.
+         * @param lineTerminator Pointer to the line terminator characters.
+         * @param terminatorSize The number of line terminator characters.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadUntilTerminator(std::string& dataString,
+                                 const char*  lineTerminator,
+                                 size_t       terminatorSize,
+                                 size_t       msTimeout) ;
 
-    BaudRate
-    SerialPort::GetBaudRate() const
-    {
-        return mImpl->GetBaudRate() ;
-    }
+        /**
+         * @brief Finds the first occurrence of a line terminator in a range
+         *        of bytes.
+         * @param begin Pointer to the first byte of the range to search.
+         * @param end Pointer to one past the last byte of the range.
+         * @param lineTerminator Pointer to the line terminator characters.
+         * @param terminatorSize The number of line terminator characters.
+         * @return Returns a pointer to the start of the line terminator, or
+         *         nullptr if the range does not contain the terminator.
+         */
+        static const uint8_t* FindLineTerminator(const uint8_t* begin,
+                                                 const uint8_t* end,
+                                                 const char*    lineTerminator,
+                                                 size_t         terminatorSize) ;
 
-    void
-    SerialPort::SetCharacterSize(const CharacterSize& characterSize)
-    {
-        mImpl->SetCharacterSize(characterSize) ;
-    }
+        /**
+         * @brief Moves data from the read-ahead buffer to caller owned memory.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @return Returns the number of bytes placed into dataBuffer.
+         */
+        size_t ReadFromReadAheadBuffer(void*  dataBuffer,
+                                       size_t bufferSize) ;
 
-    CharacterSize
-    SerialPort::GetCharacterSize() const
-    {
-        return mImpl->GetCharacterSize() ;
-    }
+        /**
+         * @brief Gets the number of unread bytes held in the read-ahead buffer.
+         * @return Returns the number of unread bytes in the read-ahead buffer.
+         */
+        size_t GetNumberOfBytesReadAhead() const ;
 
-    void
-    SerialPort::SetFlowControl(const FlowControl& flowControlType)
-    {
-        mImpl->SetFlowControl(flowControlType) ;
-    }
+        /**
+         * @brief Discards any unread bytes held in the read-ahead buffer.
+         */
+        void DiscardReadAheadBuffer() ;
 
-    FlowControl
-    SerialPort::GetFlowControl() const
-    {
-        return mImpl->GetFlowControl() ;
-    }
+        /**
+         * @brief Gets the path of the sysfs latency_timer attribute of the
+         *        USB serial adapter behind the serial port.
+         * @return Returns the path, which exists only for adapters whose
+         *         driver has a latency timer.
+         */
+        std::string GetLatencyTimerPath() const ;
 
-    void
-    SerialPort::SetParity(const Parity& parityType)
-    {
-        mImpl->SetParity(parityType) ;
-    }
+        /**
+         * @brief Restores the driver flags and latency timer saved by the
+         *        first call to SetLowLatency(). Errors are ignored, as the
+         *        serial port may be being closed after the device was removed.
+         */
+        void RestoreLowLatency() ;
 
-    Parity
-    SerialPort::GetParity() const
-    {
-        return mImpl->GetParity() ;
-    }
+        /**
+         * @brief Restores the RS-485 settings saved by the first call to
+         *        SetRS485Settings(). Errors are ignored for the same reason as
+         *        in RestoreLowLatency().
+         */
+        void RestoreRS485Settings() ;
 
-    void
-    SerialPort::SetStopBits(const StopBits& stopBits)
-    {
-        mImpl->SetStopBits(stopBits) ;
-    }
+        /**
+         * @brief Applies the specified settings to the serial port with a
+         *        single call to tcsetattr() and updates mPortSettings with
+         *        the settings that are then in effect.
+         * @param portSettings The settings to be applied.
+         */
+        void ApplyPortSettings(const termios& portSettings) ;
+
+        /**
+         * @brief Sets all of the serial port parameters in a termios structure.
+         * @param portSettings The termios structure to be modified.
+         * @param serialPortParameters The serial port parameters to be set.
+         */
+        static void UpdatePortSettings(termios&            portSettings,
+                                       const PortSettings& serialPortParameters) ;
+
+        /**
+         * @brief Sets the baud rate in a termios structure.
+         * @param portSettings The termios structure to be modified.
+         * @param baudRate The baud rate to be set.
+         */
+        static void UpdateBaudRate(termios&        portSettings,
+                                   const BaudRate& baudRate) ;
+
+        /**
+         * @brief Sets the character size in a termios structure.
+         * @param portSettings The termios structure to be modified.
+         * @param characterSize The character size to be set.
+         */
+        static void UpdateCharacterSize(termios&             portSettings,
+                                        const CharacterSize& characterSize) ;
+
+        /**
+         * @brief Sets the flow control in a termios structure.
+         * @param portSettings The termios structure to be modified.
+         * @param flowControlType The flow control type to be set.
+         */
+        static void UpdateFlowControl(termios&           portSettings,
+                                      const FlowControl& flowControlType) ;
+
+        /**
+         * @brief Sets the parity type in a termios structure.
+         * @param portSettings The termios structure to be modified.
+         * @param parityType The parity type to be set.
+         */
+        static void UpdateParity(termios&      portSettings,
+                                 const Parity& parityType) ;
+
+        /**
+         * @brief Sets the number of stop bits in a termios structure.
+         * @param portSettings The termios structure to be modified.
+         * @param stopBits The number of stop bits to be set.
+         */
+        static void UpdateStopBits(termios&        portSettings,
+                                   const StopBits& stopBits) ;
+
+        /**
+         * @brief Sets the VMIN value in a termios structure.
+         * @param portSettings The termios structure to be modified.
+         * @param vmin The minimum number of characters for non-canonical reads.
+         */
+        static void UpdateVMin(termios&    portSettings,
+                               const short vmin) ;
+
+        /**
+         * @brief Sets the VTIME value in a termios structure.
+         * @param portSettings The termios structure to be modified.
+         * @param vtime The timeout value in deciseconds for non-canonical reads.
+         */
+        static void UpdateVTime(termios&    portSettings,
+                                const short vtime) ;
+
+        /**
+         * @brief Sets the default Linux specific line discipline modes.
+         * @param portSettings The termios structure to be modified.
+         */
+        static void SetDefaultLinuxSpecificModes(termios& portSettings) ;
+
+        /**
+         * @brief Sets the default serial port input modes.
+         * @param portSettings The termios structure to be modified.
+         */
+        static void SetDefaultInputModes(termios& portSettings) ;
+
+        /**
+         * @brief Sets the default serial port output modes.
+         * @param portSettings The termios structure to be modified.
+         */
+        static void SetDefaultOutputModes(termios& portSettings) ;
+
+        /**
+         * @brief Sets the default serial port control modes.
+         * @param portSettings The termios structure to be modified.
+         */
+        static void SetDefaultControlModes(termios& portSettings) ;
+
+        /**
+         * @brief Sets the default serial port local modes.
+         * @param portSettings The termios structure to be modified.
+         */
+        static void SetDefaultLocalModes(termios& portSettings) ;
+
+        /**
+         * The file descriptor corresponding to the serial port.
+         */
+        int mFileDescriptor = -1 ;
+
+        /**
+         * Serial port settings are saved into this struct immediately after
+         * the port is opened. These settings are restored when the serial port
+         * is closed.
+         */
+        termios mOldPortSettings {} ;
+
+        /**
+         * A copy of the serial port settings currently in effect, from which
+         * the Get...() methods are served without a call to tcgetattr().
+         */
+        termios mPortSettings {} ;
+
+        /**
+         * Data read from the serial port by ReadLine() beyond the end of the
+         * line, which is returned by subsequent read operations.
+         */
+        std::vector<uint8_t> mReadAheadBuffer {} ;
+
+        /**
+         * The index of the first unread byte in mReadAheadBuffer.
+         */
+        size_t mReadAheadOffset = 0 ;
+
+        /**
+         * The time at which the data most recently added to mReadAheadBuffer
+         * was found to have arrived.
+         */
+        std::chrono::steady_clock::time_point mReadAheadTimestamp {} ;
+
+        /**
+         * True once SetLowLatency() has saved the original driver settings
+         * in mOldSerialFlags and mOldLatencyTimer.
+         */
+        bool mLowLatencySaved = false ;
+
+        /**
+         * The serial_struct flags of the driver before SetLowLatency() was
+         * first called.
+         */
+        int mOldSerialFlags = 0 ;
+
+        /**
+         * The latency_timer attribute before SetLowLatency() was first
+         * called, or empty if the adapter has none.
+         */
+        std::string mOldLatencyTimer {} ;
+
+        /**
+         * True once SetRS485Settings() has saved the original driver
+         * settings in mOldRS485Settings.
+         */
+        bool mRS485SettingsSaved = false ;
+
+        /**
+         * The RS-485 settings of the driver before SetRS485Settings() was
+         * first called.
+         */
+        serial_rs485 mOldRS485Settings {} ;
+
+        /**
+         * Counters and latency histograms of the I/O performed on the serial
+         * port, updated only when built with LIBSERIAL_ENABLE_STATISTICS.
+         */
+        mutable IoStatistics mStatistics {} ;
+
+        /**
+         * True if the read side, write side and settings of the serial port
+         * are each protected by their own mutex.
+         */
+        std::atomic<bool> mConcurrentMode {false} ;
+
+        /**
+         * Serializes read operations in concurrent mode.
+         */
+        mutable std::mutex mReadMutex {} ;
+
+        /**
+         * Serializes write operations in concurrent mode.
+         */
+        mutable std::mutex mWriteMutex {} ;
+
+        /**
+         * Serializes changes to and reads of mPortSettings in concurrent mode.
+         */
+        mutable std::mutex mConfigurationMutex {} ;
+
+        /**
+         * The eventfd signalled by Close() in concurrent mode to wake reads
+         * blocked in poll(), or -1 if concurrent mode was never enabled.
+         */
+        int mCloseEventFileDescriptor = -1 ;
+
+        /**
+         * The background reader thread.
+         */
+        std::thread mReaderThread {} ;
+
+        /**
+         * The eventfd used to wake and stop the background reader thread.
+         */
+        int mReaderStopEventFileDescriptor = -1 ;
+
+        /**
+         * The errno value with which the background reader stopped, or zero.
+         */
+        std::atomic<int> mReaderErrorNumber {0} ;
+
+        /**
+         * Set by the background reader thread once it has returned, either
+         * on request or because of an error.
+         */
+        std::atomic<bool> mReaderExited {false} ;
+
+        /**
+         * Storage for the ring buffer, whose size is a power of two.
+         */
+        std::vector<uint8_t> mRingBuffer {} ;
+
+        /**
+         * The total number of bytes written to the ring buffer. Only
+         * modified by the background reader thread.
+         */
+        std::atomic<size_t> mRingBufferHead {0} ;
+
+        /**
+         * Keeps mRingBufferHead and mRingBufferTail on separate cache lines
+         * so that the producer and the consumer do not contend for them.
+         */
+        char mRingBufferPadding[64] {} ; // NOLINT (cppcoreguidelines-avoid-c-arrays)
+
+        /**
+         * The total number of bytes read from the ring buffer. Only
+         * modified by the consumer thread.
+         */
+        std::atomic<size_t> mRingBufferTail {0} ;
+
+        /**
+         * The number of bytes discarded because the ring buffer was full.
+         */
+        std::atomic<size_t> mRingBufferOverrunCount {0} ;
+
+        /**
+         * The largest number of bytes held in the ring buffer.
+         */
+        std::atomic<size_t> mRingBufferHighWaterMark {0} ;
+    } ;
+
+    SerialPort::SerialPort()
+        : mImpl(new Implementation())
+    {
+        /* Empty */
+    }
+
+    SerialPort::SerialPort(const std::string&   fileName,
+                           const BaudRate&      baudRate,
+                           const CharacterSize& characterSize,
+                           const FlowControl&   flowControlType,
+                           const Parity&        parityType,
+                           const StopBits&      stopBits)
+        : mImpl(new Implementation(fileName,
+                                   baudRate,
+                                   characterSize,
+                                   flowControlType,
+                                   parityType,
+                                   stopBits))
+    {
+        /* Empty */
+    }
+
+    SerialPort::SerialPort(SerialPort&& otherSerialPort) : 
+        mImpl(std::move(otherSerialPort.mImpl))
+    {
+        // empty
+    }
+
+    SerialPort& SerialPort::operator=(SerialPort&& otherSerialPort)
+    {
+        mImpl = std::move(otherSerialPort.mImpl);
+        return *this;
+    }
+
+    SerialPort::~SerialPort() noexcept = default ;
+
+    void
+    SerialPort::Open(const std::string& fileName,
+                     const std::ios_base::openmode& openMode)
+    {
+        const auto read_lock = mImpl->LockReadSide() ;
+        const auto write_lock = mImpl->LockWriteSide() ;
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->Open(fileName,
+                    openMode,
+                    PortSettings {}) ;
+    }
+
+    void
+    SerialPort::Open(const std::string& fileName,
+                     const PortSettings& portSettings,
+                     const std::ios_base::openmode& openMode)
+    {
+        const auto read_lock = mImpl->LockReadSide() ;
+        const auto write_lock = mImpl->LockWriteSide() ;
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->Open(fileName,
+                    openMode,
+                    portSettings) ;
+    }
+
+    void
+    SerialPort::Close()
+    {
+        // A read waiting indefinitely for data would otherwise hold the read
+        // lock forever.
+        mImpl->InterruptBlockedReads() ;
+
+        const auto read_lock = mImpl->LockReadSide() ;
+        const auto write_lock = mImpl->LockWriteSide() ;
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->Close() ;
+    }
+
+    void
+    SerialPort::DrainWriteBuffer()
+    {
+        const auto write_lock = mImpl->LockWriteSide() ;
+
+        mImpl->DrainWriteBuffer() ;
+    }
+
+    bool
+    SerialPort::DrainWriteBuffer(const size_t msTimeout)
+    {
+        const auto write_lock = mImpl->LockWriteSide() ;
+
+        return mImpl->DrainWriteBuffer(msTimeout) ;
+    }
+
+    void
+    SerialPort::FlushInputBuffer()
+    {
+        const auto read_lock = mImpl->LockReadSide() ;
+
+        mImpl->FlushInputBuffer() ;
+    }
+
+    void
+    SerialPort::FlushOutputBuffer()
+    {
+        const auto write_lock = mImpl->LockWriteSide() ;
+
+        mImpl->FlushOutputBuffer() ;
+    }
+
+    void
+    SerialPort::FlushIOBuffers()
+    {
+        const auto read_lock = mImpl->LockReadSide() ;
+        const auto write_lock = mImpl->LockWriteSide() ;
+
+        mImpl->FlushIOBuffers() ;
+    }
+
+    bool
+    SerialPort::IsDataAvailable()
+    {
+        const auto read_lock = mImpl->LockReadSide() ;
+
+        return mImpl->IsDataAvailable() ;
+    }
+
+    bool
+    SerialPort::IsOpen() const
+    {
+        return mImpl->IsOpen() ;
+    }
+
+    void
+    SerialPort::SetDefaultSerialPortParameters()
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->SetDefaultSerialPortParameters() ;
+    }
+
+    void
+    SerialPort::SetSerialPortParameters(const PortSettings& portSettings)
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->SetSerialPortParameters(portSettings) ;
+    }
+
+    PortSettings
+    SerialPort::GetSerialPortParameters() const
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        return mImpl->GetSerialPortParameters() ;
+    }
+
+    void
+    SerialPort::SetBaudRate(const BaudRate& baudRate)
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->SetBaudRate(baudRate) ;
+    }
+
+    BaudRate
+    SerialPort::GetBaudRate() const
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        return mImpl->GetBaudRate() ;
+    }
+
+    void
+    SerialPort::SetBitRate(const speed_t bitRate)
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->SetBitRate(bitRate) ;
+    }
+
+    speed_t
+    SerialPort::GetBitRate() const
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        return mImpl->GetBitRate() ;
+    }
+
+    void
+    SerialPort::SetCharacterSize(const CharacterSize& characterSize)
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->SetCharacterSize(characterSize) ;
+    }
+
+    CharacterSize
+    SerialPort::GetCharacterSize() const
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        return mImpl->GetCharacterSize() ;
+    }
+
+    void
+    SerialPort::SetFlowControl(const FlowControl& flowControlType)
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->SetFlowControl(flowControlType) ;
+    }
+
+    FlowControl
+    SerialPort::GetFlowControl() const
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        return mImpl->GetFlowControl() ;
+    }
+
+    void
+    SerialPort::SetParity(const Parity& parityType)
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->SetParity(parityType) ;
+    }
+
+    Parity
+    SerialPort::GetParity() const
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        return mImpl->GetParity() ;
+    }
+
+    void
+    SerialPort::SetStopBits(const StopBits& stopBits)
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->SetStopBits(stopBits) ;
+    }
 
     StopBits
     SerialPort::GetStopBits() const
     {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
         return mImpl->GetStopBits() ;
     }
 
     void
     SerialPort::SetVMin(const short vmin)
     {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
         mImpl->SetVMin(vmin) ;
     }
 
     short
     SerialPort::GetVMin() const
     {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
         return mImpl->GetVMin() ;
     }
 
     void
     SerialPort::SetVTime(const short vtime)
     {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
         mImpl->SetVTime(vtime) ;
     }
 
     short
     SerialPort::GetVTime() const
     {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
         return mImpl->GetVTime() ;
     }
 
+    void
+    SerialPort::SetLowLatency(const bool lowLatency)
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->SetLowLatency(lowLatency) ;
+    }
+
+    bool
+    SerialPort::IsLowLatency() const
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        return mImpl->IsLowLatency() ;
+    }
+
+    void
+    SerialPort::SetLatencyProfile(const LatencyProfile& latencyProfile)
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->SetLatencyProfile(latencyProfile) ;
+    }
+
+    void
+    SerialPort::SetRS485Settings(const RS485Settings& rs485Settings)
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->SetRS485Settings(rs485Settings) ;
+    }
+
+    RS485Settings
+    SerialPort::GetRS485Settings() const
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        return mImpl->GetRS485Settings() ;
+    }
+
     void
     SerialPort::SetDTR(const bool dtrState)
     {
@@ -692,9 +1468,17 @@ namespace LibSerial
     int
     SerialPort::GetNumberOfBytesAvailable()
     {
+        const auto read_lock = mImpl->LockReadSide() ;
+
         return mImpl->GetNumberOfBytesAvailable() ;
     }
 
+    int
+    SerialPort::GetNumberOfBytesPending() const
+    {
+        return mImpl->GetNumberOfBytesPending() ;
+    }
+
 #ifdef __linux__
     std::vector<std::string>
     SerialPort::GetAvailableSerialPorts() const
@@ -708,6 +1492,8 @@ namespace LibSerial
                      const size_t numberOfBytes,
                      const size_t msTimeout)
     {
+        const auto read_lock = mImpl->LockReadSide() ;
+
         mImpl->Read(dataBuffer,
                     numberOfBytes,
                     msTimeout) ;
@@ -718,15 +1504,55 @@ namespace LibSerial
                      const size_t numberOfBytes,
                      const size_t msTimeout)
     {
+        const auto read_lock = mImpl->LockReadSide() ;
+
         mImpl->Read(dataString,
                     numberOfBytes,
                     msTimeout) ;
     }
 
+    void
+    SerialPort::Read(PooledDataBuffer& dataBuffer,
+                     const size_t      numberOfBytes,
+                     const size_t      msTimeout)
+    {
+        const auto read_lock = mImpl->LockReadSide() ;
+
+        mImpl->Read(dataBuffer,
+                    numberOfBytes,
+                    msTimeout) ;
+    }
+
+    size_t
+    SerialPort::Read(uint8_t* const dataBuffer,
+                     const size_t   bufferSize,
+                     const size_t   msTimeout)
+    {
+        const auto read_lock = mImpl->LockReadSide() ;
+
+        return mImpl->Read(dataBuffer,
+                           bufferSize,
+                           msTimeout) ;
+    }
+
+    void
+    SerialPort::ReadTimestamped(TimestampedDataBuffer& timestampedData,
+                                const size_t           numberOfBytes,
+                                const size_t           msTimeout)
+    {
+        const auto read_lock = mImpl->LockReadSide() ;
+
+        mImpl->ReadTimestamped(timestampedData,
+                               numberOfBytes,
+                               msTimeout) ;
+    }
+
     void
     SerialPort::ReadByte(char&        charBuffer,
                          const size_t msTimeout)
     {
+        const auto read_lock = mImpl->LockReadSide() ;
+
         mImpl->ReadByte(charBuffer,
                         msTimeout) ;
     }
@@ -735,6 +1561,8 @@ namespace LibSerial
     SerialPort::ReadByte(unsigned char& charBuffer,
                          const size_t   msTimeout)
     {
+        const auto read_lock = mImpl->LockReadSide() ;
+
         mImpl->ReadByte(charBuffer,
                         msTimeout) ;
     }
@@ -744,6 +1572,20 @@ namespace LibSerial
                          const char   lineTerminator,
                          const size_t msTimeout)
     {
+        const auto read_lock = mImpl->LockReadSide() ;
+
+        mImpl->ReadLine(dataString,
+                        lineTerminator,
+                        msTimeout) ;
+    }
+
+    void
+    SerialPort::ReadLine(std::string&       dataString,
+                         const std::string& lineTerminator,
+                         const size_t       msTimeout)
+    {
+        const auto read_lock = mImpl->LockReadSide() ;
+
         mImpl->ReadLine(dataString,
                         lineTerminator,
                         msTimeout) ;
@@ -752,50 +1594,226 @@ namespace LibSerial
     void
     SerialPort::Write(const DataBuffer& dataBuffer)
     {
+        const auto write_lock = mImpl->LockWriteSide() ;
+
         mImpl->Write(dataBuffer) ;
     }
 
     void
     SerialPort::Write(const std::string& dataString)
     {
+        const auto write_lock = mImpl->LockWriteSide() ;
+
         mImpl->Write(dataString) ;
     }
 
+    void
+    SerialPort::Write(const PooledDataBuffer& dataBuffer)
+    {
+        const auto write_lock = mImpl->LockWriteSide() ;
+
+        mImpl->Write(dataBuffer) ;
+    }
+
+    void
+    SerialPort::Write(const uint8_t* const dataBuffer,
+                      const size_t         numberOfBytes)
+    {
+        const auto write_lock = mImpl->LockWriteSide() ;
+
+        mImpl->Write(dataBuffer,
+                     numberOfBytes) ;
+    }
+
+    void
+    SerialPort::WriteV(const ConstBuffer* const buffers,
+                       const size_t             numberOfBuffers)
+    {
+        const auto write_lock = mImpl->LockWriteSide() ;
+
+        mImpl->WriteV(buffers,
+                      numberOfBuffers) ;
+    }
+
+    void
+    SerialPort::WriteV(const std::initializer_list<ConstBuffer> buffers)
+    {
+        const auto write_lock = mImpl->LockWriteSide() ;
+
+        mImpl->WriteV(buffers.begin(),
+                      buffers.size()) ;
+    }
+
+    void
+    SerialPort::WriteWithChecksum(const DataBuffer&  dataBuffer,
+                                  const ChecksumType checksumType)
+    {
+        const auto write_lock = mImpl->LockWriteSide() ;
+
+        mImpl->WriteWithChecksum(dataBuffer.data(),
+                                 dataBuffer.size(),
+                                 checksumType) ;
+    }
+
+    void
+    SerialPort::WriteWithChecksum(const uint8_t* const dataBuffer,
+                                  const size_t         numberOfBytes,
+                                  const ChecksumType   checksumType)
+    {
+        const auto write_lock = mImpl->LockWriteSide() ;
+
+        mImpl->WriteWithChecksum(dataBuffer,
+                                 numberOfBytes,
+                                 checksumType) ;
+    }
+
     void
     SerialPort::WriteByte(const char charBuffer)
     {
+        const auto write_lock = mImpl->LockWriteSide() ;
+
         mImpl->WriteByte(charBuffer) ;
     }
 
     void
     SerialPort::WriteByte(const unsigned char charBuffer)
     {
-        mImpl->WriteByte(charBuffer) ;
+        const auto write_lock = mImpl->LockWriteSide() ;
+
+        mImpl->WriteByte(charBuffer) ;
+    }
+
+    void
+    SerialPort::SetSerialPortBlockingStatus(const bool blockingStatus)
+    {
+        const auto read_lock = mImpl->LockReadSide() ;
+        const auto write_lock = mImpl->LockWriteSide() ;
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->SetSerialPortBlockingStatus(blockingStatus) ;
+    }
+
+    bool
+    SerialPort::GetSerialPortBlockingStatus() const
+    {
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        return mImpl->GetSerialPortBlockingStatus() ;
+    }
+
+    void
+    SerialPort::SetModemControlLine(const int modemLine,
+                                    const bool lineState)
+    {
+        mImpl->SetModemControlLine(modemLine, lineState) ;
+    }
+
+    bool
+    SerialPort::GetModemControlLine(const int modemLine)
+    {
+        return mImpl->GetModemControlLine(modemLine) ;
+    }
+
+    ModemLineCounters
+    SerialPort::GetModemLineCounters()
+    {
+        return mImpl->GetModemLineCounters() ;
+    }
+
+    int
+    SerialPort::WaitForModemLineChange(const int    modemLineMask,
+                                       const size_t msTimeout)
+    {
+        return mImpl->WaitForModemLineChange(modemLineMask,
+                                             msTimeout) ;
+    }
+
+    int
+    SerialPort::WaitForModemLineChange(const int          modemLineMask,
+                                       ModemLineCounters& modemLineCounters,
+                                       const size_t       msTimeout)
+    {
+        return mImpl->WaitForModemLineChange(modemLineMask,
+                                             modemLineCounters,
+                                             msTimeout) ;
+    }
+
+    void
+    SerialPort::StartBackgroundReader(const size_t ringBufferSize)
+    {
+        const auto read_lock = mImpl->LockReadSide() ;
+        const auto write_lock = mImpl->LockWriteSide() ;
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->StartBackgroundReader(ringBufferSize) ;
+    }
+
+    void
+    SerialPort::StopBackgroundReader()
+    {
+        const auto read_lock = mImpl->LockReadSide() ;
+        const auto write_lock = mImpl->LockWriteSide() ;
+        const auto configuration_lock = mImpl->LockConfiguration() ;
+
+        mImpl->StopBackgroundReader() ;
+    }
+
+    bool
+    SerialPort::IsBackgroundReaderRunning() const
+    {
+        return mImpl->IsBackgroundReaderRunning() ;
+    }
+
+    size_t
+    SerialPort::ReadFromRingBuffer(uint8_t* const dataBuffer,
+                                   const size_t   bufferSize)
+    {
+        const auto read_lock = mImpl->LockReadSide() ;
+
+        return mImpl->ReadFromRingBuffer(dataBuffer,
+                                         bufferSize) ;
+    }
+
+    size_t
+    SerialPort::GetRingBufferLevel() const
+    {
+        return mImpl->GetRingBufferLevel() ;
+    }
+
+    size_t
+    SerialPort::GetRingBufferOverrunCount() const
+    {
+        return mImpl->GetRingBufferOverrunCount() ;
+    }
+
+    size_t
+    SerialPort::GetRingBufferHighWaterMark() const
+    {
+        return mImpl->GetRingBufferHighWaterMark() ;
     }
 
-    void
-    SerialPort::SetSerialPortBlockingStatus(const bool blockingStatus)
+    SerialPortStatistics
+    SerialPort::GetStatistics() const
     {
-        mImpl->SetSerialPortBlockingStatus(blockingStatus) ;
+        return mImpl->GetStatistics() ;
     }
 
-    bool
-    SerialPort::GetSerialPortBlockingStatus() const
+    void
+    SerialPort::ResetStatistics()
     {
-        return mImpl->GetSerialPortBlockingStatus() ;
+        mImpl->ResetStatistics() ;
     }
 
     void
-    SerialPort::SetModemControlLine(const int modemLine,
-                                    const bool lineState)
+    SerialPort::SetConcurrentMode(const bool concurrentMode)
     {
-        mImpl->SetModemControlLine(modemLine, lineState) ;
+        mImpl->SetConcurrentMode(concurrentMode) ;
     }
 
     bool
-    SerialPort::GetModemControlLine(const int modemLine)
+    SerialPort::IsConcurrentMode() const
     {
-        return mImpl->GetModemControlLine(modemLine) ;
+        return mImpl->IsConcurrentMode() ;
     }
 
     /** -------------------------- Implementation -------------------------- */
@@ -808,12 +1826,17 @@ namespace LibSerial
                                                const Parity&        parityType,
                                                const StopBits&      stopBits)
     {
-        this->Open(fileName, std::ios_base::in | std::ios_base::out) ;
-        this->SetBaudRate(baudRate) ;
-        this->SetCharacterSize(characterSize) ;
-        this->SetFlowControl(flowControlType) ;
-        this->SetParity(parityType) ;
-        this->SetStopBits(stopBits) ;
+        PortSettings port_settings ;
+
+        port_settings.baudRate      = baudRate ;
+        port_settings.characterSize = characterSize ;
+        port_settings.flowControl   = flowControlType ;
+        port_settings.parity        = parityType ;
+        port_settings.stopBits      = stopBits ;
+
+        this->Open(fileName,
+                   std::ios_base::in | std::ios_base::out,
+                   port_settings) ;
     }
 
     inline
@@ -825,6 +1848,11 @@ namespace LibSerial
         {
             this->Close() ;
         }
+
+        if (mCloseEventFileDescriptor >= 0)
+        {
+            call_with_retry(close, mCloseEventFileDescriptor) ;
+        }
     }
     catch(...)
     {
@@ -840,7 +1868,8 @@ namespace LibSerial
     inline
     void
     SerialPort::Implementation::Open(const std::string& fileName,
-                                     const std::ios_base::openmode& openMode)
+                                     const std::ios_base::openmode& openMode,
+                                     const PortSettings& portSettings)
     {
         // Throw an exception if the port is already open.
         if (this->IsOpen())
@@ -848,6 +1877,8 @@ namespace LibSerial
             throw AlreadyOpen(ERR_MSG_PORT_ALREADY_OPEN) ;
         }
 
+        this->ClearBlockedReadsInterrupt() ;
+
         // We only allow three different combinations of ios_base::openmode so
         // we can use a switch here to construct the flags to be used with the
         // open() system call.  Since we are dealing with the serial port we
@@ -880,34 +1911,50 @@ namespace LibSerial
             throw OpenFailed(std::strerror(errno)) ;
         }
 
-        // Set the serial port to exclusive access to this process.
-        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
-        if (call_with_retry(ioctl,
-                            this->mFileDescriptor,
-                            TIOCEXCL) == -1)
+        try
         {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+            // Set the serial port to exclusive access to this process.
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+            if (call_with_retry(ioctl,
+                                this->mFileDescriptor,
+                                TIOCEXCL) == -1)
+            {
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
 
-        // Save the current settings of the serial port so they can be
-        // restored when the serial port is closed.
-        if (tcgetattr(this->mFileDescriptor,
-                      &mOldPortSettings) < 0)
-        {
-            throw OpenFailed(std::strerror(errno)) ;
-        }
+            // Save the current settings of the serial port so they can be
+            // restored when the serial port is closed.
+            if (tcgetattr(this->mFileDescriptor,
+                          &mOldPortSettings) < 0)
+            {
+                throw OpenFailed(std::strerror(errno)) ;
+            }
 
-        // Set up the default configuration for the serial port.
-        this->SetDefaultSerialPortParameters() ;
+            mPortSettings = mOldPortSettings ;
 
-        // Flush the input and output buffers associated with the port.
-        this->FlushIOBuffers() ;
+            // Set up the default configuration for the serial port along
+            // with the requested parameters.
+            this->SetDefaultSerialPortParameters(portSettings) ;
+
+            // Flush the input and output buffers associated with the port.
+            this->FlushIOBuffers() ;
+        }
+        catch (...)
+        {
+            // Do not leave a half configured port open.
+            call_with_retry(close, this->mFileDescriptor) ;
+            mFileDescriptor = -1 ;
+            throw ;
+        }
     }
 
     inline
     void
     SerialPort::Implementation::Close()
     {
+        // The read lock is held, so no read is left to be woken.
+        this->ClearBlockedReadsInterrupt() ;
+
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
         {
@@ -924,6 +1971,16 @@ namespace LibSerial
         // we should still close the serial port file descriptor. Otherwise,
         // the user has no way to cleanly recover from this state.
         //
+        this->DiscardReadAheadBuffer() ;
+        this->RestoreLowLatency() ;
+        this->RestoreRS485Settings() ;
+
+        // The background reader must not use the file descriptor once it
+        // has been closed. Data left in the ring buffer is discarded.
+        this->StopBackgroundReader() ;
+        mRingBufferHead = 0 ;
+        mRingBufferTail = 0 ;
+
         std::string err_msg {} ;
         if (tcsetattr(this->mFileDescriptor,
                       TCSANOW,
@@ -970,6 +2027,84 @@ namespace LibSerial
         }
     }
 
+    inline
+    bool
+    SerialPort::Implementation::DrainWriteBuffer(const size_t msTimeout)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        if (msTimeout == 0)
+        {
+            this->DrainWriteBuffer() ;
+            return true ;
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(msTimeout) ;
+
+        for (auto number_of_bytes_pending = this->GetNumberOfBytesPending();
+             number_of_bytes_pending > 0;
+             number_of_bytes_pending = this->GetNumberOfBytesPending())
+        {
+            const auto current_time = std::chrono::steady_clock::now() ;
+
+            if (current_time >= deadline)
+            {
+                return false ;
+            }
+
+            // Sleep for as long as the queued bytes take to transmit, which
+            // wakes up about when the queue is expected to be empty.
+            const auto transmit_time = std::chrono::milliseconds(
+                GetTransmitTime(this->mFileDescriptor,
+                                static_cast<size_t>(number_of_bytes_pending))) ;
+
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(transmit_time,
+                                                                                     deadline - current_time)) ;
+        }
+
+        // Wait for the characters already in the transmit FIFO of the UART,
+        // which TIOCOUTQ does not always count, without the unbounded wait
+        // of tcdrain().
+        while (true)
+        {
+            bool is_transmitter_empty = false ;
+
+            if (GetTransmitterEmpty(this->mFileDescriptor,
+                                    is_transmitter_empty) < 0)
+            {
+                // Without TIOCSERGETLSR the empty queue is all there is to go by.
+                if ((errno == ENOTTY) or
+                    (errno == EINVAL))
+                {
+                    return true ;
+                }
+
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            if (is_transmitter_empty)
+            {
+                return true ;
+            }
+
+            const auto current_time = std::chrono::steady_clock::now() ;
+
+            if (current_time >= deadline)
+            {
+                return false ;
+            }
+
+            const auto transmit_time = std::chrono::milliseconds(GetTransmitTime(this->mFileDescriptor, 1)) ;
+
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(transmit_time,
+                                                                                     deadline - current_time)) ;
+        }
+    }
+
     inline
     void
     SerialPort::Implementation::FlushInputBuffer()
@@ -980,6 +2115,8 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
+        this->DiscardReadAheadBuffer() ;
+
         if (tcflush(this->mFileDescriptor, TCIFLUSH) < 0)
         {
             throw std::runtime_error(std::strerror(errno)) ;
@@ -1012,6 +2149,8 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
+        this->DiscardReadAheadBuffer() ;
+
         if (tcflush(this->mFileDescriptor, TCIOFLUSH) < 0)
         {
             throw std::runtime_error(std::strerror(errno)) ;
@@ -1035,6 +2174,11 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
+        if (this->GetNumberOfBytesReadAhead() > 0)
+        {
+            return true ;
+        }
+
         int number_of_bytes_available = 0 ;
         bool is_data_available = false ;
 
@@ -1056,6 +2200,13 @@ namespace LibSerial
     inline
     void
     SerialPort::Implementation::SetDefaultSerialPortParameters()
+    {
+        this->SetDefaultSerialPortParameters(PortSettings {}) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::SetDefaultSerialPortParameters(const PortSettings& portSettings)
     {
         // Make sure that the serial port is open.
         if (not this->IsOpen())
@@ -1063,27 +2214,35 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
+        // Modify a copy of the current serial port settings.
+        auto port_settings = mPortSettings ;
+
         #ifdef __linux__
-            SetDefaultLinuxSpecificModes() ;
+            SetDefaultLinuxSpecificModes(port_settings) ;
         #endif
 
-        SetDefaultInputModes() ;
-        SetDefaultOutputModes() ;
-        SetDefaultControlModes() ;
-        SetDefaultLocalModes() ;
+        SetDefaultInputModes(port_settings) ;
+        SetDefaultOutputModes(port_settings) ;
+        SetDefaultControlModes(port_settings) ;
+        SetDefaultLocalModes(port_settings) ;
+
+        UpdatePortSettings(port_settings, portSettings) ;
 
-        SetBaudRate(BaudRate::BAUD_DEFAULT) ;
-        SetCharacterSize(CharacterSize::CHAR_SIZE_DEFAULT) ;
-        SetFlowControl(FlowControl::FLOW_CONTROL_DEFAULT) ;
-        SetParity(Parity::PARITY_DEFAULT) ;
-        SetStopBits(StopBits::STOP_BITS_DEFAULT) ;
-        SetVMin(VMIN_DEFAULT) ;
-        SetVTime(VTIME_DEFAULT) ;
+        // Flush the input and output buffers associated with the port, as
+        // is done whenever the flow control is set.
+        if (tcflush(this->mFileDescriptor,
+                    TCIOFLUSH) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        // Apply the default modes and all of the parameters at once.
+        this->ApplyPortSettings(port_settings) ;
     }
 
     inline
     void
-    SerialPort::Implementation::SetBaudRate(const BaudRate& baudRate)
+    SerialPort::Implementation::SetSerialPortParameters(const PortSettings& portSettings)
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -1091,39 +2250,44 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        // Modify a copy of the current serial port settings. The serial port
+        // is left unchanged if any of the parameters are invalid.
+        auto port_settings = mPortSettings ;
+        UpdatePortSettings(port_settings, portSettings) ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        // Flush the input and output buffers associated with the port if
+        // the flow control changes, as SetFlowControl() does.
+        if ((portSettings.flowControl != this->GetFlowControl()) and
+            (tcflush(this->mFileDescriptor,
+                     TCIOFLUSH) < 0))
         {
             throw std::runtime_error(std::strerror(errno)) ;
         }
 
-        // Set the baud rate for both input and output.
-        if (0 != cfsetspeed(&port_settings, static_cast<speed_t>(baudRate)))
-        {
-            // If applying the baud rate settings fail, throw an exception.
-            throw std::runtime_error(ERR_MSG_INVALID_BAUD_RATE) ;
-        }
+        // Apply all of the settings at once.
+        this->ApplyPortSettings(port_settings) ;
+    }
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
-        {
-            // If applying the settings fails, throw an exception.
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+    inline
+    PortSettings
+    SerialPort::Implementation::GetSerialPortParameters() const
+    {
+        PortSettings port_settings ;
 
-        // Set the time interval value (us) required for one byte of data to arrive.
-        mByteArrivalTimeDelta = (BITS_PER_BYTE * MICROSECONDS_PER_SEC) / GetBitRate(baudRate) ;
+        port_settings.baudRate      = this->GetBaudRate() ;
+        port_settings.characterSize = this->GetCharacterSize() ;
+        port_settings.flowControl   = this->GetFlowControl() ;
+        port_settings.parity        = this->GetParity() ;
+        port_settings.stopBits      = this->GetStopBits() ;
+        port_settings.vmin          = this->GetVMin() ;
+        port_settings.vtime         = this->GetVTime() ;
+
+        return port_settings ;
     }
 
     inline
-    BaudRate
-    SerialPort::Implementation::GetBaudRate() const
+    void
+    SerialPort::Implementation::SetBaudRate(const BaudRate& baudRate)
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -1131,19 +2295,24 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        auto port_settings = mPortSettings ;
+        UpdateBaudRate(port_settings, baudRate) ;
+        this->ApplyPortSettings(port_settings) ;
+    }
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+    inline
+    BaudRate
+    SerialPort::Implementation::GetBaudRate() const
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
         // Read the input and output baud rates.
-        const auto input_baud = cfgetispeed(&port_settings) ;
-        const auto output_baud = cfgetospeed(&port_settings) ;
+        const auto input_baud = cfgetispeed(&mPortSettings) ;
+        const auto output_baud = cfgetospeed(&mPortSettings) ;
 
         // Make sure that the input and output baud rates are
         // equal. Otherwise, we do not know which one to return.
@@ -1153,153 +2322,19 @@ namespace LibSerial
             // return BaudRate::BAUD_INVALID ;
         }
 
-        // Obtain the input baud rate from the current settings.
-        return BaudRate(input_baud) ;
-    }
-
-    inline
-    int
-    SerialPort::Implementation::GetBitRate(const BaudRate& baudRate) const
-    {
-        int baud_rate_as_int = 1 ;
-
-        switch (baudRate)
+        // A bit rate set with SetBitRate() has no BaudRate value.
+        if (input_baud == TERMIOS2_CUSTOM_SPEED)
         {
-        case BaudRate::BAUD_50:
-            baud_rate_as_int = 50 ;
-            break ;
-
-        case BaudRate::BAUD_75:
-            baud_rate_as_int = 75 ;
-            break ;
-
-        case BaudRate::BAUD_110:
-            baud_rate_as_int = 110 ;
-            break ;
-
-        case BaudRate::BAUD_134:
-            baud_rate_as_int = 134 ;
-            break ;
-
-        case BaudRate::BAUD_150:
-            baud_rate_as_int = 150 ;
-            break ;
-
-        case BaudRate::BAUD_200:
-            baud_rate_as_int = 200 ;
-            break ;
-
-        case BaudRate::BAUD_300:
-            baud_rate_as_int = 300 ;
-            break ;
-
-        case BaudRate::BAUD_600:
-            baud_rate_as_int = 600 ;
-            break ;
-
-        case BaudRate::BAUD_1200:
-            baud_rate_as_int = 1200 ;
-            break ;
-
-        case BaudRate::BAUD_1800:
-            baud_rate_as_int = 1800 ;
-            break ;
-
-        case BaudRate::BAUD_2400:
-            baud_rate_as_int = 2400 ;
-            break ;
-
-        case BaudRate::BAUD_4800:
-            baud_rate_as_int = 4800 ;
-            break ;
-
-        case BaudRate::BAUD_9600:
-            baud_rate_as_int = 9600 ;
-            break ;
-
-        case BaudRate::BAUD_19200:
-            baud_rate_as_int = 19200 ;
-            break ;
-
-        case BaudRate::BAUD_38400:
-            baud_rate_as_int = 38400 ;
-            break ;
-
-        case BaudRate::BAUD_57600:
-            baud_rate_as_int = 57600 ;
-            break ;
-
-        case BaudRate::BAUD_115200:
-            baud_rate_as_int = 115200 ;
-            break ;
-
-        case BaudRate::BAUD_230400:
-            baud_rate_as_int = 230400 ;
-            break ;
-
-// @note: >B230400 are defined in Linux but not other POSIX systems, (e.g. Mac OS X).
-#ifdef __linux__
-        case BaudRate::BAUD_460800:
-            baud_rate_as_int = 460800 ;
-            break ;
-
-        case BaudRate::BAUD_500000:
-            baud_rate_as_int = 500000 ;
-            break ;
-
-        case BaudRate::BAUD_576000:
-            baud_rate_as_int = 576000 ;
-            break ;
-
-        case BaudRate::BAUD_921600:
-            baud_rate_as_int = 921600 ;
-            break ;
-
-        case BaudRate::BAUD_1000000:
-            baud_rate_as_int = 1000000 ;
-            break ;
-
-        case BaudRate::BAUD_1152000:
-            baud_rate_as_int = 1152000 ;
-            break ;
-
-        case BaudRate::BAUD_1500000:
-            baud_rate_as_int = 1500000 ;
-            break ;
-
-#if __MAX_BAUD > B2000000
-        case BaudRate::BAUD_2000000:
-            baud_rate_as_int = 2000000 ;
-            break ;
-
-        case BaudRate::BAUD_2500000:
-            baud_rate_as_int = 2500000 ;
-            break ;
-
-        case BaudRate::BAUD_3000000:
-            baud_rate_as_int = 3000000 ;
-            break ;
-
-        case BaudRate::BAUD_3500000:
-            baud_rate_as_int = 3500000 ;
-            break ;
-
-        case BaudRate::BAUD_4000000:
-            baud_rate_as_int = 4000000 ;
-            break ;
-#endif // __MAX_BAUD
-#endif // __linux__
-        default:
-            // If an incorrect baud rate was specified, throw an exception.
-            throw std::runtime_error(ERR_MSG_INVALID_BAUD_RATE) ;
+            return BaudRate::BAUD_INVALID ;
         }
 
-        return baud_rate_as_int ;
+        // Obtain the input baud rate from the current settings.
+        return BaudRate(input_baud) ;
     }
 
     inline
     void
-    SerialPort::Implementation::SetCharacterSize(const CharacterSize& characterSize)
+    SerialPort::Implementation::SetBitRate(const speed_t bitRate)
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -1307,51 +2342,29 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        if (bitRate == 0)
         {
-            throw std::runtime_error(ERR_MSG_INVALID_CHARACTER_SIZE) ;
+            throw std::invalid_argument(ERR_MSG_INVALID_BIT_RATE) ;
         }
 
-        // Set the character size to the specified value. If the character
-        // size is not 8 then it is also important to set ISTRIP. Setting
-        // ISTRIP causes all but the 7 low-order bits to be set to
-        // zero. Otherwise they are set to unspecified values and may
-        // cause problems. At the same time, we should clear the ISTRIP
-        // flag when the character size is 8 otherwise the MSB will always
-        // be set to zero (ISTRIP does not check the character size
-        // setting;it just sets every bit above the low 7 bits to zero).
-        if (characterSize == CharacterSize::CHAR_SIZE_8)
-        {
-            // NOLINTNEXTLINE (hicpp-signed-bitwise)
-            port_settings.c_iflag &= ~ISTRIP ;  // Clear the ISTRIP flag.
-        }
-        else
+        if (SetTermios2BitRate(this->mFileDescriptor, bitRate) < 0)
         {
-            port_settings.c_iflag |= ISTRIP ;   // Set the ISTRIP flag.
+            throw std::runtime_error(std::strerror(errno)) ;
         }
 
-        // Set the character size.
-        // NOLINTNEXTLINE (hicpp-signed-bitwise)
-        port_settings.c_cflag &= ~CSIZE ;                               // Clear all CSIZE bits.
-        port_settings.c_cflag |= static_cast<tcflag_t>(characterSize) ; // Set the character size.
-
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+        // Refresh the cached settings, whose c_cflag now selects the custom
+        // bit rate. The kernel keeps the rate when other settings are later
+        // applied with tcsetattr().
+        if (tcgetattr(this->mFileDescriptor,
+                      &mPortSettings) < 0)
         {
             throw std::runtime_error(std::strerror(errno)) ;
         }
     }
 
     inline
-    CharacterSize
-    SerialPort::Implementation::GetCharacterSize() const
+    speed_t
+    SerialPort::Implementation::GetBitRate() const
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -1359,24 +2372,19 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        unsigned int bit_rate = 0 ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        if (GetTermios2BitRate(this->mFileDescriptor, bit_rate) < 0)
         {
             throw std::runtime_error(std::strerror(errno)) ;
         }
 
-        // Read the character size from the setttings.
-        // NOLINTNEXTLINE (hicpp-signed-bitwise)
-        return CharacterSize(port_settings.c_cflag & CSIZE) ;
+        return bit_rate ;
     }
 
     inline
     void
-    SerialPort::Implementation::SetFlowControl(const FlowControl& flowControlType)
+    SerialPort::Implementation::SetCharacterSize(const CharacterSize& characterSize)
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -1384,56 +2392,47 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Flush the input and output buffers associated with the port.
-        if (tcflush(this->mFileDescriptor,
-                    TCIOFLUSH) < 0)
+        auto port_settings = mPortSettings ;
+        UpdateCharacterSize(port_settings, characterSize) ;
+        this->ApplyPortSettings(port_settings) ;
+    }
+
+    inline
+    CharacterSize
+    SerialPort::Implementation::GetCharacterSize() const
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        // Read the character size from the setttings.
+        // NOLINTNEXTLINE (hicpp-signed-bitwise)
+        return CharacterSize(mPortSettings.c_cflag & CSIZE) ;
+    }
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+    inline
+    void
+    SerialPort::Implementation::SetFlowControl(const FlowControl& flowControlType)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
         {
-            throw std::runtime_error(ERR_MSG_INVALID_FLOW_CONTROL) ;
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Set the flow control. Hardware flow control uses the RTS (Ready
-        // To Send) and CTS (clear to Send) lines. Software flow control
-        // uses IXON|IXOFF
-        switch(flowControlType)
-        {
-        case FlowControl::FLOW_CONTROL_HARDWARE:
-            port_settings.c_iflag &= ~ (IXON|IXOFF) ;   // NOLINT (hicpp-signed-bitwise)
-            port_settings.c_cflag |= CRTSCTS ;
-            port_settings.c_cc[VSTART] = _POSIX_VDISABLE ;
-            port_settings.c_cc[VSTOP] = _POSIX_VDISABLE ;
-            break ;
-        case FlowControl::FLOW_CONTROL_SOFTWARE:
-            port_settings.c_iflag |= IXON|IXOFF ;        // NOLINT(hicpp-signed-bitwise)
-            port_settings.c_cflag &= ~CRTSCTS ;
-            port_settings.c_cc[VSTART] = CTRL_Q ;        // 0x11 (021) ^q
-            port_settings.c_cc[VSTOP]  = CTRL_S ;        // 0x13 (023) ^s
-            break ;
-        case FlowControl::FLOW_CONTROL_NONE:
-            port_settings.c_iflag &= ~(IXON|IXOFF) ;    // NOLINT(hicpp-signed-bitwise)
-            port_settings.c_cflag &= ~CRTSCTS ;
-            break ;
-        default:
-            throw std::invalid_argument(ERR_MSG_INVALID_FLOW_CONTROL) ;
-            // break ; break not needed after a throw
-        }
+        auto port_settings = mPortSettings ;
+        UpdateFlowControl(port_settings, flowControlType) ;
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+        // Flush the input and output buffers associated with the port.
+        if (tcflush(this->mFileDescriptor,
+                    TCIOFLUSH) < 0)
         {
             throw std::runtime_error(std::strerror(errno)) ;
         }
+
+        this->ApplyPortSettings(port_settings) ;
     }
 
     inline
@@ -1446,31 +2445,21 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
-
         // Check if IXON and IXOFF are set in c_iflag. If both are set and
         // VSTART and VSTOP are set to 0x11 (^Q) and 0x13 (^S) respectively,
         // then we are using software flow control.
-        if ((port_settings.c_iflag & IXON) and // NOLINT (hicpp-signed-bitwise)
-            (port_settings.c_iflag & IXOFF) and // NOLINT (hicpp-signed-bitwise)
-            (CTRL_Q == port_settings.c_cc[VSTART]) and
-            (CTRL_S == port_settings.c_cc[VSTOP]))
+        if ((mPortSettings.c_iflag & IXON) and // NOLINT (hicpp-signed-bitwise)
+            (mPortSettings.c_iflag & IXOFF) and // NOLINT (hicpp-signed-bitwise)
+            (CTRL_Q == mPortSettings.c_cc[VSTART]) and
+            (CTRL_S == mPortSettings.c_cc[VSTOP]))
         {
             return FlowControl::FLOW_CONTROL_SOFTWARE ;
         }
 
-        if (not ((port_settings.c_iflag & IXON) or // NOLINT (hicpp-signed-bitwise)
-                 (port_settings.c_iflag & IXOFF))) // NOLINT (hicpp-signed-bitwise)
+        if (not ((mPortSettings.c_iflag & IXON) or // NOLINT (hicpp-signed-bitwise)
+                 (mPortSettings.c_iflag & IXOFF))) // NOLINT (hicpp-signed-bitwise)
         {
-            if (0 != (port_settings.c_cflag & CRTSCTS))
+            if (0 != (mPortSettings.c_cflag & CRTSCTS))
             {
                 // If neither IXON or IXOFF is set then we must have hardware flow
                 // control.
@@ -1494,45 +2483,9 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
-
-        // Set the parity type
-        switch(parityType)
-        {
-        case Parity::PARITY_EVEN:
-            port_settings.c_cflag |= PARENB ;
-            port_settings.c_cflag &= ~PARODD ;  // NOLINT (hicpp-signed-bitwise)
-            port_settings.c_iflag |= INPCK ;
-            break ;
-        case Parity::PARITY_ODD:
-            port_settings.c_cflag |= PARENB ;
-            port_settings.c_cflag |= PARODD ;
-            port_settings.c_iflag |= INPCK ;
-            break ;
-        case Parity::PARITY_NONE:
-            port_settings.c_cflag &= ~PARENB ;  // NOLINT (hicpp-signed-bitwise)
-            port_settings.c_iflag |= IGNPAR ;
-            break ;
-        default:
-            throw std::invalid_argument(ERR_MSG_INVALID_PARITY) ;
-            // break ; break not needed after a throw
-        }
-
-        // Apply the modified port settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+        auto port_settings = mPortSettings ;
+        UpdateParity(port_settings, parityType) ;
+        this->ApplyPortSettings(port_settings) ;
     }
 
     inline
@@ -1545,21 +2498,11 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
-
         // Get the parity setting from the termios structure.
-        if (0 != (port_settings.c_cflag & PARENB)) // NOLINT (hicpp-signed-bitwise)
+        if (0 != (mPortSettings.c_cflag & PARENB)) // NOLINT (hicpp-signed-bitwise)
         {
             // parity is enabled.
-            if (port_settings.c_cflag & PARODD) // NOLINT (hicpp-signed-bitwise)
+            if (mPortSettings.c_cflag & PARODD) // NOLINT (hicpp-signed-bitwise)
             {
                 return Parity::PARITY_ODD ; // odd parity
             }
@@ -1578,42 +2521,48 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        auto port_settings = mPortSettings ;
+        UpdateStopBits(port_settings, stopBits) ;
+        this->ApplyPortSettings(port_settings) ;
+    }
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+    inline
+    StopBits
+    SerialPort::Implementation::GetStopBits() const
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Set the number of stop bits.
-        switch(stopBits)
+        // If CSTOPB is set then we are using two stop bits, otherwise we
+        // are using 1 stop bit.
+        if (mPortSettings.c_cflag & CSTOPB) // NOLINT (hicpp-signed-bitwise)
         {
-        case StopBits::STOP_BITS_1:
-            port_settings.c_cflag &= ~CSTOPB ;  // NOLINT (hicpp-signed-bitwise)
-            break ;
-        case StopBits::STOP_BITS_2:
-            port_settings.c_cflag |= CSTOPB ;
-            break ;
-        default:
-            throw std::invalid_argument(ERR_MSG_INVALID_STOP_BITS) ;
-            // break ; break not needed after a throw
+            return StopBits::STOP_BITS_2 ;
         }
+        return StopBits::STOP_BITS_1 ;
+    }
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+    inline
+    void
+    SerialPort::Implementation::SetVMin(const short vmin)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
+
+        auto port_settings = mPortSettings ;
+        UpdateVMin(port_settings, vmin) ;
+        this->ApplyPortSettings(port_settings) ;
     }
 
     inline
-    StopBits
-    SerialPort::Implementation::GetStopBits() const
+    short
+    SerialPort::Implementation::GetVMin() const
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -1621,28 +2570,40 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        return mPortSettings.c_cc[VMIN] ;
+    }
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+    inline
+    void
+    SerialPort::Implementation::SetVTime(const short vtime)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // If CSTOPB is set then we are using two stop bits, otherwise we
-        // are using 1 stop bit.
-        if (port_settings.c_cflag & CSTOPB) // NOLINT (hicpp-signed-bitwise)
+        auto port_settings = mPortSettings ;
+        UpdateVTime(port_settings, vtime) ;
+        this->ApplyPortSettings(port_settings) ;
+    }
+
+    inline
+    short
+    SerialPort::Implementation::GetVTime() const
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
         {
-            return StopBits::STOP_BITS_2 ;
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
-        return StopBits::STOP_BITS_1 ;
+
+        return mPortSettings.c_cc[VTIME] ;
     }
 
     inline
     void
-    SerialPort::Implementation::SetVMin(const short vmin)
+    SerialPort::Implementation::SetLowLatency(const bool lowLatency)
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -1650,38 +2611,69 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        if (vmin < 0 || vmin > 255)
+        serial_struct serial_info {} ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (call_with_retry(ioctl,
+                            this->mFileDescriptor,
+                            TIOCGSERIAL,
+                            &serial_info) == -1)
         {
-            std::stringstream error_message ;
-            error_message << "Invalid vmin value: " << vmin << ". " ;
-            error_message << "Vmin must be in the range [0, 255]." ;
-            throw std::invalid_argument {error_message.str()} ;
+            throw std::runtime_error(std::strerror(errno)) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        const auto latency_timer_path = this->GetLatencyTimerPath() ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        // Save the original driver settings so that Close() can restore them.
+        if (not mLowLatencySaved)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            std::ifstream latency_timer_file(latency_timer_path) ;
+            mOldLatencyTimer.clear() ;
+            std::getline(latency_timer_file, mOldLatencyTimer) ;
+
+            mOldSerialFlags = serial_info.flags ;
+            mLowLatencySaved = true ;
         }
 
-        port_settings.c_cc[VMIN] = static_cast<cc_t>(vmin) ;
+        if (lowLatency)
+        {
+            serial_info.flags |= ASYNC_LOW_LATENCY ;    // NOLINT (hicpp-signed-bitwise)
+        }
+        else
+        {
+            serial_info.flags &= ~ASYNC_LOW_LATENCY ;   // NOLINT (hicpp-signed-bitwise)
+        }
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (call_with_retry(ioctl,
+                            this->mFileDescriptor,
+                            TIOCSSERIAL,
+                            &serial_info) == -1)
         {
             throw std::runtime_error(std::strerror(errno)) ;
         }
+
+        // Writing the latency timer usually requires elevated privileges,
+        // so it is best effort. Drivers such as ftdi_sio also shorten the
+        // timer themselves when ASYNC_LOW_LATENCY is set.
+        if (not mOldLatencyTimer.empty())
+        {
+            std::ofstream latency_timer_file(latency_timer_path) ;
+
+            if (lowLatency)
+            {
+                latency_timer_file << LATENCY_TIMER_LOW_LATENCY ;
+            }
+            else
+            {
+                latency_timer_file << mOldLatencyTimer ;
+            }
+        }
     }
 
     inline
-    short
-    SerialPort::Implementation::GetVMin() const
+    bool
+    SerialPort::Implementation::IsLowLatency() const
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -1689,22 +2681,23 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        serial_struct serial_info {} ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (call_with_retry(ioctl,
+                            this->mFileDescriptor,
+                            TIOCGSERIAL,
+                            &serial_info) == -1)
         {
             throw std::runtime_error(std::strerror(errno)) ;
         }
 
-        return port_settings.c_cc[VMIN] ;
+        return (serial_info.flags & ASYNC_LOW_LATENCY) != 0 ;   // NOLINT (hicpp-signed-bitwise)
     }
 
     inline
     void
-    SerialPort::Implementation::SetVTime(const short vtime)
+    SerialPort::Implementation::SetLatencyProfile(const LatencyProfile& latencyProfile)
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -1712,38 +2705,118 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        if (vtime < 0 || vtime > 255)
+        auto port_settings = mPortSettings ;
+        bool low_latency = false ;
+
+        switch (latencyProfile)
         {
-            std::stringstream error_message ;
-            error_message << "Invalid vtime value: " << vtime << ". " ;
-            error_message << "Vtime must be in the range [0, 255]." ;
-            throw std::invalid_argument {error_message.str()} ;
+        case LatencyProfile::LATENCY_PROFILE_LATENCY:
+            UpdateVMin(port_settings, 1) ;
+            UpdateVTime(port_settings, 0) ;
+            low_latency = true ;
+            break ;
+        case LatencyProfile::LATENCY_PROFILE_THROUGHPUT:
+            UpdateVMin(port_settings, VMIN_THROUGHPUT) ;
+            UpdateVTime(port_settings, VTIME_THROUGHPUT) ;
+            break ;
+        default:
+            throw std::invalid_argument {ERR_MSG_INVALID_LATENCY_PROFILE} ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        this->ApplyPortSettings(port_settings) ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        // Drivers without TIOCGSERIAL support, such as pseudo terminals,
+        // only receive the termios settings.
+        serial_struct serial_info {} ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (call_with_retry(ioctl,
+                            this->mFileDescriptor,
+                            TIOCGSERIAL,
+                            &serial_info) == -1)
         {
+            if ((errno == ENOTTY) or
+                (errno == EINVAL))
+            {
+                return ;
+            }
+
             throw std::runtime_error(std::strerror(errno)) ;
         }
 
-        port_settings.c_cc[VTIME] = static_cast<cc_t>(vtime) ;
+        this->SetLowLatency(low_latency) ;
+    }
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+    inline
+    void
+    SerialPort::Implementation::SetRS485Settings(const RS485Settings& rs485Settings)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        serial_rs485 rs485_config {} ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (call_with_retry(ioctl,
+                            this->mFileDescriptor,
+                            TIOCGRS485,
+                            &rs485_config) == -1)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        // Save the original driver settings so that Close() can restore them.
+        if (not mRS485SettingsSaved)
+        {
+            mOldRS485Settings = rs485_config ;
+            mRS485SettingsSaved = true ;
+        }
+
+        // Flags other than the ones set here, such as bus termination, are
+        // left as the driver reported them.
+        rs485_config.flags &= ~(SER_RS485_ENABLED |        // NOLINT (hicpp-signed-bitwise)
+                                SER_RS485_RTS_ON_SEND |
+                                SER_RS485_RTS_AFTER_SEND |
+                                SER_RS485_RX_DURING_TX) ;
+
+        if (rs485Settings.enabled)
+        {
+            rs485_config.flags |= SER_RS485_ENABLED ;         // NOLINT (hicpp-signed-bitwise)
+        }
+
+        if (rs485Settings.rtsOnSend)
+        {
+            rs485_config.flags |= SER_RS485_RTS_ON_SEND ;     // NOLINT (hicpp-signed-bitwise)
+        }
+        else
+        {
+            rs485_config.flags |= SER_RS485_RTS_AFTER_SEND ;  // NOLINT (hicpp-signed-bitwise)
+        }
+
+        if (rs485Settings.receiveDuringTransmit)
+        {
+            rs485_config.flags |= SER_RS485_RX_DURING_TX ;    // NOLINT (hicpp-signed-bitwise)
+        }
+
+        rs485_config.delay_rts_before_send = rs485Settings.delayRtsBeforeSend ;
+        rs485_config.delay_rts_after_send  = rs485Settings.delayRtsAfterSend ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (call_with_retry(ioctl,
+                            this->mFileDescriptor,
+                            TIOCSRS485,
+                            &rs485_config) == -1)
         {
             throw std::runtime_error(std::strerror(errno)) ;
         }
     }
 
     inline
-    short
-    SerialPort::Implementation::GetVTime() const
+    RS485Settings
+    SerialPort::Implementation::GetRS485Settings() const
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -1751,17 +2824,25 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        serial_rs485 rs485_config {} ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (call_with_retry(ioctl,
+                            this->mFileDescriptor,
+                            TIOCGRS485,
+                            &rs485_config) == -1)
         {
             throw std::runtime_error(std::strerror(errno)) ;
         }
 
-        return port_settings.c_cc[VTIME] ;
+        RS485Settings rs485_settings {} ;
+        rs485_settings.enabled               = (rs485_config.flags & SER_RS485_ENABLED) != 0 ;       // NOLINT (hicpp-signed-bitwise)
+        rs485_settings.rtsOnSend             = (rs485_config.flags & SER_RS485_RTS_ON_SEND) != 0 ;   // NOLINT (hicpp-signed-bitwise)
+        rs485_settings.receiveDuringTransmit = (rs485_config.flags & SER_RS485_RX_DURING_TX) != 0 ;  // NOLINT (hicpp-signed-bitwise)
+        rs485_settings.delayRtsBeforeSend    = rs485_config.delay_rts_before_send ;
+        rs485_settings.delayRtsAfterSend     = rs485_config.delay_rts_after_send ;
+
+        return rs485_settings ;
     }
 
     inline
@@ -1878,50 +2959,44 @@ namespace LibSerial
             throw std::runtime_error(std::strerror(errno)) ;
         }
 
-        return number_of_bytes_available ;
+        return number_of_bytes_available + static_cast<int>(this->GetNumberOfBytesReadAhead()) ;
     }
 
-#ifdef __linux__
     inline
-    std::vector<std::string>
-    SerialPort::Implementation::GetAvailableSerialPorts() const
+    int
+    SerialPort::Implementation::GetNumberOfBytesPending() const
     {
-        constexpr int array_size = 3 ;
-        constexpr size_t max_port_number = 128 ;
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
 
-        std::string serial_ports[array_size] = {"/dev/ttyS",
-                                                "/dev/ttyACM",
-                                                "/dev/ttyUSB"} ;
+        int number_of_bytes_pending = 0 ;
 
-        std::vector<std::string> serial_port_names {} ;
-        for (const auto& port_prefix: serial_ports)
+        if (LibSerial::GetNumberOfBytesPending(this->mFileDescriptor,
+                                               number_of_bytes_pending) < 0)
         {
-            for (size_t j = 0 ;j < max_port_number;j++)
-            {
-                const auto file_name = port_prefix + std::to_string(j) ;
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
 
-                // Try to open the serial port.
-                const auto file_desc = call_with_retry(open,
-                                                       file_name.c_str(),
-                                                       O_RDWR | O_NOCTTY | O_NONBLOCK) ; // NOLINT (hicpp-vararg)
+        return number_of_bytes_pending ;
+    }
 
-                if (file_desc > 0)
-                {
-                    serial_struct serial_port_info {} ;
-                    // NOLINTNEXTLINE (hicpp-vararg)
-                    if (call_with_retry(ioctl,
-                                        file_desc,
-                                        TIOCGSERIAL,
-                                        &serial_port_info) == -1)
-                    {
-                        throw std::runtime_error(std::strerror(errno)) ;
-                    }
+#ifdef __linux__
+    inline
+    std::vector<std::string>
+    SerialPort::Implementation::GetAvailableSerialPorts() const
+    {
+        // Enumerate through sysfs rather than probing device nodes, which
+        // is slow and can block on misbehaving drivers.
+        const SerialPortEnumerator serial_port_enumerator ;
 
-                    serial_port_names.push_back(file_name) ;
+        std::vector<std::string> serial_port_names {} ;
 
-                    close(file_desc) ;
-                }
-            }
+        for (const auto& port_info : serial_port_enumerator.GetSerialPorts())
+        {
+            serial_port_names.push_back(port_info.devicePath) ;
         }
 
         return serial_port_names ;
@@ -2023,6 +3098,91 @@ namespace LibSerial
         return (0 != (serial_port_state & modemLine)) ; // NOLINT(hicpp-signed-bitwise)
     }
 
+    inline
+    ModemLineCounters
+    SerialPort::Implementation::GetModemLineCounters()
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        ModemLineCounters modem_line_counters {} ;
+
+        if (LibSerial::GetModemLineCounters(this->mFileDescriptor,
+                                            modem_line_counters) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        return modem_line_counters ;
+    }
+
+    inline
+    int
+    SerialPort::Implementation::WaitForModemLineChange(const int    modemLineMask,
+                                                       const size_t msTimeout)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        if ((modemLineMask == 0) or
+            ((modemLineMask & ~MODEM_INPUT_LINE_MASK) != 0)) // NOLINT (hicpp-signed-bitwise)
+        {
+            throw std::invalid_argument {ERR_MSG_INVALID_MODEM_LINE} ;
+        }
+
+        auto modem_line_counters = this->GetModemLineCounters() ;
+
+        return this->WaitForModemLineChange(modemLineMask,
+                                            modem_line_counters,
+                                            msTimeout) ;
+    }
+
+    inline
+    int
+    SerialPort::Implementation::WaitForModemLineChange(const int          modemLineMask,
+                                                       ModemLineCounters& modemLineCounters,
+                                                       const size_t       msTimeout)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        if ((modemLineMask == 0) or
+            ((modemLineMask & ~MODEM_INPUT_LINE_MASK) != 0)) // NOLINT (hicpp-signed-bitwise)
+        {
+            throw std::invalid_argument {ERR_MSG_INVALID_MODEM_LINE} ;
+        }
+
+        // Fails early if the signal that bounds the wait is unusable.
+        GetModemLineWakeSignal() ;
+
+        const auto changed_lines = LibSerial::WaitForModemLineChange(this->mFileDescriptor,
+                                                                     modemLineMask,
+                                                                     modemLineCounters,
+                                                                     msTimeout) ;
+        const auto error_number = errno ;
+
+        if (changed_lines < 0)
+        {
+            throw std::runtime_error(std::strerror(error_number)) ;
+        }
+
+        if (changed_lines == 0)
+        {
+            throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+        }
+
+        return changed_lines ;
+    }
+
     inline
     void
     SerialPort::Implementation::SetSerialPortBlockingStatus(const bool blockingStatus)
@@ -2086,168 +3246,338 @@ namespace LibSerial
 
     inline
     void
-    SerialPort::Implementation::SetDefaultLinuxSpecificModes()
+    SerialPort::Implementation::ApplyPortSettings(const termios& portSettings)
     {
-        // Make sure that the serial port is open.
-        if (not this->IsOpen())
+        // Apply the modified settings.
+        if (tcsetattr(this->mFileDescriptor,
+                      TCSANOW,
+                      &portSettings) < 0)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            throw std::runtime_error(std::strerror(errno)) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
+        // tcsetattr() succeeds if any of the requested changes could be made,
+        // so read back the settings that are actually in effect.
         if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+                      &mPortSettings) < 0)
         {
             throw std::runtime_error(std::strerror(errno)) ;
         }
+    }
 
-        // @NOTE - termios.c_line is not a standard element of the termios
-        // structure, (as per the Single Unix Specification 3).
-        port_settings.c_line = '\0' ;
+    inline
+    void
+    SerialPort::Implementation::UpdatePortSettings(termios&            portSettings,
+                                                   const PortSettings& serialPortParameters)
+    {
+        UpdateBaudRate(portSettings, serialPortParameters.baudRate) ;
+        UpdateCharacterSize(portSettings, serialPortParameters.characterSize) ;
+        UpdateFlowControl(portSettings, serialPortParameters.flowControl) ;
+        UpdateParity(portSettings, serialPortParameters.parity) ;
+        UpdateStopBits(portSettings, serialPortParameters.stopBits) ;
+        UpdateVMin(portSettings, serialPortParameters.vmin) ;
+        UpdateVTime(portSettings, serialPortParameters.vtime) ;
+    }
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+    inline
+    void
+    SerialPort::Implementation::UpdateBaudRate(termios&        portSettings,
+                                               const BaudRate& baudRate)
+    {
+        // Set the baud rate for both input and output.
+        if (0 != cfsetspeed(&portSettings, static_cast<speed_t>(baudRate)))
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            // If applying the baud rate settings fail, throw an exception.
+            throw std::runtime_error(ERR_MSG_INVALID_BAUD_RATE) ;
         }
     }
 
     inline
     void
-    SerialPort::Implementation::SetDefaultInputModes()
+    SerialPort::Implementation::UpdateCharacterSize(termios&             portSettings,
+                                                    const CharacterSize& characterSize)
     {
-        // Make sure that the serial port is open.
-        if (not this->IsOpen())
+        // Set the character size to the specified value. If the character
+        // size is not 8 then it is also important to set ISTRIP. Setting
+        // ISTRIP causes all but the 7 low-order bits to be set to
+        // zero. Otherwise they are set to unspecified values and may
+        // cause problems. At the same time, we should clear the ISTRIP
+        // flag when the character size is 8 otherwise the MSB will always
+        // be set to zero (ISTRIP does not check the character size
+        // setting;it just sets every bit above the low 7 bits to zero).
+        if (characterSize == CharacterSize::CHAR_SIZE_8)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            // NOLINTNEXTLINE (hicpp-signed-bitwise)
+            portSettings.c_iflag &= ~ISTRIP ;  // Clear the ISTRIP flag.
         }
-
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        else
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            portSettings.c_iflag |= ISTRIP ;   // Set the ISTRIP flag.
         }
 
-        // Ignore Break conditions on input.
-        port_settings.c_iflag = IGNBRK ;
+        // Set the character size.
+        // NOLINTNEXTLINE (hicpp-signed-bitwise)
+        portSettings.c_cflag &= ~CSIZE ;                               // Clear all CSIZE bits.
+        portSettings.c_cflag |= static_cast<tcflag_t>(characterSize) ; // Set the character size.
+    }
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+    inline
+    void
+    SerialPort::Implementation::UpdateFlowControl(termios&           portSettings,
+                                                  const FlowControl& flowControlType)
+    {
+        // Set the flow control. Hardware flow control uses the RTS (Ready
+        // To Send) and CTS (clear to Send) lines. Software flow control
+        // uses IXON|IXOFF
+        switch(flowControlType)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+        case FlowControl::FLOW_CONTROL_HARDWARE:
+            portSettings.c_iflag &= ~ (IXON|IXOFF) ;   // NOLINT (hicpp-signed-bitwise)
+            portSettings.c_cflag |= CRTSCTS ;
+            portSettings.c_cc[VSTART] = _POSIX_VDISABLE ;
+            portSettings.c_cc[VSTOP] = _POSIX_VDISABLE ;
+            break ;
+        case FlowControl::FLOW_CONTROL_SOFTWARE:
+            portSettings.c_iflag |= IXON|IXOFF ;        // NOLINT(hicpp-signed-bitwise)
+            portSettings.c_cflag &= ~CRTSCTS ;
+            portSettings.c_cc[VSTART] = CTRL_Q ;        // 0x11 (021) ^q
+            portSettings.c_cc[VSTOP]  = CTRL_S ;        // 0x13 (023) ^s
+            break ;
+        case FlowControl::FLOW_CONTROL_NONE:
+            portSettings.c_iflag &= ~(IXON|IXOFF) ;    // NOLINT(hicpp-signed-bitwise)
+            portSettings.c_cflag &= ~CRTSCTS ;
+            break ;
+        default:
+            throw std::invalid_argument(ERR_MSG_INVALID_FLOW_CONTROL) ;
+            // break ; break not needed after a throw
         }
     }
 
     inline
     void
-    SerialPort::Implementation::SetDefaultOutputModes()
+    SerialPort::Implementation::UpdateParity(termios&      portSettings,
+                                             const Parity& parityType)
     {
-        // Make sure that the serial port is open.
-        if (not this->IsOpen())
+        // Set the parity type
+        switch(parityType)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        case Parity::PARITY_EVEN:
+            portSettings.c_cflag |= PARENB ;
+            portSettings.c_cflag &= ~PARODD ;  // NOLINT (hicpp-signed-bitwise)
+            portSettings.c_iflag |= INPCK ;
+            break ;
+        case Parity::PARITY_ODD:
+            portSettings.c_cflag |= PARENB ;
+            portSettings.c_cflag |= PARODD ;
+            portSettings.c_iflag |= INPCK ;
+            break ;
+        case Parity::PARITY_NONE:
+            portSettings.c_cflag &= ~PARENB ;  // NOLINT (hicpp-signed-bitwise)
+            portSettings.c_iflag |= IGNPAR ;
+            break ;
+        default:
+            throw std::invalid_argument(ERR_MSG_INVALID_PARITY) ;
+            // break ; break not needed after a throw
         }
+    }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
-
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+    inline
+    void
+    SerialPort::Implementation::UpdateStopBits(termios&        portSettings,
+                                               const StopBits& stopBits)
+    {
+        // Set the number of stop bits.
+        switch(stopBits)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+        case StopBits::STOP_BITS_1:
+            portSettings.c_cflag &= ~CSTOPB ;  // NOLINT (hicpp-signed-bitwise)
+            break ;
+        case StopBits::STOP_BITS_2:
+            portSettings.c_cflag |= CSTOPB ;
+            break ;
+        default:
+            throw std::invalid_argument(ERR_MSG_INVALID_STOP_BITS) ;
+            // break ; break not needed after a throw
         }
+    }
 
-        port_settings.c_oflag = 0 ;
-
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+    inline
+    void
+    SerialPort::Implementation::UpdateVMin(termios&    portSettings,
+                                           const short vmin)
+    {
+        if (vmin < 0 || vmin > 255)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            std::stringstream error_message ;
+            error_message << "Invalid vmin value: " << vmin << ". " ;
+            error_message << "Vmin must be in the range [0, 255]." ;
+            throw std::invalid_argument {error_message.str()} ;
         }
+
+        portSettings.c_cc[VMIN] = static_cast<cc_t>(vmin) ;
     }
 
     inline
     void
-    SerialPort::Implementation::SetDefaultControlModes()
+    SerialPort::Implementation::UpdateVTime(termios&    portSettings,
+                                            const short vtime)
     {
-        // Make sure that the serial port is open.
-        if (not this->IsOpen())
+        if (vtime < 0 || vtime > 255)
         {
-            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            std::stringstream error_message ;
+            error_message << "Invalid vtime value: " << vtime << ". " ;
+            error_message << "Vtime must be in the range [0, 255]." ;
+            throw std::invalid_argument {error_message.str()} ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        portSettings.c_cc[VTIME] = static_cast<cc_t>(vtime) ;
+    }
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+    inline
+    void
+    SerialPort::Implementation::SetDefaultLinuxSpecificModes(termios& portSettings)
+    {
+        // @NOTE - termios.c_line is not a standard element of the termios
+        // structure, (as per the Single Unix Specification 3).
+        portSettings.c_line = '\0' ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::SetDefaultInputModes(termios& portSettings)
+    {
+        // Ignore Break conditions on input.
+        portSettings.c_iflag = IGNBRK ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::SetDefaultOutputModes(termios& portSettings)
+    {
+        portSettings.c_oflag = 0 ;
+    }
 
+    inline
+    void
+    SerialPort::Implementation::SetDefaultControlModes(termios& portSettings)
+    {
         // Enable the receiver (CREAD) and ignore modem control lines (CLOCAL).
-        port_settings.c_cflag |= CREAD | CLOCAL ;    // NOLINT (hicpp-signed-bitwise)
+        portSettings.c_cflag |= CREAD | CLOCAL ;    // NOLINT (hicpp-signed-bitwise)
+    }
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
-        {
-            throw std::runtime_error(std::strerror(errno)) ;
-        }
+    inline
+    void
+    SerialPort::Implementation::SetDefaultLocalModes(termios& portSettings)
+    {
+        portSettings.c_lflag = 0 ;
     }
 
     inline
     void
-    SerialPort::Implementation::SetDefaultLocalModes()
+    SerialPort::Implementation::Read(DataBuffer&  dataBuffer,
+                                     const size_t numberOfBytes,
+                                     const size_t msTimeout)
     {
-        // Make sure that the serial port is open.
+        this->ReadIntoContainer(dataBuffer,
+                                numberOfBytes,
+                                msTimeout) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::Read(std::string& dataString,
+                                     const size_t numberOfBytes,
+                                     const size_t msTimeout)
+    {
+        this->ReadIntoContainer(dataString,
+                                numberOfBytes,
+                                msTimeout) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::Read(PooledDataBuffer& dataBuffer,
+                                     const size_t      numberOfBytes,
+                                     const size_t      msTimeout)
+    {
+        this->ReadIntoContainer(dataBuffer,
+                                numberOfBytes,
+                                msTimeout) ;
+    }
+
+    inline
+    size_t
+    SerialPort::Implementation::Read(uint8_t* const dataBuffer,
+                                     const size_t   bufferSize,
+                                     const size_t   msTimeout)
+    {
+        // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
         {
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Get the current serial port settings.
-        termios port_settings {} ;
-        std::memset(&port_settings, 0, sizeof(port_settings)) ;
+        if (bufferSize == 0)
+        {
+            return 0 ;
+        }
+
+        // Return data already read from the serial port by ReadLine() first.
+        const auto number_of_bytes_read_ahead = this->ReadFromReadAheadBuffer(dataBuffer,
+                                                                              bufferSize) ;
 
-        if (tcgetattr(this->mFileDescriptor,
-                      &port_settings) < 0)
+        if (number_of_bytes_read_ahead > 0)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            return number_of_bytes_read_ahead ;
         }
 
-        port_settings.c_lflag = 0 ;
+        // Obtain the entry time.
+        const auto entry_time = std::chrono::steady_clock::now() ;
 
-        // Apply the modified settings.
-        if (tcsetattr(this->mFileDescriptor,
-                      TCSANOW,
-                      &port_settings) < 0)
+        while (true)
         {
-            throw std::runtime_error(std::strerror(errno)) ;
+            // Throw a ReadTimeout exception if no data arrives before
+            // msTimeout milliseconds have elapsed.
+            const auto remaining_ms = GetRemainingTimeout(entry_time, msTimeout) ;
+
+            if ((remaining_ms == 0) or
+                (not this->WaitForDataAvailable(remaining_ms)))
+            {
+                LIBSERIAL_STATISTICS(this->mStatistics.RecordReadTimeout()) ;
+                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+            }
+
+            // Return everything that has arrived with a single read() call.
+            const auto read_result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                               read,
+                                                               this->mFileDescriptor,
+                                                               dataBuffer,
+                                                               bufferSize) ;
+
+            LIBSERIAL_STATISTICS(this->mStatistics.RecordRead(read_result)) ;
+
+            if (read_result > 0)
+            {
+                return static_cast<size_t>(read_result) ;
+            }
+
+            if (read_result == 0)
+            {
+                throw std::runtime_error(std::strerror(EIO)) ;
+            }
+
+            if (errno != EWOULDBLOCK)
+            {
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
         }
     }
 
     inline
     void
-    SerialPort::Implementation::Read(DataBuffer&  dataBuffer,
-                                     const size_t numberOfBytes,
-                                     const size_t msTimeout)
+    SerialPort::Implementation::ReadTimestamped(TimestampedDataBuffer& timestampedData,
+                                                const size_t           numberOfBytes,
+                                                const size_t           msTimeout)
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -2255,93 +3585,89 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        if ((numberOfBytes == 0) and
-            (msTimeout == 0))
+        auto& data = timestampedData.data ;
+
+        data.clear() ;
+        timestampedData.chunkOffsets.clear() ;
+        timestampedData.chunkTimestamps.clear() ;
+
+        // Return data already read from the serial port by ReadLine() first.
+        if (this->GetNumberOfBytesReadAhead() > 0)
         {
-            return ;
-        }
+            const auto number_of_bytes_to_copy = (numberOfBytes == 0) ?
+                this->GetNumberOfBytesReadAhead() :
+                std::min(numberOfBytes, this->GetNumberOfBytesReadAhead()) ;
 
-        // Local variables.
-        size_t number_of_bytes_read = 0 ;
-        size_t number_of_bytes_remaining = std::max(numberOfBytes, static_cast<size_t>(1)) ;
-        size_t maximum_number_of_bytes = dataBuffer.max_size() ;
+            data.resize(number_of_bytes_to_copy) ;
+            this->ReadFromReadAheadBuffer(data.data(),
+                                          number_of_bytes_to_copy) ;
 
-        // Clear the data buffer and reserve enough space in the buffer to store the incoming data.
-        dataBuffer.clear() ;
-        dataBuffer.resize(number_of_bytes_remaining) ;
+            timestampedData.chunkOffsets.push_back(0) ;
+            timestampedData.chunkTimestamps.push_back(mReadAheadTimestamp) ;
+        }
 
         // Obtain the entry time.
-        const auto entry_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
+        const auto entry_time = std::chrono::steady_clock::now() ;
 
-        while (number_of_bytes_remaining > 0)
+        while (data.empty() or
+               (data.size() < numberOfBytes))
         {
-            // If insufficient space remains in the buffer, exit the loop and return .
-            if (number_of_bytes_remaining >= maximum_number_of_bytes - number_of_bytes_read)
-            {
-                break ;
-            }
+            const auto remaining_ms = GetRemainingTimeout(entry_time, msTimeout) ;
 
-            if (numberOfBytes == 0)
+            if ((remaining_ms == 0) or
+                (not this->WaitForDataAvailable(remaining_ms)))
             {
-                // Add an additional element for the read() call.
-                dataBuffer.resize(number_of_bytes_read + 1) ;
+                LIBSERIAL_STATISTICS(this->mStatistics.RecordReadTimeout()) ;
+                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
             }
 
-            const auto read_result = call_with_retry(read,
-                                                     this->mFileDescriptor,
-                                                     &dataBuffer[number_of_bytes_read],
-                                                     number_of_bytes_remaining) ;
+            // Stamp the chunk as soon as poll() wakes up, before spending
+            // any time on the read itself.
+            const auto arrival_time = std::chrono::steady_clock::now() ;
 
-            if (read_result > 0)
-            {
-                number_of_bytes_read += read_result ;
+            const auto number_of_bytes_read = data.size() ;
+            const auto number_of_bytes_available = static_cast<size_t>(std::max(this->GetNumberOfBytesAvailable(), 1)) ;
+            const auto number_of_bytes_to_read = (numberOfBytes == 0) ?
+                number_of_bytes_available :
+                numberOfBytes - number_of_bytes_read ;
 
-                if (numberOfBytes != 0)
-                {
-                    number_of_bytes_remaining = numberOfBytes - number_of_bytes_read ;
+            data.resize(number_of_bytes_read + number_of_bytes_to_read) ;
 
-                    if (number_of_bytes_remaining == 0)
-                    {
-                        break ;
-                    }
-                }
-            }
-            else if ((read_result <= 0) and
-                     (errno != EWOULDBLOCK))
-            {
-                throw std::runtime_error(std::strerror(errno)) ;
-            }
+            const auto read_result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                               read,
+                                                               this->mFileDescriptor,
+                                                               &data[number_of_bytes_read],
+                                                               number_of_bytes_to_read) ;
 
-            // Obtain the current time.
-            const auto current_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
+            LIBSERIAL_STATISTICS(this->mStatistics.RecordRead(read_result)) ;
 
-            // Calculate the time delta.
-            const auto elapsed_time = current_time - entry_time ;
+            const auto error_number = errno ;
 
-            // Calculate the elapsed number of milliseconds.
-            const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed_time).count() ;
+            data.resize(number_of_bytes_read +
+                        static_cast<size_t>(std::max(read_result, static_cast<ssize_t>(0)))) ;
 
-            // If more than msTimeout milliseconds have elapsed while
-            // waiting for data, then we throw a ReadTimeout exception.
-            if ((msTimeout > 0) and
-                (static_cast<size_t>(elapsed_ms) > msTimeout))
+            if (read_result > 0)
             {
-                // Resize the data buffer.
-                dataBuffer.resize(number_of_bytes_read) ;
-
-                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+                timestampedData.chunkOffsets.push_back(number_of_bytes_read) ;
+                timestampedData.chunkTimestamps.push_back(arrival_time) ;
+            }
+            else if (read_result == 0)
+            {
+                throw std::runtime_error(std::strerror(EIO)) ;
+            }
+            else if (error_number != EWOULDBLOCK)
+            {
+                throw std::runtime_error(std::strerror(error_number)) ;
             }
-
-            // Allow sufficient time for an additional byte to arrive.
-            usleep(mByteArrivalTimeDelta) ;
         }
     }
 
+    template <typename ContainerType>
     inline
     void
-    SerialPort::Implementation::Read(std::string& dataString,
-                                     const size_t numberOfBytes,
-                                     const size_t msTimeout)
+    SerialPort::Implementation::ReadIntoContainer(ContainerType& dataContainer,
+                                                  const size_t   numberOfBytes,
+                                                  const size_t   msTimeout)
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -2357,78 +3683,89 @@ namespace LibSerial
 
         // Local variables.
         size_t number_of_bytes_read = 0 ;
-        size_t number_of_bytes_remaining = std::max(numberOfBytes, static_cast<size_t>(1)) ;
-        size_t maximum_number_of_bytes = dataString.max_size() ;
 
-        // Clear the data buffer and reserve enough space in the buffer to store the incoming data.
-        dataString.clear() ;
-        dataString.resize(number_of_bytes_remaining) ;
+        // Clear the data container and reserve enough space in the container
+        // to store the incoming data. If numberOfBytes is zero, the container
+        // is grown as data arrives.
+        dataContainer.clear() ;
+        dataContainer.resize(numberOfBytes) ;
+
+        // Return data already read from the serial port by ReadLine() first.
+        if (this->GetNumberOfBytesReadAhead() > 0)
+        {
+            if (numberOfBytes == 0)
+            {
+                dataContainer.resize(this->GetNumberOfBytesReadAhead()) ;
+            }
+
+            number_of_bytes_read = this->ReadFromReadAheadBuffer(&dataContainer[0],
+                                                                 dataContainer.size()) ;
+        }
 
         // Obtain the entry time.
-        const auto entry_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
+        const auto entry_time = std::chrono::steady_clock::now() ;
 
-        while (number_of_bytes_remaining > 0)
+        while ((numberOfBytes == 0) or
+               (number_of_bytes_read < numberOfBytes))
         {
-            // If insufficient space remains in the buffer, exit the loop and return .
-            if (number_of_bytes_remaining >= maximum_number_of_bytes - number_of_bytes_read)
+            // Block in poll() until data arrives or the remaining time
+            // elapses. In the latter case data received so far remains
+            // available in the container and we throw a ReadTimeout exception.
+            const auto remaining_ms = GetRemainingTimeout(entry_time, msTimeout) ;
+
+            if ((remaining_ms == 0) or
+                (not this->WaitForDataAvailable(remaining_ms)))
             {
-                break ;
+                dataContainer.resize(number_of_bytes_read) ;
+                LIBSERIAL_STATISTICS(this->mStatistics.RecordReadTimeout()) ;
+                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
             }
 
+            size_t number_of_bytes_to_read = numberOfBytes - number_of_bytes_read ;
+
             if (numberOfBytes == 0)
             {
-                // Add an additional element for the read() call.
-                dataString.resize(number_of_bytes_read + 1) ;
+                // Drain everything that has already arrived with a single
+                // read() call.
+                const auto number_of_bytes_available = this->GetNumberOfBytesAvailable() ;
+                number_of_bytes_to_read = std::max(number_of_bytes_available, 1) ;
+
+                if (number_of_bytes_to_read > dataContainer.max_size() - number_of_bytes_read)
+                {
+                    // If insufficient space remains in the container, return.
+                    break ;
+                }
+
+                dataContainer.resize(number_of_bytes_read + number_of_bytes_to_read) ;
             }
 
-            const auto read_result = call_with_retry(read,
-                                                     this->mFileDescriptor,
-                                                     &dataString[number_of_bytes_read],
-                                                     number_of_bytes_remaining) ;
+            const auto read_result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                               read,
+                                                               this->mFileDescriptor,
+                                                               &dataContainer[number_of_bytes_read],
+                                                               number_of_bytes_to_read) ;
+
+            LIBSERIAL_STATISTICS(this->mStatistics.RecordRead(read_result)) ;
 
             if (read_result > 0)
             {
                 number_of_bytes_read += read_result ;
-
-                if (numberOfBytes != 0)
-                {
-                    number_of_bytes_remaining = numberOfBytes - number_of_bytes_read ;
-
-                    if (number_of_bytes_remaining == 0)
-                    {
-                        break ;
-                    }
-                }
             }
-            else if (read_result <= 0 &&
-                     errno != EWOULDBLOCK)
+            else if (read_result == 0)
             {
-                throw std::runtime_error(std::strerror(errno)) ;
+                // poll() reported the descriptor as readable but no data
+                // was returned, i.e. the other end of the line hung up.
+                dataContainer.resize(number_of_bytes_read) ;
+                throw std::runtime_error(std::strerror(EIO)) ;
             }
-
-            // Obtain the current time.
-            const auto current_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
-
-            // Calculate the time delta.
-            const auto elapsed_time = current_time - entry_time ;
-
-            // Calculate the elapsed number of milliseconds.
-            const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed_time).count() ;
-
-            // If more than msTimeout milliseconds have elapsed while
-            // waiting for data, then we throw a ReadTimeout exception.
-            if ((msTimeout > 0) and
-                (static_cast<size_t>(elapsed_ms) > msTimeout))
+            else if (errno != EWOULDBLOCK)
             {
-                // Resize the data string.
-                dataString.resize(number_of_bytes_read) ;
-
-                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+                dataContainer.resize(number_of_bytes_read) ;
+                throw std::runtime_error(std::strerror(errno)) ;
             }
-
-            // Allow sufficient time for an additional byte to arrive.
-            usleep(mByteArrivalTimeDelta) ;
         }
+
+        dataContainer.resize(number_of_bytes_read) ;
     }
 
     template <typename ByteType, typename /* unused */>
@@ -2447,58 +3784,159 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
+        // Return data already read from the serial port by ReadLine() first.
+        if (this->ReadFromReadAheadBuffer(&charBuffer,
+                                          sizeof(ByteType)) > 0)
+        {
+            return ;
+        }
+
         // Obtain the entry time.
-        const auto entry_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
+        const auto entry_time = std::chrono::steady_clock::now() ;
 
-        // Loop until the number of bytes requested have been read or the
-        // timeout has elapsed.
+        // Loop until the byte has been read or the timeout has elapsed.
         ssize_t read_result = 0 ;
         while (read_result < 1)
         {
-            read_result = call_with_retry(read,
-                                          this->mFileDescriptor,
-                                          &charBuffer,
-                                          sizeof(ByteType)) ;
+            // Throw a ReadTimeout exception if no data arrives before
+            // msTimeout milliseconds have elapsed.
+            const auto remaining_ms = GetRemainingTimeout(entry_time, msTimeout) ;
 
-            // If the byte has been successfully read, exit the loop and return.
-            if (read_result == sizeof(ByteType))
+            if ((remaining_ms == 0) or
+                (not this->WaitForDataAvailable(remaining_ms)))
             {
-                break ;
+                LIBSERIAL_STATISTICS(this->mStatistics.RecordReadTimeout()) ;
+                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+            }
+
+            read_result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                    read,
+                                                    this->mFileDescriptor,
+                                                    &charBuffer,
+                                                    sizeof(ByteType)) ;
+
+            LIBSERIAL_STATISTICS(this->mStatistics.RecordRead(read_result)) ;
+
+            if (read_result == 0)
+            {
+                throw std::runtime_error(std::strerror(EIO)) ;
             }
 
-            if ((read_result <= 0) and
+            if ((read_result < 0) and
                 (errno != EWOULDBLOCK))
             {
                 throw std::runtime_error(std::strerror(errno)) ;
             }
+        }
+    }
+
+    inline
+    void
+    SerialPort::Implementation::ReadLine(std::string& dataString,
+                                         const char   lineTerminator,
+                                         const size_t msTimeout)
+    {
+        this->ReadUntilTerminator(dataString,
+                                  &lineTerminator,
+                                  1,
+                                  msTimeout) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::ReadLine(std::string&       dataString,
+                                         const std::string& lineTerminator,
+                                         const size_t       msTimeout)
+    {
+        this->ReadUntilTerminator(dataString,
+                                  lineTerminator.data(),
+                                  lineTerminator.size(),
+                                  msTimeout) ;
+    }
+
+    inline
+    bool
+    SerialPort::Implementation::WaitForDataAvailable(const int msTimeout) const
+    {
+        // Close() wakes the wait through the close eventfd in concurrent
+        // mode, as a read waiting indefinitely would otherwise block it.
+        pollfd poll_fds[2] {} ;
+        poll_fds[0].fd = this->mFileDescriptor ;
+        poll_fds[0].events = POLLIN ;
+        poll_fds[1].fd = mCloseEventFileDescriptor ;
+        poll_fds[1].events = POLLIN ;
 
-            // Obtain the current time.
-            const auto current_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
+        const nfds_t number_of_poll_fds = (mCloseEventFileDescriptor < 0) ? 1 : 2 ;
+        const auto& poll_fd = poll_fds[0] ;
 
-            // Calculate the time delta.
-            const auto elapsed_time = current_time - entry_time ;
+        LIBSERIAL_STATISTICS(const auto wait_start = std::chrono::steady_clock::now()) ;
 
-            // Calculate the elapsed number of milliseconds.
-            const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed_time).count() ;
+        // Block until the kernel signals that data is available. The wait is
+        // restarted with the same timeout if it is interrupted by a signal.
+        const auto poll_result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                           poll,
+                                                           poll_fds,
+                                                           number_of_poll_fds,
+                                                           msTimeout) ;
 
-            // Throw a ReadTimeout exception if more than msTimeout milliseconds
-            // have elapsed while waiting for data.
-            if ((msTimeout > 0) and
-                (static_cast<size_t>(elapsed_ms) > msTimeout))
-            {
-                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
-            }
+        LIBSERIAL_STATISTICS(this->mStatistics.RecordReadWait(std::chrono::steady_clock::now() - wait_start)) ;
+
+        if (poll_result < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        if (poll_result == 0)
+        {
+            return false ;
+        }
+
+        if (0 != (poll_fds[1].revents & POLLIN)) // NOLINT (hicpp-signed-bitwise)
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // The device may have been removed or the descriptor may have become
+        // invalid. In either case, no more data will ever become available.
+        if (0 == (poll_fd.revents & POLLIN)) // NOLINT (hicpp-signed-bitwise)
+        {
+            const auto error_number = (poll_fd.revents & POLLNVAL) ? EBADF : EIO ; // NOLINT (hicpp-signed-bitwise)
+            throw std::runtime_error(std::strerror(error_number)) ;
+        }
+
+        return true ;
+    }
+
+    inline
+    int
+    SerialPort::Implementation::GetRemainingTimeout(const std::chrono::steady_clock::time_point& entryTime,
+                                                    const size_t msTimeout)
+    {
+        if (msTimeout == 0)
+        {
+            return -1 ;
+        }
 
-            // Allow sufficient time for an additional byte to arrive.
-            usleep(mByteArrivalTimeDelta) ;
+        // Calculate the elapsed number of milliseconds.
+        const auto elapsed_time = std::chrono::steady_clock::now() - entryTime ;
+        const auto elapsed_ms = static_cast<size_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(elapsed_time).count()) ;
+
+        if (elapsed_ms >= msTimeout)
+        {
+            return 0 ;
         }
+
+        return static_cast<int>(std::min(msTimeout - elapsed_ms,
+                                         static_cast<size_t>(std::numeric_limits<int>::max()))) ;
     }
 
     inline
     void
-    SerialPort::Implementation::ReadLine(std::string& dataString,
-                                         const char   lineTerminator,
-                                         const size_t msTimeout)
+    SerialPort::Implementation::ReadUntilTerminator(std::string& dataString,
+                                                    const char*  lineTerminator,
+                                                    const size_t terminatorSize,
+                                                    const size_t msTimeout)
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -2506,53 +3944,300 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
+        if (terminatorSize == 0)
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_TERMINATOR) ;
+        }
+
         // Clear the data string.
         dataString.clear() ;
 
-        unsigned char next_char = 0 ;
+        // Move any unread data to the front of the read-ahead buffer so
+        // that the line starts at the beginning of the buffer.
+        mReadAheadBuffer.erase(mReadAheadBuffer.begin(),
+                               mReadAheadBuffer.begin() + mReadAheadOffset) ;
+        mReadAheadOffset = 0 ;
 
-        size_t elapsed_ms = 0 ;
+        // The maximum number of bytes requested with each read() call.
+        constexpr size_t read_chunk_size = 256 ;
 
-        ssize_t remaining_ms = 0 ;
+        // The number of bytes at the start of the read-ahead buffer that have
+        // already been searched for the line terminator.
+        size_t number_of_bytes_searched = 0 ;
 
-        std::chrono::high_resolution_clock::duration entry_time ;
-        std::chrono::high_resolution_clock::duration current_time ;
-        std::chrono::high_resolution_clock::duration elapsed_time ;
+        // Move the partial line into dataString, (e.g. on timeout).
+        const auto return_partial_line = [this, &dataString]()
+        {
+            dataString.assign(mReadAheadBuffer.begin(),
+                              mReadAheadBuffer.end()) ;
+            this->DiscardReadAheadBuffer() ;
+        } ;
 
         // Obtain the entry time.
-        entry_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
+        const auto entry_time = std::chrono::steady_clock::now() ;
 
-        while (next_char != lineTerminator)
+        while (true)
         {
-            // Obtain the current time.
-            current_time = std::chrono::high_resolution_clock::now().time_since_epoch() ;
+            // Only search data that has not been searched already, allowing
+            // for a line terminator split across two reads.
+            const auto search_offset = number_of_bytes_searched -
+                                       std::min(number_of_bytes_searched, terminatorSize - 1) ;
+
+            const auto buffer_begin = mReadAheadBuffer.data() ;
+            const auto buffer_end = buffer_begin + mReadAheadBuffer.size() ;
+            const auto line_terminator = FindLineTerminator(buffer_begin + search_offset,
+                                                            buffer_end,
+                                                            lineTerminator,
+                                                            terminatorSize) ;
+
+            if (line_terminator != nullptr)
+            {
+                const auto line_size = static_cast<size_t>(line_terminator - buffer_begin) + terminatorSize ;
+
+                dataString.assign(mReadAheadBuffer.begin(),
+                                  mReadAheadBuffer.begin() + line_size) ;
+
+                mReadAheadOffset = line_size ;
+
+                if (mReadAheadOffset == mReadAheadBuffer.size())
+                {
+                    this->DiscardReadAheadBuffer() ;
+                }
+
+                return ;
+            }
 
-            // Calculate the time delta.
-            elapsed_time = current_time - entry_time ;
+            number_of_bytes_searched = mReadAheadBuffer.size() ;
 
-            // Calculate the elapsed number of milliseconds.
-            elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed_time).count() ;
+            // If msTimeout milliseconds have elapsed while waiting for data,
+            // then we throw a ReadTimeout exception.
+            const auto remaining_ms = GetRemainingTimeout(entry_time, msTimeout) ;
 
-            // If more than msTimeout milliseconds have elapsed while
-            // waiting for data, then we throw a ReadTimeout exception.
-            if (msTimeout > 0 &&
-                elapsed_ms > msTimeout)
+            if ((remaining_ms == 0) or
+                (not this->WaitForDataAvailable(remaining_ms)))
             {
+                return_partial_line() ;
+                LIBSERIAL_STATISTICS(this->mStatistics.RecordReadTimeout()) ;
                 throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
             }
 
-            remaining_ms = msTimeout - elapsed_ms ;
+            mReadAheadTimestamp = std::chrono::steady_clock::now() ;
+
+            // Append everything that has arrived, up to read_chunk_size
+            // bytes, with a single read() call.
+            const auto number_of_bytes_buffered = mReadAheadBuffer.size() ;
+            mReadAheadBuffer.resize(number_of_bytes_buffered + read_chunk_size) ;
+
+            const auto read_result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                               read,
+                                                               this->mFileDescriptor,
+                                                               &mReadAheadBuffer[number_of_bytes_buffered],
+                                                               read_chunk_size) ;
+
+            LIBSERIAL_STATISTICS(this->mStatistics.RecordRead(read_result)) ;
+
+            const auto error_number = errno ;
+
+            mReadAheadBuffer.resize(number_of_bytes_buffered +
+                                    static_cast<size_t>(std::max(read_result, static_cast<ssize_t>(0)))) ;
+
+            if (read_result == 0)
+            {
+                return_partial_line() ;
+                throw std::runtime_error(std::strerror(EIO)) ;
+            }
+
+            if ((read_result < 0) and
+                (error_number != EWOULDBLOCK))
+            {
+                return_partial_line() ;
+                throw std::runtime_error(std::strerror(error_number)) ;
+            }
+        }
+    }
+
+    inline
+    const uint8_t*
+    SerialPort::Implementation::FindLineTerminator(const uint8_t* begin,
+                                                   const uint8_t* const end,
+                                                   const char* const    lineTerminator,
+                                                   const size_t         terminatorSize)
+    {
+        // Scan for the first character of the terminator with memchr(),
+        // which the C library implements with vector instructions, (e.g.
+        // SSE2/AVX2 or NEON), and then compare any remaining characters.
+        const auto first_char = static_cast<unsigned char>(lineTerminator[0]) ;
+
+        while (static_cast<size_t>(end - begin) >= terminatorSize)
+        {
+            const auto candidate = static_cast<const uint8_t*>(
+                std::memchr(begin,
+                            first_char,
+                            static_cast<size_t>(end - begin) - terminatorSize + 1)) ;
+
+            if (candidate == nullptr)
+            {
+                return nullptr ;
+            }
+
+            if (std::memcmp(candidate + 1,
+                            lineTerminator + 1,
+                            terminatorSize - 1) == 0)
+            {
+                return candidate ;
+            }
+
+            begin = candidate + 1 ;
+        }
+
+        return nullptr ;
+    }
+
+    inline
+    size_t
+    SerialPort::Implementation::ReadFromReadAheadBuffer(void* const  dataBuffer,
+                                                        const size_t bufferSize)
+    {
+        const auto number_of_bytes = std::min(bufferSize,
+                                              this->GetNumberOfBytesReadAhead()) ;
+
+        if (number_of_bytes == 0)
+        {
+            return 0 ;
+        }
+
+        std::memcpy(dataBuffer,
+                    &mReadAheadBuffer[mReadAheadOffset],
+                    number_of_bytes) ;
+
+        mReadAheadOffset += number_of_bytes ;
+
+        if (mReadAheadOffset == mReadAheadBuffer.size())
+        {
+            this->DiscardReadAheadBuffer() ;
+        }
+
+        return number_of_bytes ;
+    }
+
+    inline
+    size_t
+    SerialPort::Implementation::GetNumberOfBytesReadAhead() const
+    {
+        return mReadAheadBuffer.size() - mReadAheadOffset ;
+    }
+
+    inline
+    std::string
+    SerialPort::Implementation::GetLatencyTimerPath() const
+    {
+        // Locate the device through its character device number, which is
+        // independent of the name or symbolic link it was opened through.
+        struct stat device_status {} ;
+
+        if (fstat(this->mFileDescriptor, &device_status) < 0)
+        {
+            return std::string() ;
+        }
+
+        return "/sys/dev/char/" +
+               std::to_string(major(device_status.st_rdev)) + ":" +
+               std::to_string(minor(device_status.st_rdev)) +
+               "/device/latency_timer" ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::RestoreLowLatency()
+    {
+        if (not mLowLatencySaved)
+        {
+            return ;
+        }
+
+        mLowLatencySaved = false ;
+
+        serial_struct serial_info {} ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (call_with_retry(ioctl,
+                            this->mFileDescriptor,
+                            TIOCGSERIAL,
+                            &serial_info) == 0)
+        {
+            // Only the low latency flag was changed by SetLowLatency().
+            serial_info.flags &= ~ASYNC_LOW_LATENCY ;                   // NOLINT (hicpp-signed-bitwise)
+            serial_info.flags |= (mOldSerialFlags & ASYNC_LOW_LATENCY) ; // NOLINT (hicpp-signed-bitwise)
+
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+            call_with_retry(ioctl,
+                            this->mFileDescriptor,
+                            TIOCSSERIAL,
+                            &serial_info) ;
+        }
+
+        if (not mOldLatencyTimer.empty())
+        {
+            std::ofstream latency_timer_file(this->GetLatencyTimerPath()) ;
+            latency_timer_file << mOldLatencyTimer ;
+        }
+    }
+
+    inline
+    void
+    SerialPort::Implementation::RestoreRS485Settings()
+    {
+        if (not mRS485SettingsSaved)
+        {
+            return ;
+        }
+
+        mRS485SettingsSaved = false ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        call_with_retry(ioctl,
+                        this->mFileDescriptor,
+                        TIOCSRS485,
+                        &mOldRS485Settings) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::DiscardReadAheadBuffer()
+    {
+        // Retain the capacity of the buffer for subsequent lines.
+        mReadAheadBuffer.clear() ;
+        mReadAheadOffset = 0 ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::Write(const DataBuffer& dataBuffer)
+    {
+        this->Write(dataBuffer.data(),
+                    dataBuffer.size()) ;
+    }
 
-            this->ReadByte(next_char,
-                           remaining_ms) ;
+    inline
+    void
+    SerialPort::Implementation::Write(const PooledDataBuffer& dataBuffer)
+    {
+        this->Write(dataBuffer.data(),
+                    dataBuffer.size()) ;
+    }
 
-            dataString += next_char ;
-        }
+    inline
+    void
+    SerialPort::Implementation::Write(const std::string& dataString)
+    {
+        this->Write(reinterpret_cast<const uint8_t*>(dataString.data()), // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                    dataString.size()) ;
     }
 
     inline
     void
-    SerialPort::Implementation::Write(const DataBuffer& dataBuffer)
+    SerialPort::Implementation::Write(const uint8_t* const dataBuffer,
+                                      const size_t         numberOfBytes)
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -2560,17 +4245,17 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        size_t number_of_bytes = dataBuffer.size() ;
-
-        // Nothing needs to be done if there is no data in the string.
-        if (number_of_bytes <= 0)
+        // Nothing needs to be done if there is no data in the buffer.
+        if (numberOfBytes <= 0)
         {
             return ;
         }
 
         // Local variables.
         size_t number_of_bytes_written = 0 ;
-        size_t number_of_bytes_remaining = number_of_bytes ;
+        size_t number_of_bytes_remaining = numberOfBytes ;
+
+        LIBSERIAL_STATISTICS(const auto write_start = std::chrono::steady_clock::now()) ;
 
         // Write the data to the serial port. Keep retrying if EAGAIN
         // error is received and EWOULDBLOCK is not received.
@@ -2578,15 +4263,18 @@ namespace LibSerial
 
         while (number_of_bytes_remaining > 0)
         {
-            write_result = call_with_retry(write,
-                                           this->mFileDescriptor,
-                                           &dataBuffer[number_of_bytes_written],
-                                           number_of_bytes_remaining) ;
+            write_result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                     write,
+                                                     this->mFileDescriptor,
+                                                     &dataBuffer[number_of_bytes_written],
+                                                     number_of_bytes_remaining) ;
+
+            LIBSERIAL_STATISTICS(this->mStatistics.RecordWrite(write_result)) ;
 
             if (write_result >= 0)
             {
                 number_of_bytes_written += write_result ;
-                number_of_bytes_remaining = number_of_bytes - number_of_bytes_written ;
+                number_of_bytes_remaining = numberOfBytes - number_of_bytes_written ;
 
                 if (number_of_bytes_remaining == 0)
                 {
@@ -2599,11 +4287,15 @@ namespace LibSerial
                 throw std::runtime_error(std::strerror(errno)) ;
             }
         }
+
+        LIBSERIAL_STATISTICS(this->mStatistics.RecordWriteCompletion(std::chrono::steady_clock::now() - write_start)) ;
     }
 
     inline
     void
-    SerialPort::Implementation::Write(const std::string& dataString)
+    SerialPort::Implementation::WriteWithChecksum(const uint8_t* const dataBuffer,
+                                                  const size_t         numberOfBytes,
+                                                  const ChecksumType   checksumType)
     {
         // Throw an exception if the serial port is not open.
         if (not this->IsOpen())
@@ -2611,45 +4303,105 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        size_t number_of_bytes = dataString.size() ;
+        uint8_t checksum[4] {} ; // NOLINT (cppcoreguidelines-avoid-c-arrays)
+
+        StoreChecksum(checksumType,
+                      ComputeChecksum(checksumType, dataBuffer, numberOfBytes),
+                      checksum) ;
 
-        // Nothing needs to be done if there is no data in the string.
-        if (number_of_bytes <= 0)
+        // NOLINTNEXTLINE (cppcoreguidelines-avoid-c-arrays)
+        const ConstBuffer buffers[] = {{dataBuffer, numberOfBytes},
+                                       {checksum, GetChecksumSize(checksumType)}} ;
+
+        this->WriteV(buffers,
+                     2) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::WriteV(const ConstBuffer* const buffers,
+                                       const size_t             numberOfBuffers)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
         {
-            return ;
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Local variables.
-        size_t number_of_bytes_written = 0 ;
-        size_t number_of_bytes_remaining = number_of_bytes ;
+        // The maximum number of buffers submitted with a single writev().
+        constexpr size_t max_iovec_count = 64 ;
 
-        // Write the data to the serial port. Keep retrying if EAGAIN
-        // error is received and EWOULDBLOCK is not received.
-        ssize_t write_result = 0 ;
+        iovec io_vector[max_iovec_count] {} ;
 
-        while (number_of_bytes_remaining > 0)
+        // The buffer currently being written and the number of bytes of
+        // that buffer already written.
+        size_t buffer_index = 0 ;
+        size_t buffer_offset = 0 ;
+
+        LIBSERIAL_STATISTICS(const auto write_start = std::chrono::steady_clock::now()) ;
+
+        while (buffer_index < numberOfBuffers)
         {
-            write_result = call_with_retry(write,
-                                           this->mFileDescriptor,
-                                           &dataString[number_of_bytes_written],
-                                           number_of_bytes_remaining) ;
+            // Gather the remaining data, skipping any empty buffers.
+            size_t iovec_count = 0 ;
 
-            if (write_result >= 0)
+            for (size_t i = buffer_index;
+                 (i < numberOfBuffers) and (iovec_count < max_iovec_count);
+                 i++)
             {
-                number_of_bytes_written += write_result ;
-                number_of_bytes_remaining = number_of_bytes - number_of_bytes_written ;
+                const size_t offset = (i == buffer_index) ? buffer_offset : 0 ;
 
-                if (number_of_bytes_remaining == 0)
+                if (buffers[i].size > offset)
                 {
-                    break ;
+                    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-const-cast)
+                    io_vector[iovec_count].iov_base = const_cast<uint8_t*>(&buffers[i].data[offset]) ;
+                    io_vector[iovec_count].iov_len  = buffers[i].size - offset ;
+                    iovec_count++ ;
                 }
             }
-            else if (write_result <= 0 &&
-                     errno != EWOULDBLOCK)
+
+            // Nothing needs to be done if there is no data left to write.
+            if (iovec_count == 0)
             {
-                throw std::runtime_error(std::strerror(errno)) ;
+                break ;
             }
+
+            // Write the data to the serial port. Keep retrying if EAGAIN
+            // error is received and EWOULDBLOCK is not received.
+            const auto write_result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                                writev,
+                                                                this->mFileDescriptor,
+                                                                io_vector,
+                                                                static_cast<int>(iovec_count)) ;
+
+            LIBSERIAL_STATISTICS(this->mStatistics.RecordWrite(write_result)) ;
+
+            if (write_result < 0)
+            {
+                if (errno != EWOULDBLOCK)
+                {
+                    throw std::runtime_error(std::strerror(errno)) ;
+                }
+
+                continue ;
+            }
+
+            // Advance past the data written, which may end part way
+            // through a buffer if the write was partial.
+            auto number_of_bytes_written = static_cast<size_t>(write_result) ;
+
+            while ((buffer_index < numberOfBuffers) and
+                   (number_of_bytes_written >= buffers[buffer_index].size - buffer_offset))
+            {
+                number_of_bytes_written -= buffers[buffer_index].size - buffer_offset ;
+                buffer_index++ ;
+                buffer_offset = 0 ;
+            }
+
+            buffer_offset += number_of_bytes_written ;
         }
+
+        LIBSERIAL_STATISTICS(this->mStatistics.RecordWriteCompletion(std::chrono::steady_clock::now() - write_start)) ;
     }
 
     inline
@@ -2666,12 +4418,17 @@ namespace LibSerial
         // error is received and EWOULDBLOCK is not received.
         ssize_t write_result = 0 ;
 
+        LIBSERIAL_STATISTICS(const auto write_start = std::chrono::steady_clock::now()) ;
+
         while (write_result <= 0)
         {
-            write_result = call_with_retry(write,
-                                           this->mFileDescriptor,
-                                           &charBuffer,
-                                           1) ;
+            write_result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                     write,
+                                                     this->mFileDescriptor,
+                                                     &charBuffer,
+                                                     1) ;
+
+            LIBSERIAL_STATISTICS(this->mStatistics.RecordWrite(write_result)) ;
 
             if (write_result == 1)
             {
@@ -2684,6 +4441,8 @@ namespace LibSerial
                 throw std::runtime_error(std::strerror(errno)) ;
             }
         }
+
+        LIBSERIAL_STATISTICS(this->mStatistics.RecordWriteCompletion(std::chrono::steady_clock::now() - write_start)) ;
     }
 
     inline
@@ -2700,12 +4459,17 @@ namespace LibSerial
         // error is received and EWOULDBLOCK is not received.
         ssize_t write_result = 0 ;
 
+        LIBSERIAL_STATISTICS(const auto write_start = std::chrono::steady_clock::now()) ;
+
         while (write_result <= 0)
         {
-            write_result = call_with_retry(write,
-                                           this->mFileDescriptor,
-                                           &charBuffer,
-                                           1) ;
+            write_result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                     write,
+                                                     this->mFileDescriptor,
+                                                     &charBuffer,
+                                                     1) ;
+
+            LIBSERIAL_STATISTICS(this->mStatistics.RecordWrite(write_result)) ;
 
             if (write_result == 1)
             {
@@ -2718,5 +4482,371 @@ namespace LibSerial
                 throw std::runtime_error(std::strerror(errno)) ;
             }
         }
+
+        LIBSERIAL_STATISTICS(this->mStatistics.RecordWriteCompletion(std::chrono::steady_clock::now() - write_start)) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::StartBackgroundReader(const size_t ringBufferSize)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        if (this->IsBackgroundReaderRunning())
+        {
+            throw std::logic_error(ERR_MSG_READER_RUNNING) ;
+        }
+
+        // Reclaim a reader thread that stopped because of an error.
+        this->StopBackgroundReader() ;
+
+        // A power of two size allows indices to be wrapped with a mask.
+        if ((ringBufferSize == 0) or
+            ((ringBufferSize & (ringBufferSize - 1)) != 0))
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_RING_SIZE) ;
+        }
+
+        mReaderStopEventFileDescriptor = eventfd(0, EFD_CLOEXEC) ;
+
+        if (mReaderStopEventFileDescriptor < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        mRingBuffer.assign(ringBufferSize, 0) ;
+        mRingBufferHead = 0 ;
+        mRingBufferTail = 0 ;
+        mRingBufferOverrunCount = 0 ;
+        mRingBufferHighWaterMark = 0 ;
+        mReaderErrorNumber = 0 ;
+        mReaderExited = false ;
+
+        mReaderThread = std::thread([this]()
+        {
+            this->BackgroundReaderLoop() ;
+            mReaderExited = true ;
+        }) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::StopBackgroundReader()
+    {
+        // A reader that stopped because of an error is still joined here.
+        if (not mReaderThread.joinable())
+        {
+            return ;
+        }
+
+        const uint64_t stop_event = 1 ;
+
+        // Wake the background reader thread from poll() and wait for it.
+        if (call_with_retry(write,
+                            mReaderStopEventFileDescriptor,
+                            &stop_event,
+                            sizeof(stop_event)) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        mReaderThread.join() ;
+
+        call_with_retry(close, mReaderStopEventFileDescriptor) ;
+        mReaderStopEventFileDescriptor = -1 ;
+    }
+
+    inline
+    bool
+    SerialPort::Implementation::IsBackgroundReaderRunning() const
+    {
+        return mReaderThread.joinable() and
+               not mReaderExited ;
+    }
+
+    inline
+    size_t
+    SerialPort::Implementation::ReadFromRingBuffer(uint8_t* const dataBuffer,
+                                                   const size_t   bufferSize)
+    {
+        const auto tail = mRingBufferTail.load(std::memory_order_relaxed) ;
+        const auto head = mRingBufferHead.load(std::memory_order_acquire) ;
+
+        const auto number_of_bytes = std::min(bufferSize, head - tail) ;
+
+        if (number_of_bytes == 0)
+        {
+            const auto error_number = mReaderErrorNumber.load() ;
+
+            if ((bufferSize > 0) and
+                (error_number != 0))
+            {
+                throw std::runtime_error(std::strerror(error_number)) ;
+            }
+
+            return 0 ;
+        }
+
+        // The data may wrap around the end of the ring buffer.
+        const auto ring_buffer_size = mRingBuffer.size() ;
+        const auto start_index = tail & (ring_buffer_size - 1) ;
+        const auto first_size = std::min(number_of_bytes, ring_buffer_size - start_index) ;
+
+        std::memcpy(dataBuffer,
+                    &mRingBuffer[start_index],
+                    first_size) ;
+        std::memcpy(&dataBuffer[first_size],
+                    mRingBuffer.data(),
+                    number_of_bytes - first_size) ;
+
+        mRingBufferTail.store(tail + number_of_bytes, std::memory_order_release) ;
+
+        return number_of_bytes ;
+    }
+
+    inline
+    size_t
+    SerialPort::Implementation::GetRingBufferLevel() const
+    {
+        return mRingBufferHead.load(std::memory_order_acquire) -
+               mRingBufferTail.load(std::memory_order_acquire) ;
+    }
+
+    inline
+    size_t
+    SerialPort::Implementation::GetRingBufferOverrunCount() const
+    {
+        return mRingBufferOverrunCount.load() ;
+    }
+
+    inline
+    size_t
+    SerialPort::Implementation::GetRingBufferHighWaterMark() const
+    {
+        return mRingBufferHighWaterMark.load() ;
+    }
+
+    inline
+    SerialPortStatistics
+    SerialPort::Implementation::GetStatistics() const
+    {
+        return mStatistics.GetSnapshot() ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::ResetStatistics()
+    {
+        mStatistics.Reset() ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::SetConcurrentMode(const bool concurrentMode)
+    {
+        if (concurrentMode and
+            (mCloseEventFileDescriptor < 0))
+        {
+            mCloseEventFileDescriptor = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) ; // NOLINT (hicpp-signed-bitwise)
+
+            if (mCloseEventFileDescriptor < 0)
+            {
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+        }
+
+        mConcurrentMode.store(concurrentMode, std::memory_order_release) ;
+    }
+
+    inline
+    bool
+    SerialPort::Implementation::IsConcurrentMode() const
+    {
+        return mConcurrentMode.load(std::memory_order_acquire) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::InterruptBlockedReads() const
+    {
+        if (not mConcurrentMode.load(std::memory_order_acquire))
+        {
+            return ;
+        }
+
+        const uint64_t close_event = 1 ;
+
+        if (call_with_retry(write,
+                            mCloseEventFileDescriptor,
+                            &close_event,
+                            sizeof(close_event)) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+    }
+
+    inline
+    void
+    SerialPort::Implementation::ClearBlockedReadsInterrupt() const
+    {
+        if (mCloseEventFileDescriptor < 0)
+        {
+            return ;
+        }
+
+        // The eventfd is non-blocking, so this fails with EAGAIN if no
+        // wakeup is pending.
+        uint64_t close_events = 0 ;
+        call_with_retry(read,
+                        mCloseEventFileDescriptor,
+                        &close_events,
+                        sizeof(close_events)) ;
+    }
+
+    inline
+    std::unique_lock<std::mutex>
+    SerialPort::Implementation::LockReadSide() const
+    {
+        if (not mConcurrentMode.load(std::memory_order_acquire))
+        {
+            return std::unique_lock<std::mutex>() ;
+        }
+
+        return std::unique_lock<std::mutex>(mReadMutex) ;
+    }
+
+    inline
+    std::unique_lock<std::mutex>
+    SerialPort::Implementation::LockWriteSide() const
+    {
+        if (not mConcurrentMode.load(std::memory_order_acquire))
+        {
+            return std::unique_lock<std::mutex>() ;
+        }
+
+        return std::unique_lock<std::mutex>(mWriteMutex) ;
+    }
+
+    inline
+    std::unique_lock<std::mutex>
+    SerialPort::Implementation::LockConfiguration() const
+    {
+        if (not mConcurrentMode.load(std::memory_order_acquire))
+        {
+            return std::unique_lock<std::mutex>() ;
+        }
+
+        return std::unique_lock<std::mutex>(mConfigurationMutex) ;
+    }
+
+    inline
+    void
+    SerialPort::Implementation::BackgroundReaderLoop()
+    {
+        const auto ring_buffer_size = mRingBuffer.size() ;
+
+        // Buffer used to drain the driver when the ring buffer is full.
+        constexpr size_t discard_buffer_size = 256 ;
+        uint8_t discard_buffer[discard_buffer_size] ; // NOLINT (cppcoreguidelines-avoid-c-arrays)
+
+        pollfd poll_fds[2] {} ; // NOLINT (cppcoreguidelines-avoid-c-arrays)
+        poll_fds[0].fd = this->mFileDescriptor ;
+        poll_fds[0].events = POLLIN ;
+        poll_fds[1].fd = mReaderStopEventFileDescriptor ;
+        poll_fds[1].events = POLLIN ;
+
+        while (true)
+        {
+            if (call_with_retry(poll, poll_fds, 2, -1) < 0)
+            {
+                mReaderErrorNumber = errno ;
+                return ;
+            }
+
+            if (poll_fds[1].revents != 0)
+            {
+                return ;
+            }
+
+            if (0 == (poll_fds[0].revents & POLLIN)) // NOLINT (hicpp-signed-bitwise)
+            {
+                mReaderErrorNumber = (poll_fds[0].revents & POLLNVAL) ? EBADF : EIO ; // NOLINT (hicpp-signed-bitwise)
+                return ;
+            }
+
+            const auto head = mRingBufferHead.load(std::memory_order_relaxed) ;
+            const auto tail = mRingBufferTail.load(std::memory_order_acquire) ;
+            const auto free_size = ring_buffer_size - (head - tail) ;
+
+            ssize_t read_result = 0 ;
+
+            if (free_size == 0)
+            {
+                // Keep the driver's buffer drained, counting the bytes lost.
+                read_result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                        read,
+                                                        this->mFileDescriptor,
+                                                        discard_buffer,
+                                                        discard_buffer_size) ;
+
+                LIBSERIAL_STATISTICS(this->mStatistics.RecordRead(read_result)) ;
+
+                if (read_result > 0)
+                {
+                    mRingBufferOverrunCount += static_cast<size_t>(read_result) ;
+                }
+            }
+            else
+            {
+                // Read directly into the free space, which may wrap around
+                // the end of the ring buffer.
+                const auto start_index = head & (ring_buffer_size - 1) ;
+                const auto first_size = std::min(free_size, ring_buffer_size - start_index) ;
+
+                iovec io_vector[2] {} ; // NOLINT (cppcoreguidelines-avoid-c-arrays)
+                io_vector[0].iov_base = &mRingBuffer[start_index] ;
+                io_vector[0].iov_len  = first_size ;
+                io_vector[1].iov_base = mRingBuffer.data() ;
+                io_vector[1].iov_len  = free_size - first_size ;
+
+                read_result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                        readv,
+                                                        this->mFileDescriptor,
+                                                        io_vector,
+                                                        (free_size > first_size) ? 2 : 1) ;
+
+                LIBSERIAL_STATISTICS(this->mStatistics.RecordRead(read_result)) ;
+
+                if (read_result > 0)
+                {
+                    const auto new_head = head + static_cast<size_t>(read_result) ;
+                    mRingBufferHead.store(new_head, std::memory_order_release) ;
+
+                    const auto level = new_head - tail ;
+
+                    if (level > mRingBufferHighWaterMark.load(std::memory_order_relaxed))
+                    {
+                        mRingBufferHighWaterMark.store(level, std::memory_order_relaxed) ;
+                    }
+                }
+            }
+
+            if (read_result == 0)
+            {
+                mReaderErrorNumber = EIO ;
+                return ;
+            }
+
+            if ((read_result < 0) and
+                (errno != EWOULDBLOCK))
+            {
+                mReaderErrorNumber = errno ;
+                return ;
+            }
+        }
     }
 } // namespace LibSerial
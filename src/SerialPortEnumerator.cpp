@@ -0,0 +1,629 @@
+/******************************************************************************
+ * @file SerialPortEnumerator.cpp                                             *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/SerialPortEnumerator.h"
+#include "libserial/SerialPortConstants.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace LibSerial
+{
+    /**
+     * @brief The netlink multicast group the kernel broadcasts uevents on.
+     */
+    constexpr unsigned int KERNEL_UEVENT_GROUP = 1 ;
+
+    /**
+     * @brief The size of the buffer used to receive a single uevent, which
+     *        the kernel limits to a few kilobytes.
+     */
+    constexpr size_t UEVENT_BUFFER_SIZE = 8192 ;
+
+    /**
+     * @brief The number of parent directories of a tty device searched for
+     *        the attributes of the USB device it belongs to. A USB serial
+     *        port sits below its interface, which sits below the USB device.
+     */
+    constexpr int MAX_USB_DEVICE_DEPTH = 3 ;
+
+    /**
+     * @brief SerialPortEnumerator::Implementation is the SerialPortEnumerator
+     *        implementation class.
+     */
+    class SerialPortEnumerator::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param sysfsTtyDirectory The sysfs tty class directory to read.
+         * @param deviceDirectory The directory holding the device nodes.
+         */
+        explicit Implementation(const std::string& sysfsTtyDirectory,
+                                const std::string& deviceDirectory) ;
+
+        /**
+         * @brief Default Destructor. Stops monitoring if it is active.
+         */
+        ~Implementation() noexcept ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Gets the serial ports currently present on the system.
+         * @return Returns the serial ports sorted by device name.
+         */
+        std::vector<SerialPortInfo> GetSerialPorts() const ;
+
+        /**
+         * @brief Gets information about a single tty device from sysfs.
+         * @param deviceName The kernel device name.
+         * @return Returns the port information.
+         */
+        SerialPortInfo GetSerialPortInfo(const std::string& deviceName) const ;
+
+        /**
+         * @brief Starts listening for serial port hotplug events.
+         */
+        void StartMonitoring() ;
+
+        /**
+         * @brief Stops listening for serial port hotplug events.
+         */
+        void StopMonitoring() ;
+
+        /**
+         * @brief Determines whether hotplug events are being monitored.
+         * @return Returns true if hotplug events are being monitored.
+         */
+        bool IsMonitoring() const ;
+
+        /**
+         * @brief Gets the monitor file descriptor.
+         * @return Returns the monitor file descriptor, or -1.
+         */
+        int GetMonitorFileDescriptor() const ;
+
+        /**
+         * @brief Waits for the next serial port hotplug event.
+         * @param msTimeout The timeout period in milliseconds, or zero to
+         *        block until an event is received.
+         * @return Returns the hotplug event.
+         */
+        SerialPortEvent ReadEvent(size_t msTimeout) ;
+
+    private:
+        /**
+         * @brief Determines whether a tty class entry describes a serial
+         *        port, i.e. whether it is backed by a device and, for legacy
+         *        UART ports, whether any hardware is actually present.
+         * @param ttyDirectory The sysfs directory of the tty device.
+         * @return Returns true if the entry describes a serial port.
+         */
+        static bool IsSerialPort(const std::string& ttyDirectory) ;
+
+        /**
+         * @brief Reads the first line of a sysfs attribute file, with any
+         *        trailing whitespace removed.
+         * @param fileName The attribute file to read.
+         * @return Returns the attribute value, or an empty string if the
+         *         attribute does not exist.
+         */
+        static std::string ReadAttribute(const std::string& fileName) ;
+
+        /**
+         * @brief Resolves a symbolic link to a canonical path.
+         * @param fileName The path to resolve.
+         * @return Returns the canonical path, or an empty string if the path
+         *         cannot be resolved.
+         */
+        static std::string ResolvePath(const std::string& fileName) ;
+
+        /**
+         * @brief Receives and parses one uevent from the netlink socket.
+         * @param portEvent Filled in if the uevent describes a tty device
+         *        being added or removed.
+         * @return Returns true if portEvent was filled in.
+         */
+        bool ReceiveEvent(SerialPortEvent& portEvent) const ;
+
+        /**
+         * @brief The sysfs tty class directory.
+         */
+        std::string mSysfsTtyDirectory ;
+
+        /**
+         * @brief The device node directory, ending with a '/'.
+         */
+        std::string mDeviceDirectory ;
+
+        /**
+         * @brief The netlink socket receiving kernel uevents, or -1.
+         */
+        int mMonitorFileDescriptor = -1 ;
+    } ;
+
+    SerialPortEnumerator::SerialPortEnumerator(const std::string& sysfsTtyDirectory,
+                                               const std::string& deviceDirectory)
+        : mImpl(new Implementation(sysfsTtyDirectory,
+                                   deviceDirectory))
+    {
+        /* Empty */
+    }
+
+    SerialPortEnumerator::~SerialPortEnumerator() noexcept = default ;
+
+    std::vector<SerialPortInfo>
+    SerialPortEnumerator::GetSerialPorts() const
+    {
+        return mImpl->GetSerialPorts() ;
+    }
+
+    SerialPortInfo
+    SerialPortEnumerator::GetSerialPortInfo(const std::string& deviceName) const
+    {
+        return mImpl->GetSerialPortInfo(deviceName) ;
+    }
+
+    void
+    SerialPortEnumerator::StartMonitoring()
+    {
+        mImpl->StartMonitoring() ;
+    }
+
+    void
+    SerialPortEnumerator::StopMonitoring()
+    {
+        mImpl->StopMonitoring() ;
+    }
+
+    bool
+    SerialPortEnumerator::IsMonitoring() const
+    {
+        return mImpl->IsMonitoring() ;
+    }
+
+    int
+    SerialPortEnumerator::GetMonitorFileDescriptor() const
+    {
+        return mImpl->GetMonitorFileDescriptor() ;
+    }
+
+    SerialPortEvent
+    SerialPortEnumerator::ReadEvent(const size_t msTimeout)
+    {
+        return mImpl->ReadEvent(msTimeout) ;
+    }
+
+    inline
+    SerialPortEnumerator::Implementation::Implementation(const std::string& sysfsTtyDirectory,
+                                                         const std::string& deviceDirectory)
+        : mSysfsTtyDirectory(sysfsTtyDirectory)
+        , mDeviceDirectory(deviceDirectory)
+    {
+        if (mDeviceDirectory.empty() or
+            (mDeviceDirectory.back() != '/'))
+        {
+            mDeviceDirectory += '/' ;
+        }
+    }
+
+    inline
+    SerialPortEnumerator::Implementation::~Implementation() noexcept
+    {
+        this->StopMonitoring() ;
+    }
+
+    inline
+    std::vector<SerialPortInfo>
+    SerialPortEnumerator::Implementation::GetSerialPorts() const
+    {
+        std::vector<SerialPortInfo> serial_ports {} ;
+
+        auto* const tty_directory = opendir(mSysfsTtyDirectory.c_str()) ;
+
+        if (tty_directory == nullptr)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        while (const auto* const directory_entry = readdir(tty_directory)) // NOLINT (concurrency-mt-unsafe)
+        {
+            const std::string device_name = directory_entry->d_name ;
+
+            if ((device_name == ".") or
+                (device_name == "..") or
+                (not IsSerialPort(mSysfsTtyDirectory + "/" + device_name)))
+            {
+                continue ;
+            }
+
+            serial_ports.push_back(this->GetSerialPortInfo(device_name)) ;
+        }
+
+        closedir(tty_directory) ;
+
+        std::sort(serial_ports.begin(),
+                  serial_ports.end(),
+                  [](const SerialPortInfo& lhs, const SerialPortInfo& rhs)
+                  {
+                      return lhs.deviceName < rhs.deviceName ;
+                  }) ;
+
+        return serial_ports ;
+    }
+
+    inline
+    SerialPortInfo
+    SerialPortEnumerator::Implementation::GetSerialPortInfo(const std::string& deviceName) const
+    {
+        SerialPortInfo port_info {} ;
+        port_info.deviceName = deviceName ;
+        port_info.devicePath = mDeviceDirectory + deviceName ;
+
+        const auto device_directory = ResolvePath(mSysfsTtyDirectory + "/" + deviceName + "/device") ;
+
+        if (device_directory.empty())
+        {
+            return port_info ;
+        }
+
+        const auto driver_directory = ResolvePath(device_directory + "/driver") ;
+        port_info.driver = driver_directory.substr(driver_directory.find_last_of('/') + 1) ;
+
+        // The USB device attributes live in an ancestor of the tty device:
+        // the USB interface for usb-serial drivers, or the USB device itself
+        // for ACM and some vendor specific drivers.
+        auto usb_directory = device_directory ;
+
+        for (int depth = 0 ; depth < MAX_USB_DEVICE_DEPTH ; ++depth)
+        {
+            auto vendor_id = ReadAttribute(usb_directory + "/idVendor") ;
+
+            if (not vendor_id.empty())
+            {
+                port_info.vendorId     = std::move(vendor_id) ;
+                port_info.productId    = ReadAttribute(usb_directory + "/idProduct") ;
+                port_info.manufacturer = ReadAttribute(usb_directory + "/manufacturer") ;
+                port_info.product      = ReadAttribute(usb_directory + "/product") ;
+                port_info.serialNumber = ReadAttribute(usb_directory + "/serial") ;
+                break ;
+            }
+
+            const auto separator = usb_directory.find_last_of('/') ;
+
+            if ((separator == std::string::npos) or
+                (separator == 0))
+            {
+                break ;
+            }
+
+            usb_directory.resize(separator) ;
+        }
+
+        return port_info ;
+    }
+
+    inline
+    void
+    SerialPortEnumerator::Implementation::StartMonitoring()
+    {
+        if (this->IsMonitoring())
+        {
+            return ;
+        }
+
+        // NOLINTNEXTLINE (hicpp-signed-bitwise)
+        const auto socket_descriptor = socket(AF_NETLINK,
+                                              SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK,
+                                              NETLINK_KOBJECT_UEVENT) ;
+
+        if (socket_descriptor < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        sockaddr_nl socket_address {} ;
+        socket_address.nl_family = AF_NETLINK ;
+        socket_address.nl_groups = KERNEL_UEVENT_GROUP ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+        if (bind(socket_descriptor,
+                 reinterpret_cast<sockaddr*>(&socket_address),
+                 sizeof(socket_address)) < 0)
+        {
+            const auto error_number = errno ;
+            close(socket_descriptor) ;
+            throw std::runtime_error(std::strerror(error_number)) ;
+        }
+
+        mMonitorFileDescriptor = socket_descriptor ;
+    }
+
+    inline
+    void
+    SerialPortEnumerator::Implementation::StopMonitoring()
+    {
+        if (not this->IsMonitoring())
+        {
+            return ;
+        }
+
+        close(mMonitorFileDescriptor) ;
+        mMonitorFileDescriptor = -1 ;
+    }
+
+    inline
+    bool
+    SerialPortEnumerator::Implementation::IsMonitoring() const
+    {
+        return mMonitorFileDescriptor >= 0 ;
+    }
+
+    inline
+    int
+    SerialPortEnumerator::Implementation::GetMonitorFileDescriptor() const
+    {
+        return mMonitorFileDescriptor ;
+    }
+
+    inline
+    SerialPortEvent
+    SerialPortEnumerator::Implementation::ReadEvent(const size_t msTimeout)
+    {
+        if (not this->IsMonitoring())
+        {
+            throw std::logic_error(ERR_MSG_MONITOR_NOT_STARTED) ;
+        }
+
+        using namespace std::chrono ;
+
+        const auto deadline = steady_clock::now() + milliseconds(msTimeout) ;
+
+        while (true)
+        {
+            SerialPortEvent port_event {} ;
+
+            if (this->ReceiveEvent(port_event))
+            {
+                return port_event ;
+            }
+
+            // Nothing pending, (or only uevents of other subsystems), so
+            // wait for the socket to become readable again.
+            int poll_timeout = -1 ;
+
+            if (msTimeout > 0)
+            {
+                const auto remaining = duration_cast<milliseconds>(deadline - steady_clock::now()).count() ;
+
+                if (remaining <= 0)
+                {
+                    throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+                }
+
+                poll_timeout = static_cast<int>(std::min<decltype(remaining)>(remaining, INT_MAX)) ;
+            }
+
+            pollfd poll_descriptor {mMonitorFileDescriptor, POLLIN, 0} ;
+
+            const auto result = poll(&poll_descriptor, 1, poll_timeout) ;
+
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue ;
+                }
+
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            if (result == 0)
+            {
+                throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+            }
+        }
+    }
+
+    inline
+    bool
+    SerialPortEnumerator::Implementation::IsSerialPort(const std::string& ttyDirectory)
+    {
+        // Virtual terminals, ptys and the console have no backing device.
+        if (ResolvePath(ttyDirectory + "/device").empty())
+        {
+            return false ;
+        }
+
+        // The 8250 driver registers ttyS ports whether or not a UART is
+        // present and reports the missing ones as PORT_UNKNOWN, (0).
+        const auto port_type = ReadAttribute(ttyDirectory + "/type") ;
+
+        return port_type != "0" ;
+    }
+
+    inline
+    std::string
+    SerialPortEnumerator::Implementation::ReadAttribute(const std::string& fileName)
+    {
+        std::ifstream attribute_file(fileName) ;
+        std::string attribute_value {} ;
+
+        if (not std::getline(attribute_file, attribute_value))
+        {
+            return std::string() ;
+        }
+
+        const auto last_character = attribute_value.find_last_not_of(" \t\r\n") ;
+        attribute_value.resize(last_character == std::string::npos ? 0 : last_character + 1) ;
+
+        return attribute_value ;
+    }
+
+    inline
+    std::string
+    SerialPortEnumerator::Implementation::ResolvePath(const std::string& fileName)
+    {
+        std::array<char, PATH_MAX> resolved_path {} ;
+
+        if (realpath(fileName.c_str(), resolved_path.data()) == nullptr)
+        {
+            return std::string() ;
+        }
+
+        return std::string(resolved_path.data()) ;
+    }
+
+    inline
+    bool
+    SerialPortEnumerator::Implementation::ReceiveEvent(SerialPortEvent& portEvent) const
+    {
+        std::array<char, UEVENT_BUFFER_SIZE> uevent_buffer {} ;
+        sockaddr_nl sender_address {} ;
+        socklen_t address_length = sizeof(sender_address) ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto bytes_received = recvfrom(mMonitorFileDescriptor,
+                                             uevent_buffer.data(),
+                                             uevent_buffer.size() - 1,
+                                             0,
+                                             reinterpret_cast<sockaddr*>(&sender_address),
+                                             &address_length) ;
+
+        if (bytes_received < 0)
+        {
+            if ((errno == EWOULDBLOCK) or
+                (errno == EINTR) or
+                (errno == ENOBUFS))
+            {
+                // ENOBUFS means that events were dropped; the caller may
+                // call GetSerialPorts() to resynchronize.
+                return false ;
+            }
+
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        // Only trust messages sent by the kernel itself.
+        if (sender_address.nl_pid != 0)
+        {
+            return false ;
+        }
+
+        // A uevent is a "action@devpath" header followed by NUL separated
+        // KEY=value pairs.
+        std::string action {} ;
+        std::string subsystem {} ;
+        std::string device_name {} ;
+
+        const auto* position = uevent_buffer.data() ;
+        const auto* const end = uevent_buffer.data() + bytes_received ;
+
+        while (position < end)
+        {
+            const std::string field(position) ;
+            position += field.size() + 1 ;
+
+            if (field.compare(0, 7, "ACTION=") == 0)
+            {
+                action = field.substr(7) ;
+            }
+            else if (field.compare(0, 10, "SUBSYSTEM=") == 0)
+            {
+                subsystem = field.substr(10) ;
+            }
+            else if (field.compare(0, 8, "DEVNAME=") == 0)
+            {
+                device_name = field.substr(8) ;
+            }
+        }
+
+        if ((subsystem != "tty") or
+            device_name.empty())
+        {
+            return false ;
+        }
+
+        if (action == "add")
+        {
+            if (not IsSerialPort(mSysfsTtyDirectory + "/" + device_name))
+            {
+                return false ;
+            }
+
+            portEvent.eventType = SerialPortEventType::PORT_ADDED ;
+            portEvent.portInfo  = this->GetSerialPortInfo(device_name) ;
+            return true ;
+        }
+
+        if (action == "remove")
+        {
+            portEvent.eventType           = SerialPortEventType::PORT_REMOVED ;
+            portEvent.portInfo.deviceName = device_name ;
+            portEvent.portInfo.devicePath = mDeviceDirectory + device_name ;
+            return true ;
+        }
+
+        return false ;
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,1899 @@
+/******************************************************************************
+ * @file SerialPortReactor.cpp                                                *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/SerialPortReactor.h"
+#include "ModemLineWait.h"
+#include "TransmitQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace LibSerial
+{
+    /**
+     * @brief The maximum number of events retrieved by a single call to
+     *        epoll_wait(). Keeping this small lets several threads in Run()
+     *        share the load when many ports become ready at once.
+     */
+    constexpr int MAX_EVENTS_PER_WAIT = 16 ;
+
+    /**
+     * @brief The default modem line sampling interval in milliseconds.
+     */
+    constexpr size_t MODEM_LINE_POLL_INTERVAL_DEFAULT = 10 ;
+
+    /**
+     * @brief The epoll user data value identifying the stop event descriptor.
+     *        Port handles start at one so they never collide with it.
+     */
+    constexpr SerialPortReactor::PortId STOP_EVENT_ID = 0 ;
+
+    /**
+     * @brief The epoll user data value identifying the timer descriptor.
+     *        Port handles are allocated upwards from one and never reach it.
+     */
+    constexpr SerialPortReactor::PortId TIMER_EVENT_ID = std::numeric_limits<SerialPortReactor::PortId>::max() ;
+
+    /**
+     * @brief The epoll user data value identifying the modem line event
+     *        descriptor, signaled by the threads waiting in TIOCMIWAIT.
+     */
+    constexpr SerialPortReactor::PortId MODEM_LINE_EVENT_ID = TIMER_EVENT_ID - 1 ;
+
+    /**
+     * @brief SerialPortReactor::Implementation is the SerialPortReactor
+     *        implementation class.
+     */
+    class SerialPortReactor::Implementation
+    {
+    public:
+        /**
+         * @brief Default Constructor.
+         */
+        Implementation() ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        ~Implementation() noexcept ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Transfers ownership of an open port to the reactor.
+         * @param port The port to be managed by the reactor.
+         * @param callbacks The callbacks to invoke for the port.
+         * @return Returns the handle identifying the port.
+         */
+        template <typename PortType>
+        PortId Add(std::unique_ptr<PortType>   port,
+                   const Callbacks<PortType>& callbacks) ;
+
+        /**
+         * @brief Removes a port from the reactor and closes it.
+         * @param portId The handle of the port to be removed.
+         */
+        void Remove(PortId portId) ;
+
+        /**
+         * @brief Gets a port owned by the reactor.
+         * @param portId The handle returned when the port was added.
+         * @return Returns a reference to the port.
+         */
+        template <typename PortType>
+        PortType& GetPort(PortId portId) ;
+
+        /**
+         * @brief Gets the number of ports owned by the reactor.
+         * @return Returns the number of ports owned by the reactor.
+         */
+        size_t GetNumberOfPorts() const ;
+
+        /**
+         * @brief Enables or disables dispatching of the writable callback.
+         * @param portId The handle of the port.
+         * @param writableInterest True to dispatch writable callbacks.
+         */
+        void SetWritableInterest(PortId portId,
+                                 bool   writableInterest) ;
+
+        /**
+         * @brief Sets the transmit queue depth at or below which the writable
+         *        callback is dispatched.
+         * @param portId The handle of the port.
+         * @param writableThreshold The transmit queue depth in bytes.
+         */
+        void SetWritableThreshold(PortId portId,
+                                  size_t writableThreshold) ;
+
+        /**
+         * @brief Enables or disables dispatching of the data-ready callback.
+         * @param portId The handle of the port.
+         * @param readableInterest True to dispatch data-ready callbacks.
+         */
+        void SetReadableInterest(PortId portId,
+                                 bool   readableInterest) ;
+
+        /**
+         * @brief Starts a one-shot timer.
+         * @param msDelay The delay in milliseconds.
+         * @param callback The callback to invoke when the timer expires.
+         * @return Returns the handle identifying the timer.
+         */
+        TimerId StartTimer(size_t                       msDelay,
+                           const std::function<void()>& callback) ;
+
+        /**
+         * @brief Cancels a timer.
+         * @param timerId The handle of the timer.
+         * @return Returns true if the timer was cancelled before it expired.
+         */
+        bool CancelTimer(TimerId timerId) ;
+
+        /**
+         * @brief Sets the modem line sampling interval.
+         * @param msInterval The sampling interval in milliseconds.
+         */
+        void SetModemLinePollInterval(size_t msInterval) ;
+
+        /**
+         * @brief Dispatches events until Stop() is called.
+         */
+        void Run() ;
+
+        /**
+         * @brief Waits for and dispatches a single round of events.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t RunOnce(size_t msTimeout) ;
+
+        /**
+         * @brief Causes all threads in Run() to return.
+         */
+        void Stop() ;
+
+    private:
+
+        /**
+         * @brief The state kept by the reactor for each port it owns.
+         */
+        class PortEntry
+        {
+        public:
+            /**
+             * @brief Destructor, closes the descriptor of the modem line
+             *        watcher thread.
+             */
+            virtual ~PortEntry()
+            {
+                if (mModemLineEventFileDescriptor >= 0)
+                {
+                    close(mModemLineEventFileDescriptor) ;
+                }
+            }
+
+            /**
+             * @brief Invokes the data-ready callback, if any.
+             * @return Returns true iff a callback was invoked.
+             */
+            virtual bool OnDataReady() = 0 ;
+
+            /**
+             * @brief Invokes the writable callback, if any.
+             * @return Returns true iff a callback was invoked.
+             */
+            virtual bool OnWritable() = 0 ;
+
+            /**
+             * @brief Invokes the modem line change callback, if any.
+             * @param modemLineState The current state of the modem lines.
+             * @return Returns true iff a callback was invoked.
+             */
+            virtual bool OnModemLineChange(int modemLineState) = 0 ;
+
+            /**
+             * @brief Invokes the hang-up callback, if any.
+             * @return Returns true iff a callback was invoked.
+             */
+            virtual bool OnHangUp() = 0 ;
+
+            /**
+             * @brief Determines if a data-ready callback has been provided.
+             * @return Returns true iff a data-ready callback has been provided.
+             */
+            virtual bool HasDataReadyCallback() const = 0 ;
+
+            /**
+             * @brief Determines if a modem line change callback has been provided.
+             * @return Returns true iff a modem line change callback has been provided.
+             */
+            virtual bool HasModemLineChangeCallback() const = 0 ;
+
+            /**
+             * @brief Interrupts and joins the modem line watcher thread, if
+             *        it has been started.
+             */
+            void StopModemLineWatcher()
+            {
+                if (not mModemLineWatcher.joinable())
+                {
+                    return ;
+                }
+
+                if (InterruptModemLineWait(mModemLineWatcher.native_handle(),
+                                           mModemLineWatcherStopRequested,
+                                           mModemLineWatcherFinished))
+                {
+                    mModemLineWatcher.join() ;
+                    return ;
+                }
+
+                // The watcher holds a reference to this entry and returns
+                // without touching the reactor once a line changes.
+                mModemLineWatcher.detach() ;
+            }
+
+            /**
+             * The handle identifying the port.
+             */
+            PortId mPortId = STOP_EVENT_ID ;
+
+            /**
+             * The file descriptor of the port.
+             */
+            int mFileDescriptor = -1 ;
+
+            /**
+             * Held while a callback for the port is running so that events
+             * for a port are never dispatched on two threads at once.
+             */
+            std::mutex mDispatchMutex {} ;
+
+            /**
+             * True if the writable callback should be dispatched.
+             */
+            std::atomic<bool> mWritableInterest {false} ;
+
+            /**
+             * The transmit queue depth at or below which the writable
+             * callback is dispatched.
+             */
+            std::atomic<size_t> mWritableThreshold {std::numeric_limits<size_t>::max()} ;
+
+            /**
+             * True while the writable callback is held back by a timer until
+             * the transmit queue is expected to have drained to the threshold.
+             */
+            std::atomic<bool> mWritableDeferred {false} ;
+
+            /**
+             * True if the data-ready callback should be dispatched.
+             */
+            std::atomic<bool> mReadableInterest {true} ;
+
+            /**
+             * True once the port has been removed from the reactor.
+             */
+            std::atomic<bool> mRemoved {false} ;
+
+            /**
+             * True once a hang-up or error condition has been reported.
+             */
+            std::atomic<bool> mHungUp {false} ;
+
+            /**
+             * The last sampled state of the modem input lines.
+             */
+            int mModemLineState = 0 ;
+
+            /**
+             * The modem line counters when the lines were last sampled.
+             */
+            ModemLineCounters mModemLineCounters {} ;
+
+            /**
+             * True if the modem lines are sampled periodically because the
+             * driver cannot report changes with TIOCMIWAIT. Only changed with
+             * the reactor mutex held.
+             */
+            std::atomic<bool> mModemLinePolled {false} ;
+
+            /**
+             * The thread blocked in TIOCMIWAIT on behalf of the port.
+             */
+            std::thread mModemLineWatcher {} ;
+
+            /**
+             * Set to make the modem line watcher thread return.
+             */
+            std::atomic<bool> mModemLineWatcherStopRequested {false} ;
+
+            /**
+             * Set by the modem line watcher thread once it has returned.
+             */
+            std::atomic<bool> mModemLineWatcherFinished {false} ;
+
+            /**
+             * A duplicate of the modem line event descriptor of the reactor
+             * signaled by the watcher thread, so that it remains valid for
+             * a watcher that could not be stopped.
+             */
+            int mModemLineEventFileDescriptor = -1 ;
+
+            /**
+             * True if the modem line watcher thread has reported a change
+             * that has not yet been dispatched.
+             */
+            std::atomic<bool> mModemLineEventPending {false} ;
+
+            /**
+             * True once TIOCMIWAIT has failed for the port.
+             */
+            std::atomic<bool> mModemLineWatchFailed {false} ;
+        } ;
+
+        /**
+         * @brief PortEntry specialization holding a port of a given type
+         *        together with its callbacks.
+         */
+        template <typename PortType>
+        class TypedPortEntry : public PortEntry
+        {
+        public:
+            /**
+             * @brief Constructor.
+             * @param port The port being managed.
+             * @param callbacks The callbacks to invoke for the port.
+             */
+            TypedPortEntry(std::unique_ptr<PortType>   port,
+                           const Callbacks<PortType>& callbacks)
+                : mPort(std::move(port))
+                , mCallbacks(callbacks)
+            {
+                /* Empty */
+            }
+
+            /**
+             * @brief Destructor. The modem line watcher thread is stopped
+             *        before the port it waits on is closed.
+             */
+            ~TypedPortEntry() override
+            {
+                this->StopModemLineWatcher() ;
+            }
+
+            /**
+             * @brief Copy construction is disallowed.
+             */
+            TypedPortEntry(const TypedPortEntry& otherTypedPortEntry) = delete ;
+
+            /**
+             * @brief Move construction is disallowed.
+             */
+            TypedPortEntry(TypedPortEntry&& otherTypedPortEntry) = delete ;
+
+            /**
+             * @brief Copy assignment is disallowed.
+             */
+            TypedPortEntry& operator=(const TypedPortEntry& otherTypedPortEntry) = delete ;
+
+            /**
+             * @brief Move assignment is disallowed.
+             */
+            TypedPortEntry& operator=(TypedPortEntry&& otherTypedPortEntry) = delete ;
+
+            bool OnDataReady() override
+            {
+                return Invoke(mCallbacks.dataReady) ;
+            }
+
+            bool OnWritable() override
+            {
+                return Invoke(mCallbacks.writable) ;
+            }
+
+            bool OnModemLineChange(const int modemLineState) override
+            {
+                if (not mCallbacks.modemLineChange)
+                {
+                    return false ;
+                }
+
+                mCallbacks.modemLineChange(mPortId, *mPort, modemLineState) ;
+                return true ;
+            }
+
+            bool OnHangUp() override
+            {
+                return Invoke(mCallbacks.hangUp) ;
+            }
+
+            bool HasDataReadyCallback() const override
+            {
+                return static_cast<bool>(mCallbacks.dataReady) ;
+            }
+
+            bool HasModemLineChangeCallback() const override
+            {
+                return static_cast<bool>(mCallbacks.modemLineChange) ;
+            }
+
+            /**
+             * The port being managed.
+             */
+            std::unique_ptr<PortType> mPort ;
+
+            /**
+             * The callbacks to invoke for the port.
+             */
+            Callbacks<PortType> mCallbacks ;
+
+        private:
+
+            /**
+             * @brief Invokes the specified callback if it is not empty.
+             * @param callback The callback to be invoked.
+             * @return Returns true iff the callback was invoked.
+             */
+            bool Invoke(const std::function<void(PortId, PortType&)>& callback)
+            {
+                if (not callback)
+                {
+                    return false ;
+                }
+
+                callback(mPortId, *mPort) ;
+                return true ;
+            }
+        } ;
+
+        /**
+         * @brief Finds the entry of the specified port.
+         * @param portId The handle of the port.
+         * @return Returns the entry of the port.
+         */
+        std::shared_ptr<PortEntry> FindPortEntry(PortId portId) const ;
+
+        /**
+         * @brief Registers or re-arms the port with epoll.
+         * @param portEntry The entry of the port.
+         * @param epollOperation EPOLL_CTL_ADD or EPOLL_CTL_MOD.
+         */
+        void ArmPortEntry(PortEntry& portEntry,
+                          int        epollOperation) const ;
+
+        /**
+         * @brief Invokes the callbacks matching the events reported for a port.
+         * @param portEntry The entry of the port.
+         * @param events The epoll events reported for the port.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t DispatchPortEvents(PortEntry& portEntry,
+                                  uint32_t   events) ;
+
+        /**
+         * @brief Determines if the transmit queue of a port is at or below
+         *        its writable threshold. If not, writable events are held
+         *        back by a timer that expires once the excess is expected
+         *        to have been transmitted.
+         * @param portEntry The entry of the port.
+         * @return Returns true iff the writable callback may be dispatched.
+         */
+        bool CheckWritableThreshold(PortEntry& portEntry) ;
+
+        /**
+         * @brief Invokes the callbacks of all expired timers and re-arms the
+         *        timer descriptor for the next one.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t DispatchTimers() ;
+
+        /**
+         * @brief Arms the timer descriptor for the earliest pending timer, or
+         *        disarms it if no timers are pending. Must be called with the
+         *        timer mutex held.
+         */
+        void ArmTimerDescriptor() ;
+
+        /**
+         * @brief Body of the modem line watcher thread of a port, which waits
+         *        in TIOCMIWAIT and signals the modem line event descriptor
+         *        whenever one of the modem input lines changes.
+         * @param portEntry The entry of the port.
+         */
+        static void WatchModemLines(PortEntry& portEntry) ;
+
+        /**
+         * @brief Samples the modem input lines of a port and invokes its
+         *        modem line change callback if they changed. Must be called
+         *        with the dispatch mutex of the port held.
+         * @param portEntry The entry of the port.
+         * @return Returns true iff a callback was invoked.
+         */
+        static bool SampleModemLines(PortEntry& portEntry) ;
+
+        /**
+         * @brief Dispatches the modem line changes reported by the modem line
+         *        watcher threads.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t DispatchModemLineEvents() ;
+
+        /**
+         * @brief Samples the modem input lines of each port whose driver
+         *        does not support TIOCMIWAIT and dispatches any changes.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t DispatchModemLineChanges() ;
+
+        /**
+         * @brief Gets the epoll_wait() timeout to use before the next modem
+         *        line sample is due.
+         * @param msTimeout The epoll_wait() timeout requested by the caller.
+         * @return Returns the epoll_wait() timeout in milliseconds.
+         */
+        int GetModemLineWaitTimeout(int msTimeout) const ;
+
+        /**
+         * @brief Waits for and dispatches events without tracking the number
+         *        of threads running the reactor.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t DispatchEvents(size_t msTimeout) ;
+
+        /**
+         * @brief Records that a thread has started running the reactor.
+         */
+        void EnterRun() ;
+
+        /**
+         * @brief Records that a thread has stopped running the reactor and
+         *        clears any pending stop request once no threads remain.
+         */
+        void LeaveRun() ;
+
+        /**
+         * The epoll file descriptor.
+         */
+        int mEpollFileDescriptor = -1 ;
+
+        /**
+         * The eventfd used to wake threads blocked in epoll_wait().
+         */
+        int mStopEventFileDescriptor = -1 ;
+
+        /**
+         * The timerfd signaled when the earliest pending timer expires.
+         */
+        int mTimerFileDescriptor = -1 ;
+
+        /**
+         * The eventfd signaled by the modem line watcher threads.
+         */
+        int mModemLineEventFileDescriptor = -1 ;
+
+        /**
+         * Protects the timers.
+         */
+        std::mutex mTimerMutex {} ;
+
+        /**
+         * The callbacks of the pending timers, indexed by handle.
+         */
+        std::map<TimerId, std::function<void()>> mTimerCallbacks {} ;
+
+        /**
+         * The pending timers ordered by expiry time. Entries of cancelled
+         * timers are discarded when they reach the front.
+         */
+        std::multimap<std::chrono::steady_clock::time_point, TimerId> mTimerQueue {} ;
+
+        /**
+         * The handle that will be assigned to the next timer started.
+         */
+        TimerId mNextTimerId = 1 ;
+
+        /**
+         * Protects the port entries and the thread count.
+         */
+        mutable std::mutex mMutex {} ;
+
+        /**
+         * The ports owned by the reactor, indexed by handle.
+         */
+        std::map<PortId, std::shared_ptr<PortEntry>> mPortEntries {} ;
+
+        /**
+         * The handle that will be assigned to the next port added.
+         */
+        PortId mNextPortId = STOP_EVENT_ID + 1 ;
+
+        /**
+         * The number of threads currently running the reactor.
+         */
+        size_t mNumberOfRunningThreads = 0 ;
+
+        /**
+         * The number of ports whose modem lines are sampled periodically.
+         */
+        std::atomic<size_t> mNumberOfModemLinePorts {0} ;
+
+        /**
+         * True once Stop() has been called.
+         */
+        std::atomic<bool> mStopRequested {false} ;
+
+        /**
+         * Held by the thread sampling the modem lines.
+         */
+        std::mutex mModemLineMutex {} ;
+
+        /**
+         * The modem line sampling interval in milliseconds.
+         */
+        std::atomic<size_t> mModemLinePollInterval {MODEM_LINE_POLL_INTERVAL_DEFAULT} ;
+
+        /**
+         * The time at which the modem lines are next due to be sampled in
+         * steady_clock ticks.
+         */
+        std::atomic<std::chrono::steady_clock::rep> mNextModemLineSample {0} ;
+    } ;
+
+    SerialPortReactor::SerialPortReactor()
+        : mImpl(new Implementation())
+    {
+        /* Empty */
+    }
+
+    SerialPortReactor::~SerialPortReactor() noexcept = default ;
+
+    SerialPortReactor::PortId
+    SerialPortReactor::Add(std::unique_ptr<SerialPort>   serialPort,
+                           const Callbacks<SerialPort>& callbacks)
+    {
+        return mImpl->Add(std::move(serialPort),
+                          callbacks) ;
+    }
+
+    SerialPortReactor::PortId
+    SerialPortReactor::Add(std::unique_ptr<SerialStream>   serialStream,
+                           const Callbacks<SerialStream>& callbacks)
+    {
+        return mImpl->Add(std::move(serialStream),
+                          callbacks) ;
+    }
+
+    void
+    SerialPortReactor::Remove(const PortId portId)
+    {
+        mImpl->Remove(portId) ;
+    }
+
+    SerialPort&
+    SerialPortReactor::GetSerialPort(const PortId portId)
+    {
+        return mImpl->GetPort<SerialPort>(portId) ;
+    }
+
+    SerialStream&
+    SerialPortReactor::GetSerialStream(const PortId portId)
+    {
+        return mImpl->GetPort<SerialStream>(portId) ;
+    }
+
+    size_t
+    SerialPortReactor::GetNumberOfPorts() const
+    {
+        return mImpl->GetNumberOfPorts() ;
+    }
+
+    void
+    SerialPortReactor::SetWritableInterest(const PortId portId,
+                                           const bool   writableInterest)
+    {
+        mImpl->SetWritableInterest(portId,
+                                   writableInterest) ;
+    }
+
+    void
+    SerialPortReactor::SetWritableThreshold(const PortId portId,
+                                            const size_t writableThreshold)
+    {
+        mImpl->SetWritableThreshold(portId,
+                                    writableThreshold) ;
+    }
+
+    void
+    SerialPortReactor::SetReadableInterest(const PortId portId,
+                                           const bool   readableInterest)
+    {
+        mImpl->SetReadableInterest(portId,
+                                   readableInterest) ;
+    }
+
+    SerialPortReactor::TimerId
+    SerialPortReactor::StartTimer(const size_t                 msDelay,
+                                  const std::function<void()>& callback)
+    {
+        return mImpl->StartTimer(msDelay,
+                                 callback) ;
+    }
+
+    bool
+    SerialPortReactor::CancelTimer(const TimerId timerId)
+    {
+        return mImpl->CancelTimer(timerId) ;
+    }
+
+    void
+    SerialPortReactor::SetModemLinePollInterval(const size_t msInterval)
+    {
+        mImpl->SetModemLinePollInterval(msInterval) ;
+    }
+
+    void
+    SerialPortReactor::Run()
+    {
+        mImpl->Run() ;
+    }
+
+    size_t
+    SerialPortReactor::RunOnce(const size_t msTimeout)
+    {
+        return mImpl->RunOnce(msTimeout) ;
+    }
+
+    void
+    SerialPortReactor::Stop()
+    {
+        mImpl->Stop() ;
+    }
+
+    inline
+    SerialPortReactor::Implementation::Implementation()
+    {
+        mEpollFileDescriptor = epoll_create1(EPOLL_CLOEXEC) ;
+
+        if (mEpollFileDescriptor < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        mStopEventFileDescriptor = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) ; // NOLINT (hicpp-signed-bitwise)
+
+        if (mStopEventFileDescriptor < 0)
+        {
+            const auto error_number = errno ;
+            close(mEpollFileDescriptor) ;
+            throw std::runtime_error(std::strerror(error_number)) ;
+        }
+
+        // The stop event is level-triggered so that every thread blocked in
+        // epoll_wait() wakes up once Stop() is called.
+        epoll_event stop_event {} ;
+        stop_event.events = EPOLLIN ;
+        stop_event.data.u64 = STOP_EVENT_ID ;
+
+        if (epoll_ctl(mEpollFileDescriptor,
+                      EPOLL_CTL_ADD,
+                      mStopEventFileDescriptor,
+                      &stop_event) < 0)
+        {
+            const auto error_number = errno ;
+            close(mStopEventFileDescriptor) ;
+            close(mEpollFileDescriptor) ;
+            throw std::runtime_error(std::strerror(error_number)) ;
+        }
+
+        // std::chrono::steady_clock is CLOCK_MONOTONIC, so timer deadlines
+        // can be handed to the timerfd as absolute times.
+        mTimerFileDescriptor = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK) ; // NOLINT (hicpp-signed-bitwise)
+
+        epoll_event timer_event {} ;
+        timer_event.events = EPOLLIN ;
+        timer_event.data.u64 = TIMER_EVENT_ID ;
+
+        if ((mTimerFileDescriptor < 0) or
+            (epoll_ctl(mEpollFileDescriptor,
+                       EPOLL_CTL_ADD,
+                       mTimerFileDescriptor,
+                       &timer_event) < 0))
+        {
+            const auto error_number = errno ;
+            close(mTimerFileDescriptor) ;
+            close(mStopEventFileDescriptor) ;
+            close(mEpollFileDescriptor) ;
+            throw std::runtime_error(std::strerror(error_number)) ;
+        }
+
+        mModemLineEventFileDescriptor = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) ; // NOLINT (hicpp-signed-bitwise)
+
+        epoll_event modem_line_event {} ;
+        modem_line_event.events = EPOLLIN ;
+        modem_line_event.data.u64 = MODEM_LINE_EVENT_ID ;
+
+        if ((mModemLineEventFileDescriptor < 0) or
+            (epoll_ctl(mEpollFileDescriptor,
+                       EPOLL_CTL_ADD,
+                       mModemLineEventFileDescriptor,
+                       &modem_line_event) < 0))
+        {
+            const auto error_number = errno ;
+            close(mModemLineEventFileDescriptor) ;
+            close(mTimerFileDescriptor) ;
+            close(mStopEventFileDescriptor) ;
+            close(mEpollFileDescriptor) ;
+            throw std::runtime_error(std::strerror(error_number)) ;
+        }
+    }
+
+    inline
+    SerialPortReactor::Implementation::~Implementation()
+    {
+        // The modem line watcher threads hold references to their entries,
+        // so they are stopped before the ports are closed, which is done
+        // before the epoll descriptor they are registered with is closed.
+        for (const auto& port_entry : mPortEntries)
+        {
+            port_entry.second->StopModemLineWatcher() ;
+        }
+
+        mPortEntries.clear() ;
+
+        close(mModemLineEventFileDescriptor) ;
+        close(mTimerFileDescriptor) ;
+        close(mStopEventFileDescriptor) ;
+        close(mEpollFileDescriptor) ;
+    }
+
+    template <typename PortType>
+    inline
+    SerialPortReactor::PortId
+    SerialPortReactor::Implementation::Add(std::unique_ptr<PortType>   port,
+                                           const Callbacks<PortType>& callbacks)
+    {
+        if ((not port) or
+            (not port->IsOpen()))
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        const auto file_descriptor = port->GetFileDescriptor() ;
+
+        auto port_entry = std::make_shared<TypedPortEntry<PortType>>(std::move(port),
+                                                                     callbacks) ;
+        port_entry->mFileDescriptor = file_descriptor ;
+
+        if (port_entry->HasModemLineChangeCallback())
+        {
+            // Record the initial modem line state so that only subsequent
+            // changes are reported.
+            int modem_line_state = 0 ;
+
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+            if (ioctl(file_descriptor,
+                      TIOCMGET,
+                      &modem_line_state) == 0)
+            {
+                port_entry->mModemLineState = modem_line_state & MODEM_INPUT_LINE_MASK ; // NOLINT (hicpp-signed-bitwise)
+            }
+
+            // Drivers that count modem line transitions also support
+            // TIOCMIWAIT, so their changes are delivered by a watcher thread
+            // instead of being sampled, provided that the wake signal can
+            // stop it.
+            if ((GetModemLineCounters(file_descriptor,
+                                      port_entry->mModemLineCounters) == 0) and
+                IsModemLineWakeSignalUsable())
+            {
+                // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+                port_entry->mModemLineEventFileDescriptor = fcntl(mModemLineEventFileDescriptor,
+                                                                  F_DUPFD_CLOEXEC,
+                                                                  0) ;
+
+                if (port_entry->mModemLineEventFileDescriptor < 0)
+                {
+                    throw std::runtime_error(std::strerror(errno)) ;
+                }
+
+                // The watcher shares ownership of the entry, which is only
+                // released once it has returned.
+                std::shared_ptr<PortEntry> watched_entry = port_entry ;
+
+                port_entry->mModemLineWatcher = std::thread([watched_entry]()
+                {
+                    WatchModemLines(*watched_entry) ;
+                }) ;
+            }
+            else
+            {
+                port_entry->mModemLinePolled = true ;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex) ;
+
+        port_entry->mPortId = mNextPortId ;
+
+        try
+        {
+            this->ArmPortEntry(*port_entry,
+                               EPOLL_CTL_ADD) ;
+        }
+        catch (...)
+        {
+            port_entry->StopModemLineWatcher() ;
+            throw ;
+        }
+
+        mPortEntries.emplace(mNextPortId, port_entry) ;
+
+        if (port_entry->mModemLinePolled)
+        {
+            ++mNumberOfModemLinePorts ;
+        }
+
+        return mNextPortId++ ;
+    }
+
+    inline
+    void
+    SerialPortReactor::Implementation::Remove(const PortId portId)
+    {
+        std::shared_ptr<PortEntry> port_entry ;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex) ;
+
+            const auto port_entry_iter = mPortEntries.find(portId) ;
+
+            if (port_entry_iter == mPortEntries.end())
+            {
+                throw std::invalid_argument(ERR_MSG_INVALID_PORT_ID) ;
+            }
+
+            port_entry = port_entry_iter->second ;
+            mPortEntries.erase(port_entry_iter) ;
+
+            port_entry->mRemoved = true ;
+
+            if (port_entry->mModemLinePolled)
+            {
+                --mNumberOfModemLinePorts ;
+            }
+
+            // Deregister the descriptor before the port is closed so that a
+            // recycled descriptor number is never reported for this port.
+            epoll_ctl(mEpollFileDescriptor,
+                      EPOLL_CTL_DEL,
+                      port_entry->mFileDescriptor,
+                      nullptr) ;
+        }
+
+        // The modem line watcher holds a reference to the entry until it
+        // has been stopped.
+        port_entry->StopModemLineWatcher() ;
+
+        // If a callback for this port is running on another thread, that
+        // thread holds the last reference and closes the port on return.
+    }
+
+    template <typename PortType>
+    inline
+    PortType&
+    SerialPortReactor::Implementation::GetPort(const PortId portId)
+    {
+        const auto port_entry = std::dynamic_pointer_cast<TypedPortEntry<PortType>>(this->FindPortEntry(portId)) ;
+
+        if (not port_entry)
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_PORT_ID) ;
+        }
+
+        return *port_entry->mPort ;
+    }
+
+    inline
+    size_t
+    SerialPortReactor::Implementation::GetNumberOfPorts() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex) ;
+        return mPortEntries.size() ;
+    }
+
+    inline
+    void
+    SerialPortReactor::Implementation::SetWritableInterest(const PortId portId,
+                                                           const bool   writableInterest)
+    {
+        const auto port_entry = this->FindPortEntry(portId) ;
+
+        if (not port_entry)
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_PORT_ID) ;
+        }
+
+        if (port_entry->mWritableInterest.exchange(writableInterest) != writableInterest)
+        {
+            // This may be called from within a callback for the same port,
+            // so the dispatch mutex is not taken here. Re-arming early is
+            // harmless since dispatching is serialized by that mutex.
+            this->ArmPortEntry(*port_entry,
+                               EPOLL_CTL_MOD) ;
+        }
+    }
+
+    inline
+    void
+    SerialPortReactor::Implementation::SetWritableThreshold(const PortId portId,
+                                                            const size_t writableThreshold)
+    {
+        const auto port_entry = this->FindPortEntry(portId) ;
+
+        if (not port_entry)
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_PORT_ID) ;
+        }
+
+        // A new threshold takes effect the next time the port is writable.
+        // If writable events are being held back they stay so until the
+        // timer expires.
+        port_entry->mWritableThreshold = writableThreshold ;
+    }
+
+    inline
+    void
+    SerialPortReactor::Implementation::SetReadableInterest(const PortId portId,
+                                                           const bool   readableInterest)
+    {
+        const auto port_entry = this->FindPortEntry(portId) ;
+
+        if (not port_entry)
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_PORT_ID) ;
+        }
+
+        if (port_entry->mReadableInterest.exchange(readableInterest) != readableInterest)
+        {
+            // See SetWritableInterest() for why the dispatch mutex is not
+            // taken here.
+            this->ArmPortEntry(*port_entry,
+                               EPOLL_CTL_MOD) ;
+        }
+    }
+
+    inline
+    SerialPortReactor::TimerId
+    SerialPortReactor::Implementation::StartTimer(const size_t                 msDelay,
+                                                  const std::function<void()>& callback)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(msDelay) ;
+
+        std::lock_guard<std::mutex> lock(mTimerMutex) ;
+
+        const auto timer_id = mNextTimerId++ ;
+
+        mTimerCallbacks.emplace(timer_id, callback) ;
+        const auto timer_iter = mTimerQueue.emplace(deadline, timer_id) ;
+
+        // Only a new earliest deadline requires the descriptor to be re-armed.
+        if (timer_iter == mTimerQueue.begin())
+        {
+            this->ArmTimerDescriptor() ;
+        }
+
+        return timer_id ;
+    }
+
+    inline
+    bool
+    SerialPortReactor::Implementation::CancelTimer(const TimerId timerId)
+    {
+        std::lock_guard<std::mutex> lock(mTimerMutex) ;
+
+        // The queue entry is discarded once it expires, which at worst
+        // causes one spurious wake-up of the reactor.
+        return mTimerCallbacks.erase(timerId) > 0 ;
+    }
+
+    inline
+    void
+    SerialPortReactor::Implementation::SetModemLinePollInterval(const size_t msInterval)
+    {
+        mModemLinePollInterval = std::max(msInterval, static_cast<size_t>(1)) ;
+    }
+
+    inline
+    void
+    SerialPortReactor::Implementation::Run()
+    {
+        this->EnterRun() ;
+
+        try
+        {
+            while (not mStopRequested)
+            {
+                this->DispatchEvents(0) ;
+            }
+        }
+        catch (...)
+        {
+            this->LeaveRun() ;
+            throw ;
+        }
+
+        this->LeaveRun() ;
+    }
+
+    inline
+    size_t
+    SerialPortReactor::Implementation::RunOnce(const size_t msTimeout)
+    {
+        this->EnterRun() ;
+
+        size_t number_of_callbacks = 0 ;
+
+        try
+        {
+            number_of_callbacks = this->DispatchEvents(msTimeout) ;
+        }
+        catch (...)
+        {
+            this->LeaveRun() ;
+            throw ;
+        }
+
+        this->LeaveRun() ;
+
+        return number_of_callbacks ;
+    }
+
+    inline
+    void
+    SerialPortReactor::Implementation::Stop()
+    {
+        mStopRequested = true ;
+
+        const uint64_t stop_event = 1 ;
+
+        if ((call_with_retry(write,
+                             mStopEventFileDescriptor,
+                             &stop_event,
+                             sizeof(stop_event)) < 0) and
+            (errno != EWOULDBLOCK))
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+    }
+
+    inline
+    std::shared_ptr<SerialPortReactor::Implementation::PortEntry>
+    SerialPortReactor::Implementation::FindPortEntry(const PortId portId) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex) ;
+
+        const auto port_entry_iter = mPortEntries.find(portId) ;
+
+        if (port_entry_iter == mPortEntries.end())
+        {
+            return nullptr ;
+        }
+
+        return port_entry_iter->second ;
+    }
+
+    inline
+    void
+    SerialPortReactor::Implementation::ArmPortEntry(PortEntry& portEntry,
+                                                    const int  epollOperation) const
+    {
+        if (portEntry.mHungUp or
+            portEntry.mRemoved)
+        {
+            return ;
+        }
+
+        // EPOLLONESHOT ensures that only one thread receives the events of a
+        // port until it has been re-armed after its callbacks return.
+        epoll_event port_event {} ;
+        port_event.events = EPOLLONESHOT ; // NOLINT (hicpp-signed-bitwise)
+        port_event.data.u64 = portEntry.mPortId ;
+
+        if (portEntry.HasDataReadyCallback() and
+            portEntry.mReadableInterest)
+        {
+            port_event.events |= EPOLLIN ; // NOLINT (hicpp-signed-bitwise)
+        }
+
+        if (portEntry.mWritableInterest and
+            not portEntry.mWritableDeferred)
+        {
+            port_event.events |= EPOLLOUT ; // NOLINT (hicpp-signed-bitwise)
+        }
+
+        if (epoll_ctl(mEpollFileDescriptor,
+                      epollOperation,
+                      portEntry.mFileDescriptor,
+                      &port_event) < 0)
+        {
+            // The port may have been removed by another thread.
+            if ((errno == ENOENT) and
+                portEntry.mRemoved)
+            {
+                return ;
+            }
+
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+    }
+
+    inline
+    size_t
+    SerialPortReactor::Implementation::DispatchPortEvents(PortEntry&     portEntry,
+                                                          const uint32_t events)
+    {
+        std::lock_guard<std::mutex> lock(portEntry.mDispatchMutex) ;
+
+        size_t number_of_callbacks = 0 ;
+
+        try
+        {
+            if ((events & EPOLLIN) and // NOLINT (hicpp-signed-bitwise)
+                portEntry.mReadableInterest and
+                portEntry.OnDataReady())
+            {
+                ++number_of_callbacks ;
+            }
+
+            if ((events & EPOLLOUT) and // NOLINT (hicpp-signed-bitwise)
+                portEntry.mWritableInterest and
+                not portEntry.mRemoved and
+                this->CheckWritableThreshold(portEntry) and
+                portEntry.OnWritable())
+            {
+                ++number_of_callbacks ;
+            }
+
+            if ((events & (EPOLLHUP | EPOLLERR)) and // NOLINT (hicpp-signed-bitwise)
+                not portEntry.mRemoved)
+            {
+                // The port is never re-armed after a hang-up since epoll
+                // would otherwise report the condition continuously.
+                portEntry.mHungUp = true ;
+
+                if (portEntry.OnHangUp())
+                {
+                    ++number_of_callbacks ;
+                }
+            }
+        }
+        catch (...)
+        {
+            this->ArmPortEntry(portEntry,
+                               EPOLL_CTL_MOD) ;
+            throw ;
+        }
+
+        this->ArmPortEntry(portEntry,
+                           EPOLL_CTL_MOD) ;
+
+        return number_of_callbacks ;
+    }
+
+    inline
+    bool
+    SerialPortReactor::Implementation::CheckWritableThreshold(PortEntry& portEntry)
+    {
+        const size_t writable_threshold = portEntry.mWritableThreshold ;
+
+        if (writable_threshold == std::numeric_limits<size_t>::max())
+        {
+            return true ;
+        }
+
+        // If the queue depth cannot be read the callback is dispatched as
+        // if no threshold had been set.
+        int number_of_bytes_pending = 0 ;
+
+        if ((GetNumberOfBytesPending(portEntry.mFileDescriptor,
+                                     number_of_bytes_pending) < 0) or
+            (static_cast<size_t>(number_of_bytes_pending) <= writable_threshold))
+        {
+            return true ;
+        }
+
+        // EPOLLOUT is left out when the port is re-armed, otherwise epoll
+        // would report the port as writable continuously while the driver
+        // has room for more data.
+        portEntry.mWritableDeferred = true ;
+
+        const auto ms_delay = GetTransmitTime(portEntry.mFileDescriptor,
+                                              static_cast<size_t>(number_of_bytes_pending) - writable_threshold) ;
+        const auto port_id = portEntry.mPortId ;
+
+        this->StartTimer(ms_delay, [this, port_id]()
+        {
+            const auto port_entry = this->FindPortEntry(port_id) ;
+
+            if (port_entry)
+            {
+                port_entry->mWritableDeferred = false ;
+                this->ArmPortEntry(*port_entry,
+                                   EPOLL_CTL_MOD) ;
+            }
+        }) ;
+
+        return false ;
+    }
+
+    inline
+    size_t
+    SerialPortReactor::Implementation::DispatchTimers()
+    {
+        std::vector<std::function<void()>> expired_callbacks ;
+
+        {
+            std::lock_guard<std::mutex> lock(mTimerMutex) ;
+
+            // Clear the level-triggered readiness of the descriptor. Other
+            // threads woken by the same expiry find nothing left to do.
+            uint64_t number_of_expirations = 0 ;
+            call_with_retry(read,
+                            mTimerFileDescriptor,
+                            &number_of_expirations,
+                            sizeof(number_of_expirations)) ;
+
+            const auto current_time = std::chrono::steady_clock::now() ;
+
+            while ((not mTimerQueue.empty()) and
+                   (mTimerQueue.begin()->first <= current_time))
+            {
+                const auto timer_callback_iter = mTimerCallbacks.find(mTimerQueue.begin()->second) ;
+
+                if (timer_callback_iter != mTimerCallbacks.end())
+                {
+                    expired_callbacks.push_back(std::move(timer_callback_iter->second)) ;
+                    mTimerCallbacks.erase(timer_callback_iter) ;
+                }
+
+                mTimerQueue.erase(mTimerQueue.begin()) ;
+            }
+
+            this->ArmTimerDescriptor() ;
+        }
+
+        // The callbacks are invoked without the timer mutex held so that
+        // they may start or cancel timers themselves.
+        std::exception_ptr callback_exception ;
+
+        for (const auto& expired_callback : expired_callbacks)
+        {
+            try
+            {
+                expired_callback() ;
+            }
+            catch (...)
+            {
+                if (not callback_exception)
+                {
+                    callback_exception = std::current_exception() ;
+                }
+            }
+        }
+
+        if (callback_exception)
+        {
+            std::rethrow_exception(callback_exception) ;
+        }
+
+        return expired_callbacks.size() ;
+    }
+
+    inline
+    void
+    SerialPortReactor::Implementation::ArmTimerDescriptor()
+    {
+        // Discard the entries of cancelled timers at the front of the queue.
+        while ((not mTimerQueue.empty()) and
+               (mTimerCallbacks.count(mTimerQueue.begin()->second) == 0))
+        {
+            mTimerQueue.erase(mTimerQueue.begin()) ;
+        }
+
+        itimerspec timer_value {} ;
+
+        if (not mTimerQueue.empty())
+        {
+            using std::chrono::nanoseconds ;
+
+            const auto deadline_ns = std::max(std::chrono::duration_cast<nanoseconds>(mTimerQueue.begin()->first.time_since_epoch()).count(),
+                                              nanoseconds::rep(1)) ;
+
+            // A zero it_value would disarm the timer rather than expire it.
+            timer_value.it_value.tv_sec  = static_cast<time_t>(deadline_ns / 1000000000) ;
+            timer_value.it_value.tv_nsec = static_cast<long>(deadline_ns % 1000000000) ;
+        }
+
+        if (timerfd_settime(mTimerFileDescriptor,
+                            TFD_TIMER_ABSTIME,
+                            &timer_value,
+                            nullptr) < 0)
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+    }
+
+    inline
+    void
+    SerialPortReactor::Implementation::WatchModemLines(PortEntry& portEntry)
+    {
+        auto modem_line_counters = portEntry.mModemLineCounters ;
+
+        while (true)
+        {
+            const auto changed_lines = WaitForModemLineChange(portEntry.mFileDescriptor,
+                                                              MODEM_INPUT_LINE_MASK,
+                                                              modem_line_counters,
+                                                              portEntry.mModemLineWatcherStopRequested) ;
+
+            if ((changed_lines == 0) or
+                portEntry.mModemLineWatcherStopRequested)
+            {
+                break ;
+            }
+
+            // A driver that counts transitions but rejects TIOCMIWAIT falls
+            // back to having its modem lines sampled.
+            if (changed_lines < 0)
+            {
+                portEntry.mModemLineWatchFailed = true ;
+            }
+
+            // The event is flagged before the descriptor is signaled, so a
+            // dispatching thread that has consumed the signal always finds it.
+            portEntry.mModemLineEventPending = true ;
+
+            const uint64_t modem_line_event = 1 ;
+            call_with_retry(write,
+                            portEntry.mModemLineEventFileDescriptor,
+                            &modem_line_event,
+                            sizeof(modem_line_event)) ;
+
+            if (changed_lines < 0)
+            {
+                break ;
+            }
+        }
+
+        portEntry.mModemLineWatcherFinished = true ;
+    }
+
+    inline
+    bool
+    SerialPortReactor::Implementation::SampleModemLines(PortEntry& portEntry)
+    {
+        int modem_line_state = 0 ;
+
+        // Ports whose driver does not report the modem line state never
+        // invoke their modemLineChange callback.
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (ioctl(portEntry.mFileDescriptor,
+                  TIOCMGET,
+                  &modem_line_state) < 0)
+        {
+            return false ;
+        }
+
+        modem_line_state &= MODEM_INPUT_LINE_MASK ; // NOLINT (hicpp-signed-bitwise)
+
+        // A transition that has already been undone, such as a ring pulse,
+        // leaves the state unchanged but is still visible in the counters.
+        ModemLineCounters modem_line_counters {} ;
+        auto transitions_counted = false ;
+
+        if ((not portEntry.mModemLinePolled) and
+            (GetModemLineCounters(portEntry.mFileDescriptor,
+                                  modem_line_counters) == 0))
+        {
+            transitions_counted = GetChangedModemLines(portEntry.mModemLineCounters,
+                                                       modem_line_counters) != 0 ;
+            portEntry.mModemLineCounters = modem_line_counters ;
+        }
+
+        if ((modem_line_state == portEntry.mModemLineState) and
+            (not transitions_counted))
+        {
+            return false ;
+        }
+
+        portEntry.mModemLineState = modem_line_state ;
+
+        return portEntry.OnModemLineChange(modem_line_state) ;
+    }
+
+    inline
+    size_t
+    SerialPortReactor::Implementation::DispatchModemLineEvents()
+    {
+        uint64_t number_of_events = 0 ;
+
+        // Other threads woken by the same signal find nothing left to do.
+        if (call_with_retry(read,
+                            mModemLineEventFileDescriptor,
+                            &number_of_events,
+                            sizeof(number_of_events)) < 0)
+        {
+            return 0 ;
+        }
+
+        std::vector<std::shared_ptr<PortEntry>> port_entries ;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex) ;
+
+            for (const auto& port_entry : mPortEntries)
+            {
+                if (not port_entry.second->mModemLineEventPending.exchange(false))
+                {
+                    continue ;
+                }
+
+                if (port_entry.second->mModemLineWatchFailed and
+                    not port_entry.second->mModemLinePolled)
+                {
+                    port_entry.second->mModemLinePolled = true ;
+                    ++mNumberOfModemLinePorts ;
+                }
+
+                port_entries.push_back(port_entry.second) ;
+            }
+        }
+
+        size_t number_of_callbacks = 0 ;
+        std::exception_ptr callback_exception ;
+
+        for (const auto& port_entry : port_entries)
+        {
+            // Unlike periodic sampling, a reported change must not be skipped
+            // while the port is busy in another callback.
+            std::lock_guard<std::mutex> dispatch_lock(port_entry->mDispatchMutex) ;
+
+            if (port_entry->mRemoved or
+                port_entry->mHungUp)
+            {
+                continue ;
+            }
+
+            try
+            {
+                if (SampleModemLines(*port_entry))
+                {
+                    ++number_of_callbacks ;
+                }
+            }
+            catch (...)
+            {
+                if (not callback_exception)
+                {
+                    callback_exception = std::current_exception() ;
+                }
+            }
+        }
+
+        if (callback_exception)
+        {
+            std::rethrow_exception(callback_exception) ;
+        }
+
+        return number_of_callbacks ;
+    }
+
+    inline
+    size_t
+    SerialPortReactor::Implementation::DispatchModemLineChanges()
+    {
+        using std::chrono::steady_clock ;
+
+        if (mNumberOfModemLinePorts == 0)
+        {
+            return 0 ;
+        }
+
+        // Only one thread samples the modem lines at a time.
+        std::unique_lock<std::mutex> sample_lock(mModemLineMutex,
+                                                 std::try_to_lock) ;
+
+        const auto current_time = steady_clock::now() ;
+
+        if ((not sample_lock.owns_lock()) or
+            (current_time.time_since_epoch().count() < mNextModemLineSample))
+        {
+            return 0 ;
+        }
+
+        const auto next_sample_time = current_time + std::chrono::milliseconds(mModemLinePollInterval) ;
+        mNextModemLineSample = next_sample_time.time_since_epoch().count() ;
+
+        std::vector<std::shared_ptr<PortEntry>> port_entries ;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex) ;
+
+            for (const auto& port_entry : mPortEntries)
+            {
+                if (port_entry.second->mModemLinePolled)
+                {
+                    port_entries.push_back(port_entry.second) ;
+                }
+            }
+        }
+
+        size_t number_of_callbacks = 0 ;
+
+        for (const auto& port_entry : port_entries)
+        {
+            // Ports busy in a callback on another thread are sampled on the
+            // next round instead of blocking this thread.
+            std::unique_lock<std::mutex> dispatch_lock(port_entry->mDispatchMutex,
+                                                       std::try_to_lock) ;
+
+            if ((not dispatch_lock.owns_lock()) or
+                port_entry->mRemoved or
+                port_entry->mHungUp)
+            {
+                continue ;
+            }
+
+            if (SampleModemLines(*port_entry))
+            {
+                ++number_of_callbacks ;
+            }
+        }
+
+        return number_of_callbacks ;
+    }
+
+    inline
+    int
+    SerialPortReactor::Implementation::GetModemLineWaitTimeout(const int msTimeout) const
+    {
+        using std::chrono::steady_clock ;
+
+        if (mNumberOfModemLinePorts == 0)
+        {
+            return msTimeout ;
+        }
+
+        const auto current_ticks = steady_clock::now().time_since_epoch().count() ;
+        const auto remaining_time = steady_clock::duration(std::max(mNextModemLineSample - current_ticks,
+                                                                    steady_clock::rep(0))) ;
+
+        // Round up so that the wait does not end just before the sample is due.
+        const auto remaining_ms = static_cast<int>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(remaining_time).count() + 1) ;
+
+        if (msTimeout < 0)
+        {
+            return remaining_ms ;
+        }
+
+        return std::min(msTimeout, remaining_ms) ;
+    }
+
+    inline
+    size_t
+    SerialPortReactor::Implementation::DispatchEvents(const size_t msTimeout)
+    {
+        // Obtain the entry time.
+        const auto entry_time = std::chrono::steady_clock::now() ;
+
+        size_t number_of_callbacks = 0 ;
+
+        while ((number_of_callbacks == 0) and
+               (not mStopRequested))
+        {
+            int wait_ms = -1 ;
+
+            if (msTimeout > 0)
+            {
+                const auto elapsed_ms = static_cast<size_t>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - entry_time).count()) ;
+
+                if (elapsed_ms >= msTimeout)
+                {
+                    break ;
+                }
+
+                wait_ms = static_cast<int>(std::min(msTimeout - elapsed_ms,
+                                                    static_cast<size_t>(std::numeric_limits<int>::max()))) ;
+            }
+
+            wait_ms = this->GetModemLineWaitTimeout(wait_ms) ;
+
+            epoll_event events[MAX_EVENTS_PER_WAIT] {} ; // NOLINT (modernize-avoid-c-arrays)
+
+            const auto number_of_events = call_with_retry(epoll_wait,
+                                                          mEpollFileDescriptor,
+                                                          events,
+                                                          MAX_EVENTS_PER_WAIT,
+                                                          wait_ms) ;
+
+            if (number_of_events < 0)
+            {
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            // Every retrieved event must be dispatched and its port re-armed
+            // even if a callback throws, so the first exception is held back
+            // until the whole batch has been processed.
+            std::exception_ptr callback_exception ;
+
+            for (int i = 0; i < number_of_events; ++i)
+            {
+                const auto& event = events[i] ; // NOLINT (cppcoreguidelines-pro-bounds-constant-array-index)
+
+                if (event.data.u64 == STOP_EVENT_ID)
+                {
+                    continue ;
+                }
+
+                if (event.data.u64 == MODEM_LINE_EVENT_ID)
+                {
+                    try
+                    {
+                        number_of_callbacks += this->DispatchModemLineEvents() ;
+                    }
+                    catch (...)
+                    {
+                        if (not callback_exception)
+                        {
+                            callback_exception = std::current_exception() ;
+                        }
+                    }
+
+                    continue ;
+                }
+
+                if (event.data.u64 == TIMER_EVENT_ID)
+                {
+                    try
+                    {
+                        number_of_callbacks += this->DispatchTimers() ;
+                    }
+                    catch (...)
+                    {
+                        if (not callback_exception)
+                        {
+                            callback_exception = std::current_exception() ;
+                        }
+                    }
+
+                    continue ;
+                }
+
+                const auto port_entry = this->FindPortEntry(event.data.u64) ;
+
+                if (not port_entry)
+                {
+                    continue ;
+                }
+
+                try
+                {
+                    number_of_callbacks += this->DispatchPortEvents(*port_entry,
+                                                                    event.events) ;
+                }
+                catch (...)
+                {
+                    if (not callback_exception)
+                    {
+                        callback_exception = std::current_exception() ;
+                    }
+                }
+            }
+
+            if (callback_exception)
+            {
+                std::rethrow_exception(callback_exception) ;
+            }
+
+            number_of_callbacks += this->DispatchModemLineChanges() ;
+        }
+
+        return number_of_callbacks ;
+    }
+
+    inline
+    void
+    SerialPortReactor::Implementation::EnterRun()
+    {
+        std::lock_guard<std::mutex> lock(mMutex) ;
+        ++mNumberOfRunningThreads ;
+    }
+
+    inline
+    void
+    SerialPortReactor::Implementation::LeaveRun()
+    {
+        std::lock_guard<std::mutex> lock(mMutex) ;
+
+        if ((--mNumberOfRunningThreads == 0) and
+            mStopRequested)
+        {
+            // Consume the stop event so that the reactor can be run again.
+            uint64_t stop_event = 0 ;
+            call_with_retry(read,
+                            mStopEventFileDescriptor,
+                            &stop_event,
+                            sizeof(stop_event)) ;
+
+            mStopRequested = false ;
+        }
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,290 @@
+/******************************************************************************
+ * @file SerialPortStatistics.cpp                                             *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/SerialPortStatistics.h"
+
+#include <algorithm>
+
+namespace LibSerial
+{
+    double
+    LatencyHistogramSnapshot::GetMean() const
+    {
+        if (count == 0)
+        {
+            return 0.0 ;
+        }
+
+        return static_cast<double>(total) / static_cast<double>(count) ;
+    }
+
+    uint64_t
+    LatencyHistogramSnapshot::GetValueAtPercentile(const double percentile) const
+    {
+        if (count == 0)
+        {
+            return 0 ;
+        }
+
+        const auto clamped_percentile = std::min(std::max(percentile, 0.0), 100.0) ;
+
+        // The rank of the value, counting from one.
+        const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(clamped_percentile / 100.0 * static_cast<double>(count) + 0.5)) ;
+
+        uint64_t cumulative_count = 0 ;
+
+        for (size_t bucket_index = 0 ; bucket_index < bucketCounts.size() ; ++bucket_index)
+        {
+            cumulative_count += bucketCounts[bucket_index] ;
+
+            if (cumulative_count >= rank)
+            {
+                return std::min(GetBucketUpperBound(bucket_index), maximum) ;
+            }
+        }
+
+        return maximum ;
+    }
+
+    uint64_t
+    LatencyHistogramSnapshot::GetBucketUpperBound(const size_t bucketIndex)
+    {
+        if (bucketIndex < LATENCY_HISTOGRAM_SUB_BUCKETS)
+        {
+            return bucketIndex ;
+        }
+
+        const auto magnitude = bucketIndex / LATENCY_HISTOGRAM_SUB_BUCKETS + LATENCY_HISTOGRAM_SUB_BUCKET_BITS - 1 ;
+        const auto sub_bucket = bucketIndex % LATENCY_HISTOGRAM_SUB_BUCKETS ;
+
+        return ((LATENCY_HISTOGRAM_SUB_BUCKETS + sub_bucket + 1) << (magnitude - LATENCY_HISTOGRAM_SUB_BUCKET_BITS)) - 1 ;
+    }
+
+    void
+    LatencyHistogramSnapshot::Merge(const LatencyHistogramSnapshot& otherSnapshot)
+    {
+        if (bucketCounts.size() < otherSnapshot.bucketCounts.size())
+        {
+            bucketCounts.resize(otherSnapshot.bucketCounts.size()) ;
+        }
+
+        for (size_t bucket_index = 0 ; bucket_index < otherSnapshot.bucketCounts.size() ; ++bucket_index)
+        {
+            bucketCounts[bucket_index] += otherSnapshot.bucketCounts[bucket_index] ;
+        }
+
+        count += otherSnapshot.count ;
+        total += otherSnapshot.total ;
+        maximum = std::max(maximum, otherSnapshot.maximum) ;
+    }
+
+    void
+    SerialPortStatistics::Merge(const SerialPortStatistics& otherStatistics)
+    {
+        enabled = enabled or otherStatistics.enabled ;
+        bytesRead += otherStatistics.bytesRead ;
+        bytesWritten += otherStatistics.bytesWritten ;
+        readCalls += otherStatistics.readCalls ;
+        writeCalls += otherStatistics.writeCalls ;
+        wouldBlockResults += otherStatistics.wouldBlockResults ;
+        interruptedCalls += otherStatistics.interruptedCalls ;
+        readTimeouts += otherStatistics.readTimeouts ;
+        readWaitTime.Merge(otherStatistics.readWaitTime) ;
+        writeCompletionTime.Merge(otherStatistics.writeCompletionTime) ;
+    }
+
+    void
+    LatencyHistogram::Record(const uint64_t nanoseconds) noexcept
+    {
+        mBucketCounts[GetBucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed) ;
+        mTotal.fetch_add(nanoseconds, std::memory_order_relaxed) ;
+
+        auto maximum = mMaximum.load(std::memory_order_relaxed) ;
+
+        while ((nanoseconds > maximum) and
+               (not mMaximum.compare_exchange_weak(maximum,
+                                                   nanoseconds,
+                                                   std::memory_order_relaxed)))
+        {
+            /* Retry with the updated maximum. */
+        }
+    }
+
+    LatencyHistogramSnapshot
+    LatencyHistogram::GetSnapshot() const
+    {
+        LatencyHistogramSnapshot snapshot ;
+        snapshot.bucketCounts.resize(LATENCY_HISTOGRAM_BUCKETS) ;
+
+        for (size_t bucket_index = 0 ; bucket_index < LATENCY_HISTOGRAM_BUCKETS ; ++bucket_index)
+        {
+            snapshot.bucketCounts[bucket_index] = mBucketCounts[bucket_index].load(std::memory_order_relaxed) ;
+        }
+
+        // The count is derived from the copied buckets, so that it stays
+        // consistent with them while values are being recorded.
+        snapshot.count = 0 ;
+
+        for (const auto bucket_count : snapshot.bucketCounts)
+        {
+            snapshot.count += bucket_count ;
+        }
+
+        snapshot.total = mTotal.load(std::memory_order_relaxed) ;
+        snapshot.maximum = mMaximum.load(std::memory_order_relaxed) ;
+
+        return snapshot ;
+    }
+
+    void
+    LatencyHistogram::Reset() noexcept
+    {
+        for (auto& bucket_count : mBucketCounts)
+        {
+            bucket_count.store(0, std::memory_order_relaxed) ;
+        }
+
+        mTotal.store(0, std::memory_order_relaxed) ;
+        mMaximum.store(0, std::memory_order_relaxed) ;
+    }
+
+    size_t
+    LatencyHistogram::GetBucketIndex(const uint64_t nanoseconds) noexcept
+    {
+        if (nanoseconds < LATENCY_HISTOGRAM_SUB_BUCKETS)
+        {
+            return static_cast<size_t>(nanoseconds) ;
+        }
+
+        // The position of the most significant bit, at least
+        // LATENCY_HISTOGRAM_SUB_BUCKET_BITS here.
+        const auto magnitude = static_cast<size_t>(63 - __builtin_clzll(nanoseconds)) ;
+
+        if (magnitude > LATENCY_HISTOGRAM_MAXIMUM_MAGNITUDE)
+        {
+            return LATENCY_HISTOGRAM_BUCKETS - 1 ;
+        }
+
+        const auto shift = magnitude - LATENCY_HISTOGRAM_SUB_BUCKET_BITS ;
+        const auto sub_bucket = static_cast<size_t>(nanoseconds >> shift) & (LATENCY_HISTOGRAM_SUB_BUCKETS - 1) ;
+
+        return (magnitude - LATENCY_HISTOGRAM_SUB_BUCKET_BITS + 1) * LATENCY_HISTOGRAM_SUB_BUCKETS + sub_bucket ;
+    }
+
+    void
+    IoStatistics::RecordRead(const ssize_t result) noexcept
+    {
+        mReadCalls.fetch_add(1, std::memory_order_relaxed) ;
+
+        if (result > 0)
+        {
+            mBytesRead.fetch_add(static_cast<uint64_t>(result), std::memory_order_relaxed) ;
+        }
+        else if ((result < 0) and
+                 (errno == EWOULDBLOCK))
+        {
+            mWouldBlockResults.fetch_add(1, std::memory_order_relaxed) ;
+        }
+    }
+
+    void
+    IoStatistics::RecordWrite(const ssize_t result) noexcept
+    {
+        mWriteCalls.fetch_add(1, std::memory_order_relaxed) ;
+
+        if (result > 0)
+        {
+            mBytesWritten.fetch_add(static_cast<uint64_t>(result), std::memory_order_relaxed) ;
+        }
+        else if ((result < 0) and
+                 (errno == EWOULDBLOCK))
+        {
+            mWouldBlockResults.fetch_add(1, std::memory_order_relaxed) ;
+        }
+    }
+
+    void
+    IoStatistics::RecordReadWait(const std::chrono::steady_clock::duration waitTime) noexcept
+    {
+        mReadWaitTime.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(waitTime).count())) ;
+    }
+
+    void
+    IoStatistics::RecordWriteCompletion(const std::chrono::steady_clock::duration completionTime) noexcept
+    {
+        mWriteCompletionTime.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(completionTime).count())) ;
+    }
+
+    void
+    IoStatistics::RecordReadTimeout() noexcept
+    {
+        mReadTimeouts.fetch_add(1, std::memory_order_relaxed) ;
+    }
+
+    SerialPortStatistics
+    IoStatistics::GetSnapshot() const
+    {
+        SerialPortStatistics snapshot ;
+
+#ifdef LIBSERIAL_ENABLE_STATISTICS
+        snapshot.enabled = true ;
+#endif
+
+        snapshot.bytesRead           = mBytesRead.load(std::memory_order_relaxed) ;
+        snapshot.bytesWritten        = mBytesWritten.load(std::memory_order_relaxed) ;
+        snapshot.readCalls           = mReadCalls.load(std::memory_order_relaxed) ;
+        snapshot.writeCalls          = mWriteCalls.load(std::memory_order_relaxed) ;
+        snapshot.wouldBlockResults   = mWouldBlockResults.load(std::memory_order_relaxed) ;
+        snapshot.interruptedCalls    = mInterruptedCalls.load(std::memory_order_relaxed) ;
+        snapshot.readTimeouts        = mReadTimeouts.load(std::memory_order_relaxed) ;
+        snapshot.readWaitTime        = mReadWaitTime.GetSnapshot() ;
+        snapshot.writeCompletionTime = mWriteCompletionTime.GetSnapshot() ;
+
+        return snapshot ;
+    }
+
+    void
+    IoStatistics::Reset() noexcept
+    {
+        mBytesRead.store(0, std::memory_order_relaxed) ;
+        mBytesWritten.store(0, std::memory_order_relaxed) ;
+        mReadCalls.store(0, std::memory_order_relaxed) ;
+        mWriteCalls.store(0, std::memory_order_relaxed) ;
+        mWouldBlockResults.store(0, std::memory_order_relaxed) ;
+        mInterruptedCalls.store(0, std::memory_order_relaxed) ;
+        mReadTimeouts.store(0, std::memory_order_relaxed) ;
+        mReadWaitTime.Reset() ;
+        mWriteCompletionTime.Reset() ;
+    }
+
+} // namespace LibSerial
@@ -49,13 +49,17 @@ namespace LibSerial
                                const StopBits&      stopBits) : 
         std::iostream(nullptr)
     {
-        this->Open(fileName) ;  // NOLINT (fuchsia-default-arguments)
-        this->SetBaudRate(baudRate) ;
-        this->SetCharacterSize(characterSize) ;
-        this->SetFlowControl(flowControlType) ;
-        this->SetParity(parityType) ;
-        this->SetStopBits(stopBits) ;
-        this->FlushIOBuffers() ;
+        PortSettings port_settings ;
+
+        port_settings.baudRate      = baudRate ;
+        port_settings.characterSize = characterSize ;
+        port_settings.flowControl   = flowControlType ;
+        port_settings.parity        = parityType ;
+        port_settings.stopBits      = stopBits ;
+
+        // Open() flushes the input and output buffers once the settings
+        // have been applied.
+        this->Open(fileName, port_settings) ;  // NOLINT (fuchsia-default-arguments)
     }
 
     SerialStream::~SerialStream() 
@@ -101,6 +105,29 @@ namespace LibSerial
         throw ;
     }
 
+    void
+    SerialStream::Open(const std::string& fileName,
+                       const PortSettings& portSettings,
+                       const std::ios_base::openmode& openMode)
+    try
+    {
+        // Create a new SerialStreamBuf if one does not exist.
+        if (mIOBuffer == nullptr)
+        {
+            mIOBuffer = std::make_unique<SerialStreamBuf>() ;
+            assert(mIOBuffer != nullptr) ;  // NOLINT (cppcoreguidelines-pro-bounds-array-to-pointer-decay)
+            this->rdbuf(mIOBuffer.get()) ;
+        }
+
+        // Open and configure the serial port.
+        mIOBuffer->Open(fileName, portSettings, openMode) ;
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
     void
     SerialStream::Close()
     {
@@ -334,6 +361,60 @@ namespace LibSerial
         throw ;
     }
 
+    void
+    SerialStream::SetBitRate(const speed_t bitRate)
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            my_buffer->SetBitRate(bitRate) ;
+        }
+        else
+        {
+            // If the dynamic_cast above failed then we either have a NULL
+            // streambuf associated with this stream or we have a buffer of
+            // class other than SerialStreamBuf. In either case, we have a
+            // problem and we should stop all I/O using this stream.
+            setstate(badbit) ;
+        }
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
+    speed_t
+    SerialStream::GetBitRate()
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            return my_buffer->GetBitRate() ;
+        }
+        // If the dynamic_cast above failed then we either have a NULL
+        // streambuf associated with this stream or we have a buffer of
+        // class other than SerialStreamBuf. In either case, we have a
+        // problem and we should stop all I/O using this stream.
+        setstate(badbit) ;
+        return 0 ;
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
     void
     SerialStream::SetCharacterSize(const CharacterSize& characterSize)
     try
@@ -685,6 +766,200 @@ namespace LibSerial
         throw ;
     }
 
+    void
+    SerialStream::SetLowLatency(const bool lowLatency)
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            my_buffer->SetLowLatency(lowLatency) ;
+        }
+        else
+        {
+            // If the dynamic_cast above failed then we either have a NULL
+            // streambuf associated with this stream or we have a buffer of
+            // class other than SerialStreamBuf. In either case, we have a
+            // problem and we should stop all I/O using this stream.
+            setstate(badbit) ;
+        }
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
+    bool
+    SerialStream::IsLowLatency()
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            return my_buffer->IsLowLatency() ;
+        }
+        // If the dynamic_cast above failed then we either have a NULL
+        // streambuf associated with this stream or we have a buffer of
+        // class other than SerialStreamBuf. In either case, we have a
+        // problem and we should stop all I/O using this stream.
+        setstate(badbit) ;
+        return false ;
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
+    void
+    SerialStream::SetLatencyProfile(const LatencyProfile& latencyProfile)
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            my_buffer->SetLatencyProfile(latencyProfile) ;
+        }
+        else
+        {
+            // If the dynamic_cast above failed then we either have a NULL
+            // streambuf associated with this stream or we have a buffer of
+            // class other than SerialStreamBuf. In either case, we have a
+            // problem and we should stop all I/O using this stream.
+            setstate(badbit) ;
+        }
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
+    void
+    SerialStream::SetReadBufferSize(const size_t bufferSize)
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            // Try to set the read buffer size.
+            my_buffer->SetReadBufferSize(bufferSize) ;
+        }
+        else
+        {
+            // If the dynamic_cast above failed then we either have a NULL
+            // streambuf associated with this stream or we have a buffer of
+            // class other than SerialStreamBuf. In either case, we have a
+            // problem and we should stop all I/O using this stream.
+            setstate(badbit) ;
+        }
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
+    size_t
+    SerialStream::GetReadBufferSize()
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            // Try to get the read buffer size.
+            return my_buffer->GetReadBufferSize() ;
+        }
+        // If the dynamic_cast above failed then we either have a NULL
+        // streambuf associated with this stream or we have a buffer of
+        // class other than SerialStreamBuf. In either case, we have a
+        // problem and we should stop all I/O using this stream.
+        setstate(badbit) ;
+        return 0 ;
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
+    void
+    SerialStream::SetWriteBufferSize(const size_t bufferSize)
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            // Try to set the write buffer size.
+            my_buffer->SetWriteBufferSize(bufferSize) ;
+        }
+        else
+        {
+            // If the dynamic_cast above failed then we either have a NULL
+            // streambuf associated with this stream or we have a buffer of
+            // class other than SerialStreamBuf. In either case, we have a
+            // problem and we should stop all I/O using this stream.
+            setstate(badbit) ;
+        }
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
+    size_t
+    SerialStream::GetWriteBufferSize()
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            // Try to get the write buffer size.
+            return my_buffer->GetWriteBufferSize() ;
+        }
+        // If the dynamic_cast above failed then we either have a NULL
+        // streambuf associated with this stream or we have a buffer of
+        // class other than SerialStreamBuf. In either case, we have a
+        // problem and we should stop all I/O using this stream.
+        setstate(badbit) ;
+        return 0 ;
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
     void
     SerialStream::SetDTR(const bool dtrState)
     try
@@ -906,6 +1181,52 @@ namespace LibSerial
         throw ;
     }
 
+    SerialPortStatistics
+    SerialStream::GetStatistics()
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            return my_buffer->GetStatistics() ;
+        }
+
+        setstate(badbit) ;
+        return SerialPortStatistics() ;
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
+    void
+    SerialStream::ResetStatistics()
+    try
+    {
+        auto my_buffer = dynamic_cast<SerialStreamBuf *>(this->rdbuf()) ;
+
+        // Make sure that we are dealing with a SerialStreamBuf before
+        // proceeding. This check also makes sure that we have a non-NULL
+        // buffer associated with this stream.
+        if (my_buffer != nullptr)
+        {
+            my_buffer->ResetStatistics() ;
+            return ;
+        }
+
+        setstate(badbit) ;
+    }
+    catch (const std::exception&)
+    {
+        setstate(std::ios_base::failbit) ;
+        throw ;
+    }
+
     std::vector<std::string>
     SerialStream::GetAvailableSerialPorts()
     try
@@ -33,8 +33,11 @@
 
 #include "libserial/SerialStreamBuf.h"
 #include "libserial/SerialPort.h"
+#include "StatisticsRecording.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstring>
 #include <fcntl.h>
 #include <linux/serial.h>
@@ -43,6 +46,12 @@
 
 namespace LibSerial
 {
+    /**
+     * @brief The number of characters reserved in front of the get area so
+     *        that previously read characters can be put back.
+     */
+    constexpr size_t PUTBACK_AREA_SIZE = 8 ;
+
     /**
      * @brief SerialStreamBuf::Implementation is the SerialStreamBuf implementation class.
      */
@@ -50,9 +59,11 @@ namespace LibSerial
     {
     public:
         /**
-         * @brief Default Constructor.
+         * @brief Constructor.
+         * @param streamBuf The SerialStreamBuf whose get and put areas are
+         *        managed by this instance.
          */
-        Implementation() = default ;
+        explicit Implementation(SerialStreamBuf& streamBuf) ;
 
         /**
          * @brief Default Destructor.
@@ -63,6 +74,8 @@ namespace LibSerial
          * @brief Constructor that allows a SerialStreamBuf instance to be
          *        created and opened, initializing the corresponding
          *        serial port with the specified parameters.
+         * @param streamBuf The SerialStreamBuf whose get and put areas are
+         *        managed by this instance.
          * @param fileName The file name of the serial stream.
          * @param baudRate The communications baud rate.
          * @param characterSize The size of the character buffer for
@@ -71,7 +84,8 @@ namespace LibSerial
          * @param stopBits The number of stop bits for the serial stream.
          * @param flowControlType The flow control type for the serial stream.
          */
-        Implementation(const std::string&   fileName,
+        Implementation(SerialStreamBuf&     streamBuf,
+                       const std::string&   fileName,
                        const BaudRate&      baudRate,
                        const CharacterSize& characterSize,
                        const FlowControl&   flowControlType,
@@ -108,6 +122,18 @@ namespace LibSerial
         void Open(const std::string& fileName,
                   const std::ios_base::openmode& openMode) ;
 
+        /**
+         * @brief Opens the serial port associated with the specified file
+         *        name and configures it with the specified parameters.
+         * @param fileName The file name of the serial port.
+         * @param portSettings The serial port parameters to be set.
+         * @param openMode The communication mode status when the serial
+         *        communication port is opened.
+         */
+        void Open(const std::string& fileName,
+                  const PortSettings& portSettings,
+                  const std::ios_base::openmode& openMode) ;
+
         /**
          * @brief Closes the serial port. All settings of the serial port will be
          *        lost and no more I/O can be performed on the serial port.
@@ -162,6 +188,18 @@ namespace LibSerial
          */
         BaudRate GetBaudRate() const ;
 
+        /**
+         * @brief Sets the serial port to an arbitrary bit rate in bits per second.
+         * @param bitRate The bit rate in bits per second.
+         */
+        void SetBitRate(const speed_t bitRate) ;
+
+        /**
+         * @brief Gets the bit rate in bits per second currently used by the serial port.
+         * @return Returns the bit rate in bits per second.
+         */
+        speed_t GetBitRate() const ;
+
         /**
          * @brief Sets the character size for the serial port.
          * @param characterSize The character size to be set.
@@ -235,6 +273,57 @@ namespace LibSerial
          */
         short GetVTime() const ;
 
+        /**
+         * @brief Enables or disables the low latency mode of the serial port driver.
+         * @param lowLatency True to enable low latency mode.
+         */
+        void SetLowLatency(const bool lowLatency) ;
+
+        /**
+         * @brief Determines whether the low latency mode of the serial port driver is enabled.
+         * @return Returns true if ASYNC_LOW_LATENCY is set.
+         */
+        bool IsLowLatency() const ;
+
+        /**
+         * @brief Applies a preset of VMIN, VTIME and driver buffering settings.
+         * @param latencyProfile The profile to be applied.
+         */
+        void SetLatencyProfile(const LatencyProfile& latencyProfile) ;
+
+        /**
+         * @brief Sets the size of the get area.
+         * @param bufferSize The size of the get area in bytes.
+         */
+        void SetReadBufferSize(size_t bufferSize) ;
+
+        /**
+         * @brief Gets the size of the get area.
+         * @return Returns the size of the get area in bytes.
+         */
+        size_t GetReadBufferSize() const ;
+
+        /**
+         * @brief Sets the size of the put area.
+         * @param bufferSize The size of the put area in bytes.
+         */
+        void SetWriteBufferSize(size_t bufferSize) ;
+
+        /**
+         * @brief Gets the size of the put area.
+         * @return Returns the size of the put area in bytes.
+         */
+        size_t GetWriteBufferSize() const ;
+
+        /**
+         * @brief Writes the put area followed by the specified buffers to
+         *        the serial port.
+         * @param buffers Pointer to the first of the buffers to write.
+         * @param numberOfBuffers The number of buffers to write.
+         */
+        void WriteV(const ConstBuffer* buffers,
+                    size_t             numberOfBuffers) ;
+
         /**
          * @brief Sets the serial port DTR line status.
          * @param dtrState The state to set the DTR line
@@ -283,6 +372,17 @@ namespace LibSerial
          */
         int GetNumberOfBytesAvailable() ;
 
+        /**
+         * @brief Gets the I/O statistics of the serial stream buffer.
+         * @return Returns a snapshot of the statistics.
+         */
+        SerialPortStatistics GetStatistics() const ;
+
+        /**
+         * @brief Clears the I/O statistics of the serial stream buffer.
+         */
+        void ResetStatistics() ;
+
 #ifdef __linux__
         /**
          * @brief Gets a list of available serial ports.
@@ -292,6 +392,12 @@ namespace LibSerial
         std::vector<std::string> GetAvailableSerialPorts() const ;
 #endif
 
+        /**
+         * @brief Writes any data held in the put area to the serial port.
+         * @return Returns 0 if successful, otherwise -1.
+         */
+        int sync() ;
+
         /**
          * @brief Writes up to n characters from the character sequence at
          *        char s to the serial port associated with the buffer.
@@ -341,9 +447,8 @@ namespace LibSerial
 
         /**
          * @brief This function is called when a putback of a character
-         *        fails. This must be implemented for unbuffered I/O as all
-         *        streambuf subclasses are required to provide putback of
-         *        at least one character.
+         *        fails, i.e. when the character does not match the previous
+         *        character in the get area or the get area is at its start.
          * @param character The character to putback.
          * @return Returns The character iff successful, otherwise eof to signal an error.
          */
@@ -356,32 +461,75 @@ namespace LibSerial
          */
         std::streamsize  showmanyc() ;
 
+    private:
+
         /**
-         * @brief True if a putback value is available in mPutbackChar.
-         *
-         * :TODO: Should this be private?
+         * @brief Writes the specified characters to the serial port,
+         *        retrying after partial writes.
+         * @param character Pointer to the characters to write.
+         * @param numberOfBytes The number of characters to write.
+         * @return Returns the number of characters actually written.
          */
-        bool mPutbackAvailable {false} ;
+        std::streamsize WriteToSerialPort(const char_type* character,
+                                          std::streamsize  numberOfBytes) ;
 
         /**
-         * @brief We use unbuffered I/O for the serial port. However, we
-         *        need to provide the putback of at least one character.
-         *        This character contains the putback character.
-         *
-         * :TODO: Should this be private?
+         * @brief Writes the contents of the put area to the serial port.
+         * @return Returns true iff the put area has been completely written.
          */
-        char mPutbackChar {0} ;
+        bool FlushPutArea() ;
 
-    private:
+        /**
+         * @brief Discards any unread characters held in the get area.
+         */
+        void DiscardGetArea() ;
+
+        /**
+         * @brief Discards any unwritten characters held in the put area.
+         */
+        void DiscardPutArea() ;
+
+        /**
+         * @brief Gets the number of unread characters held in the get area.
+         * @return Returns the number of unread characters in the get area.
+         */
+        std::streamsize GetNumberOfBufferedBytes() const ;
+
+        /**
+         * The SerialStreamBuf whose get and put areas are managed here.
+         */
+        SerialStreamBuf& mStreamBuf ;
+
+        /**
+         * Storage for the get area, preceded by PUTBACK_AREA_SIZE characters
+         * reserved for putback.
+         */
+        std::vector<char_type> mReadBuffer {} ;
+
+        /**
+         * Storage for the put area.
+         */
+        std::vector<char_type> mWriteBuffer {} ;
+
+        /**
+         * The size of the get area requested with SetReadBufferSize().
+         */
+        size_t mReadBufferSize = 0 ;
 
         /**
          * SerialPort device that will be used for communication.
          */
         SerialPort mSerialPort {} ;
+
+        /**
+         * @brief Counters and latency histograms of the I/O performed
+         *        directly on the file descriptor by the stream buffer.
+         */
+        IoStatistics mStatistics {} ;
     } ;
 
     SerialStreamBuf::SerialStreamBuf()
-        : mImpl(new Implementation)
+        : mImpl(new Implementation(*this))
     {
         setbuf(nullptr, 0) ;
     }
@@ -392,7 +540,8 @@ namespace LibSerial
                                      const FlowControl&   flowControlType,
                                      const Parity&        parityType,
                                      const StopBits&      stopBits)
-        : mImpl(new Implementation(fileName,
+        : mImpl(new Implementation(*this,
+                                   fileName,
                                    baudRate,
                                    characterSize,
                                    flowControlType,
@@ -412,6 +561,16 @@ namespace LibSerial
                     openMode) ;
     }
 
+    void
+    SerialStreamBuf::Open(const std::string& fileName,
+                          const PortSettings& portSettings,
+                          const std::ios_base::openmode& openMode)
+    {
+        mImpl->Open(fileName,
+                    portSettings,
+                    openMode) ;
+    }
+
     void
     SerialStreamBuf::Close()
     {
@@ -472,6 +631,18 @@ namespace LibSerial
         return mImpl->GetBaudRate() ;
     }
 
+    void
+    SerialStreamBuf::SetBitRate(const speed_t bitRate)
+    {
+        mImpl->SetBitRate(bitRate) ;
+    }
+
+    speed_t
+    SerialStreamBuf::GetBitRate() const
+    {
+        return mImpl->GetBitRate() ;
+    }
+
     void
     SerialStreamBuf::SetCharacterSize(const CharacterSize& characterSize)
     {
@@ -544,6 +715,63 @@ namespace LibSerial
         return mImpl->GetVTime() ;
     }
 
+    void
+    SerialStreamBuf::SetLowLatency(const bool lowLatency)
+    {
+        mImpl->SetLowLatency(lowLatency) ;
+    }
+
+    bool
+    SerialStreamBuf::IsLowLatency() const
+    {
+        return mImpl->IsLowLatency() ;
+    }
+
+    void
+    SerialStreamBuf::SetLatencyProfile(const LatencyProfile& latencyProfile)
+    {
+        mImpl->SetLatencyProfile(latencyProfile) ;
+    }
+
+    void
+    SerialStreamBuf::SetReadBufferSize(const size_t bufferSize)
+    {
+        mImpl->SetReadBufferSize(bufferSize) ;
+    }
+
+    size_t
+    SerialStreamBuf::GetReadBufferSize() const
+    {
+        return mImpl->GetReadBufferSize() ;
+    }
+
+    void
+    SerialStreamBuf::SetWriteBufferSize(const size_t bufferSize)
+    {
+        mImpl->SetWriteBufferSize(bufferSize) ;
+    }
+
+    size_t
+    SerialStreamBuf::GetWriteBufferSize() const
+    {
+        return mImpl->GetWriteBufferSize() ;
+    }
+
+    void
+    SerialStreamBuf::WriteV(const ConstBuffer* const buffers,
+                            const size_t             numberOfBuffers)
+    {
+        mImpl->WriteV(buffers,
+                      numberOfBuffers) ;
+    }
+
+    void
+    SerialStreamBuf::WriteV(const std::initializer_list<ConstBuffer> buffers)
+    {
+        mImpl->WriteV(buffers.begin(),
+                      buffers.size()) ;
+    }
+
     void
     SerialStreamBuf::SetDTR(const bool dtrState)
     {
@@ -592,6 +820,18 @@ namespace LibSerial
         return mImpl->GetNumberOfBytesAvailable() ;
     }
 
+    SerialPortStatistics
+    SerialStreamBuf::GetStatistics() const
+    {
+        return mImpl->GetStatistics() ;
+    }
+
+    void
+    SerialStreamBuf::ResetStatistics()
+    {
+        mImpl->ResetStatistics() ;
+    }
+
 #ifdef __linux__
     std::vector<std::string>
     SerialStreamBuf::GetAvailableSerialPorts() const
@@ -601,9 +841,20 @@ namespace LibSerial
 #endif
 
     std::streambuf*
-    SerialStreamBuf::setbuf(char_type* character, std::streamsize numberOfBytes)
+    SerialStreamBuf::setbuf(char_type* /* character */, std::streamsize numberOfBytes)
     {
-        return std::streambuf::setbuf(character, numberOfBytes) ;
+        const auto buffer_size = static_cast<size_t>(std::max(numberOfBytes, std::streamsize(0))) ;
+
+        mImpl->SetReadBufferSize(buffer_size) ;
+        mImpl->SetWriteBufferSize(buffer_size) ;
+
+        return this ;
+    }
+
+    int
+    SerialStreamBuf::sync()
+    {
+        return mImpl->sync() ;
     }
 
     std::streamsize
@@ -652,20 +903,31 @@ namespace LibSerial
     /** -------------------------- Implementation -------------------------- */
 
     inline
-    SerialStreamBuf::Implementation::Implementation(const std::string&   fileName,
+    SerialStreamBuf::Implementation::Implementation(SerialStreamBuf& streamBuf)
+        : mStreamBuf(streamBuf)
+    {
+        this->SetReadBufferSize(0) ;
+        this->SetWriteBufferSize(0) ;
+    }
+
+    inline
+    SerialStreamBuf::Implementation::Implementation(SerialStreamBuf&     streamBuf,
+                                                    const std::string&   fileName,
                                                     const BaudRate&      baudRate,
                                                     const CharacterSize& characterSize,
                                                     const FlowControl&   flowControlType,
                                                     const Parity&        parityType,
                                                     const StopBits&      stopBits)
-    try : mSerialPort(fileName,
+    try : mStreamBuf(streamBuf)
+        , mSerialPort(fileName,
                       baudRate, 
                       characterSize,
                       flowControlType,
                       parityType,
                       stopBits)
     {
-        //  empty
+        this->SetReadBufferSize(0) ;
+        this->SetWriteBufferSize(0) ;
     }
     catch (const std::exception& err)
     {
@@ -697,11 +959,27 @@ namespace LibSerial
     void
     SerialStreamBuf::Implementation::Open(const std::string& fileName,
                                           const std::ios_base::openmode& openMode)
+    {
+        this->Open(fileName,
+                   PortSettings {},
+                   openMode) ;
+    }
+
+    inline
+    void
+    SerialStreamBuf::Implementation::Open(const std::string& fileName,
+                                          const PortSettings& portSettings,
+                                          const std::ios_base::openmode& openMode)
     try
     {
-        mSerialPort.Open(fileName, 
+        mSerialPort.Open(fileName,
+                         portSettings,
                          openMode) ;
 
+        // Data buffered while the port was previously open is discarded.
+        this->DiscardGetArea() ;
+        this->DiscardPutArea() ;
+
         // @note - Stream communications need to happen in blocking mode.
         mSerialPort.SetSerialPortBlockingStatus(true) ;
     }
@@ -722,13 +1000,30 @@ namespace LibSerial
     void
     SerialStreamBuf::Implementation::Close()
     {
+        // Write out any buffered data before closing the port.
+        const auto is_flushed = (not this->IsOpen()) or this->FlushPutArea() ;
+        const auto error_number = errno ;
+
+        this->DiscardGetArea() ;
+        this->DiscardPutArea() ;
+
         mSerialPort.Close() ;
+
+        if (not is_flushed)
+        {
+            throw std::runtime_error(std::strerror(error_number)) ;
+        }
     }
 
     inline
     void
     SerialStreamBuf::Implementation::DrainWriteBuffer()
     {
+        if (not this->FlushPutArea())
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
         mSerialPort.DrainWriteBuffer() ;
     }
 
@@ -737,6 +1032,7 @@ namespace LibSerial
     SerialStreamBuf::Implementation::FlushInputBuffer()
     {
         mSerialPort.FlushInputBuffer() ;
+        this->DiscardGetArea() ;
     }
 
     inline
@@ -744,6 +1040,7 @@ namespace LibSerial
     SerialStreamBuf::Implementation::FlushOutputBuffer()
     {
         mSerialPort.FlushOutputBuffer() ;
+        this->DiscardPutArea() ;
     }
 
     inline
@@ -751,6 +1048,8 @@ namespace LibSerial
     SerialStreamBuf::Implementation::FlushIOBuffers()
     {
         mSerialPort.FlushIOBuffers() ;
+        this->DiscardGetArea() ;
+        this->DiscardPutArea() ;
     }
 
     inline
@@ -764,7 +1063,8 @@ namespace LibSerial
     bool
     SerialStreamBuf::Implementation::IsDataAvailable() 
     {
-        return mSerialPort.IsDataAvailable() ;
+        return (this->GetNumberOfBufferedBytes() > 0) or
+               mSerialPort.IsDataAvailable() ;
     }
 
     inline
@@ -788,6 +1088,20 @@ namespace LibSerial
         return mSerialPort.GetBaudRate() ;
     }
 
+    inline
+    void
+    SerialStreamBuf::Implementation::SetBitRate(const speed_t bitRate)
+    {
+        mSerialPort.SetBitRate(bitRate) ;
+    }
+
+    inline
+    speed_t
+    SerialStreamBuf::Implementation::GetBitRate() const
+    {
+        return mSerialPort.GetBitRate() ;
+    }
+
     inline
     void
     SerialStreamBuf::Implementation::SetCharacterSize(const CharacterSize& characterSize)
@@ -872,6 +1186,104 @@ namespace LibSerial
         return mSerialPort.GetVTime() ;
     }
 
+    inline
+    void
+    SerialStreamBuf::Implementation::SetLowLatency(const bool lowLatency)
+    {
+        mSerialPort.SetLowLatency(lowLatency) ;
+    }
+
+    inline
+    bool
+    SerialStreamBuf::Implementation::IsLowLatency() const
+    {
+        return mSerialPort.IsLowLatency() ;
+    }
+
+    inline
+    void
+    SerialStreamBuf::Implementation::SetLatencyProfile(const LatencyProfile& latencyProfile)
+    {
+        mSerialPort.SetLatencyProfile(latencyProfile) ;
+    }
+
+    inline
+    void
+    SerialStreamBuf::Implementation::SetReadBufferSize(const size_t bufferSize)
+    {
+        // Preserve any characters that have been read but not consumed yet.
+        const auto number_of_buffered_bytes = static_cast<size_t>(this->GetNumberOfBufferedBytes()) ;
+
+        std::vector<char_type> read_buffer(PUTBACK_AREA_SIZE +
+                                           std::max({bufferSize,
+                                                     number_of_buffered_bytes,
+                                                     static_cast<size_t>(1)})) ;
+
+        const auto get_area = &read_buffer[PUTBACK_AREA_SIZE] ;
+
+        if (number_of_buffered_bytes > 0)
+        {
+            std::memcpy(get_area,
+                        mStreamBuf.gptr(),
+                        number_of_buffered_bytes) ;
+        }
+
+        mReadBuffer.swap(read_buffer) ;
+        mReadBufferSize = bufferSize ;
+
+        mStreamBuf.setg(get_area,
+                        get_area,
+                        get_area + number_of_buffered_bytes) ;
+    }
+
+    inline
+    size_t
+    SerialStreamBuf::Implementation::GetReadBufferSize() const
+    {
+        return mReadBufferSize ;
+    }
+
+    inline
+    void
+    SerialStreamBuf::Implementation::SetWriteBufferSize(const size_t bufferSize)
+    {
+        if (not this->FlushPutArea())
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        mWriteBuffer.assign(bufferSize, 0) ;
+        this->DiscardPutArea() ;
+    }
+
+    inline
+    size_t
+    SerialStreamBuf::Implementation::GetWriteBufferSize() const
+    {
+        return mWriteBuffer.size() ;
+    }
+
+    inline
+    void
+    SerialStreamBuf::Implementation::WriteV(const ConstBuffer* const buffers,
+                                            const size_t             numberOfBuffers)
+    {
+        // Throw an exception if the serial port is not open.
+        if (not this->IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        // Preserve the ordering of data already written to the stream.
+        if (not this->FlushPutArea())
+        {
+            throw std::runtime_error(std::strerror(errno)) ;
+        }
+
+        mSerialPort.WriteV(buffers,
+                           numberOfBuffers) ;
+    }
+
     inline
     void
     SerialStreamBuf::Implementation::SetDTR(const bool dtrState)
@@ -925,7 +1337,31 @@ namespace LibSerial
     int
     SerialStreamBuf::Implementation::GetNumberOfBytesAvailable()
     {
-        return mSerialPort.GetNumberOfBytesAvailable() ;
+        return static_cast<int>(this->GetNumberOfBufferedBytes()) +
+               mSerialPort.GetNumberOfBytesAvailable() ;
+    }
+
+    inline
+    SerialPortStatistics
+    SerialStreamBuf::Implementation::GetStatistics() const
+    {
+        // Reads of the get area and writes of the put area use the file
+        // descriptor directly and are recorded in mStatistics, while
+        // WriteV() and the port's own methods are recorded by the serial
+        // port. Each call is counted in one of the two, so the sum of both
+        // counts nothing twice.
+        auto statistics = mStatistics.GetSnapshot() ;
+        statistics.Merge(mSerialPort.GetStatistics()) ;
+
+        return statistics ;
+    }
+
+    inline
+    void
+    SerialStreamBuf::Implementation::ResetStatistics()
+    {
+        mStatistics.Reset() ;
+        mSerialPort.ResetStatistics() ;
     }
 
 #ifdef __linux__
@@ -937,6 +1373,25 @@ namespace LibSerial
     }
 #endif
 
+    inline
+    int
+    SerialStreamBuf::Implementation::sync()
+    {
+        // Nothing needs to be done if the put area is empty.
+        if (mStreamBuf.pptr() == mStreamBuf.pbase())
+        {
+            return 0 ;
+        }
+
+        if ((not this->IsOpen()) or
+            (not this->FlushPutArea()))
+        {
+            return -1 ;
+        }
+
+        return 0 ;
+    }
+
     inline
     std::streamsize
     SerialStreamBuf::Implementation::xsputn(const char_type* character,
@@ -954,21 +1409,36 @@ namespace LibSerial
             return 0 ;
         }
 
-        // Write the n characters to the serial port.
-        // 
-        // :TODO: Consider using mSerialPort.Write() here instead of writing
-        //        to the file descriptor directly.
-        const auto fd = mSerialPort.GetFileDescriptor() ;
-        ssize_t result = call_with_retry(write, fd, character, numberOfBytes) ;
+        // Copy the characters into the put area if they fit.
+        if (numberOfBytes <= mStreamBuf.epptr() - mStreamBuf.pptr())
+        {
+            std::memcpy(mStreamBuf.pptr(),
+                        character,
+                        numberOfBytes) ;
 
-        // If the write failed then return 0.
-        if (result <= 0)
+            mStreamBuf.pbump(static_cast<int>(numberOfBytes)) ;
+            return numberOfBytes ;
+        }
+
+        // Otherwise, make room by writing out the put area first.
+        if (not this->FlushPutArea())
         {
             return 0 ;
         }
 
-        // Otherwise, return the number of bytes actually written.
-        return result;
+        // Writes at least as large as the put area bypass it entirely.
+        if (numberOfBytes >= static_cast<std::streamsize>(mWriteBuffer.size()))
+        {
+            return this->WriteToSerialPort(character,
+                                           numberOfBytes) ;
+        }
+
+        std::memcpy(mStreamBuf.pptr(),
+                    character,
+                    numberOfBytes) ;
+
+        mStreamBuf.pbump(static_cast<int>(numberOfBytes)) ;
+        return numberOfBytes ;
     }
 
     inline
@@ -992,64 +1462,74 @@ namespace LibSerial
             return 0 ;
         }
 
-        // Try to read up to n characters in the array s.
-        ssize_t result = -1;
+        std::streamsize number_of_bytes_read = 0 ;
 
-        // If a putback character is available, then we need to read only
-        // n-1 character.
-        if (mPutbackAvailable)
+        while (number_of_bytes_read < numberOfBytes)
         {
-            // Put the mPutbackChar at the beginning of the array 's'.
-            // Increment result to indicate that a character has been placed in s.
-            character[0] = mPutbackChar;
-            result++;
-
-            // The putback character is no longer available.
-            mPutbackAvailable = false;
-
-            // If we need to read more than one character, then call read()
-            // and try to read numberOfBytes-1 more characters and put them
-            // at location starting from &character[1].
-            if (numberOfBytes > 1)
+            const auto number_of_bytes_remaining = numberOfBytes - number_of_bytes_read ;
+            const auto number_of_buffered_bytes = this->GetNumberOfBufferedBytes() ;
+
+            // Consume the characters held in the get area first.
+            if (number_of_buffered_bytes > 0)
+            {
+                const auto number_of_bytes_to_copy = std::min(number_of_buffered_bytes,
+                                                              number_of_bytes_remaining) ;
+
+                std::memcpy(&character[number_of_bytes_read],
+                            mStreamBuf.gptr(),
+                            number_of_bytes_to_copy) ;
+
+                mStreamBuf.gbump(static_cast<int>(number_of_bytes_to_copy)) ;
+                number_of_bytes_read += number_of_bytes_to_copy ;
+                continue ;
+            }
+
+            // Requests at least as large as the get area are read directly
+            // into the destination array.
+            if (number_of_bytes_remaining >= static_cast<std::streamsize>(mReadBuffer.size() - PUTBACK_AREA_SIZE))
             {
-                // 
-                // :TODO: Consider using mSerialPort.Read() here instead of
-                // using the file descriptor.
-                //
                 const auto fd = mSerialPort.GetFileDescriptor() ;
-                result = call_with_retry(read, fd, &character[1], numberOfBytes-1) ;
 
-                // If read was successful, then we need to increment result by
-                // one to indicate that the putback character was prepended to
-                // the array, s. If read failed then leave result at -1.
-                if (result != -1)
+                LIBSERIAL_STATISTICS(const auto wait_start = std::chrono::steady_clock::now()) ;
+
+                const auto result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                              read,
+                                                              fd,
+                                                              &character[number_of_bytes_read],
+                                                              number_of_bytes_remaining) ;
+
+                LIBSERIAL_STATISTICS(this->mStatistics.RecordReadWait(std::chrono::steady_clock::now() - wait_start)) ;
+                LIBSERIAL_STATISTICS(this->mStatistics.RecordRead(result)) ;
+
+                if (result <= 0)
                 {
-                    result++;
+                    break ;
                 }
+
+                // Keep the most recently read characters available for putback.
+                const auto putback_count = std::min(static_cast<size_t>(result), PUTBACK_AREA_SIZE) ;
+                const auto get_area = &mReadBuffer[PUTBACK_AREA_SIZE] ;
+
+                std::memcpy(get_area - putback_count,
+                            &character[number_of_bytes_read + result - putback_count],
+                            putback_count) ;
+
+                mStreamBuf.setg(get_area - putback_count,
+                                get_area,
+                                get_area) ;
+
+                number_of_bytes_read += result ;
+                continue ;
             }
-        }
-        else
-        {
-            // If no putback character is available then we try to
-            // read numberOfBytes characters.
-            // 
-            // :TODO: Consider using mSerialPort.Read() here instead of
-            //        using the file descriptor.
-            const auto fd = mSerialPort.GetFileDescriptor() ;
-            result = call_with_retry(read, fd, character, numberOfBytes) ;
-        }
 
-        // If result == -1 then the read call had an error, otherwise, if
-        // result == 0 then we could not read the characters. In either
-        // case, we return 0 to indicate that no characters could be read
-        // from the serial port.
-        if (result <= 0)
-        {
-            return 0 ;
+            if (traits_type::eq_int_type(this->underflow(), traits_type::eof()))
+            {
+                break ;
+            }
         }
 
         // Return the number of characters actually read from the serial port.
-        return result;
+        return number_of_bytes_read ;
     }
 
     inline
@@ -1062,25 +1542,33 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
+        // Make room in the put area by writing out its contents.
+        if (not this->FlushPutArea())
+        {
+            return traits_type::eof() ;
+        }
+
         // Try to write the specified character to the serial port.
         if (traits_type::eq_int_type(character, traits_type::eof()))
         {
             // If character is the eof character then we do nothing.
-            return traits_type::eof() ;
+            return traits_type::not_eof(character) ;
         }
 
-        // Otherwise we write the character to the serial port.
-        // 
-        // :TODO: Consider using a method of SerialPort class here instead
-        //        of using the file descriptor.
-        const auto fd = mSerialPort.GetFileDescriptor() ;
-        char out_char = traits_type::to_char_type(character) ;
-        ssize_t result = call_with_retry(write, fd, &out_char, 1) ;
+        const char out_char = traits_type::to_char_type(character) ;
 
-        // If the write failed then return eof.
-        if (result <= 0)
+        if (mWriteBuffer.empty())
         {
-            return traits_type::eof() ;
+            // Unbuffered output writes the character immediately.
+            if (this->WriteToSerialPort(&out_char, 1) != 1)
+            {
+                return traits_type::eof() ;
+            }
+        }
+        else
+        {
+            *mStreamBuf.pptr() = out_char ;
+            mStreamBuf.pbump(1) ;
         }
 
         // Otherwise, return something other than eof().
@@ -1097,51 +1585,68 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // Read the next character from the serial port.
-        char next_char = 0 ;
-        ssize_t result = -1;
+        // Return the next character if the get area is not empty.
+        if (mStreamBuf.gptr() < mStreamBuf.egptr())
+        {
+            return traits_type::to_int_type(*mStreamBuf.gptr()) ;
+        }
+
+        // Move the most recently read characters into the putback area so
+        // that they remain available for putback after refilling.
+        const auto get_area = &mReadBuffer[PUTBACK_AREA_SIZE] ;
+        const auto putback_count = std::min(static_cast<size_t>(mStreamBuf.gptr() - mStreamBuf.eback()),
+                                            PUTBACK_AREA_SIZE) ;
 
-        // If a putback character is available then we return that
-        // character. However, we are not supposed to change the value of
-        // gptr() in this routine so we leave mPutbackAvailable set to true.
-        if (mPutbackAvailable)
+        std::memmove(get_area - putback_count,
+                     mStreamBuf.gptr() - putback_count,
+                     putback_count) ;
+
+        // Fill the get area with everything the driver has already received,
+        // blocking for at least one character. Large buffers are filled
+        // with a single read() instead of one call per character.
+        auto number_of_bytes_to_read = mReadBuffer.size() - PUTBACK_AREA_SIZE ;
+
+        if (number_of_bytes_to_read > 1)
         {
-            next_char = mPutbackChar;
+            const auto number_of_bytes_available = mSerialPort.GetNumberOfBytesAvailable() ;
+
+            number_of_bytes_to_read = std::min(number_of_bytes_to_read,
+                                               static_cast<size_t>(std::max(number_of_bytes_available, 1))) ;
         }
-        else
+
+        const auto fd = mSerialPort.GetFileDescriptor() ;
+
+        // The port is in blocking mode, so the time spent in read() is the
+        // time spent waiting for data to arrive.
+        LIBSERIAL_STATISTICS(const auto wait_start = std::chrono::steady_clock::now()) ;
+
+        const auto result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                      read,
+                                                      fd,
+                                                      get_area,
+                                                      number_of_bytes_to_read) ;
+
+        LIBSERIAL_STATISTICS(this->mStatistics.RecordReadWait(std::chrono::steady_clock::now() - wait_start)) ;
+        LIBSERIAL_STATISTICS(this->mStatistics.RecordRead(result)) ;
+
+        if (result <= 0)
         {
-            // If no putback character is available then we need to read one
-            // character from the serial port.
-            // 
-            // :TODO: Consider using a method of SerialPort class here instead
-            // of using the file descriptor.
-            //
-            const auto fd = mSerialPort.GetFileDescriptor() ;
-            result = call_with_retry(read, fd, &next_char, 1) ;
-
-            // Make the next character the putback character. This has the
-            // effect of returning the next character without changing gptr()
-            // as required by the C++ standard.
-            if (result == 1)
-            {
-                mPutbackChar = next_char;
-                mPutbackAvailable = true ;
-            }
-            else if (result <= 0)
-            {
-                // If we had a problem reading the character, we return
-                // traits::eof().
-                return traits_type::eof() ;
-            }
+            // If we had a problem reading the character, we return
+            // traits::eof().
+            mStreamBuf.setg(get_area - putback_count,
+                            get_area,
+                            get_area) ;
+
+            return traits_type::eof() ;
         }
 
-        // :NOTE: Wed Aug  9 21:26:51 2000 Pagey
-        //        The value of mPutbackAvailable is always true when the code
-        //        reaches here.
+        mStreamBuf.setg(get_area - putback_count,
+                        get_area,
+                        get_area + result) ;
 
         // Return the character as an int value as required by the C++
         // standard.
-        return traits_type::to_int_type(next_char) ;
+        return traits_type::to_int_type(*mStreamBuf.gptr()) ;
     }
 
     inline
@@ -1154,11 +1659,14 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        int_type next_char = underflow() ;
+        const auto next_char = underflow() ;
 
-        mPutbackAvailable = false;
+        if (not traits_type::eq_int_type(next_char, traits_type::eof()))
+        {
+            mStreamBuf.gbump(1) ;
+        }
 
-        return next_char;
+        return next_char ;
     }
 
     inline
@@ -1171,12 +1679,6 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        // If a putback character is already available, then we cannot
-        // do any more putback and hence need to return eof.
-        if (mPutbackAvailable)
-        {
-            return traits_type::eof() ;
-        }
         if (traits_type::eq_int_type(character, traits_type::eof()))
         {
             // If an eof character is passed in, then we are required to
@@ -1184,11 +1686,23 @@ namespace LibSerial
             // port. Hence we return eof to signal an error.
             return traits_type::eof() ;
         }
-        //
-        // If no putback character is available at present, then make
-        // "character" the putback character and return it.
-        mPutbackChar = traits_type::to_char_type(character) ;
-        mPutbackAvailable = true ;
+
+        // If the putback area is exhausted we cannot do any more putback and
+        // hence need to return eof.
+        if (mStreamBuf.gptr() == mReadBuffer.data())
+        {
+            return traits_type::eof() ;
+        }
+
+        // Otherwise, store the character in front of the current position
+        // and make it the next character to be read.
+        const auto putback_position = mStreamBuf.gptr() - 1 ;
+        *putback_position = traits_type::to_char_type(character) ;
+
+        mStreamBuf.setg(std::min(mStreamBuf.eback(), putback_position),
+                        putback_position,
+                        mStreamBuf.egptr()) ;
+
         return traits_type::not_eof(character) ;
     }
 
@@ -1202,23 +1716,106 @@ namespace LibSerial
             throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
         }
 
-        ssize_t number_of_bytes_available = 0 ;
+        // This is only called by in_avail() once the get area is empty.
+        return mSerialPort.GetNumberOfBytesAvailable() ;
+    }
 
-        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
-        // 
-        // :TODO: Consider using a method of SerialPort class here instead
-        //        of using the file descriptor.
+    inline
+    std::streamsize
+    SerialStreamBuf::Implementation::WriteToSerialPort(const char_type*      character,
+                                                       const std::streamsize numberOfBytes)
+    {
         const auto fd = mSerialPort.GetFileDescriptor() ;
-        const auto result = call_with_retry(ioctl,
-                                            fd,
-                                            FIONREAD,
-                                            &number_of_bytes_available) ;
 
-        if ((result >= 0) and (number_of_bytes_available > 0))
+        std::streamsize number_of_bytes_written = 0 ;
+
+        LIBSERIAL_STATISTICS(const auto write_start = std::chrono::steady_clock::now()) ;
+
+        while (number_of_bytes_written < numberOfBytes)
+        {
+            const auto result = LIBSERIAL_CALL_WITH_RETRY(this->mStatistics,
+                                                          write,
+                                                          fd,
+                                                          &character[number_of_bytes_written],
+                                                          numberOfBytes - number_of_bytes_written) ;
+
+            LIBSERIAL_STATISTICS(this->mStatistics.RecordWrite(result)) ;
+
+            // If the write failed then return the number of bytes written so far.
+            if (result <= 0)
+            {
+                break ;
+            }
+
+            number_of_bytes_written += result ;
+        }
+
+        LIBSERIAL_STATISTICS(this->mStatistics.RecordWriteCompletion(std::chrono::steady_clock::now() - write_start)) ;
+
+        return number_of_bytes_written ;
+    }
+
+    inline
+    bool
+    SerialStreamBuf::Implementation::FlushPutArea()
+    {
+        const auto number_of_bytes_pending = mStreamBuf.pptr() - mStreamBuf.pbase() ;
+
+        if (number_of_bytes_pending == 0)
+        {
+            return true ;
+        }
+
+        const auto number_of_bytes_written = this->WriteToSerialPort(mStreamBuf.pbase(),
+                                                                     number_of_bytes_pending) ;
+
+        if (number_of_bytes_written < number_of_bytes_pending)
         {
-            mPutbackAvailable = true ;
+            // Keep the characters that could not be written at the start of
+            // the put area so that a later flush can retry them.
+            const auto error_number = errno ;
+
+            std::memmove(mStreamBuf.pbase(),
+                         mStreamBuf.pbase() + number_of_bytes_written,
+                         number_of_bytes_pending - number_of_bytes_written) ;
+
+            this->DiscardPutArea() ;
+            mStreamBuf.pbump(static_cast<int>(number_of_bytes_pending - number_of_bytes_written)) ;
+
+            errno = error_number ;
+            return false ;
         }
 
-        return number_of_bytes_available;
+        this->DiscardPutArea() ;
+        return true ;
+    }
+
+    inline
+    void
+    SerialStreamBuf::Implementation::DiscardGetArea()
+    {
+        const auto get_area = &mReadBuffer[PUTBACK_AREA_SIZE] ;
+
+        mStreamBuf.setg(get_area,
+                        get_area,
+                        get_area) ;
     }
+
+    inline
+    void
+    SerialStreamBuf::Implementation::DiscardPutArea()
+    {
+        // With unbuffered output the put area is empty, so every write goes
+        // through overflow() or xsputn() and reaches the port immediately.
+        mStreamBuf.setp(mWriteBuffer.data(),
+                        mWriteBuffer.data() + mWriteBuffer.size()) ;
+    }
+
+    inline
+    std::streamsize
+    SerialStreamBuf::Implementation::GetNumberOfBufferedBytes() const
+    {
+        return mStreamBuf.egptr() - mStreamBuf.gptr() ;
+    }
+
 } // namespace LibSerial
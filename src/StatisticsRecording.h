@@ -0,0 +1,53 @@
+/******************************************************************************
+ * @file StatisticsRecording.h                                                *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPort.h>
+#include <libserial/SerialPortStatistics.h>
+
+/**
+ * @brief Statistics are only gathered when the library is built with
+ *        LIBSERIAL_ENABLE_STATISTICS defined. Otherwise the recording
+ *        statements in the I/O paths compile to nothing, and the statistics
+ *        reported by SerialPort and SerialStreamBuf are always zero. These
+ *        macros are only used inside the library, so that the definition
+ *        seen by applications never affects them.
+ */
+#ifdef LIBSERIAL_ENABLE_STATISTICS
+#define LIBSERIAL_STATISTICS(statement) statement
+#define LIBSERIAL_CALL_WITH_RETRY(ioStatistics, ...) (ioStatistics).CallWithRetry(__VA_ARGS__)
+#else
+#define LIBSERIAL_STATISTICS(statement)
+#define LIBSERIAL_CALL_WITH_RETRY(ioStatistics, ...) call_with_retry(__VA_ARGS__)
+#endif
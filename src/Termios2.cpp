@@ -0,0 +1,85 @@
+/******************************************************************************
+ * @file Termios2.cpp                                                         *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "Termios2.h"
+
+#include <asm/ioctls.h>
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+
+namespace LibSerial
+{
+    static_assert(TERMIOS2_CUSTOM_SPEED == BOTHER,
+                  "TERMIOS2_CUSTOM_SPEED must match BOTHER.") ;
+
+    int
+    SetTermios2BitRate(const int          fileDescriptor,
+                       const unsigned int bitRate)
+    {
+        termios2 port_settings {} ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (ioctl(fileDescriptor, TCGETS2, &port_settings) < 0)
+        {
+            return -1 ;
+        }
+
+        // Clear both the output speed and the input speed, which then
+        // follows the output speed.
+        port_settings.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT)) ;   // NOLINT (hicpp-signed-bitwise)
+        port_settings.c_cflag |= BOTHER ;                         // NOLINT (hicpp-signed-bitwise)
+        port_settings.c_ispeed = bitRate ;
+        port_settings.c_ospeed = bitRate ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        return ioctl(fileDescriptor, TCSETS2, &port_settings) ;
+    }
+
+    int
+    GetTermios2BitRate(const int     fileDescriptor,
+                       unsigned int& bitRate)
+    {
+        termios2 port_settings {} ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (ioctl(fileDescriptor, TCGETS2, &port_settings) < 0)
+        {
+            return -1 ;
+        }
+
+        bitRate = port_settings.c_ospeed ;
+
+        return 0 ;
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,70 @@
+/******************************************************************************
+ * @file Termios2.h                                                           *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+namespace LibSerial
+{
+    /**
+     * The termios2 interface of the Linux kernel, which sets the bit rate of
+     * a serial port as an integer rather than as one of the Bxxx constants.
+     * It is declared in <asm/termbits.h>, whose struct termios conflicts with
+     * the one in <termios.h>, so it is only used from Termios2.cpp.
+     */
+
+    /**
+     * @brief The c_cflag speed value, BOTHER in <asm/termbits.h>, that
+     *        selects the bit rate stored in the c_ispeed and c_ospeed fields.
+     */
+    constexpr unsigned int TERMIOS2_CUSTOM_SPEED = 0010000 ;
+
+    /**
+     * @brief Sets the input and output bit rate of a serial port with
+     *        TCSETS2 and BOTHER, leaving the other settings unchanged.
+     * @param fileDescriptor The file descriptor of the serial port.
+     * @param bitRate The bit rate in bits per second.
+     * @return Returns 0 on success, or -1 with errno set on failure.
+     */
+    int SetTermios2BitRate(int          fileDescriptor,
+                           unsigned int bitRate) ;
+
+    /**
+     * @brief Gets the output bit rate of a serial port with TCGETS2.
+     * @param fileDescriptor The file descriptor of the serial port.
+     * @param bitRate The bit rate in bits per second.
+     * @return Returns 0 on success, or -1 with errno set on failure.
+     */
+    int GetTermios2BitRate(int           fileDescriptor,
+                           unsigned int& bitRate) ;
+
+} // namespace LibSerial
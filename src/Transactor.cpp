@@ -0,0 +1,748 @@
+/******************************************************************************
+ * @file Transactor.cpp                                                       *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/Transactor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace LibSerial
+{
+    /**
+     * @brief Transactor::Implementation is the Transactor implementation
+     *        class.
+     */
+    class Transactor::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param serialPort The open serial port to perform transactions on.
+         * @param frameCodec The codec used to encode requests and decode
+         *        responses.
+         * @param transactorPolicy The tuning parameters.
+         * @param responseKeyFunction Function extracting the key of each
+         *        response, or empty to match responses in request order.
+         */
+        explicit Implementation(SerialPort&                 serialPort,
+                                std::unique_ptr<FrameCodec> frameCodec,
+                                const TransactorPolicy&     transactorPolicy,
+                                const ResponseKeyFunction&  responseKeyFunction) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        ~Implementation() = default ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Queues a request.
+         * @param request The request payload.
+         * @param responseHandler The handler invoked when the transaction
+         *        completes.
+         * @param key The key of the expected response.
+         * @return Returns the handle identifying the transaction.
+         */
+        TransactionId Submit(const DataBuffer&      request,
+                             const ResponseHandler& responseHandler,
+                             uint64_t               key) ;
+
+        /**
+         * @brief Sends queued requests and dispatches responses and timeouts
+         *        until at least one transaction has completed.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of transactions that completed.
+         */
+        size_t RunOnce(size_t msTimeout) ;
+
+        /**
+         * @brief Dispatches responses and timeouts until every transaction
+         *        has completed.
+         */
+        void Drain() ;
+
+        /**
+         * @brief Gets the number of outstanding transactions.
+         * @return Returns the number of outstanding transactions.
+         */
+        size_t GetNumberOfOutstandingTransactions() const ;
+
+        /**
+         * @brief Gets the number of requests in flight.
+         * @return Returns the number of requests in flight.
+         */
+        size_t GetNumberOfTransactionsInFlight() const ;
+
+        /**
+         * @brief Gets the number of requests sent again after a timeout.
+         * @return Returns the number of retries.
+         */
+        size_t GetNumberOfRetries() const ;
+
+        /**
+         * @brief Gets the number of responses discarded.
+         * @return Returns the number of unmatched responses.
+         */
+        size_t GetNumberOfUnmatchedResponses() const ;
+
+    private:
+
+        /**
+         * @brief The state of a submitted transaction.
+         */
+        struct Transaction
+        {
+            uint64_t        key              = 0 ;  // !< The key of the expected response.
+            DataBuffer      encodedRequest   {} ;   // !< The request, encoded once at submission.
+            ResponseHandler responseHandler  {} ;   // !< The handler invoked on completion.
+            size_t          numberOfAttempts = 0 ;  // !< The number of times the request was sent.
+            bool            inFlight         = false ; // !< True while awaiting a response to the last attempt.
+        } ;
+
+        /**
+         * @brief The deadline of one attempt of a transaction, held in the
+         *        timer wheel slot of its tick. Entries of transactions that
+         *        have since completed or been sent again are discarded when
+         *        their slot is next visited, so they never need to be found
+         *        and removed.
+         */
+        struct TimerEntry
+        {
+            TransactionId transactionId ; // !< The transaction the deadline belongs to.
+            size_t        attempt ;       // !< The attempt the deadline belongs to.
+            uint64_t      deadlineTick ;  // !< The tick at which the attempt expires.
+        } ;
+
+        /**
+         * @brief Gets the number of timer ticks elapsed since construction.
+         * @return Returns the current tick.
+         */
+        uint64_t GetCurrentTick() const ;
+
+        /**
+         * @brief Sends queued requests, as one write, while the window
+         *        allows, and starts the deadline of each of them.
+         */
+        void SendRequests() ;
+
+        /**
+         * @brief Matches a response to its transaction and completes it.
+         * @param response The response payload.
+         * @return Returns the number of transactions that completed.
+         */
+        size_t DispatchResponse(const ConstBuffer& response) ;
+
+        /**
+         * @brief Advances the timer wheel to the current tick, sending again
+         *        or failing each request whose deadline has passed.
+         * @return Returns the number of transactions that failed.
+         */
+        size_t ExpireDeadlines() ;
+
+        /**
+         * @brief Gets the time until the first occupied slot of the timer
+         *        wheel is due.
+         * @return Returns the time in milliseconds, at least one.
+         */
+        size_t GetTimeToNextDeadline() const ;
+
+        /**
+         * @brief Removes a transaction and invokes its handler.
+         * @param transactionId The handle of the transaction.
+         * @param error The error to pass to the handler, if any.
+         * @param response The response to pass to the handler.
+         */
+        void CompleteTransaction(TransactionId      transactionId,
+                                 std::exception_ptr error,
+                                 DataBuffer         response) ;
+
+        /**
+         * @brief The serial port transactions are performed on.
+         */
+        SerialPort& mSerialPort ;
+
+        /**
+         * @brief The frame reader decoding responses. Its codec also encodes
+         *        requests.
+         */
+        FrameReader mFrameReader ;
+
+        /**
+         * @brief The tuning parameters.
+         */
+        TransactorPolicy mPolicy ;
+
+        /**
+         * @brief Function extracting the key of each response, or empty to
+         *        match responses in request order.
+         */
+        ResponseKeyFunction mResponseKeyFunction ;
+
+        /**
+         * @brief The outstanding transactions, indexed by handle.
+         */
+        std::map<TransactionId, Transaction> mTransactions {} ;
+
+        /**
+         * @brief The transactions waiting to be sent, in sending order.
+         */
+        std::deque<TransactionId> mPendingRequests {} ;
+
+        /**
+         * @brief The transactions in flight, in the order they were sent.
+         */
+        std::deque<TransactionId> mRequestsInFlight {} ;
+
+        /**
+         * @brief The outstanding transactions indexed by response key, used
+         *        only with a response key function.
+         */
+        std::map<uint64_t, TransactionId> mTransactionKeys {} ;
+
+        /**
+         * @brief The timer wheel. Slot i holds the deadlines falling on the
+         *        ticks equal to i modulo the number of slots.
+         */
+        std::vector<std::vector<TimerEntry>> mTimerWheel ;
+
+        /**
+         * @brief The last tick whose slot has been visited.
+         */
+        uint64_t mCurrentTick = 0 ;
+
+        /**
+         * @brief The time from which ticks are counted.
+         */
+        std::chrono::steady_clock::time_point mStartTime ;
+
+        /**
+         * @brief The buffer into which requests released together are
+         *        encoded, so that they are sent with a single write.
+         */
+        DataBuffer mSendBuffer {} ;
+
+        /**
+         * @brief The handle that will be assigned to the next transaction.
+         */
+        TransactionId mNextTransactionId = 1 ;
+
+        /**
+         * @brief The number of requests sent again after a timeout.
+         */
+        size_t mNumberOfRetries = 0 ;
+
+        /**
+         * @brief The number of responses that matched no transaction.
+         */
+        size_t mNumberOfUnmatchedResponses = 0 ;
+    } ;
+
+    Transactor::Transactor(SerialPort&                 serialPort,
+                           std::unique_ptr<FrameCodec> frameCodec,
+                           const TransactorPolicy&     transactorPolicy,
+                           const ResponseKeyFunction&  responseKeyFunction)
+        : mImpl(new Implementation(serialPort,
+                                   std::move(frameCodec),
+                                   transactorPolicy,
+                                   responseKeyFunction))
+    {
+        /* Empty */
+    }
+
+    Transactor::~Transactor() = default ;
+
+    Transactor::TransactionId
+    Transactor::Submit(const DataBuffer&      request,
+                       const ResponseHandler& responseHandler,
+                       const uint64_t         key)
+    {
+        return mImpl->Submit(request,
+                             responseHandler,
+                             key) ;
+    }
+
+    size_t
+    Transactor::RunOnce(const size_t msTimeout)
+    {
+        return mImpl->RunOnce(msTimeout) ;
+    }
+
+    void
+    Transactor::Drain()
+    {
+        mImpl->Drain() ;
+    }
+
+    size_t
+    Transactor::GetNumberOfOutstandingTransactions() const
+    {
+        return mImpl->GetNumberOfOutstandingTransactions() ;
+    }
+
+    size_t
+    Transactor::GetNumberOfTransactionsInFlight() const
+    {
+        return mImpl->GetNumberOfTransactionsInFlight() ;
+    }
+
+    size_t
+    Transactor::GetNumberOfRetries() const
+    {
+        return mImpl->GetNumberOfRetries() ;
+    }
+
+    size_t
+    Transactor::GetNumberOfUnmatchedResponses() const
+    {
+        return mImpl->GetNumberOfUnmatchedResponses() ;
+    }
+
+    inline
+    Transactor::Implementation::Implementation(SerialPort&                 serialPort,
+                                               std::unique_ptr<FrameCodec> frameCodec,
+                                               const TransactorPolicy&     transactorPolicy,
+                                               const ResponseKeyFunction&  responseKeyFunction)
+        : mSerialPort(serialPort)
+        , mFrameReader(serialPort,
+                       std::move(frameCodec),
+                       transactorPolicy.bufferSize)
+        , mPolicy(transactorPolicy)
+        , mResponseKeyFunction(responseKeyFunction)
+        , mTimerWheel()
+        , mStartTime(std::chrono::steady_clock::now())
+    {
+        if (mPolicy.windowSize == 0)
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_WINDOW_SIZE) ;
+        }
+
+        if ((mPolicy.msTimerResolution == 0) or
+            (mPolicy.numberOfTimerSlots == 0))
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_TIMER_WHEEL) ;
+        }
+
+        mTimerWheel.resize(mPolicy.numberOfTimerSlots) ;
+    }
+
+    inline
+    Transactor::TransactionId
+    Transactor::Implementation::Submit(const DataBuffer&      request,
+                                       const ResponseHandler& responseHandler,
+                                       const uint64_t         key)
+    {
+        if (mResponseKeyFunction and
+            (mTransactionKeys.count(key) != 0))
+        {
+            throw std::invalid_argument(ERR_MSG_DUPLICATE_KEY) ;
+        }
+
+        Transaction transaction {} ;
+        transaction.key = key ;
+        transaction.responseHandler = responseHandler ;
+
+        mFrameReader.GetFrameCodec().Encode(request.data(),
+                                            request.size(),
+                                            transaction.encodedRequest) ;
+
+        const auto transaction_id = mNextTransactionId++ ;
+
+        mTransactions.emplace(transaction_id, std::move(transaction)) ;
+        mPendingRequests.push_back(transaction_id) ;
+
+        if (mResponseKeyFunction)
+        {
+            mTransactionKeys.emplace(key, transaction_id) ;
+        }
+
+        return transaction_id ;
+    }
+
+    inline
+    size_t
+    Transactor::Implementation::RunOnce(const size_t msTimeout)
+    {
+        using std::chrono::steady_clock ;
+
+        // Obtain the entry time.
+        const auto entry_time = steady_clock::now() ;
+
+        size_t number_of_transactions = 0 ;
+
+        while ((number_of_transactions == 0) and
+               (not mTransactions.empty()))
+        {
+            this->SendRequests() ;
+
+            auto wait_ms = this->GetTimeToNextDeadline() ;
+
+            if (msTimeout > 0)
+            {
+                const auto elapsed_ms = static_cast<size_t>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(steady_clock::now() - entry_time).count()) ;
+
+                if (elapsed_ms >= msTimeout)
+                {
+                    break ;
+                }
+
+                wait_ms = std::min(wait_ms, msTimeout - elapsed_ms) ;
+            }
+
+            ConstBuffer response {} ;
+            auto response_received = mFrameReader.TryReadFrame(response) ;
+
+            if (not response_received)
+            {
+                try
+                {
+                    response = mFrameReader.ReadFrame(wait_ms) ;
+                    response_received = true ;
+                }
+                catch (const ReadTimeout&)
+                {
+                    /* Deadlines are checked below. */
+                }
+            }
+
+            if (response_received)
+            {
+                number_of_transactions += this->DispatchResponse(response) ;
+
+                // Dispatch the other responses that arrived in the same read.
+                while (mFrameReader.TryReadFrame(response))
+                {
+                    number_of_transactions += this->DispatchResponse(response) ;
+                }
+            }
+
+            number_of_transactions += this->ExpireDeadlines() ;
+        }
+
+        // Keep the window full while the caller processes the results.
+        this->SendRequests() ;
+
+        return number_of_transactions ;
+    }
+
+    inline
+    void
+    Transactor::Implementation::Drain()
+    {
+        while (not mTransactions.empty())
+        {
+            this->RunOnce(0) ;
+        }
+    }
+
+    inline
+    size_t
+    Transactor::Implementation::GetNumberOfOutstandingTransactions() const
+    {
+        return mTransactions.size() ;
+    }
+
+    inline
+    size_t
+    Transactor::Implementation::GetNumberOfTransactionsInFlight() const
+    {
+        return mRequestsInFlight.size() ;
+    }
+
+    inline
+    size_t
+    Transactor::Implementation::GetNumberOfRetries() const
+    {
+        return mNumberOfRetries ;
+    }
+
+    inline
+    size_t
+    Transactor::Implementation::GetNumberOfUnmatchedResponses() const
+    {
+        return mNumberOfUnmatchedResponses ;
+    }
+
+    inline
+    uint64_t
+    Transactor::Implementation::GetCurrentTick() const
+    {
+        const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - mStartTime).count() ;
+
+        return static_cast<uint64_t>(elapsed_ms) / mPolicy.msTimerResolution ;
+    }
+
+    inline
+    void
+    Transactor::Implementation::SendRequests()
+    {
+        mSendBuffer.clear() ;
+
+        // Round the deadline up to a whole tick, and never onto a tick
+        // whose slot has already been visited.
+        const auto timeout_ticks = (mPolicy.msTimeout + mPolicy.msTimerResolution - 1) / mPolicy.msTimerResolution ;
+        const auto deadline_tick = std::max(this->GetCurrentTick() + timeout_ticks,
+                                            mCurrentTick + 1) ;
+
+        while ((not mPendingRequests.empty()) and
+               (mRequestsInFlight.size() < mPolicy.windowSize))
+        {
+            const auto transaction_id = mPendingRequests.front() ;
+            mPendingRequests.pop_front() ;
+
+            auto& transaction = mTransactions.at(transaction_id) ;
+
+            mSendBuffer.insert(mSendBuffer.end(),
+                               transaction.encodedRequest.begin(),
+                               transaction.encodedRequest.end()) ;
+
+            transaction.inFlight = true ;
+            ++transaction.numberOfAttempts ;
+
+            mTimerWheel[deadline_tick % mTimerWheel.size()].push_back({transaction_id,
+                                                                        transaction.numberOfAttempts,
+                                                                        deadline_tick}) ;
+            mRequestsInFlight.push_back(transaction_id) ;
+        }
+
+        if (not mSendBuffer.empty())
+        {
+            mSerialPort.Write(mSendBuffer.data(),
+                              mSendBuffer.size()) ;
+        }
+    }
+
+    inline
+    size_t
+    Transactor::Implementation::DispatchResponse(const ConstBuffer& response)
+    {
+        TransactionId transaction_id = 0 ;
+
+        if (mResponseKeyFunction)
+        {
+            const auto transaction_key_iter = mTransactionKeys.find(mResponseKeyFunction(response)) ;
+
+            // A late response to an attempt that timed out still completes
+            // the transaction, even though it is queued to be sent again.
+            if ((transaction_key_iter != mTransactionKeys.end()) and
+                (mTransactions.at(transaction_key_iter->second).numberOfAttempts > 0))
+            {
+                transaction_id = transaction_key_iter->second ;
+            }
+        }
+        else if (not mRequestsInFlight.empty())
+        {
+            transaction_id = mRequestsInFlight.front() ;
+        }
+
+        if (transaction_id == 0)
+        {
+            ++mNumberOfUnmatchedResponses ;
+            return 0 ;
+        }
+
+        this->CompleteTransaction(transaction_id,
+                                  nullptr,
+                                  DataBuffer(response.data,
+                                             response.data + response.size)) ;
+        return 1 ;
+    }
+
+    inline
+    size_t
+    Transactor::Implementation::ExpireDeadlines()
+    {
+        const auto current_tick = this->GetCurrentTick() ;
+
+        // Each slot is visited at most once, however long ago the wheel was
+        // last advanced.
+        const auto last_tick = std::min(current_tick,
+                                        mCurrentTick + mTimerWheel.size()) ;
+
+        std::vector<TimerEntry> expired_entries ;
+
+        for (auto tick = mCurrentTick + 1; tick <= last_tick; ++tick)
+        {
+            auto& timer_slot = mTimerWheel[tick % mTimerWheel.size()] ;
+
+            const auto expired_begin = std::partition(timer_slot.begin(),
+                                                      timer_slot.end(),
+                                                      [current_tick](const TimerEntry& timerEntry)
+                                                      {
+                                                          return timerEntry.deadlineTick > current_tick ;
+                                                      }) ;
+
+            expired_entries.insert(expired_entries.end(),
+                                   expired_begin,
+                                   timer_slot.end()) ;
+            timer_slot.erase(expired_begin,
+                             timer_slot.end()) ;
+        }
+
+        mCurrentTick = std::max(mCurrentTick, current_tick) ;
+
+        std::vector<TransactionId> retried_transactions ;
+        std::vector<TransactionId> failed_transactions ;
+
+        for (const auto& expired_entry : expired_entries)
+        {
+            const auto transaction_iter = mTransactions.find(expired_entry.transactionId) ;
+
+            if ((transaction_iter == mTransactions.end()) or
+                (not transaction_iter->second.inFlight) or
+                (transaction_iter->second.numberOfAttempts != expired_entry.attempt))
+            {
+                continue ;
+            }
+
+            transaction_iter->second.inFlight = false ;
+            mRequestsInFlight.erase(std::find(mRequestsInFlight.begin(),
+                                              mRequestsInFlight.end(),
+                                              expired_entry.transactionId)) ;
+
+            if (transaction_iter->second.numberOfAttempts <= mPolicy.maximumRetries)
+            {
+                retried_transactions.push_back(expired_entry.transactionId) ;
+            }
+            else
+            {
+                failed_transactions.push_back(expired_entry.transactionId) ;
+            }
+        }
+
+        // Requests sent again go ahead of those not yet sent at all.
+        mPendingRequests.insert(mPendingRequests.begin(),
+                                retried_transactions.begin(),
+                                retried_transactions.end()) ;
+        mNumberOfRetries += retried_transactions.size() ;
+
+        for (const auto transaction_id : failed_transactions)
+        {
+            this->CompleteTransaction(transaction_id,
+                                      std::make_exception_ptr(ReadTimeout(ERR_MSG_READ_TIMEOUT)),
+                                      DataBuffer()) ;
+        }
+
+        return failed_transactions.size() ;
+    }
+
+    inline
+    size_t
+    Transactor::Implementation::GetTimeToNextDeadline() const
+    {
+        const auto elapsed_ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - mStartTime).count()) ;
+
+        for (auto tick = mCurrentTick + 1; tick <= mCurrentTick + mTimerWheel.size(); ++tick)
+        {
+            if (mTimerWheel[tick % mTimerWheel.size()].empty())
+            {
+                continue ;
+            }
+
+            const auto due_ms = tick * mPolicy.msTimerResolution ;
+
+            return static_cast<size_t>(std::max(due_ms, elapsed_ms + 1) - elapsed_ms) ;
+        }
+
+        return std::max(mPolicy.msTimeout, static_cast<size_t>(1)) ;
+    }
+
+    inline
+    void
+    Transactor::Implementation::CompleteTransaction(const TransactionId transactionId,
+                                                    std::exception_ptr  error,
+                                                    DataBuffer          response)
+    {
+        const auto transaction_iter = mTransactions.find(transactionId) ;
+        const auto response_handler = std::move(transaction_iter->second.responseHandler) ;
+
+        if (mResponseKeyFunction)
+        {
+            mTransactionKeys.erase(transaction_iter->second.key) ;
+        }
+
+        const auto in_flight_iter = std::find(mRequestsInFlight.begin(),
+                                              mRequestsInFlight.end(),
+                                              transactionId) ;
+
+        if (in_flight_iter != mRequestsInFlight.end())
+        {
+            mRequestsInFlight.erase(in_flight_iter) ;
+        }
+
+        const auto pending_iter = std::find(mPendingRequests.begin(),
+                                            mPendingRequests.end(),
+                                            transactionId) ;
+
+        if (pending_iter != mPendingRequests.end())
+        {
+            mPendingRequests.erase(pending_iter) ;
+        }
+
+        mTransactions.erase(transaction_iter) ;
+
+        // The transaction is forgotten before its handler runs, so the
+        // handler may submit further requests, even with the same key.
+        if (response_handler)
+        {
+            response_handler(error,
+                             std::move(response)) ;
+        }
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,113 @@
+/******************************************************************************
+ * @file TransmitQueue.cpp                                                    *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "TransmitQueue.h"
+#include "Termios2.h"
+
+#include <algorithm>
+#include <sys/ioctl.h>
+#include <termios.h>
+
+namespace LibSerial
+{
+    int
+    GetNumberOfBytesPending(const int fileDescriptor,
+                            int&      numberOfBytesPending)
+    {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        return ioctl(fileDescriptor, TIOCOUTQ, &numberOfBytesPending) ;
+    }
+
+    int
+    GetTransmitterEmpty(const int fileDescriptor,
+                        bool&     isTransmitterEmpty)
+    {
+        unsigned int line_status = 0 ;
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg)
+        if (ioctl(fileDescriptor, TIOCSERGETLSR, &line_status) < 0)
+        {
+            return -1 ;
+        }
+
+        isTransmitterEmpty = (line_status & TIOCSER_TEMT) != 0 ; // NOLINT (hicpp-signed-bitwise)
+        return 0 ;
+    }
+
+    size_t
+    GetTransmitTime(const int    fileDescriptor,
+                    const size_t numberOfBytes)
+    {
+        unsigned int bit_rate = 0 ;
+        termios port_settings {} ;
+
+        if ((GetTermios2BitRate(fileDescriptor, bit_rate) < 0) or
+            (bit_rate == 0) or
+            (tcgetattr(fileDescriptor, &port_settings) < 0))
+        {
+            return 1 ;
+        }
+
+        // A start bit, the data bits, the parity bit and the stop bits.
+        size_t bits_per_character = 1 ;
+
+        // NOLINTNEXTLINE (hicpp-signed-bitwise)
+        switch (port_settings.c_cflag & CSIZE)
+        {
+        case CS5:
+            bits_per_character += 5 ;
+            break ;
+        case CS6:
+            bits_per_character += 6 ;
+            break ;
+        case CS7:
+            bits_per_character += 7 ;
+            break ;
+        default:
+            bits_per_character += 8 ;
+            break ;
+        }
+
+        // NOLINTNEXTLINE (hicpp-signed-bitwise)
+        bits_per_character += (port_settings.c_cflag & PARENB) ? 1 : 0 ;
+
+        // NOLINTNEXTLINE (hicpp-signed-bitwise)
+        bits_per_character += (port_settings.c_cflag & CSTOPB) ? 2 : 1 ;
+
+        // Round up, so that the queue has drained when the time is up.
+        const auto ms_transmit_time = (numberOfBytes * bits_per_character * 1000 + bit_rate - 1) / bit_rate ;
+
+        return std::max(ms_transmit_time, static_cast<size_t>(1)) ;
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,80 @@
+/******************************************************************************
+ * @file TransmitQueue.h                                                      *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+namespace LibSerial
+{
+    /**
+     * The depth of the driver's transmit queue, shared by SerialPort and
+     * SerialPortReactor to pace output without blocking in tcdrain().
+     */
+
+    /**
+     * @brief Gets the number of bytes queued by the driver for transmission
+     *        with TIOCOUTQ.
+     * @param fileDescriptor The file descriptor of the serial port.
+     * @param numberOfBytesPending The number of bytes not yet transmitted.
+     * @return Returns 0 on success, or -1 with errno set on failure.
+     */
+    int GetNumberOfBytesPending(int  fileDescriptor,
+                                int& numberOfBytesPending) ;
+
+    /**
+     * @brief Determines with TIOCSERGETLSR whether the transmitter of the
+     *        UART is empty, including its FIFO and shift register, which
+     *        TIOCOUTQ does not always count. Drivers that do not support
+     *        TIOCSERGETLSR, such as pseudo terminals and most USB serial
+     *        adapters, fail with ENOTTY or EINVAL.
+     * @param fileDescriptor The file descriptor of the serial port.
+     * @param isTransmitterEmpty True iff the transmitter is empty.
+     * @return Returns 0 on success, or -1 with errno set on failure.
+     */
+    int GetTransmitterEmpty(int   fileDescriptor,
+                            bool& isTransmitterEmpty) ;
+
+    /**
+     * @brief Estimates the time needed to transmit a number of bytes with
+     *        the current bit rate and character framing of a serial port.
+     *        If the bit rate cannot be read, one millisecond is returned so
+     *        that callers fall back to polling the queue depth.
+     * @param fileDescriptor The file descriptor of the serial port.
+     * @param numberOfBytes The number of bytes to be transmitted.
+     * @return Returns the estimated time in milliseconds, at least one.
+     */
+    size_t GetTransmitTime(int    fileDescriptor,
+                           size_t numberOfBytes) ;
+
+} // namespace LibSerial
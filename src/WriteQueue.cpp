@@ -0,0 +1,526 @@
+/******************************************************************************
+ * @file WriteQueue.cpp                                                       *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "libserial/WriteQueue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace LibSerial
+{
+    /**
+     * @brief WriteQueue::Implementation is the WriteQueue implementation
+     *        class.
+     */
+    class WriteQueue::Implementation
+    {
+    public:
+        /**
+         * @brief Constructor. Starts the background writer thread.
+         * @param serialPort The open serial port to write to.
+         * @param writeQueuePolicy The flush and backpressure policy.
+         */
+        explicit Implementation(SerialPort&             serialPort,
+                                const WriteQueuePolicy& writeQueuePolicy) ;
+
+        /**
+         * @brief Default Destructor. Writes any data still queued and stops
+         *        the background writer thread.
+         */
+        ~Implementation() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Implementation(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Implementation(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Implementation& operator=(const Implementation& otherImplementation) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Implementation& operator=(Implementation&& otherImplementation) = delete ;
+
+        /**
+         * @brief Queues data to be written to the serial port.
+         * @param dataBuffer Pointer to the data to be queued.
+         * @param numberOfBytes The number of bytes to be queued.
+         * @return Returns true if the data was queued, or false if the
+         *         queue is full.
+         */
+        bool Write(const uint8_t* dataBuffer,
+                   size_t         numberOfBytes) ;
+
+        /**
+         * @brief Writes all queued data and waits until it has been written.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns true if the data was written.
+         */
+        bool Flush(size_t msTimeout) ;
+
+        /**
+         * @brief Gets the number of bytes queued and not yet written.
+         * @return Returns the number of bytes queued.
+         */
+        size_t GetNumberOfQueuedBytes() const ;
+
+        /**
+         * @brief Gets the number of write operations issued to the serial port.
+         * @return Returns the number of write operations.
+         */
+        size_t GetNumberOfWriteCalls() const ;
+
+        /**
+         * @brief Gets the number of writes rejected because the queue was full.
+         * @return Returns the number of rejected writes.
+         */
+        size_t GetNumberOfRejectedWrites() const ;
+
+    private:
+        /**
+         * @brief The background writer thread, which waits for the flush
+         *        policy to be met and writes all queued data at once.
+         */
+        void WriterLoop() ;
+
+        /**
+         * @brief Determines whether the queued data should be written now.
+         *        Must be called with mMutex held and mPendingData not empty.
+         * @param currentTime The current time.
+         * @return Returns true if the queued data should be written.
+         */
+        bool IsFlushDue(std::chrono::steady_clock::time_point currentTime) const ;
+
+        /**
+         * @brief Rethrows the exception with which the background writer
+         *        failed, if any. Must be called with mMutex held.
+         */
+        void CheckWriterError() const ;
+
+        /**
+         * @brief The serial port data is written to.
+         */
+        SerialPort& mSerialPort ;
+
+        /**
+         * @brief The flush and backpressure policy.
+         */
+        WriteQueuePolicy mWriteQueuePolicy ;
+
+        /**
+         * @brief Protects all of the members below, except mWritingData.
+         */
+        mutable std::mutex mMutex {} ;
+
+        /**
+         * @brief Signalled when data is queued, a flush is requested or the
+         *        writer thread is asked to stop.
+         */
+        std::condition_variable mWriterCondition {} ;
+
+        /**
+         * @brief Signalled when a batch has been written or the writer
+         *        thread has failed.
+         */
+        std::condition_variable mFlushCondition {} ;
+
+        /**
+         * @brief The data queued since the last batch was taken. The
+         *        buffer is swapped with mWritingData rather than copied, so
+         *        both keep their capacity and no allocation is needed once
+         *        the queue has warmed up.
+         */
+        DataBuffer mPendingData {} ;
+
+        /**
+         * @brief The batch being written, used only by the writer thread.
+         */
+        DataBuffer mWritingData {} ;
+
+        /**
+         * @brief The time at which the oldest byte in mPendingData was
+         *        queued.
+         */
+        std::chrono::steady_clock::time_point mOldestPendingTime {} ;
+
+        /**
+         * @brief The total number of bytes ever queued.
+         */
+        uint64_t mNumberOfBytesQueued = 0 ;
+
+        /**
+         * @brief The total number of bytes ever written.
+         */
+        uint64_t mNumberOfBytesWritten = 0 ;
+
+        /**
+         * @brief The value of mNumberOfBytesQueued when Flush() was last
+         *        called. Data is written without delay until
+         *        mNumberOfBytesWritten reaches it.
+         */
+        uint64_t mFlushTarget = 0 ;
+
+        /**
+         * @brief The number of write operations issued to the serial port.
+         */
+        size_t mNumberOfWriteCalls = 0 ;
+
+        /**
+         * @brief The number of writes rejected because the queue was full.
+         */
+        size_t mNumberOfRejectedWrites = 0 ;
+
+        /**
+         * @brief True once the writer thread has been asked to stop.
+         */
+        bool mStopRequested = false ;
+
+        /**
+         * @brief The exception with which the writer thread failed.
+         */
+        std::exception_ptr mWriterError {} ;
+
+        /**
+         * @brief The background writer thread, started last.
+         */
+        std::thread mWriterThread {} ;
+    } ;
+
+    WriteQueue::WriteQueue(SerialPort&             serialPort,
+                           const WriteQueuePolicy& writeQueuePolicy)
+        : mImpl(new Implementation(serialPort,
+                                   writeQueuePolicy))
+    {
+        /* Empty */
+    }
+
+    WriteQueue::~WriteQueue() = default ;
+
+    bool
+    WriteQueue::Write(const uint8_t* const dataBuffer,
+                      const size_t         numberOfBytes)
+    {
+        return mImpl->Write(dataBuffer,
+                            numberOfBytes) ;
+    }
+
+    bool
+    WriteQueue::Write(const DataBuffer& dataBuffer)
+    {
+        return mImpl->Write(dataBuffer.data(),
+                            dataBuffer.size()) ;
+    }
+
+    bool
+    WriteQueue::Write(const std::string& dataString)
+    {
+        return mImpl->Write(reinterpret_cast<const uint8_t*>(dataString.data()), // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                            dataString.size()) ;
+    }
+
+    bool
+    WriteQueue::WriteByte(const uint8_t dataByte)
+    {
+        return mImpl->Write(&dataByte, 1) ;
+    }
+
+    bool
+    WriteQueue::Flush(const size_t msTimeout)
+    {
+        return mImpl->Flush(msTimeout) ;
+    }
+
+    size_t
+    WriteQueue::GetNumberOfQueuedBytes() const
+    {
+        return mImpl->GetNumberOfQueuedBytes() ;
+    }
+
+    size_t
+    WriteQueue::GetNumberOfWriteCalls() const
+    {
+        return mImpl->GetNumberOfWriteCalls() ;
+    }
+
+    size_t
+    WriteQueue::GetNumberOfRejectedWrites() const
+    {
+        return mImpl->GetNumberOfRejectedWrites() ;
+    }
+
+    inline
+    WriteQueue::Implementation::Implementation(SerialPort&             serialPort,
+                                               const WriteQueuePolicy& writeQueuePolicy)
+        : mSerialPort(serialPort)
+        , mWriteQueuePolicy(writeQueuePolicy)
+    {
+        if (not mSerialPort.IsOpen())
+        {
+            throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+        }
+
+        if ((mWriteQueuePolicy.maximumBatchSize == 0) or
+            (mWriteQueuePolicy.maximumQueueSize == 0))
+        {
+            throw std::invalid_argument(ERR_MSG_INVALID_BUFFER_SIZE) ;
+        }
+
+        mPendingData.reserve(mWriteQueuePolicy.maximumBatchSize) ;
+        mWritingData.reserve(mWriteQueuePolicy.maximumBatchSize) ;
+
+        mWriterThread = std::thread(&Implementation::WriterLoop, this) ;
+    }
+
+    inline
+    WriteQueue::Implementation::~Implementation()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex) ;
+            mStopRequested = true ;
+        }
+
+        mWriterCondition.notify_one() ;
+        mWriterThread.join() ;
+    }
+
+    inline
+    bool
+    WriteQueue::Implementation::Write(const uint8_t* const dataBuffer,
+                                      const size_t         numberOfBytes)
+    {
+        std::unique_lock<std::mutex> lock(mMutex) ;
+
+        this->CheckWriterError() ;
+
+        if (numberOfBytes == 0)
+        {
+            return true ;
+        }
+
+        const auto number_of_bytes_pending = mPendingData.size() ;
+
+        if ((number_of_bytes_pending > 0) and
+            (number_of_bytes_pending + numberOfBytes > mWriteQueuePolicy.maximumQueueSize))
+        {
+            mNumberOfRejectedWrites++ ;
+            return false ;
+        }
+
+        if (number_of_bytes_pending == 0)
+        {
+            mOldestPendingTime = std::chrono::steady_clock::now() ;
+        }
+
+        mPendingData.insert(mPendingData.end(),
+                            dataBuffer,
+                            dataBuffer + numberOfBytes) ;
+
+        mNumberOfBytesQueued += numberOfBytes ;
+
+        // The writer only needs waking to start its delay timer or when the
+        // batch is already due.
+        const bool wake_writer = (number_of_bytes_pending == 0) or
+                                 (mPendingData.size() >= mWriteQueuePolicy.maximumBatchSize) ;
+
+        lock.unlock() ;
+
+        if (wake_writer)
+        {
+            mWriterCondition.notify_one() ;
+        }
+
+        return true ;
+    }
+
+    inline
+    bool
+    WriteQueue::Implementation::Flush(const size_t msTimeout)
+    {
+        std::unique_lock<std::mutex> lock(mMutex) ;
+
+        this->CheckWriterError() ;
+
+        const auto flush_target = mNumberOfBytesQueued ;
+        mFlushTarget = flush_target ;
+
+        mWriterCondition.notify_one() ;
+
+        const auto is_flushed = [this, flush_target]()
+        {
+            return (mNumberOfBytesWritten >= flush_target) or
+                   (mWriterError != nullptr) ;
+        } ;
+
+        if (msTimeout == 0)
+        {
+            mFlushCondition.wait(lock, is_flushed) ;
+        }
+        else if (not mFlushCondition.wait_for(lock,
+                                              std::chrono::milliseconds(msTimeout),
+                                              is_flushed))
+        {
+            return false ;
+        }
+
+        this->CheckWriterError() ;
+
+        return true ;
+    }
+
+    inline
+    size_t
+    WriteQueue::Implementation::GetNumberOfQueuedBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex) ;
+        return static_cast<size_t>(mNumberOfBytesQueued - mNumberOfBytesWritten) ;
+    }
+
+    inline
+    size_t
+    WriteQueue::Implementation::GetNumberOfWriteCalls() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex) ;
+        return mNumberOfWriteCalls ;
+    }
+
+    inline
+    size_t
+    WriteQueue::Implementation::GetNumberOfRejectedWrites() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex) ;
+        return mNumberOfRejectedWrites ;
+    }
+
+    inline
+    void
+    WriteQueue::Implementation::WriterLoop()
+    {
+        std::unique_lock<std::mutex> lock(mMutex) ;
+
+        while (true)
+        {
+            // Wait until there is data whose flush is due.
+            while (mPendingData.empty() or
+                   (not this->IsFlushDue(std::chrono::steady_clock::now())))
+            {
+                if (mPendingData.empty())
+                {
+                    if (mStopRequested)
+                    {
+                        return ;
+                    }
+
+                    mWriterCondition.wait(lock) ;
+                }
+                else
+                {
+                    const auto flush_time = mOldestPendingTime +
+                        std::chrono::microseconds(mWriteQueuePolicy.maximumDelayMicroseconds) ;
+
+                    mWriterCondition.wait_until(lock, flush_time) ;
+                }
+            }
+
+            // Take everything queued so far as one batch. Producers keep
+            // queueing into the other buffer while the batch is written.
+            std::swap(mPendingData, mWritingData) ;
+            lock.unlock() ;
+
+            std::exception_ptr writer_error {} ;
+
+            try
+            {
+                mSerialPort.Write(mWritingData.data(),
+                                  mWritingData.size()) ;
+            }
+            catch (...)
+            {
+                writer_error = std::current_exception() ;
+            }
+
+            lock.lock() ;
+
+            if (writer_error != nullptr)
+            {
+                // Data queued after the failure can never be written.
+                mWriterError = writer_error ;
+                mPendingData.clear() ;
+                mWritingData.clear() ;
+                mFlushCondition.notify_all() ;
+                return ;
+            }
+
+            mNumberOfBytesWritten += mWritingData.size() ;
+            mNumberOfWriteCalls++ ;
+            mWritingData.clear() ;
+
+            mFlushCondition.notify_all() ;
+        }
+    }
+
+    inline
+    bool
+    WriteQueue::Implementation::IsFlushDue(const std::chrono::steady_clock::time_point currentTime) const
+    {
+        // Pending data follows any batch being written, so a flush target
+        // beyond the bytes written covers some of it.
+        return mStopRequested or
+               (mFlushTarget > mNumberOfBytesWritten) or
+               (mPendingData.size() >= mWriteQueuePolicy.maximumBatchSize) or
+               (currentTime - mOldestPendingTime >=
+                std::chrono::microseconds(mWriteQueuePolicy.maximumDelayMicroseconds)) ;
+    }
+
+    inline
+    void
+    WriteQueue::Implementation::CheckWriterError() const
+    {
+        if (mWriterError != nullptr)
+        {
+            std::rethrow_exception(mWriterError) ;
+        }
+    }
+
+} // namespace LibSerial
@@ -0,0 +1,342 @@
+/******************************************************************************
+ * @file AsyncSerialPort.h                                                    *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPort.h>
+#include <libserial/SerialPortReactor.h>
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+
+#if __cplusplus >= 202002L
+#include <coroutine>
+#endif
+
+namespace LibSerial
+{
+    /**
+     * @brief AsyncSerialPort provides completion based reads and writes on a
+     *        SerialPort owned by a SerialPortReactor. Operations are started
+     *        from any thread and are completed by the threads running the
+     *        reactor, so a single reactor thread can drive many outstanding
+     *        exchanges on many ports.
+     *
+     *        Each operation is available in three forms: with a completion
+     *        handler, returning a std::future, and, when compiled as C++20,
+     *        returning an awaitable for use with co_await. Handlers are
+     *        invoked, and coroutines resumed, on a thread running the
+     *        reactor.
+     *
+     *        Reads complete in the order they were started, as do writes.
+     *        Data received while no read is pending is left in the driver.
+     *        Operations pending when the AsyncSerialPort is destroyed fail
+     *        with a NotOpen exception.
+     */
+    class AsyncSerialPort
+    {
+    public:
+        /**
+         * @brief Handler invoked when a ReadAsync() operation completes. The
+         *        error is empty on success.
+         */
+        using ReadHandler = std::function<void(std::exception_ptr error, DataBuffer dataBuffer)> ;
+
+        /**
+         * @brief Handler invoked when a ReadUntilAsync() operation completes.
+         *        The error is empty on success.
+         */
+        using ReadUntilHandler = std::function<void(std::exception_ptr error, std::string dataString)> ;
+
+        /**
+         * @brief Handler invoked when a WriteAsync() operation completes with
+         *        the number of bytes written. The error is empty on success.
+         */
+        using WriteHandler = std::function<void(std::exception_ptr error, size_t numberOfBytes)> ;
+
+        /**
+         * @brief Constructor. Transfers ownership of an open SerialPort to
+         *        the reactor.
+         * @param serialPortReactor The reactor that completes the operations.
+         *        It must outlive the AsyncSerialPort.
+         * @param serialPort The open serial port.
+         */
+        AsyncSerialPort(SerialPortReactor&          serialPortReactor,
+                        std::unique_ptr<SerialPort> serialPort) ;
+
+        /**
+         * @brief Default Destructor. Removes the serial port from the
+         *        reactor, which closes it.
+         */
+        virtual ~AsyncSerialPort() noexcept ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        AsyncSerialPort(const AsyncSerialPort& otherAsyncSerialPort) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        AsyncSerialPort(AsyncSerialPort&& otherAsyncSerialPort) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        AsyncSerialPort& operator=(const AsyncSerialPort& otherAsyncSerialPort) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        AsyncSerialPort& operator=(AsyncSerialPort&& otherAsyncSerialPort) = delete ;
+
+        /**
+         * @brief Gets the handle of the serial port within the reactor.
+         * @return Returns the handle of the serial port.
+         */
+        SerialPortReactor::PortId GetPortId() const ;
+
+        /**
+         * @brief Starts reading the specified number of bytes. If
+         *        numberOfBytes is zero, the read completes with whatever has
+         *        been received as soon as at least one byte is available. If
+         *        msTimeout is non-zero and elapses first, the read fails with
+         *        a ReadTimeout exception and any bytes received so far are
+         *        kept for the next read.
+         * @param numberOfBytes The number of bytes to read.
+         * @param msTimeout The timeout period in milliseconds.
+         * @param handler The handler to invoke on completion.
+         */
+        void ReadAsync(size_t             numberOfBytes,
+                       size_t             msTimeout,
+                       const ReadHandler& handler) ;
+
+        /**
+         * @brief Starts reading until the delimiter has been received. The
+         *        result includes the delimiter. Timeouts behave as for
+         *        ReadAsync().
+         * @param delimiter The non-empty delimiter ending the data.
+         * @param msTimeout The timeout period in milliseconds.
+         * @param handler The handler to invoke on completion.
+         */
+        void ReadUntilAsync(const std::string&      delimiter,
+                            size_t                  msTimeout,
+                            const ReadUntilHandler& handler) ;
+
+        /**
+         * @brief Starts writing a buffer. The write completes once all of the
+         *        data has been handed to the driver; DrainWriteBuffer() may
+         *        still block until it has been transmitted.
+         * @param dataBuffer The data to be written.
+         * @param handler The handler to invoke on completion.
+         */
+        void WriteAsync(DataBuffer          dataBuffer,
+                        const WriteHandler& handler) ;
+
+        /**
+         * @brief Starts reading the specified number of bytes.
+         * @param numberOfBytes The number of bytes to read, see ReadAsync().
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns a future that receives the data.
+         */
+        std::future<DataBuffer> ReadAsync(size_t numberOfBytes,
+                                          size_t msTimeout = 0) ;
+
+        /**
+         * @brief Starts reading until the delimiter has been received.
+         * @param delimiter The non-empty delimiter ending the data.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns a future that receives the data, including the
+         *         delimiter.
+         */
+        std::future<std::string> ReadUntilAsync(const std::string& delimiter,
+                                                size_t             msTimeout = 0) ;
+
+        /**
+         * @brief Starts writing a buffer.
+         * @param dataBuffer The data to be written.
+         * @return Returns a future that becomes ready once the data has
+         *         been handed to the driver.
+         */
+        std::future<void> WriteAsync(DataBuffer dataBuffer) ;
+
+        /**
+         * @brief Starts writing a string.
+         * @param dataString The data to be written.
+         * @return Returns a future that becomes ready once the data has
+         *         been handed to the driver.
+         */
+        std::future<void> WriteAsync(const std::string& dataString) ;
+
+#if __cplusplus >= 202002L
+        /**
+         * @brief An awaitable wrapping one asynchronous operation. The
+         *        operation is started when the awaitable is co_awaited and
+         *        the coroutine is resumed on a thread running the reactor.
+         */
+        template <typename ResultType>
+        class Awaitable
+        {
+        public:
+            /**
+             * @brief Function starting the operation with a handler.
+             */
+            using Initiator = std::function<void(std::function<void(std::exception_ptr, ResultType)>)> ;
+
+            /**
+             * @brief Constructor.
+             * @param initiator The function starting the operation.
+             */
+            explicit Awaitable(Initiator initiator)
+                : mInitiator(std::move(initiator))
+            {
+                /* Empty */
+            }
+
+            /**
+             * @brief The operation is always started on suspension.
+             */
+            bool await_ready() const noexcept
+            {
+                return false ;
+            }
+
+            /**
+             * @brief Starts the operation.
+             * @return Returns false if the operation already completed, in
+             *         which case the coroutine continues immediately.
+             */
+            bool await_suspend(std::coroutine_handle<> coroutineHandle)
+            {
+                mCoroutineHandle = coroutineHandle ;
+
+                mInitiator([this](std::exception_ptr error, ResultType result)
+                           {
+                               mError = error ;
+                               mResult = std::move(result) ;
+
+                               // Whichever of the handler and await_suspend()
+                               // finishes second decides how to continue.
+                               if (mCompleted.exchange(true))
+                               {
+                                   mCoroutineHandle.resume() ;
+                               }
+                           }) ;
+
+                return not mCompleted.exchange(true) ;
+            }
+
+            /**
+             * @brief Gets the result of the operation.
+             */
+            ResultType await_resume()
+            {
+                if (mError)
+                {
+                    std::rethrow_exception(mError) ;
+                }
+
+                return std::move(mResult) ;
+            }
+
+        private:
+            Initiator               mInitiator ;
+            std::coroutine_handle<> mCoroutineHandle {} ;
+            std::exception_ptr      mError {} ;
+            ResultType              mResult {} ;
+            std::atomic<bool>       mCompleted {false} ;
+        } ;
+
+        /**
+         * @brief Reads the specified number of bytes, see ReadAsync().
+         * @return Returns an awaitable producing the data.
+         */
+        Awaitable<DataBuffer> AwaitRead(const size_t numberOfBytes,
+                                        const size_t msTimeout = 0)
+        {
+            return Awaitable<DataBuffer>([=, this](ReadHandler handler)
+                                         {
+                                             this->ReadAsync(numberOfBytes, msTimeout, handler) ;
+                                         }) ;
+        }
+
+        /**
+         * @brief Reads until the delimiter has been received, see
+         *        ReadUntilAsync().
+         * @return Returns an awaitable producing the data.
+         */
+        Awaitable<std::string> AwaitReadUntil(const std::string& delimiter,
+                                              const size_t       msTimeout = 0)
+        {
+            return Awaitable<std::string>([=, this](ReadUntilHandler handler)
+                                          {
+                                              this->ReadUntilAsync(delimiter, msTimeout, handler) ;
+                                          }) ;
+        }
+
+        /**
+         * @brief Writes a buffer, see WriteAsync().
+         * @return Returns an awaitable producing the number of bytes written.
+         */
+        Awaitable<size_t> AwaitWrite(DataBuffer dataBuffer)
+        {
+            return Awaitable<size_t>([this, data_buffer = std::move(dataBuffer)](WriteHandler handler) mutable
+                                     {
+                                         this->WriteAsync(std::move(data_buffer), handler) ;
+                                     }) ;
+        }
+#endif // __cplusplus >= 202002L
+
+    protected:
+
+    private:
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance. It is shared with
+         *        the reactor callbacks and timers, which may still be
+         *        running on another thread while this instance is destroyed.
+         */
+        std::shared_ptr<Implementation> mImpl;
+
+    } ; // class AsyncSerialPort
+
+} // namespace LibSerial
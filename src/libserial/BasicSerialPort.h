@@ -0,0 +1,862 @@
+/******************************************************************************
+ * @file BasicSerialPort.h                                                    *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPort.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace LibSerial
+{
+    /**
+     * @brief A mutex that does nothing, used by NoLocking so that the lock
+     *        guards of BasicSerialPort compile away entirely.
+     */
+    class NullMutex
+    {
+    public:
+        /**
+         * @brief Does nothing.
+         */
+        void lock() noexcept
+        {
+        }
+
+        /**
+         * @brief Does nothing.
+         */
+        void unlock() noexcept
+        {
+        }
+    } ;
+
+    /**
+     * @brief Locking policy of a BasicSerialPort used by a single thread.
+     *        No synchronization is performed.
+     */
+    struct NoLocking
+    {
+        /**
+         * @brief The mutex type guarding reads and guarding writes.
+         */
+        using MutexType = NullMutex ;
+
+        /**
+         * @brief False, Close() is never called while another thread reads
+         *        or writes.
+         */
+        static constexpr bool IS_THREAD_SAFE = false ;
+    } ;
+
+    /**
+     * @brief Locking policy of a BasicSerialPort shared between threads.
+     *        Reads and writes are serialized by separate mutexes, so one
+     *        thread can read while another writes.
+     */
+    struct MutexLocking
+    {
+        /**
+         * @brief The mutex type guarding reads and guarding writes.
+         */
+        using MutexType = std::mutex ;
+
+        /**
+         * @brief True, Close() wakes threads blocked in a read or write.
+         */
+        static constexpr bool IS_THREAD_SAFE = true ;
+    } ;
+
+    /**
+     * @brief Buffering policy of a BasicSerialPort that passes every read
+     *        straight to read(), directly into the memory of the caller.
+     */
+    struct Unbuffered
+    {
+        /**
+         * @brief The size of the receive buffer, zero for none.
+         */
+        static constexpr size_t BUFFER_SIZE = 0 ;
+    } ;
+
+    /**
+     * @brief Buffering policy of a BasicSerialPort that reads into a receive
+     *        buffer of BufferSize bytes held inside the port, so that small
+     *        reads such as ReadByte() are served from memory and only one
+     *        read() system call is made per burst of received data. Reads
+     *        of at least BufferSize bytes bypass the buffer once it is empty.
+     */
+    template <size_t BufferSize>
+    struct ReadBuffered
+    {
+        static_assert(BufferSize > 0, "The receive buffer size must be positive.") ;
+
+        /**
+         * @brief The size of the receive buffer.
+         */
+        static constexpr size_t BUFFER_SIZE = BufferSize ;
+    } ;
+
+    /**
+     * @brief Blocking policy of a BasicSerialPort that sleeps in poll()
+     *        until the serial port is ready or the timeout expires.
+     */
+    struct PollBlocking
+    {
+        /**
+         * @brief Waits until the file descriptor is ready for the events or
+         *        the wakeup file descriptor becomes readable. Returning early
+         *        is always allowed, the caller retries the operation and
+         *        checks its own deadline.
+         * @param fileDescriptor The file descriptor to wait on.
+         * @param events The poll() events to wait for.
+         * @param wakeupFileDescriptor An eventfd signaled by Close(), or -1.
+         * @param msTimeout The longest time to wait in milliseconds, or -1
+         *        to wait indefinitely.
+         */
+        static void Wait(const int   fileDescriptor,
+                         const short events,
+                         const int   wakeupFileDescriptor,
+                         const int   msTimeout)
+        {
+            // poll() ignores entries with a negative file descriptor.
+            std::array<pollfd, 2> poll_fds {{{fileDescriptor, events, 0},
+                                             {wakeupFileDescriptor, POLLIN, 0}}} ;
+
+            if (poll(poll_fds.data(), poll_fds.size(), msTimeout) < 0)
+            {
+                if (errno == EINTR)
+                {
+                    return ;
+                }
+
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            const auto revents = poll_fds[0].revents ;
+
+            // A hang-up with the requested event still set leaves data to
+            // be read first, the following read() then reports the error.
+            if (((revents & events) == 0) and
+                ((revents & (POLLHUP | POLLERR | POLLNVAL)) != 0))
+            {
+                throw std::runtime_error(std::strerror(((revents & POLLNVAL) != 0) ? EBADF : EIO)) ;
+            }
+        }
+    } ;
+
+    /**
+     * @brief Blocking policy of a BasicSerialPort that never sleeps. The
+     *        port retries read() and write() in a busy loop, trading a
+     *        whole CPU core for the lowest possible wakeup latency.
+     */
+    struct SpinBlocking
+    {
+        /**
+         * @brief Returns immediately.
+         */
+        static void Wait(const int   /* fileDescriptor */,
+                         const short /* events */,
+                         const int   /* wakeupFileDescriptor */,
+                         const int   /* msTimeout */) noexcept
+        {
+        }
+    } ;
+
+    /**
+     * @brief BasicSerialPort is a serial port whose read and write paths
+     *        are defined inline in this header, with the blocking strategy,
+     *        the receive buffering and the locking chosen at compile time
+     *        through policy template parameters. The hot paths are a few
+     *        lines around read(), write() and the chosen Wait(), with no
+     *        pimpl indirection and no features that were not asked for,
+     *        so the compiler can inline them into tight byte level loops.
+     *
+     *        Opening, configuring and closing the port are delegated to an
+     *        owned SerialPort, available from GetSerialPort(), which
+     *        remains the stable ABI wrapper for everything else. The port
+     *        is switched to non-blocking mode when opened; it must not be
+     *        switched back, closed, or read from through GetSerialPort(),
+     *        as that would bypass the receive buffer of this class.
+     *
+     *        Timeouts follow SerialPort: a timeout of zero waits
+     *        indefinitely, and a ReadTimeout exception is thrown when it
+     *        expires, with any data already read left in place. A read()
+     *        returning zero is reported as a hang-up, so VMIN must stay
+     *        positive.
+     *
+     *        With MutexLocking, Close() may be called while other threads
+     *        are blocked in a read or write; they are woken and throw
+     *        NotOpen.
+     *
+     * @tparam LockingPolicy NoLocking or MutexLocking.
+     * @tparam BufferingPolicy Unbuffered or ReadBuffered<N>.
+     * @tparam BlockingPolicy PollBlocking or SpinBlocking.
+     */
+    template <typename LockingPolicy   = NoLocking,
+              typename BufferingPolicy = Unbuffered,
+              typename BlockingPolicy  = PollBlocking>
+    class BasicSerialPort
+    {
+    public:
+        /**
+         * @brief Default Constructor.
+         */
+        explicit BasicSerialPort() = default ;
+
+        /**
+         * @brief Constructor that creates and opens the serial port with
+         *        the specified parameters.
+         * @param fileName The file name of the serial port.
+         * @param portSettings The serial port parameters to be set.
+         */
+        explicit BasicSerialPort(const std::string&  fileName,
+                                 const PortSettings& portSettings = PortSettings())
+        {
+            Open(fileName, portSettings) ;
+        }
+
+        /**
+         * @brief Destructor, the owned SerialPort closes the port.
+         */
+        virtual ~BasicSerialPort()
+        {
+            if (mWakeupFileDescriptor >= 0)
+            {
+                close(mWakeupFileDescriptor) ;
+            }
+        }
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        BasicSerialPort(const BasicSerialPort& otherBasicSerialPort) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        BasicSerialPort(BasicSerialPort&& otherBasicSerialPort) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        BasicSerialPort& operator=(const BasicSerialPort& otherBasicSerialPort) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        BasicSerialPort& operator=(BasicSerialPort&& otherBasicSerialPort) = delete ;
+
+        /**
+         * @brief Opens the serial port, configures it with the specified
+         *        parameters and switches it to non-blocking mode.
+         * @param fileName The file name of the serial port.
+         * @param portSettings The serial port parameters to be set, with
+         *        a positive vmin, otherwise std::invalid_argument is thrown.
+         * @param openMode The communication mode status when the serial
+         *        communication port is opened.
+         */
+        void Open(const std::string&             fileName,
+                  const PortSettings&            portSettings = PortSettings(),
+                  const std::ios_base::openmode& openMode = std::ios_base::in | std::ios_base::out)
+        {
+            if (portSettings.vmin <= 0)
+            {
+                throw std::invalid_argument(ERR_MSG_INVALID_VMIN) ;
+            }
+
+            std::lock_guard<ReadMutex> read_lock(mReadMutex) ;
+            std::lock_guard<WriteMutex> write_lock(mWriteMutex) ;
+
+            mSerialPort.Open(fileName, portSettings, openMode) ;
+
+            try
+            {
+                mSerialPort.SetSerialPortBlockingStatus(false) ;
+
+                if (LockingPolicy::IS_THREAD_SAFE)
+                {
+                    mWakeupFileDescriptor = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) ;
+
+                    if (mWakeupFileDescriptor < 0)
+                    {
+                        throw std::runtime_error(std::strerror(errno)) ;
+                    }
+                }
+            }
+            catch (...)
+            {
+                mSerialPort.Close() ;
+                throw ;
+            }
+
+            mBufferHead = 0 ;
+            mBufferTail = 0 ;
+            mIsClosing = false ;
+            mFileDescriptor = mSerialPort.GetFileDescriptor() ;
+        }
+
+        /**
+         * @brief Closes the serial port, discarding any buffered data.
+         */
+        void Close()
+        {
+            // Wake blocked readers and writers first, they hold the locks.
+            mIsClosing = true ;
+
+            const int wakeup_file_descriptor = mWakeupFileDescriptor ;
+
+            if (wakeup_file_descriptor >= 0)
+            {
+                const uint64_t wakeup_count = 1 ;
+                static_cast<void>(write(wakeup_file_descriptor, &wakeup_count, sizeof(wakeup_count))) ;
+            }
+
+            std::lock_guard<ReadMutex> read_lock(mReadMutex) ;
+            std::lock_guard<WriteMutex> write_lock(mWriteMutex) ;
+
+            mFileDescriptor = -1 ;
+            mBufferHead = 0 ;
+            mBufferTail = 0 ;
+            mIsClosing = false ;
+
+            if (mWakeupFileDescriptor >= 0)
+            {
+                close(mWakeupFileDescriptor) ;
+                mWakeupFileDescriptor = -1 ;
+            }
+
+            mSerialPort.Close() ;
+        }
+
+        /**
+         * @brief Determines if the serial port is open for I/O.
+         * @return Returns true iff the serial port is open.
+         */
+        bool IsOpen() const noexcept
+        {
+            return mFileDescriptor.load(std::memory_order_relaxed) >= 0 ;
+        }
+
+        /**
+         * @brief Gets the owned SerialPort, to query or change the serial
+         *        port parameters and the modem control lines.
+         * @return Returns the owned SerialPort.
+         */
+        SerialPort& GetSerialPort() noexcept
+        {
+            return mSerialPort ;
+        }
+
+        /**
+         * @brief Determines if data is buffered or waiting to be read.
+         * @return Returns true iff data is available to read.
+         */
+        bool IsDataAvailable()
+        {
+            std::lock_guard<ReadMutex> read_lock(mReadMutex) ;
+
+            CheckOpen() ;
+
+            if (mBufferHead != mBufferTail)
+            {
+                return true ;
+            }
+
+            int number_of_bytes_available = 0 ;
+
+            if (ioctl(mFileDescriptor.load(std::memory_order_relaxed), // NOLINT (cppcoreguidelines-pro-type-vararg)
+                      FIONREAD,
+                      &number_of_bytes_available) < 0)
+            {
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            return number_of_bytes_available > 0 ;
+        }
+
+        /**
+         * @brief Reads up to bufferSize bytes into caller owned memory. The
+         *        method blocks until at least one byte is available and then
+         *        returns everything that has arrived, up to bufferSize bytes.
+         *        If no data arrives within msTimeout milliseconds, a
+         *        ReadTimeout exception is thrown. If msTimeout is zero, then
+         *        this method will block until data becomes available.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of bytes placed into dataBuffer.
+         */
+        size_t Read(uint8_t* const dataBuffer,
+                    const size_t   bufferSize,
+                    const size_t   msTimeout = 0)
+        {
+            std::lock_guard<ReadMutex> read_lock(mReadMutex) ;
+
+            CheckOpen() ;
+
+            return ReadSome(dataBuffer, bufferSize, Deadline(msTimeout)) ;
+        }
+
+        /**
+         * @brief Reads exactly numberOfBytes bytes into dataBuffer, which
+         *        is resized to hold them. If they do not all arrive within
+         *        msTimeout milliseconds, a ReadTimeout exception is thrown
+         *        and dataBuffer holds the bytes received so far. If msTimeout
+         *        is zero, then this method will block until all requested
+         *        bytes are received.
+         * @param dataBuffer The data buffer to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void Read(DataBuffer&  dataBuffer,
+                  const size_t numberOfBytes,
+                  const size_t msTimeout = 0)
+        {
+            ReadExactly(dataBuffer, numberOfBytes, msTimeout) ;
+        }
+
+        /**
+         * @brief Reads exactly numberOfBytes bytes into dataString, which
+         *        is resized to hold them. If they do not all arrive within
+         *        msTimeout milliseconds, a ReadTimeout exception is thrown
+         *        and dataString holds the bytes received so far. If msTimeout
+         *        is zero, then this method will block until all requested
+         *        bytes are received.
+         * @param dataString The string to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void Read(std::string& dataString,
+                  const size_t numberOfBytes,
+                  const size_t msTimeout = 0)
+        {
+            ReadExactly(dataString, numberOfBytes, msTimeout) ;
+        }
+
+        /**
+         * @brief Reads a single byte from the serial port. If no data is
+         *        available within the specified number of milliseconds,
+         *        (msTimeout), then this method will throw a ReadTimeout
+         *        exception. If msTimeout is zero, then this method will
+         *        block until data becomes available.
+         * @param charBuffer The character read from the serial port.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadByte(char&        charBuffer,
+                      const size_t msTimeout = 0)
+        {
+            unsigned char byte_buffer = 0 ;
+            ReadByte(byte_buffer, msTimeout) ;
+            charBuffer = static_cast<char>(byte_buffer) ;
+        }
+
+        /**
+         * @brief Reads a single byte from the serial port. If no data is
+         *        available within the specified number of milliseconds,
+         *        (msTimeout), then this method will throw a ReadTimeout
+         *        exception. If msTimeout is zero, then this method will
+         *        block until data becomes available.
+         * @param charBuffer The character read from the serial port.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadByte(unsigned char& charBuffer,
+                      const size_t   msTimeout = 0)
+        {
+            std::lock_guard<ReadMutex> read_lock(mReadMutex) ;
+
+            CheckOpen() ;
+
+            // Serve buffered data without touching the clock.
+            if (mBufferHead != mBufferTail)
+            {
+                charBuffer = mBuffer[mBufferHead++] ;
+                return ;
+            }
+
+            ReadSome(&charBuffer, 1, Deadline(msTimeout)) ;
+        }
+
+        /**
+         * @brief Writes numberOfBytes bytes to the serial port, waiting
+         *        with the blocking policy whenever the transmit buffer of
+         *        the serial port is full.
+         * @param dataBuffer Pointer to the data to be written.
+         * @param numberOfBytes The number of bytes to write.
+         */
+        void Write(const uint8_t* dataBuffer,
+                   size_t         numberOfBytes)
+        {
+            std::lock_guard<WriteMutex> write_lock(mWriteMutex) ;
+
+            CheckOpen() ;
+
+            const int file_descriptor = mFileDescriptor.load(std::memory_order_relaxed) ;
+
+            while (numberOfBytes > 0)
+            {
+                const auto result = write(file_descriptor, dataBuffer, numberOfBytes) ;
+
+                if (result > 0)
+                {
+                    dataBuffer += result ;
+                    numberOfBytes -= static_cast<size_t>(result) ;
+                    continue ;
+                }
+
+                if ((result < 0) and
+                    (errno != EAGAIN) and
+                    (errno != EINTR))
+                {
+                    throw std::runtime_error(std::strerror(errno)) ;
+                }
+
+                if ((result == 0) or
+                    (errno == EAGAIN))
+                {
+                    BlockingPolicy::Wait(file_descriptor, POLLOUT, mWakeupFileDescriptor, -1) ;
+                    CheckOpen() ;
+                }
+            }
+        }
+
+        /**
+         * @brief Writes a DataBuffer to the serial port.
+         * @param dataBuffer The data to be written.
+         */
+        void Write(const DataBuffer& dataBuffer)
+        {
+            Write(dataBuffer.data(), dataBuffer.size()) ;
+        }
+
+        /**
+         * @brief Writes a std::string to the serial port.
+         * @param dataString The data to be written.
+         */
+        void Write(const std::string& dataString)
+        {
+            Write(reinterpret_cast<const uint8_t*>(dataString.data()), // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                  dataString.size()) ;
+        }
+
+        /**
+         * @brief Writes a single byte to the serial port.
+         * @param charBuffer The byte to be written.
+         */
+        void WriteByte(const char charBuffer)
+        {
+            const auto byte_buffer = static_cast<uint8_t>(charBuffer) ;
+            Write(&byte_buffer, 1) ;
+        }
+
+        /**
+         * @brief Writes a single byte to the serial port.
+         * @param charBuffer The byte to be written.
+         */
+        void WriteByte(const unsigned char charBuffer)
+        {
+            Write(&charBuffer, 1) ;
+        }
+
+    private:
+
+        /**
+         * @brief The mutex type guarding reads.
+         */
+        using ReadMutex = typename LockingPolicy::MutexType ;
+
+        /**
+         * @brief The mutex type guarding writes.
+         */
+        using WriteMutex = typename LockingPolicy::MutexType ;
+
+        /**
+         * @brief The clock used for read deadlines.
+         */
+        using Clock = std::chrono::steady_clock ;
+
+        /**
+         * @brief Throws NotOpen if the serial port is not open or is being
+         *        closed by another thread.
+         */
+        void CheckOpen() const
+        {
+            if ((not IsOpen()) or
+                mIsClosing.load(std::memory_order_relaxed))
+            {
+                throw NotOpen(ERR_MSG_PORT_NOT_OPEN) ;
+            }
+        }
+
+        /**
+         * @brief Converts a timeout into a deadline, the largest time point
+         *        standing for no timeout.
+         * @param msTimeout The timeout period in milliseconds, or zero.
+         * @return Returns the deadline.
+         */
+        static Clock::time_point Deadline(const size_t msTimeout)
+        {
+            if (msTimeout == 0)
+            {
+                return Clock::time_point::max() ;
+            }
+
+            return Clock::now() + std::chrono::milliseconds(msTimeout) ;
+        }
+
+        /**
+         * @brief Reads exactly numberOfBytes bytes into a container of bytes.
+         * @param container The DataBuffer or std::string to read into.
+         * @param numberOfBytes The number of bytes to read.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        template <typename Container>
+        void ReadExactly(Container&   container,
+                         const size_t numberOfBytes,
+                         const size_t msTimeout)
+        {
+            std::lock_guard<ReadMutex> read_lock(mReadMutex) ;
+
+            CheckOpen() ;
+
+            container.resize(numberOfBytes) ;
+
+            const auto deadline = Deadline(msTimeout) ;
+            size_t bytes_read = 0 ;
+
+            try
+            {
+                while (bytes_read < numberOfBytes)
+                {
+                    bytes_read += ReadSome(reinterpret_cast<uint8_t*>(&container[bytes_read]), // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+                                           numberOfBytes - bytes_read,
+                                           deadline) ;
+                }
+            }
+            catch (const ReadTimeout&)
+            {
+                container.resize(bytes_read) ;
+                throw ;
+            }
+        }
+
+        /**
+         * @brief Reads at least one and at most bufferSize bytes, waiting
+         *        with the blocking policy until the deadline. The caller
+         *        must hold the read lock.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @param deadline The time after which ReadTimeout is thrown.
+         * @return Returns the number of bytes placed into dataBuffer.
+         */
+        size_t ReadSome(uint8_t* const          dataBuffer,
+                        const size_t            bufferSize,
+                        const Clock::time_point deadline)
+        {
+            if (bufferSize == 0)
+            {
+                return 0 ;
+            }
+
+            for (;;)
+            {
+                // Try the read first, so that data already waiting is
+                // returned without computing a timeout.
+                const auto bytes_read = ReadAvailable(dataBuffer, bufferSize) ;
+
+                if (bytes_read > 0)
+                {
+                    return bytes_read ;
+                }
+
+                auto ms_remaining = -1 ;
+
+                if (deadline != Clock::time_point::max())
+                {
+                    const auto remaining = deadline - Clock::now() ;
+
+                    if (remaining <= Clock::duration::zero())
+                    {
+                        throw ReadTimeout(ERR_MSG_READ_TIMEOUT) ;
+                    }
+
+                    // Round up, so that poll() does not wake just before
+                    // the deadline and spin.
+                    const auto ms_rounded_up = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        remaining + std::chrono::milliseconds(1) - Clock::duration(1)).count() ;
+
+                    ms_remaining = static_cast<int>(std::min<decltype(ms_rounded_up)>(ms_rounded_up,
+                                                                                      std::numeric_limits<int>::max())) ;
+                }
+
+                BlockingPolicy::Wait(mFileDescriptor.load(std::memory_order_relaxed),
+                                     POLLIN,
+                                     mWakeupFileDescriptor,
+                                     ms_remaining) ;
+                CheckOpen() ;
+            }
+        }
+
+        /**
+         * @brief Copies buffered data into dataBuffer, or makes one
+         *        non-blocking read() if the receive buffer is empty.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer,
+         *        which must be positive.
+         * @return Returns the number of bytes placed into dataBuffer, zero
+         *         if no data is available.
+         */
+        size_t ReadAvailable(uint8_t* const dataBuffer,
+                             const size_t   bufferSize)
+        {
+            // A local copy, so that std::min() does not odr-use the member.
+            constexpr size_t buffer_capacity = BufferingPolicy::BUFFER_SIZE ;
+
+            if ((buffer_capacity == 0) or
+                (bufferSize >= buffer_capacity))
+            {
+                if (mBufferHead == mBufferTail)
+                {
+                    return ReadFromPort(dataBuffer, bufferSize) ;
+                }
+            }
+            else if (mBufferHead == mBufferTail)
+            {
+                mBufferHead = 0 ;
+                mBufferTail = ReadFromPort(mBuffer.data(), buffer_capacity) ;
+            }
+
+            const auto bytes_copied = std::min(bufferSize, mBufferTail - mBufferHead) ;
+            std::copy_n(mBuffer.data() + mBufferHead, bytes_copied, dataBuffer) ;
+            mBufferHead += bytes_copied ;
+
+            return bytes_copied ;
+        }
+
+        /**
+         * @brief Makes one non-blocking read() from the serial port.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @return Returns the number of bytes read, zero if no data is
+         *         available.
+         */
+        size_t ReadFromPort(uint8_t* const dataBuffer,
+                            const size_t   bufferSize) const
+        {
+            const auto result = read(mFileDescriptor.load(std::memory_order_relaxed), dataBuffer, bufferSize) ;
+
+            if (result > 0)
+            {
+                return static_cast<size_t>(result) ;
+            }
+
+            // With VMIN positive, read() only returns zero after a hang-up.
+            if (result == 0)
+            {
+                throw std::runtime_error(std::strerror(EIO)) ;
+            }
+
+            if ((errno != EAGAIN) and
+                (errno != EINTR))
+            {
+                throw std::runtime_error(std::strerror(errno)) ;
+            }
+
+            return 0 ;
+        }
+
+        /**
+         * @brief The serial port performing the open, configuration and
+         *        close operations.
+         */
+        SerialPort mSerialPort {} ;
+
+        /**
+         * @brief The file descriptor of the open serial port, or -1,
+         *        atomic so that IsOpen() may be called without the locks.
+         */
+        std::atomic<int> mFileDescriptor {-1} ;
+
+        /**
+         * @brief An eventfd signaled by Close() to wake blocked readers and
+         *        writers, or -1 with NoLocking.
+         */
+        int mWakeupFileDescriptor = -1 ;
+
+        /**
+         * @brief True while Close() waits for blocked readers and writers
+         *        to release the locks.
+         */
+        std::atomic<bool> mIsClosing {false} ;
+
+        /**
+         * @brief The receive buffer, empty for the Unbuffered policy.
+         */
+        std::array<uint8_t, BufferingPolicy::BUFFER_SIZE> mBuffer {} ;
+
+        /**
+         * @brief The index of the next unread byte in mBuffer.
+         */
+        size_t mBufferHead = 0 ;
+
+        /**
+         * @brief The index one past the last unread byte in mBuffer.
+         */
+        size_t mBufferTail = 0 ;
+
+        /**
+         * @brief Serializes reads.
+         */
+        ReadMutex mReadMutex {} ;
+
+        /**
+         * @brief Serializes writes.
+         */
+        WriteMutex mWriteMutex {} ;
+    } ;
+
+} // namespace LibSerial
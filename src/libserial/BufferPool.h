@@ -0,0 +1,224 @@
+/******************************************************************************
+ * @file BufferPool.h                                                         *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace LibSerial
+{
+    /**
+     * @brief The number of fixed block size classes of BufferPool.
+     */
+    constexpr size_t BUFFER_POOL_SIZE_CLASSES = 6 ;
+
+    /**
+     * @brief The block size of the smallest BufferPool size class. Each
+     *        following size class is four times larger.
+     */
+    constexpr size_t BUFFER_POOL_MINIMUM_BLOCK_SIZE = 64 ;
+
+    /**
+     * @brief The block size of the largest BufferPool size class.
+     */
+    constexpr size_t BUFFER_POOL_MAXIMUM_BLOCK_SIZE = BUFFER_POOL_MINIMUM_BLOCK_SIZE << (2 * (BUFFER_POOL_SIZE_CLASSES - 1)) ;
+
+    /**
+     * @brief BufferPool is a process wide pool of memory blocks in a few
+     *        fixed size classes, used to avoid a malloc()/free() pair for
+     *        every message received or sent.
+     *
+     *        Each thread keeps a small cache of free blocks per size class,
+     *        so allocation and deallocation normally take no lock. When a
+     *        thread cache runs empty or overflows, a batch of blocks is
+     *        moved from or to a shared depot under a per size class mutex.
+     *        Blocks may be released by a different thread than the one that
+     *        allocated them. Requests larger than the largest size class are
+     *        passed straight to operator new.
+     */
+    class BufferPool
+    {
+    public:
+        /**
+         * @brief BufferPool only has static members.
+         */
+        BufferPool() = delete ;
+
+        /**
+         * @brief Allocates a block of at least the specified size, aligned
+         *        as by operator new.
+         * @param size The number of bytes required.
+         * @return Returns a pointer to the block.
+         */
+        static void* Allocate(size_t size) ;
+
+        /**
+         * @brief Returns a block to the pool.
+         * @param block The block, as returned by Allocate().
+         * @param size The size passed to Allocate() for this block.
+         */
+        static void Deallocate(void*  block,
+                               size_t size) noexcept ;
+
+        /**
+         * @brief Gets the size of the block that Allocate() returns for the
+         *        specified size.
+         * @param size The number of bytes required.
+         * @return Returns the usable size of the block.
+         */
+        static size_t GetBlockSize(size_t size) ;
+
+        /**
+         * @brief Gets the number of free blocks held in the cache of the
+         *        calling thread and in the shared depot.
+         * @return Returns the number of free blocks.
+         */
+        static size_t GetNumberOfCachedBlocks() ;
+
+        /**
+         * @brief Releases the free blocks held in the cache of the calling
+         *        thread and in the shared depot back to the system.
+         */
+        static void Trim() ;
+
+    private:
+        /**
+         * @brief Forward declaration of the per thread cache of free blocks.
+         */
+        class ThreadCache ;
+
+        /**
+         * @brief Forward declaration of the shared depot of free blocks.
+         */
+        class Depot ;
+
+        /**
+         * @brief Gets the size class serving the specified size.
+         * @param size The number of bytes required, at most
+         *        BUFFER_POOL_MAXIMUM_BLOCK_SIZE.
+         * @return Returns the index of the size class.
+         */
+        static size_t GetSizeClass(size_t size) ;
+    } ; // class BufferPool
+
+    /**
+     * @brief PoolAllocator is a standard allocator drawing from BufferPool,
+     *        which allows containers to opt into pooled memory.
+     */
+    template <typename T>
+    class PoolAllocator
+    {
+    public:
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "BufferPool blocks are aligned as by operator new.") ;
+
+        /**
+         * @brief The type of the objects allocated.
+         */
+        using value_type = T ;
+
+        /**
+         * @brief Default Constructor.
+         */
+        PoolAllocator() noexcept = default ;
+
+        /**
+         * @brief Converting Copy Constructor. All PoolAllocator instances
+         *        share the same pool.
+         */
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>& /* otherPoolAllocator */) noexcept // NOLINT (google-explicit-constructor)
+        {
+            /* Empty */
+        }
+
+        /**
+         * @brief Allocates storage for the specified number of objects.
+         * @param numberOfObjects The number of objects.
+         * @return Returns a pointer to the storage.
+         */
+        T* allocate(const size_t numberOfObjects)
+        {
+            if (numberOfObjects > std::numeric_limits<size_t>::max() / sizeof(T))
+            {
+                throw std::bad_alloc() ;
+            }
+
+            return static_cast<T*>(BufferPool::Allocate(numberOfObjects * sizeof(T))) ;
+        }
+
+        /**
+         * @brief Releases storage returned by allocate().
+         * @param objects Pointer to the storage.
+         * @param numberOfObjects The number of objects passed to allocate().
+         */
+        void deallocate(T* const     objects,
+                        const size_t numberOfObjects) noexcept
+        {
+            BufferPool::Deallocate(objects,
+                                   numberOfObjects * sizeof(T)) ;
+        }
+    } ;
+
+    /**
+     * @brief All PoolAllocator instances are interchangeable.
+     */
+    template <typename T, typename U>
+    bool operator==(const PoolAllocator<T>& /* lhs */,
+                    const PoolAllocator<U>& /* rhs */) noexcept
+    {
+        return true ;
+    }
+
+    /**
+     * @brief All PoolAllocator instances are interchangeable.
+     */
+    template <typename T, typename U>
+    bool operator!=(const PoolAllocator<T>& /* lhs */,
+                    const PoolAllocator<U>& /* rhs */) noexcept
+    {
+        return false ;
+    }
+
+    /**
+     * @brief A DataBuffer whose storage is drawn from BufferPool. Existing
+     *        code can switch to pooled memory by using this type in place
+     *        of DataBuffer.
+     */
+    using PooledDataBuffer = std::vector<uint8_t, PoolAllocator<uint8_t>> ;
+
+} // namespace LibSerial
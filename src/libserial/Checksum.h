@@ -0,0 +1,105 @@
+/******************************************************************************
+ * @file Checksum.h                                                           *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPortConstants.h>
+
+#include <cstdint>
+
+namespace LibSerial
+{
+    /**
+     * @brief The checksums computed by ComputeChecksum(). Each is appended
+     *        to the data it covers in the byte order its protocols use.
+     */
+    enum class ChecksumType
+    {
+        CRC_16_CCITT,  // !< CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF, sent big endian.
+        CRC_16_MODBUS, // !< CRC-16/MODBUS: reflected polynomial 0x8005, initial value 0xFFFF, sent little endian.
+        CRC_32         // !< CRC-32 as used by Ethernet and zlib: reflected polynomial 0x04C11DB7, sent little endian.
+    } ;
+
+    /**
+     * @brief Computes a checksum. CRCs are computed eight bytes at a time
+     *        with slicing-by-8 tables. CRC-32 uses the carry-less multiply
+     *        (PCLMULQDQ) instructions on x86-64 and the CRC32 instructions
+     *        on ARMv8 when the processor supports them.
+     * @param checksumType The checksum to compute.
+     * @param data Pointer to the data.
+     * @param size The number of bytes of data.
+     * @return Returns the checksum.
+     */
+    uint32_t ComputeChecksum(ChecksumType   checksumType,
+                             const uint8_t* data,
+                             size_t         size) ;
+
+    /**
+     * @brief Gets the number of bytes a checksum occupies when appended to
+     *        the data it covers.
+     * @param checksumType The checksum type.
+     * @return Returns the size of the checksum in bytes.
+     */
+    size_t GetChecksumSize(ChecksumType checksumType) ;
+
+    /**
+     * @brief Stores a checksum in the byte order it is sent in.
+     * @param checksumType The checksum type.
+     * @param checksum The checksum to store.
+     * @param destination Receives GetChecksumSize() bytes.
+     */
+    void StoreChecksum(ChecksumType checksumType,
+                       uint32_t     checksum,
+                       uint8_t*     destination) ;
+
+    /**
+     * @brief Computes the checksum of a buffer and appends it to the buffer.
+     * @param checksumType The checksum to compute.
+     * @param dataBuffer The data, to which the checksum is appended.
+     */
+    void AppendChecksum(ChecksumType checksumType,
+                        DataBuffer&  dataBuffer) ;
+
+    /**
+     * @brief Verifies data followed by its checksum, without copying it.
+     * @param checksumType The checksum type.
+     * @param data Pointer to the data.
+     * @param size The number of bytes of data, including the checksum.
+     * @return Returns true iff the data is at least as long as the checksum
+     *         and the checksum matches the data that precedes it.
+     */
+    bool VerifyChecksum(ChecksumType   checksumType,
+                        const uint8_t* data,
+                        size_t         size) ;
+
+} // namespace LibSerial
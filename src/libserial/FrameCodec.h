@@ -0,0 +1,283 @@
+/******************************************************************************
+ * @file FrameCodec.h                                                         *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/Checksum.h>
+#include <libserial/SerialPortConstants.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace LibSerial
+{
+    /**
+     * @brief The outcome of a call to FrameCodec::Decode().
+     */
+    enum class DecodeResult
+    {
+        INCOMPLETE, // !< More data is needed before a frame can be decoded.
+        FRAME,      // !< A complete frame has been decoded.
+        SKIPPED,    // !< Bytes carrying no frame, (e.g. idle delimiters), were consumed.
+        INVALID     // !< A malformed frame was consumed and discarded.
+    } ;
+
+    /**
+     * @brief FrameCodec is the interface implemented by the framing formats
+     *        understood by FrameReader. Decoding is performed in place: the
+     *        decoded frame is a view into the data passed to Decode(), which
+     *        may be modified in the process.
+     *
+     *        A codec may remember how much of an incomplete frame it has
+     *        already scanned, so Decode() must be passed the same frame
+     *        start, with more data appended, until it returns something
+     *        other than INCOMPLETE, or Reset() must be called first.
+     */
+    class FrameCodec
+    {
+    public:
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~FrameCodec() = default ;
+
+        /**
+         * @brief Decodes the frame at the start of the specified data.
+         * @param data The received data, starting at a frame boundary.
+         * @param size The number of bytes of received data.
+         * @param bytesConsumed Set to the number of bytes that make up the
+         *        frame, or skipped bytes, unless INCOMPLETE is returned.
+         * @param frame Set to the decoded payload if FRAME is returned.
+         * @return Returns the outcome of decoding.
+         */
+        virtual DecodeResult Decode(uint8_t*     data,
+                                    size_t       size,
+                                    size_t&      bytesConsumed,
+                                    ConstBuffer& frame) = 0 ;
+
+        /**
+         * @brief Encodes a payload as one frame.
+         * @param payload Pointer to the payload.
+         * @param payloadSize The number of bytes in the payload.
+         * @param encodedFrame The encoded frame is appended to this buffer.
+         */
+        virtual void Encode(const uint8_t* payload,
+                            size_t         payloadSize,
+                            DataBuffer&    encodedFrame) const = 0 ;
+
+        /**
+         * @brief Discards any state kept about a partially decoded frame.
+         */
+        virtual void Reset() = 0 ;
+    } ;
+
+    /**
+     * @brief Frames made of a fixed size length field holding the payload
+     *        size, followed by the payload.
+     */
+    class LengthPrefixCodec : public FrameCodec
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param lengthFieldSize The size of the length field: 1, 2 or 4 bytes.
+         * @param bigEndian True if the length field is big endian.
+         * @param maximumPayloadSize Longer frames are treated as invalid,
+         *        which allows the decoder to resynchronize after noise.
+         */
+        explicit LengthPrefixCodec(size_t lengthFieldSize    = 2,
+                                   bool   bigEndian          = true,
+                                   size_t maximumPayloadSize = 65535) ;
+
+        DecodeResult Decode(uint8_t*     data,
+                            size_t       size,
+                            size_t&      bytesConsumed,
+                            ConstBuffer& frame) override ;
+
+        void Encode(const uint8_t* payload,
+                    size_t         payloadSize,
+                    DataBuffer&    encodedFrame) const override ;
+
+        void Reset() override ;
+
+    private:
+        /**
+         * @brief The size of the length field in bytes.
+         */
+        size_t mLengthFieldSize ;
+
+        /**
+         * @brief True if the length field is big endian.
+         */
+        bool mBigEndian ;
+
+        /**
+         * @brief The maximum accepted payload size.
+         */
+        size_t mMaximumPayloadSize ;
+    } ;
+
+    /**
+     * @brief Consistent Overhead Byte Stuffing frames, each terminated by a
+     *        zero byte.
+     */
+    class CobsCodec : public FrameCodec
+    {
+    public:
+        DecodeResult Decode(uint8_t*     data,
+                            size_t       size,
+                            size_t&      bytesConsumed,
+                            ConstBuffer& frame) override ;
+
+        void Encode(const uint8_t* payload,
+                    size_t         payloadSize,
+                    DataBuffer&    encodedFrame) const override ;
+
+        void Reset() override ;
+
+    private:
+        /**
+         * @brief The number of bytes already scanned for the delimiter.
+         */
+        size_t mScanOffset = 0 ;
+    } ;
+
+    /**
+     * @brief Serial Line Internet Protocol (RFC 1055) frames.
+     */
+    class SlipCodec : public FrameCodec
+    {
+    public:
+        DecodeResult Decode(uint8_t*     data,
+                            size_t       size,
+                            size_t&      bytesConsumed,
+                            ConstBuffer& frame) override ;
+
+        void Encode(const uint8_t* payload,
+                    size_t         payloadSize,
+                    DataBuffer&    encodedFrame) const override ;
+
+        void Reset() override ;
+
+    private:
+        /**
+         * @brief The number of bytes already scanned for the END byte.
+         */
+        size_t mScanOffset = 0 ;
+    } ;
+
+    /**
+     * @brief Frames terminated by a delimiter sequence, (e.g. text lines).
+     *        The delimiter is not part of the decoded frame, and is not
+     *        escaped when it occurs in a payload being encoded.
+     */
+    class DelimiterCodec : public FrameCodec
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param delimiter The non-empty sequence terminating each frame.
+         */
+        explicit DelimiterCodec(const std::string& delimiter = "\n") ;
+
+        DecodeResult Decode(uint8_t*     data,
+                            size_t       size,
+                            size_t&      bytesConsumed,
+                            ConstBuffer& frame) override ;
+
+        void Encode(const uint8_t* payload,
+                    size_t         payloadSize,
+                    DataBuffer&    encodedFrame) const override ;
+
+        void Reset() override ;
+
+    private:
+        /**
+         * @brief The sequence terminating each frame.
+         */
+        std::string mDelimiter ;
+
+        /**
+         * @brief The number of bytes already scanned for the delimiter.
+         */
+        size_t mScanOffset = 0 ;
+    } ;
+
+    /**
+     * @brief Frames of another codec whose payload is followed by a
+     *        checksum. Decoding verifies the checksum in place and strips
+     *        it from the frame. Frames whose checksum does not match are
+     *        reported as INVALID.
+     */
+    class ChecksumCodec : public FrameCodec
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param frameCodec The codec framing the payload and its checksum.
+         * @param checksumType The checksum following each payload.
+         */
+        explicit ChecksumCodec(std::unique_ptr<FrameCodec> frameCodec,
+                               ChecksumType                checksumType = ChecksumType::CRC_16_CCITT) ;
+
+        DecodeResult Decode(uint8_t*     data,
+                            size_t       size,
+                            size_t&      bytesConsumed,
+                            ConstBuffer& frame) override ;
+
+        void Encode(const uint8_t* payload,
+                    size_t         payloadSize,
+                    DataBuffer&    encodedFrame) const override ;
+
+        void Reset() override ;
+
+    private:
+
+        /**
+         * @brief The codec framing the payload and its checksum.
+         */
+        std::unique_ptr<FrameCodec> mFrameCodec ;
+
+        /**
+         * @brief The checksum following each payload.
+         */
+        ChecksumType mChecksumType ;
+
+        /**
+         * @brief The size of the checksum in bytes.
+         */
+        size_t mChecksumSize ;
+    } ;
+
+} // namespace LibSerial
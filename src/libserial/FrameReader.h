@@ -0,0 +1,173 @@
+/******************************************************************************
+ * @file FrameReader.h                                                        *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/FrameCodec.h>
+#include <libserial/SerialPort.h>
+
+#include <memory>
+
+namespace LibSerial
+{
+    /**
+     * @brief FrameReader reads from a SerialPort in bulk into an internal
+     *        buffer and decodes complete frames in place using a FrameCodec.
+     *        Frames are returned as views into the buffer, so no copy is
+     *        made between the read() system call and the caller.
+     *
+     *        Malformed frames are discarded and counted, and decoding
+     *        resumes at the next frame boundary found by the codec.
+     */
+    class FrameReader
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param serialPort The open serial port to read frames from. The
+         *        serial port must outlive the frame reader.
+         * @param frameCodec The codec used to decode frames.
+         * @param bufferSize The size of the receive buffer, which bounds the
+         *        size of an encoded frame.
+         */
+        explicit FrameReader(SerialPort&                 serialPort,
+                             std::unique_ptr<FrameCodec> frameCodec,
+                             size_t                      bufferSize = 65536) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~FrameReader() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        FrameReader(const FrameReader& otherFrameReader) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        FrameReader(FrameReader&& otherFrameReader) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        FrameReader& operator=(const FrameReader& otherFrameReader) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        FrameReader& operator=(FrameReader&& otherFrameReader) = delete ;
+
+        /**
+         * @brief Reads the next frame from the serial port. The returned view
+         *        remains valid until the next call to a method of the frame
+         *        reader. A ReadTimeout exception is thrown if no complete
+         *        frame arrives within msTimeout milliseconds; data received
+         *        so far is retained.
+         * @param msTimeout The timeout period in milliseconds, or zero to
+         *        wait indefinitely.
+         * @return Returns a view of the decoded frame payload.
+         */
+        ConstBuffer ReadFrame(size_t msTimeout = 0) ;
+
+        /**
+         * @brief Reads the next frame from the serial port and copies its
+         *        payload to the specified buffer.
+         * @param frame The buffer receiving the decoded frame payload.
+         * @param msTimeout The timeout period in milliseconds, or zero to
+         *        wait indefinitely.
+         */
+        void ReadFrame(DataBuffer& frame,
+                       size_t      msTimeout = 0) ;
+
+        /**
+         * @brief Reads the next frame from the serial port and copies its
+         *        payload to the specified buffer drawn from BufferPool.
+         * @param frame The pooled buffer receiving the decoded frame payload.
+         * @param msTimeout The timeout period in milliseconds, or zero to
+         *        wait indefinitely.
+         */
+        void ReadFrame(PooledDataBuffer& frame,
+                       size_t            msTimeout = 0) ;
+
+        /**
+         * @brief Decodes a frame from data that has already been received,
+         *        without reading from the serial port.
+         * @param frame Set to a view of the decoded frame payload, valid
+         *        until the next call to a method of the frame reader.
+         * @return Returns true if a frame was decoded.
+         */
+        bool TryReadFrame(ConstBuffer& frame) ;
+
+        /**
+         * @brief Gets the number of malformed or oversized frames discarded.
+         * @return Returns the number of frames discarded.
+         */
+        size_t GetNumberOfInvalidFrames() const ;
+
+        /**
+         * @brief Gets the number of received bytes not yet decoded.
+         * @return Returns the number of bytes held in the receive buffer.
+         */
+        size_t GetNumberOfBufferedBytes() const ;
+
+        /**
+         * @brief Gets the codec used to decode frames, which can also be
+         *        used to encode frames sent the other way.
+         * @return Returns a reference to the frame codec.
+         */
+        const FrameCodec& GetFrameCodec() const ;
+
+        /**
+         * @brief Discards all buffered data and any partial frame.
+         */
+        void Reset() ;
+
+    protected:
+
+    private:
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class FrameReader
+
+} // namespace LibSerial
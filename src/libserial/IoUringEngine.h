@@ -0,0 +1,267 @@
+/******************************************************************************
+ * @file IoUringEngine.h                                                      *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPort.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace LibSerial
+{
+    /**
+     * @brief The queue and buffer sizes used by an IoUringEngine.
+     */
+    struct IoUringEnginePolicy
+    {
+        /**
+         * @brief The number of submission queue entries. Requests beyond
+         *        this number cause an early submission.
+         */
+        size_t queueDepth = 256 ;
+
+        /**
+         * @brief The size in bytes of each receive buffer.
+         */
+        size_t bufferSize = 4096 ;
+
+        /**
+         * @brief The number of receive buffers shared by all ports, which
+         *        must be a power of two no larger than 32768.
+         */
+        size_t numberOfBuffers = 64 ;
+    } ;
+
+    /**
+     * @brief IoUringEngine performs the reads and writes of many open serial
+     *        ports through a single io_uring instance instead of a
+     *        poll()/read()/write() sequence per port and per transfer.
+     *
+     *        Each port added to the engine has a multishot read armed that
+     *        places incoming data into receive buffers registered with the
+     *        kernel, so data keeps arriving without a system call per read.
+     *        Writes to a port are linked so that they complete in order, and
+     *        the requests of all ports are submitted together by one
+     *        io_uring_enter() call, which also waits for the completions.
+     *
+     *        The engine is compiled in only when LIBSERIAL_ENABLE_IO_URING
+     *        is defined, and requires a kernel with io_uring buffer rings
+     *        (5.19 or newer). Otherwise IsSupported() returns false and the
+     *        constructor throws. Ports remain owned by the caller and keep
+     *        working with the ordinary SerialPort methods once removed, so an
+     *        application can choose per port whether to use the engine.
+     *
+     *        The engine is not thread safe. All of its methods, and the
+     *        callbacks, run on the thread calling RunOnce().
+     */
+    class IoUringEngine
+    {
+    public:
+
+        /**
+         * @brief Handle used to identify a port added to the engine.
+         */
+        using PortId = uint64_t ;
+
+        /**
+         * @brief The callbacks invoked for a port added to the engine. Any
+         *        of the callbacks may be left empty.
+         */
+        struct Callbacks
+        {
+            /**
+             * @brief Invoked with data received from the port. The data is
+             *        only valid until the callback returns.
+             */
+            std::function<void(PortId portId, const uint8_t* dataBuffer, size_t numberOfBytes)> dataReceived {} ;
+
+            /**
+             * @brief Invoked once the data of a Write() has been written, and
+             *        drained if requested. The errorNumber argument is zero on
+             *        success, or the errno value with which the write failed.
+             */
+            std::function<void(PortId portId, size_t numberOfBytes, int errorNumber)> writeComplete {} ;
+
+            /**
+             * @brief Invoked when reading from the port fails, e.g. because
+             *        the device has been unplugged. No further data is
+             *        received from the port until it is removed.
+             */
+            std::function<void(PortId portId, int errorNumber)> hangUp {} ;
+        } ;
+
+        /**
+         * @brief Constructor. Creates the io_uring instance and registers the
+         *        receive buffers.
+         * @param ioUringEnginePolicy The queue and buffer sizes.
+         */
+        explicit IoUringEngine(const IoUringEnginePolicy& ioUringEnginePolicy = IoUringEnginePolicy()) ;
+
+        /**
+         * @brief Default Destructor. Removes all ports from the engine, but
+         *        does not close them.
+         */
+        virtual ~IoUringEngine() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        IoUringEngine(const IoUringEngine& otherIoUringEngine) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        IoUringEngine(IoUringEngine&& otherIoUringEngine) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        IoUringEngine& operator=(const IoUringEngine& otherIoUringEngine) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        IoUringEngine& operator=(IoUringEngine&& otherIoUringEngine) = delete ;
+
+        /**
+         * @brief Determines whether the engine was compiled in and is
+         *        supported by the running kernel.
+         * @return Returns true if an IoUringEngine can be constructed.
+         */
+        static bool IsSupported() ;
+
+        /**
+         * @brief Adds an open serial port to the engine and arms its read.
+         *        The serial port must remain open until it is removed, and
+         *        must not be read from directly in the meantime.
+         * @param serialPort The serial port.
+         * @param callbacks The callbacks to invoke for the serial port.
+         * @return Returns the handle identifying the serial port.
+         */
+        PortId Add(SerialPort&      serialPort,
+                   const Callbacks& callbacks) ;
+
+        /**
+         * @brief Cancels the requests of a port and removes it from the
+         *        engine, without closing it. Must not be called from a
+         *        callback.
+         * @param portId The handle of the port to be removed.
+         */
+        void Remove(PortId portId) ;
+
+        /**
+         * @brief Gets the number of ports added to the engine.
+         * @return Returns the number of ports.
+         */
+        size_t GetNumberOfPorts() const ;
+
+        /**
+         * @brief Queues data to be written to a port. The data is copied, and
+         *        is submitted with the next call to Submit() or RunOnce().
+         * @param portId The handle of the port.
+         * @param dataBuffer Pointer to the data to be written.
+         * @param numberOfBytes The number of bytes to be written.
+         * @param drainWriteBuffer True to wait until the data has been
+         *        transmitted, as with DrainWriteBuffer(), before the
+         *        writeComplete callback is invoked.
+         */
+        void Write(PortId         portId,
+                   const uint8_t* dataBuffer,
+                   size_t         numberOfBytes,
+                   bool           drainWriteBuffer = false) ;
+
+        /**
+         * @brief Queues data to be written to a port.
+         * @param portId The handle of the port.
+         * @param dataBuffer The data to be written.
+         * @param drainWriteBuffer True to drain the data before the
+         *        writeComplete callback is invoked.
+         */
+        void Write(PortId            portId,
+                   const DataBuffer& dataBuffer,
+                   bool              drainWriteBuffer = false) ;
+
+        /**
+         * @brief Queues data to be written to a port.
+         * @param portId The handle of the port.
+         * @param dataString The data to be written.
+         * @param drainWriteBuffer True to drain the data before the
+         *        writeComplete callback is invoked.
+         */
+        void Write(PortId             portId,
+                   const std::string& dataString,
+                   bool               drainWriteBuffer = false) ;
+
+        /**
+         * @brief Submits all queued requests, of every port, with a single
+         *        system call without waiting for their completion.
+         * @return Returns the number of requests submitted.
+         */
+        size_t Submit() ;
+
+        /**
+         * @brief Submits all queued requests, waits for completions and
+         *        dispatches them. If msTimeout is zero, this method blocks
+         *        until at least one completion has arrived. Completions that
+         *        have already arrived are dispatched without a system call.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t RunOnce(size_t msTimeout = 0) ;
+
+        /**
+         * @brief Gets the number of io_uring_enter() system calls made, for
+         *        comparison with the number of bytes transferred.
+         * @return Returns the number of system calls.
+         */
+        size_t GetNumberOfSystemCalls() const ;
+
+    protected:
+
+    private:
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class IoUringEngine
+
+} // namespace LibSerial
@@ -0,0 +1,329 @@
+/******************************************************************************
+ * @file ResilientSerialPort.h                                                *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPort.h>
+#include <libserial/SerialPortEnumerator.h>
+
+#include <memory>
+#include <string>
+
+namespace LibSerial
+{
+    /**
+     * @brief The longest time in milliseconds between two scans of sysfs
+     *        for the device of a disconnected ResilientSerialPort. Hotplug
+     *        events, when they can be monitored, trigger a scan at once.
+     */
+    constexpr size_t RECONNECT_SCAN_INTERVAL_MS = 10 ;
+
+    /**
+     * @brief ResilientSerialPort is a serial port that survives its device
+     *        being removed and plugged in again, as happens when a USB
+     *        serial adapter briefly drops off the bus.
+     *
+     *        The device is identified by its USB serial number rather than
+     *        by its device node, which may change when it reappears. When a
+     *        read or write fails because the device went away, the port is
+     *        closed and reopened as soon as a device with the same serial
+     *        number is present again, listening for hotplug events with
+     *        SerialPortEnumerator so that no time is lost polling. The
+     *        cached port settings are reapplied with the single tcsetattr()
+     *        of SerialPort::Open(), followed by the bit rate set with
+     *        SetBitRate(), if any; other settings, (e.g. RS-485 mode), are
+     *        not restored. Settings that can never be applied are rejected
+     *        with std::invalid_argument when they are set.
+     *
+     *        Reads wait across a disconnection within their timeout. Writes
+     *        never wait: while the device is absent they are kept in an
+     *        optional replay queue of bounded size, (the oldest writes are
+     *        dropped when it is full), and sent in order as soon as the
+     *        device has been reopened. Of a write interrupted by the
+     *        disconnection, only the bytes the driver had not yet accepted
+     *        are replayed; bytes accepted by the driver but lost with the
+     *        device are not resent. Without a replay queue,
+     *        writing to a disconnected port throws a std::runtime_error.
+     *
+     *        Like SerialPort, a ResilientSerialPort must be used from one
+     *        thread at a time.
+     */
+    class ResilientSerialPort
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param sysfsTtyDirectory The sysfs tty class directory searched
+         *        for the device, which only needs to be changed for testing
+         *        purposes.
+         * @param deviceDirectory The directory holding the device nodes,
+         *        which likewise only needs to be changed for testing
+         *        purposes.
+         */
+        explicit ResilientSerialPort(const std::string& sysfsTtyDirectory = SYSFS_TTY_CLASS_DIRECTORY,
+                                     const std::string& deviceDirectory = DEVICE_DIRECTORY) ;
+
+        /**
+         * @brief Default Destructor. Closes the serial port if it is open.
+         */
+        virtual ~ResilientSerialPort() noexcept ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        ResilientSerialPort(const ResilientSerialPort& otherResilientSerialPort) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        ResilientSerialPort(ResilientSerialPort&& otherResilientSerialPort) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        ResilientSerialPort& operator=(const ResilientSerialPort& otherResilientSerialPort) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        ResilientSerialPort& operator=(ResilientSerialPort&& otherResilientSerialPort) = delete ;
+
+        /**
+         * @brief Opens the serial port of the device with the specified
+         *        USB serial number, which must be present, and configures it
+         *        with the specified parameters.
+         * @param serialNumber The USB serial number of the device, as
+         *        reported in SerialPortInfo::serialNumber.
+         * @param portSettings The serial port parameters to be set.
+         * @param openMode The communication mode status when the serial
+         *        communication port is opened.
+         */
+        void Open(const std::string&             serialNumber,
+                  const PortSettings&            portSettings = PortSettings(),
+                  const std::ios_base::openmode& openMode = std::ios_base::in | std::ios_base::out) ;
+
+        /**
+         * @brief Closes the serial port and discards any queued writes.
+         */
+        void Close() ;
+
+        /**
+         * @brief Determines if the serial port is open, whether or not its
+         *        device is currently connected.
+         * @return Returns true iff Open() has been called and Close() has
+         *         not.
+         */
+        bool IsOpen() const ;
+
+        /**
+         * @brief Determines if the device of the serial port is connected,
+         *        i.e. if the last read or write did not find it removed.
+         * @return Returns true iff the device is connected.
+         */
+        bool IsConnected() const ;
+
+        /**
+         * @brief Waits until the device of the serial port is connected,
+         *        reopening it if it was disconnected.
+         * @param msTimeout The timeout period in milliseconds, or zero to
+         *        wait indefinitely.
+         * @return Returns true if the device is connected, false if it did
+         *         not reappear within msTimeout milliseconds.
+         */
+        bool WaitForReconnect(size_t msTimeout = 0) ;
+
+        /**
+         * @brief Gets the device node the serial port is currently open on.
+         * @return Returns the device path, or an empty string while the
+         *         device is disconnected.
+         */
+        std::string GetDevicePath() const ;
+
+        /**
+         * @brief Gets the number of times the device has been reopened
+         *        after a disconnection.
+         * @return Returns the number of reconnections.
+         */
+        size_t GetNumberOfReconnects() const ;
+
+        /**
+         * @brief Sets the size of the queue of writes replayed once the
+         *        device reconnects. Writes already queued beyond the new
+         *        size are dropped, oldest first.
+         * @param numberOfBytes The maximum number of bytes queued, or zero
+         *        to disable the replay queue, which is the default.
+         */
+        void SetReplayQueueSize(size_t numberOfBytes) ;
+
+        /**
+         * @brief Gets the size of the replay queue.
+         * @return Returns the maximum number of bytes queued.
+         */
+        size_t GetReplayQueueSize() const ;
+
+        /**
+         * @brief Gets the number of bytes waiting in the replay queue.
+         * @return Returns the number of bytes queued.
+         */
+        size_t GetNumberOfBytesQueued() const ;
+
+        /**
+         * @brief Gets the number of bytes dropped because the replay queue
+         *        was full.
+         * @return Returns the number of bytes dropped.
+         */
+        size_t GetNumberOfBytesDropped() const ;
+
+        /**
+         * @brief Sets all serial port parameters and caches them for the
+         *        next reconnection. While the device is disconnected the
+         *        parameters are only cached, and applied when it reappears.
+         * @param portSettings The serial port parameters to be set.
+         */
+        void SetSerialPortParameters(const PortSettings& portSettings) ;
+
+        /**
+         * @brief Gets the serial port parameters that are applied when the
+         *        device reconnects.
+         * @return Returns the port settings.
+         */
+        PortSettings GetSerialPortParameters() const ;
+
+        /**
+         * @brief Sets a bit rate that has no BaudRate value, see
+         *        SerialPort::SetBitRate(), and caches it for the next
+         *        reconnection. While the device is disconnected the bit rate
+         *        is only cached, and applied when it reappears, after the
+         *        port is opened with the last valid BaudRate.
+         * @param bitRate The bit rate in bits per second.
+         */
+        void SetBitRate(speed_t bitRate) ;
+
+        /**
+         * @brief Gets the underlying serial port, e.g. to control the modem
+         *        lines. It is closed while the device is disconnected and
+         *        must not be opened or closed directly. Changes made to its
+         *        PortSettings parameters are kept across reconnections. A
+         *        bit rate set with its SetBitRate() is only kept if it can
+         *        still be read back when the disconnection is detected, so
+         *        use SetBitRate() of this class instead.
+         * @return Returns the underlying serial port.
+         */
+        SerialPort& GetSerialPort() ;
+
+        /**
+         * @brief Reads up to bufferSize bytes from the serial port directly
+         *        into caller owned memory. The method blocks until at least
+         *        one byte is available, reconnecting the device if needed,
+         *        and then returns everything that has arrived, up to
+         *        bufferSize bytes. If no data arrives within msTimeout
+         *        milliseconds, a ReadTimeout exception is thrown. If
+         *        msTimeout is zero, then this method will block until data
+         *        becomes available.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of bytes placed into dataBuffer.
+         */
+        size_t Read(uint8_t* dataBuffer,
+                    size_t   bufferSize,
+                    size_t   msTimeout = 0) ;
+
+        /**
+         * @brief Reads exactly numberOfBytes bytes from the serial port into
+         *        dataBuffer, which is resized to hold them, reconnecting the
+         *        device as often as needed. If they do not all arrive within
+         *        msTimeout milliseconds, a ReadTimeout exception is thrown and
+         *        dataBuffer holds the bytes received so far. If msTimeout is
+         *        zero, then this method will block until all requested bytes
+         *        are received.
+         * @param dataBuffer The data buffer to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void Read(DataBuffer& dataBuffer,
+                  size_t      numberOfBytes,
+                  size_t      msTimeout = 0) ;
+
+        /**
+         * @brief Reads a single byte from the serial port. If no data is
+         *        available within the specified number of milliseconds,
+         *        (msTimeout), then this method will throw a ReadTimeout
+         *        exception. If msTimeout is zero, then this method will
+         *        block until data becomes available.
+         * @param charBuffer The character read from the serial port.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadByte(char&  charBuffer,
+                      size_t msTimeout = 0) ;
+
+        /**
+         * @brief Writes numberOfBytes bytes to the serial port, or queues
+         *        them for replay if the device is disconnected.
+         * @param dataBuffer Pointer to the data to be written.
+         * @param numberOfBytes The number of bytes to write.
+         */
+        void Write(const uint8_t* dataBuffer,
+                   size_t         numberOfBytes) ;
+
+        /**
+         * @brief Writes a DataBuffer to the serial port, or queues it for
+         *        replay if the device is disconnected.
+         * @param dataBuffer The data to be written.
+         */
+        void Write(const DataBuffer& dataBuffer) ;
+
+        /**
+         * @brief Writes a std::string to the serial port, or queues it for
+         *        replay if the device is disconnected.
+         * @param dataString The data to be written.
+         */
+        void Write(const std::string& dataString) ;
+
+    protected:
+
+    private:
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class ResilientSerialPort
+
+} // namespace LibSerial
@@ -0,0 +1,442 @@
+/******************************************************************************
+ * @file SerialCapture.h                                                      *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPort.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace LibSerial
+{
+    /**
+     * @brief The direction of the data in a capture record.
+     */
+    enum class CaptureDirection : uint8_t
+    {
+        CAPTURE_DIRECTION_RECEIVED,    // !< Data read from the serial port.
+        CAPTURE_DIRECTION_TRANSMITTED, // !< Data written to the serial port.
+    } ;
+
+    /**
+     * @brief The value of CaptureFileHeader::magic, "LIBSCAP1" when stored
+     *        in little-endian byte order.
+     */
+    constexpr uint64_t CAPTURE_FILE_MAGIC = 0x315041435342494CULL ;
+
+    /**
+     * @brief The version of the capture file format described here.
+     */
+    constexpr uint32_t CAPTURE_FILE_VERSION = 1 ;
+
+    /**
+     * @brief The alignment in bytes of each record in a capture file.
+     */
+    constexpr size_t CAPTURE_RECORD_ALIGNMENT = 8 ;
+
+    /**
+     * @brief The default initial size in bytes of a capture file, which is
+     *        doubled whenever it fills up.
+     */
+    constexpr size_t CAPTURE_FILE_SIZE_DEFAULT = 1 << 20 ;
+
+    /**
+     * @brief The header at the start of a capture file. All fields are
+     *        stored in host byte order. The header is followed by dataSize
+     *        bytes of records, each a CaptureRecordHeader followed by its
+     *        data and padded to CAPTURE_RECORD_ALIGNMENT bytes.
+     */
+    struct CaptureFileHeader
+    {
+        uint64_t magic ;       // !< CAPTURE_FILE_MAGIC.
+        uint32_t version ;     // !< CAPTURE_FILE_VERSION.
+        uint32_t headerSize ;  // !< The size of this header in bytes.
+        uint64_t dataSize ;    // !< The number of bytes of complete records.
+        uint64_t reserved ;    // !< Zero.
+    } ;
+
+    /**
+     * @brief The header of one record in a capture file.
+     */
+    struct CaptureRecordHeader
+    {
+        uint64_t timestamp ;   // !< Nanoseconds since the capture started.
+        uint32_t size ;        // !< The number of data bytes that follow.
+        uint8_t  direction ;   // !< A CaptureDirection value.
+        uint8_t  reserved[3] ; // NOLINT (cppcoreguidelines-avoid-c-arrays)
+    } ;
+
+    /**
+     * @brief CaptureTap wraps a SerialPort and records the data read from
+     *        and written to it, with its direction and a monotonic
+     *        timestamp, in an append-only capture file that can later be
+     *        replayed with ReplayPort. The file is memory mapped, so a record
+     *        is a copy into the mapping rather than a system call; the only
+     *        system calls are those that grow the file when it fills up. As
+     *        the mapping is shared, records already made survive a crash of
+     *        the process.
+     */
+    class CaptureTap
+    {
+    public:
+        /**
+         * @brief Constructor. Creates or truncates the capture file.
+         * @param serialPort The serial port to capture. The serial port must
+         *        outlive the capture tap.
+         * @param fileName The name of the capture file.
+         * @param initialFileSize The initial size of the capture file.
+         */
+        explicit CaptureTap(SerialPort&        serialPort,
+                            const std::string& fileName,
+                            size_t             initialFileSize = CAPTURE_FILE_SIZE_DEFAULT) ;
+
+        /**
+         * @brief Default Destructor. Truncates the capture file to the
+         *        records made and closes it.
+         */
+        virtual ~CaptureTap() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        CaptureTap(const CaptureTap& otherCaptureTap) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        CaptureTap(CaptureTap&& otherCaptureTap) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        CaptureTap& operator=(const CaptureTap& otherCaptureTap) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        CaptureTap& operator=(CaptureTap&& otherCaptureTap) = delete ;
+
+        /**
+         * @brief Reads from the serial port with SerialPort::Read() and
+         *        records the data read, including any data received before a
+         *        ReadTimeout exception.
+         * @param dataBuffer The data buffer to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void Read(DataBuffer& dataBuffer,
+                  size_t      numberOfBytes = 0,
+                  size_t      msTimeout = 0) ;
+
+        /**
+         * @brief Reads from the serial port with SerialPort::Read() and
+         *        records the data read.
+         * @param dataString The string to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void Read(std::string& dataString,
+                  size_t       numberOfBytes = 0,
+                  size_t       msTimeout = 0) ;
+
+        /**
+         * @brief Reads from the serial port into caller owned memory with
+         *        SerialPort::Read() and records the data read.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of bytes placed into dataBuffer.
+         */
+        size_t Read(uint8_t* dataBuffer,
+                    size_t   bufferSize,
+                    size_t   msTimeout = 0) ;
+
+        /**
+         * @brief Reads a single byte from the serial port with
+         *        SerialPort::ReadByte() and records it.
+         * @param charBuffer The character read from the serial port.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadByte(unsigned char& charBuffer,
+                      size_t         msTimeout = 0) ;
+
+        /**
+         * @brief Reads a line from the serial port with SerialPort::ReadLine()
+         *        and records the data read.
+         * @param dataString The data string read from the serial port.
+         * @param lineTerminator The line termination character.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadLine(std::string& dataString,
+                      char         lineTerminator = '\n',
+                      size_t       msTimeout = 0) ;
+
+        /**
+         * @brief Writes to the serial port with SerialPort::Write() and
+         *        records the data written.
+         * @param dataBuffer The data to write to the serial port.
+         */
+        void Write(const DataBuffer& dataBuffer) ;
+
+        /**
+         * @brief Writes to the serial port with SerialPort::Write() and
+         *        records the data written.
+         * @param dataString The data to write to the serial port.
+         */
+        void Write(const std::string& dataString) ;
+
+        /**
+         * @brief Writes to the serial port with SerialPort::Write() and
+         *        records the data written.
+         * @param dataBuffer Pointer to the data to write to the serial port.
+         * @param bufferSize The number of bytes to write.
+         */
+        void Write(const uint8_t* dataBuffer,
+                   size_t         bufferSize) ;
+
+        /**
+         * @brief Writes a single byte to the serial port with
+         *        SerialPort::WriteByte() and records it.
+         * @param charBuffer The byte to write to the serial port.
+         */
+        void WriteByte(unsigned char charBuffer) ;
+
+        /**
+         * @brief Appends a record to the capture file without using the
+         *        serial port, e.g. for data transferred through other means.
+         *        Records may be made from several threads at once.
+         * @param captureDirection The direction of the data.
+         * @param dataBuffer Pointer to the data to be recorded.
+         * @param bufferSize The number of bytes to be recorded.
+         */
+        void Record(CaptureDirection captureDirection,
+                    const uint8_t*   dataBuffer,
+                    size_t           bufferSize) ;
+
+        /**
+         * @brief Gets the number of records made.
+         * @return Returns the number of records in the capture file.
+         */
+        size_t GetNumberOfRecords() const ;
+
+    protected:
+
+    private:
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class CaptureTap
+
+    /**
+     * @brief ReplayPort stands in for a SerialPort in tests and benchmarks
+     *        by replaying the received data of a capture file made with
+     *        CaptureTap. Data becomes available at the times at which it was
+     *        captured, scaled by the replay speed, or all at once if the
+     *        replay speed is zero. Data written to a replay port is
+     *        discarded. Once all of the captured data has been read, read
+     *        methods throw ReadTimeout without waiting.
+     */
+    class ReplayPort
+    {
+    public:
+        /**
+         * @brief Constructor. Maps the capture file and starts the replay.
+         * @param fileName The name of the capture file.
+         * @param replaySpeed The replay speed relative to real time, e.g.
+         *        10.0 for ten times faster, or zero to make all of the data
+         *        available at once.
+         */
+        explicit ReplayPort(const std::string& fileName,
+                            double             replaySpeed = 1.0) ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~ReplayPort() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        ReplayPort(const ReplayPort& otherReplayPort) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        ReplayPort(ReplayPort&& otherReplayPort) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        ReplayPort& operator=(const ReplayPort& otherReplayPort) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        ReplayPort& operator=(ReplayPort&& otherReplayPort) = delete ;
+
+        /**
+         * @brief Reads the specified number of bytes, with the same
+         *        behavior as SerialPort::Read().
+         * @param dataBuffer The data buffer to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void Read(DataBuffer& dataBuffer,
+                  size_t      numberOfBytes = 0,
+                  size_t      msTimeout = 0) ;
+
+        /**
+         * @brief Reads the specified number of bytes, with the same
+         *        behavior as SerialPort::Read().
+         * @param dataString The string to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void Read(std::string& dataString,
+                  size_t       numberOfBytes = 0,
+                  size_t       msTimeout = 0) ;
+
+        /**
+         * @brief Reads up to bufferSize bytes into caller owned memory, with
+         *        the same behavior as SerialPort::Read().
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of bytes placed into dataBuffer.
+         */
+        size_t Read(uint8_t* dataBuffer,
+                    size_t   bufferSize,
+                    size_t   msTimeout = 0) ;
+
+        /**
+         * @brief Reads a single byte, with the same behavior as
+         *        SerialPort::ReadByte().
+         * @param charBuffer The character read.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadByte(unsigned char& charBuffer,
+                      size_t         msTimeout = 0) ;
+
+        /**
+         * @brief Reads a line, with the same behavior as
+         *        SerialPort::ReadLine().
+         * @param dataString The data string read.
+         * @param lineTerminator The line termination character.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void ReadLine(std::string& dataString,
+                      char         lineTerminator = '\n',
+                      size_t       msTimeout = 0) ;
+
+        /**
+         * @brief Discards the data, counting the bytes written.
+         * @param dataBuffer The data written.
+         */
+        void Write(const DataBuffer& dataBuffer) ;
+
+        /**
+         * @brief Discards the data, counting the bytes written.
+         * @param dataString The data written.
+         */
+        void Write(const std::string& dataString) ;
+
+        /**
+         * @brief Discards the data, counting the bytes written.
+         * @param dataBuffer Pointer to the data written.
+         * @param bufferSize The number of bytes written.
+         */
+        void Write(const uint8_t* dataBuffer,
+                   size_t         bufferSize) ;
+
+        /**
+         * @brief Discards the byte, counting it as written.
+         * @param charBuffer The byte written.
+         */
+        void WriteByte(unsigned char charBuffer) ;
+
+        /**
+         * @brief Checks if data that has been replayed is waiting to be read.
+         * @return Returns true if data is available.
+         */
+        bool IsDataAvailable() const ;
+
+        /**
+         * @brief Gets the number of bytes that have been replayed and are
+         *        waiting to be read.
+         * @return Returns the number of bytes available.
+         */
+        size_t GetNumberOfBytesAvailable() const ;
+
+        /**
+         * @brief Determines whether all of the captured data has been read.
+         * @return Returns true at the end of the capture.
+         */
+        bool IsEndOfCapture() const ;
+
+        /**
+         * @brief Restarts the replay from the start of the capture.
+         */
+        void Rewind() ;
+
+        /**
+         * @brief Gets the number of bytes written to the replay port.
+         * @return Returns the number of bytes written.
+         */
+        size_t GetNumberOfBytesWritten() const ;
+
+    protected:
+
+    private:
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class ReplayPort
+
+} // namespace LibSerial
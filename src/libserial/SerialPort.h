@@ -33,8 +33,12 @@
 
 #pragma once
 
+#include <libserial/BufferPool.h>
+#include <libserial/Checksum.h>
 #include <libserial/SerialPortConstants.h>
+#include <libserial/SerialPortStatistics.h>
 
+#include <initializer_list>
 #include <ios>
 #include <memory>
 
@@ -116,6 +120,23 @@ namespace LibSerial
         void Open(const std::string& fileName,
                   const std::ios_base::openmode& openMode = std::ios_base::in | std::ios_base::out) ;
 
+        /**
+         * @brief Opens the serial port associated with the specified file
+         *        name and configures it with the specified parameters. The
+         *        parameters are applied together with the default settings
+         *        in a single call to tcsetattr(), rather than one call per
+         *        parameter as when each setter is called after Open(). If
+         *        any of the parameters are invalid an exception is thrown
+         *        and the serial port is closed again.
+         * @param fileName The file name of the serial port.
+         * @param portSettings The serial port parameters to be set.
+         * @param openMode The communication mode status when the serial
+         *        communication port is opened.
+         */
+        void Open(const std::string& fileName,
+                  const PortSettings& portSettings,
+                  const std::ios_base::openmode& openMode = std::ios_base::in | std::ios_base::out) ;
+
         /**
          * @brief Closes the serial port. All settings of the serial port will be
          *        lost and no more I/O can be performed on the serial port.
@@ -127,6 +148,18 @@ namespace LibSerial
          */
         void DrainWriteBuffer() ;
 
+        /**
+         * @brief Waits until the write buffer is drained or the timeout
+         *        period elapses. The depth of the transmit queue is checked
+         *        with TIOCOUTQ at intervals derived from the bit rate, and
+         *        once it is empty, TIOCSERGETLSR is polled until the last
+         *        characters have left the UART, for drivers that support it.
+         * @param msTimeout The timeout period in milliseconds. If zero,
+         *        this method waits like DrainWriteBuffer().
+         * @return Returns true iff the write buffer was drained.
+         */
+        bool DrainWriteBuffer(size_t msTimeout) ;
+
         /**
          * @brief Flushes the serial port input buffer.
          */
@@ -159,6 +192,24 @@ namespace LibSerial
          */
         void SetDefaultSerialPortParameters() ;
 
+        /**
+         * @brief Sets the baud rate, character size, flow control, parity,
+         *        stop bits, VMIN and VTIME of the serial port with a single
+         *        call to tcsetattr(). If any of the parameters are invalid
+         *        an exception is thrown and the serial port is left
+         *        unchanged. As with SetFlowControl(), the input and output
+         *        buffers are flushed if the flow control is changed.
+         * @param portSettings The serial port parameters to be set.
+         */
+        void SetSerialPortParameters(const PortSettings& portSettings) ;
+
+        /**
+         * @brief Gets the baud rate, character size, flow control, parity,
+         *        stop bits, VMIN and VTIME of the serial port.
+         * @return Returns the current serial port parameters.
+         */
+        PortSettings GetSerialPortParameters() const ;
+
         /**
          * @brief Sets the baud rate for the serial port to the specified value
          * @param baudRate The baud rate to be set for the serial port.
@@ -171,6 +222,25 @@ namespace LibSerial
          */
         BaudRate GetBaudRate() const ;
 
+        /**
+         * @brief Sets the serial port to an arbitrary bit rate in bits per
+         *        second, such as 250000 for DMX or rates above 4 Mbaud,
+         *        through the termios2 interface. Once set, GetBaudRate()
+         *        returns BaudRate::BAUD_INVALID until SetBaudRate() selects
+         *        a standard rate again. The driver may round the rate to the
+         *        nearest one its hardware supports, see GetBitRate().
+         * @param bitRate The bit rate in bits per second.
+         */
+        void SetBitRate(const speed_t bitRate) ;
+
+        /**
+         * @brief Gets the bit rate in bits per second currently used by the
+         *        serial port, whether it was set with SetBitRate() or
+         *        SetBaudRate().
+         * @return Returns the bit rate in bits per second.
+         */
+        speed_t GetBitRate() const ;
+
         /**
          * @brief Sets the character size for the serial port.
          * @param characterSize The character size to be set.
@@ -247,6 +317,63 @@ namespace LibSerial
          */
         short GetVTime() const ;
 
+        /**
+         * @brief Enables or disables the low latency mode of the serial port
+         *        driver. This sets or clears ASYNC_LOW_LATENCY with
+         *        TIOCSSERIAL, which asks the driver to pass received data to
+         *        the tty layer immediately rather than from a deferred work
+         *        queue. For USB serial adapters that expose a latency_timer
+         *        attribute in sysfs, such as FTDI devices whose default 16 ms
+         *        timer dominates request/response round trips, the timer is
+         *        also set to LATENCY_TIMER_LOW_LATENCY milliseconds if the
+         *        attribute is writable. The original driver settings are
+         *        restored when the serial port is closed.
+         * @param lowLatency True to enable low latency mode.
+         */
+        void SetLowLatency(const bool lowLatency) ;
+
+        /**
+         * @brief Determines whether the low latency mode of the serial port
+         *        driver is enabled.
+         * @return Returns true if ASYNC_LOW_LATENCY is set.
+         */
+        bool IsLowLatency() const ;
+
+        /**
+         * @brief Applies a preset of VMIN, VTIME and driver buffering
+         *        settings. LATENCY_PROFILE_LATENCY sets VMIN to 1 and VTIME
+         *        to 0, so that blocking reads return as soon as one byte
+         *        arrives, and enables low latency mode. LATENCY_PROFILE_THROUGHPUT
+         *        sets VMIN to VMIN_THROUGHPUT and VTIME to VTIME_THROUGHPUT, so
+         *        that blocking reads return full buffers or after an idle
+         *        gap, and disables low latency mode. Drivers that do not
+         *        support TIOCSSERIAL, such as pseudo terminals, only receive
+         *        the VMIN and VTIME settings.
+         * @param latencyProfile The profile to be applied.
+         */
+        void SetLatencyProfile(const LatencyProfile& latencyProfile) ;
+
+        /**
+         * @brief Configures the RS-485 mode of the serial port driver with
+         *        TIOCSRS485. In RS-485 mode the driver, or the UART itself,
+         *        drives RTS to enable the bus transmitter for exactly the
+         *        duration of each transmission, so half-duplex buses need no
+         *        SetRTS() and DrainWriteBuffer() calls around every Write().
+         *        The driver may adjust settings its hardware does not
+         *        support, see GetRS485Settings(). The original RS-485 settings
+         *        are restored when the serial port is closed. Drivers without
+         *        RS-485 support, such as pseudo terminals, cause a
+         *        std::runtime_error to be thrown.
+         * @param rs485Settings The RS-485 settings to be applied.
+         */
+        void SetRS485Settings(const RS485Settings& rs485Settings) ;
+
+        /**
+         * @brief Gets the RS-485 settings in effect in the serial port driver.
+         * @return Returns the RS-485 settings reported by TIOCGRS485.
+         */
+        RS485Settings GetRS485Settings() const ;
+
         /**
          * @brief Sets the DTR line to the specified value.
          * @param dtrState The line voltage state to be set,
@@ -287,6 +414,10 @@ namespace LibSerial
 
         /**
          * @brief Gets the serial port file descriptor.
+         * @note The serial port parameters are cached when they are set, so
+         *       changes made directly to the terminal attributes of this
+         *       file descriptor, (e.g. with tcsetattr()), are not reported
+         *       by the Get...() methods.
          * @return Returns the serial port file descriptor.
          */
         int GetFileDescriptor() const ;
@@ -297,9 +428,20 @@ namespace LibSerial
          */
         int GetNumberOfBytesAvailable() ;
 
+        /**
+         * @brief Gets the number of bytes written to the serial port that
+         *        the driver has not yet transmitted, with TIOCOUTQ. Some
+         *        drivers do not count the characters already moved to the
+         *        transmit FIFO of the UART.
+         * @return Returns the number of bytes pending transmission.
+         */
+        int GetNumberOfBytesPending() const ;
+
 #ifdef __linux__
         /**
-         * @brief Gets a list of available serial ports.
+         * @brief Gets a list of available serial ports. The list is read
+         *         from sysfs without opening any device. Use
+         *         SerialPortEnumerator for USB metadata and hotplug events.
          * @return Returns a std::vector of std::strings with the name of
          *         each available serial port.
          */
@@ -344,6 +486,57 @@ namespace LibSerial
                   size_t       numberOfBytes = 0,
                   size_t       msTimeout = 0) ;
 
+        /**
+         * @brief Reads the specified number of bytes from the serial port
+         *        into a buffer drawn from BufferPool. The behavior is the
+         *        same as for the DataBuffer Read() method; reusing the same
+         *        buffer avoids allocating at all once it has grown.
+         * @param dataBuffer The pooled data buffer to place data into.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds.
+         */
+        void Read(PooledDataBuffer& dataBuffer,
+                  size_t            numberOfBytes = 0,
+                  size_t            msTimeout = 0) ;
+
+        /**
+         * @brief Reads up to bufferSize bytes from the serial port directly
+         *        into caller owned memory. The method blocks until at least
+         *        one byte is available and then returns everything that has
+         *        arrived, up to bufferSize bytes, without allocating. If no
+         *        data arrives within msTimeout milliseconds, a ReadTimeout
+         *        exception is thrown. If msTimeout is zero, then this method
+         *        will block until data becomes available.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of bytes placed into dataBuffer.
+         */
+        size_t Read(uint8_t* dataBuffer,
+                    size_t   bufferSize,
+                    size_t   msTimeout = 0) ;
+
+        /**
+         * @brief Reads the specified number of bytes from the serial port,
+         *        recording when each chunk of data arrived. The timestamp of
+         *        a chunk is taken from the monotonic clock as soon as poll()
+         *        reports that data is available, before the data is read,
+         *        so it does not include the time spent returning to the
+         *        caller. Data retained by a previous ReadLine() is returned
+         *        first, as one chunk stamped with the time it was read. If
+         *        numberOfBytes is zero, the method returns after the first
+         *        chunk. If the data does not arrive within msTimeout
+         *        milliseconds, a ReadTimeout exception is thrown and the data
+         *        received so far remains available in timestampedData.
+         * @param timestampedData The data read and the chunk timestamps.
+         * @param numberOfBytes The number of bytes to read before returning.
+         * @param msTimeout The timeout period in milliseconds, or zero to
+         *        wait indefinitely.
+         */
+        void ReadTimestamped(TimestampedDataBuffer& timestampedData,
+                             size_t                 numberOfBytes = 0,
+                             size_t                 msTimeout = 0) ;
+
         /**
          * @brief Reads a single byte from the serial port. If no data is
          *        available within the specified number of milliseconds,
@@ -375,6 +568,10 @@ namespace LibSerial
          *        If msTimeout is 0, then this method will block until a line
          *        terminator is received. In all cases, any data received
          *        remains available in the string on return from this method.
+         *        Data is read from the serial port in bulk; any bytes received
+         *        after the line terminator are retained and returned by
+         *        subsequent Read...() calls, and are included in the values
+         *        reported by IsDataAvailable() and GetNumberOfBytesAvailable().
          * @param dataString The data string read from the serial port.
          * @param lineTerminator The line termination character to specify the
          *        end of a line.
@@ -385,6 +582,23 @@ namespace LibSerial
                       char         lineTerminator = '\n',
                       size_t       msTimeout = 0) ;
 
+        /**
+         * @brief Reads a line of characters ending with a multi-character
+         *        line terminator, (e.g. "\r\n"), from the serial port.
+         *        The timeout behavior and the handling of data received
+         *        after the line terminator are the same as for the single
+         *        character ReadLine() method.
+         * @param dataString The data string read from the serial port,
+         *        including the line terminator.
+         * @param lineTerminator The non-empty sequence of characters that
+         *        specifies the end of a line.
+         * @param msTimeout The timeout value to return if a line terminator
+         *        is not read.
+         */
+        void ReadLine(std::string&       dataString,
+                      const std::string& lineTerminator,
+                      size_t             msTimeout = 0) ;
+
         /**
          * @brief Writes a DataBuffer to the serial port.
          * @param dataBuffer The DataBuffer to write to the serial port.
@@ -397,6 +611,60 @@ namespace LibSerial
          */
         void Write(const std::string& dataString) ;
 
+        /**
+         * @brief Writes a PooledDataBuffer to the serial port.
+         * @param dataBuffer The PooledDataBuffer to write to the serial port.
+         */
+        void Write(const PooledDataBuffer& dataBuffer) ;
+
+        /**
+         * @brief Writes the specified number of bytes from caller owned
+         *        memory to the serial port.
+         * @param dataBuffer Pointer to the data to write to the serial port.
+         * @param numberOfBytes The number of bytes to write.
+         */
+        void Write(const uint8_t* dataBuffer,
+                   size_t         numberOfBytes) ;
+
+        /**
+         * @brief Writes the contents of several buffers to the serial port,
+         *        in order, using gather writes so that the buffers need not
+         *        first be copied into a single contiguous buffer.
+         * @param buffers Pointer to the first of the buffers to write.
+         * @param numberOfBuffers The number of buffers to write.
+         */
+        void WriteV(const ConstBuffer* buffers,
+                    size_t             numberOfBuffers) ;
+
+        /**
+         * @brief Writes the contents of several buffers to the serial port,
+         *        in order, using gather writes so that the buffers need not
+         *        first be copied into a single contiguous buffer.
+         * @param buffers The buffers to write, (e.g. {header, payload, crc}).
+         */
+        void WriteV(std::initializer_list<ConstBuffer> buffers) ;
+
+        /**
+         * @brief Writes the contents of a DataBuffer followed by its
+         *        checksum, see ComputeChecksum(). The checksum is sent with
+         *        the data in a single gather write, without copying the data.
+         * @param dataBuffer The data to write to the serial port.
+         * @param checksumType The checksum to append.
+         */
+        void WriteWithChecksum(const DataBuffer&  dataBuffer,
+                               const ChecksumType checksumType) ;
+
+        /**
+         * @brief Writes the specified number of bytes from caller owned
+         *        memory followed by their checksum, see ComputeChecksum().
+         * @param dataBuffer Pointer to the data to write to the serial port.
+         * @param numberOfBytes The number of bytes to write.
+         * @param checksumType The checksum to append.
+         */
+        void WriteWithChecksum(const uint8_t*     dataBuffer,
+                               size_t             numberOfBytes,
+                               const ChecksumType checksumType) ;
+
         /**
          * @brief Writes a single byte to the serial port.
          * @param charbuffer The byte to write to the serial port.
@@ -441,6 +709,160 @@ namespace LibSerial
          */
         bool GetModemControlLine(int modemLine) ;
 
+        /**
+         * @brief Gets the number of transitions of each modem input line
+         *        counted by the driver with TIOCGICOUNT. Drivers that do not
+         *        count transitions, such as pseudo terminals, cause a
+         *        std::runtime_error to be thrown.
+         * @return Returns the current modem line counters.
+         */
+        ModemLineCounters GetModemLineCounters() ;
+
+        /**
+         * @brief Blocks with TIOCMIWAIT until one of the specified modem
+         *        input lines changes state, without polling. If msTimeout is
+         *        zero, this method waits indefinitely. A wait with a timeout
+         *        is cut short by a timer thread shared by all ports, which
+         *        sends the calling thread the real-time signal SIGRTMIN + 1.
+         *        A handler that does nothing is installed for that signal
+         *        unless the application has installed its own, and the
+         *        signal is unblocked in the calling thread for the duration
+         *        of the wait. If the application ignores the signal or
+         *        handles it with SA_RESTART, a std::runtime_error is thrown.
+         * @param modemLineMask A combination of TIOCM_CTS, TIOCM_DSR,
+         *        TIOCM_CD and TIOCM_RI.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the lines of modemLineMask that changed state.
+         */
+        int WaitForModemLineChange(int    modemLineMask,
+                                   size_t msTimeout = 0) ;
+
+        /**
+         * @brief Blocks until one of the specified modem input lines changes
+         *        state, as WaitForModemLineChange(int, size_t), but returns
+         *        immediately if a line has already changed since the
+         *        supplied counters were read. Passing the same counters to
+         *        successive calls therefore never misses a transition that
+         *        occurred between two waits.
+         * @param modemLineMask A combination of TIOCM_CTS, TIOCM_DSR,
+         *        TIOCM_CD and TIOCM_RI.
+         * @param modemLineCounters The counters returned by
+         *        GetModemLineCounters() or by the previous wait, updated
+         *        when a change is reported.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the lines of modemLineMask that changed state.
+         */
+        int WaitForModemLineChange(int                modemLineMask,
+                                   ModemLineCounters& modemLineCounters,
+                                   size_t             msTimeout = 0) ;
+
+        /**
+         * @brief Starts a background thread that keeps the driver's receive
+         *        buffer drained into a lock-free single-producer/single-consumer
+         *        ring buffer. Received data is then obtained without any
+         *        system call using ReadFromRingBuffer(). While the background
+         *        reader is running, the other Read...() methods must not be
+         *        used and ReadFromRingBuffer() must only be called from one
+         *        thread at a time.
+         * @param ringBufferSize The size of the ring buffer in bytes, which
+         *        must be a non-zero power of two.
+         */
+        void StartBackgroundReader(size_t ringBufferSize = RING_BUFFER_SIZE_DEFAULT) ;
+
+        /**
+         * @brief Stops the background reader thread, if running. Data already
+         *        in the ring buffer remains available to ReadFromRingBuffer()
+         *        until the serial port is closed or the background reader is
+         *        started again.
+         */
+        void StopBackgroundReader() ;
+
+        /**
+         * @brief Determines if the background reader thread has been started
+         *        and not yet stopped, either by StopBackgroundReader() or
+         *        because reading from the serial port failed.
+         * @return Returns true iff the background reader is running.
+         */
+        bool IsBackgroundReaderRunning() const ;
+
+        /**
+         * @brief Moves data received by the background reader from the ring
+         *        buffer into caller owned memory. This method never blocks.
+         *        If the background reader has stopped because of an error,
+         *        a std::runtime_error is thrown once the ring buffer is empty.
+         * @param dataBuffer Pointer to the memory to place data into.
+         * @param bufferSize The number of bytes available at dataBuffer.
+         * @return Returns the number of bytes placed into dataBuffer, which
+         *         is zero if the ring buffer is empty.
+         */
+        size_t ReadFromRingBuffer(uint8_t* dataBuffer,
+                                  size_t   bufferSize) ;
+
+        /**
+         * @brief Gets the number of bytes waiting in the ring buffer.
+         * @return Returns the number of bytes waiting in the ring buffer.
+         */
+        size_t GetRingBufferLevel() const ;
+
+        /**
+         * @brief Gets the number of received bytes that were discarded by the
+         *        background reader because the ring buffer was full.
+         * @return Returns the number of bytes discarded.
+         */
+        size_t GetRingBufferOverrunCount() const ;
+
+        /**
+         * @brief Gets the largest number of bytes held in the ring buffer at
+         *        any one time since the background reader was started.
+         * @return Returns the ring buffer high-water mark in bytes.
+         */
+        size_t GetRingBufferHighWaterMark() const ;
+
+        /**
+         * @brief Gets the I/O statistics gathered since the serial port was
+         *        constructed or ResetStatistics() was last called. Statistics
+         *        are only gathered when the library is built with
+         *        LIBSERIAL_ENABLE_STATISTICS, otherwise all values are zero.
+         * @return Returns a snapshot of the statistics.
+         */
+        SerialPortStatistics GetStatistics() const ;
+
+        /**
+         * @brief Clears the I/O statistics of the serial port.
+         */
+        void ResetStatistics() ;
+
+        /**
+         * @brief Enables or disables concurrent mode, in which the serial
+         *        port may be used from several threads at once. Reads,
+         *        writes and changes to the serial port settings are each
+         *        serialized by their own mutex, so one thread can read while
+         *        another writes, at full speed in both directions. Open(),
+         *        Close() and the background reader methods take all three
+         *        locks, so Close() waits for reads and writes in progress.
+         *        Reads waiting for data are woken by Close() first and throw
+         *        NotOpen, so one thread may close the serial port to stop
+         *        another that is blocked in a read without a timeout.
+         *
+         *        The modem control line methods need no lock, as the kernel
+         *        applies each TIOCMBIS, TIOCMBIC and TIOCMGET atomically.
+         *        IsOpen() and GetFileDescriptor() are unsynchronized, so
+         *        Close() must not race with them.
+         *
+         *        Concurrent mode is disabled by default, in which case the
+         *        serial port must be used from one thread at a time. It
+         *        must not be changed while another thread uses the serial
+         *        port.
+         * @param concurrentMode True to enable concurrent mode.
+         */
+        void SetConcurrentMode(const bool concurrentMode) ;
+
+        /**
+         * @brief Determines whether concurrent mode is enabled.
+         * @return Returns true if concurrent mode is enabled.
+         */
+        bool IsConcurrentMode() const ;
+
     protected:
 
     private:
@@ -33,6 +33,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <limits>
 #include <stdexcept>
 #include <string>
@@ -53,6 +54,30 @@ namespace LibSerial
     const std::string ERR_MSG_PORT_ALREADY_OPEN      = "Serial port already open.";
     const std::string ERR_MSG_PORT_NOT_OPEN          = "Serial port not open.";
     const std::string ERR_MSG_INVALID_MODEM_LINE     = "Invalid modem line." ;
+    const std::string ERR_MSG_INVALID_PORT_ID        = "Invalid port id." ;
+    const std::string ERR_MSG_INVALID_TERMINATOR     = "Invalid line terminator." ;
+    const std::string ERR_MSG_INVALID_RING_SIZE      = "Ring buffer size must be a non-zero power of two." ;
+    const std::string ERR_MSG_READER_RUNNING         = "Background reader already running." ;
+    const std::string ERR_MSG_MONITOR_NOT_STARTED    = "Hotplug monitoring not started." ;
+    const std::string ERR_MSG_PORT_HUNG_UP           = "Serial port hung up." ;
+    const std::string ERR_MSG_FRAME_TOO_LARGE        = "Frame payload too large." ;
+    const std::string ERR_MSG_INVALID_LENGTH_FIELD   = "Length field size must be 1, 2 or 4 bytes." ;
+    const std::string ERR_MSG_INVALID_BUFFER_SIZE    = "Buffer size must be non-zero." ;
+    const std::string ERR_MSG_NO_FRAME_CODEC         = "A frame codec is required." ;
+    const std::string ERR_MSG_INVALID_LATENCY_PROFILE = "Invalid latency profile." ;
+    const std::string ERR_MSG_INVALID_BIT_RATE       = "Bit rate must be non-zero." ;
+    const std::string ERR_MSG_INVALID_CAPTURE_FILE   = "Invalid capture file." ;
+    const std::string ERR_MSG_INVALID_REPLAY_SPEED   = "Replay speed must be zero or positive." ;
+    const std::string ERR_MSG_IO_URING_UNAVAILABLE   = "io_uring support is not available." ;
+    const std::string ERR_MSG_INVALID_BUFFER_COUNT   = "Number of buffers must be a power of two no larger than 32768." ;
+    const std::string ERR_MSG_INVALID_WINDOW_SIZE    = "Window size must be non-zero." ;
+    const std::string ERR_MSG_INVALID_TIMER_WHEEL    = "Timer resolution and number of timer slots must be non-zero." ;
+    const std::string ERR_MSG_DUPLICATE_KEY          = "A transaction with this key is already outstanding." ;
+    const std::string ERR_MSG_INVALID_CHECKSUM_TYPE  = "Invalid checksum type." ;
+    const std::string ERR_MSG_PORT_DISCONNECTED      = "Serial port disconnected." ;
+    const std::string ERR_MSG_DEVICE_NOT_FOUND       = "No serial port with the requested serial number." ;
+    const std::string ERR_MSG_INVALID_VMIN           = "VMIN must be positive." ;
+    const std::string ERR_MSG_MODEM_LINE_WAKE_SIGNAL = "SIGRTMIN + 1 is ignored or restarts system calls." ;
 
     /**
      * @brief Time conversion constants.
@@ -76,6 +101,29 @@ namespace LibSerial
      */
     constexpr short VTIME_DEFAULT = 0 ;
 
+    /**
+     * @brief The VMIN value used by LatencyProfile::LATENCY_PROFILE_THROUGHPUT.
+     */
+    constexpr short VMIN_THROUGHPUT = 255 ;
+
+    /**
+     * @brief The VTIME value in deciseconds used by
+     *        LatencyProfile::LATENCY_PROFILE_THROUGHPUT.
+     */
+    constexpr short VTIME_THROUGHPUT = 1 ;
+
+    /**
+     * @brief The USB serial adapter latency timer in milliseconds requested
+     *        in low latency mode.
+     */
+    constexpr int LATENCY_TIMER_LOW_LATENCY = 1 ;
+
+    /**
+     * @brief The default size in bytes of the ring buffer filled by the
+     *        SerialPort background reader.
+     */
+    constexpr size_t RING_BUFFER_SIZE_DEFAULT = 65536 ;
+
     /**
      * @brief Character used to signal that I/O can start while using
      *        software flow control with the serial port.
@@ -93,6 +141,63 @@ namespace LibSerial
      */
     using DataBuffer =  std::vector<uint8_t> ;
 
+    /**
+     * @brief A read-only view of caller owned memory, used to describe
+     *        each of the buffers of a vectored (gather) write.
+     */
+    struct ConstBuffer
+    {
+        /**
+         * @brief Pointer to the first byte of the buffer.
+         */
+        const uint8_t* data ;
+
+        /**
+         * @brief The number of bytes in the buffer.
+         */
+        size_t size ;
+    } ;
+
+    /**
+     * @brief Data received by SerialPort::ReadTimestamped(), stored as a
+     *        structure of arrays: the bytes, and for each chunk of bytes
+     *        returned by one read() call, the offset of its first byte and
+     *        the time at which it was found to have arrived. The bytes of
+     *        chunk i are data[chunkOffsets[i]] up to the start of chunk i + 1,
+     *        or the end of data for the last chunk.
+     */
+    struct TimestampedDataBuffer
+    {
+        /**
+         * @brief The bytes received.
+         */
+        DataBuffer data {} ;
+
+        /**
+         * @brief The offset into data of the first byte of each chunk.
+         */
+        std::vector<size_t> chunkOffsets {} ;
+
+        /**
+         * @brief The arrival time of each chunk.
+         */
+        std::vector<std::chrono::steady_clock::time_point> chunkTimestamps {} ;
+    } ;
+
+    /**
+     * @brief The number of transitions of each modem input line counted by
+     *        the serial port driver since the port was opened, as reported
+     *        by TIOCGICOUNT. Comparing two snapshots reveals transitions
+     *        that occurred while nobody was waiting for them.
+     */
+    struct ModemLineCounters
+    {
+        int cts = 0 ; // !< Transitions of the CTS line.
+        int dsr = 0 ; // !< Transitions of the DSR line.
+        int ri  = 0 ; // !< Trailing edges of the RI line.
+        int dcd = 0 ; // !< Transitions of the DCD line.
+    } ;
+
 
     /**
      * @note - For reference, below is a list of std::exception types:
@@ -277,4 +382,44 @@ namespace LibSerial
         STOP_BITS_INVALID = std::numeric_limits<tcflag_t>::max()
     } ;
 
+    /**
+     * @brief Preset trade-offs between latency and throughput, applied with
+     *        SerialPort::SetLatencyProfile().
+     */
+    enum class LatencyProfile
+    {
+        LATENCY_PROFILE_LATENCY,    // !< Deliver every byte as soon as it arrives.
+        LATENCY_PROFILE_THROUGHPUT, // !< Batch received bytes to reduce wakeups.
+    } ;
+
+    /**
+     * @brief A complete set of serial port parameters, which can be applied
+     *        at once with SerialPort::SetSerialPortParameters().
+     */
+    struct PortSettings
+    {
+        BaudRate      baudRate      = BaudRate::BAUD_DEFAULT ;               // !< The baud rate.
+        CharacterSize characterSize = CharacterSize::CHAR_SIZE_DEFAULT ;     // !< The character size.
+        FlowControl   flowControl   = FlowControl::FLOW_CONTROL_DEFAULT ;    // !< The flow control type.
+        Parity        parity        = Parity::PARITY_DEFAULT ;               // !< The parity type.
+        StopBits      stopBits      = StopBits::STOP_BITS_DEFAULT ;          // !< The number of stop bits.
+        short         vmin          = VMIN_DEFAULT ;                         // !< VMIN, see man termios(3).
+        short         vtime         = VTIME_DEFAULT ;                        // !< VTIME in deciseconds.
+    } ;
+
+    /**
+     * @brief The RS-485 settings of a serial port, applied by the driver with
+     *        TIOCSRS485 so that the transmitter is switched on and off by the
+     *        hardware or the driver rather than by toggling RTS from user
+     *        space. See SerialPort::SetRS485Settings().
+     */
+    struct RS485Settings
+    {
+        bool         enabled               = false ; // !< True to enable RS-485 mode.
+        bool         rtsOnSend             = true ;  // !< RTS level while sending, the opposite level is used otherwise.
+        bool         receiveDuringTransmit = false ; // !< True to keep the receiver enabled while sending.
+        unsigned int delayRtsBeforeSend    = 0 ;     // !< The delay in milliseconds between asserting RTS and sending.
+        unsigned int delayRtsAfterSend     = 0 ;     // !< The delay in milliseconds between sending and releasing RTS.
+    } ;
+
 } // namespace LibSerial
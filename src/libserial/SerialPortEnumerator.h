@@ -0,0 +1,209 @@
+/******************************************************************************
+ * @file SerialPortEnumerator.h                                               *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace LibSerial
+{
+    /**
+     * @brief The sysfs directory listing every tty device known to the kernel.
+     */
+    const std::string SYSFS_TTY_CLASS_DIRECTORY = "/sys/class/tty" ;
+
+    /**
+     * @brief The directory holding the device nodes of the serial ports.
+     */
+    const std::string DEVICE_DIRECTORY = "/dev/" ;
+
+    /**
+     * @brief Description of a serial port as reported by sysfs. Fields that
+     *        are not known for a given port, (e.g. the USB identifiers of an
+     *        on-board UART), are left empty.
+     */
+    struct SerialPortInfo
+    {
+        std::string deviceName ;   // !< The kernel device name, (e.g. "ttyUSB0").
+        std::string devicePath ;   // !< The device node, (e.g. "/dev/ttyUSB0").
+        std::string driver ;       // !< The name of the bound driver, (e.g. "ftdi_sio").
+        std::string vendorId ;     // !< The USB vendor id as four hex digits.
+        std::string productId ;    // !< The USB product id as four hex digits.
+        std::string manufacturer ; // !< The USB manufacturer string.
+        std::string product ;      // !< The USB product string.
+        std::string serialNumber ; // !< The USB serial number string.
+    } ;
+
+    /**
+     * @brief The kinds of hotplug events reported by SerialPortEnumerator.
+     */
+    enum class SerialPortEventType
+    {
+        PORT_ADDED,   // !< A serial port has appeared.
+        PORT_REMOVED  // !< A serial port has disappeared.
+    } ;
+
+    /**
+     * @brief A hotplug event reported by SerialPortEnumerator::ReadEvent().
+     *        Only the deviceName and devicePath of the port information are
+     *        filled in for PORT_REMOVED events since sysfs no longer
+     *        describes the port at that point, so removal of any tty
+     *        device is reported.
+     */
+    struct SerialPortEvent
+    {
+        SerialPortEventType eventType ; // !< The kind of event.
+        SerialPortInfo      portInfo ;  // !< The port the event refers to.
+    } ;
+
+    /**
+     * @brief SerialPortEnumerator lists the serial ports present on the
+     *        system by reading sysfs, without opening any device node, and
+     *        optionally monitors the kernel uevent netlink socket, (the same
+     *        source of events udev uses), to report ports as they are
+     *        plugged in or removed.
+     *
+     *        The monitor file descriptor may be added to an existing poll(),
+     *        select() or epoll loop; ReadEvent() should then be called each
+     *        time it becomes readable.
+     */
+    class SerialPortEnumerator
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param sysfsTtyDirectory The sysfs tty class directory to read,
+         *        which only needs to be changed for testing purposes.
+         * @param deviceDirectory The directory the device paths reported
+         *        for the ports are in, which likewise only needs to be
+         *        changed for testing purposes.
+         */
+        explicit SerialPortEnumerator(const std::string& sysfsTtyDirectory = SYSFS_TTY_CLASS_DIRECTORY,
+                                      const std::string& deviceDirectory = DEVICE_DIRECTORY) ;
+
+        /**
+         * @brief Default Destructor. Stops monitoring if it is active.
+         */
+        virtual ~SerialPortEnumerator() noexcept ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        SerialPortEnumerator(const SerialPortEnumerator& otherSerialPortEnumerator) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        SerialPortEnumerator(SerialPortEnumerator&& otherSerialPortEnumerator) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        SerialPortEnumerator& operator=(const SerialPortEnumerator& otherSerialPortEnumerator) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        SerialPortEnumerator& operator=(SerialPortEnumerator&& otherSerialPortEnumerator) = delete ;
+
+        /**
+         * @brief Gets the serial ports currently present on the system.
+         *        Virtual terminals and other tty devices that are not backed
+         *        by hardware are skipped, as are legacy UART ports that the
+         *        kernel reports as having no hardware attached.
+         * @return Returns the serial ports sorted by device name.
+         */
+        std::vector<SerialPortInfo> GetSerialPorts() const ;
+
+        /**
+         * @brief Gets information about a single tty device from sysfs.
+         * @param deviceName The kernel device name, (e.g. "ttyUSB0").
+         * @return Returns the port information. Only the deviceName and
+         *         devicePath are filled in if sysfs does not describe the
+         *         device.
+         */
+        SerialPortInfo GetSerialPortInfo(const std::string& deviceName) const ;
+
+        /**
+         * @brief Starts listening for serial port hotplug events.
+         */
+        void StartMonitoring() ;
+
+        /**
+         * @brief Stops listening for serial port hotplug events.
+         */
+        void StopMonitoring() ;
+
+        /**
+         * @brief Determines whether hotplug events are being monitored.
+         * @return Returns true if StartMonitoring() has been called and
+         *         StopMonitoring() has not.
+         */
+        bool IsMonitoring() const ;
+
+        /**
+         * @brief Gets the file descriptor that becomes readable when a
+         *        hotplug event may be pending.
+         * @return Returns the monitor file descriptor, or -1 if hotplug
+         *         events are not being monitored.
+         */
+        int GetMonitorFileDescriptor() const ;
+
+        /**
+         * @brief Waits for the next serial port hotplug event. Uevents for
+         *        other subsystems are discarded while waiting.
+         * @param msTimeout The timeout period in milliseconds. If zero, this
+         *        method blocks until an event is received.
+         * @return Returns the hotplug event.
+         */
+        SerialPortEvent ReadEvent(size_t msTimeout = 0) ;
+
+    protected:
+
+    private:
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class SerialPortEnumerator
+
+} // namespace LibSerial
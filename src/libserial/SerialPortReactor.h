@@ -0,0 +1,305 @@
+/******************************************************************************
+ * @file SerialPortReactor.h                                                  *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPort.h>
+#include <libserial/SerialStream.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace LibSerial
+{
+    /**
+     * @brief SerialPortReactor multiplexes many SerialPort and SerialStream
+     *        instances onto one or a few threads using epoll. The reactor
+     *        takes ownership of each port added to it and invokes user
+     *        supplied callbacks when data is ready to be read, when the
+     *        port is ready to accept more data, or when the state of one of
+     *        the modem input lines (CTS, DSR, DCD, RI) changes.
+     *
+     *        Run() may be called from several threads at once. Events for a
+     *        given port are never dispatched to more than one thread at a
+     *        time, so the callbacks of a single port need no locking of
+     *        their own. Callbacks are level-triggered: a data-ready callback
+     *        that does not consume all available data will be invoked again.
+     *        Only data still held by the driver is reported, so data-ready
+     *        callbacks of a SerialPort read with ReadLine() should consume
+     *        everything while IsDataAvailable() returns true, and those of a
+     *        SerialStream using a read buffer while rdbuf()->in_avail() is
+     *        non-zero.
+     *
+     *        One-shot timers started with StartTimer() are dispatched by the
+     *        same threads, which allows timeouts to be implemented without
+     *        a thread of their own.
+     */
+    class SerialPortReactor
+    {
+    public:
+
+        /**
+         * @brief Handle used to identify a port owned by the reactor.
+         */
+        using PortId = uint64_t ;
+
+        /**
+         * @brief Handle used to identify a timer started with StartTimer().
+         */
+        using TimerId = uint64_t ;
+
+        /**
+         * @brief The set of callbacks invoked for a port owned by the
+         *        reactor. Any of the callbacks may be left empty.
+         */
+        template <typename PortType>
+        struct Callbacks
+        {
+            /**
+             * @brief Invoked when data is available to be read from the port.
+             */
+            std::function<void(PortId portId, PortType& port)> dataReady {} ;
+
+            /**
+             * @brief Invoked when the port can accept more data. Only
+             *        dispatched after SetWritableInterest() has been enabled
+             *        for the port, and, if SetWritableThreshold() has been
+             *        called, only once the transmit queue has drained to the
+             *        threshold.
+             */
+            std::function<void(PortId portId, PortType& port)> writable {} ;
+
+            /**
+             * @brief Invoked when one of the modem input lines changes state.
+             *        The modemLineState argument holds the current TIOCM_CTS,
+             *        TIOCM_DSR, TIOCM_CD and TIOCM_RI bits. If the driver
+             *        supports TIOCMIWAIT, a thread waits for changes on behalf
+             *        of the port and the driver's transition counters are
+             *        checked, so the callback is invoked promptly and even for
+             *        a pulse that has already ended. The lines of other ports,
+             *        such as pseudo terminals, are sampled periodically.
+             */
+            std::function<void(PortId portId, PortType& port, int modemLineState)> modemLineChange {} ;
+
+            /**
+             * @brief Invoked when the device hangs up or an error condition
+             *        is reported on the port. No further events are
+             *        dispatched for the port until it is removed.
+             */
+            std::function<void(PortId portId, PortType& port)> hangUp {} ;
+        } ;
+
+        /**
+         * @brief Default Constructor.
+         */
+        explicit SerialPortReactor() ;
+
+        /**
+         * @brief Default Destructor. Closes all ports owned by the reactor.
+         */
+        virtual ~SerialPortReactor() noexcept ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        SerialPortReactor(const SerialPortReactor& otherSerialPortReactor) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        SerialPortReactor(SerialPortReactor&& otherSerialPortReactor) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        SerialPortReactor& operator=(const SerialPortReactor& otherSerialPortReactor) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        SerialPortReactor& operator=(SerialPortReactor&& otherSerialPortReactor) = delete ;
+
+        /**
+         * @brief Transfers ownership of an open SerialPort to the reactor.
+         * @param serialPort The serial port to be managed by the reactor.
+         * @param callbacks The callbacks to invoke for the serial port.
+         * @return Returns the handle identifying the serial port.
+         */
+        PortId Add(std::unique_ptr<SerialPort>   serialPort,
+                   const Callbacks<SerialPort>& callbacks) ;
+
+        /**
+         * @brief Transfers ownership of an open SerialStream to the reactor.
+         * @param serialStream The serial stream to be managed by the reactor.
+         * @param callbacks The callbacks to invoke for the serial stream.
+         * @return Returns the handle identifying the serial stream.
+         */
+        PortId Add(std::unique_ptr<SerialStream>   serialStream,
+                   const Callbacks<SerialStream>& callbacks) ;
+
+        /**
+         * @brief Removes a port from the reactor and closes it. If a callback
+         *        for the port is running on another thread, the port is
+         *        closed once that callback returns.
+         * @param portId The handle of the port to be removed.
+         */
+        void Remove(PortId portId) ;
+
+        /**
+         * @brief Gets a SerialPort owned by the reactor.
+         * @param portId The handle returned when the serial port was added.
+         * @return Returns a reference to the serial port.
+         */
+        SerialPort& GetSerialPort(PortId portId) ;
+
+        /**
+         * @brief Gets a SerialStream owned by the reactor.
+         * @param portId The handle returned when the serial stream was added.
+         * @return Returns a reference to the serial stream.
+         */
+        SerialStream& GetSerialStream(PortId portId) ;
+
+        /**
+         * @brief Gets the number of ports owned by the reactor.
+         * @return Returns the number of ports owned by the reactor.
+         */
+        size_t GetNumberOfPorts() const ;
+
+        /**
+         * @brief Enables or disables dispatching of the writable callback
+         *        for the specified port. Writable interest is disabled when
+         *        a port is added.
+         * @param portId The handle of the port.
+         * @param writableInterest True to dispatch writable callbacks.
+         */
+        void SetWritableInterest(PortId portId,
+                                 bool   writableInterest) ;
+
+        /**
+         * @brief Holds back the writable callback of the specified port
+         *        until no more than the specified number of bytes are queued
+         *        by the driver for transmission, as reported by TIOCOUTQ.
+         *        This bounds the time data written from the callback waits
+         *        behind earlier data. While the queue is deeper, the reactor
+         *        checks it again after the time needed to transmit the
+         *        excess at the port's bit rate, rather than each time the
+         *        driver has room. The default, the largest size_t value,
+         *        dispatches the callback whenever the driver accepts data.
+         * @param portId The handle of the port.
+         * @param writableThreshold The largest transmit queue depth in bytes
+         *        at which the writable callback is dispatched.
+         */
+        void SetWritableThreshold(PortId portId,
+                                  size_t writableThreshold) ;
+
+        /**
+         * @brief Enables or disables dispatching of the data-ready callback
+         *        for the specified port. Readable interest is enabled when a
+         *        port is added. Data that arrives while it is disabled is left
+         *        in the driver and reported once it is enabled again.
+         * @param portId The handle of the port.
+         * @param readableInterest True to dispatch data-ready callbacks.
+         */
+        void SetReadableInterest(PortId portId,
+                                 bool   readableInterest) ;
+
+        /**
+         * @brief Starts a one-shot timer. The callback is invoked by one of
+         *        the threads running the reactor once the delay has elapsed.
+         * @param msDelay The delay in milliseconds.
+         * @param callback The callback to invoke when the timer expires.
+         * @return Returns the handle identifying the timer.
+         */
+        TimerId StartTimer(size_t                       msDelay,
+                           const std::function<void()>& callback) ;
+
+        /**
+         * @brief Cancels a timer started with StartTimer().
+         * @param timerId The handle of the timer.
+         * @return Returns true if the timer was cancelled before its callback
+         *         was invoked.
+         */
+        bool CancelTimer(TimerId timerId) ;
+
+        /**
+         * @brief Sets the interval at which the modem input lines of ports
+         *        with a modemLineChange callback are sampled, for ports whose
+         *        driver does not support TIOCMIWAIT. The lines of the other
+         *        ports are watched by a thread blocked in TIOCMIWAIT, which
+         *        is stopped with the signal SIGRTMIN + 1, see
+         *        SerialPort::WaitForModemLineChange(). If the application
+         *        ignores that signal or handles it with SA_RESTART, all
+         *        ports are sampled instead.
+         * @param msInterval The sampling interval in milliseconds.
+         */
+        void SetModemLinePollInterval(size_t msInterval) ;
+
+        /**
+         * @brief Dispatches events until Stop() is called. This method may
+         *        be called from several threads to share the event load.
+         */
+        void Run() ;
+
+        /**
+         * @brief Waits for and dispatches a single round of events. If
+         *        msTimeout is zero, this method blocks until at least one
+         *        event has been dispatched or Stop() is called.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of callbacks that were invoked.
+         */
+        size_t RunOnce(size_t msTimeout = 0) ;
+
+        /**
+         * @brief Causes all threads in Run() to return. Run() may be called
+         *        again once every thread has returned from it.
+         */
+        void Stop() ;
+
+    protected:
+
+    private:
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class SerialPortReactor
+
+} // namespace LibSerial
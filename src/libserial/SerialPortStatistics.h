@@ -0,0 +1,329 @@
+/******************************************************************************
+ * @file SerialPortStatistics.h                                               *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <sys/types.h>
+#include <type_traits>
+#include <vector>
+
+namespace LibSerial
+{
+    /**
+     * @brief Values below this are counted exactly by a LatencyHistogram;
+     *        above it, each power of two range is split into this many
+     *        buckets, which bounds the relative error to 1/16.
+     */
+    constexpr size_t LATENCY_HISTOGRAM_SUB_BUCKETS = 16 ;
+
+    /**
+     * @brief The log2 of LATENCY_HISTOGRAM_SUB_BUCKETS.
+     */
+    constexpr size_t LATENCY_HISTOGRAM_SUB_BUCKET_BITS = 4 ;
+
+    /**
+     * @brief Latencies of 2^40 nanoseconds, (about 18 minutes), or more are
+     *        counted in the last bucket.
+     */
+    constexpr size_t LATENCY_HISTOGRAM_MAXIMUM_MAGNITUDE = 40 ;
+
+    /**
+     * @brief The number of buckets of a LatencyHistogram.
+     */
+    constexpr size_t LATENCY_HISTOGRAM_BUCKETS = LATENCY_HISTOGRAM_SUB_BUCKETS *
+                                                 (LATENCY_HISTOGRAM_MAXIMUM_MAGNITUDE - LATENCY_HISTOGRAM_SUB_BUCKET_BITS + 2) ;
+
+    /**
+     * @brief A point in time copy of a LatencyHistogram.
+     */
+    struct LatencyHistogramSnapshot
+    {
+        /**
+         * @brief The number of recorded values in each bucket.
+         */
+        std::vector<uint64_t> bucketCounts {} ;
+
+        /**
+         * @brief The number of recorded values.
+         */
+        uint64_t count = 0 ;
+
+        /**
+         * @brief The sum of the recorded values, in nanoseconds.
+         */
+        uint64_t total = 0 ;
+
+        /**
+         * @brief The largest recorded value, in nanoseconds.
+         */
+        uint64_t maximum = 0 ;
+
+        /**
+         * @brief Gets the mean of the recorded values.
+         * @return Returns the mean in nanoseconds, or zero if no values
+         *         were recorded.
+         */
+        double GetMean() const ;
+
+        /**
+         * @brief Gets the value at or below which the specified percentage
+         *        of the recorded values fall.
+         * @param percentile The percentile, from 0.0 to 100.0.
+         * @return Returns the upper bound of the bucket holding the
+         *         percentile in nanoseconds, or zero if no values were
+         *         recorded.
+         */
+        uint64_t GetValueAtPercentile(double percentile) const ;
+
+        /**
+         * @brief Gets the largest value counted in the specified bucket.
+         * @param bucketIndex The index of the bucket.
+         * @return Returns the largest value of the bucket in nanoseconds.
+         */
+        static uint64_t GetBucketUpperBound(size_t bucketIndex) ;
+
+        /**
+         * @brief Adds the values recorded in another snapshot to this one.
+         * @param otherSnapshot The snapshot to add.
+         */
+        void Merge(const LatencyHistogramSnapshot& otherSnapshot) ;
+    } ;
+
+    /**
+     * @brief LatencyHistogram records durations in nanoseconds into log
+     *        linear buckets, in the manner of an HDR histogram. Recording is
+     *        lock free and may be done from several threads at once.
+     */
+    class LatencyHistogram
+    {
+    public:
+        /**
+         * @brief Records a duration.
+         * @param nanoseconds The duration in nanoseconds.
+         */
+        void Record(uint64_t nanoseconds) noexcept ;
+
+        /**
+         * @brief Gets a copy of the histogram.
+         * @return Returns the snapshot.
+         */
+        LatencyHistogramSnapshot GetSnapshot() const ;
+
+        /**
+         * @brief Clears all recorded values.
+         */
+        void Reset() noexcept ;
+
+        /**
+         * @brief Gets the bucket counting the specified duration.
+         * @param nanoseconds The duration in nanoseconds.
+         * @return Returns the index of the bucket.
+         */
+        static size_t GetBucketIndex(uint64_t nanoseconds) noexcept ;
+
+    private:
+        /**
+         * @brief The number of recorded values in each bucket.
+         */
+        std::array<std::atomic<uint64_t>, LATENCY_HISTOGRAM_BUCKETS> mBucketCounts {} ;
+
+        /**
+         * @brief The sum of the recorded values.
+         */
+        std::atomic<uint64_t> mTotal {0} ;
+
+        /**
+         * @brief The largest recorded value.
+         */
+        std::atomic<uint64_t> mMaximum {0} ;
+    } ;
+
+    /**
+     * @brief A point in time copy of the I/O statistics of a serial port.
+     */
+    struct SerialPortStatistics
+    {
+        /**
+         * @brief True if the library was built with statistics enabled.
+         */
+        bool enabled = false ;
+
+        /**
+         * @brief The number of bytes returned by read() calls.
+         */
+        uint64_t bytesRead = 0 ;
+
+        /**
+         * @brief The number of bytes accepted by write() calls.
+         */
+        uint64_t bytesWritten = 0 ;
+
+        /**
+         * @brief The number of read() and readv() system calls.
+         */
+        uint64_t readCalls = 0 ;
+
+        /**
+         * @brief The number of write() and writev() system calls.
+         */
+        uint64_t writeCalls = 0 ;
+
+        /**
+         * @brief The number of system calls that failed with EWOULDBLOCK.
+         */
+        uint64_t wouldBlockResults = 0 ;
+
+        /**
+         * @brief The number of system calls retried after failing with EINTR.
+         */
+        uint64_t interruptedCalls = 0 ;
+
+        /**
+         * @brief The number of reads that ended with a ReadTimeout.
+         */
+        uint64_t readTimeouts = 0 ;
+
+        /**
+         * @brief Time spent blocked waiting for data to arrive, either in
+         *        poll() or in a blocking read().
+         */
+        LatencyHistogramSnapshot readWaitTime {} ;
+
+        /**
+         * @brief Time taken by each Write...() call to hand all its data to
+         *        the driver.
+         */
+        LatencyHistogramSnapshot writeCompletionTime {} ;
+
+        /**
+         * @brief Adds the values of other statistics to these.
+         * @param otherStatistics The statistics to add.
+         */
+        void Merge(const SerialPortStatistics& otherStatistics) ;
+    } ;
+
+    /**
+     * @brief IoStatistics holds the counters of one serial port. The
+     *        counters are updated with relaxed atomic operations, so that
+     *        recording costs a few nanoseconds next to each system call.
+     */
+    class IoStatistics
+    {
+    public:
+        /**
+         * @brief Records the result of a read() or readv() system call.
+         * @param result The value returned by the system call.
+         */
+        void RecordRead(ssize_t result) noexcept ;
+
+        /**
+         * @brief Records the result of a write() or writev() system call.
+         * @param result The value returned by the system call.
+         */
+        void RecordWrite(ssize_t result) noexcept ;
+
+        /**
+         * @brief Records the time spent blocked waiting for data to arrive.
+         * @param waitTime The time spent in poll() or a blocking read().
+         */
+        void RecordReadWait(std::chrono::steady_clock::duration waitTime) noexcept ;
+
+        /**
+         * @brief Records the time taken to complete a write.
+         * @param completionTime The time taken to write all of the data.
+         */
+        void RecordWriteCompletion(std::chrono::steady_clock::duration completionTime) noexcept ;
+
+        /**
+         * @brief Records a read that ended with a ReadTimeout.
+         */
+        void RecordReadTimeout() noexcept ;
+
+        /**
+         * @brief Calls a function, retrying while it fails with EINTR, in
+         *        the same way as call_with_retry(), and counts the retries.
+         * @param func The function to be called.
+         * @param args The arguments to be passed to the function.
+         * @return Returns the value returned by the last call.
+         */
+        template<typename Fn, typename... Args>
+        typename std::result_of<Fn(Args...)>::type
+        CallWithRetry(Fn func, Args... args)
+        {
+            auto result = func(std::forward<Args>(args)...) ;
+
+            while ((result == -1) and (errno == EINTR))
+            {
+                mInterruptedCalls.fetch_add(1, std::memory_order_relaxed) ;
+                result = func(std::forward<Args>(args)...) ;
+            }
+
+            return result ;
+        }
+
+        /**
+         * @brief Gets a copy of the statistics.
+         * @return Returns the snapshot.
+         */
+        SerialPortStatistics GetSnapshot() const ;
+
+        /**
+         * @brief Clears all counters and histograms.
+         */
+        void Reset() noexcept ;
+
+    private:
+        /**
+         * @brief The counters reported in SerialPortStatistics.
+         */
+        std::atomic<uint64_t> mBytesRead {0} ;
+        std::atomic<uint64_t> mBytesWritten {0} ;
+        std::atomic<uint64_t> mReadCalls {0} ;
+        std::atomic<uint64_t> mWriteCalls {0} ;
+        std::atomic<uint64_t> mWouldBlockResults {0} ;
+        std::atomic<uint64_t> mInterruptedCalls {0} ;
+        std::atomic<uint64_t> mReadTimeouts {0} ;
+
+        /**
+         * @brief The histograms reported in SerialPortStatistics.
+         */
+        LatencyHistogram mReadWaitTime {} ;
+        LatencyHistogram mWriteCompletionTime {} ;
+    } ;
+
+} // namespace LibSerial
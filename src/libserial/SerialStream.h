@@ -144,6 +144,19 @@ namespace LibSerial
         void Open(const std::string& fileName,
                   const std::ios_base::openmode& openMode = std::ios_base::in | std::ios_base::out) ;
 
+        /**
+         * @brief Opens the serial port associated with the specified file
+         *        name and configures it with the specified parameters in a
+         *        single call to tcsetattr(), see SerialPort::Open().
+         * @param fileName The file name of the serial port.
+         * @param portSettings The serial port parameters to be set.
+         * @param openMode The communication mode status when the serial
+         *        communication port is opened.
+         */
+        void Open(const std::string& fileName,
+                  const PortSettings& portSettings,
+                  const std::ios_base::openmode& openMode = std::ios_base::in | std::ios_base::out) ;
+
         /**
          * @brief Closes the serial port. All settings of the serial port will be
          *        lost and no more I/O can be performed on the serial port.
@@ -194,6 +207,25 @@ namespace LibSerial
          */
         BaudRate GetBaudRate() ;
 
+        /**
+         * @brief Sets the serial port to an arbitrary bit rate in bits per
+         *        second, such as 250000 for DMX or rates above 4 Mbaud,
+         *        through the termios2 interface. Once set, GetBaudRate()
+         *        returns BaudRate::BAUD_INVALID until SetBaudRate() selects
+         *        a standard rate again. The driver may round the rate to the
+         *        nearest one its hardware supports, see GetBitRate().
+         * @param bitRate The bit rate in bits per second.
+         */
+        void SetBitRate(const speed_t bitRate) ;
+
+        /**
+         * @brief Gets the bit rate in bits per second currently used by the
+         *        serial port, whether it was set with SetBitRate() or
+         *        SetBaudRate().
+         * @return Returns the bit rate in bits per second.
+         */
+        speed_t GetBitRate() ;
+
         /**
          * @brief Sets the character size for the serial port.
          * @param characterSize The character size to be set.
@@ -270,6 +302,58 @@ namespace LibSerial
          */
         short GetVTime() ;
 
+        /**
+         * @brief Enables or disables the low latency mode of the serial port
+         *        driver, see SerialPort::SetLowLatency().
+         * @param lowLatency True to enable low latency mode.
+         */
+        void SetLowLatency(const bool lowLatency) ;
+
+        /**
+         * @brief Determines whether the low latency mode of the serial port
+         *        driver is enabled.
+         * @return Returns true if ASYNC_LOW_LATENCY is set.
+         */
+        bool IsLowLatency() ;
+
+        /**
+         * @brief Applies a preset of VMIN, VTIME and driver buffering
+         *        settings, see SerialPort::SetLatencyProfile().
+         * @param latencyProfile The profile to be applied.
+         */
+        void SetLatencyProfile(const LatencyProfile& latencyProfile) ;
+
+        /**
+         * @brief Sets the size of the buffer used for data read from the
+         *        serial port. A size of zero selects unbuffered input,
+         *        which is the default.
+         * @param bufferSize The size of the read buffer in bytes.
+         */
+        void SetReadBufferSize(size_t bufferSize) ;
+
+        /**
+         * @brief Gets the size of the buffer used for data read from the
+         *        serial port.
+         * @return Returns the size of the read buffer in bytes.
+         */
+        size_t GetReadBufferSize() ;
+
+        /**
+         * @brief Sets the size of the buffer used for data written to the
+         *        serial port. A size of zero selects unbuffered output,
+         *        which is the default. Buffered data is written to the serial
+         *        port when the buffer is full or the stream is flushed.
+         * @param bufferSize The size of the write buffer in bytes.
+         */
+        void SetWriteBufferSize(size_t bufferSize) ;
+
+        /**
+         * @brief Gets the size of the buffer used for data written to the
+         *        serial port.
+         * @return Returns the size of the write buffer in bytes.
+         */
+        size_t GetWriteBufferSize() ;
+
         /**
          * @brief Sets the DTR line to the specified value.
          * @param dtrState The line voltage state to be set,
@@ -320,6 +404,18 @@ namespace LibSerial
          */
         int GetNumberOfBytesAvailable() ;
 
+        /**
+         * @brief Gets the I/O statistics of the serial stream, see
+         *        SerialStreamBuf::GetStatistics().
+         * @return Returns a snapshot of the statistics.
+         */
+        SerialPortStatistics GetStatistics() ;
+
+        /**
+         * @brief Clears the I/O statistics of the serial stream.
+         */
+        void ResetStatistics() ;
+
         /**
          * @brief Gets a list of available serial ports.
          * @return Returns a std::vector of std::strings with the name of
@@ -34,7 +34,9 @@
 #pragma once
 
 #include <libserial/SerialPortConstants.h>
+#include <libserial/SerialPortStatistics.h>
 
+#include <initializer_list>
 #include <memory>
 #include <streambuf>
 #include <vector>
@@ -52,8 +54,10 @@ namespace LibSerial
      *        associated with the serial port and the standard filebuf does not
      *        provide access to it.
      *
-     *        At present, this class uses unbuffered I/O and all calls
-     *        to setbuf() will be ignored.
+     *        By default, this class uses unbuffered I/O. A get area filled
+     *        by a single read() of all available data and a put area that
+     *        is written out on sync() or when full can be enabled with
+     *        SetReadBufferSize() and SetWriteBufferSize().
      */
     class SerialStreamBuf : public std::streambuf
     {
@@ -119,6 +123,19 @@ namespace LibSerial
         void Open(const std::string& fileName,
                   const std::ios_base::openmode& openMode = std::ios_base::in | std::ios_base::out) ;
 
+        /**
+         * @brief Opens the serial port associated with the specified file
+         *        name and configures it with the specified parameters in a
+         *        single call to tcsetattr(), see SerialPort::Open().
+         * @param fileName The file name of the serial port.
+         * @param portSettings The serial port parameters to be set.
+         * @param openMode The communication mode status when the serial
+         *        communication port is opened.
+         */
+        void Open(const std::string& fileName,
+                  const PortSettings& portSettings,
+                  const std::ios_base::openmode& openMode = std::ios_base::in | std::ios_base::out) ;
+
         /**
          * @brief Closes the serial port. All settings of the serial port will be
          *        lost and no more I/O can be performed on the serial port.
@@ -174,6 +191,25 @@ namespace LibSerial
          */
         BaudRate GetBaudRate() const ;
 
+        /**
+         * @brief Sets the serial port to an arbitrary bit rate in bits per
+         *        second, such as 250000 for DMX or rates above 4 Mbaud,
+         *        through the termios2 interface. Once set, GetBaudRate()
+         *        returns BaudRate::BAUD_INVALID until SetBaudRate() selects
+         *        a standard rate again. The driver may round the rate to the
+         *        nearest one its hardware supports, see GetBitRate().
+         * @param bitRate The bit rate in bits per second.
+         */
+        void SetBitRate(const speed_t bitRate) ;
+
+        /**
+         * @brief Gets the bit rate in bits per second currently used by the
+         *        serial port, whether it was set with SetBitRate() or
+         *        SetBaudRate().
+         * @return Returns the bit rate in bits per second.
+         */
+        speed_t GetBitRate() const ;
+
         /**
          * @brief Sets the character size for the serial port.
          * @param characterSize The character size to be set.
@@ -250,6 +286,79 @@ namespace LibSerial
          */
         short GetVTime() const ;
 
+        /**
+         * @brief Enables or disables the low latency mode of the serial port
+         *        driver, see SerialPort::SetLowLatency().
+         * @param lowLatency True to enable low latency mode.
+         */
+        void SetLowLatency(const bool lowLatency) ;
+
+        /**
+         * @brief Determines whether the low latency mode of the serial port
+         *        driver is enabled.
+         * @return Returns true if ASYNC_LOW_LATENCY is set.
+         */
+        bool IsLowLatency() const ;
+
+        /**
+         * @brief Applies a preset of VMIN, VTIME and driver buffering
+         *        settings, see SerialPort::SetLatencyProfile().
+         * @param latencyProfile The profile to be applied.
+         */
+        void SetLatencyProfile(const LatencyProfile& latencyProfile) ;
+
+        /**
+         * @brief Sets the size of the get area used to buffer data read
+         *        from the serial port. A size of zero selects unbuffered
+         *        input, which is the default. Any buffered data that has not
+         *        been consumed yet is preserved.
+         * @param bufferSize The size of the get area in bytes.
+         */
+        void SetReadBufferSize(size_t bufferSize) ;
+
+        /**
+         * @brief Gets the size of the get area used to buffer data read
+         *        from the serial port.
+         * @return Returns the size of the get area in bytes.
+         */
+        size_t GetReadBufferSize() const ;
+
+        /**
+         * @brief Sets the size of the put area used to buffer data written
+         *        to the serial port. A size of zero selects unbuffered
+         *        output, which is the default. Any data in the current put
+         *        area is written to the serial port first.
+         * @param bufferSize The size of the put area in bytes.
+         */
+        void SetWriteBufferSize(size_t bufferSize) ;
+
+        /**
+         * @brief Gets the size of the put area used to buffer data written
+         *        to the serial port.
+         * @return Returns the size of the put area in bytes.
+         */
+        size_t GetWriteBufferSize() const ;
+
+        /**
+         * @brief Writes the contents of several buffers to the serial port,
+         *        in order, using gather writes so that the buffers need not
+         *        first be copied into a single contiguous buffer. Any data
+         *        in the put area is written to the serial port first.
+         * @param buffers Pointer to the first of the buffers to write.
+         * @param numberOfBuffers The number of buffers to write.
+         */
+        void WriteV(const ConstBuffer* buffers,
+                    size_t             numberOfBuffers) ;
+
+        /**
+         * @brief Writes the contents of several buffers to the serial port,
+         *        in order, using gather writes so that the buffers need not
+         *        first be copied into a single contiguous buffer. Any data
+         *        in the put area is written to the serial port first.
+         * @param buffers The buffers to write, (e.g. {header, payload, crc}).
+         */
+        void WriteV(std::initializer_list<ConstBuffer> buffers) ;
+
         /**
          * @brief Sets the DTR line to the specified value.
          * @param dtrState The line voltage state to be set,
@@ -300,6 +409,20 @@ namespace LibSerial
          */
         int GetNumberOfBytesAvailable() ;
 
+        /**
+         * @brief Gets the I/O statistics gathered since the serial stream
+         *        buffer was constructed or ResetStatistics() was last called.
+         *        Statistics are only gathered when the library is built with
+         *        LIBSERIAL_ENABLE_STATISTICS, otherwise all values are zero.
+         * @return Returns a snapshot of the statistics.
+         */
+        SerialPortStatistics GetStatistics() const ;
+
+        /**
+         * @brief Clears the I/O statistics of the serial stream buffer.
+         */
+        void ResetStatistics() ;
+
 #ifdef __linux__
         /**
          * @brief Gets a list of available serial ports.
@@ -321,19 +444,26 @@ namespace LibSerial
          *        subclass's notion of getting memory for the buffered
          *        characters. 
          *
-         *        In the case of SerialStreamBuffer, we want to keep using
-         *        unbuffered I/O. Hence, using this method has no effect at
-         *        present.
+         *        In the case of SerialStreamBuffer, the get and put areas
+         *        are always allocated internally. The character pointer is
+         *        ignored and numberOfBytes is used as the size of both the
+         *        get and put areas, i.e. setbuf(nullptr, 0) selects
+         *        unbuffered I/O.
          *
-         *
-         * @param character Pointer to the character buffer to write to the serial port.
-         * @param numberOfBytes The number of characters to write to the serial port.
+         * @param character Ignored.
+         * @param numberOfBytes The size of the get and put areas in bytes.
          * @return Returns a pointer to this streambuf object.
          *
          */
         virtual std::streambuf* setbuf(char_type* character, 
                                        std::streamsize numberOfBytes) override ;
 
+        /**
+         * @brief Writes any data held in the put area to the serial port.
+         * @return Returns 0 if successful, otherwise -1.
+         */
+        virtual int sync() override ;
+
         /**
          * @brief Writes up to n characters from the character sequence at 
          *        char s to the serial port associated with the buffer.
@@ -383,9 +513,10 @@ namespace LibSerial
 
         /**
          * @brief This function is called when a putback of a character
-         *        fails. This must be implemented for unbuffered I/O as all
-         *        streambuf subclasses are required to provide putback of
-         *        at least one character.
+         *        fails, i.e. when the character does not match the previous
+         *        character in the get area or the get area is at its start.
+         *        The get area reserves room for putting back at least one
+         *        character even when unbuffered I/O is used.
          * @param character The character to putback.
          * @return Returns The character iff successful, otherwise eof to signal an error.
          */
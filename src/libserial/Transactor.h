@@ -0,0 +1,248 @@
+/******************************************************************************
+ * @file Transactor.h                                                         *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/FrameReader.h>
+#include <libserial/SerialPort.h>
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+
+namespace LibSerial
+{
+    /**
+     * @brief The tuning parameters of a Transactor.
+     */
+    struct TransactorPolicy
+    {
+        /**
+         * @brief The maximum number of requests sent but not yet answered.
+         *        Further requests are queued until a response arrives.
+         */
+        size_t windowSize = 8 ;
+
+        /**
+         * @brief The time in milliseconds allowed for each attempt of a
+         *        request before it is sent again or fails.
+         */
+        size_t msTimeout = 1000 ;
+
+        /**
+         * @brief The number of times a request is sent again after a timeout
+         *        before its handler is invoked with a ReadTimeout error.
+         */
+        size_t maximumRetries = 2 ;
+
+        /**
+         * @brief The duration in milliseconds covered by each slot of the
+         *        timer wheel tracking request deadlines.
+         */
+        size_t msTimerResolution = 1 ;
+
+        /**
+         * @brief The number of slots of the timer wheel. Deadlines further
+         *        away than the span of the wheel are kept for several turns.
+         */
+        size_t numberOfTimerSlots = 1024 ;
+
+        /**
+         * @brief The size of the receive buffer of the frame reader, which
+         *        bounds the size of an encoded response.
+         */
+        size_t bufferSize = 65536 ;
+    } ;
+
+    /**
+     * @brief Transactor performs request/response transactions over a
+     *        SerialPort with up to TransactorPolicy::windowSize requests in
+     *        flight, so that the round trip time of the link no longer
+     *        limits the transaction rate. Requests and responses are framed
+     *        with a FrameCodec.
+     *
+     *        Responses are matched to requests in the order the requests
+     *        were sent, or, if a response key function is supplied, by the
+     *        key it extracts from each response. Keyed matching should be
+     *        used whenever a device may answer out of order, or a response
+     *        may arrive after its request has timed out and been sent again.
+     *        Responses matching no outstanding request are discarded and
+     *        counted.
+     *
+     *        The deadline of each attempt is tracked on a timer wheel. A
+     *        request that times out is sent again, ahead of any queued
+     *        requests, up to TransactorPolicy::maximumRetries times.
+     *
+     *        Transactions make progress only while RunOnce() or Drain() is
+     *        running. A transactor must be used from one thread at a time.
+     *        Handlers are invoked from RunOnce() and Drain() and may submit
+     *        further requests.
+     */
+    class Transactor
+    {
+    public:
+        /**
+         * @brief Handle identifying a submitted transaction.
+         */
+        using TransactionId = uint64_t ;
+
+        /**
+         * @brief Handler invoked once a transaction completes, with the
+         *        response payload or with a ReadTimeout error once all
+         *        attempts have timed out.
+         */
+        using ResponseHandler = std::function<void(std::exception_ptr error, DataBuffer response)> ;
+
+        /**
+         * @brief Function extracting the key of a response payload, which is
+         *        compared with the key supplied to Submit().
+         */
+        using ResponseKeyFunction = std::function<uint64_t(const ConstBuffer& response)> ;
+
+        /**
+         * @brief Constructor.
+         * @param serialPort The open serial port to perform transactions on.
+         *        The serial port must outlive the transactor.
+         * @param frameCodec The codec used to encode requests and decode
+         *        responses.
+         * @param transactorPolicy The tuning parameters.
+         * @param responseKeyFunction Function extracting the key of each
+         *        response, or empty to match responses in request order.
+         */
+        explicit Transactor(SerialPort&                 serialPort,
+                            std::unique_ptr<FrameCodec> frameCodec,
+                            const TransactorPolicy&     transactorPolicy    = TransactorPolicy(),
+                            const ResponseKeyFunction&  responseKeyFunction = nullptr) ;
+
+        /**
+         * @brief Default Destructor. Outstanding transactions are discarded
+         *        without their handlers being invoked.
+         */
+        virtual ~Transactor() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        Transactor(const Transactor& otherTransactor) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        Transactor(Transactor&& otherTransactor) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        Transactor& operator=(const Transactor& otherTransactor) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        Transactor& operator=(Transactor&& otherTransactor) = delete ;
+
+        /**
+         * @brief Queues a request. The request is encoded immediately and
+         *        sent by RunOnce() or Drain() once the window allows.
+         * @param request The request payload.
+         * @param responseHandler The handler invoked when the transaction
+         *        completes.
+         * @param key The key of the expected response when a response key
+         *        function has been supplied, which must not be shared with
+         *        another outstanding transaction. Ignored otherwise.
+         * @return Returns the handle identifying the transaction.
+         */
+        TransactionId Submit(const DataBuffer&      request,
+                             const ResponseHandler& responseHandler,
+                             uint64_t               key = 0) ;
+
+        /**
+         * @brief Sends queued requests and dispatches responses and timeouts
+         *        until at least one transaction has completed. If msTimeout
+         *        is zero, this method blocks until a transaction completes
+         *        or none is outstanding.
+         * @param msTimeout The timeout period in milliseconds.
+         * @return Returns the number of transactions that completed.
+         */
+        size_t RunOnce(size_t msTimeout = 0) ;
+
+        /**
+         * @brief Dispatches responses and timeouts until every submitted
+         *        transaction, including those submitted by handlers, has
+         *        completed.
+         */
+        void Drain() ;
+
+        /**
+         * @brief Gets the number of transactions submitted and not yet
+         *        completed.
+         * @return Returns the number of outstanding transactions.
+         */
+        size_t GetNumberOfOutstandingTransactions() const ;
+
+        /**
+         * @brief Gets the number of requests sent and not yet answered.
+         * @return Returns the number of requests in flight.
+         */
+        size_t GetNumberOfTransactionsInFlight() const ;
+
+        /**
+         * @brief Gets the number of requests sent again after a timeout.
+         * @return Returns the number of retries.
+         */
+        size_t GetNumberOfRetries() const ;
+
+        /**
+         * @brief Gets the number of responses that matched no outstanding
+         *        request and were discarded.
+         * @return Returns the number of unmatched responses.
+         */
+        size_t GetNumberOfUnmatchedResponses() const ;
+
+    protected:
+
+    private:
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class Transactor
+
+} // namespace LibSerial
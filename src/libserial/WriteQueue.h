@@ -0,0 +1,208 @@
+/******************************************************************************
+ * @file WriteQueue.h                                                         *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include <libserial/SerialPort.h>
+
+#include <memory>
+
+namespace LibSerial
+{
+    /**
+     * @brief The conditions under which a WriteQueue writes queued data to
+     *        the serial port.
+     */
+    struct WriteQueuePolicy
+    {
+        /**
+         * @brief Queued data is written as soon as at least this many bytes
+         *        are waiting.
+         */
+        size_t maximumBatchSize = 4096 ;
+
+        /**
+         * @brief Queued data is written once its oldest byte has waited this
+         *        many microseconds, or as soon as possible if zero.
+         */
+        size_t maximumDelayMicroseconds = 1000 ;
+
+        /**
+         * @brief Writes are rejected when they would take the number of
+         *        bytes waiting beyond this limit.
+         */
+        size_t maximumQueueSize = 65536 ;
+    } ;
+
+    /**
+     * @brief WriteQueue coalesces small writes from any number of threads
+     *        into large write() calls made by a background thread, in the
+     *        manner of Nagle's algorithm. Data is written once
+     *        WriteQueuePolicy::maximumBatchSize bytes are waiting, once the
+     *        oldest byte has waited WriteQueuePolicy::maximumDelayMicroseconds,
+     *        or when Flush() is called, whichever happens first.
+     *
+     *        Data from one call to Write() is never split by data from
+     *        another, so the calls need no external locking. The serial port
+     *        must not be written to directly while the write queue exists.
+     */
+    class WriteQueue
+    {
+    public:
+        /**
+         * @brief Constructor. Starts the background writer thread.
+         * @param serialPort The open serial port to write to. The serial
+         *        port must outlive the write queue.
+         * @param writeQueuePolicy The flush and backpressure policy.
+         */
+        explicit WriteQueue(SerialPort&             serialPort,
+                            const WriteQueuePolicy& writeQueuePolicy = WriteQueuePolicy()) ;
+
+        /**
+         * @brief Default Destructor. Writes any data still queued and stops
+         *        the background writer thread.
+         */
+        virtual ~WriteQueue() ;
+
+        /**
+         * @brief Copy construction is disallowed.
+         */
+        WriteQueue(const WriteQueue& otherWriteQueue) = delete ;
+
+        /**
+         * @brief Move construction is disallowed.
+         */
+        WriteQueue(WriteQueue&& otherWriteQueue) = delete ;
+
+        /**
+         * @brief Copy assignment is disallowed.
+         */
+        WriteQueue& operator=(const WriteQueue& otherWriteQueue) = delete ;
+
+        /**
+         * @brief Move assignment is disallowed.
+         */
+        WriteQueue& operator=(WriteQueue&& otherWriteQueue) = delete ;
+
+        /**
+         * @brief Queues data to be written to the serial port. The data is
+         *        rejected, to push back on the caller, if it would take the
+         *        queue beyond WriteQueuePolicy::maximumQueueSize bytes. Data
+         *        larger than the limit is accepted when the queue is empty.
+         *        If the background writer has failed, its exception is
+         *        rethrown.
+         * @param dataBuffer Pointer to the data to be queued.
+         * @param numberOfBytes The number of bytes to be queued.
+         * @return Returns true if the data was queued, or false if the
+         *         queue is full.
+         */
+        bool Write(const uint8_t* dataBuffer,
+                   size_t         numberOfBytes) ;
+
+        /**
+         * @brief Queues data to be written to the serial port, see
+         *        Write(const uint8_t*, size_t).
+         * @param dataBuffer The data to be queued.
+         * @return Returns true if the data was queued, or false if the
+         *         queue is full.
+         */
+        bool Write(const DataBuffer& dataBuffer) ;
+
+        /**
+         * @brief Queues data to be written to the serial port, see
+         *        Write(const uint8_t*, size_t).
+         * @param dataString The data to be queued.
+         * @return Returns true if the data was queued, or false if the
+         *         queue is full.
+         */
+        bool Write(const std::string& dataString) ;
+
+        /**
+         * @brief Queues a single byte to be written to the serial port, see
+         *        Write(const uint8_t*, size_t).
+         * @param dataByte The byte to be queued.
+         * @return Returns true if the byte was queued, or false if the
+         *         queue is full.
+         */
+        bool WriteByte(uint8_t dataByte) ;
+
+        /**
+         * @brief Writes all queued data without waiting for the flush policy
+         *        and waits until the data queued before the call has been
+         *        written to the serial port. If the background writer has
+         *        failed, its exception is rethrown.
+         * @param msTimeout The timeout period in milliseconds, or zero to
+         *        wait indefinitely.
+         * @return Returns true if the data was written, or false if the
+         *         timeout period elapsed first.
+         */
+        bool Flush(size_t msTimeout = 0) ;
+
+        /**
+         * @brief Gets the number of bytes queued and not yet written,
+         *        including those being written.
+         * @return Returns the number of bytes queued.
+         */
+        size_t GetNumberOfQueuedBytes() const ;
+
+        /**
+         * @brief Gets the number of write operations issued to the serial
+         *        port, each of which writes a batch of coalesced data.
+         * @return Returns the number of write operations.
+         */
+        size_t GetNumberOfWriteCalls() const ;
+
+        /**
+         * @brief Gets the number of calls to Write() and WriteByte() that
+         *        were rejected because the queue was full.
+         * @return Returns the number of rejected writes.
+         */
+        size_t GetNumberOfRejectedWrites() const ;
+
+    protected:
+
+    private:
+        /**
+         * @brief Forward declaration of the Implementation class folowing
+         *        the PImpl idiom.
+         */
+        class Implementation;
+
+        /**
+         * @brief Pointer to Implementation class instance.
+         */
+        std::unique_ptr<Implementation> mImpl;
+
+    } ; // class WriteQueue
+
+} // namespace LibSerial
@@ -0,0 +1,233 @@
+/******************************************************************************
+ * @file AsyncSerialPortUnitTests.cpp                                         *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "AsyncSerialPortUnitTests.h"
+#include "UnitTests.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+
+using namespace LibSerial;
+
+AsyncSerialPortUnitTests::AsyncSerialPortUnitTests()
+{
+    reactorThread = std::thread([this]() { serialPortReactor.Run() ; }) ;
+}
+
+AsyncSerialPortUnitTests::~AsyncSerialPortUnitTests()
+{
+    serialPortReactor.Stop() ;
+    reactorThread.join() ;
+}
+
+void
+AsyncSerialPortUnitTests::testAsyncSerialPortReadWrite()
+{
+    const auto timeout = std::chrono::milliseconds(timeOutMilliseconds) ;
+
+    AsyncSerialPort async_port_1(serialPortReactor,
+                                 std::unique_ptr<SerialPort>(new SerialPort(SERIAL_PORT_1))) ;
+    AsyncSerialPort async_port_2(serialPortReactor,
+                                 std::unique_ptr<SerialPort>(new SerialPort(SERIAL_PORT_2))) ;
+
+    ASSERT_NE(async_port_1.GetPortId(), async_port_2.GetPortId()) ;
+
+    // Read a fixed number of bytes.
+    auto read_future = async_port_2.ReadAsync(writeString1.size(), timeOutMilliseconds) ;
+    auto write_future = async_port_1.WriteAsync(writeString1) ;
+
+    ASSERT_EQ(write_future.wait_for(timeout), std::future_status::ready) ;
+    write_future.get() ;
+
+    ASSERT_EQ(read_future.wait_for(timeout), std::future_status::ready) ;
+    const auto data_buffer = read_future.get() ;
+    ASSERT_EQ(std::string(data_buffer.begin(), data_buffer.end()), writeString1) ;
+
+    // Several reads outstanding at once complete in order, and data after
+    // the last delimiter is kept for the next read.
+    auto line_future_1 = async_port_2.ReadUntilAsync("\r\n", timeOutMilliseconds) ;
+    auto line_future_2 = async_port_2.ReadUntilAsync("\r\n", timeOutMilliseconds) ;
+
+    async_port_1.WriteAsync(writeString1 + "\r\n") ;
+    async_port_1.WriteAsync(writeString2 + "\r\nextra") ;
+
+    ASSERT_EQ(line_future_1.wait_for(timeout), std::future_status::ready) ;
+    ASSERT_EQ(line_future_1.get(), writeString1 + "\r\n") ;
+
+    ASSERT_EQ(line_future_2.wait_for(timeout), std::future_status::ready) ;
+    ASSERT_EQ(line_future_2.get(), writeString2 + "\r\n") ;
+
+    auto extra_future = async_port_2.ReadAsync(5, timeOutMilliseconds) ;
+    ASSERT_EQ(extra_future.wait_for(timeout), std::future_status::ready) ;
+    ASSERT_EQ(extra_future.get(), DataBuffer({'e', 'x', 't', 'r', 'a'})) ;
+
+    // Writes in both directions at once.
+    auto read_future_1 = async_port_1.ReadUntilAsync("\n", timeOutMilliseconds) ;
+    auto read_future_2 = async_port_2.ReadUntilAsync("\n", timeOutMilliseconds) ;
+
+    async_port_1.WriteAsync(writeString1 + '\n') ;
+    async_port_2.WriteAsync(writeString2 + '\n') ;
+
+    ASSERT_EQ(read_future_1.wait_for(timeout), std::future_status::ready) ;
+    ASSERT_EQ(read_future_1.get(), writeString2 + '\n') ;
+
+    ASSERT_EQ(read_future_2.wait_for(timeout), std::future_status::ready) ;
+    ASSERT_EQ(read_future_2.get(), writeString1 + '\n') ;
+
+    ASSERT_THROW(async_port_1.ReadUntilAsync(""), std::invalid_argument) ;
+}
+
+void
+AsyncSerialPortUnitTests::testAsyncSerialPortReadTimeout()
+{
+    const auto timeout = std::chrono::milliseconds(timeOutMilliseconds) ;
+
+    std::future<DataBuffer> pending_future ;
+
+    {
+        AsyncSerialPort async_port_1(serialPortReactor,
+                                     std::unique_ptr<SerialPort>(new SerialPort(SERIAL_PORT_1))) ;
+        AsyncSerialPort async_port_2(serialPortReactor,
+                                     std::unique_ptr<SerialPort>(new SerialPort(SERIAL_PORT_2))) ;
+
+        auto timeout_future = async_port_2.ReadAsync(1, 10) ;
+        ASSERT_EQ(timeout_future.wait_for(timeout), std::future_status::ready) ;
+        ASSERT_THROW(timeout_future.get(), ReadTimeout) ;
+
+        // Data received before a timeout is kept for the next read.
+        auto line_future = async_port_2.ReadUntilAsync("\n", 50) ;
+        async_port_1.WriteAsync(std::string("abc")) ;
+
+        ASSERT_EQ(line_future.wait_for(timeout), std::future_status::ready) ;
+        ASSERT_THROW(line_future.get(), ReadTimeout) ;
+
+        auto data_future = async_port_2.ReadAsync(3, timeOutMilliseconds) ;
+        ASSERT_EQ(data_future.wait_for(timeout), std::future_status::ready) ;
+        ASSERT_EQ(data_future.get(), DataBuffer({'a', 'b', 'c'})) ;
+
+        // A read without a timeout stays pending.
+        pending_future = async_port_2.ReadAsync(1) ;
+        ASSERT_EQ(pending_future.wait_for(std::chrono::milliseconds(10)), std::future_status::timeout) ;
+    }
+
+    // Destroying the AsyncSerialPort fails the pending read.
+    ASSERT_EQ(pending_future.wait_for(timeout), std::future_status::ready) ;
+    ASSERT_THROW(pending_future.get(), NotOpen) ;
+
+    // The ports have been closed and can be opened again.
+    serialPort1.Open(SERIAL_PORT_1) ;
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    serialPort1.Close() ;
+}
+
+void
+AsyncSerialPortUnitTests::testAsyncSerialPortHandlers()
+{
+    const auto timeout = std::chrono::milliseconds(timeOutMilliseconds) ;
+
+    AsyncSerialPort async_port_1(serialPortReactor,
+                                 std::unique_ptr<SerialPort>(new SerialPort(SERIAL_PORT_1))) ;
+    AsyncSerialPort async_port_2(serialPortReactor,
+                                 std::unique_ptr<SerialPort>(new SerialPort(SERIAL_PORT_2))) ;
+
+    std::promise<std::string> line_promise ;
+    std::promise<size_t> write_promise ;
+
+    // Each received line starts the next read from within the handler.
+    std::atomic<size_t> number_of_lines {0} ;
+
+    AsyncSerialPort::ReadUntilHandler read_line_handler ;
+    read_line_handler = [&](std::exception_ptr error, std::string dataString)
+    {
+        ASSERT_FALSE(error) ;
+
+        if (++number_of_lines < 3)
+        {
+            async_port_2.ReadUntilAsync("\n", 0, read_line_handler) ;
+            return ;
+        }
+
+        line_promise.set_value(dataString) ;
+    } ;
+
+    async_port_2.ReadUntilAsync("\n", 0, read_line_handler) ;
+
+    const auto lines = writeString1 + '\n' + writeString1 + '\n' + writeString2 + '\n' ;
+
+    async_port_1.WriteAsync(DataBuffer(lines.begin(), lines.end()),
+                            [&write_promise](std::exception_ptr error, size_t numberOfBytes)
+                            {
+                                ASSERT_FALSE(error) ;
+                                write_promise.set_value(numberOfBytes) ;
+                            }) ;
+
+    auto write_future = write_promise.get_future() ;
+    ASSERT_EQ(write_future.wait_for(timeout), std::future_status::ready) ;
+    ASSERT_EQ(write_future.get(), lines.size()) ;
+
+    auto line_future = line_promise.get_future() ;
+    ASSERT_EQ(line_future.wait_for(timeout), std::future_status::ready) ;
+    ASSERT_EQ(line_future.get(), writeString2 + '\n') ;
+    ASSERT_EQ(number_of_lines, 3) ;
+}
+
+TEST_F(AsyncSerialPortUnitTests, testAsyncSerialPortReadWrite)
+{
+    SCOPED_TRACE("Async Serial Port Read and Write Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testAsyncSerialPortReadWrite() ;
+    }
+}
+
+TEST_F(AsyncSerialPortUnitTests, testAsyncSerialPortReadTimeout)
+{
+    SCOPED_TRACE("Async Serial Port Read Timeout Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testAsyncSerialPortReadTimeout() ;
+    }
+}
+
+TEST_F(AsyncSerialPortUnitTests, testAsyncSerialPortHandlers)
+{
+    SCOPED_TRACE("Async Serial Port Completion Handlers Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testAsyncSerialPortHandlers() ;
+    }
+}
@@ -0,0 +1,90 @@
+/******************************************************************************
+ * @file AsyncSerialPortUnitTests.h                                           *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include "UnitTests.h"
+#include "libserial/AsyncSerialPort.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+/**
+ * @namespace Libserial
+ */
+namespace LibSerial
+{
+    class AsyncSerialPortUnitTests : public UnitTests
+    {
+    public:
+
+        /**
+         * @brief Default Constructor. Starts a thread running the reactor.
+         */
+        explicit AsyncSerialPortUnitTests() ;
+
+        /**
+         * @brief Default Destructor. Stops the reactor thread.
+         */
+        virtual ~AsyncSerialPortUnitTests() ;
+
+    protected:
+
+        /**
+         * @brief Tests ReadAsync(), ReadUntilAsync() and WriteAsync() with
+         *        several operations outstanding.
+         */
+        void testAsyncSerialPortReadWrite() ;
+
+        /**
+         * @brief Tests read timeouts and the failure of operations pending
+         *        when the AsyncSerialPort is destroyed.
+         */
+        void testAsyncSerialPortReadTimeout() ;
+
+        /**
+         * @brief Tests the completion handler forms of the operations.
+         */
+        void testAsyncSerialPortHandlers() ;
+
+        /**
+         * @var Reactor instance completing the asynchronous operations.
+         */
+        LibSerial::SerialPortReactor serialPortReactor {} ;
+
+        /**
+         * @var Thread running the reactor.
+         */
+        std::thread reactorThread {} ;
+    } ;
+}
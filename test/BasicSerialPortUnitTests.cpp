@@ -0,0 +1,269 @@
+/******************************************************************************
+ * @file BasicSerialPortUnitTests.cpp                                         *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "BasicSerialPortUnitTests.h"
+
+#include <atomic>
+#include <chrono>
+#include <pty.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace LibSerial;
+
+template <typename Port>
+void
+BasicSerialPortUnitTests::testPortReadWrite()
+{
+    Port basic_serial_port ;
+    ASSERT_FALSE(basic_serial_port.IsOpen()) ;
+
+    PortSettings port_settings ;
+    port_settings.baudRate = BaudRate::BAUD_115200 ;
+
+    basic_serial_port.Open(SERIAL_PORT_1, port_settings) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(basic_serial_port.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+    ASSERT_EQ(basic_serial_port.GetSerialPort().GetBaudRate(), BaudRate::BAUD_115200) ;
+
+    // Writes from the fast path port.
+    basic_serial_port.Write(writeString1) ;
+    basic_serial_port.WriteByte('\n') ;
+
+    std::string read_string ;
+    serialPort2.ReadLine(read_string, '\n', timeOutMilliseconds) ;
+    ASSERT_EQ(read_string, writeString1 + '\n') ;
+
+    // Reads into the fast path port.
+    ASSERT_FALSE(basic_serial_port.IsDataAvailable()) ;
+
+    serialPort2.Write(writeString1) ;
+    serialPort2.DrainWriteBuffer() ;
+
+    char first_byte = 0 ;
+    basic_serial_port.ReadByte(first_byte, timeOutMilliseconds) ;
+    ASSERT_EQ(first_byte, writeString1[0]) ;
+
+    unsigned char second_byte = 0 ;
+    basic_serial_port.ReadByte(second_byte, timeOutMilliseconds) ;
+    ASSERT_EQ(second_byte, static_cast<unsigned char>(writeString1[1])) ;
+
+    ASSERT_TRUE(basic_serial_port.IsDataAvailable()) ;
+
+    uint8_t chunk[8] {} ;
+    const auto chunk_size = basic_serial_port.Read(chunk, sizeof(chunk), timeOutMilliseconds) ;
+    ASSERT_GT(chunk_size, 0U) ;
+    ASSERT_LE(chunk_size, sizeof(chunk)) ;
+    ASSERT_EQ(std::string(chunk, chunk + chunk_size), writeString1.substr(2, chunk_size)) ;
+
+    const auto remaining_size = writeString1.size() - 2 - chunk_size ;
+
+    DataBuffer read_buffer ;
+    basic_serial_port.Read(read_buffer, remaining_size, timeOutMilliseconds) ;
+    ASSERT_EQ(std::string(read_buffer.begin(), read_buffer.end()), writeString1.substr(2 + chunk_size)) ;
+
+    ASSERT_FALSE(basic_serial_port.IsDataAvailable()) ;
+
+    basic_serial_port.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(basic_serial_port.IsOpen()) ;
+}
+
+void
+BasicSerialPortUnitTests::testBasicSerialPortReadWrite()
+{
+    testPortReadWrite<BasicSerialPort<>>() ;
+    testPortReadWrite<BasicSerialPort<NoLocking, ReadBuffered<64>>>() ;
+    testPortReadWrite<BasicSerialPort<MutexLocking, ReadBuffered<4>, PollBlocking>>() ;
+    testPortReadWrite<BasicSerialPort<MutexLocking, Unbuffered, SpinBlocking>>() ;
+}
+
+void
+BasicSerialPortUnitTests::testBasicSerialPortReadTimeout()
+{
+    BasicSerialPort<NoLocking, ReadBuffered<16>> basic_serial_port(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(basic_serial_port.IsOpen()) ;
+
+    char read_byte = 0 ;
+    ASSERT_THROW(basic_serial_port.ReadByte(read_byte, 1), ReadTimeout) ;
+
+    uint8_t read_data[4] {} ;
+    ASSERT_THROW(basic_serial_port.Read(read_data, sizeof(read_data), 1), ReadTimeout) ;
+
+    // A partial read keeps the bytes that did arrive.
+    serialPort2.Write(writeString1) ;
+    serialPort2.DrainWriteBuffer() ;
+
+    std::string read_string ;
+    ASSERT_THROW(basic_serial_port.Read(read_string, writeString1.size() + 1, timeOutMilliseconds), ReadTimeout) ;
+    ASSERT_EQ(read_string, writeString1) ;
+
+    basic_serial_port.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_THROW(basic_serial_port.ReadByte(read_byte), NotOpen) ;
+    ASSERT_THROW(basic_serial_port.Read(read_data, sizeof(read_data)), NotOpen) ;
+    ASSERT_THROW(basic_serial_port.WriteByte('x'), NotOpen) ;
+    ASSERT_THROW(basic_serial_port.IsDataAvailable(), NotOpen) ;
+}
+
+template <typename Port>
+void
+BasicSerialPortUnitTests::testPortCloseUnblocksRead()
+{
+    Port basic_serial_port(SERIAL_PORT_1) ;
+    ASSERT_TRUE(basic_serial_port.IsOpen()) ;
+
+    std::atomic<bool> is_not_open {false} ;
+
+    std::thread read_thread([&basic_serial_port, &is_not_open]()
+                            {
+                                unsigned char read_byte = 0 ;
+
+                                try
+                                {
+                                    basic_serial_port.ReadByte(read_byte, 0) ;
+                                }
+                                catch (const NotOpen&)
+                                {
+                                    is_not_open = true ;
+                                }
+                            }) ;
+
+    // Give the reader time to block.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)) ;
+
+    basic_serial_port.Close() ;
+    read_thread.join() ;
+
+    ASSERT_TRUE(is_not_open) ;
+    ASSERT_FALSE(basic_serial_port.IsOpen()) ;
+
+    // A later open is not woken by the earlier Close().
+    basic_serial_port.Open(SERIAL_PORT_1) ;
+
+    char read_byte = 0 ;
+    ASSERT_THROW(basic_serial_port.ReadByte(read_byte, 1), ReadTimeout) ;
+
+    basic_serial_port.Close() ;
+}
+
+template <typename Port>
+void
+BasicSerialPortUnitTests::testPortHangUp()
+{
+    int master_fd = -1 ;
+    int slave_fd = -1 ;
+    char slave_name[64] {} ;
+
+    ASSERT_EQ(openpty(&master_fd, &slave_fd, slave_name, nullptr, nullptr), 0) ;
+
+    Port basic_serial_port(slave_name) ;
+    close(slave_fd) ;
+
+    ASSERT_TRUE(basic_serial_port.IsOpen()) ;
+
+    // Closing the master hangs up the slave.
+    close(master_fd) ;
+
+    char read_byte = 0 ;
+    ASSERT_THROW(basic_serial_port.ReadByte(read_byte, 0), std::runtime_error) ;
+
+    basic_serial_port.Close() ;
+}
+
+void
+BasicSerialPortUnitTests::testBasicSerialPortCloseUnblocksRead()
+{
+    testPortCloseUnblocksRead<BasicSerialPort<MutexLocking>>() ;
+    testPortCloseUnblocksRead<BasicSerialPort<MutexLocking, ReadBuffered<64>, SpinBlocking>>() ;
+}
+
+void
+BasicSerialPortUnitTests::testBasicSerialPortHangUp()
+{
+    testPortHangUp<BasicSerialPort<>>() ;
+    testPortHangUp<BasicSerialPort<NoLocking, ReadBuffered<64>, SpinBlocking>>() ;
+
+    PortSettings port_settings ;
+    port_settings.vmin = 0 ;
+
+    BasicSerialPort<> basic_serial_port ;
+    ASSERT_THROW(basic_serial_port.Open(SERIAL_PORT_1, port_settings), std::invalid_argument) ;
+    ASSERT_FALSE(basic_serial_port.IsOpen()) ;
+}
+
+TEST_F(BasicSerialPortUnitTests, testBasicSerialPortReadWrite)
+{
+    SCOPED_TRACE("BasicSerialPort Read And Write Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testBasicSerialPortReadWrite() ;
+    }
+}
+
+TEST_F(BasicSerialPortUnitTests, testBasicSerialPortReadTimeout)
+{
+    SCOPED_TRACE("BasicSerialPort Read Timeout Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testBasicSerialPortReadTimeout() ;
+    }
+}
+
+TEST_F(BasicSerialPortUnitTests, testBasicSerialPortCloseUnblocksRead)
+{
+    SCOPED_TRACE("BasicSerialPort Close Unblocks Read Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testBasicSerialPortCloseUnblocksRead() ;
+    }
+}
+
+TEST_F(BasicSerialPortUnitTests, testBasicSerialPortHangUp)
+{
+    SCOPED_TRACE("BasicSerialPort Hang-Up Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testBasicSerialPortHangUp() ;
+    }
+}
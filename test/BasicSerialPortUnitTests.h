@@ -0,0 +1,108 @@
+/******************************************************************************
+ * @file BasicSerialPortUnitTests.h                                           *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include "UnitTests.h"
+#include "libserial/BasicSerialPort.h"
+
+#include <gtest/gtest.h>
+
+/**
+ * @namespace Libserial
+ */
+namespace LibSerial
+{
+    class BasicSerialPortUnitTests : public UnitTests
+    {
+    public:
+
+        /**
+         * @brief Default Constructor.
+         */
+        explicit BasicSerialPortUnitTests() = default ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~BasicSerialPortUnitTests() = default ;
+
+    protected:
+
+        /**
+         * @brief Tests reading and writing with each combination of
+         *        policies against a SerialPort.
+         */
+        void testBasicSerialPortReadWrite() ;
+
+        /**
+         * @brief Tests that read timeouts keep the data received so far and
+         *        that a closed port throws NotOpen.
+         */
+        void testBasicSerialPortReadTimeout() ;
+
+        /**
+         * @brief Tests that Close() from another thread wakes a reader
+         *        blocked indefinitely, which then throws NotOpen.
+         */
+        void testBasicSerialPortCloseUnblocksRead() ;
+
+        /**
+         * @brief Tests that a hang-up of the serial port is reported as an
+         *        error instead of being waited on, and that a VMIN of zero
+         *        is rejected.
+         */
+        void testBasicSerialPortHangUp() ;
+
+        /**
+         * @brief Tests reading and writing with the specified instance of
+         *        BasicSerialPort.
+         */
+        template <typename Port>
+        void testPortReadWrite() ;
+
+        /**
+         * @brief Tests that Close() wakes a blocked reader of the specified
+         *        instance of BasicSerialPort.
+         */
+        template <typename Port>
+        void testPortCloseUnblocksRead() ;
+
+        /**
+         * @brief Tests a hang-up with the specified instance of
+         *        BasicSerialPort.
+         */
+        template <typename Port>
+        void testPortHangUp() ;
+    } ;
+}
@@ -0,0 +1,246 @@
+/******************************************************************************
+ * @file BufferPoolUnitTests.cpp                                              *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "BufferPoolUnitTests.h"
+#include "UnitTests.h"
+#include "libserial/FrameReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace LibSerial;
+
+void
+BufferPoolUnitTests::testBufferPoolAllocate()
+{
+    ASSERT_EQ(BufferPool::GetBlockSize(1), BUFFER_POOL_MINIMUM_BLOCK_SIZE) ;
+    ASSERT_EQ(BufferPool::GetBlockSize(64), 64U) ;
+    ASSERT_EQ(BufferPool::GetBlockSize(65), 256U) ;
+    ASSERT_EQ(BufferPool::GetBlockSize(4096), 4096U) ;
+    ASSERT_EQ(BufferPool::GetBlockSize(BUFFER_POOL_MAXIMUM_BLOCK_SIZE), BUFFER_POOL_MAXIMUM_BLOCK_SIZE) ;
+    ASSERT_EQ(BufferPool::GetBlockSize(BUFFER_POOL_MAXIMUM_BLOCK_SIZE + 1), BUFFER_POOL_MAXIMUM_BLOCK_SIZE + 1) ;
+
+    BufferPool::Trim() ;
+    ASSERT_EQ(BufferPool::GetNumberOfCachedBlocks(), 0U) ;
+
+    // A released block is handed out again for any size in its class.
+    auto* const block = BufferPool::Allocate(100) ;
+    std::memset(block, 0xA5, BufferPool::GetBlockSize(100)) ;
+    BufferPool::Deallocate(block, 100) ;
+    ASSERT_EQ(BufferPool::GetNumberOfCachedBlocks(), 1U) ;
+
+    auto* const reused_block = BufferPool::Allocate(256) ;
+    ASSERT_EQ(reused_block, block) ;
+    ASSERT_EQ(BufferPool::GetNumberOfCachedBlocks(), 0U) ;
+    BufferPool::Deallocate(reused_block, 256) ;
+
+    // Blocks larger than the largest size class are not cached.
+    auto* const large_block = BufferPool::Allocate(BUFFER_POOL_MAXIMUM_BLOCK_SIZE + 1) ;
+    BufferPool::Deallocate(large_block, BUFFER_POOL_MAXIMUM_BLOCK_SIZE + 1) ;
+    ASSERT_EQ(BufferPool::GetNumberOfCachedBlocks(), 1U) ;
+
+    // Containers using the allocator recycle their storage.
+    {
+        PooledDataBuffer data_buffer(writeString1.begin(), writeString1.end()) ;
+        ASSERT_EQ(std::string(data_buffer.begin(), data_buffer.end()), writeString1) ;
+
+        data_buffer.resize(10000, 'x') ;
+        ASSERT_EQ(data_buffer.back(), 'x') ;
+    }
+
+    ASSERT_GT(BufferPool::GetNumberOfCachedBlocks(), 1U) ;
+
+    // The per thread cache is bounded; the rest goes to the shared depot.
+    std::vector<void*> blocks ;
+
+    for (size_t i = 0 ; i < 1000 ; ++i)
+    {
+        blocks.push_back(BufferPool::Allocate(32)) ;
+    }
+
+    for (auto* const allocated_block : blocks)
+    {
+        BufferPool::Deallocate(allocated_block, 32) ;
+    }
+
+    ASSERT_GE(BufferPool::GetNumberOfCachedBlocks(), 1000U) ;
+
+    BufferPool::Trim() ;
+    ASSERT_EQ(BufferPool::GetNumberOfCachedBlocks(), 0U) ;
+}
+
+void
+BufferPoolUnitTests::testBufferPoolMultiThread()
+{
+    constexpr size_t number_of_threads = 8 ;
+    constexpr size_t number_of_buffers = 2000 ;
+
+    // Each producer fills buffers that a consumer checks and releases.
+    std::vector<std::vector<PooledDataBuffer>> produced_buffers(number_of_threads) ;
+    std::vector<std::thread> threads ;
+
+    for (size_t thread_index = 0 ; thread_index < number_of_threads ; ++thread_index)
+    {
+        threads.emplace_back([&produced_buffers, thread_index]()
+        {
+            auto& buffers = produced_buffers[thread_index] ;
+
+            for (size_t i = 0 ; i < number_of_buffers ; ++i)
+            {
+                const auto size = 1 + (i * 37) % 5000 ;
+                buffers.emplace_back(size, static_cast<uint8_t>(thread_index + i)) ;
+            }
+        }) ;
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join() ;
+    }
+
+    threads.clear() ;
+
+    std::vector<size_t> failures(number_of_threads, 0) ;
+
+    for (size_t thread_index = 0 ; thread_index < number_of_threads ; ++thread_index)
+    {
+        threads.emplace_back([&produced_buffers, &failures, thread_index]()
+        {
+            // Consume the buffers of another thread.
+            auto& buffers = produced_buffers[(thread_index + 1) % number_of_threads] ;
+            const auto producer_index = (thread_index + 1) % number_of_threads ;
+
+            for (size_t i = 0 ; i < buffers.size() ; ++i)
+            {
+                const auto expected_size = 1 + (i * 37) % 5000 ;
+                const auto expected_value = static_cast<uint8_t>(producer_index + i) ;
+
+                if ((buffers[i].size() != expected_size) or
+                    (std::count(buffers[i].begin(), buffers[i].end(), expected_value) !=
+                     static_cast<std::ptrdiff_t>(expected_size)))
+                {
+                    ++failures[thread_index] ;
+                }
+            }
+
+            buffers.clear() ;
+            buffers.shrink_to_fit() ;
+        }) ;
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join() ;
+    }
+
+    for (const auto failure_count : failures)
+    {
+        ASSERT_EQ(failure_count, 0U) ;
+    }
+
+    // Exiting threads return their caches to the depot.
+    ASSERT_GE(BufferPool::GetNumberOfCachedBlocks(), number_of_threads) ;
+
+    BufferPool::Trim() ;
+    ASSERT_EQ(BufferPool::GetNumberOfCachedBlocks(), 0U) ;
+}
+
+void
+BufferPoolUnitTests::testPooledDataBufferReadWrite()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    const PooledDataBuffer write_buffer(writeString1.begin(), writeString1.end()) ;
+    PooledDataBuffer read_buffer ;
+
+    serialPort1.Write(write_buffer) ;
+    serialPort2.Read(read_buffer, write_buffer.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(read_buffer, write_buffer) ;
+
+    // Reusing the buffer for a shorter read keeps its storage.
+    const auto* const storage = read_buffer.data() ;
+
+    serialPort1.Write(writeString2.substr(0, 10)) ;
+    serialPort2.Read(read_buffer, 10, timeOutMilliseconds) ;
+    ASSERT_EQ(std::string(read_buffer.begin(), read_buffer.end()), writeString2.substr(0, 10)) ;
+    ASSERT_EQ(read_buffer.data(), storage) ;
+
+    // Frames may be copied out of a FrameReader into pooled buffers.
+    FrameReader frame_reader(serialPort2,
+                             std::unique_ptr<FrameCodec>(new DelimiterCodec("\r\n"))) ;
+
+    serialPort1.Write(writeString1 + "\r\n") ;
+
+    PooledDataBuffer frame ;
+    frame_reader.ReadFrame(frame, timeOutMilliseconds) ;
+    ASSERT_EQ(std::string(frame.begin(), frame.end()), writeString1) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+}
+
+TEST_F(BufferPoolUnitTests, testBufferPoolAllocate)
+{
+    SCOPED_TRACE("Buffer Pool Allocate Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testBufferPoolAllocate() ;
+    }
+}
+
+TEST_F(BufferPoolUnitTests, testBufferPoolMultiThread)
+{
+    SCOPED_TRACE("Buffer Pool Multi-Thread Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testBufferPoolMultiThread() ;
+    }
+}
+
+TEST_F(BufferPoolUnitTests, testPooledDataBufferReadWrite)
+{
+    SCOPED_TRACE("Pooled Data Buffer Read and Write Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testPooledDataBufferReadWrite() ;
+    }
+}
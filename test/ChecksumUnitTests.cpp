@@ -0,0 +1,239 @@
+/******************************************************************************
+ * @file ChecksumUnitTests.cpp                                                *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "ChecksumUnitTests.h"
+#include "libserial/FrameReader.h"
+
+#include <random>
+#include <vector>
+
+using namespace LibSerial;
+
+uint32_t
+ChecksumUnitTests::computeBitwiseChecksum(const ChecksumType checksumType,
+                                          const uint8_t*     data,
+                                          const size_t       size)
+{
+    uint32_t crc = (checksumType == ChecksumType::CRC_32) ? 0xFFFFFFFFU : 0xFFFFU ;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (checksumType == ChecksumType::CRC_16_CCITT)
+        {
+            crc ^= static_cast<uint32_t>(data[i]) << 8U ;
+
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = ((crc & 0x8000U) ? ((crc << 1U) ^ 0x1021U) : (crc << 1U)) & 0xFFFFU ;
+            }
+        }
+        else
+        {
+            const auto polynomial = (checksumType == ChecksumType::CRC_32) ? 0xEDB88320U : 0xA001U ;
+
+            crc ^= data[i] ;
+
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc & 1U) ? ((crc >> 1U) ^ polynomial) : (crc >> 1U) ;
+            }
+        }
+    }
+
+    return (checksumType == ChecksumType::CRC_32) ? ~crc : crc ;
+}
+
+void
+ChecksumUnitTests::testChecksumCompute()
+{
+    const std::string check_string = "123456789" ;
+    const auto check_data = reinterpret_cast<const uint8_t*>(check_string.data()) ; // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
+
+    ASSERT_EQ(ComputeChecksum(ChecksumType::CRC_16_CCITT,  check_data, check_string.size()), 0x29B1U) ;
+    ASSERT_EQ(ComputeChecksum(ChecksumType::CRC_16_MODBUS, check_data, check_string.size()), 0x4B37U) ;
+    ASSERT_EQ(ComputeChecksum(ChecksumType::CRC_32,        check_data, check_string.size()), 0xCBF43926U) ;
+
+    ASSERT_EQ(ComputeChecksum(ChecksumType::CRC_16_CCITT,  nullptr, 0), 0xFFFFU) ;
+    ASSERT_EQ(ComputeChecksum(ChecksumType::CRC_16_MODBUS, nullptr, 0), 0xFFFFU) ;
+    ASSERT_EQ(ComputeChecksum(ChecksumType::CRC_32,        nullptr, 0), 0U) ;
+
+    // Lengths either side of the eight byte slices and of the 16 and 64
+    // byte blocks folded by the instruction set kernels, at every
+    // alignment.
+    std::mt19937 random_generator(static_cast<unsigned int>(TEST_ITERATIONS)) ;
+    DataBuffer data(1024 + 8) ;
+
+    for (auto& data_byte : data)
+    {
+        data_byte = static_cast<uint8_t>(random_generator()) ;
+    }
+
+    for (const auto checksum_type : {ChecksumType::CRC_16_CCITT,
+                                     ChecksumType::CRC_16_MODBUS,
+                                     ChecksumType::CRC_32})
+    {
+        for (size_t size = 0; size <= 1024; size += (size < 160) ? 1 : 61)
+        {
+            for (size_t offset = 0; offset < 8; ++offset)
+            {
+                ASSERT_EQ(ComputeChecksum(checksum_type, data.data() + offset, size),
+                          computeBitwiseChecksum(checksum_type, data.data() + offset, size)) ;
+            }
+        }
+    }
+
+    ASSERT_THROW(ComputeChecksum(static_cast<ChecksumType>(-1), check_data, check_string.size()),
+                 std::invalid_argument) ;
+    ASSERT_THROW(GetChecksumSize(static_cast<ChecksumType>(-1)),
+                 std::invalid_argument) ;
+}
+
+void
+ChecksumUnitTests::testChecksumAppendVerify()
+{
+    const DataBuffer check_data = {'1', '2', '3', '4', '5', '6', '7', '8', '9'} ;
+
+    auto data = check_data ;
+    AppendChecksum(ChecksumType::CRC_16_CCITT, data) ;
+    ASSERT_EQ(DataBuffer(data.begin() + 9, data.end()), DataBuffer({0x29, 0xB1})) ;
+    ASSERT_TRUE(VerifyChecksum(ChecksumType::CRC_16_CCITT, data.data(), data.size())) ;
+
+    data = check_data ;
+    AppendChecksum(ChecksumType::CRC_16_MODBUS, data) ;
+    ASSERT_EQ(DataBuffer(data.begin() + 9, data.end()), DataBuffer({0x37, 0x4B})) ;
+    ASSERT_TRUE(VerifyChecksum(ChecksumType::CRC_16_MODBUS, data.data(), data.size())) ;
+
+    data = check_data ;
+    AppendChecksum(ChecksumType::CRC_32, data) ;
+    ASSERT_EQ(DataBuffer(data.begin() + 9, data.end()), DataBuffer({0x26, 0x39, 0xF4, 0xCB})) ;
+    ASSERT_TRUE(VerifyChecksum(ChecksumType::CRC_32, data.data(), data.size())) ;
+
+    // Any corrupted byte, or data shorter than the checksum, fails.
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        auto corrupted_data = data ;
+        corrupted_data[i] ^= 0x01 ;
+        ASSERT_FALSE(VerifyChecksum(ChecksumType::CRC_32, corrupted_data.data(), corrupted_data.size())) ;
+    }
+
+    ASSERT_FALSE(VerifyChecksum(ChecksumType::CRC_32, data.data(), 3)) ;
+
+    ASSERT_EQ(GetChecksumSize(ChecksumType::CRC_16_CCITT), 2U) ;
+    ASSERT_EQ(GetChecksumSize(ChecksumType::CRC_16_MODBUS), 2U) ;
+    ASSERT_EQ(GetChecksumSize(ChecksumType::CRC_32), 4U) ;
+}
+
+void
+ChecksumUnitTests::testChecksumWriteAndFrameReader()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    // WriteWithChecksum() sends the data followed by its checksum.
+    const DataBuffer write_data(writeString1.begin(), writeString1.end()) ;
+    serialPort1.WriteWithChecksum(write_data, ChecksumType::CRC_16_MODBUS) ;
+
+    DataBuffer read_data ;
+    serialPort2.Read(read_data, write_data.size() + 2, timeOutMilliseconds) ;
+
+    auto expected_data = write_data ;
+    AppendChecksum(ChecksumType::CRC_16_MODBUS, expected_data) ;
+    ASSERT_EQ(read_data, expected_data) ;
+
+    // Frames are verified and stripped of their checksum as they are read.
+    FrameReader frame_reader(serialPort2,
+                             std::unique_ptr<FrameCodec>(new ChecksumCodec(std::unique_ptr<FrameCodec>(new CobsCodec()),
+                                                                           ChecksumType::CRC_32))) ;
+
+    const ChecksumCodec checksum_codec(std::unique_ptr<FrameCodec>(new CobsCodec()),
+                                       ChecksumType::CRC_32) ;
+
+    DataBuffer encoded_frames ;
+    checksum_codec.Encode(write_data.data(), write_data.size(), encoded_frames) ;
+
+    // A frame whose payload was corrupted in transit.
+    const auto corrupted_frame_start = encoded_frames.size() ;
+    checksum_codec.Encode(write_data.data(), write_data.size(), encoded_frames) ;
+    encoded_frames[corrupted_frame_start + 2] ^= 0x01 ;
+
+    checksum_codec.Encode(write_data.data(), 4, encoded_frames) ;
+
+    serialPort1.Write(encoded_frames) ;
+
+    auto frame = frame_reader.ReadFrame(timeOutMilliseconds) ;
+    ASSERT_EQ(DataBuffer(frame.data, frame.data + frame.size), write_data) ;
+
+    frame = frame_reader.ReadFrame(timeOutMilliseconds) ;
+    ASSERT_EQ(DataBuffer(frame.data, frame.data + frame.size), DataBuffer(write_data.begin(), write_data.begin() + 4)) ;
+    ASSERT_EQ(frame_reader.GetNumberOfInvalidFrames(), 1U) ;
+
+    ASSERT_THROW(ChecksumCodec(nullptr), std::invalid_argument) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_THROW(serialPort1.WriteWithChecksum(write_data, ChecksumType::CRC_32), NotOpen) ;
+}
+
+TEST_F(ChecksumUnitTests, testChecksumCompute)
+{
+    SCOPED_TRACE("Checksum Compute Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testChecksumCompute() ;
+    }
+}
+
+TEST_F(ChecksumUnitTests, testChecksumAppendVerify)
+{
+    SCOPED_TRACE("Checksum Append And Verify Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testChecksumAppendVerify() ;
+    }
+}
+
+TEST_F(ChecksumUnitTests, testChecksumWriteAndFrameReader)
+{
+    SCOPED_TRACE("Checksum WriteWithChecksum() And FrameReader Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testChecksumWriteAndFrameReader() ;
+    }
+}
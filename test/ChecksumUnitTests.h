@@ -0,0 +1,92 @@
+/******************************************************************************
+ * @file ChecksumUnitTests.h                                                  *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include "UnitTests.h"
+#include "libserial/Checksum.h"
+
+#include <gtest/gtest.h>
+
+/**
+ * @namespace Libserial
+ */
+namespace LibSerial
+{
+    class ChecksumUnitTests : public UnitTests
+    {
+    public:
+
+        /**
+         * @brief Default Constructor.
+         */
+        explicit ChecksumUnitTests() = default ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~ChecksumUnitTests() = default ;
+
+    protected:
+
+        /**
+         * @brief Tests each checksum against its published check value and
+         *        against a bit at a time computation, for lengths and
+         *        alignments that exercise every code path.
+         */
+        void testChecksumCompute() ;
+
+        /**
+         * @brief Tests the byte order of appended checksums and their
+         *        verification.
+         */
+        void testChecksumAppendVerify() ;
+
+        /**
+         * @brief Tests writing data with WriteWithChecksum() and reading it
+         *        back through a ChecksumCodec.
+         */
+        void testChecksumWriteAndFrameReader() ;
+
+        /**
+         * @brief Computes a checksum one bit at a time.
+         * @param checksumType The checksum to compute.
+         * @param data Pointer to the data.
+         * @param size The number of bytes of data.
+         * @return Returns the checksum.
+         */
+        static uint32_t computeBitwiseChecksum(ChecksumType   checksumType,
+                                               const uint8_t* data,
+                                               size_t         size) ;
+    } ;
+}
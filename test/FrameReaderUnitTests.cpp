@@ -0,0 +1,372 @@
+/******************************************************************************
+ * @file FrameReaderUnitTests.cpp                                             *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "FrameReaderUnitTests.h"
+#include "UnitTests.h"
+
+#include <algorithm>
+
+using namespace LibSerial;
+
+std::vector<DataBuffer>
+FrameReaderUnitTests::getTestPayloads()
+{
+    std::vector<DataBuffer> payloads ;
+
+    payloads.push_back({'a'}) ;
+    payloads.push_back({0x00}) ;
+    payloads.push_back({0x00, 0x00}) ;
+    payloads.push_back({0x11, 0x00, 0x22, 0x00}) ;
+    payloads.push_back({0xC0, 0xDB, 0xDC, 0xDD, 0xC0}) ;
+
+    // COBS block boundaries fall at 254 non-zero bytes.
+    for (const size_t size : {253, 254, 255, 508, 1000})
+    {
+        DataBuffer payload(size) ;
+
+        for (size_t i = 0 ; i < size ; ++i)
+        {
+            payload[i] = static_cast<uint8_t>(1 + i % 255) ;
+        }
+
+        payloads.push_back(payload) ;
+
+        payload.back() = 0x00 ;
+        payloads.push_back(payload) ;
+    }
+
+    return payloads ;
+}
+
+DecodeResult
+FrameReaderUnitTests::decodeNextFrame(FrameCodec&  frameCodec,
+                                      DataBuffer&  data,
+                                      const size_t size,
+                                      size_t&      frameStart,
+                                      ConstBuffer& frame)
+{
+    while (true)
+    {
+        size_t bytes_consumed = 0 ;
+
+        const auto result = frameCodec.Decode(data.data() + frameStart,
+                                              size - frameStart,
+                                              bytes_consumed,
+                                              frame) ;
+
+        if (result == DecodeResult::INCOMPLETE)
+        {
+            return result ;
+        }
+
+        frameStart += bytes_consumed ;
+
+        if (result != DecodeResult::SKIPPED)
+        {
+            return result ;
+        }
+    }
+}
+
+void
+FrameReaderUnitTests::testFrameCodecRoundTrip()
+{
+    std::vector<std::unique_ptr<FrameCodec>> codecs ;
+    codecs.emplace_back(new LengthPrefixCodec()) ;
+    codecs.emplace_back(new LengthPrefixCodec(1, true, 255)) ;
+    codecs.emplace_back(new LengthPrefixCodec(4, false)) ;
+    codecs.emplace_back(new CobsCodec()) ;
+    codecs.emplace_back(new SlipCodec()) ;
+
+    for (auto& codec : codecs)
+    {
+        for (const auto& payload : getTestPayloads())
+        {
+            if ((dynamic_cast<LengthPrefixCodec*>(codec.get()) != nullptr) and
+                (payload.size() > 255))
+            {
+                continue ;
+            }
+
+            DataBuffer encoded_frame ;
+            codec->Encode(payload.data(), payload.size(), encoded_frame) ;
+
+            size_t frame_start = 0 ;
+            ConstBuffer frame {} ;
+
+            ASSERT_EQ(decodeNextFrame(*codec,
+                                      encoded_frame,
+                                      encoded_frame.size(),
+                                      frame_start,
+                                      frame),
+                      DecodeResult::FRAME) ;
+
+            ASSERT_EQ(frame_start, encoded_frame.size()) ;
+            ASSERT_EQ(DataBuffer(frame.data, frame.data + frame.size), payload) ;
+        }
+    }
+
+    // The COBS encoding never contains the delimiter before the end.
+    CobsCodec cobs_codec ;
+    DataBuffer cobs_frame ;
+    const DataBuffer zeros(300, 0x00) ;
+    cobs_codec.Encode(zeros.data(), zeros.size(), cobs_frame) ;
+    ASSERT_EQ(std::count(cobs_frame.begin(), cobs_frame.end(), 0x00), 1) ;
+    ASSERT_EQ(cobs_frame.back(), 0x00) ;
+
+    // Delimited frames exclude the delimiter, and may be empty.
+    DelimiterCodec delimiter_codec("\r\n") ;
+    DataBuffer delimited_frames ;
+    delimiter_codec.Encode(reinterpret_cast<const uint8_t*>(writeString1.data()),
+                           writeString1.size(),
+                           delimited_frames) ;
+    delimiter_codec.Encode(nullptr, 0, delimited_frames) ;
+
+    size_t bytes_consumed = 0 ;
+    ConstBuffer frame {} ;
+
+    ASSERT_EQ(delimiter_codec.Decode(delimited_frames.data(),
+                                     delimited_frames.size(),
+                                     bytes_consumed,
+                                     frame),
+              DecodeResult::FRAME) ;
+    ASSERT_EQ(std::string(frame.data, frame.data + frame.size), writeString1) ;
+    ASSERT_EQ(bytes_consumed, writeString1.size() + 2) ;
+
+    ASSERT_EQ(delimiter_codec.Decode(delimited_frames.data() + bytes_consumed,
+                                     delimited_frames.size() - bytes_consumed,
+                                     bytes_consumed,
+                                     frame),
+              DecodeResult::FRAME) ;
+    ASSERT_EQ(frame.size, 0U) ;
+
+    ASSERT_THROW(DelimiterCodec(""), std::invalid_argument) ;
+    ASSERT_THROW(LengthPrefixCodec(3), std::invalid_argument) ;
+
+    LengthPrefixCodec short_codec(1) ;
+    DataBuffer oversized(256) ;
+    ASSERT_THROW(short_codec.Encode(oversized.data(), oversized.size(), oversized),
+                 std::invalid_argument) ;
+}
+
+void
+FrameReaderUnitTests::testFrameCodecPartialInput()
+{
+    std::vector<std::unique_ptr<FrameCodec>> codecs ;
+    codecs.emplace_back(new LengthPrefixCodec()) ;
+    codecs.emplace_back(new CobsCodec()) ;
+    codecs.emplace_back(new SlipCodec()) ;
+    codecs.emplace_back(new DelimiterCodec("\r\n")) ;
+
+    const DataBuffer payload(writeString1.begin(), writeString1.end()) ;
+
+    for (auto& codec : codecs)
+    {
+        DataBuffer encoded_frames ;
+        codec->Encode(payload.data(), payload.size(), encoded_frames) ;
+        codec->Encode(payload.data(), payload.size(), encoded_frames) ;
+
+        const auto frame_size = encoded_frames.size() / 2 ;
+
+        // Feed the first frame a byte at a time, as a slow link would.
+        size_t frame_start = 0 ;
+        ConstBuffer frame {} ;
+
+        for (size_t size = 0 ; size < frame_size ; ++size)
+        {
+            ASSERT_EQ(decodeNextFrame(*codec, encoded_frames, size, frame_start, frame),
+                      DecodeResult::INCOMPLETE) ;
+        }
+
+        ASSERT_EQ(decodeNextFrame(*codec, encoded_frames, encoded_frames.size(), frame_start, frame),
+                  DecodeResult::FRAME) ;
+        ASSERT_EQ(frame_start, frame_size) ;
+        ASSERT_EQ(DataBuffer(frame.data, frame.data + frame.size), payload) ;
+
+        ASSERT_EQ(decodeNextFrame(*codec, encoded_frames, encoded_frames.size(), frame_start, frame),
+                  DecodeResult::FRAME) ;
+        ASSERT_EQ(frame_start, encoded_frames.size()) ;
+        ASSERT_EQ(DataBuffer(frame.data, frame.data + frame.size), payload) ;
+    }
+
+    // A truncated COBS block is reported as invalid.
+    CobsCodec cobs_codec ;
+    DataBuffer bad_cobs_frame = {0x05, 'a', 'b', 0x00} ;
+    size_t bytes_consumed = 0 ;
+    ConstBuffer frame {} ;
+
+    ASSERT_EQ(cobs_codec.Decode(bad_cobs_frame.data(), bad_cobs_frame.size(), bytes_consumed, frame),
+              DecodeResult::INVALID) ;
+    ASSERT_EQ(bytes_consumed, bad_cobs_frame.size()) ;
+
+    // An unknown SLIP escape is reported as invalid, and the leading END
+    // sent by most encoders is skipped.
+    SlipCodec slip_codec ;
+    DataBuffer bad_slip_frame = {0xC0, 'a', 0xDB, 'b', 0xC0} ;
+
+    ASSERT_EQ(slip_codec.Decode(bad_slip_frame.data(), bad_slip_frame.size(), bytes_consumed, frame),
+              DecodeResult::SKIPPED) ;
+    ASSERT_EQ(bytes_consumed, 1U) ;
+    ASSERT_EQ(slip_codec.Decode(bad_slip_frame.data() + 1, bad_slip_frame.size() - 1, bytes_consumed, frame),
+              DecodeResult::INVALID) ;
+
+    // A delimiter split across reads is still found.
+    DelimiterCodec delimiter_codec("\r\n") ;
+    DataBuffer split_frame = {'a', 'b', '\r', '\n'} ;
+
+    ASSERT_EQ(delimiter_codec.Decode(split_frame.data(), 3, bytes_consumed, frame),
+              DecodeResult::INCOMPLETE) ;
+    ASSERT_EQ(delimiter_codec.Decode(split_frame.data(), 4, bytes_consumed, frame),
+              DecodeResult::FRAME) ;
+    ASSERT_EQ(frame.size, 2U) ;
+
+    // An oversized length is dropped a byte at a time.
+    LengthPrefixCodec length_codec(2, true, 16) ;
+    DataBuffer bad_length_frame = {0xFF, 0x00, 0x01, 'x'} ;
+
+    ASSERT_EQ(length_codec.Decode(bad_length_frame.data(), bad_length_frame.size(), bytes_consumed, frame),
+              DecodeResult::INVALID) ;
+    ASSERT_EQ(bytes_consumed, 1U) ;
+    ASSERT_EQ(length_codec.Decode(bad_length_frame.data() + 1, bad_length_frame.size() - 1, bytes_consumed, frame),
+              DecodeResult::FRAME) ;
+    ASSERT_EQ(frame.size, 1U) ;
+    ASSERT_EQ(frame.data[0], 'x') ;
+}
+
+void
+FrameReaderUnitTests::testFrameReaderReadFrame()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    CobsCodec cobs_codec ;
+    FrameReader frame_reader(serialPort2,
+                             std::unique_ptr<FrameCodec>(new CobsCodec()),
+                             1024) ;
+
+    // Several frames written at once, with some noise between them.
+    const auto payloads = getTestPayloads() ;
+    DataBuffer encoded_frames ;
+
+    for (const auto& payload : payloads)
+    {
+        cobs_codec.Encode(payload.data(), payload.size(), encoded_frames) ;
+    }
+
+    const DataBuffer bad_frame = {0x05, 'a', 0x00} ;
+    encoded_frames.insert(encoded_frames.end(), bad_frame.begin(), bad_frame.end()) ;
+    cobs_codec.Encode(payloads[0].data(), payloads[0].size(), encoded_frames) ;
+
+    serialPort1.Write(encoded_frames) ;
+
+    for (const auto& payload : payloads)
+    {
+        const auto frame = frame_reader.ReadFrame(timeOutMilliseconds) ;
+        ASSERT_EQ(DataBuffer(frame.data, frame.data + frame.size), payload) ;
+    }
+
+    DataBuffer frame_copy ;
+    frame_reader.ReadFrame(frame_copy, timeOutMilliseconds) ;
+    ASSERT_EQ(frame_copy, payloads[0]) ;
+    ASSERT_EQ(frame_reader.GetNumberOfInvalidFrames(), 1U) ;
+    ASSERT_EQ(frame_reader.GetNumberOfBufferedBytes(), 0U) ;
+
+    // A partial frame is kept when the read times out.
+    DataBuffer split_frame ;
+    cobs_codec.Encode(payloads[3].data(), payloads[3].size(), split_frame) ;
+
+    serialPort1.Write(DataBuffer(split_frame.begin(), split_frame.end() - 2)) ;
+    ASSERT_THROW(frame_reader.ReadFrame(10), ReadTimeout) ;
+
+    ConstBuffer frame {} ;
+    ASSERT_FALSE(frame_reader.TryReadFrame(frame)) ;
+    ASSERT_EQ(frame_reader.GetNumberOfBufferedBytes(), split_frame.size() - 2) ;
+
+    serialPort1.Write(DataBuffer(split_frame.end() - 2, split_frame.end())) ;
+    frame = frame_reader.ReadFrame(timeOutMilliseconds) ;
+    ASSERT_EQ(DataBuffer(frame.data, frame.data + frame.size), payloads[3]) ;
+
+    // A frame larger than the buffer is discarded.
+    const DataBuffer large_payload(2048, 'z') ;
+    DataBuffer large_frame ;
+    cobs_codec.Encode(large_payload.data(), large_payload.size(), large_frame) ;
+    cobs_codec.Encode(payloads[0].data(), payloads[0].size(), large_frame) ;
+
+    serialPort1.Write(large_frame) ;
+
+    frame_reader.ReadFrame(frame_copy, timeOutMilliseconds) ;
+    while (frame_copy != payloads[0])
+    {
+        frame_reader.ReadFrame(frame_copy, timeOutMilliseconds) ;
+    }
+
+    ASSERT_GT(frame_reader.GetNumberOfInvalidFrames(), 1U) ;
+
+    ASSERT_THROW(FrameReader(serialPort2, nullptr), std::invalid_argument) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+}
+
+TEST_F(FrameReaderUnitTests, testFrameCodecRoundTrip)
+{
+    SCOPED_TRACE("Frame Codec Round Trip Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testFrameCodecRoundTrip() ;
+    }
+}
+
+TEST_F(FrameReaderUnitTests, testFrameCodecPartialInput)
+{
+    SCOPED_TRACE("Frame Codec Partial Input Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testFrameCodecPartialInput() ;
+    }
+}
+
+TEST_F(FrameReaderUnitTests, testFrameReaderReadFrame)
+{
+    SCOPED_TRACE("Frame Reader Read Frame Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testFrameReaderReadFrame() ;
+    }
+}
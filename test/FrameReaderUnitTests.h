@@ -0,0 +1,103 @@
+/******************************************************************************
+ * @file FrameReaderUnitTests.h                                               *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include "UnitTests.h"
+#include "libserial/FrameReader.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+/**
+ * @namespace Libserial
+ */
+namespace LibSerial
+{
+    class FrameReaderUnitTests : public UnitTests
+    {
+    public:
+
+        /**
+         * @brief Default Constructor.
+         */
+        explicit FrameReaderUnitTests() = default ;
+
+        /**
+         * @brief Default Destructor.
+         */
+        virtual ~FrameReaderUnitTests() = default ;
+
+    protected:
+
+        /**
+         * @brief Tests that each codec decodes what it encodes, including
+         *        payloads made of the characters it has to escape.
+         */
+        void testFrameCodecRoundTrip() ;
+
+        /**
+         * @brief Tests decoding of frames that arrive a few bytes at a time,
+         *        and recovery from malformed frames.
+         */
+        void testFrameCodecPartialInput() ;
+
+        /**
+         * @brief Tests reading frames from a serial port with FrameReader.
+         */
+        void testFrameReaderReadFrame() ;
+
+        /**
+         * @brief Gets payloads exercising the corner cases of the codecs.
+         * @return Returns the test payloads.
+         */
+        static std::vector<DataBuffer> getTestPayloads() ;
+
+        /**
+         * @brief Decodes the next frame the way FrameReader does, skipping
+         *        bytes that carry no frame.
+         * @param frameCodec The codec used to decode the frame.
+         * @param data The encoded data.
+         * @param size The number of bytes of encoded data available.
+         * @param frameStart The offset of the next frame, advanced past
+         *        each frame or skipped byte consumed.
+         * @param frame Set to the decoded frame payload.
+         * @return Returns the outcome of decoding.
+         */
+        static DecodeResult decodeNextFrame(FrameCodec&  frameCodec,
+                                            DataBuffer&  data,
+                                            size_t       size,
+                                            size_t&      frameStart,
+                                            ConstBuffer& frame) ;
+    } ;
+}
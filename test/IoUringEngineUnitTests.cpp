@@ -0,0 +1,305 @@
+/******************************************************************************
+ * @file IoUringEngineUnitTests.cpp                                           *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "IoUringEngineUnitTests.h"
+#include "UnitTests.h"
+
+#include <chrono>
+#include <stdexcept>
+
+using namespace LibSerial;
+
+/**
+ * @brief Runs the engine until a condition is met or a timeout elapses.
+ * @param ioUringEngine The engine to run.
+ * @param condition The condition to wait for.
+ * @param msTimeout The timeout period in milliseconds.
+ * @return Returns true if the condition was met.
+ */
+template <typename ConditionType>
+static bool
+runUntil(IoUringEngine&       ioUringEngine,
+         const ConditionType& condition,
+         const size_t         msTimeout)
+{
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(msTimeout) ;
+
+    while (not condition())
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            return false ;
+        }
+
+        ioUringEngine.RunOnce(msTimeout / 10) ;
+    }
+
+    return true ;
+}
+
+void
+IoUringEngineUnitTests::testIoUringEngineReadWrite()
+{
+    if (not IoUringEngine::IsSupported())
+    {
+        ASSERT_THROW(IoUringEngine {}, std::runtime_error) ;
+        return ;
+    }
+
+    IoUringEngine io_uring_engine ;
+
+    SerialPort serial_port ;
+    ASSERT_THROW(io_uring_engine.Add(serial_port, {}), NotOpen) ;
+
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    std::string received_string ;
+    size_t number_of_writes_completed = 0 ;
+    size_t number_of_bytes_written = 0 ;
+
+    IoUringEngine::Callbacks callbacks ;
+    callbacks.dataReceived = [&received_string](IoUringEngine::PortId,
+                                                const uint8_t* dataBuffer,
+                                                size_t         numberOfBytes)
+    {
+        received_string.append(dataBuffer, dataBuffer + numberOfBytes) ;
+    } ;
+    callbacks.writeComplete = [&number_of_writes_completed,
+                               &number_of_bytes_written](IoUringEngine::PortId,
+                                                         size_t numberOfBytes,
+                                                         int    errorNumber)
+    {
+        ASSERT_EQ(errorNumber, 0) ;
+        number_of_writes_completed++ ;
+        number_of_bytes_written += numberOfBytes ;
+    } ;
+
+    const auto port_id = io_uring_engine.Add(serialPort2, callbacks) ;
+    ASSERT_EQ(io_uring_engine.GetNumberOfPorts(), 1u) ;
+
+    // Data is received through the armed read.
+    serialPort1.Write(writeString1) ;
+
+    ASSERT_TRUE(runUntil(io_uring_engine,
+                         [&]() { return received_string.size() >= writeString1.size() ; },
+                         timeOutMilliseconds)) ;
+    ASSERT_EQ(received_string, writeString1) ;
+
+    // A drained write.
+    io_uring_engine.Write(port_id, writeString2, true) ;
+
+    ASSERT_TRUE(runUntil(io_uring_engine,
+                         [&]() { return number_of_writes_completed == 1 ; },
+                         timeOutMilliseconds)) ;
+    ASSERT_EQ(number_of_bytes_written, writeString2.size()) ;
+
+    std::string read_string ;
+    serialPort1.Read(read_string, writeString2.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(read_string, writeString2) ;
+
+    // Writes queued together complete in order.
+    const std::string ordered_string = "0123456789" ;
+
+    for (const auto character : ordered_string)
+    {
+        io_uring_engine.Write(port_id, std::string(1, character)) ;
+    }
+
+    ASSERT_TRUE(runUntil(io_uring_engine,
+                         [&]() { return number_of_writes_completed == 1 + ordered_string.size() ; },
+                         timeOutMilliseconds)) ;
+
+    serialPort1.Read(read_string, ordered_string.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(read_string, ordered_string) ;
+
+    // A removed port is no longer read by the engine, but remains usable.
+    io_uring_engine.Remove(port_id) ;
+    ASSERT_EQ(io_uring_engine.GetNumberOfPorts(), 0u) ;
+    ASSERT_THROW(io_uring_engine.Write(port_id, writeString2), std::invalid_argument) ;
+    ASSERT_THROW(io_uring_engine.Remove(port_id), std::invalid_argument) ;
+
+    serialPort1.Write(writeString1) ;
+    serialPort2.Read(read_string, writeString1.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(read_string, writeString1) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
+void
+IoUringEngineUnitTests::testIoUringEngineBatchedSubmission()
+{
+    if (not IoUringEngine::IsSupported())
+    {
+        return ;
+    }
+
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    {
+        IoUringEngine io_uring_engine ;
+
+        std::string received_string1 ;
+        std::string received_string2 ;
+
+        IoUringEngine::Callbacks callbacks1 ;
+        callbacks1.dataReceived = [&received_string1](IoUringEngine::PortId,
+                                                      const uint8_t* dataBuffer,
+                                                      size_t         numberOfBytes)
+        {
+            received_string1.append(dataBuffer, dataBuffer + numberOfBytes) ;
+        } ;
+
+        IoUringEngine::Callbacks callbacks2 ;
+        callbacks2.dataReceived = [&received_string2](IoUringEngine::PortId,
+                                                      const uint8_t* dataBuffer,
+                                                      size_t         numberOfBytes)
+        {
+            received_string2.append(dataBuffer, dataBuffer + numberOfBytes) ;
+        } ;
+
+        const auto port_id1 = io_uring_engine.Add(serialPort1, callbacks1) ;
+        const auto port_id2 = io_uring_engine.Add(serialPort2, callbacks2) ;
+
+        io_uring_engine.Write(port_id1, writeString1) ;
+        io_uring_engine.Write(port_id2, writeString2) ;
+
+        // Both reads and both writes go out with a single system call.
+        const auto number_of_system_calls = io_uring_engine.GetNumberOfSystemCalls() ;
+        ASSERT_EQ(io_uring_engine.Submit(), 4u) ;
+        ASSERT_EQ(io_uring_engine.GetNumberOfSystemCalls(), number_of_system_calls + 1) ;
+
+        ASSERT_TRUE(runUntil(io_uring_engine,
+                             [&]()
+                             {
+                                 return (received_string1.size() >= writeString2.size()) and
+                                        (received_string2.size() >= writeString1.size()) ;
+                             },
+                             timeOutMilliseconds)) ;
+
+        ASSERT_EQ(received_string1, writeString2) ;
+        ASSERT_EQ(received_string2, writeString1) ;
+
+        // Data received in bursts needs far fewer system calls than bytes.
+        constexpr size_t number_of_messages = 10 ;
+        const std::string message_string(50, 'x') ;
+
+        received_string1.clear() ;
+
+        const auto burst_system_calls = io_uring_engine.GetNumberOfSystemCalls() ;
+
+        for (size_t i = 0; i < number_of_messages; i++)
+        {
+            io_uring_engine.Write(port_id2, message_string) ;
+        }
+
+        ASSERT_TRUE(runUntil(io_uring_engine,
+                             [&]() { return received_string1.size() >= number_of_messages * message_string.size() ; },
+                             timeOutMilliseconds)) ;
+
+        ASSERT_EQ(received_string1.size(), number_of_messages * message_string.size()) ;
+        ASSERT_LT(io_uring_engine.GetNumberOfSystemCalls() - burst_system_calls,
+                  received_string1.size() / 10) ;
+    }
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
+void
+IoUringEngineUnitTests::testIoUringEngineInvalidPolicy()
+{
+    if (not IoUringEngine::IsSupported())
+    {
+        return ;
+    }
+
+    IoUringEnginePolicy io_uring_engine_policy ;
+    io_uring_engine_policy.numberOfBuffers = 3 ;
+    ASSERT_THROW(IoUringEngine {io_uring_engine_policy}, std::invalid_argument) ;
+
+    io_uring_engine_policy.numberOfBuffers = 65536 ;
+    ASSERT_THROW(IoUringEngine {io_uring_engine_policy}, std::invalid_argument) ;
+
+    io_uring_engine_policy.numberOfBuffers = 16 ;
+    io_uring_engine_policy.bufferSize = 0 ;
+    ASSERT_THROW(IoUringEngine {io_uring_engine_policy}, std::invalid_argument) ;
+
+    io_uring_engine_policy.bufferSize = 64 ;
+    ASSERT_NO_THROW(IoUringEngine {io_uring_engine_policy}) ;
+}
+
+TEST_F(IoUringEngineUnitTests, testIoUringEngineReadWrite)
+{
+    SCOPED_TRACE("IoUringEngine Read Write Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testIoUringEngineReadWrite() ;
+    }
+}
+
+TEST_F(IoUringEngineUnitTests, testIoUringEngineBatchedSubmission)
+{
+    SCOPED_TRACE("IoUringEngine Batched Submission Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testIoUringEngineBatchedSubmission() ;
+    }
+}
+
+TEST_F(IoUringEngineUnitTests, testIoUringEngineInvalidPolicy)
+{
+    SCOPED_TRACE("IoUringEngine Invalid Policy Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testIoUringEngineInvalidPolicy() ;
+    }
+}
@@ -34,6 +34,7 @@
 #include "MultiThreadUnitTests.h"
 #include "UnitTests.h"
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <thread>
@@ -270,6 +271,145 @@ MultiThreadUnitTests::testMultiThreadSerialPortReadWrite()
     serialPort2.Close() ;
 }
 
+void
+MultiThreadUnitTests::testMultiThreadSerialPortConcurrentMode()
+{
+    constexpr size_t number_of_lines = 20 ;
+
+    ASSERT_FALSE(serialPort1.IsConcurrentMode()) ;
+
+    serialPort1.SetConcurrentMode(true) ;
+    serialPort2.SetConcurrentMode(true) ;
+
+    ASSERT_TRUE(serialPort1.IsConcurrentMode()) ;
+
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    // Discard any data still in transit from an earlier test, as the lines
+    // are checked from the first byte received.
+    usleep(readBufferDelay) ;
+    serialPort1.FlushIOBuffers() ;
+    serialPort2.FlushIOBuffers() ;
+
+    std::atomic<size_t> number_of_failures {0} ;
+    std::atomic<bool> is_running {true} ;
+
+    const auto write_lines = [](SerialPort&        serialPort,
+                                const std::string& dataString)
+    {
+        for (size_t i = 0; i < number_of_lines; i++)
+        {
+            serialPort.Write(dataString + '\n') ;
+        }
+    } ;
+
+    const auto read_lines = [&number_of_failures, this](SerialPort&        serialPort,
+                                                        const std::string& dataString)
+    {
+        std::string line {} ;
+
+        for (size_t i = 0; i < number_of_lines; i++)
+        {
+            try
+            {
+                serialPort.ReadLine(line, '\n', timeOutMilliseconds * 4) ;
+            }
+            catch (const ReadTimeout&)
+            {
+                number_of_failures++ ;
+                return ;
+            }
+
+            if (line != dataString + '\n')
+            {
+                number_of_failures++ ;
+            }
+        }
+    } ;
+
+    const auto query_settings = [&number_of_failures, &is_running](SerialPort& serialPort)
+    {
+        while (is_running)
+        {
+            if (serialPort.GetBaudRate() != BaudRate::BAUD_DEFAULT)
+            {
+                number_of_failures++ ;
+            }
+        }
+    } ;
+
+    std::thread read_thread_1(read_lines, std::ref(serialPort1), std::cref(writeString2)) ;
+    std::thread read_thread_2(read_lines, std::ref(serialPort2), std::cref(writeString1)) ;
+    std::thread write_thread_1(write_lines, std::ref(serialPort1), std::cref(writeString1)) ;
+    std::thread write_thread_2(write_lines, std::ref(serialPort2), std::cref(writeString2)) ;
+    std::thread query_thread(query_settings, std::ref(serialPort1)) ;
+
+    write_thread_1.join() ;
+    write_thread_2.join() ;
+    read_thread_1.join() ;
+    read_thread_2.join() ;
+
+    is_running = false ;
+    query_thread.join() ;
+
+    ASSERT_EQ(number_of_failures, 0u) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+
+    serialPort1.SetConcurrentMode(false) ;
+    serialPort2.SetConcurrentMode(false) ;
+}
+
+void
+MultiThreadUnitTests::testMultiThreadSerialPortCloseUnblocksRead()
+{
+    serialPort1.SetConcurrentMode(true) ;
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort1.FlushIOBuffers() ;
+
+    std::atomic<bool> is_not_open {false} ;
+
+    std::thread read_thread([&is_not_open, this]()
+                            {
+                                uint8_t read_buffer[1] {} ;
+
+                                try
+                                {
+                                    serialPort1.Read(read_buffer, sizeof(read_buffer), 0) ;
+                                }
+                                catch (const NotOpen&)
+                                {
+                                    is_not_open = true ;
+                                }
+                            }) ;
+
+    // Give the reader time to block in poll().
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)) ;
+
+    serialPort1.Close() ;
+    read_thread.join() ;
+
+    ASSERT_TRUE(is_not_open) ;
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+
+    // A later open is not woken by the earlier Close().
+    serialPort1.Open(SERIAL_PORT_1) ;
+
+    uint8_t read_buffer[1] {} ;
+    ASSERT_THROW(serialPort1.Read(read_buffer, sizeof(read_buffer), 1), ReadTimeout) ;
+
+    serialPort1.Close() ;
+    serialPort1.SetConcurrentMode(false) ;
+}
+
 TEST_F(MultiThreadUnitTests, testMultiThreadSerialStreamReadWrite)
 {
     SCOPED_TRACE("Test Multi-Thread Serial Stream Communication.") ;
@@ -319,3 +459,23 @@ TEST_F(MultiThreadUnitTests, testMultiThreadSerialPortReadWrite)
         ADD_FAILURE() ;
     }
 }
+
+TEST_F(MultiThreadUnitTests, testMultiThreadSerialPortConcurrentMode)
+{
+    SCOPED_TRACE("Test Multi-Thread Serial Port Concurrent Mode.") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testMultiThreadSerialPortConcurrentMode() ;
+    }
+}
+
+TEST_F(MultiThreadUnitTests, testMultiThreadSerialPortCloseUnblocksRead)
+{
+    SCOPED_TRACE("Test Multi-Thread Serial Port Close Unblocks Read.") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testMultiThreadSerialPortCloseUnblocksRead() ;
+    }
+}
@@ -91,6 +91,20 @@ namespace LibSerial
          */
         void testMultiThreadSerialPortReadWrite() ;
 
+        /**
+         * @brief Tests for correct functionality of full-duplex traffic on a
+         *        serial port in concurrent mode, with one thread reading, one
+         *        writing and one querying the settings of each serial port.
+         */
+        void testMultiThreadSerialPortConcurrentMode() ;
+
+        /**
+         * @brief Tests that closing a serial port in concurrent mode wakes a
+         *        thread blocked in a read without a timeout, which then
+         *        throws NotOpen.
+         */
+        void testMultiThreadSerialPortCloseUnblocksRead() ;
+
         /**
          * @param C++11 thread std::mutex for locking parameters in the threaded unit tests.
          */
@@ -0,0 +1,473 @@
+/******************************************************************************
+ * @file ResilientSerialPortUnitTests.cpp                                     *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "ResilientSerialPortUnitTests.h"
+
+#include <chrono>
+#include <fstream>
+#include <ftw.h>
+#include <poll.h>
+#include <pty.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace LibSerial;
+
+ResilientSerialPortUnitTests::ResilientSerialPortUnitTests()
+{
+    std::string root_template = "/tmp/libserial-resilient-XXXXXX" ;
+
+    if (mkdtemp(&root_template[0]) == nullptr)
+    {
+        throw std::runtime_error("Unable to create the fake sysfs directory.") ;
+    }
+
+    rootDirectory = root_template ;
+
+    const auto usb_device = rootDirectory + "/devices/usb1/1-1" ;
+
+    for (const auto& directory : {rootDirectory + "/devices",
+                                  rootDirectory + "/devices/usb1",
+                                  usb_device,
+                                  usb_device + "/1-1:1.0",
+                                  rootDirectory + "/class",
+                                  rootDirectory + "/class/tty",
+                                  rootDirectory + "/dev"})
+    {
+        mkdir(directory.c_str(), S_IRWXU) ;
+    }
+
+    std::ofstream(usb_device + "/idVendor") << "0403\n" ;
+    std::ofstream(usb_device + "/idProduct") << "6001\n" ;
+    std::ofstream(usb_device + "/serial") << deviceSerialNumber << '\n' ;
+}
+
+ResilientSerialPortUnitTests::~ResilientSerialPortUnitTests()
+{
+    unplugDevice() ;
+
+    nftw(rootDirectory.c_str(),
+         [](const char* fileName, const struct stat*, int, FTW*)
+         {
+             return remove(fileName) ;
+         },
+         16,
+         FTW_DEPTH | FTW_PHYS) ;
+}
+
+void
+ResilientSerialPortUnitTests::plugDevice(const std::string& newDeviceName)
+{
+    int slave_fd = -1 ;
+    char slave_name[256] {} ;
+
+    struct termios raw_settings {} ;
+    cfmakeraw(&raw_settings) ;
+
+    if (openpty(&masterFileDescriptor, &slave_fd, slave_name, &raw_settings, nullptr) < 0)
+    {
+        throw std::runtime_error("Unable to create a pseudo-terminal.") ;
+    }
+
+    // The port opens the slave by its device node, as it would a real
+    // adapter.
+    close(slave_fd) ;
+
+    deviceName = newDeviceName ;
+
+    const auto usb_tty = rootDirectory + "/devices/usb1/1-1/1-1:1.0/" + deviceName ;
+    const auto tty_class_entry = rootDirectory + "/class/tty/" + deviceName ;
+
+    mkdir(usb_tty.c_str(), S_IRWXU) ;
+    mkdir(tty_class_entry.c_str(), S_IRWXU) ;
+    symlink(usb_tty.c_str(), (tty_class_entry + "/device").c_str()) ;
+    symlink(slave_name, (rootDirectory + "/dev/" + deviceName).c_str()) ;
+}
+
+void
+ResilientSerialPortUnitTests::unplugDevice()
+{
+    if (masterFileDescriptor < 0)
+    {
+        return ;
+    }
+
+    // Closing the master hangs up the slave, as the removal of a USB
+    // serial adapter does.
+    close(masterFileDescriptor) ;
+    masterFileDescriptor = -1 ;
+
+    const auto tty_class_entry = rootDirectory + "/class/tty/" + deviceName ;
+
+    unlink((rootDirectory + "/dev/" + deviceName).c_str()) ;
+    unlink((tty_class_entry + "/device").c_str()) ;
+    rmdir(tty_class_entry.c_str()) ;
+    rmdir((rootDirectory + "/devices/usb1/1-1/1-1:1.0/" + deviceName).c_str()) ;
+
+    deviceName.clear() ;
+}
+
+void
+ResilientSerialPortUnitTests::writeToDevice(const std::string& dataString) const
+{
+    ASSERT_EQ(write(masterFileDescriptor, dataString.data(), dataString.size()),
+              static_cast<ssize_t>(dataString.size())) ;
+}
+
+std::string
+ResilientSerialPortUnitTests::readFromDevice(const size_t numberOfBytes) const
+{
+    std::string data_string ;
+    char read_buffer[256] {} ;
+
+    while (data_string.size() < numberOfBytes)
+    {
+        pollfd poll_fd {masterFileDescriptor, POLLIN, 0} ;
+
+        if (poll(&poll_fd, 1, static_cast<int>(timeOutMilliseconds)) <= 0)
+        {
+            break ;
+        }
+
+        const auto result = read(masterFileDescriptor,
+                                 read_buffer,
+                                 std::min(sizeof(read_buffer), numberOfBytes - data_string.size())) ;
+
+        if (result <= 0)
+        {
+            break ;
+        }
+
+        data_string.append(read_buffer, static_cast<size_t>(result)) ;
+    }
+
+    return data_string ;
+}
+
+void
+ResilientSerialPortUnitTests::testResilientSerialPortReconnect()
+{
+    ResilientSerialPort resilient_serial_port(rootDirectory + "/class/tty",
+                                              rootDirectory + "/dev") ;
+
+    // The device must be present to be opened.
+    ASSERT_THROW(resilient_serial_port.Open(deviceSerialNumber), OpenFailed) ;
+    ASSERT_FALSE(resilient_serial_port.IsOpen()) ;
+
+    plugDevice("ttyUSB0") ;
+
+    PortSettings port_settings ;
+    port_settings.baudRate = BaudRate::BAUD_57600 ;
+
+    resilient_serial_port.Open(deviceSerialNumber, port_settings) ;
+
+    ASSERT_TRUE(resilient_serial_port.IsOpen()) ;
+    ASSERT_TRUE(resilient_serial_port.IsConnected()) ;
+    ASSERT_EQ(resilient_serial_port.GetDevicePath(), rootDirectory + "/dev/ttyUSB0") ;
+    ASSERT_THROW(resilient_serial_port.Open(deviceSerialNumber), AlreadyOpen) ;
+
+    resilient_serial_port.Write(writeString1) ;
+    ASSERT_EQ(readFromDevice(writeString1.size()), writeString1) ;
+
+    writeToDevice(writeString1) ;
+
+    DataBuffer read_buffer ;
+    resilient_serial_port.Read(read_buffer, writeString1.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(std::string(read_buffer.begin(), read_buffer.end()), writeString1) ;
+
+    // A read times out while the device is gone.
+    unplugDevice() ;
+
+    char read_byte = 0 ;
+    ASSERT_THROW(resilient_serial_port.ReadByte(read_byte, 50), ReadTimeout) ;
+    ASSERT_FALSE(resilient_serial_port.IsConnected()) ;
+    ASSERT_TRUE(resilient_serial_port.IsOpen()) ;
+    ASSERT_TRUE(resilient_serial_port.GetDevicePath().empty()) ;
+    ASSERT_FALSE(resilient_serial_port.WaitForReconnect(20)) ;
+
+    // The device reappears under another name, and a read picks it up,
+    // with the cached settings applied, well within its timeout.
+    plugDevice("ttyUSB1") ;
+
+    const auto device_path = rootDirectory + "/dev/ttyUSB1" ;
+    std::thread remote_writer([this]()
+                              {
+                                  std::this_thread::sleep_for(std::chrono::milliseconds(100)) ;
+                                  writeToDevice(writeString1) ;
+                              }) ;
+
+    const auto reconnect_start = std::chrono::steady_clock::now() ;
+    resilient_serial_port.Read(read_buffer, writeString1.size(), 1000) ;
+    remote_writer.join() ;
+
+    ASSERT_EQ(std::string(read_buffer.begin(), read_buffer.end()), writeString1) ;
+    ASSERT_LT(std::chrono::steady_clock::now() - reconnect_start, std::chrono::milliseconds(500)) ;
+    ASSERT_TRUE(resilient_serial_port.IsConnected()) ;
+    ASSERT_EQ(resilient_serial_port.GetDevicePath(), device_path) ;
+    ASSERT_EQ(resilient_serial_port.GetNumberOfReconnects(), 1U) ;
+    ASSERT_EQ(resilient_serial_port.GetSerialPortParameters().baudRate, BaudRate::BAUD_57600) ;
+
+    // Without a replay queue, writes to a disconnected port fail.
+    unplugDevice() ;
+    ASSERT_THROW(resilient_serial_port.Write(writeString1), std::runtime_error) ;
+    ASSERT_FALSE(resilient_serial_port.IsConnected()) ;
+
+    resilient_serial_port.Close() ;
+    ASSERT_FALSE(resilient_serial_port.IsOpen()) ;
+
+    ASSERT_THROW(resilient_serial_port.Read(read_buffer, 1), NotOpen) ;
+    ASSERT_THROW(resilient_serial_port.Write(writeString1), NotOpen) ;
+    ASSERT_THROW(resilient_serial_port.WaitForReconnect(), NotOpen) ;
+}
+
+void
+ResilientSerialPortUnitTests::testResilientSerialPortReplayQueue()
+{
+    ResilientSerialPort resilient_serial_port(rootDirectory + "/class/tty",
+                                              rootDirectory + "/dev") ;
+
+    plugDevice("ttyUSB0") ;
+    resilient_serial_port.Open(deviceSerialNumber) ;
+    resilient_serial_port.SetReplayQueueSize(16) ;
+    ASSERT_EQ(resilient_serial_port.GetReplayQueueSize(), 16U) ;
+
+    unplugDevice() ;
+
+    // The first write finds the device gone and is queued, as are the
+    // following ones, until the oldest have to make room.
+    resilient_serial_port.Write(std::string("12345678")) ;
+    resilient_serial_port.Write(std::string("abcdefgh")) ;
+    ASSERT_FALSE(resilient_serial_port.IsConnected()) ;
+    ASSERT_EQ(resilient_serial_port.GetNumberOfBytesQueued(), 16U) ;
+    ASSERT_EQ(resilient_serial_port.GetNumberOfBytesDropped(), 0U) ;
+
+    resilient_serial_port.Write(std::string("ABCD")) ;
+    ASSERT_EQ(resilient_serial_port.GetNumberOfBytesQueued(), 12U) ;
+    ASSERT_EQ(resilient_serial_port.GetNumberOfBytesDropped(), 8U) ;
+
+    // A write too large for the queue is dropped entirely.
+    resilient_serial_port.Write(writeString1) ;
+    ASSERT_EQ(resilient_serial_port.GetNumberOfBytesQueued(), 12U) ;
+    ASSERT_EQ(resilient_serial_port.GetNumberOfBytesDropped(), 8U + writeString1.size()) ;
+
+    // The queued writes are sent, in order, as soon as the device is back.
+    plugDevice("ttyUSB0") ;
+    ASSERT_TRUE(resilient_serial_port.WaitForReconnect(timeOutMilliseconds)) ;
+    ASSERT_EQ(resilient_serial_port.GetNumberOfBytesQueued(), 0U) ;
+    ASSERT_EQ(readFromDevice(12), "abcdefghABCD") ;
+
+    // Writes go straight to the device again.
+    resilient_serial_port.Write(std::string("xyz")) ;
+    ASSERT_EQ(readFromDevice(3), "xyz") ;
+
+    // Shrinking the queue drops the oldest writes.
+    unplugDevice() ;
+    resilient_serial_port.Write(std::string("12345678")) ;
+    resilient_serial_port.Write(std::string("abcd")) ;
+    resilient_serial_port.SetReplayQueueSize(4) ;
+    ASSERT_EQ(resilient_serial_port.GetNumberOfBytesQueued(), 4U) ;
+
+    // A write made once the device is back reconnects without waiting
+    // for a read, after the queued data.
+    plugDevice("ttyUSB2") ;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2 * RECONNECT_SCAN_INTERVAL_MS)) ;
+    resilient_serial_port.Write(std::string("efgh")) ;
+    ASSERT_TRUE(resilient_serial_port.IsConnected()) ;
+    ASSERT_EQ(readFromDevice(8), "abcdefgh") ;
+    ASSERT_EQ(resilient_serial_port.GetNumberOfReconnects(), 2U) ;
+
+    resilient_serial_port.Close() ;
+    unplugDevice() ;
+}
+
+void
+ResilientSerialPortUnitTests::testResilientSerialPortCustomBitRate()
+{
+    ResilientSerialPort resilient_serial_port(rootDirectory + "/class/tty",
+                                              rootDirectory + "/dev") ;
+
+    plugDevice("ttyUSB0") ;
+
+    // Settings that cannot be applied fail the open instead of being
+    // taken for a device that is not ready yet.
+    PortSettings port_settings ;
+    port_settings.baudRate = BaudRate::BAUD_INVALID ;
+    ASSERT_THROW(resilient_serial_port.Open(deviceSerialNumber, port_settings), std::invalid_argument) ;
+    ASSERT_FALSE(resilient_serial_port.IsOpen()) ;
+
+    port_settings.baudRate = BaudRate::BAUD_19200 ;
+    resilient_serial_port.Open(deviceSerialNumber, port_settings) ;
+
+    port_settings.baudRate = BaudRate::BAUD_INVALID ;
+    ASSERT_THROW(resilient_serial_port.SetSerialPortParameters(port_settings), std::invalid_argument) ;
+    ASSERT_THROW(resilient_serial_port.SetBitRate(0), std::invalid_argument) ;
+    ASSERT_EQ(resilient_serial_port.GetSerialPortParameters().baudRate, BaudRate::BAUD_19200) ;
+
+    constexpr speed_t bit_rate = 250000 ;
+    resilient_serial_port.SetBitRate(bit_rate) ;
+    ASSERT_EQ(resilient_serial_port.GetSerialPort().GetBitRate(), bit_rate) ;
+    ASSERT_EQ(resilient_serial_port.GetSerialPortParameters().baudRate, BaudRate::BAUD_INVALID) ;
+
+    unplugDevice() ;
+
+    char read_byte = 0 ;
+    ASSERT_THROW(resilient_serial_port.ReadByte(read_byte, 50), ReadTimeout) ;
+    ASSERT_FALSE(resilient_serial_port.IsConnected()) ;
+
+    plugDevice("ttyUSB1") ;
+    ASSERT_TRUE(resilient_serial_port.WaitForReconnect(timeOutMilliseconds)) ;
+    ASSERT_EQ(resilient_serial_port.GetSerialPort().GetBitRate(), bit_rate) ;
+
+    // The bit rate is kept across further reconnections.
+    unplugDevice() ;
+    ASSERT_THROW(resilient_serial_port.ReadByte(read_byte, 50), ReadTimeout) ;
+
+    plugDevice("ttyUSB0") ;
+    ASSERT_TRUE(resilient_serial_port.WaitForReconnect(timeOutMilliseconds)) ;
+    ASSERT_EQ(resilient_serial_port.GetSerialPort().GetBitRate(), bit_rate) ;
+    ASSERT_EQ(resilient_serial_port.GetNumberOfReconnects(), 2U) ;
+
+    // A baud rate replaces the bit rate for later reconnections.
+    port_settings.baudRate = BaudRate::BAUD_38400 ;
+    resilient_serial_port.SetSerialPortParameters(port_settings) ;
+
+    unplugDevice() ;
+    ASSERT_THROW(resilient_serial_port.ReadByte(read_byte, 50), ReadTimeout) ;
+
+    plugDevice("ttyUSB1") ;
+    ASSERT_TRUE(resilient_serial_port.WaitForReconnect(timeOutMilliseconds)) ;
+    ASSERT_EQ(resilient_serial_port.GetSerialPortParameters().baudRate, BaudRate::BAUD_38400) ;
+
+    resilient_serial_port.Close() ;
+    unplugDevice() ;
+}
+
+void
+ResilientSerialPortUnitTests::testResilientSerialPortPartialWrite()
+{
+    ResilientSerialPort resilient_serial_port(rootDirectory + "/class/tty",
+                                              rootDirectory + "/dev") ;
+
+    // Far more than the pseudo-terminal buffers, so that the write is
+    // still in progress when the device is unplugged.
+    constexpr size_t number_of_bytes = 1024 * 1024 ;
+
+    std::string write_string(number_of_bytes, '\0') ;
+
+    for (size_t i = 0; i < number_of_bytes; i++)
+    {
+        write_string[i] = static_cast<char>('a' + (i * 7) % 26) ;
+    }
+
+    plugDevice("ttyUSB0") ;
+    resilient_serial_port.Open(deviceSerialNumber) ;
+    resilient_serial_port.SetReplayQueueSize(number_of_bytes) ;
+
+    std::thread unplug_thread([this]
+                              {
+                                  std::this_thread::sleep_for(std::chrono::milliseconds(100)) ;
+                                  unplugDevice() ;
+                              }) ;
+
+    resilient_serial_port.Write(write_string) ;
+    unplug_thread.join() ;
+
+    // Only the bytes the driver had not accepted are queued.
+    const auto number_of_bytes_queued = resilient_serial_port.GetNumberOfBytesQueued() ;
+    ASSERT_FALSE(resilient_serial_port.IsConnected()) ;
+    ASSERT_GT(number_of_bytes_queued, 0U) ;
+    ASSERT_LT(number_of_bytes_queued, number_of_bytes) ;
+    ASSERT_EQ(resilient_serial_port.GetNumberOfBytesDropped(), 0U) ;
+
+    // The replay blocks until the device has taken the queued bytes, so
+    // they are read while the port reconnects.
+    plugDevice("ttyUSB1") ;
+
+    std::string read_string ;
+    std::thread read_thread([this, &read_string, number_of_bytes_queued]
+                            {
+                                read_string = readFromDevice(number_of_bytes_queued) ;
+                            }) ;
+
+    const auto is_reconnected = resilient_serial_port.WaitForReconnect(timeOutMilliseconds) ;
+    read_thread.join() ;
+
+    ASSERT_TRUE(is_reconnected) ;
+    ASSERT_EQ(resilient_serial_port.GetNumberOfBytesQueued(), 0U) ;
+    ASSERT_EQ(read_string, write_string.substr(number_of_bytes - number_of_bytes_queued)) ;
+
+    resilient_serial_port.Close() ;
+    unplugDevice() ;
+}
+
+TEST_F(ResilientSerialPortUnitTests, testResilientSerialPortReconnect)
+{
+    SCOPED_TRACE("ResilientSerialPort Reconnect Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testResilientSerialPortReconnect() ;
+    }
+}
+
+TEST_F(ResilientSerialPortUnitTests, testResilientSerialPortReplayQueue)
+{
+    SCOPED_TRACE("ResilientSerialPort Replay Queue Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testResilientSerialPortReplayQueue() ;
+    }
+}
+
+TEST_F(ResilientSerialPortUnitTests, testResilientSerialPortCustomBitRate)
+{
+    SCOPED_TRACE("ResilientSerialPort Custom Bit Rate Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testResilientSerialPortCustomBitRate() ;
+    }
+}
+
+TEST_F(ResilientSerialPortUnitTests, testResilientSerialPortPartialWrite)
+{
+    SCOPED_TRACE("ResilientSerialPort Partial Write Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testResilientSerialPortPartialWrite() ;
+    }
+}
@@ -0,0 +1,138 @@
+/******************************************************************************
+ * @file ResilientSerialPortUnitTests.h                                       *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include "UnitTests.h"
+#include "libserial/ResilientSerialPort.h"
+
+#include <gtest/gtest.h>
+
+/**
+ * @namespace Libserial
+ */
+namespace LibSerial
+{
+    class ResilientSerialPortUnitTests : public UnitTests
+    {
+    public:
+
+        /**
+         * @brief Default Constructor. Creates fake sysfs and device node
+         *        directories in which pseudo-terminals stand in for a USB
+         *        serial adapter that can be unplugged and plugged in again.
+         */
+        explicit ResilientSerialPortUnitTests() ;
+
+        /**
+         * @brief Default Destructor. Unplugs the device and removes the
+         *        fake directories.
+         */
+        virtual ~ResilientSerialPortUnitTests() ;
+
+    protected:
+
+        /**
+         * @brief Tests opening the device by serial number, reading and
+         *        writing while it is connected, and reads waiting across a
+         *        disconnection.
+         */
+        void testResilientSerialPortReconnect() ;
+
+        /**
+         * @brief Tests that writes made while the device is disconnected
+         *        are replayed when it reconnects, within the bounds of the
+         *        replay queue.
+         */
+        void testResilientSerialPortReplayQueue() ;
+
+        /**
+         * @brief Tests that a bit rate set with SetBitRate() survives a
+         *        reconnection, and that invalid settings are reported
+         *        instead of retried.
+         */
+        void testResilientSerialPortCustomBitRate() ;
+
+        /**
+         * @brief Tests that a write interrupted by a disconnection replays
+         *        only the bytes the device had not yet accepted.
+         */
+        void testResilientSerialPortPartialWrite() ;
+
+        /**
+         * @brief Plugs in the device under the specified device name,
+         *        backed by a new pseudo-terminal.
+         * @param deviceName The kernel device name, (e.g. "ttyUSB0").
+         */
+        void plugDevice(const std::string& deviceName) ;
+
+        /**
+         * @brief Unplugs the device, hanging up its pseudo-terminal.
+         */
+        void unplugDevice() ;
+
+        /**
+         * @brief Writes data to the remote end of the device.
+         * @param dataString The data to write.
+         */
+        void writeToDevice(const std::string& dataString) const ;
+
+        /**
+         * @brief Reads data sent to the remote end of the device.
+         * @param numberOfBytes The number of bytes to read.
+         * @return Returns the data read, which is shorter than requested if
+         *         it did not arrive within timeOutMilliseconds.
+         */
+        std::string readFromDevice(size_t numberOfBytes) const ;
+
+        /**
+         * @var The USB serial number of the device.
+         */
+        const std::string deviceSerialNumber {"LS0RECON"} ;
+
+        /**
+         * @var The root of the fake sysfs and device node directories.
+         */
+        std::string rootDirectory {} ;
+
+        /**
+         * @var The name the device is currently plugged in under.
+         */
+        std::string deviceName {} ;
+
+        /**
+         * @var The master side of the current pseudo-terminal, or -1.
+         */
+        int masterFileDescriptor = -1 ;
+    } ;
+}
@@ -0,0 +1,278 @@
+/******************************************************************************
+ * @file SerialCaptureUnitTests.cpp                                           *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "SerialCaptureUnitTests.h"
+#include "UnitTests.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace LibSerial;
+
+SerialCaptureUnitTests::SerialCaptureUnitTests()
+{
+    std::string file_template = "/tmp/libserial-capture-XXXXXX" ;
+
+    const auto file_descriptor = mkstemp(&file_template[0]) ;
+
+    if (file_descriptor < 0)
+    {
+        throw std::runtime_error("Unable to create the capture file.") ;
+    }
+
+    close(file_descriptor) ;
+    captureFileName = file_template ;
+}
+
+SerialCaptureUnitTests::~SerialCaptureUnitTests()
+{
+    unlink(captureFileName.c_str()) ;
+}
+
+void
+SerialCaptureUnitTests::testSerialCaptureCaptureAndReplay()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    const std::string line_string = "capture line\n" ;
+    const DataBuffer data_buffer {0x00, 0x55, 0xAA, 0xFF, 0x0A} ;
+
+    std::string received_line ;
+    DataBuffer received_data ;
+    std::string written_string ;
+
+    {
+        CaptureTap capture_tap(serialPort2, captureFileName) ;
+
+        serialPort1.Write(line_string) ;
+        capture_tap.ReadLine(received_line, '\n', timeOutMilliseconds) ;
+        ASSERT_EQ(received_line, line_string) ;
+
+        capture_tap.Write(writeString2) ;
+        serialPort1.Read(written_string, writeString2.size(), timeOutMilliseconds) ;
+        ASSERT_EQ(written_string, writeString2) ;
+
+        serialPort1.Write(data_buffer) ;
+        capture_tap.Read(received_data, data_buffer.size(), timeOutMilliseconds) ;
+        ASSERT_EQ(received_data, data_buffer) ;
+
+        // Data received before a timeout is recorded too.
+        serialPort1.WriteByte('x') ;
+        ASSERT_THROW(capture_tap.Read(received_data, 2, timeOutMilliseconds), ReadTimeout) ;
+        ASSERT_EQ(received_data.size(), 1u) ;
+
+        ASSERT_EQ(capture_tap.GetNumberOfRecords(), 4u) ;
+    }
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+
+    // The capture file holds only the records made.
+    struct stat file_status {} ;
+    ASSERT_EQ(stat(captureFileName.c_str(), &file_status), 0) ;
+    ASSERT_LT(static_cast<size_t>(file_status.st_size), CAPTURE_FILE_SIZE_DEFAULT) ;
+
+    ReplayPort replay_port(captureFileName, 0.0) ;
+
+    ASSERT_TRUE(replay_port.IsDataAvailable()) ;
+    ASSERT_EQ(replay_port.GetNumberOfBytesAvailable(),
+              line_string.size() + data_buffer.size() + 1) ;
+
+    for (size_t pass = 0; pass < 2; pass++)
+    {
+        std::string replayed_line ;
+        replay_port.ReadLine(replayed_line, '\n', timeOutMilliseconds) ;
+        ASSERT_EQ(replayed_line, line_string) ;
+
+        // The transmitted record is skipped and writes are discarded.
+        replay_port.Write(writeString2) ;
+
+        DataBuffer replayed_data ;
+        replay_port.Read(replayed_data, data_buffer.size(), timeOutMilliseconds) ;
+        ASSERT_EQ(replayed_data, data_buffer) ;
+
+        unsigned char replayed_byte = 0 ;
+        replay_port.ReadByte(replayed_byte, timeOutMilliseconds) ;
+        ASSERT_EQ(replayed_byte, 'x') ;
+
+        ASSERT_TRUE(replay_port.IsEndOfCapture()) ;
+        ASSERT_FALSE(replay_port.IsDataAvailable()) ;
+        ASSERT_THROW(replay_port.ReadByte(replayed_byte, timeOutMilliseconds), ReadTimeout) ;
+
+        replay_port.Rewind() ;
+        ASSERT_FALSE(replay_port.IsEndOfCapture()) ;
+    }
+
+    ASSERT_EQ(replay_port.GetNumberOfBytesWritten(), 2 * writeString2.size()) ;
+}
+
+void
+SerialCaptureUnitTests::testSerialCaptureReplayTiming()
+{
+    constexpr size_t number_of_records = 1000 ;
+    constexpr auto record_interval = std::chrono::milliseconds(100) ;
+
+    {
+        // Records can be made without using the serial port, and a small
+        // initial file size forces the file to grow.
+        CaptureTap capture_tap(serialPort1, captureFileName, 64) ;
+
+        for (size_t i = 0; i < number_of_records; i++)
+        {
+            const auto data_byte = static_cast<uint8_t>(i) ;
+            capture_tap.Record(CaptureDirection::CAPTURE_DIRECTION_RECEIVED,
+                               &data_byte,
+                               sizeof(data_byte)) ;
+        }
+
+        std::this_thread::sleep_for(record_interval) ;
+
+        const uint8_t last_byte = 'z' ;
+        capture_tap.Record(CaptureDirection::CAPTURE_DIRECTION_RECEIVED,
+                           &last_byte,
+                           sizeof(last_byte)) ;
+
+        ASSERT_EQ(capture_tap.GetNumberOfRecords(), number_of_records + 1) ;
+    }
+
+    {
+        ReplayPort replay_port(captureFileName, 0.0) ;
+
+        DataBuffer replayed_data ;
+        replay_port.Read(replayed_data, number_of_records + 1, timeOutMilliseconds) ;
+
+        for (size_t i = 0; i < number_of_records; i++)
+        {
+            ASSERT_EQ(replayed_data[i], static_cast<uint8_t>(i)) ;
+        }
+
+        ASSERT_EQ(replayed_data.back(), 'z') ;
+    }
+
+    {
+        ReplayPort replay_port(captureFileName, 1.0) ;
+
+        DataBuffer replayed_data ;
+        replay_port.Read(replayed_data, number_of_records, timeOutMilliseconds) ;
+        ASSERT_EQ(replayed_data.size(), number_of_records) ;
+
+        // The last byte is not replayed until its capture time.
+        ASSERT_FALSE(replay_port.IsDataAvailable()) ;
+        ASSERT_FALSE(replay_port.IsEndOfCapture()) ;
+
+        unsigned char replayed_byte = 0 ;
+        ASSERT_THROW(replay_port.ReadByte(replayed_byte, 10), ReadTimeout) ;
+
+        const auto entry_time = std::chrono::steady_clock::now() ;
+        replay_port.ReadByte(replayed_byte, timeOutMilliseconds) ;
+        const auto elapsed_time = std::chrono::steady_clock::now() - entry_time ;
+
+        ASSERT_EQ(replayed_byte, 'z') ;
+        ASSERT_GT(elapsed_time, record_interval / 2) ;
+        ASSERT_LT(elapsed_time, record_interval * 2) ;
+        ASSERT_TRUE(replay_port.IsEndOfCapture()) ;
+    }
+}
+
+void
+SerialCaptureUnitTests::testSerialCaptureInvalidFile()
+{
+    ASSERT_THROW(ReplayPort {"/nonexistent/capture"}, OpenFailed) ;
+
+    // An empty file, and one that is not a capture file.
+    ASSERT_THROW(ReplayPort {captureFileName}, std::runtime_error) ;
+
+    {
+        std::ofstream capture_file(captureFileName) ;
+        capture_file << "This is not a capture file, but it is long enough." ;
+    }
+
+    ASSERT_THROW(ReplayPort {captureFileName}, std::runtime_error) ;
+
+    {
+        CaptureTap capture_tap(serialPort1, captureFileName) ;
+        const uint8_t data_byte = 'a' ;
+        capture_tap.Record(CaptureDirection::CAPTURE_DIRECTION_TRANSMITTED,
+                           &data_byte,
+                           sizeof(data_byte)) ;
+    }
+
+    ASSERT_THROW((ReplayPort {captureFileName, -1.0}), std::invalid_argument) ;
+
+    // A truncated record is rejected.
+    ASSERT_EQ(truncate(captureFileName.c_str(),
+                       sizeof(CaptureFileHeader) + sizeof(CaptureRecordHeader)), 0) ;
+    ASSERT_THROW(ReplayPort {captureFileName}, std::runtime_error) ;
+}
+
+TEST_F(SerialCaptureUnitTests, testSerialCaptureCaptureAndReplay)
+{
+    SCOPED_TRACE("Serial Capture Capture And Replay Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialCaptureCaptureAndReplay() ;
+    }
+}
+
+TEST_F(SerialCaptureUnitTests, testSerialCaptureReplayTiming)
+{
+    SCOPED_TRACE("Serial Capture Replay Timing Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialCaptureReplayTiming() ;
+    }
+}
+
+TEST_F(SerialCaptureUnitTests, testSerialCaptureInvalidFile)
+{
+    SCOPED_TRACE("Serial Capture Invalid File Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialCaptureInvalidFile() ;
+    }
+}
@@ -0,0 +1,86 @@
+/******************************************************************************
+ * @file SerialCaptureUnitTests.h                                             *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#pragma once
+
+#include "UnitTests.h"
+#include "libserial/SerialCapture.h"
+
+#include <gtest/gtest.h>
+
+/**
+ * @namespace Libserial
+ */
+namespace LibSerial
+{
+    class SerialCaptureUnitTests : public UnitTests
+    {
+    public:
+
+        /**
+         * @brief Default Constructor. Creates a temporary capture file.
+         */
+        explicit SerialCaptureUnitTests() ;
+
+        /**
+         * @brief Default Destructor. Removes the temporary capture file.
+         */
+        virtual ~SerialCaptureUnitTests() ;
+
+    protected:
+
+        /**
+         * @brief Tests capturing a session through the serial ports and
+         *        replaying it as fast as possible.
+         */
+        void testSerialCaptureCaptureAndReplay() ;
+
+        /**
+         * @brief Tests that a capture replayed in real time delivers the data
+         *        at the times at which it was captured, and that the capture
+         *        file grows as needed.
+         */
+        void testSerialCaptureReplayTiming() ;
+
+        /**
+         * @brief Tests that invalid capture files and replay speeds are
+         *        rejected.
+         */
+        void testSerialCaptureInvalidFile() ;
+
+        /**
+         * @var The name of the temporary capture file.
+         */
+        std::string captureFileName {} ;
+    } ;
+}
@@ -0,0 +1,245 @@
+/******************************************************************************
+ * @file SerialPortEnumeratorUnitTests.cpp                                    *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "SerialPortEnumeratorUnitTests.h"
+#include "UnitTests.h"
+
+#include <fstream>
+#include <ftw.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace LibSerial;
+
+/**
+ * @brief Creates a directory and any missing parent directories.
+ * @param directoryName The directory to create.
+ */
+static void
+makeDirectories(const std::string& directoryName)
+{
+    for (auto separator = directoryName.find('/', 1) ;
+         ; separator = directoryName.find('/', separator + 1))
+    {
+        mkdir(directoryName.substr(0, separator).c_str(), S_IRWXU) ;
+
+        if (separator == std::string::npos)
+        {
+            break ;
+        }
+    }
+}
+
+/**
+ * @brief Writes a single line sysfs attribute file.
+ * @param fileName The attribute file to write.
+ * @param value The attribute value.
+ */
+static void
+writeAttribute(const std::string& fileName,
+               const std::string& value)
+{
+    std::ofstream attribute_file(fileName) ;
+    attribute_file << value << '\n' ;
+}
+
+SerialPortEnumeratorUnitTests::SerialPortEnumeratorUnitTests()
+{
+    std::string root_template = "/tmp/libserial-sysfs-XXXXXX" ;
+
+    if (mkdtemp(&root_template[0]) == nullptr)
+    {
+        throw std::runtime_error("Unable to create the fake sysfs directory.") ;
+    }
+
+    sysfsRootDirectory = root_template ;
+
+    const auto usb_device    = sysfsRootDirectory + "/devices/usb1/1-1" ;
+    const auto usb_tty       = usb_device + "/1-1:1.0/ttyUSB0" ;
+    const auto uart_device   = sysfsRootDirectory + "/devices/platform/serial8250" ;
+    const auto tty_directory = sysfsRootDirectory + "/class/tty" ;
+
+    makeDirectories(usb_tty) ;
+    makeDirectories(uart_device) ;
+    makeDirectories(sysfsRootDirectory + "/drivers/ftdi_sio") ;
+    makeDirectories(sysfsRootDirectory + "/drivers/serial8250") ;
+
+    writeAttribute(usb_device + "/idVendor",     "0403") ;
+    writeAttribute(usb_device + "/idProduct",    "6001") ;
+    writeAttribute(usb_device + "/manufacturer", "FTDI") ;
+    writeAttribute(usb_device + "/product",      "FT232R USB UART") ;
+    writeAttribute(usb_device + "/serial",       "A5XK3RJT") ;
+
+    symlink((sysfsRootDirectory + "/drivers/ftdi_sio").c_str(),
+            (usb_tty + "/driver").c_str()) ;
+    symlink((sysfsRootDirectory + "/drivers/serial8250").c_str(),
+            (uart_device + "/driver").c_str()) ;
+
+    // A USB serial port.
+    makeDirectories(tty_directory + "/ttyUSB0") ;
+    symlink(usb_tty.c_str(),
+            (tty_directory + "/ttyUSB0/device").c_str()) ;
+
+    // A legacy UART with hardware present.
+    makeDirectories(tty_directory + "/ttyS0") ;
+    symlink(uart_device.c_str(),
+            (tty_directory + "/ttyS0/device").c_str()) ;
+    writeAttribute(tty_directory + "/ttyS0/type", "4") ;
+
+    // A legacy UART without hardware.
+    makeDirectories(tty_directory + "/ttyS1") ;
+    symlink(uart_device.c_str(),
+            (tty_directory + "/ttyS1/device").c_str()) ;
+    writeAttribute(tty_directory + "/ttyS1/type", "0") ;
+
+    // A virtual terminal.
+    makeDirectories(tty_directory + "/tty0") ;
+}
+
+SerialPortEnumeratorUnitTests::~SerialPortEnumeratorUnitTests()
+{
+    nftw(sysfsRootDirectory.c_str(),
+         [](const char* fileName, const struct stat*, int, FTW*)
+         {
+             return remove(fileName) ;
+         },
+         16,
+         FTW_DEPTH | FTW_PHYS) ;
+}
+
+void
+SerialPortEnumeratorUnitTests::testSerialPortEnumeratorGetSerialPorts()
+{
+    const SerialPortEnumerator serial_port_enumerator(sysfsRootDirectory + "/class/tty") ;
+
+    const auto serial_ports = serial_port_enumerator.GetSerialPorts() ;
+
+    ASSERT_EQ(serial_ports.size(), 2) ;
+
+    ASSERT_EQ(serial_ports[0].deviceName, "ttyS0") ;
+    ASSERT_EQ(serial_ports[0].devicePath, "/dev/ttyS0") ;
+    ASSERT_EQ(serial_ports[0].driver, "serial8250") ;
+    ASSERT_TRUE(serial_ports[0].vendorId.empty()) ;
+    ASSERT_TRUE(serial_ports[0].serialNumber.empty()) ;
+
+    ASSERT_EQ(serial_ports[1].deviceName, "ttyUSB0") ;
+    ASSERT_EQ(serial_ports[1].devicePath, "/dev/ttyUSB0") ;
+    ASSERT_EQ(serial_ports[1].driver, "ftdi_sio") ;
+    ASSERT_EQ(serial_ports[1].vendorId, "0403") ;
+    ASSERT_EQ(serial_ports[1].productId, "6001") ;
+    ASSERT_EQ(serial_ports[1].manufacturer, "FTDI") ;
+    ASSERT_EQ(serial_ports[1].product, "FT232R USB UART") ;
+    ASSERT_EQ(serial_ports[1].serialNumber, "A5XK3RJT") ;
+
+    // Devices unknown to sysfs are described by their name only.
+    const auto port_info = serial_port_enumerator.GetSerialPortInfo("ttyACM0") ;
+    ASSERT_EQ(port_info.devicePath, "/dev/ttyACM0") ;
+    ASSERT_TRUE(port_info.driver.empty()) ;
+
+    // Device paths are reported in the device directory given.
+    const SerialPortEnumerator device_directory_enumerator(sysfsRootDirectory + "/class/tty",
+                                                           "/tmp/dev") ;
+    ASSERT_EQ(device_directory_enumerator.GetSerialPorts()[1].devicePath, "/tmp/dev/ttyUSB0") ;
+
+    const SerialPortEnumerator missing_enumerator(sysfsRootDirectory + "/missing") ;
+    ASSERT_THROW(missing_enumerator.GetSerialPorts(), std::runtime_error) ;
+}
+
+void
+SerialPortEnumeratorUnitTests::testSerialPortEnumeratorSystemPorts()
+{
+    const SerialPortEnumerator serial_port_enumerator ;
+
+    std::vector<std::string> device_paths ;
+
+    for (const auto& port_info : serial_port_enumerator.GetSerialPorts())
+    {
+        device_paths.push_back(port_info.devicePath) ;
+    }
+
+    ASSERT_EQ(serialPort1.GetAvailableSerialPorts(), device_paths) ;
+}
+
+void
+SerialPortEnumeratorUnitTests::testSerialPortEnumeratorMonitoring()
+{
+    SerialPortEnumerator serial_port_enumerator(sysfsRootDirectory + "/class/tty") ;
+
+    ASSERT_FALSE(serial_port_enumerator.IsMonitoring()) ;
+    ASSERT_EQ(serial_port_enumerator.GetMonitorFileDescriptor(), -1) ;
+    ASSERT_THROW(serial_port_enumerator.ReadEvent(1), std::logic_error) ;
+
+    serial_port_enumerator.StartMonitoring() ;
+
+    ASSERT_TRUE(serial_port_enumerator.IsMonitoring()) ;
+    ASSERT_GE(serial_port_enumerator.GetMonitorFileDescriptor(), 0) ;
+
+    // No serial port is plugged in or removed while the test runs.
+    ASSERT_THROW(serial_port_enumerator.ReadEvent(1), ReadTimeout) ;
+
+    serial_port_enumerator.StopMonitoring() ;
+
+    ASSERT_FALSE(serial_port_enumerator.IsMonitoring()) ;
+    ASSERT_THROW(serial_port_enumerator.ReadEvent(1), std::logic_error) ;
+}
+
+TEST_F(SerialPortEnumeratorUnitTests, testSerialPortEnumeratorGetSerialPorts)
+{
+    SCOPED_TRACE("Serial Port Enumerator GetSerialPorts() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortEnumeratorGetSerialPorts() ;
+    }
+}
+
+TEST_F(SerialPortEnumeratorUnitTests, testSerialPortEnumeratorSystemPorts)
+{
+    SCOPED_TRACE("Serial Port Enumerator System Ports Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortEnumeratorSystemPorts() ;
+    }
+}
+
+TEST_F(SerialPortEnumeratorUnitTests, testSerialPortEnumeratorMonitoring)
+{
+    SCOPED_TRACE("Serial Port Enumerator Monitoring Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortEnumeratorMonitoring() ;
+    }
+}
@@ -0,0 +1,414 @@
+/******************************************************************************
+ * @file SerialPortReactorUnitTests.cpp                                       *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "SerialPortReactorUnitTests.h"
+#include "UnitTests.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace LibSerial;
+
+SerialPortReactorUnitTests::SerialPortReactorUnitTests()
+{
+    // Empty
+}
+
+SerialPortReactorUnitTests::~SerialPortReactorUnitTests()
+{
+    // Empty
+}
+
+void
+SerialPortReactorUnitTests::testSerialPortReactorAddRemove()
+{
+    ASSERT_EQ(serialPortReactor.GetNumberOfPorts(), 0) ;
+
+    // Closed ports cannot be added.
+    ASSERT_THROW(serialPortReactor.Add(std::unique_ptr<SerialPort>(new SerialPort()),
+                                       SerialPortReactor::Callbacks<SerialPort>()),
+                 NotOpen) ;
+
+    const auto port_id = serialPortReactor.Add(std::unique_ptr<SerialPort>(new SerialPort(SERIAL_PORT_1)),
+                                               SerialPortReactor::Callbacks<SerialPort>()) ;
+
+    ASSERT_EQ(serialPortReactor.GetNumberOfPorts(), 1) ;
+    ASSERT_TRUE(serialPortReactor.GetSerialPort(port_id).IsOpen()) ;
+    ASSERT_THROW(serialPortReactor.GetSerialStream(port_id), std::invalid_argument) ;
+
+    serialPortReactor.Remove(port_id) ;
+
+    ASSERT_EQ(serialPortReactor.GetNumberOfPorts(), 0) ;
+    ASSERT_THROW(serialPortReactor.GetSerialPort(port_id), std::invalid_argument) ;
+    ASSERT_THROW(serialPortReactor.Remove(port_id), std::invalid_argument) ;
+
+    // The removed port has been closed and can be opened again.
+    serialPort1.Open(SERIAL_PORT_1) ;
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    serialPort1.Close() ;
+}
+
+void
+SerialPortReactorUnitTests::testSerialPortReactorDataReady()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+
+    std::string received_string ;
+
+    SerialPortReactor::Callbacks<SerialPort> callbacks ;
+    callbacks.dataReady = [&received_string](SerialPortReactor::PortId /* portId */,
+                                             SerialPort&                serialPort)
+    {
+        std::string read_string ;
+        serialPort.Read(read_string,
+                        static_cast<size_t>(serialPort.GetNumberOfBytesAvailable())) ;
+        received_string += read_string ;
+    } ;
+
+    const auto port_id = serialPortReactor.Add(std::unique_ptr<SerialPort>(new SerialPort(SERIAL_PORT_2)),
+                                               callbacks) ;
+
+    // Nothing is dispatched before any data arrives.
+    ASSERT_EQ(serialPortReactor.RunOnce(1), 0) ;
+
+    serialPort1.Write(writeString1 + '\n') ;
+
+    const auto start_time = getTimeInMilliSeconds() ;
+
+    while ((received_string.size() < writeString1.size() + 1) and
+           (getTimeInMilliSeconds() - start_time < timeOutMilliseconds))
+    {
+        serialPortReactor.RunOnce(timeOutMilliseconds) ;
+    }
+
+    ASSERT_EQ(received_string, writeString1 + '\n') ;
+
+    serialPortReactor.Remove(port_id) ;
+    serialPort1.Close() ;
+}
+
+void
+SerialPortReactorUnitTests::testSerialPortReactorSerialStreamDataReady()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+
+    std::unique_ptr<SerialStream> serial_stream(new SerialStream()) ;
+    serial_stream->Open(SERIAL_PORT_2) ;
+
+    std::string received_string ;
+
+    SerialPortReactor::Callbacks<SerialStream> callbacks ;
+    callbacks.dataReady = [&received_string](SerialPortReactor::PortId /* portId */,
+                                             SerialStream&              serialStream)
+    {
+        std::getline(serialStream, received_string) ;
+    } ;
+
+    const auto port_id = serialPortReactor.Add(std::move(serial_stream),
+                                               callbacks) ;
+
+    serialPort1.Write(writeString2 + '\n') ;
+
+    ASSERT_EQ(serialPortReactor.RunOnce(timeOutMilliseconds), 1) ;
+    ASSERT_EQ(received_string, writeString2) ;
+
+    serialPortReactor.Remove(port_id) ;
+    serialPort1.Close() ;
+}
+
+void
+SerialPortReactorUnitTests::testSerialPortReactorWritable()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+
+    size_t writable_count = 0 ;
+
+    SerialPortReactor::Callbacks<SerialPort> callbacks ;
+    callbacks.writable = [this, &writable_count](SerialPortReactor::PortId portId,
+                                                 SerialPort&               serialPort)
+    {
+        serialPort.Write(writeString1 + '\n') ;
+        serialPortReactor.SetWritableInterest(portId, false) ;
+        ++writable_count ;
+    } ;
+
+    const auto port_id = serialPortReactor.Add(std::unique_ptr<SerialPort>(new SerialPort(SERIAL_PORT_2)),
+                                               callbacks) ;
+
+    // No writable callbacks are dispatched until writable interest is enabled.
+    ASSERT_EQ(serialPortReactor.RunOnce(1), 0) ;
+
+    serialPortReactor.SetWritableInterest(port_id, true) ;
+
+    ASSERT_EQ(serialPortReactor.RunOnce(timeOutMilliseconds), 1) ;
+    ASSERT_EQ(serialPortReactor.RunOnce(1), 0) ;
+    ASSERT_EQ(writable_count, 1) ;
+
+    serialPort1.ReadLine(readString1, '\n', timeOutMilliseconds) ;
+    ASSERT_EQ(readString1, writeString1 + '\n') ;
+
+    serialPortReactor.Remove(port_id) ;
+    serialPort1.Close() ;
+}
+
+void
+SerialPortReactorUnitTests::testSerialPortReactorWritableThreshold()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+
+    const size_t writable_threshold = 16 ;
+    const size_t number_of_writes = 4 ;
+    const std::string write_string(1024, 'x') ;
+
+    size_t writable_count = 0 ;
+    std::vector<int> queue_depths ;
+
+    SerialPortReactor::Callbacks<SerialPort> callbacks ;
+    callbacks.writable = [&](SerialPortReactor::PortId portId,
+                             SerialPort&               serialPort)
+    {
+        queue_depths.push_back(serialPort.GetNumberOfBytesPending()) ;
+        serialPort.Write(write_string) ;
+
+        if (++writable_count == number_of_writes)
+        {
+            serialPortReactor.SetWritableInterest(portId, false) ;
+        }
+    } ;
+
+    const auto port_id = serialPortReactor.Add(std::unique_ptr<SerialPort>(new SerialPort(SERIAL_PORT_2)),
+                                               callbacks) ;
+
+    ASSERT_THROW(serialPortReactor.SetWritableThreshold(port_id + 1, writable_threshold),
+                 std::invalid_argument) ;
+
+    serialPortReactor.SetWritableThreshold(port_id, writable_threshold) ;
+    serialPortReactor.SetWritableInterest(port_id, true) ;
+
+    std::string received_string ;
+    const auto start_time = getTimeInMilliSeconds() ;
+
+    while ((received_string.size() < number_of_writes * write_string.size()) and
+           (getTimeInMilliSeconds() - start_time < 4 * timeOutMilliseconds))
+    {
+        serialPortReactor.RunOnce(1) ;
+
+        std::string read_string ;
+        const auto number_of_bytes_available = serialPort1.GetNumberOfBytesAvailable() ;
+
+        if (number_of_bytes_available > 0)
+        {
+            serialPort1.Read(read_string, static_cast<size_t>(number_of_bytes_available)) ;
+            received_string += read_string ;
+        }
+    }
+
+    ASSERT_EQ(writable_count, number_of_writes) ;
+    ASSERT_EQ(received_string.size(), number_of_writes * write_string.size()) ;
+
+    for (const auto queue_depth : queue_depths)
+    {
+        ASSERT_LE(static_cast<size_t>(queue_depth), writable_threshold) ;
+    }
+
+    serialPortReactor.Remove(port_id) ;
+    serialPort1.Close() ;
+}
+
+void
+SerialPortReactorUnitTests::testSerialPortReactorRunStop()
+{
+    std::atomic<size_t> number_of_lines {0} ;
+
+    SerialPortReactor::Callbacks<SerialPort> callbacks ;
+    callbacks.dataReady = [&number_of_lines](SerialPortReactor::PortId /* portId */,
+                                             SerialPort&                serialPort)
+    {
+        std::string read_string ;
+        serialPort.ReadLine(read_string, '\n', 250) ;
+        ++number_of_lines ;
+    } ;
+
+    const auto port_id = serialPortReactor.Add(std::unique_ptr<SerialPort>(new SerialPort(SERIAL_PORT_2)),
+                                               callbacks) ;
+
+    serialPort1.Open(SERIAL_PORT_1) ;
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+
+    std::vector<std::thread> run_threads ;
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        run_threads.emplace_back([this]() { serialPortReactor.Run() ; }) ;
+    }
+
+    serialPort1.Write(writeString1 + '\n') ;
+
+    const auto start_time = getTimeInMilliSeconds() ;
+
+    while ((number_of_lines == 0) and
+           (getTimeInMilliSeconds() - start_time < timeOutMilliseconds))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1)) ;
+    }
+
+    serialPortReactor.Stop() ;
+
+    for (auto& run_thread : run_threads)
+    {
+        run_thread.join() ;
+    }
+
+    ASSERT_EQ(number_of_lines, 1) ;
+
+    // The reactor can be run again once all threads have returned.
+    ASSERT_EQ(serialPortReactor.RunOnce(1), 0) ;
+
+    serialPortReactor.Remove(port_id) ;
+    serialPort1.Close() ;
+}
+
+void
+SerialPortReactorUnitTests::testSerialPortReactorTimers()
+{
+    std::vector<int> fired_timers ;
+
+    serialPortReactor.StartTimer(20, [&fired_timers]() { fired_timers.push_back(2) ; }) ;
+    serialPortReactor.StartTimer(1, [&fired_timers]() { fired_timers.push_back(1) ; }) ;
+
+    const auto cancelled_timer = serialPortReactor.StartTimer(1, [&fired_timers]() { fired_timers.push_back(0) ; }) ;
+    ASSERT_TRUE(serialPortReactor.CancelTimer(cancelled_timer)) ;
+    ASSERT_FALSE(serialPortReactor.CancelTimer(cancelled_timer)) ;
+
+    const auto start_time = getTimeInMilliSeconds() ;
+
+    while ((fired_timers.size() < 2) and
+           (getTimeInMilliSeconds() - start_time < timeOutMilliseconds))
+    {
+        serialPortReactor.RunOnce(timeOutMilliseconds) ;
+    }
+
+    // Timers fire in order of expiry, and cancelled timers never fire.
+    ASSERT_EQ(fired_timers, std::vector<int>({1, 2})) ;
+    ASSERT_GE(getTimeInMilliSeconds() - start_time, 19) ;
+
+    // Timers may be started from within a timer callback.
+    bool nested_timer_fired = false ;
+
+    serialPortReactor.StartTimer(0, [this, &nested_timer_fired]()
+    {
+        serialPortReactor.StartTimer(0, [&nested_timer_fired]() { nested_timer_fired = true ; }) ;
+    }) ;
+
+    ASSERT_EQ(serialPortReactor.RunOnce(timeOutMilliseconds), 1) ;
+    ASSERT_EQ(serialPortReactor.RunOnce(timeOutMilliseconds), 1) ;
+    ASSERT_TRUE(nested_timer_fired) ;
+
+    // Nothing is dispatched once all timers have fired.
+    ASSERT_EQ(serialPortReactor.RunOnce(1), 0) ;
+}
+
+TEST_F(SerialPortReactorUnitTests, testSerialPortReactorAddRemove)
+{
+    SCOPED_TRACE("Serial Port Reactor Add() and Remove() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortReactorAddRemove() ;
+    }
+}
+
+TEST_F(SerialPortReactorUnitTests, testSerialPortReactorDataReady)
+{
+    SCOPED_TRACE("Serial Port Reactor Data Ready Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortReactorDataReady() ;
+    }
+}
+
+TEST_F(SerialPortReactorUnitTests, testSerialPortReactorSerialStreamDataReady)
+{
+    SCOPED_TRACE("Serial Port Reactor Serial Stream Data Ready Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortReactorSerialStreamDataReady() ;
+    }
+}
+
+TEST_F(SerialPortReactorUnitTests, testSerialPortReactorWritable)
+{
+    SCOPED_TRACE("Serial Port Reactor Writable Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortReactorWritable() ;
+    }
+}
+
+TEST_F(SerialPortReactorUnitTests, testSerialPortReactorRunStop)
+{
+    SCOPED_TRACE("Serial Port Reactor Run() and Stop() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortReactorRunStop() ;
+    }
+}
+
+TEST_F(SerialPortReactorUnitTests, testSerialPortReactorTimers)
+{
+    SCOPED_TRACE("Serial Port Reactor Timers Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortReactorTimers() ;
+    }
+}
+
+TEST_F(SerialPortReactorUnitTests, testSerialPortReactorWritableThreshold)
+{
+    SCOPED_TRACE("Serial Port Reactor Writable Threshold Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortReactorWritableThreshold() ;
+    }
+}
@@ -0,0 +1,227 @@
+/******************************************************************************
+ * @file SerialPortStatisticsUnitTests.cpp                                    *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "SerialPortStatisticsUnitTests.h"
+#include "UnitTests.h"
+
+using namespace LibSerial;
+
+void
+SerialPortStatisticsUnitTests::testLatencyHistogram()
+{
+    // Small values are counted exactly, larger ones within 1/16.
+    for (uint64_t value : {0ULL, 1ULL, 15ULL, 16ULL, 17ULL, 100ULL, 1000ULL, 123456ULL, 1ULL << 39})
+    {
+        const auto bucket_index = LatencyHistogram::GetBucketIndex(value) ;
+        const auto upper_bound = LatencyHistogramSnapshot::GetBucketUpperBound(bucket_index) ;
+
+        ASSERT_GE(upper_bound, value) ;
+        ASSERT_LE(upper_bound - value, value / LATENCY_HISTOGRAM_SUB_BUCKETS) ;
+
+        if (bucket_index > 0)
+        {
+            ASSERT_LT(LatencyHistogramSnapshot::GetBucketUpperBound(bucket_index - 1), value) ;
+        }
+    }
+
+    ASSERT_EQ(LatencyHistogram::GetBucketIndex(UINT64_MAX), LATENCY_HISTOGRAM_BUCKETS - 1) ;
+
+    LatencyHistogram histogram ;
+    ASSERT_EQ(histogram.GetSnapshot().count, 0U) ;
+    ASSERT_EQ(histogram.GetSnapshot().GetValueAtPercentile(50.0), 0U) ;
+
+    // One to a thousand microseconds.
+    for (uint64_t i = 1 ; i <= 1000 ; ++i)
+    {
+        histogram.Record(i * 1000) ;
+    }
+
+    auto snapshot = histogram.GetSnapshot() ;
+    ASSERT_EQ(snapshot.count, 1000U) ;
+    ASSERT_EQ(snapshot.maximum, 1000000U) ;
+    ASSERT_DOUBLE_EQ(snapshot.GetMean(), 500500.0) ;
+
+    const auto median = snapshot.GetValueAtPercentile(50.0) ;
+    ASSERT_GE(median, 500000U) ;
+    ASSERT_LE(median, 500000U + 500000U / LATENCY_HISTOGRAM_SUB_BUCKETS) ;
+
+    const auto p99 = snapshot.GetValueAtPercentile(99.0) ;
+    ASSERT_GE(p99, 990000U) ;
+    ASSERT_LE(p99, 1000000U) ;
+
+    ASSERT_EQ(snapshot.GetValueAtPercentile(100.0), 1000000U) ;
+
+    // Merging adds the counts of both snapshots.
+    LatencyHistogram other_histogram ;
+    other_histogram.Record(5000000) ;
+
+    snapshot.Merge(other_histogram.GetSnapshot()) ;
+    ASSERT_EQ(snapshot.count, 1001U) ;
+    ASSERT_EQ(snapshot.maximum, 5000000U) ;
+
+    histogram.Reset() ;
+    ASSERT_EQ(histogram.GetSnapshot().count, 0U) ;
+    ASSERT_EQ(histogram.GetSnapshot().maximum, 0U) ;
+}
+
+void
+SerialPortStatisticsUnitTests::testSerialPortStatistics()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    serialPort1.ResetStatistics() ;
+    serialPort2.ResetStatistics() ;
+
+    std::string read_string ;
+
+    serialPort1.Write(writeString1) ;
+    serialPort2.Read(read_string, writeString1.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(read_string, writeString1) ;
+
+    ASSERT_THROW(serialPort2.Read(read_string, 1, 1), ReadTimeout) ;
+
+    const auto write_statistics = serialPort1.GetStatistics() ;
+    const auto read_statistics = serialPort2.GetStatistics() ;
+
+    ASSERT_EQ(write_statistics.enabled, read_statistics.enabled) ;
+
+    if (write_statistics.enabled)
+    {
+        ASSERT_EQ(write_statistics.bytesWritten, writeString1.size()) ;
+        ASSERT_GE(write_statistics.writeCalls, 1U) ;
+        ASSERT_EQ(write_statistics.writeCompletionTime.count, 1U) ;
+        ASSERT_EQ(write_statistics.bytesRead, 0U) ;
+
+        ASSERT_EQ(read_statistics.bytesRead, writeString1.size()) ;
+        ASSERT_GE(read_statistics.readCalls, 1U) ;
+        ASSERT_EQ(read_statistics.readTimeouts, 1U) ;
+        ASSERT_GE(read_statistics.readWaitTime.count, 2U) ;
+        ASSERT_GE(read_statistics.readWaitTime.maximum, 500000U) ;
+        ASSERT_EQ(read_statistics.bytesWritten, 0U) ;
+    }
+    else
+    {
+        ASSERT_EQ(write_statistics.bytesWritten, 0U) ;
+        ASSERT_EQ(read_statistics.bytesRead, 0U) ;
+        ASSERT_EQ(read_statistics.readTimeouts, 0U) ;
+        ASSERT_EQ(read_statistics.readWaitTime.count, 0U) ;
+    }
+
+    serialPort2.ResetStatistics() ;
+
+    const auto reset_statistics = serialPort2.GetStatistics() ;
+    ASSERT_EQ(reset_statistics.bytesRead, 0U) ;
+    ASSERT_EQ(reset_statistics.readCalls, 0U) ;
+    ASSERT_EQ(reset_statistics.readTimeouts, 0U) ;
+    ASSERT_EQ(reset_statistics.readWaitTime.count, 0U) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+}
+
+void
+SerialPortStatisticsUnitTests::testSerialStreamStatistics()
+{
+    serialStream1.Open(SERIAL_PORT_1) ;
+    serialStream2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialStream1.IsOpen()) ;
+    ASSERT_TRUE(serialStream2.IsOpen()) ;
+
+    serialStream1.ResetStatistics() ;
+    serialStream2.ResetStatistics() ;
+
+    std::string read_string ;
+
+    serialStream1 << writeString1 << std::endl ;
+    std::getline(serialStream2, read_string) ;
+    ASSERT_EQ(read_string, writeString1) ;
+
+    const auto write_statistics = serialStream1.GetStatistics() ;
+    const auto read_statistics = serialStream2.GetStatistics() ;
+
+    if (write_statistics.enabled)
+    {
+        ASSERT_EQ(write_statistics.bytesWritten, writeString1.size() + 1) ;
+        ASSERT_GE(write_statistics.writeCompletionTime.count, 1U) ;
+
+        ASSERT_EQ(read_statistics.bytesRead, writeString1.size() + 1) ;
+        ASSERT_GE(read_statistics.readCalls, 1U) ;
+        ASSERT_GE(read_statistics.readWaitTime.count, 1U) ;
+    }
+    else
+    {
+        ASSERT_EQ(write_statistics.bytesWritten, 0U) ;
+        ASSERT_EQ(read_statistics.bytesRead, 0U) ;
+    }
+
+    serialStream1.ResetStatistics() ;
+    ASSERT_EQ(serialStream1.GetStatistics().bytesWritten, 0U) ;
+
+    serialStream1.Close() ;
+    serialStream2.Close() ;
+}
+
+TEST_F(SerialPortStatisticsUnitTests, testLatencyHistogram)
+{
+    SCOPED_TRACE("Latency Histogram Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testLatencyHistogram() ;
+    }
+}
+
+TEST_F(SerialPortStatisticsUnitTests, testSerialPortStatistics)
+{
+    SCOPED_TRACE("Serial Port Statistics Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortStatistics() ;
+    }
+}
+
+TEST_F(SerialPortStatisticsUnitTests, testSerialStreamStatistics)
+{
+    SCOPED_TRACE("Serial Stream Statistics Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialStreamStatistics() ;
+    }
+}
@@ -34,8 +34,11 @@
 #include "SerialPortUnitTests.h"
 #include "UnitTests.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <iostream>
+#include <pty.h>
 #include <thread>
 #include <unistd.h>
 #include <vector>
@@ -1103,6 +1106,763 @@ SerialPortUnitTests::testSerialPortReadLineWriteString()
     ASSERT_FALSE(serialPort2.IsOpen()) ;
 }
 
+void
+SerialPortUnitTests::testSerialPortReadWriteCallerBuffer()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    constexpr size_t data_count = 75 ;
+
+    uint8_t writeArray[data_count] {} ;
+    uint8_t readArray[data_count] {} ;
+
+    for (size_t i = 0; i < data_count; i++)
+    {
+        writeArray[i] = static_cast<uint8_t>(48 + i) ;
+    }
+
+    serialPort1.Write(writeArray, data_count) ;
+    serialPort1.DrainWriteBuffer() ;
+
+    // Data may arrive in several chunks, each returned by a separate call.
+    size_t number_of_bytes_read = 0 ;
+
+    while (number_of_bytes_read < data_count)
+    {
+        number_of_bytes_read += serialPort2.Read(&readArray[number_of_bytes_read],
+                                                 data_count - number_of_bytes_read,
+                                                 timeOutMilliseconds) ;
+    }
+
+    ASSERT_EQ(number_of_bytes_read, data_count) ;
+    ASSERT_EQ(0, std::memcmp(readArray, writeArray, data_count)) ;
+
+    // No more than the capacity of the caller's buffer is returned.
+    serialPort2.Write(writeArray, data_count) ;
+    serialPort2.DrainWriteBuffer() ;
+    usleep(readBufferDelay) ;
+
+    ASSERT_EQ(serialPort1.Read(readArray, 10, timeOutMilliseconds), 10) ;
+    ASSERT_EQ(serialPort1.GetNumberOfBytesAvailable(), data_count - 10) ;
+    serialPort1.FlushInputBuffer() ;
+
+    // A ReadTimeout exception is thrown when no data arrives.
+    ASSERT_THROW(serialPort1.Read(readArray, data_count, 1), ReadTimeout) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortWriteV()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    const DataBuffer header {0x02, 0x10, 0x00, 0x04} ;
+    const DataBuffer payload(writeString1.begin(), writeString1.end()) ;
+    const DataBuffer crc {0xA5, 0x5A} ;
+
+    DataBuffer expected_buffer(header) ;
+    expected_buffer.insert(expected_buffer.end(), payload.begin(), payload.end()) ;
+    expected_buffer.insert(expected_buffer.end(), crc.begin(), crc.end()) ;
+
+    // Empty buffers are skipped.
+    serialPort1.WriteV({{header.data(), header.size()},
+                        {nullptr, 0},
+                        {payload.data(), payload.size()},
+                        {crc.data(), crc.size()}}) ;
+
+    DataBuffer read_buffer ;
+    serialPort2.Read(read_buffer, expected_buffer.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(read_buffer, expected_buffer) ;
+
+    // More buffers than can be submitted with a single writev() call.
+    const size_t number_of_buffers = 200 ;
+    std::vector<ConstBuffer> buffers ;
+    expected_buffer.clear() ;
+
+    for (size_t i = 0; i < number_of_buffers; i++)
+    {
+        buffers.push_back({&payload[i % payload.size()], 1}) ;
+        expected_buffer.push_back(payload[i % payload.size()]) ;
+    }
+
+    serialPort1.WriteV(buffers.data(), buffers.size()) ;
+
+    read_buffer.clear() ;
+    serialPort2.Read(read_buffer, expected_buffer.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(read_buffer, expected_buffer) ;
+
+    // Nothing is written when there are no buffers.
+    serialPort1.WriteV(nullptr, 0) ;
+    usleep(readBufferDelay) ;
+    ASSERT_FALSE(serialPort2.IsDataAvailable()) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+
+    ASSERT_THROW(serialPort1.WriteV(buffers.data(), buffers.size()), NotOpen) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortReadLineMultiCharTerminator()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    const std::string line_terminator = "\r\n" ;
+
+    // Several lines arriving together are returned one at a time.
+    serialPort1.Write(writeString1 + line_terminator +
+                      writeString2 + line_terminator + "partial") ;
+    serialPort1.DrainWriteBuffer() ;
+    usleep(readBufferDelay) ;
+
+    serialPort2.ReadLine(readString1, line_terminator, timeOutMilliseconds) ;
+    ASSERT_EQ(readString1, writeString1 + line_terminator) ;
+
+    // Data following the line terminator remains available.
+    ASSERT_TRUE(serialPort2.IsDataAvailable()) ;
+    ASSERT_EQ(static_cast<size_t>(serialPort2.GetNumberOfBytesAvailable()),
+              writeString2.size() + line_terminator.size() + 7) ;
+
+    serialPort2.ReadLine(readString1, line_terminator, timeOutMilliseconds) ;
+    ASSERT_EQ(readString1, writeString2 + line_terminator) ;
+
+    unsigned char read_byte = 0 ;
+    serialPort2.ReadByte(read_byte, timeOutMilliseconds) ;
+    ASSERT_EQ(read_byte, 'p') ;
+
+    // A ReadTimeout exception returns the partial line.
+    ASSERT_THROW(serialPort2.ReadLine(readString1, line_terminator, 1), ReadTimeout) ;
+    ASSERT_EQ(readString1, "artial") ;
+    ASSERT_FALSE(serialPort2.IsDataAvailable()) ;
+
+    // A line terminator split across two reads is found.
+    serialPort1.Write(writeString1 + '\r') ;
+    serialPort1.DrainWriteBuffer() ;
+
+    std::thread write_thread([this]()
+    {
+        usleep(readBufferDelay) ;
+        serialPort1.Write("\n" + writeString2 + '\n') ;
+    }) ;
+
+    serialPort2.ReadLine(readString1, line_terminator, timeOutMilliseconds) ;
+    write_thread.join() ;
+    ASSERT_EQ(readString1, writeString1 + line_terminator) ;
+
+    serialPort2.ReadLine(readString1, '\n', timeOutMilliseconds) ;
+    ASSERT_EQ(readString1, writeString2 + '\n') ;
+
+    ASSERT_THROW(serialPort2.ReadLine(readString1, std::string(), timeOutMilliseconds),
+                 std::invalid_argument) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortBackgroundReader()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    ASSERT_FALSE(serialPort2.IsBackgroundReaderRunning()) ;
+    ASSERT_THROW(serialPort2.StartBackgroundReader(0), std::invalid_argument) ;
+    ASSERT_THROW(serialPort2.StartBackgroundReader(1000), std::invalid_argument) ;
+
+    serialPort2.StartBackgroundReader(1024) ;
+    ASSERT_TRUE(serialPort2.IsBackgroundReaderRunning()) ;
+    ASSERT_THROW(serialPort2.StartBackgroundReader(1024), std::logic_error) ;
+
+    // Data written to the serial port is placed in the ring buffer.
+    serialPort1.Write(writeString1) ;
+
+    DataBuffer read_buffer(writeString1.size()) ;
+    size_t number_of_bytes_read = 0 ;
+
+    const auto start_time = getTimeInMilliSeconds() ;
+
+    while ((number_of_bytes_read < writeString1.size()) and
+           (getTimeInMilliSeconds() - start_time < timeOutMilliseconds))
+    {
+        number_of_bytes_read += serialPort2.ReadFromRingBuffer(&read_buffer[number_of_bytes_read],
+                                                               read_buffer.size() - number_of_bytes_read) ;
+    }
+
+    ASSERT_EQ(std::string(read_buffer.begin(), read_buffer.end()), writeString1) ;
+    ASSERT_EQ(serialPort2.GetRingBufferLevel(), 0) ;
+    ASSERT_EQ(serialPort2.GetRingBufferOverrunCount(), 0) ;
+    ASSERT_GT(serialPort2.GetRingBufferHighWaterMark(), 0) ;
+    ASSERT_LE(serialPort2.GetRingBufferHighWaterMark(), writeString1.size()) ;
+
+    serialPort2.StopBackgroundReader() ;
+    ASSERT_FALSE(serialPort2.IsBackgroundReaderRunning()) ;
+
+    // Data arriving while the ring buffer is full is discarded and counted.
+    const size_t ring_buffer_size = 16 ;
+    serialPort2.StartBackgroundReader(ring_buffer_size) ;
+
+    serialPort1.Write(writeString1) ;
+    serialPort1.DrainWriteBuffer() ;
+    usleep(readBufferDelay) ;
+
+    ASSERT_EQ(serialPort2.GetRingBufferLevel(), ring_buffer_size) ;
+    ASSERT_EQ(serialPort2.GetRingBufferHighWaterMark(), ring_buffer_size) ;
+    ASSERT_EQ(serialPort2.GetRingBufferOverrunCount(), writeString1.size() - ring_buffer_size) ;
+
+    serialPort2.StopBackgroundReader() ;
+
+    // Data remains available after the background reader is stopped.
+    ASSERT_EQ(serialPort2.ReadFromRingBuffer(read_buffer.data(), read_buffer.size()), ring_buffer_size) ;
+    ASSERT_EQ(std::string(read_buffer.begin(), read_buffer.begin() + ring_buffer_size),
+              writeString1.substr(0, ring_buffer_size)) ;
+
+    // Closing the serial port stops the background reader.
+    serialPort2.StartBackgroundReader() ;
+    serialPort2.Close() ;
+    ASSERT_FALSE(serialPort2.IsBackgroundReaderRunning()) ;
+
+    serialPort1.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortBackgroundReaderHangUp()
+{
+    int master_fd = -1 ;
+    int slave_fd = -1 ;
+    char slave_name[64] {} ;
+
+    ASSERT_EQ(openpty(&master_fd, &slave_fd, slave_name, nullptr, nullptr), 0) ;
+
+    SerialPort serial_port(slave_name) ;
+    close(slave_fd) ;
+
+    serial_port.StartBackgroundReader(64) ;
+    ASSERT_TRUE(serial_port.IsBackgroundReaderRunning()) ;
+
+    // Closing the master hangs up the slave, which stops the reader.
+    close(master_fd) ;
+
+    const auto start_time = getTimeInMilliSeconds() ;
+
+    while (serial_port.IsBackgroundReaderRunning() and
+           (getTimeInMilliSeconds() - start_time < timeOutMilliseconds))
+    {
+        usleep(1000) ;
+    }
+
+    ASSERT_FALSE(serial_port.IsBackgroundReaderRunning()) ;
+
+    uint8_t read_buffer[1] {} ;
+    ASSERT_THROW(serial_port.ReadFromRingBuffer(read_buffer, sizeof(read_buffer)), std::runtime_error) ;
+
+    // The stopped reader can be started again.
+    serial_port.StartBackgroundReader(64) ;
+    serial_port.StopBackgroundReader() ;
+    ASSERT_FALSE(serial_port.IsBackgroundReaderRunning()) ;
+
+    serial_port.Close() ;
+}
+
+void
+SerialPortUnitTests::testSerialPortSetGetSerialPortParameters()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+
+    // The serial port is opened with the default parameters.
+    const PortSettings default_settings ;
+    auto port_settings = serialPort1.GetSerialPortParameters() ;
+
+    ASSERT_EQ(port_settings.baudRate,      default_settings.baudRate) ;
+    ASSERT_EQ(port_settings.characterSize, default_settings.characterSize) ;
+    ASSERT_EQ(port_settings.flowControl,   default_settings.flowControl) ;
+    ASSERT_EQ(port_settings.parity,        default_settings.parity) ;
+    ASSERT_EQ(port_settings.stopBits,      default_settings.stopBits) ;
+    ASSERT_EQ(port_settings.vmin,          default_settings.vmin) ;
+    ASSERT_EQ(port_settings.vtime,         default_settings.vtime) ;
+
+    // All parameters are applied at once.
+    PortSettings new_settings ;
+    new_settings.baudRate      = BaudRate::BAUD_9600 ;
+    new_settings.characterSize = CharacterSize::CHAR_SIZE_8 ;
+    new_settings.flowControl   = FlowControl::FLOW_CONTROL_HARDWARE ;
+    new_settings.parity        = Parity::PARITY_NONE ;
+    new_settings.stopBits      = StopBits::STOP_BITS_2 ;
+    new_settings.vmin          = 5 ;
+    new_settings.vtime         = 3 ;
+
+    serialPort1.SetSerialPortParameters(new_settings) ;
+
+    ASSERT_EQ(serialPort1.GetBaudRate(),      new_settings.baudRate) ;
+    ASSERT_EQ(serialPort1.GetCharacterSize(), new_settings.characterSize) ;
+    ASSERT_EQ(serialPort1.GetFlowControl(),   new_settings.flowControl) ;
+    ASSERT_EQ(serialPort1.GetParity(),        new_settings.parity) ;
+    ASSERT_EQ(serialPort1.GetStopBits(),      new_settings.stopBits) ;
+    ASSERT_EQ(serialPort1.GetVMin(),          new_settings.vmin) ;
+    ASSERT_EQ(serialPort1.GetVTime(),         new_settings.vtime) ;
+
+    // Individual setters are reflected in the batch getter.
+    serialPort1.SetBaudRate(BaudRate::BAUD_19200) ;
+    port_settings = serialPort1.GetSerialPortParameters() ;
+    ASSERT_EQ(port_settings.baudRate, BaudRate::BAUD_19200) ;
+    ASSERT_EQ(port_settings.parity,   new_settings.parity) ;
+
+    // The serial port is left unchanged if any parameter is invalid.
+    PortSettings invalid_settings ;
+    invalid_settings.vmin = 256 ;
+    ASSERT_THROW(serialPort1.SetSerialPortParameters(invalid_settings), std::invalid_argument) ;
+    ASSERT_EQ(serialPort1.GetBaudRate(), BaudRate::BAUD_19200) ;
+    ASSERT_EQ(serialPort1.GetVMin(),     new_settings.vmin) ;
+
+    serialPort1.SetDefaultSerialPortParameters() ;
+    port_settings = serialPort1.GetSerialPortParameters() ;
+    ASSERT_EQ(port_settings.baudRate, default_settings.baudRate) ;
+    ASSERT_EQ(port_settings.parity,   default_settings.parity) ;
+    ASSERT_EQ(port_settings.vmin,     default_settings.vmin) ;
+
+    serialPort1.Close() ;
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+
+    ASSERT_THROW(serialPort1.SetSerialPortParameters(new_settings), NotOpen) ;
+    ASSERT_THROW(serialPort1.GetSerialPortParameters(), NotOpen) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortReadTimestamped()
+{
+    TimestampedDataBuffer timestamped_data ;
+
+    ASSERT_THROW(serialPort2.ReadTimestamped(timestamped_data), NotOpen) ;
+
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    const DataBuffer first_chunk(writeString1.begin(), writeString1.end()) ;
+    const DataBuffer second_chunk(writeString2.begin(), writeString2.end()) ;
+
+    // Two writes separated by a pause arrive as two chunks, the second
+    // stamped no earlier than the pause after the first.
+    const auto write_time = std::chrono::steady_clock::now() ;
+
+    std::thread write_thread([&]()
+    {
+        serialPort1.Write(first_chunk) ;
+        serialPort1.DrainWriteBuffer() ;
+        usleep(readBufferDelay * 5) ;
+        serialPort1.Write(second_chunk) ;
+        serialPort1.DrainWriteBuffer() ;
+    }) ;
+
+    serialPort2.ReadTimestamped(timestamped_data,
+                                first_chunk.size() + second_chunk.size(),
+                                timeOutMilliseconds) ;
+    write_thread.join() ;
+
+    DataBuffer expected_data(first_chunk) ;
+    expected_data.insert(expected_data.end(), second_chunk.begin(), second_chunk.end()) ;
+    ASSERT_EQ(timestamped_data.data, expected_data) ;
+
+    const auto& chunk_offsets = timestamped_data.chunkOffsets ;
+    const auto& chunk_timestamps = timestamped_data.chunkTimestamps ;
+
+    ASSERT_GE(chunk_offsets.size(), 2u) ;
+    ASSERT_EQ(chunk_offsets.size(), chunk_timestamps.size()) ;
+    ASSERT_EQ(chunk_offsets.front(), 0u) ;
+    ASSERT_GE(chunk_timestamps.front(), write_time) ;
+
+    for (size_t chunk = 1; chunk < chunk_offsets.size(); chunk++)
+    {
+        ASSERT_GT(chunk_offsets[chunk], chunk_offsets[chunk - 1]) ;
+        ASSERT_GE(chunk_timestamps[chunk], chunk_timestamps[chunk - 1]) ;
+    }
+
+    const auto second_chunk_index = static_cast<size_t>(
+        std::find(chunk_offsets.begin(), chunk_offsets.end(), first_chunk.size()) -
+        chunk_offsets.begin()) ;
+
+    ASSERT_LT(second_chunk_index, chunk_offsets.size()) ;
+    ASSERT_GE(chunk_timestamps[second_chunk_index] - chunk_timestamps.front(),
+              std::chrono::microseconds(readBufferDelay * 2)) ;
+
+    // With no byte count, only the first chunk is returned.
+    serialPort1.Write(first_chunk) ;
+    serialPort1.DrainWriteBuffer() ;
+    usleep(readBufferDelay) ;
+
+    serialPort2.ReadTimestamped(timestamped_data, 0, timeOutMilliseconds) ;
+    ASSERT_EQ(timestamped_data.data, first_chunk) ;
+    ASSERT_EQ(timestamped_data.chunkOffsets.size(), 1u) ;
+
+    // Data read ahead by ReadLine() is returned first as one chunk.
+    serialPort1.Write(writeString1 + '\n' + writeString2) ;
+    serialPort1.DrainWriteBuffer() ;
+    usleep(readBufferDelay) ;
+
+    serialPort2.ReadLine(readString1, '\n', timeOutMilliseconds) ;
+    ASSERT_EQ(readString1, writeString1 + '\n') ;
+
+    serialPort2.ReadTimestamped(timestamped_data, second_chunk.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(timestamped_data.data, second_chunk) ;
+    ASSERT_EQ(timestamped_data.chunkOffsets.size(), 1u) ;
+
+    // A timeout keeps the data received so far.
+    serialPort1.Write(first_chunk) ;
+    serialPort1.DrainWriteBuffer() ;
+    usleep(readBufferDelay) ;
+
+    ASSERT_THROW(serialPort2.ReadTimestamped(timestamped_data,
+                                             first_chunk.size() + 1,
+                                             timeOutMilliseconds),
+                 ReadTimeout) ;
+    ASSERT_EQ(timestamped_data.data, first_chunk) ;
+    ASSERT_EQ(timestamped_data.chunkOffsets.size(), timestamped_data.chunkTimestamps.size()) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortSetLatencyProfile()
+{
+    ASSERT_THROW(serialPort1.SetLowLatency(true), NotOpen) ;
+    ASSERT_THROW(serialPort1.IsLowLatency(), NotOpen) ;
+    ASSERT_THROW(serialPort1.SetLatencyProfile(LatencyProfile::LATENCY_PROFILE_LATENCY), NotOpen) ;
+
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    serialPort2.SetLatencyProfile(LatencyProfile::LATENCY_PROFILE_THROUGHPUT) ;
+    ASSERT_EQ(serialPort2.GetVMin(), VMIN_THROUGHPUT) ;
+    ASSERT_EQ(serialPort2.GetVTime(), VTIME_THROUGHPUT) ;
+
+    serialPort1.Write(writeString1) ;
+    serialPort2.Read(readString1, writeString1.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(readString1, writeString1) ;
+
+    serialPort2.SetLatencyProfile(LatencyProfile::LATENCY_PROFILE_LATENCY) ;
+    ASSERT_EQ(serialPort2.GetVMin(), 1) ;
+    ASSERT_EQ(serialPort2.GetVTime(), 0) ;
+
+    serialPort1.Write(writeString2) ;
+    serialPort2.Read(readString1, writeString2.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(readString1, writeString2) ;
+
+    // Drivers without TIOCSSERIAL, such as pseudo terminals, report an
+    // error rather than silently ignoring the request.
+    try
+    {
+        serialPort2.SetLowLatency(true) ;
+        ASSERT_TRUE(serialPort2.IsLowLatency()) ;
+
+        serialPort2.SetLowLatency(false) ;
+        ASSERT_FALSE(serialPort2.IsLowLatency()) ;
+    }
+    catch (const std::runtime_error&)
+    {
+        ASSERT_THROW(serialPort2.IsLowLatency(), std::runtime_error) ;
+    }
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortSetGetBitRate()
+{
+    ASSERT_THROW(serialPort1.SetBitRate(250000), NotOpen) ;
+    ASSERT_THROW(serialPort1.GetBitRate(), NotOpen) ;
+
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    // Standard baud rates are reported as bit rates.
+    serialPort1.SetBaudRate(BaudRate::BAUD_115200) ;
+    ASSERT_EQ(serialPort1.GetBitRate(), 115200u) ;
+
+    ASSERT_THROW(serialPort1.SetBitRate(0), std::invalid_argument) ;
+
+    // Rates without a Bxxx constant, and above the largest one.
+    for (const speed_t bit_rate : {250000u, 6000000u, 12000000u})
+    {
+        serialPort1.SetBitRate(bit_rate) ;
+        ASSERT_EQ(serialPort1.GetBitRate(), bit_rate) ;
+        ASSERT_EQ(serialPort1.GetBaudRate(), BaudRate::BAUD_INVALID) ;
+    }
+
+    // The bit rate is kept when other settings change.
+    serialPort1.SetBitRate(250000) ;
+    serialPort1.SetParity(Parity::PARITY_ODD) ;
+    serialPort1.SetVMin(0) ;
+    ASSERT_EQ(serialPort1.GetBitRate(), 250000u) ;
+
+    serialPort1.Write(writeString1) ;
+    serialPort2.Read(readString1, writeString1.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(readString1, writeString1) ;
+
+    // A standard baud rate can be selected again.
+    serialPort1.SetBaudRate(BaudRate::BAUD_9600) ;
+    ASSERT_EQ(serialPort1.GetBaudRate(), BaudRate::BAUD_9600) ;
+    ASSERT_EQ(serialPort1.GetBitRate(), 9600u) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortSetGetRS485Settings()
+{
+    RS485Settings rs485_settings {} ;
+
+    ASSERT_THROW(serialPort1.SetRS485Settings(rs485_settings), NotOpen) ;
+    ASSERT_THROW(serialPort1.GetRS485Settings(), NotOpen) ;
+
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    // Drivers without RS-485 support, such as pseudo terminals, report an
+    // error rather than silently ignoring the request.
+    try
+    {
+        rs485_settings.enabled            = true ;
+        rs485_settings.rtsOnSend          = false ;
+        rs485_settings.delayRtsBeforeSend = 1 ;
+        rs485_settings.delayRtsAfterSend  = 2 ;
+
+        serialPort1.SetRS485Settings(rs485_settings) ;
+
+        const auto applied_settings = serialPort1.GetRS485Settings() ;
+        ASSERT_TRUE(applied_settings.enabled) ;
+        ASSERT_FALSE(applied_settings.rtsOnSend) ;
+
+        serialPort1.Write(writeString1) ;
+        serialPort2.Read(readString1, writeString1.size(), timeOutMilliseconds) ;
+        ASSERT_EQ(readString1, writeString1) ;
+
+        rs485_settings.enabled = false ;
+        serialPort1.SetRS485Settings(rs485_settings) ;
+        ASSERT_FALSE(serialPort1.GetRS485Settings().enabled) ;
+    }
+    catch (const std::runtime_error&)
+    {
+        ASSERT_THROW(serialPort1.GetRS485Settings(), std::runtime_error) ;
+    }
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortOpenWithPortSettings()
+{
+    PortSettings port_settings ;
+    port_settings.baudRate      = BaudRate::BAUD_9600 ;
+    port_settings.characterSize = CharacterSize::CHAR_SIZE_8 ;
+    port_settings.flowControl   = FlowControl::FLOW_CONTROL_HARDWARE ;
+    port_settings.parity        = Parity::PARITY_NONE ;
+    port_settings.stopBits      = StopBits::STOP_BITS_2 ;
+    port_settings.vmin          = 5 ;
+    port_settings.vtime         = 3 ;
+
+    serialPort1.Open(SERIAL_PORT_1, port_settings) ;
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+
+    ASSERT_EQ(serialPort1.GetBaudRate(),      port_settings.baudRate) ;
+    ASSERT_EQ(serialPort1.GetCharacterSize(), port_settings.characterSize) ;
+    ASSERT_EQ(serialPort1.GetFlowControl(),   port_settings.flowControl) ;
+    ASSERT_EQ(serialPort1.GetParity(),        port_settings.parity) ;
+    ASSERT_EQ(serialPort1.GetStopBits(),      port_settings.stopBits) ;
+    ASSERT_EQ(serialPort1.GetVMin(),          port_settings.vmin) ;
+    ASSERT_EQ(serialPort1.GetVTime(),         port_settings.vtime) ;
+
+    ASSERT_THROW(serialPort1.Open(SERIAL_PORT_1, port_settings), AlreadyOpen) ;
+
+    serialPort1.Close() ;
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+
+    // The serial port is not left open if any parameter is invalid.
+    PortSettings invalid_settings ;
+    invalid_settings.vmin = 256 ;
+    ASSERT_THROW(serialPort1.Open(SERIAL_PORT_1, invalid_settings), std::invalid_argument) ;
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+
+    // The serial port can still be opened afterwards.
+    serialPort1.Open(SERIAL_PORT_1, PortSettings()) ;
+    ASSERT_EQ(serialPort1.GetBaudRate(), BaudRate::BAUD_DEFAULT) ;
+    serialPort1.Close() ;
+
+    // The constructor taking the parameters configures the port the same way.
+    SerialPort serial_port(SERIAL_PORT_1,
+                           port_settings.baudRate,
+                           port_settings.characterSize,
+                           port_settings.flowControl,
+                           port_settings.parity,
+                           port_settings.stopBits) ;
+
+    ASSERT_EQ(serial_port.GetBaudRate(), port_settings.baudRate) ;
+    ASSERT_EQ(serial_port.GetParity(),   port_settings.parity) ;
+    ASSERT_EQ(serial_port.GetStopBits(), port_settings.stopBits) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortDrainWriteBufferTimeout()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    ASSERT_EQ(serialPort1.GetNumberOfBytesPending(), 0) ;
+
+    serialPort1.Write(writeString1) ;
+
+    ASSERT_TRUE(serialPort1.DrainWriteBuffer(timeOutMilliseconds)) ;
+    ASSERT_EQ(serialPort1.GetNumberOfBytesPending(), 0) ;
+
+    serialPort2.Read(readString1, writeString1.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(readString1, writeString1) ;
+
+    // A timeout of zero waits like DrainWriteBuffer().
+    ASSERT_TRUE(serialPort1.DrainWriteBuffer(0)) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_THROW(serialPort1.GetNumberOfBytesPending(), NotOpen) ;
+    ASSERT_THROW(serialPort1.DrainWriteBuffer(timeOutMilliseconds), NotOpen) ;
+}
+
+void
+SerialPortUnitTests::testSerialPortWaitForModemLineChange()
+{
+    ASSERT_THROW(serialPort1.GetModemLineCounters(), NotOpen) ;
+    ASSERT_THROW(serialPort1.WaitForModemLineChange(TIOCM_CTS), NotOpen) ;
+
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    ASSERT_THROW(serialPort1.WaitForModemLineChange(0), std::invalid_argument) ;
+    ASSERT_THROW(serialPort1.WaitForModemLineChange(TIOCM_RTS), std::invalid_argument) ;
+
+    ModemLineCounters modem_line_counters {} ;
+
+    try
+    {
+        modem_line_counters = serialPort1.GetModemLineCounters() ;
+    }
+    catch (const std::runtime_error& error)
+    {
+        // Drivers that do not count transitions, such as pseudo terminals,
+        // do not support TIOCMIWAIT either.
+        if (error.what() != std::string(std::strerror(ENOTTY)))
+        {
+            throw ;
+        }
+
+        serialPort1.Close() ;
+        serialPort2.Close() ;
+
+        GTEST_SKIP() << "The serial port does not count modem line transitions." ;
+    }
+
+    serialPort2.SetRTS(true) ;
+    modem_line_counters = serialPort1.GetModemLineCounters() ;
+
+    // A change made while waiting wakes the waiting thread.
+    std::thread rts_thread([this]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10)) ;
+        serialPort2.SetRTS(false) ;
+    }) ;
+
+    const auto changed_lines = serialPort1.WaitForModemLineChange(TIOCM_CTS,
+                                                                  modem_line_counters,
+                                                                  timeOutMilliseconds) ;
+    rts_thread.join() ;
+
+    ASSERT_EQ(changed_lines, TIOCM_CTS) ;
+    ASSERT_FALSE(serialPort1.GetCTS()) ;
+
+    // A pulse that ended before the next wait is still reported.
+    serialPort2.SetRTS(true) ;
+    serialPort2.SetRTS(false) ;
+
+    ASSERT_EQ(serialPort1.WaitForModemLineChange(TIOCM_CTS,
+                                                 modem_line_counters,
+                                                 timeOutMilliseconds),
+              TIOCM_CTS) ;
+
+    // The counters are now up to date, so waiting again times out.
+    ASSERT_THROW(serialPort1.WaitForModemLineChange(TIOCM_CTS,
+                                                    modem_line_counters,
+                                                    timeOutMilliseconds),
+                 ReadTimeout) ;
+
+    serialPort2.SetRTS(true) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
 TEST_F(SerialPortUnitTests, testSerialPortConstructors)
 {
     SCOPED_TRACE("Serial Port Constructors Tests") ;
@@ -1384,3 +2144,134 @@ TEST_F(SerialPortUnitTests, testSerialPortReadLineWriteString)
         testSerialPortReadLineWriteString() ;
     }
 }
+
+TEST_F(SerialPortUnitTests, testSerialPortReadWriteCallerBuffer)
+{
+    SCOPED_TRACE("Serial Port Read() and Write() Caller Buffer Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortReadWriteCallerBuffer() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortWriteV)
+{
+    SCOPED_TRACE("Serial Port WriteV() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortWriteV() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortReadLineMultiCharTerminator)
+{
+    SCOPED_TRACE("Serial Port ReadLine() Multi-Character Terminator Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortReadLineMultiCharTerminator() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortBackgroundReader)
+{
+    SCOPED_TRACE("Serial Port Background Reader Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortBackgroundReader() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortBackgroundReaderHangUp)
+{
+    SCOPED_TRACE("Serial Port Background Reader Hang-Up Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortBackgroundReaderHangUp() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortSetGetSerialPortParameters)
+{
+    SCOPED_TRACE("Serial Port SetSerialPortParameters() and GetSerialPortParameters() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortSetGetSerialPortParameters() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortReadTimestamped)
+{
+    SCOPED_TRACE("Serial Port ReadTimestamped() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortReadTimestamped() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortSetLatencyProfile)
+{
+    SCOPED_TRACE("Serial Port SetLowLatency() and SetLatencyProfile() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortSetLatencyProfile() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortSetGetBitRate)
+{
+    SCOPED_TRACE("Serial Port SetBitRate() and GetBitRate() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortSetGetBitRate() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortWaitForModemLineChange)
+{
+    SCOPED_TRACE("Serial Port WaitForModemLineChange() Test") ;
+
+    for (size_t i = 0; (i < TEST_ITERATIONS) and (not IsSkipped()); i++)
+    {
+        testSerialPortWaitForModemLineChange() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortSetGetRS485Settings)
+{
+    SCOPED_TRACE("Serial Port SetRS485Settings() and GetRS485Settings() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortSetGetRS485Settings() ;
+    }
+}
+
+
+TEST_F(SerialPortUnitTests, testSerialPortOpenWithPortSettings)
+{
+    SCOPED_TRACE("Serial Port Open() With Port Settings Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortOpenWithPortSettings() ;
+    }
+}
+
+TEST_F(SerialPortUnitTests, testSerialPortDrainWriteBufferTimeout)
+{
+    SCOPED_TRACE("Serial Port DrainWriteBuffer() With Timeout Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialPortDrainWriteBufferTimeout() ;
+    }
+}
@@ -203,6 +203,76 @@ namespace LibSerial
          */
         void testSerialPortReadLineWriteString() ;
 
+        /**
+         * @brief Tests for correct functionality of the Read() and Write() overloads operating on caller owned memory.
+         */
+        void testSerialPortReadWriteCallerBuffer() ;
+
+        /**
+         * @brief Tests for correct functionality of the WriteV() method.
+         */
+        void testSerialPortWriteV() ;
+
+        /**
+         * @brief Tests for correct functionality of ReadLine() with a multi-character line terminator and of data read beyond the end of a line.
+         */
+        void testSerialPortReadLineMultiCharTerminator() ;
+
+        /**
+         * @brief Tests for correct functionality of the background reader and its ring buffer.
+         */
+        void testSerialPortBackgroundReader() ;
+
+        /**
+         * @brief Tests that the background reader is reported as stopped
+         *        once reading fails, and that it can be restarted.
+         */
+        void testSerialPortBackgroundReaderHangUp() ;
+
+        /**
+         * @brief Tests for correct functionality of SerialPort::SetSerialPortParameters() and SerialPort::GetSerialPortParameters().
+         */
+        void testSerialPortSetGetSerialPortParameters() ;
+
+        /**
+         * @brief Tests for correct functionality of the ReadTimestamped() method.
+         */
+        void testSerialPortReadTimestamped() ;
+
+        /**
+         * @brief Tests for correct functionality of the SetLowLatency() and SetLatencyProfile() methods.
+         */
+        void testSerialPortSetLatencyProfile() ;
+
+        /**
+         * @brief Tests for correct functionality of the SetBitRate() and GetBitRate() methods.
+         */
+        void testSerialPortSetGetBitRate() ;
+
+        /**
+         * @brief Tests for correct functionality of the GetModemLineCounters()
+         *        and WaitForModemLineChange() methods.
+         */
+        void testSerialPortWaitForModemLineChange() ;
+
+        /**
+         * @brief Tests for correct functionality of the SetRS485Settings() and
+         *        GetRS485Settings() methods.
+         */
+        void testSerialPortSetGetRS485Settings() ;
+
+        /**
+         * @brief Tests for correct functionality of opening a serial port
+         *        with Open(fileName, portSettings).
+         */
+        void testSerialPortOpenWithPortSettings() ;
+
+        /**
+         * @brief Tests for correct functionality of GetNumberOfBytesPending()
+         *        and DrainWriteBuffer() with a timeout.
+         */
+        void testSerialPortDrainWriteBufferTimeout() ;
+
     } ; // class SerialPortUnitTests
 
 } // namespace LibSerial
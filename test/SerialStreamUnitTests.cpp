@@ -935,6 +935,98 @@ SerialStreamUnitTests::testSerialStreamGetWriteByte()
 }
 
 
+void
+SerialStreamUnitTests::testSerialStreamBufferedReadWrite()
+{
+    serialStream1.Open(SERIAL_PORT_1) ;
+    serialStream2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialStream1.IsOpen()) ;
+    ASSERT_TRUE(serialStream2.IsOpen()) ;
+
+    ASSERT_EQ(serialStream1.GetReadBufferSize(), 0) ;
+    ASSERT_EQ(serialStream1.GetWriteBufferSize(), 0) ;
+
+    const size_t buffer_size = 256 ;
+
+    serialStream1.SetWriteBufferSize(buffer_size) ;
+    serialStream2.SetReadBufferSize(buffer_size) ;
+
+    ASSERT_EQ(serialStream1.GetWriteBufferSize(), buffer_size) ;
+    ASSERT_EQ(serialStream2.GetReadBufferSize(), buffer_size) ;
+
+    // Buffered output is held back until the stream is flushed.
+    serialStream1 << writeString1 << '\n' << writeString2 << '\n' ;
+    usleep(readBufferDelay) ;
+    ASSERT_FALSE(serialStream2.IsDataAvailable()) ;
+
+    serialStream1.flush() ;
+    usleep(readBufferDelay) ;
+
+    const auto number_of_bytes = writeString1.size() + writeString2.size() + 2 ;
+    ASSERT_EQ(serialStream2.GetNumberOfBytesAvailable(), number_of_bytes) ;
+
+    // Both lines arrive in the read buffer with the first read, but remain
+    // available to subsequent reads.
+    getline(serialStream2, readString1) ;
+    ASSERT_EQ(readString1, writeString1) ;
+    ASSERT_TRUE(serialStream2.IsDataAvailable()) ;
+    ASSERT_EQ(serialStream2.GetNumberOfBytesAvailable(), writeString2.size() + 1) ;
+
+    char readByte = 0 ;
+    serialStream2.get(readByte) ;
+    ASSERT_EQ(readByte, writeString2[0]) ;
+    serialStream2.unget() ;
+
+    getline(serialStream2, readString2) ;
+    ASSERT_EQ(readString2, writeString2) ;
+    ASSERT_FALSE(serialStream2.IsDataAvailable()) ;
+
+    // Data still held in the write buffer is written out on close.
+    serialStream1 << writeString2 << '\n' ;
+    serialStream1.Close() ;
+
+    getline(serialStream2, readString2) ;
+    ASSERT_EQ(readString2, writeString2) ;
+
+    serialStream2.Close() ;
+
+    ASSERT_FALSE(serialStream1.IsOpen()) ;
+    ASSERT_FALSE(serialStream2.IsOpen()) ;
+}
+
+void
+SerialStreamUnitTests::testSerialStreamBufWriteV()
+{
+    serialStream1.Open(SERIAL_PORT_1) ;
+    serialStream2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialStream1.IsOpen()) ;
+    ASSERT_TRUE(serialStream2.IsOpen()) ;
+
+    auto serial_stream_buf = dynamic_cast<SerialStreamBuf*>(serialStream1.rdbuf()) ;
+    ASSERT_NE(serial_stream_buf, nullptr) ;
+
+    serialStream1.SetWriteBufferSize(256) ;
+
+    const DataBuffer payload(writeString2.begin(), writeString2.end()) ;
+    const uint8_t terminator = '\n' ;
+
+    // Data held in the put area is written before the buffers.
+    serialStream1 << writeString1 ;
+    serial_stream_buf->WriteV({{payload.data(), payload.size()},
+                               {&terminator, 1}}) ;
+
+    getline(serialStream2, readString1) ;
+    ASSERT_EQ(readString1, writeString1 + writeString2) ;
+
+    serialStream1.Close() ;
+    serialStream2.Close() ;
+
+    ASSERT_FALSE(serialStream1.IsOpen()) ;
+    ASSERT_FALSE(serialStream2.IsOpen()) ;
+}
+
 TEST_F(SerialStreamUnitTests, testSerialStreamConstructors)
 {
     SCOPED_TRACE("Serial Stream Constructor Tests") ;
@@ -1186,3 +1278,23 @@ TEST_F(SerialStreamUnitTests, testSerialStreamGetWriteByte)
         testSerialStreamGetWriteByte() ;
     }
 }
+
+TEST_F(SerialStreamUnitTests, testSerialStreamBufferedReadWrite)
+{
+    SCOPED_TRACE("Serial Stream Buffered Read and Write Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialStreamBufferedReadWrite() ;
+    }
+}
+
+TEST_F(SerialStreamUnitTests, testSerialStreamBufWriteV)
+{
+    SCOPED_TRACE("Serial Stream Buf WriteV() Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testSerialStreamBufWriteV() ;
+    }
+}
@@ -189,6 +189,17 @@ namespace LibSerial
          */
         void testSerialStreamGetWriteByte() ;
 
+        /**
+         * @brief Tests for correct functionality of buffered I/O enabled with the
+         *        SetReadBufferSize() and SetWriteBufferSize() methods.
+         */
+        void testSerialStreamBufferedReadWrite() ;
+
+        /**
+         * @brief Tests for correct functionality of the SerialStreamBuf::WriteV() method.
+         */
+        void testSerialStreamBufWriteV() ;
+
     } ; // class SerialStreamUnitTests
 
 } // namespace LibSerial
@@ -0,0 +1,352 @@
+/******************************************************************************
+ * @file TransactorUnitTests.cpp                                              *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "TransactorUnitTests.h"
+
+#include <thread>
+#include <vector>
+
+using namespace LibSerial ;
+
+void
+TransactorUnitTests::testTransactorFifoMatching()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    const size_t number_of_requests = 20 ;
+
+    // The device echoes every request it receives.
+    std::thread responder([this, number_of_requests]()
+    {
+        FrameReader frame_reader(serialPort2,
+                                 std::unique_ptr<FrameCodec>(new CobsCodec())) ;
+        CobsCodec cobs_codec ;
+
+        try
+        {
+            for (size_t i = 0; i < number_of_requests; i++)
+            {
+                const auto frame = frame_reader.ReadFrame(timeOutMilliseconds) ;
+
+                DataBuffer response ;
+                cobs_codec.Encode(frame.data, frame.size, response) ;
+                serialPort2.Write(response) ;
+            }
+        }
+        catch (const ReadTimeout&)
+        {
+            /* The transactor reports the missing responses. */
+        }
+    }) ;
+
+    TransactorPolicy transactor_policy ;
+    transactor_policy.windowSize = 4 ;
+    transactor_policy.msTimeout = timeOutMilliseconds ;
+
+    Transactor transactor(serialPort1,
+                          std::unique_ptr<FrameCodec>(new CobsCodec()),
+                          transactor_policy) ;
+
+    std::vector<DataBuffer> requests ;
+    std::vector<DataBuffer> responses ;
+
+    for (size_t i = 0; i < number_of_requests; i++)
+    {
+        const auto request_string = writeString1 + std::to_string(i) ;
+        requests.emplace_back(request_string.begin(), request_string.end()) ;
+
+        transactor.Submit(requests.back(),
+                          [&responses](std::exception_ptr error, DataBuffer response)
+                          {
+                              if (not error)
+                              {
+                                  responses.push_back(std::move(response)) ;
+                              }
+                          }) ;
+    }
+
+    ASSERT_EQ(transactor.GetNumberOfOutstandingTransactions(), number_of_requests) ;
+    ASSERT_EQ(transactor.GetNumberOfTransactionsInFlight(), 0U) ;
+
+    ASSERT_GT(transactor.RunOnce(), 0U) ;
+    ASSERT_LE(transactor.GetNumberOfTransactionsInFlight(), transactor_policy.windowSize) ;
+
+    transactor.Drain() ;
+    responder.join() ;
+
+    ASSERT_EQ(responses, requests) ;
+    ASSERT_EQ(transactor.GetNumberOfOutstandingTransactions(), 0U) ;
+    ASSERT_EQ(transactor.GetNumberOfRetries(), 0U) ;
+    ASSERT_EQ(transactor.GetNumberOfUnmatchedResponses(), 0U) ;
+
+    // Nothing is outstanding, so there is nothing to wait for.
+    ASSERT_EQ(transactor.RunOnce(), 0U) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+}
+
+void
+TransactorUnitTests::testTransactorKeyedMatching()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    const size_t number_of_requests = 4 ;
+
+    // The device answers the whole window at once, last request first, and
+    // adds a response nobody asked for.
+    std::thread responder([this, number_of_requests]()
+    {
+        FrameReader frame_reader(serialPort2,
+                                 std::unique_ptr<FrameCodec>(new CobsCodec())) ;
+        CobsCodec cobs_codec ;
+
+        std::vector<DataBuffer> frames ;
+
+        try
+        {
+            for (size_t i = 0; i < number_of_requests; i++)
+            {
+                DataBuffer frame ;
+                frame_reader.ReadFrame(frame, timeOutMilliseconds) ;
+                frames.push_back(frame) ;
+            }
+        }
+        catch (const ReadTimeout&)
+        {
+            /* The transactor reports the missing responses. */
+        }
+
+        DataBuffer responses ;
+        const DataBuffer unexpected_response = {'z'} ;
+        cobs_codec.Encode(unexpected_response.data(), unexpected_response.size(), responses) ;
+
+        for (auto frame = frames.rbegin(); frame != frames.rend(); ++frame)
+        {
+            frame->push_back('!') ;
+            cobs_codec.Encode(frame->data(), frame->size(), responses) ;
+        }
+
+        serialPort2.Write(responses) ;
+    }) ;
+
+    TransactorPolicy transactor_policy ;
+    transactor_policy.windowSize = number_of_requests ;
+    transactor_policy.msTimeout = timeOutMilliseconds ;
+
+    Transactor transactor(serialPort1,
+                          std::unique_ptr<FrameCodec>(new CobsCodec()),
+                          transactor_policy,
+                          [](const ConstBuffer& response) -> uint64_t
+                          {
+                              return response.size > 0 ? response.data[0] : 0 ;
+                          }) ;
+
+    std::vector<DataBuffer> responses(number_of_requests) ;
+
+    for (size_t i = 0; i < number_of_requests; i++)
+    {
+        const auto key = static_cast<uint8_t>('a' + i) ;
+        const DataBuffer request = {key} ;
+
+        transactor.Submit(request,
+                          [&responses, i](std::exception_ptr error, DataBuffer response)
+                          {
+                              if (not error)
+                              {
+                                  responses[i] = std::move(response) ;
+                              }
+                          },
+                          key) ;
+    }
+
+    transactor.Drain() ;
+    responder.join() ;
+
+    for (size_t i = 0; i < number_of_requests; i++)
+    {
+        const DataBuffer expected_response = {static_cast<uint8_t>('a' + i), '!'} ;
+        ASSERT_EQ(responses[i], expected_response) ;
+    }
+
+    ASSERT_EQ(transactor.GetNumberOfRetries(), 0U) ;
+    ASSERT_EQ(transactor.GetNumberOfUnmatchedResponses(), 1U) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+}
+
+void
+TransactorUnitTests::testTransactorTimeoutAndRetry()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    TransactorPolicy transactor_policy ;
+    transactor_policy.msTimeout = 20 ;
+    transactor_policy.maximumRetries = 2 ;
+
+    Transactor transactor(serialPort1,
+                          std::unique_ptr<FrameCodec>(new CobsCodec()),
+                          transactor_policy) ;
+
+    const DataBuffer request(writeString1.begin(), writeString1.end()) ;
+    std::exception_ptr transaction_error {} ;
+    bool transaction_completed = false ;
+
+    transactor.Submit(request,
+                      [&](std::exception_ptr error, DataBuffer /* response */)
+                      {
+                          transaction_error = error ;
+                          transaction_completed = true ;
+                      }) ;
+
+    ASSERT_EQ(transactor.RunOnce(5), 0U) ;
+    ASSERT_FALSE(transaction_completed) ;
+
+    transactor.Drain() ;
+
+    ASSERT_TRUE(transaction_completed) ;
+    ASSERT_THROW(std::rethrow_exception(transaction_error), ReadTimeout) ;
+    ASSERT_EQ(transactor.GetNumberOfRetries(), transactor_policy.maximumRetries) ;
+    ASSERT_EQ(transactor.GetNumberOfOutstandingTransactions(), 0U) ;
+
+    // The device received the request once plus once per retry.
+    FrameReader frame_reader(serialPort2,
+                             std::unique_ptr<FrameCodec>(new CobsCodec())) ;
+
+    for (size_t i = 0; i <= transactor_policy.maximumRetries; i++)
+    {
+        const auto frame = frame_reader.ReadFrame(timeOutMilliseconds) ;
+        ASSERT_EQ(DataBuffer(frame.data, frame.data + frame.size), request) ;
+    }
+
+    ASSERT_THROW(frame_reader.ReadFrame(10), ReadTimeout) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+}
+
+void
+TransactorUnitTests::testTransactorInvalidArguments()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+
+    TransactorPolicy transactor_policy ;
+    transactor_policy.windowSize = 0 ;
+
+    ASSERT_THROW(Transactor(serialPort1,
+                            std::unique_ptr<FrameCodec>(new CobsCodec()),
+                            transactor_policy),
+                 std::invalid_argument) ;
+
+    transactor_policy = TransactorPolicy() ;
+    transactor_policy.numberOfTimerSlots = 0 ;
+
+    ASSERT_THROW(Transactor(serialPort1,
+                            std::unique_ptr<FrameCodec>(new CobsCodec()),
+                            transactor_policy),
+                 std::invalid_argument) ;
+
+    ASSERT_THROW(Transactor(serialPort1, nullptr),
+                 std::invalid_argument) ;
+
+    Transactor transactor(serialPort1,
+                          std::unique_ptr<FrameCodec>(new CobsCodec()),
+                          TransactorPolicy(),
+                          [](const ConstBuffer& /* response */) -> uint64_t
+                          {
+                              return 0 ;
+                          }) ;
+
+    const DataBuffer request = {'a'} ;
+
+    transactor.Submit(request, nullptr, 1) ;
+    ASSERT_THROW(transactor.Submit(request, nullptr, 1),
+                 std::invalid_argument) ;
+    ASSERT_EQ(transactor.GetNumberOfOutstandingTransactions(), 1U) ;
+
+    serialPort1.Close() ;
+}
+
+TEST_F(TransactorUnitTests, testTransactorFifoMatching)
+{
+    SCOPED_TRACE("Transactor FIFO Matching Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testTransactorFifoMatching() ;
+    }
+}
+
+TEST_F(TransactorUnitTests, testTransactorKeyedMatching)
+{
+    SCOPED_TRACE("Transactor Keyed Matching Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testTransactorKeyedMatching() ;
+    }
+}
+
+TEST_F(TransactorUnitTests, testTransactorTimeoutAndRetry)
+{
+    SCOPED_TRACE("Transactor Timeout And Retry Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testTransactorTimeoutAndRetry() ;
+    }
+}
+
+TEST_F(TransactorUnitTests, testTransactorInvalidArguments)
+{
+    SCOPED_TRACE("Transactor Invalid Arguments Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testTransactorInvalidArguments() ;
+    }
+}
@@ -0,0 +1,272 @@
+/******************************************************************************
+ * @file WriteQueueUnitTests.cpp                                              *
+ * @copyright (C) 2004-2018 LibSerial Development Team. All rights reserved.  *
+ * crayzeewulf@gmail.com                                                      *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in         *
+ *    the documentation and/or other materials provided with the              *
+ *    distribution.                                                           *
+ * 3. Neither the name PX4 nor the names of its contributors may be           *
+ *    used to endorse or promote products derived from this software          *
+ *    without specific prior written permission.                              *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS        *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT          *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS          *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE             *
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,        *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,       *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS      *
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED         *
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT                *
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN          *
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE            *
+ * POSSIBILITY OF SUCH DAMAGE.                                                *
+ *****************************************************************************/
+
+#include "WriteQueueUnitTests.h"
+#include "UnitTests.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace LibSerial;
+
+void
+WriteQueueUnitTests::testWriteQueueCoalescing()
+{
+    ASSERT_THROW(WriteQueue {serialPort1}, NotOpen) ;
+
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    constexpr size_t number_of_threads = 4 ;
+    constexpr size_t number_of_writes = 100 ;
+    const std::string message = "cmd;" ;
+
+    WriteQueuePolicy write_queue_policy ;
+    write_queue_policy.maximumDelayMicroseconds = 5000 ;
+
+    {
+        WriteQueue write_queue(serialPort1, write_queue_policy) ;
+
+        std::vector<std::thread> producer_threads {} ;
+
+        for (size_t producer = 0; producer < number_of_threads; producer++)
+        {
+            producer_threads.emplace_back([&write_queue, &message, producer]()
+            {
+                for (size_t i = 0; i < number_of_writes; i++)
+                {
+                    ASSERT_TRUE(write_queue.WriteByte(static_cast<uint8_t>('0' + producer))) ;
+                    ASSERT_TRUE(write_queue.Write(message)) ;
+                }
+            }) ;
+        }
+
+        for (auto& producer_thread : producer_threads)
+        {
+            producer_thread.join() ;
+        }
+
+        ASSERT_TRUE(write_queue.Flush(timeOutMilliseconds)) ;
+        ASSERT_EQ(write_queue.GetNumberOfQueuedBytes(), 0u) ;
+        ASSERT_EQ(write_queue.GetNumberOfRejectedWrites(), 0u) ;
+        ASSERT_GT(write_queue.GetNumberOfWriteCalls(), 0u) ;
+        ASSERT_LT(write_queue.GetNumberOfWriteCalls(), number_of_threads * number_of_writes) ;
+    }
+
+    const auto number_of_bytes = number_of_threads * number_of_writes * (1 + message.size()) ;
+
+    DataBuffer read_buffer ;
+    serialPort2.Read(read_buffer, number_of_bytes, timeOutMilliseconds * 4) ;
+    ASSERT_EQ(read_buffer.size(), number_of_bytes) ;
+
+    // A message is never split by a write from another thread, although
+    // other writes may land between a producer's byte and its message.
+    std::string messages_string ;
+
+    for (const auto data_byte : read_buffer)
+    {
+        if ((data_byte < '0') or
+            (data_byte >= '0' + number_of_threads))
+        {
+            messages_string.push_back(static_cast<char>(data_byte)) ;
+        }
+    }
+
+    ASSERT_EQ(messages_string.size(), number_of_threads * number_of_writes * message.size()) ;
+
+    for (size_t offset = 0; offset < messages_string.size(); offset += message.size())
+    {
+        ASSERT_EQ(messages_string.compare(offset, message.size(), message), 0) ;
+    }
+
+    for (size_t producer = 0; producer < number_of_threads; producer++)
+    {
+        ASSERT_EQ(static_cast<size_t>(std::count(read_buffer.begin(),
+                                                 read_buffer.end(),
+                                                 '0' + producer)),
+                  number_of_writes) ;
+    }
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
+void
+WriteQueueUnitTests::testWriteQueueFlushPolicy()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    WriteQueuePolicy write_queue_policy ;
+    write_queue_policy.maximumBatchSize = 2 * writeString1.size() ;
+    write_queue_policy.maximumDelayMicroseconds = 60000000 ;
+
+    {
+        WriteQueue write_queue(serialPort1, write_queue_policy) ;
+
+        // Data below the batch size waits for the delay.
+        ASSERT_TRUE(write_queue.Write(writeString1)) ;
+        usleep(readBufferDelay) ;
+        ASSERT_EQ(write_queue.GetNumberOfQueuedBytes(), writeString1.size()) ;
+        ASSERT_EQ(write_queue.GetNumberOfWriteCalls(), 0u) ;
+        ASSERT_FALSE(serialPort2.IsDataAvailable()) ;
+
+        // Reaching the batch size writes it.
+        ASSERT_TRUE(write_queue.Write(writeString1)) ;
+        serialPort2.Read(readString1, 2 * writeString1.size(), timeOutMilliseconds) ;
+        ASSERT_EQ(readString1, writeString1 + writeString1) ;
+        ASSERT_TRUE(write_queue.Flush(timeOutMilliseconds)) ;
+        ASSERT_EQ(write_queue.GetNumberOfWriteCalls(), 1u) ;
+
+        // An explicit flush does not wait for the delay.
+        ASSERT_TRUE(write_queue.Write(writeString2)) ;
+        ASSERT_TRUE(write_queue.Flush(timeOutMilliseconds)) ;
+        ASSERT_EQ(write_queue.GetNumberOfQueuedBytes(), 0u) ;
+        serialPort2.Read(readString1, writeString2.size(), timeOutMilliseconds) ;
+        ASSERT_EQ(readString1, writeString2) ;
+
+        ASSERT_TRUE(write_queue.Flush(timeOutMilliseconds)) ;
+
+        // Data left in the queue is written by the destructor.
+        ASSERT_TRUE(write_queue.Write(writeString1)) ;
+    }
+
+    serialPort2.Read(readString1, writeString1.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(readString1, writeString1) ;
+
+    // A delay of zero writes data as soon as possible.
+    write_queue_policy.maximumDelayMicroseconds = 0 ;
+
+    {
+        WriteQueue write_queue(serialPort1, write_queue_policy) ;
+
+        ASSERT_TRUE(write_queue.Write(writeString2)) ;
+        serialPort2.Read(readString1, writeString2.size(), timeOutMilliseconds) ;
+        ASSERT_EQ(readString1, writeString2) ;
+    }
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
+void
+WriteQueueUnitTests::testWriteQueueBackpressure()
+{
+    serialPort1.Open(SERIAL_PORT_1) ;
+    serialPort2.Open(SERIAL_PORT_2) ;
+
+    ASSERT_TRUE(serialPort1.IsOpen()) ;
+    ASSERT_TRUE(serialPort2.IsOpen()) ;
+
+    WriteQueuePolicy write_queue_policy ;
+    write_queue_policy.maximumQueueSize = 16 ;
+    write_queue_policy.maximumDelayMicroseconds = 60000000 ;
+
+    write_queue_policy.maximumBatchSize = 0 ;
+    ASSERT_THROW((WriteQueue {serialPort1, write_queue_policy}), std::invalid_argument) ;
+    write_queue_policy.maximumBatchSize = 1024 ;
+
+    const DataBuffer small_buffer(10, 'a') ;
+    const DataBuffer large_buffer(32, 'b') ;
+
+    {
+        WriteQueue write_queue(serialPort1, write_queue_policy) ;
+
+        ASSERT_TRUE(write_queue.Write(small_buffer)) ;
+        ASSERT_FALSE(write_queue.Write(small_buffer)) ;
+        ASSERT_FALSE(write_queue.Write(large_buffer)) ;
+        ASSERT_EQ(write_queue.GetNumberOfRejectedWrites(), 2u) ;
+        ASSERT_EQ(write_queue.GetNumberOfQueuedBytes(), small_buffer.size()) ;
+
+        // Data larger than the limit is accepted into an empty queue.
+        ASSERT_TRUE(write_queue.Flush(timeOutMilliseconds)) ;
+        ASSERT_TRUE(write_queue.Write(large_buffer)) ;
+        ASSERT_TRUE(write_queue.Flush(timeOutMilliseconds)) ;
+    }
+
+    DataBuffer expected_buffer(small_buffer) ;
+    expected_buffer.insert(expected_buffer.end(), large_buffer.begin(), large_buffer.end()) ;
+
+    DataBuffer read_buffer ;
+    serialPort2.Read(read_buffer, expected_buffer.size(), timeOutMilliseconds) ;
+    ASSERT_EQ(read_buffer, expected_buffer) ;
+
+    serialPort1.Close() ;
+    serialPort2.Close() ;
+
+    ASSERT_FALSE(serialPort1.IsOpen()) ;
+    ASSERT_FALSE(serialPort2.IsOpen()) ;
+}
+
+TEST_F(WriteQueueUnitTests, testWriteQueueCoalescing)
+{
+    SCOPED_TRACE("Write Queue Coalescing Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testWriteQueueCoalescing() ;
+    }
+}
+
+TEST_F(WriteQueueUnitTests, testWriteQueueFlushPolicy)
+{
+    SCOPED_TRACE("Write Queue Flush Policy Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testWriteQueueFlushPolicy() ;
+    }
+}
+
+TEST_F(WriteQueueUnitTests, testWriteQueueBackpressure)
+{
+    SCOPED_TRACE("Write Queue Backpressure Test") ;
+
+    for (size_t i = 0; i < TEST_ITERATIONS; i++)
+    {
+        testWriteQueueBackpressure() ;
+    }
+}